@@ -0,0 +1,89 @@
+//
+//  testtaxonomytrie.cpp
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "testtaxonomytrie.hpp"
+
+/**************************************************************************************************/
+TestTaxonomyTrie::TestTaxonomyTrie() {  //setup
+    m = MothurOut::getInstance();
+    
+    root = trie.addNode("Root");
+    bacteria = addChild(root, "Bacteria");
+    archaea = addChild(root, "Archaea");
+    firmicutes = addChild(bacteria, "Firmicutes");
+    bacteroidetes = addChild(bacteria, "Bacteroidetes");
+    unclassified = addChild(bacteria, "unclassified");
+    archaeaUnclassified = addChild(archaea, "unclassified");
+}
+/**************************************************************************************************/
+TestTaxonomyTrie::~TestTaxonomyTrie() {}
+/**************************************************************************************************/
+int TestTaxonomyTrie::addChild(int parent, string name) {
+    int child = trie.addNode(name);
+    trie.addChild(parent, child);
+    return child;
+}
+/**************************************************************************************************/
+
+TEST(TestTaxonomyTrie, findChild) {
+    TestTaxonomyTrie test;
+    
+    EXPECT_EQ(test.bacteria, test.trie.findChild(test.root, "Bacteria"));
+    EXPECT_EQ(test.firmicutes, test.trie.findChild(test.bacteria, "Firmicutes"));
+    EXPECT_EQ(test.unclassified, test.trie.findChild(test.bacteria, "unclassified"));
+    EXPECT_EQ(test.archaeaUnclassified, test.trie.findChild(test.archaea, "unclassified"));
+    
+    EXPECT_EQ(-1, test.trie.findChild(test.root, "Firmicutes")); //only children are found
+    EXPECT_EQ(-1, test.trie.findChild(test.archaea, "Firmicutes"));
+    EXPECT_EQ(-1, test.trie.findChild(test.root, "Eukaryota")); //not a name in the trie
+}
+
+TEST(TestTaxonomyTrie, namesAreShared) {
+    TestTaxonomyTrie test;
+    
+    EXPECT_EQ(7, test.trie.getNumNodes());
+    EXPECT_EQ(6, test.trie.getNumNames()); //unclassified is stored once
+    EXPECT_EQ("unclassified", test.trie.getName(test.archaeaUnclassified));
+    EXPECT_EQ("Bacteroidetes", test.trie.getName(test.bacteroidetes));
+}
+
+TEST(TestTaxonomyTrie, childrenInAlphabeticalOrder) {
+    TestTaxonomyTrie test;
+    
+    const vector<int>& rootChildren = test.trie.getChildren(test.root);
+    ASSERT_EQ(2, rootChildren.size());
+    EXPECT_EQ(test.archaea, rootChildren[0]);
+    EXPECT_EQ(test.bacteria, rootChildren[1]);
+    
+    const vector<int>& bacteriaChildren = test.trie.getChildren(test.bacteria);
+    ASSERT_EQ(3, test.trie.getNumChildren(test.bacteria));
+    EXPECT_EQ(test.bacteroidetes, bacteriaChildren[0]);
+    EXPECT_EQ(test.firmicutes, bacteriaChildren[1]);
+    EXPECT_EQ(test.unclassified, bacteriaChildren[2]);
+    
+    EXPECT_EQ(0, test.trie.getNumChildren(test.firmicutes));
+}
+
+TEST(TestTaxonomyTrie, phyloTreeSeqs) {
+    PhyloTree phylo;
+    phylo.addSeqToTree("seq1", "Bacteria(100);Firmicutes(100);Clostridia(100);");
+    phylo.addSeqToTree("seq2", "Bacteria(100);Bacteroidetes(100);Bacteroidia(100);");
+    phylo.addSeqToTree("seq3", "Bacteria(100);Firmicutes(100);Bacilli(100);");
+    phylo.addSeqToTree("seq4", "Bacteria(100);Firmicutes(100);Clostridia(100);");
+    
+    vector<string> firmicutes = phylo.getSeqs("Bacteria;Firmicutes;");
+    ASSERT_EQ(3, firmicutes.size());
+    
+    vector<string> clostridia = phylo.getSeqs("Bacteria;Firmicutes;Clostridia;");
+    ASSERT_EQ(2, clostridia.size());
+    EXPECT_EQ("seq1", clostridia[0]);
+    EXPECT_EQ("seq4", clostridia[1]);
+    
+    EXPECT_EQ(0, phylo.getSeqs("Bacteria;Bacteroidetes;Clostridia;").size());
+}
+/**************************************************************************************************/
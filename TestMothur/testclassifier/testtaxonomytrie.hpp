@@ -0,0 +1,32 @@
+//
+//  testtaxonomytrie.hpp
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef testtaxonomytrie_hpp
+#define testtaxonomytrie_hpp
+
+#include "gtest.h"
+#include "taxonomytrie.hpp"
+#include "phylotree.h"
+
+class TestTaxonomyTrie {
+    
+public:
+    
+    TestTaxonomyTrie();
+    ~TestTaxonomyTrie();
+    
+    TaxonomyTrie trie;
+    int root, bacteria, archaea, firmicutes, bacteroidetes, unclassified, archaeaUnclassified;
+    
+private:
+    MothurOut* m;
+    
+    int addChild(int, string); //parent, name
+};
+
+#endif /* testtaxonomytrie_hpp */
@@ -0,0 +1,97 @@
+//
+//  testsortseqscommand.cpp
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "testsortseqscommand.h"
+#include "currentfile.h"
+
+/**************************************************************************************************/
+TestSortSeqsCommand::TestSortSeqsCommand() {  //setup
+    m = MothurOut::getInstance();
+    string path = CurrentFile::getInstance()->getTestFilePath();
+    accnosFile = path + "testsortseqs.accnos";
+    fastaFile = path + "testsortseqs.fasta";
+    qualFile = path + "testsortseqs.qual";
+
+    //names repeated in both the accnos and fasta files
+    ofstream out;
+    util.openOutputFile(accnosFile, out);
+    out << "seq3\nseq1\nseq3\nseq2\n";
+    out.close();
+
+    util.openOutputFile(fastaFile, out);
+    out << ">seq1\nAAAA\n>seq2\nCCCC\n>seq1\nAAAA\n>seq4\nTTTT\n>seq3\nGGGG\n";
+    out.close();
+
+    util.openOutputFile(qualFile, out);
+    out << ">seq3\t4\n30 30 30 30\n>seq4\t4\n20 20 20 20\n>seq2\t4\n40 40 40 40\n>seq1\t4\n10 10 10 10\n";
+    out.close();
+}
+/**************************************************************************************************/
+TestSortSeqsCommand::~TestSortSeqsCommand() {
+    util.mothurRemove(accnosFile); util.mothurRemove(fastaFile); util.mothurRemove(qualFile);
+    for (int i = 0; i < outputFiles.size(); i++) { util.mothurRemove(outputFiles[i]); }
+    m->setSortMemory(1073741824);
+}
+/**************************************************************************************************/
+map<string, vector<string> > TestSortSeqsCommand::runSortSeqs(string options) {
+    CurrentFile* current = CurrentFile::getInstance();
+    current->setMothurCalling(true);
+
+    Command* sortCommand = new SortSeqsCommand(options);
+    sortCommand->execute();
+    map<string, vector<string> > filenames = sortCommand->getOutputFiles();
+    delete sortCommand;
+
+    current->setMothurCalling(false);
+
+    for (map<string, vector<string> >::iterator it = filenames.begin(); it != filenames.end(); it++) {
+        outputFiles.insert(outputFiles.end(), it->second.begin(), it->second.end());
+    }
+    return filenames;
+}
+/**************************************************************************************************/
+vector<string> TestSortSeqsCommand::readNames(string filename) {
+    vector<string> names;
+    ifstream in; util.openInputFile(filename, in);
+    string line;
+    while (std::getline(in, line)) { if ((line.length() != 0) && (line[0] == '>')) { names.push_back(line.substr(1, line.find_first_of(" \t") - 1)); } }
+    in.close();
+    return names;
+}
+/**************************************************************************************************/
+
+TEST(TestSortSeqsCommand, largeWithRepeatedNames) {
+    TestSortSeqsCommand test;
+    test.m->setSortMemory(64); //a run per record
+
+    vector<string> expected;
+    expected.push_back("seq3"); expected.push_back("seq1"); expected.push_back("seq2"); expected.push_back("seq4");
+
+    map<string, vector<string> > large = test.runSortSeqs("accnos=" + test.accnosFile + ", fasta=" + test.fastaFile + ", large=T");
+    ASSERT_EQ(1, large["fasta"].size());
+    vector<string> largeNames = test.readNames(large["fasta"][0]);
+    EXPECT_EQ(expected, largeNames);
+
+    map<string, vector<string> > small = test.runSortSeqs("accnos=" + test.accnosFile + ", fasta=" + test.fastaFile);
+    ASSERT_EQ(1, small["fasta"].size());
+    EXPECT_EQ(largeNames, test.readNames(small["fasta"][0]));
+}
+
+TEST(TestSortSeqsCommand, largeOrderFromRepeatedFasta) {
+    TestSortSeqsCommand test;
+    test.m->setSortMemory(64);
+
+    //the fasta file sets the order, keeping the first place of seq1
+    map<string, vector<string> > large = test.runSortSeqs("fasta=" + test.fastaFile + ", qfile=" + test.qualFile + ", large=T");
+    ASSERT_EQ(1, large["qfile"].size());
+
+    vector<string> expected;
+    expected.push_back("seq1"); expected.push_back("seq2"); expected.push_back("seq4"); expected.push_back("seq3");
+    EXPECT_EQ(expected, test.readNames(large["qfile"][0]));
+}
+/**************************************************************************************************/
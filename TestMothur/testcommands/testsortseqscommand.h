@@ -0,0 +1,32 @@
+//
+//  testsortseqscommand.h
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__testsortseqscommand__
+#define __Mothur__testsortseqscommand__
+
+#include "gtest.h"
+#include "sortseqscommand.h"
+
+class TestSortSeqsCommand {
+
+public:
+
+    TestSortSeqsCommand();
+    ~TestSortSeqsCommand();
+
+    MothurOut* m;
+    Utils util;
+    string accnosFile, fastaFile, qualFile;
+    vector<string> outputFiles;
+
+    map<string, vector<string> > runSortSeqs(string); //options, returns the output files
+    vector<string> readNames(string); //the names in a fasta or qual file, in order
+
+};
+
+#endif /* defined(__Mothur__testsortseqscommand__) */
@@ -0,0 +1,127 @@
+//
+//  testexternalsort.cpp
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "testexternalsort.h"
+#include "currentfile.h"
+
+/**************************************************************************************************/
+TestExternalSort::TestExternalSort() {  //setup
+    m = MothurOut::getInstance();
+    string path = CurrentFile::getInstance()->getTestFilePath();
+    rootName = path + "testexternalsort.";
+    outputFile = path + "testexternalsort.sorted";
+    inputFile = path + "testexternalsort.dist";
+
+    //few keys, so most records tie
+    unsigned int state = 12345;
+    for (int i = 0; i < 2000; i++) {
+        state = state * 1103515245 + 12345;
+        int key = (state >> 16) % 37;
+        records.push_back(make_pair(key, "record" + toString(i) + "\n"));
+    }
+
+    ofstream out;
+    util.openOutputFile(inputFile, out);
+    out << "2\tx\n1\tb\n1\n1.0\ta\n-3\tz\n1\t\n0.5\n1\ta\tq\n1\ta\n";
+    out.close();
+}
+/**************************************************************************************************/
+TestExternalSort::~TestExternalSort() {
+    util.mothurRemove(outputFile); util.mothurRemove(inputFile);
+    m->setSortMemory(1073741824);
+}
+/**************************************************************************************************/
+vector<string> TestExternalSort::readLines(string filename) {
+    vector<string> lines;
+    ifstream in; util.openInputFile(filename, in);
+    string line;
+    while (std::getline(in, line)) { lines.push_back(line); }
+    in.close();
+    return lines;
+}
+/**************************************************************************************************/
+vector<string> TestExternalSort::sortRecords(int processors, unsigned long long memory) {
+    ExternalSort sorter(rootName, processors, memory, false);
+    for (int i = 0; i < records.size(); i++) { sorter.add(ExternalSort::encodeKey((unsigned long long)records[i].first), records[i].second); }
+    EXPECT_EQ(records.size(), sorter.output(outputFile));
+    return readLines(outputFile);
+}
+/**************************************************************************************************/
+
+TEST(TestExternalSort, encodeKey) {
+    vector<double> values;
+    values.push_back(-1e300); values.push_back(-5); values.push_back(-0.5); values.push_back(0);
+    values.push_back(1e-300); values.push_back(0.03); values.push_back(2); values.push_back(1e10);
+
+    for (int i = 1; i < values.size(); i++) { EXPECT_LT(ExternalSort::encodeKey(values[i-1]), ExternalSort::encodeKey(values[i])); }
+    EXPECT_EQ(ExternalSort::encodeKey(0.0), ExternalSort::encodeKey(-0.0));
+
+    EXPECT_LT(ExternalSort::encodeKey((unsigned long long)255), ExternalSort::encodeKey((unsigned long long)256));
+    EXPECT_LT(ExternalSort::encodeKey((unsigned long long)0), ExternalSort::encodeKey((unsigned long long)1));
+}
+
+TEST(TestExternalSort, inMemoryKeepsOrderOfTies) {
+    TestExternalSort test;
+    vector<pair<int, string> > expected = test.records;
+    stable_sort(expected.begin(), expected.end(), [](const pair<int, string>& a, const pair<int, string>& b) { return a.first < b.first; });
+
+    vector<string> lines = test.sortRecords(1, 1073741824);
+    ASSERT_EQ(expected.size(), lines.size());
+    for (int i = 0; i < lines.size(); i++) { EXPECT_EQ(expected[i].second, lines[i] + "\n"); }
+}
+
+TEST(TestExternalSort, runsLargerThanBudget) {
+    TestExternalSort test;
+    vector<pair<int, string> > expected = test.records;
+    stable_sort(expected.begin(), expected.end(), [](const pair<int, string>& a, const pair<int, string>& b) { return a.first < b.first; });
+
+    //a small budget writes more than EXTERNAL_SORT_MAX_RUNS runs, so they are merged in rounds
+    for (int processors = 1; processors <= 3; processors += 2) {
+        vector<string> lines = test.sortRecords(processors, 1024);
+        ASSERT_EQ(expected.size(), lines.size());
+        for (int i = 0; i < lines.size(); i++) { EXPECT_EQ(expected[i].second, lines[i] + "\n"); }
+    }
+
+    //the runs are removed
+    ifstream in;
+    EXPECT_FALSE(test.util.openInputFile(test.rootName + "0.sortrun.temp", in, "no error"));
+}
+
+TEST(TestExternalSort, recordLargerThanBudget) {
+    TestExternalSort test;
+    string large(5000, 'A'); large += "\n";
+
+    ExternalSort sorter(test.rootName, 1, 1024, false);
+    sorter.add(ExternalSort::encodeKey((unsigned long long)2), "small2\n");
+    sorter.add(ExternalSort::encodeKey((unsigned long long)1), large);
+    sorter.add(ExternalSort::encodeKey((unsigned long long)0), "small0\n");
+    EXPECT_EQ(3, sorter.output(test.outputFile));
+
+    vector<string> lines = test.readLines(test.outputFile);
+    ASSERT_EQ(3, lines.size());
+    EXPECT_EQ("small0", lines[0]);
+    EXPECT_EQ(large, lines[1] + "\n");
+    EXPECT_EQ("small2", lines[2]);
+}
+
+TEST(TestExternalSort, tiesLikeSort) {
+    TestExternalSort test;
+
+    //the order of LC_ALL=C sort -n -k1, where a line sorts before the lines it starts
+    vector<string> expected;
+    expected.push_back("-3\tz"); expected.push_back("0.5"); expected.push_back("1"); expected.push_back("1\t");
+    expected.push_back("1\ta"); expected.push_back("1\ta\tq"); expected.push_back("1\tb"); expected.push_back("1.0\ta");
+    expected.push_back("2\tx");
+
+    for (int memory = 64; memory <= 1048576; memory *= 128) { //in runs and in memory
+        test.m->setSortMemory(memory);
+        test.util.sortFileNumeric(test.inputFile, test.outputFile, 1);
+        EXPECT_EQ(expected, test.readLines(test.outputFile));
+    }
+}
+/**************************************************************************************************/
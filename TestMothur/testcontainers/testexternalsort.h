@@ -0,0 +1,32 @@
+//
+//  testexternalsort.h
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__testexternalsort__
+#define __Mothur__testexternalsort__
+
+#include "gtest.h"
+#include "externalsort.hpp"
+
+class TestExternalSort {
+
+public:
+
+    TestExternalSort();
+    ~TestExternalSort();
+
+    MothurOut* m;
+    Utils util;
+    string rootName, outputFile, inputFile;
+    vector<pair<int, string> > records; //key, record in the order they are added
+
+    vector<string> readLines(string);
+    vector<string> sortRecords(int, unsigned long long); //processors, memory. Sorts the records with ExternalSort and returns the output lines
+
+};
+
+#endif /* defined(__Mothur__testexternalsort__) */
@@ -0,0 +1,81 @@
+//
+//  testnameset.cpp
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "testnameset.h"
+#include "currentfile.h"
+
+/**************************************************************************************************/
+TestNameSet::TestNameSet() {  //setup
+    m = MothurOut::getInstance();
+    accnosFile = CurrentFile::getInstance()->getTestFilePath() + "testnameset.accnos";
+
+    ofstream out;
+    util.openOutputFile(accnosFile, out);
+    out << "seq1\nseq2\tseq3\n\nseq2\nM00967:43:000000000-A3JHG:1:1101:18327:1701\n";
+    out.close();
+}
+/**************************************************************************************************/
+TestNameSet::~TestNameSet() { util.mothurRemove(accnosFile); }
+/**************************************************************************************************/
+
+TEST(TestNameSet, insertAndCount) {
+    NameSet names;
+    EXPECT_TRUE(names.empty());
+
+    EXPECT_TRUE(names.insert("seq1"));
+    EXPECT_TRUE(names.insert("seq2"));
+    EXPECT_FALSE(names.insert("seq1")); //already in the set
+    EXPECT_TRUE(names.insert("")); //empty names are names too
+
+    EXPECT_EQ(3, names.size());
+    EXPECT_EQ(1, names.count("seq1"));
+    EXPECT_EQ(1, names.count(""));
+    EXPECT_EQ(0, names.count("seq"));
+    EXPECT_EQ(0, names.count("seq12"));
+
+    string buffer = "seq1 seq2";
+    EXPECT_EQ(1, names.count(buffer.c_str(), 4));
+    EXPECT_EQ(1, names.count(buffer.c_str() + 5, 4));
+    EXPECT_EQ(0, names.count(buffer.c_str(), 5));
+}
+
+TEST(TestNameSet, keepsOrder) {
+    set<string> input; input.insert("c"); input.insert("a"); input.insert("b");
+    NameSet names(input);
+
+    EXPECT_EQ(3, names.size());
+    EXPECT_EQ("a", names.getName(0));
+    EXPECT_EQ("c", names.getName(2));
+    EXPECT_EQ(input, names.getNames());
+
+    names.clear();
+    EXPECT_TRUE(names.empty());
+    EXPECT_EQ(0, names.count("a"));
+    EXPECT_TRUE(names.insert("a"));
+}
+
+TEST(TestNameSet, grows) {
+    NameSet names;
+    for (int i = 0; i < 100000; i++) { names.insert("name" + toString(i)); }
+
+    EXPECT_EQ(100000, names.size());
+    for (int i = 0; i < 100000; i += 7) { ASSERT_EQ(1, names.count("name" + toString(i))); }
+    EXPECT_EQ(0, names.count("name100000"));
+    EXPECT_EQ("name99999", names.getName(99999));
+}
+
+TEST(TestNameSet, readAccnos) {
+    TestNameSet test;
+    NameSet names;
+
+    EXPECT_EQ(4, test.util.readAccnos(test.accnosFile, names));
+    EXPECT_EQ(1, names.count("seq3"));
+    EXPECT_EQ(1, names.count("M00967_43_000000000-A3JHG_1_1101_18327_1701")); //checkName changes ':' to '_'
+    EXPECT_EQ(0, names.count("M00967:43:000000000-A3JHG:1:1101:18327:1701"));
+}
+/**************************************************************************************************/
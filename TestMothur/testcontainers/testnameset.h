@@ -0,0 +1,29 @@
+//
+//  testnameset.h
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__testnameset__
+#define __Mothur__testnameset__
+
+#include "gtest.h"
+#include "nameset.hpp"
+#include "utils.hpp"
+
+class TestNameSet {
+
+public:
+
+    TestNameSet();
+    ~TestNameSet();
+
+    MothurOut* m;
+    Utils util;
+    string accnosFile;
+
+};
+
+#endif /* defined(__Mothur__testnameset__) */
@@ -0,0 +1,159 @@
+//
+//  testsequenceindex.cpp
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "testsequenceindex.h"
+#include "currentfile.h"
+
+/**************************************************************************************************/
+TestSequenceIndex::TestSequenceIndex() {  //setup
+    m = MothurOut::getInstance();
+    string path = CurrentFile::getInstance()->getTestFilePath();
+    fastaFile = path + "testsequenceindex.fasta";
+    fastqFile = path + "testsequenceindex.fastq";
+    countFile = path + "testsequenceindex.count_table";
+    outputDir = path + "testsequenceindex/";
+    util.mkDir(outputDir);
+
+    ofstream out;
+    util.openOutputFile(fastaFile, out);
+    out << ">seq1 first comment\nACGT\nacgt\n>seq2\n\nGG-TT..\n\n>seq3\n>seq:4\tlast\nAAAA\n";
+    out.close();
+
+    util.openOutputFile(fastqFile, out);
+    out << "@read1\nACGT\n+\nIIII\n\n@read2 extra\nGGC\n+read2\nHHH\n";
+    out.close();
+
+    util.openOutputFile(countFile, out);
+    out << "Representative_Sequence\ttotal\tA\tB\nseq1\t3\t1\t2\nseq2\t1\t0\t1\n";
+    out.close();
+}
+/**************************************************************************************************/
+TestSequenceIndex::~TestSequenceIndex() {
+    util.mothurRemove(fastaFile); util.mothurRemove(fastqFile); util.mothurRemove(countFile);
+    util.mothurRemove(fastaFile + ".idx"); util.mothurRemove(fastqFile + ".idx"); util.mothurRemove(countFile + ".idx");
+    util.mothurRemove(outputDir + util.getSimpleName(fastaFile) + ".idx");
+}
+/**************************************************************************************************/
+
+TEST(TestSequenceIndex, matchesScan) {
+    TestSequenceIndex test;
+
+    //without set.dir(index=T) the file is scanned and no index is saved
+    long long numScanned = 0;
+    vector<unsigned long long> scanned = test.util.setFilePosFasta(test.fastaFile, numScanned);
+    ifstream in;
+    EXPECT_FALSE(test.util.openInputFile(test.fastaFile + ".idx", in, "no error"));
+
+    SequenceIndex index(test.fastaFile, '>', "");
+    EXPECT_FALSE(index.isValid());
+    ASSERT_TRUE(index.build());
+    EXPECT_TRUE(index.isSaved());
+
+    EXPECT_EQ(numScanned, index.getNumRecords());
+    EXPECT_EQ(scanned, index.getPositions());
+    EXPECT_EQ(SequenceIndex::hashName("seq1"), index.getNameHash(0));
+    EXPECT_EQ(SequenceIndex::hashName("seq_4"), index.getNameHash(3));
+    EXPECT_EQ(8, index.getLength(0));
+    EXPECT_EQ(7, index.getLength(1));
+    EXPECT_EQ(0, index.getLength(2));
+
+    //read back from the index file
+    SequenceIndex loaded(test.fastaFile, '>', "");
+    ASSERT_TRUE(loaded.isValid());
+    EXPECT_EQ(index.getNumRecords(), loaded.getNumRecords());
+    EXPECT_EQ(index.getPositions(), loaded.getPositions());
+    for (long long i = 0; i < index.getNumRecords(); i++) {
+        EXPECT_EQ(index.getNameHash(i), loaded.getNameHash(i));
+        EXPECT_EQ(index.getLength(i), loaded.getLength(i));
+    }
+}
+
+TEST(TestSequenceIndex, changedFile) {
+    TestSequenceIndex test;
+    SequenceIndex index(test.fastaFile, '>', "");
+    ASSERT_TRUE(index.build());
+
+    ofstream out; test.util.openOutputFileAppend(test.fastaFile, out);
+    out << ">seq5\nCCCC\n";
+    out.close();
+
+    SequenceIndex changed(test.fastaFile, '>', "");
+    EXPECT_FALSE(changed.isValid());
+    ASSERT_TRUE(changed.build());
+    EXPECT_EQ(5, changed.getNumRecords());
+
+    //the old index was replaced
+    SequenceIndex loaded(test.fastaFile, '>', "");
+    EXPECT_TRUE(loaded.isValid());
+    EXPECT_EQ(5, loaded.getNumRecords());
+}
+
+TEST(TestSequenceIndex, keepsOtherFiles) {
+    TestSequenceIndex test;
+    ofstream out; test.util.openOutputFile(test.fastaFile + ".idx", out);
+    out << "not an index\n";
+    out.close();
+
+    SequenceIndex index(test.fastaFile, '>', "");
+    EXPECT_FALSE(index.isValid());
+    ASSERT_TRUE(index.build());
+    EXPECT_FALSE(index.isSaved());
+    EXPECT_EQ(4, index.getNumRecords());
+
+    ifstream in; test.util.openInputFile(test.fastaFile + ".idx", in);
+    EXPECT_EQ("not an index", test.util.getline(in));
+    in.close();
+}
+
+TEST(TestSequenceIndex, outputDirectory) {
+    TestSequenceIndex test;
+    SequenceIndex index(test.fastaFile, '>', test.outputDir);
+    ASSERT_TRUE(index.build());
+    ASSERT_TRUE(index.isSaved());
+    EXPECT_EQ(test.outputDir + "testsequenceindex.fasta.idx", index.getIndexFileName());
+
+    ifstream in;
+    EXPECT_FALSE(test.util.openInputFile(test.fastaFile + ".idx", in, "no error"));
+    in.close();
+
+    SequenceIndex loaded(test.fastaFile, '>', test.outputDir);
+    EXPECT_TRUE(loaded.isValid());
+
+    //an index next to the file is used when there isn't one in the output directory
+    SequenceIndex local(test.fastaFile, '>', "");
+    EXPECT_FALSE(local.isValid());
+    ASSERT_TRUE(local.build());
+    test.util.mothurRemove(index.getIndexFileName());
+    SequenceIndex fallback(test.fastaFile, '>', test.outputDir);
+    EXPECT_TRUE(fallback.isValid());
+    EXPECT_EQ(test.fastaFile + ".idx", fallback.getIndexFileName());
+}
+
+TEST(TestSequenceIndex, fastqAndCount) {
+    TestSequenceIndex test;
+    long long numScanned = 0;
+    vector<unsigned long long> scanned = test.util.setFilePosFasta(test.fastqFile, numScanned, '@');
+
+    SequenceIndex fastq(test.fastqFile, '@', "");
+    ASSERT_TRUE(fastq.build());
+    EXPECT_EQ(2, fastq.getNumRecords());
+    EXPECT_EQ(scanned, fastq.getPositions());
+    EXPECT_EQ(SequenceIndex::hashName("read2"), fastq.getNameHash(1));
+    EXPECT_EQ(3, fastq.getLength(1));
+
+    SequenceIndex count(test.countFile, '\n', "");
+    ASSERT_TRUE(count.build());
+    ASSERT_EQ(2, count.getNumRecords());
+    EXPECT_EQ(SequenceIndex::hashName("seq2"), count.getNameHash(1));
+    EXPECT_EQ(10, count.getLength(0));
+
+    //the delimiter is part of the index
+    SequenceIndex wrongDelim(test.countFile, '>', "");
+    EXPECT_FALSE(wrongDelim.isValid());
+}
+/**************************************************************************************************/
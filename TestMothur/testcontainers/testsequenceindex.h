@@ -0,0 +1,28 @@
+//
+//  testsequenceindex.h
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__testsequenceindex__
+#define __Mothur__testsequenceindex__
+
+#include "gtest.h"
+#include "sequenceindex.hpp"
+
+class TestSequenceIndex {
+
+public:
+
+    TestSequenceIndex();
+    ~TestSequenceIndex();
+
+    MothurOut* m;
+    Utils util;
+    string fastaFile, fastqFile, countFile, outputDir;
+
+};
+
+#endif /* defined(__Mothur__testsequenceindex__) */
@@ -0,0 +1,160 @@
+//
+//  testsequencereader.cpp
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "testsequencereader.h"
+#include "currentfile.h"
+
+/**************************************************************************************************/
+TestSequenceReader::TestSequenceReader() {  //setup
+    m = MothurOut::getInstance();
+    string path = CurrentFile::getInstance()->getTestFilePath();
+    fastaFile = path + "testsequencereader.fasta";
+    qualFile = path + "testsequencereader.qual";
+    fastqFile = path + "testsequencereader.fastq";
+    largeFile = path + "testsequencereader.large.fasta";
+
+    ofstream out;
+    util.openOutputFile(fastaFile, out);
+    out << ">seq1 first comment\nACGT\nacgt\n>seq2\n\nGG-TT..\n\n>seq3\n>seq4\tlast\r\nAAAA";
+    out.close();
+
+    util.openOutputFile(qualFile, out);
+    out << ">seq1\n40 39 38\n37\n>seq2\n20 20\n";
+    out.close();
+
+    util.openOutputFile(fastqFile, out);
+    out << "@read1\nACGT\n+\nIIII\n\n@read2 extra\nGGC\n+read2\nHHH\n";
+    out.close();
+
+    //a record larger than the reader's block
+    largeSeq = "";
+    for (int i = 0; i < (3 * SEQUENCE_READER_BLOCK_SIZE) / 4; i++) { largeSeq += "ACGT"; }
+    util.openOutputFile(largeFile, out);
+    out << ">large\n";
+    for (int i = 0; i < largeSeq.length(); i += 80) { out << largeSeq.substr(i, 80) << '\n'; }
+    out << ">small\nCCCC\n";
+    out.close();
+}
+/**************************************************************************************************/
+TestSequenceReader::~TestSequenceReader() {
+    util.mothurRemove(fastaFile); util.mothurRemove(qualFile); util.mothurRemove(fastqFile); util.mothurRemove(largeFile);
+}
+/**************************************************************************************************/
+
+TEST(TestSequenceReader, readFasta) {
+    TestSequenceReader test;
+    SequenceReader reader(test.fastaFile);
+    TextSpan name, comment, body;
+
+    ASSERT_TRUE(reader.readFasta(name, comment, body));
+    EXPECT_EQ("seq1", name.toString());
+    EXPECT_EQ(" first comment", comment.toString());
+    EXPECT_EQ("ACGT\nacgt\n", body.toString());
+
+    ASSERT_TRUE(reader.readFasta(name, comment, body));
+    EXPECT_EQ("seq2", name.toString());
+    EXPECT_EQ("", comment.toString());
+    EXPECT_EQ("GG-TT..\n\n", body.toString());
+
+    ASSERT_TRUE(reader.readFasta(name, comment, body));
+    EXPECT_EQ("seq3", name.toString());
+    EXPECT_EQ("", body.toString());
+
+    ASSERT_TRUE(reader.readFasta(name, comment, body));
+    EXPECT_EQ("seq4", name.toString());
+    EXPECT_EQ("\tlast", comment.toString());
+    EXPECT_EQ("AAAA", body.toString());
+
+    EXPECT_TRUE(reader.eof());
+    EXPECT_FALSE(reader.readFasta(name, comment, body));
+}
+
+TEST(TestSequenceReader, sequenceMatchesIfstream) {
+    TestSequenceReader test;
+    SequenceReader reader(test.fastaFile);
+    ifstream in; test.util.openInputFile(test.fastaFile, in);
+
+    for (int i = 0; i < 4; i++) {
+        Sequence fromReader(reader);
+        Sequence fromStream(in); test.util.gobble(in);
+
+        EXPECT_EQ(fromStream.getName(), fromReader.getName());
+        EXPECT_EQ(fromStream.getAligned(), fromReader.getAligned());
+        EXPECT_EQ(fromStream.getComment(), fromReader.getComment());
+    }
+    in.close();
+}
+
+TEST(TestSequenceReader, qualityScores) {
+    TestSequenceReader test;
+    SequenceReader reader(test.qualFile);
+
+    QualityScores first(reader);
+    EXPECT_EQ("seq1", first.getName());
+    vector<int> scores = first.getScores();
+    ASSERT_EQ(4, scores.size());
+    EXPECT_EQ(40, scores[0]);
+    EXPECT_EQ(37, scores[3]);
+
+    QualityScores second(reader);
+    EXPECT_EQ("seq2", second.getName());
+    EXPECT_EQ(2, second.getScores().size());
+}
+
+TEST(TestSequenceReader, readFastq) {
+    TestSequenceReader test;
+    SequenceReader reader(test.fastqFile);
+    TextSpan header, sequence, header2, quality;
+
+    ASSERT_TRUE(reader.readFastq(header, sequence, header2, quality));
+    EXPECT_EQ("@read1", header.toString());
+    EXPECT_EQ("ACGT", sequence.toString());
+    EXPECT_EQ("+", header2.toString());
+    EXPECT_EQ("IIII", quality.toString());
+
+    ASSERT_TRUE(reader.readFastq(header, sequence, header2, quality));
+    EXPECT_EQ("@read2 extra", header.toString());
+    EXPECT_EQ("GGC", sequence.toString());
+    EXPECT_EQ("+read2", header2.toString());
+    EXPECT_EQ("HHH", quality.toString());
+
+    EXPECT_FALSE(reader.readFastq(header, sequence, header2, quality));
+}
+
+TEST(TestSequenceReader, seek) {
+    TestSequenceReader test;
+    SequenceReader reader(test.fastaFile);
+    TextSpan name, comment, body;
+
+    reader.readFasta(name, comment, body);
+    unsigned long long second = reader.getPosition();
+    reader.readFasta(name, comment, body);
+    reader.readFasta(name, comment, body);
+
+    reader.seek(second);
+    ASSERT_TRUE(reader.readFasta(name, comment, body));
+    EXPECT_EQ("seq2", name.toString());
+
+    SequenceReader fromOffset(test.fastaFile, second);
+    ASSERT_TRUE(fromOffset.readFasta(name, comment, body));
+    EXPECT_EQ("seq2", name.toString());
+}
+
+TEST(TestSequenceReader, recordLargerThanBlock) {
+    TestSequenceReader test;
+    SequenceReader reader(test.largeFile);
+
+    Sequence large(reader);
+    EXPECT_EQ("large", large.getName());
+    EXPECT_EQ(test.largeSeq, large.getAligned());
+
+    Sequence small(reader);
+    EXPECT_EQ("small", small.getName());
+    EXPECT_EQ("CCCC", small.getAligned());
+}
+/**************************************************************************************************/
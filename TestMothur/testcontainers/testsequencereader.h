@@ -0,0 +1,31 @@
+//
+//  testsequencereader.h
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef __Mothur__testsequencereader__
+#define __Mothur__testsequencereader__
+
+#include "gtest.h"
+#include "sequencereader.hpp"
+#include "sequence.hpp"
+#include "qualityscores.h"
+
+class TestSequenceReader {
+
+public:
+
+    TestSequenceReader();
+    ~TestSequenceReader();
+
+    MothurOut* m;
+    Utils util;
+    string fastaFile, qualFile, fastqFile, largeFile;
+    string largeSeq;
+
+};
+
+#endif /* defined(__Mothur__testsequencereader__) */
@@ -0,0 +1,115 @@
+//
+//  testrarecalc.cpp
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "testrarecalc.hpp"
+#include <bitset>
+
+/**************************************************************************************************/
+TestRareCalc::TestRareCalc() {  //setup
+    m = MothurOut::getInstance();
+    
+    int a[] = { 1, 1, 2, 3, 1, 4 };
+    abunds.assign(a, a+6);
+    
+    int g1[] = { 1, 0, 2, 0, 0 };
+    int g2[] = { 0, 3, 1, 0, 0 };
+    int g3[] = { 1, 0, 0, 0, 5 };
+    int g4[] = { 0, 0, 4, 1, 0 };
+    int g5[] = { 2, 0, 0, 0, 1 };
+    groups.push_back(vector<int>(g1, g1+5)); groups.push_back(vector<int>(g2, g2+5)); groups.push_back(vector<int>(g3, g3+5));
+    groups.push_back(vector<int>(g4, g4+5)); groups.push_back(vector<int>(g5, g5+5));
+}
+/**************************************************************************************************/
+TestRareCalc::~TestRareCalc() {}
+/**************************************************************************************************/
+vector<double> TestRareCalc::enumerateSeqs(int n) {
+    vector<int> otus; //the otu of each sequence
+    for (int i = 0; i < abunds.size(); i++) { for (int j = 0; j < abunds[i]; j++) { otus.push_back(i); } }
+    
+    double total = 0, totalSquares = 0, numSubsamples = 0;
+    for (unsigned int mask = 0; mask < (1u << otus.size()); mask++) {
+        if (bitset<32>(mask).count() != n) { continue; }
+        set<int> observed;
+        for (int i = 0; i < otus.size(); i++) { if (mask & (1u << i)) { observed.insert(otus[i]); } }
+        total += observed.size(); totalSquares += observed.size() * observed.size(); numSubsamples++;
+    }
+    
+    double mean = total / numSubsamples;
+    vector<double> results; results.push_back(mean); results.push_back((totalSquares / numSubsamples) - (mean * mean));
+    return results;
+}
+/**************************************************************************************************/
+vector<double> TestRareCalc::enumerateGroups(int n) {
+    double total = 0, totalSquares = 0, numSubsamples = 0;
+    for (unsigned int mask = 0; mask < (1u << groups.size()); mask++) {
+        if (bitset<32>(mask).count() != n) { continue; }
+        set<int> observed;
+        for (int i = 0; i < groups.size(); i++) {
+            if (mask & (1u << i)) { for (int j = 0; j < groups[i].size(); j++) { if (groups[i][j] != 0) { observed.insert(j); } } }
+        }
+        total += observed.size(); totalSquares += observed.size() * observed.size(); numSubsamples++;
+    }
+    
+    double mean = total / numSubsamples;
+    vector<double> results; results.push_back(mean); results.push_back((totalSquares / numSubsamples) - (mean * mean));
+    return results;
+}
+/**************************************************************************************************/
+
+TEST(TestRareCalc, sequenceSubsamples) {
+    TestRareCalc test;
+    RAbundVector rabund;
+    for (int i = 0; i < test.abunds.size(); i++) { rabund.push_back(test.abunds[i]); }
+    SAbundVector sabund = rabund.getSAbundVector();
+    RareCalc calc(&sabund);
+    
+    for (int n = 1; n <= rabund.getNumSeqs(); n++) {
+        vector<double> expected = test.enumerateSeqs(n);
+        EstOutput result = calc.getValues(n);
+        
+        ASSERT_NEAR(expected[0], result[0], 0.000001); //expected otus observed
+        
+        double sd = (result[2] - result[0]) / 1.96;
+        ASSERT_NEAR(expected[1], sd * sd, 0.000001); //variance
+        ASSERT_NEAR(result[0] - result[1], result[2] - result[0], 0.000001);
+    }
+}
+
+TEST(TestRareCalc, allSequences) {
+    TestRareCalc test;
+    RAbundVector rabund;
+    for (int i = 0; i < test.abunds.size(); i++) { rabund.push_back(test.abunds[i]); }
+    SAbundVector sabund = rabund.getSAbundVector();
+    RareCalc calc(&sabund);
+    
+    EstOutput result = calc.getValues(rabund.getNumSeqs());
+    
+    ASSERT_NEAR(6, result[0], 0.000001);
+    ASSERT_NEAR(6, result[1], 0.000001);
+    ASSERT_NEAR(6, result[2], 0.000001);
+}
+
+TEST(TestRareCalc, groupSubsamples) {
+    TestRareCalc test;
+    vector<SharedRAbundVector*> lookup;
+    for (int i = 0; i < test.groups.size(); i++) { lookup.push_back(new SharedRAbundVector(test.groups[i])); }
+    RareCalc calc(lookup);
+    
+    for (int n = 1; n <= lookup.size(); n++) {
+        vector<double> expected = test.enumerateGroups(n);
+        EstOutput result = calc.getValues(n);
+        
+        ASSERT_NEAR(expected[0], result[0], 0.000001); //expected otus observed
+        
+        double sd = (result[2] - result[0]) / 1.96;
+        ASSERT_NEAR(expected[1], sd * sd, 0.000001); //variance
+    }
+    
+    for (int i = 0; i < lookup.size(); i++) { delete lookup[i]; }
+}
+/**************************************************************************************************/
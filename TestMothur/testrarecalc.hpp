@@ -0,0 +1,36 @@
+//
+//  testrarecalc.hpp
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef testrarecalc_hpp
+#define testrarecalc_hpp
+
+#include "gtest.h"
+#include "rarecalc.h"
+#include "rabundvector.hpp"
+#include "sharedrabundvector.hpp"
+
+//compares RareCalc to the mean and variance of the otus observed over every possible subsample
+class TestRareCalc {
+    
+public:
+    
+    TestRareCalc();
+    ~TestRareCalc();
+    
+    vector<int> abunds; //otu abundances
+    vector< vector<int> > groups; //otu abundances in each group
+    
+    vector<double> enumerateSeqs(int); //mean and variance of the otus observed in every subsample of n sequences
+    vector<double> enumerateGroups(int); //mean and variance of the otus observed in every subsample of n groups
+    
+private:
+    MothurOut* m;
+    
+};
+
+#endif /* testrarecalc_hpp */
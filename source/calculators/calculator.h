@@ -15,6 +15,39 @@ EstOutput getValues(SharedRAbundVector* shared1, SharedRAbundVector* shared2), w
 
 typedef vector<double> EstOutput;
 
+/***********************************************************************/
+//sums over the otus of a pair of groups, gathered in one pass and shared by the calculators that only need these.
+//The sums of powers are kept as counts, so they are exact.
+struct SharedPairStats {
+	double numBins, S1, S2, S12; //otus, otus in A, otus in B, otus in both
+	double sumA, sumB, sumMin, sumAbsDiff, sumSqDiff;
+	double sumAA, sumBB, sumAB, sumAAA, sumBBB, sumAAB, sumABB;
+
+	SharedPairStats(const vector<int>& A, const vector<int>& B) {
+		clear();
+		for (int i = 0; i < A.size(); i++) { addOTU(A[i], B[i]); }
+	}
+
+private:
+	void clear() {
+		numBins = 0; S1 = 0; S2 = 0; S12 = 0;
+		sumA = 0; sumB = 0; sumMin = 0; sumAbsDiff = 0; sumSqDiff = 0;
+		sumAA = 0; sumBB = 0; sumAB = 0; sumAAA = 0; sumBBB = 0; sumAAB = 0; sumABB = 0;
+	}
+	inline void addOTU(double a, double b) {
+		numBins++;
+		if (a != 0) { S1++; }
+		if (b != 0) { S2++; }
+		if ((a != 0) && (b != 0)) { S12++; }
+		sumA += a; sumB += b;
+		sumMin += ((a < b) ? a : b);
+		sumAbsDiff += fabs(a - b);
+		sumSqDiff += (a - b) * (a - b);
+		sumAA += a * a; sumBB += b * b; sumAB += a * b;
+		sumAAA += a * a * a; sumBBB += b * b * b; sumAAB += a * a * b; sumABB += a * b * b;
+	}
+};
+
 /***********************************************************************/
 
 class Calculator {
@@ -29,6 +62,9 @@ public:
 	virtual EstOutput getValues(vector<SharedRAbundVector*>) = 0;
     //optional calc that returns the otus labels of shared otus
     virtual EstOutput getValues(vector<SharedRAbundVector*> sv , vector<string>&) { data = getValues(sv); return data; }
+    //optional calc for a pair of groups that only needs the SharedPairStats
+    virtual bool hasPairStats()     {   return false;       }
+    virtual EstOutput getValues(SharedPairStats&) { return data; }
 	virtual void print(ostream& f)	{ f.setf(ios::fixed, ios::floatfield); f.setf(ios::showpoint);
 									  f << data[0]; for(int i=1;i<data.size();i++){	f << '\t' << data[i];	}}
     
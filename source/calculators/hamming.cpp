@@ -40,4 +40,17 @@ EstOutput Hamming::getValues(vector<SharedRAbundVector*> shared) {
 	}
 }
 /***********************************************************************/
+EstOutput Hamming::getValues(SharedPairStats& stats) {
+	try {
+		data.resize(1,0);
+		data[0] = stats.S1 + stats.S2 - (2 * stats.S12);
+		if (isnan(data[0]) || isinf(data[0])) { data[0] = 0; }
+		return data;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Hamming", "getValues");
+		exit(1);
+	}
+}
+/***********************************************************************/
 
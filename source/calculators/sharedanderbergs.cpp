@@ -44,5 +44,18 @@ EstOutput Anderberg::getValues(vector<SharedRAbundVector*> shared) {
 		exit(1);
 	}
 }
+/***********************************************************************/
+EstOutput Anderberg::getValues(SharedPairStats& stats) {
+	try {
+		data.resize(1,0);
+		data[0] = 1.0 - stats.S12 / ((float)((2 * stats.S1) + (2 * stats.S2) - (3 * stats.S12)));
+		if (isnan(data[0]) || isinf(data[0])) { data[0] = 0; }
+		return data;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Anderberg", "getValues");
+		exit(1);
+	}
+}
 
 /***********************************************************************/
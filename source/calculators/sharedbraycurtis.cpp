@@ -48,5 +48,18 @@ EstOutput BrayCurtis::getValues(vector<SharedRAbundVector*> shared) {
 		exit(1);
 	}
 }
+/***********************************************************************/
+EstOutput BrayCurtis::getValues(SharedPairStats& stats) {
+	try {
+		data.resize(1,0);
+		data[0] = 1.0 - (2 * stats.sumMin) / (float)(stats.sumA + stats.sumB);
+		if (isnan(data[0]) || isinf(data[0])) { data[0] = 0; }
+		return data;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "BrayCurtis", "getValues");
+		exit(1);
+	}
+}
 
 /***********************************************************************/
@@ -44,5 +44,18 @@ EstOutput Kulczynski::getValues(vector<SharedRAbundVector*> shared) {
 		exit(1);
 	}
 }
+/***********************************************************************/
+EstOutput Kulczynski::getValues(SharedPairStats& stats) {
+	try {
+		data.resize(1,0);
+		data[0] = 1.0 - stats.S12 / (float)(stats.S1 + stats.S2 - (2 * stats.S12));
+		if (isnan(data[0]) || isinf(data[0])) { data[0] = 0; }
+		return data;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Kulczynski", "getValues");
+		exit(1);
+	}
+}
 
 /***********************************************************************/
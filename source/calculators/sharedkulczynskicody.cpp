@@ -44,5 +44,18 @@ EstOutput KulczynskiCody::getValues(vector<SharedRAbundVector*> shared) {
 		exit(1);
 	}
 }
+/***********************************************************************/
+EstOutput KulczynskiCody::getValues(SharedPairStats& stats) {
+	try {
+		data.resize(1,0);
+		data[0] = 1.0 - 0.5 * ((stats.S12 / (float)stats.S1) + (stats.S12 / (float)stats.S2));
+		if (isnan(data[0]) || isinf(data[0])) { data[0] = 0; }
+		return data;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "KulczynskiCody", "getValues");
+		exit(1);
+	}
+}
 
 /***********************************************************************/
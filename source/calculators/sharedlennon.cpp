@@ -50,5 +50,22 @@ EstOutput Lennon::getValues(vector<SharedRAbundVector*> shared) {
 		exit(1);
 	}
 }
+/***********************************************************************/
+EstOutput Lennon::getValues(SharedPairStats& stats) {
+	try {
+		data.resize(1,0);
+		double tempA = stats.S1 - stats.S12;
+		double tempB = stats.S2 - stats.S12;
+		double min = tempB;
+		if (tempA < tempB) { min = tempA; }
+		data[0] = 1.0 - stats.S12 / (float)(stats.S12 + min);
+		if (isnan(data[0]) || isinf(data[0])) { data[0] = 0; }
+		return data;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Lennon", "getValues");
+		exit(1);
+	}
+}
 
 /***********************************************************************/
@@ -23,6 +23,12 @@ public:
 		data[0] = (double)shared[0]->getNumSeqs() + (double)shared[1]->getNumSeqs();
 		return data;
 	}
+	EstOutput getValues(SharedPairStats& stats) {
+		data.resize(1,0);
+		data[0] = stats.sumA + stats.sumB;
+		return data;
+	}
+	bool hasPairStats() { return true; }
 	string getCitation() { return "http://www.mothur.org/wiki/Sharednseqs"; }
 };
 
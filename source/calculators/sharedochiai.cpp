@@ -44,5 +44,18 @@ EstOutput Ochiai::getValues(vector<SharedRAbundVector*> shared) {
 		exit(1);
 	}
 }
+/***********************************************************************/
+EstOutput Ochiai::getValues(SharedPairStats& stats) {
+	try {
+		data.resize(1,0);
+		data[0] = stats.S12 / ((float)pow((stats.S1 * stats.S2), 0.5));
+		if (isnan(data[0]) || isinf(data[0])) { data[0] = 0; }
+		return data;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Ochiai", "getValues");
+		exit(1);
+	}
+}
 
 /***********************************************************************/
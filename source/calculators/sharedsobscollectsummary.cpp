@@ -39,4 +39,16 @@ EstOutput SharedSobsCS::getValues(vector<SharedRAbundVector*> shared){
 	}
 }
 /***********************************************************************/
+EstOutput SharedSobsCS::getValues(SharedPairStats& stats) {
+	try {
+		data.resize(1,0);
+		data[0] = stats.S12;
+		return data;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SharedSobsCS", "getValues");
+		exit(1);
+	}
+}
+/***********************************************************************/
 
@@ -45,5 +45,18 @@ EstOutput SorClass::getValues(vector<SharedRAbundVector*> shared) {
 		exit(1);
 	}
 }
+/***********************************************************************/
+EstOutput SorClass::getValues(SharedPairStats& stats) {
+	try {
+		data.resize(1,0);
+		data[0] = 1.0-(2 * stats.S12) / (float)(stats.S1 + stats.S2);
+		if (isnan(data[0]) || isinf(data[0])) { data[0] = 0; }
+		return data;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SorClass", "getValues");
+		exit(1);
+	}
+}
 
 /***********************************************************************/
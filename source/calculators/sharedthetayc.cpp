@@ -16,7 +16,6 @@ EstOutput ThetaYC::getValues(vector<SharedRAbundVector*> shared) {
 		
 		double Atotal = 0;
 		double Btotal = 0;
-		double thetaYC = 0;
 		double pi = 0;
 		double qi = 0;
 		double a = 0;
@@ -51,6 +50,41 @@ EstOutput ThetaYC::getValues(vector<SharedRAbundVector*> shared) {
 			sumPsqQ += pi * pi * qi;
 		}
 
+		return calcTheta(Atotal, Btotal, a, b, d, sumPcubed, sumQcubed, sumPQsq, sumPsqQ);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ThetaYC", "getValues");
+		exit(1);
+	}
+}
+/***********************************************************************/
+//the sums of powers are exact counts, so they are only divided by the totals at the end
+EstOutput ThetaYC::getValues(SharedPairStats& stats) {
+	try {
+		double Atotal = stats.sumA;
+		double Btotal = stats.sumB;
+		
+		double a = stats.sumAA / (Atotal * Atotal);
+		double b = stats.sumBB / (Btotal * Btotal);
+		double d = stats.sumAB / (Atotal * Btotal);
+		double sumPcubed = stats.sumAAA / (Atotal * Atotal * Atotal);
+		double sumQcubed = stats.sumBBB / (Btotal * Btotal * Btotal);
+		double sumPQsq = stats.sumABB / (Atotal * Btotal * Btotal);
+		double sumPsqQ = stats.sumAAB / (Atotal * Atotal * Btotal);
+		
+		return calcTheta(Atotal, Btotal, a, b, d, sumPcubed, sumQcubed, sumPQsq, sumPsqQ);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ThetaYC", "getValues");
+		exit(1);
+	}
+}
+/***********************************************************************/
+EstOutput ThetaYC::calcTheta(double Atotal, double Btotal, double a, double b, double d, double sumPcubed, double sumQcubed, double sumPQsq, double sumPsqQ) {
+	try {
+		data.resize(3,0.0000);
+		double thetaYC = 0;
+		
 		thetaYC = d / (a + b - d);
 		
 		if (isnan(thetaYC) || isinf(thetaYC)) { thetaYC = 0; }
@@ -82,7 +116,7 @@ EstOutput ThetaYC::getValues(vector<SharedRAbundVector*> shared) {
 		return data;
 	}
 	catch(exception& e) {
-		m->errorOut(e, "ThetaYC", "getValues");
+		m->errorOut(e, "ThetaYC", "calcTheta");
 		exit(1);
 	}
 }
@@ -23,8 +23,11 @@ public:
 	ThetaYC() :  Calculator("thetayc", 3, false) {};
 	EstOutput getValues(SAbundVector*) {return data;};
 	EstOutput getValues(vector<SharedRAbundVector*>);
+	EstOutput getValues(SharedPairStats&);
+	bool hasPairStats() { return true; }
 	string getCitation() { return "http://www.mothur.org/wiki/Thetayc"; }
 private:
+	EstOutput calcTheta(double, double, double, double, double, double, double, double, double); //totals, a, b, d, and the sums of cubes
 	
 };
 
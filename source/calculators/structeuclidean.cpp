@@ -37,4 +37,17 @@ EstOutput StructEuclidean::getValues(vector<SharedRAbundVector*> shared) {
 	}
 }
 /***********************************************************************/
+EstOutput StructEuclidean::getValues(SharedPairStats& stats) {
+	try {
+		data.resize(1,0);
+		data[0] = sqrt(stats.sumSqDiff);
+		if (isnan(data[0]) || isinf(data[0])) { data[0] = 0; }
+		return data;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "StructEuclidean", "getValues");
+		exit(1);
+	}
+}
+/***********************************************************************/
 
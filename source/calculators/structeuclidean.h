@@ -22,6 +22,8 @@ public:
 	StructEuclidean() :  Calculator("structeuclidean", 1, false) {};
 	EstOutput getValues(SAbundVector*) {return data;};
 	EstOutput getValues(vector<SharedRAbundVector*>);
+	EstOutput getValues(SharedPairStats&);
+	bool hasPairStats() { return true; }
 	string getCitation() { return "http://www.mothur.org/wiki/Structeuclidean"; }
 private:
 	
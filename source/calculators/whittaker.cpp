@@ -31,5 +31,20 @@ EstOutput Whittaker::getValues(vector<SharedRAbundVector*> shared){
 		exit(1);
 	}
 }
+/***********************************************************************/
+EstOutput Whittaker::getValues(SharedPairStats& stats) {
+	try {
+		data.resize(1);
+		int countA = stats.S1;
+		int countB = stats.S2;
+		int sTotal = stats.numBins;
+		data[0] = 2-2*sTotal/(float)(countA+countB);
+		return data;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Whittaker", "getValues");
+		exit(1);
+	}
+}
 
 /***********************************************************************/
@@ -73,7 +73,8 @@ ChimeraSlayer::ChimeraSlayer(string file, string temp, bool trim, map<string, in
 		numNoParents = 0;
 		blastlocation = blas;
 		threadID = tid;
-		
+		databaseLeft = NULL; databaseRight = NULL;
+		numTemplateChecked = 0;
 		
 		createFilter(templateSeqs, 0.0); //just removed columns where all seqs have a gap
 		
@@ -122,7 +123,8 @@ ChimeraSlayer::ChimeraSlayer(string file, string temp, bool trim, map<string, in
 		numNoParents = 0;
 		blastlocation = blas;
 		threadID = tid;
-		
+		databaseLeft = NULL; databaseRight = NULL;
+		numTemplateChecked = 0;
 		
 		createFilter(templateSeqs, 0.0); //just removed columns where all seqs have a gap
 		
@@ -265,73 +267,42 @@ int ChimeraSlayer::doPrep() {
 	}
 }
 //***************************************************************************************************************
-vector<Sequence*> ChimeraSlayer::getTemplate(Sequence q, vector<Sequence*>& userTemplateFiltered) {
+vector<Sequence*> ChimeraSlayer::getTemplate(Sequence q, vector<Sequence*>& thisTemplateFiltered) {
 	try {
 		
 		//when template=self, the query file is sorted from most abundance to least abundant
 		//userTemplate grows as the query file is processed by adding sequences that are not chimeric and more abundant
-		vector<Sequence*> userTemplate;
-		
 		int myAbund = priority[q.getName()];
 		
-		for (int i = 0; i < templateSeqs.size(); i++) {
+		//the queries come in order of abundance, so the sequences checked for an earlier query are still more abundant than this one.
+		//If they are not, start over.
+		if ((numTemplateChecked != 0) && !(priority[templateSeqs[numTemplateChecked-1]->getName()] > myAbund)) {
+			userTemplate.clear(); userTemplateFiltered.clear();
+			numTemplateChecked = 0;
+			if (searchMethod == "kmer") {  delete databaseRight;  delete databaseLeft;  databaseRight = NULL; databaseLeft = NULL; }
+		}
+		
+		for (; numTemplateChecked < templateSeqs.size(); numTemplateChecked++) {
 			
 			if (m->getControl_pressed()) { return userTemplate; } 
 			
 			//have I reached a sequence with the same abundance as myself?
-			if (!(priority[templateSeqs[i]->getName()] > myAbund)) { break; }
+			if (!(priority[templateSeqs[numTemplateChecked]->getName()] > myAbund)) { break; }
 			
 			//if its am not chimeric add it
-			if (chimericSeqs.count(templateSeqs[i]->getName()) == 0) { 
-				userTemplate.push_back(templateSeqs[i]); 
-				if (searchMethod == "distance") { userTemplateFiltered.push_back(filteredTemplateSeqs[i]); }
-			}
+			if (chimericSeqs.count(templateSeqs[numTemplateChecked]->getName()) == 0) { addToTemplate(numTemplateChecked); }
 		}
 		
+		thisTemplateFiltered = userTemplateFiltered;
+		
 		//avoids nuisance error from formatdb for making blank blast database
 		if (userTemplate.size() == 0) {
 			return userTemplate;
 		}
 		
-		string 	kmerDBNameLeft;
-		string 	kmerDBNameRight;
-		
-		//generate the kmerdb to pass to maligner
 		if (searchMethod == "kmer") {
-            Utils util;
-			string templatePath = util.hasPath(templateFileName);
-			string rightTemplateFileName = templatePath + "right." + util.getRootName(util.getSimpleName(templateFileName));
-			databaseRight = new KmerDB(rightTemplateFileName, kmerSize);
-			
-			string leftTemplateFileName = templatePath + "left." + util.getRootName(util.getSimpleName(templateFileName));
-			databaseLeft = new KmerDB(leftTemplateFileName, kmerSize);	
-			
-			
-			for (int i = 0; i < userTemplate.size(); i++) {
-				
-				if (m->getControl_pressed()) { return userTemplate; } 
-				
-				string leftFrag = userTemplate[i]->getUnaligned();
-				leftFrag = leftFrag.substr(0, int(leftFrag.length() * 0.33));
-				
-				Sequence leftTemp(userTemplate[i]->getName(), leftFrag);
-				databaseLeft->addSequence(leftTemp);	
-			}
-			databaseLeft->generateDB();
 			databaseLeft->setNumSeqs(userTemplate.size());
-				
-			for (int i = 0; i < userTemplate.size(); i++) {
-				if (m->getControl_pressed()) { return userTemplate; }  
-					
-				string rightFrag = userTemplate[i]->getUnaligned();
-				rightFrag = rightFrag.substr(int(rightFrag.length() * 0.66));
-					
-				Sequence rightTemp(userTemplate[i]->getName(), rightFrag);
-				databaseRight->addSequence(rightTemp);	
-			}
-			databaseRight->generateDB();
 			databaseRight->setNumSeqs(userTemplate.size());
-	
 		}else if (searchMethod == "blast") {
 			
 			//generate blastdb
@@ -353,13 +324,45 @@ vector<Sequence*> ChimeraSlayer::getTemplate(Sequence q, vector<Sequence*>& user
 		exit(1);
 	}
 }
-
+//***************************************************************************************************************
+//for template=self, adds templateSeqs[index] to the userTemplate. The kmer databases are kept between queries and only get the
+//new sequence's left and right fragments added, instead of being rebuilt from the whole userTemplate.
+void ChimeraSlayer::addToTemplate(int index) {
+	try {
+		userTemplate.push_back(templateSeqs[index]);
+		if (searchMethod == "distance") { userTemplateFiltered.push_back(filteredTemplateSeqs[index]); }
+		
+		if (searchMethod == "kmer") {
+			if (databaseLeft == NULL) {
+				Utils util;
+				string templatePath = util.hasPath(templateFileName);
+				string rightTemplateFileName = templatePath + "right." + util.getRootName(util.getSimpleName(templateFileName));
+				databaseRight = new KmerDB(rightTemplateFileName, kmerSize);
+				
+				string leftTemplateFileName = templatePath + "left." + util.getRootName(util.getSimpleName(templateFileName));
+				databaseLeft = new KmerDB(leftTemplateFileName, kmerSize);
+			}
+			
+			string unaligned = templateSeqs[index]->getUnaligned();
+			
+			Sequence leftTemp(templateSeqs[index]->getName(), unaligned.substr(0, int(unaligned.length() * 0.33)));
+			databaseLeft->addSequence(leftTemp);
+			
+			Sequence rightTemp(templateSeqs[index]->getName(), unaligned.substr(int(unaligned.length() * 0.66)));
+			databaseRight->addSequence(rightTemp);
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ChimeraSlayer", "addToTemplate");
+		exit(1);
+	}
+}
 //***************************************************************************************************************
 ChimeraSlayer::~ChimeraSlayer() { 	
 	if (templateFileName != "self") {
 		if (searchMethod == "kmer") {  delete databaseRight;  delete databaseLeft;  }	
 		else if (searchMethod == "blast") {  delete databaseLeft; }
-	}
+	}else if (searchMethod == "kmer") {  delete databaseRight;  delete databaseLeft;  } //kept for the whole run, see getTemplate
 }
 //***************************************************************************************************************
 void ChimeraSlayer::printHeader(ostream& out) {
@@ -549,8 +552,7 @@ int ChimeraSlayer::getChimeras(Sequence* query) {
 		Slayer slayer(window, increment, minSim, divR, iters, minSNP, minBS);
 		
 		if (templateFileName == "self") {
-			if (searchMethod == "kmer") {  delete databaseRight;  delete databaseLeft;  }	
-			else if (searchMethod == "blast") {  delete databaseLeft; }
+			if (searchMethod == "blast") {  delete databaseLeft; }
 		}
 	
 		if (m->getControl_pressed()) {  return 0;  }
@@ -46,6 +46,8 @@ class ChimeraSlayer : public MothurChimera {
 		Database* databaseLeft;
 		map<string, int> priority; //for template=self, seqname, seqAligned, abundance
 		set<string> chimericSeqs; //for template=self, so we don't add chimeric sequences to the userTemplate set
+		vector<Sequence*> userTemplate, userTemplateFiltered; //for template=self, the templateSeqs checked so far that are not chimeric
+		int numTemplateChecked; //for template=self, number of templateSeqs added to or skipped from the userTemplate
 		int numNoParents, threadID;
 	
 		vector<data_struct>  chimeraResults;
@@ -61,6 +63,7 @@ class ChimeraSlayer : public MothurChimera {
 		string getBlock(data_results, data_results, bool, bool, string);
 		//int readNameFile(string);
 		vector<Sequence*> getTemplate(Sequence, vector<Sequence*>&);
+		void addToTemplate(int);
 		vector<Sequence> getRefSeqs(Sequence, vector<Sequence*>&, vector<Sequence*>&);
 		vector<Sequence> getBlastSeqs(Sequence, vector<Sequence*>&, int);
 		vector<Sequence> getKmerSeqs(Sequence, vector<Sequence*>&, int);
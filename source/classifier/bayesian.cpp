@@ -278,18 +278,18 @@ string Bayesian::bootstrapResults(vector<int> kmers, int tax, int numToSelect, s
 			//get taxonomy
 			int newTax = getMostProbableTaxonomy(temp);
 			//int newTax = 1;
-			TaxNode taxonomyTemp = phyloTree->get(newTax);
+			const TaxNode* taxonomyTemp = &(phyloTree->get(newTax));
 			
 			//add to confidence results
-			while (taxonomyTemp.level != 0) { //while you are not at the root
+			while (taxonomyTemp->level != 0) { //while you are not at the root
 				itBoot2 = confidenceScores.find(newTax); //is this a classification we already have a count on
 				
 				if (itBoot2 != confidenceScores.end()) { //this is a classification we need a confidence for
 					(itBoot2->second)++;
 				}
 				
-				newTax = taxonomyTemp.parent;
-				taxonomyTemp = phyloTree->get(newTax);
+				newTax = taxonomyTemp->parent;
+				taxonomyTemp = &(phyloTree->get(newTax));
 			}
 	
 		}
@@ -105,29 +105,30 @@ string Knn::findCommonTaxonomy(vector<string> closest)  {
 		//build tree
 		p->assignHeirarchyIDs(0);
 		
-		TaxNode currentNode = p->get(0);
+		int currentNode = 0;
 		
 		//at each level
-		while (currentNode.children.size() != 0) { //you still have more to explore
+		while (p->getChildren(currentNode).size() != 0) { //you still have more to explore
 			
-			TaxNode bestChild;
+			int bestChild = -1;
 			int bestChildSize = 0;
 			
 			//go through children
-			for (map<string, int>::iterator itChild = currentNode.children.begin(); itChild != currentNode.children.end(); itChild++) {
+			const vector<int>& children = p->getChildren(currentNode);
+			for (int i = 0; i < children.size(); i++) {
 				
-				TaxNode temp = p->get(itChild->second);
+				const TaxNode& temp = p->get(children[i]);
 				
 				//select child with largest accessions - most seqs assigned to it
 				if (temp.accessions.size() > bestChildSize) {
-					bestChild = p->get(itChild->second);
+					bestChild = children[i];
 					bestChildSize = temp.accessions.size();
 				}
 				
 			}
 			
-			if (bestChildSize == closest.size()) { //if yes, add it
-				conTax += bestChild.name + ";";
+			if ((bestChild != -1) && (bestChildSize == closest.size())) { //if yes, add it
+				conTax += p->get(bestChild).name + ";";
 			}else{ //if no, quit
 				break;
 			}
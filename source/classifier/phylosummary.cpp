@@ -21,6 +21,7 @@ PhyloSummary::PhyloSummary(string refTfile, CountTable* c, bool r, int p){
 		
 		ct = c;
         groupmap = NULL;
+        setGroups();
         
 		//check for necessary files
 		string taxFileNameTest = util.getFullPathName((refTfile.substr(0,refTfile.find_last_of(".")+1) + "tree.sum"));
@@ -55,8 +56,10 @@ PhyloSummary::PhyloSummary(CountTable* c, bool r, int p){
 		
 		ct = c;
         groupmap = NULL;
+        setGroups();
 		
-		tree.push_back(rawTaxNode("Root"));
+		tree.push_back(TaxSummaryNode(-1, 0, groupNames.size()));
+		taxonomy.addNode("Root");
 		tree[0].rank = "0";
 	}
 	catch(exception& e) {
@@ -76,6 +79,7 @@ PhyloSummary::PhyloSummary(string refTfile, GroupMap* g, bool r, int p){
 		
 		groupmap = g;
         ct = NULL;
+        setGroups();
 				
 		//check for necessary files
 		string taxFileNameTest = util.getFullPathName((refTfile.substr(0,refTfile.find_last_of(".")+1) + "tree.sum"));
@@ -110,8 +114,10 @@ PhyloSummary::PhyloSummary(GroupMap* g, bool r, int p){
 		
 		groupmap = g;
         ct = NULL;
+        setGroups();
 		
-		tree.push_back(rawTaxNode("Root"));
+		tree.push_back(TaxSummaryNode(-1, 0, groupNames.size()));
+		taxonomy.addNode("Root");
 		tree[0].rank = "0";
 	}
 	catch(exception& e) {
@@ -160,140 +166,94 @@ string PhyloSummary::getNextTaxon(string& heirarchy){
 
 /**************************************************************************************************/
 
-int PhyloSummary::addSeqToTree(string seqName, string seqTaxonomy){
+void PhyloSummary::setGroups(){
 	try {
-				
-		numSeqs++;
+		groupNames.clear(); groupIndexes.clear();
 		
-		map<string, int>::iterator childPointer;
+		if (groupmap != NULL) { groupNames = groupmap->getNamesOfGroups(); }
+		else if (ct != NULL) {
+			if (ct->hasGroupInfo()) { groupNames = ct->getNamesOfGroups(); }
+		}
 		
-		int currentNode = 0;
-		string taxon;
+		for (int i = 0; i < groupNames.size(); i++) { groupIndexes[groupNames[i]] = i; }
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PhyloSummary", "setGroups");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+double PhyloSummary::getGroupSize(int i){
+	try {
+		if (groupmap != NULL) { return groupmap->getNumSeqs(groupNames[i]); }
+		else if (ct != NULL) { return ct->getGroupCount(groupNames[i]); }
 		
-		int level = 0;
+		return 0;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PhyloSummary", "getGroupSize");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+int PhyloSummary::addChild(int parent, string taxon, int level){
+	try {
+		tree.push_back(TaxSummaryNode(parent, level, groupNames.size()));
+		int index = taxonomy.addNode(taxon);
+		taxonomy.addChild(parent, index);
 		
-		//are there confidence scores, if so remove them
-		if (seqTaxonomy.find_first_of('(') != -1) {  util.removeConfidences(seqTaxonomy);	}
+		return index;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PhyloSummary", "addChild");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+int PhyloSummary::addSeqToTree(string seqName, string seqTaxonomy){
+	try {
+		//the seqs count and group counts are the same at every level of its taxonomy
+		int thisCount = 1;
+		vector<int> groupCounts;
 		
-		while (seqTaxonomy != "") {
-			
-            level++;
-            
-			if (m->getControl_pressed()) { return 0; }
-			
-			//somehow the parent is getting one too many accnos
-			//use print to reassign the taxa id
-			taxon = getNextTaxon(seqTaxonomy);
+		if (groupmap != NULL) {
+			//find out the sequences group
+			string group = groupmap->getGroup(seqName);
 			
-			childPointer = tree[currentNode].children.find(taxon);
+			if (group == "not found") {  m->mothurOut("[WARNING]: " + seqName + " is not in your groupfile, and will be included in the overall total, but not any group total."); m->mothurOutEndLine();  }
 			
-			if(childPointer != tree[currentNode].children.end()){	//if the node already exists, update count and move on
-				int thisCount = 1;
-                
-                if (groupmap != NULL) {
-					//find out the sequences group
-					string group = groupmap->getGroup(seqName);
-					
-					if (group == "not found") {  m->mothurOut("[WARNING]: " + seqName + " is not in your groupfile, and will be included in the overall total, but not any group total."); m->mothurOutEndLine();  }
-					
-					//do you have a count for this group?
-					map<string, int>::iterator itGroup = tree[childPointer->second].groupCount.find(group);
-					
-					//if yes, increment it - there should not be a case where we can't find it since we load group in read
-					if (itGroup != tree[childPointer->second].groupCount.end()) {
-						tree[childPointer->second].groupCount[group]++;
-					}
-				}else if (ct != NULL) {
-                    if (ct->hasGroupInfo()) {
-                        vector<int> groupCounts = ct->getGroupCounts(seqName);
-                        vector<string> groups = ct->getNamesOfGroups();
-                        for (int i = 0; i < groups.size(); i++) {
-                            
-                            if (groupCounts[i] != 0) {
-                                //do you have a count for this group?
-                                map<string, int>::iterator itGroup = tree[childPointer->second].groupCount.find(groups[i]);
-                                
-                                //if yes, increment it - there should not be a case where we can't find it since we load group in read
-                                if (itGroup != tree[childPointer->second].groupCount.end()) {
-                                    tree[childPointer->second].groupCount[groups[i]] += groupCounts[i];
-                                }
-                            }
-                        }
-                    }
-                    thisCount = ct->getNumSeqs(seqName);
-                }
-				
-				tree[childPointer->second].total += thisCount;
+			groupCounts.resize(groupNames.size(), 0);
+			unordered_map<string, int>::iterator itGroup = groupIndexes.find(group);
+			if (itGroup != groupIndexes.end()) { groupCounts[itGroup->second] = 1; }
+		}else if (ct != NULL) {
+			if (ct->hasGroupInfo()) { groupCounts = ct->getGroupCounts(seqName); }
+			thisCount = ct->getNumSeqs(seqName);
+		}
+		
+		return addToTree(seqTaxonomy, thisCount, groupCounts, seqName);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PhyloSummary", "addSeqToTree");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
 
-				currentNode = childPointer->second;
-			}else{	
-				if (ignore) {
-						
-					tree.push_back(rawTaxNode(taxon));
-					int index = tree.size() - 1;
-				
-					tree[index].parent = currentNode;
-					tree[index].level = level;
-					tree[currentNode].children[taxon] = index;
-                    int thisCount = 1;
-					
-					//initialize groupcounts
-					if (groupmap != NULL) {
-						vector<string> mGroups = groupmap->getNamesOfGroups();
-						for (int j = 0; j < mGroups.size(); j++) {
-							tree[index].groupCount[mGroups[j]] = 0;
-						}
-						
-						//find out the sequences group
-						string group = groupmap->getGroup(seqName);
-						
-						if (group == "not found") {  m->mothurOut("[WARNING]: " + seqName + " is not in your groupfile, and will be included in the overall total, but not any group total."); m->mothurOutEndLine();  }
-						
-						//do you have a count for this group?
-						map<string, int>::iterator itGroup = tree[index].groupCount.find(group);
-						
-						//if yes, increment it - there should not be a case where we can't find it since we load group in read
-						if (itGroup != tree[index].groupCount.end()) {
-							tree[index].groupCount[group]++;
-						}
-					}else if (ct != NULL) {
-                        if (ct->hasGroupInfo()) {
-                            vector<string> mGroups = ct->getNamesOfGroups();
-                            for (int j = 0; j < mGroups.size(); j++) {
-                                tree[index].groupCount[mGroups[j]] = 0;
-                            }
-                            vector<int> groupCounts = ct->getGroupCounts(seqName);
-                            vector<string> groups = ct->getNamesOfGroups();
-                        
-                            for (int i = 0; i < groups.size(); i++) {
-                                if (groupCounts[i] != 0) {
-                                   
-                                    //do you have a count for this group?
-                                    map<string, int>::iterator itGroup = tree[index].groupCount.find(groups[i]);
-                                     
-                                    //if yes, increment it - there should not be a case where we can't find it since we load group in read
-                                    if (itGroup != tree[index].groupCount.end()) {
-                                        tree[index].groupCount[groups[i]]+=groupCounts[i];
-                                    }
-                                }
-                            }
-                        }
-                        thisCount = ct->getNumSeqs(seqName);
-                    }
-					
-                    tree[index].total = thisCount;
-					currentNode = index;
-					
-				}else{ //otherwise, error
-					m->mothurOut("Warning: cannot find taxon " + taxon + " in reference taxonomy tree at level " + toString(tree[currentNode].level) + " for " + seqName + ". This may cause totals of daughter levels not to add up in summary file."); m->mothurOutEndLine();
-					break;
-				}
+int PhyloSummary::addSeqToTree(string seqTaxonomy, map<string, bool> containsGroup){
+	try {
+		vector<int> groupCounts(groupNames.size(), 0);
+		
+		for (map<string, bool>::iterator itContains = containsGroup.begin(); itContains != containsGroup.end(); itContains++) {
+			if (itContains->second) {
+				unordered_map<string, int>::iterator itGroup = groupIndexes.find(itContains->first);
+				if (itGroup != groupIndexes.end()) { groupCounts[itGroup->second] = 1; }
 			}
-        }
-        
-        if (level > maxLevel) { maxLevel = level; }
-        
-		return 0;
+		}
+		
+		return addToTree(seqTaxonomy, 1, groupCounts, "");
 	}
 	catch(exception& e) {
 		m->errorOut(e, "PhyloSummary", "addSeqToTree");
@@ -302,17 +262,18 @@ int PhyloSummary::addSeqToTree(string seqName, string seqTaxonomy){
 }
 /**************************************************************************************************/
 
-int PhyloSummary::addSeqToTree(string seqTaxonomy, map<string, bool> containsGroup){
+int PhyloSummary::addToTree(string seqTaxonomy, int thisCount, vector<int>& groupCounts, string seqName){
 	try {
 		numSeqs++;
 		
-		map<string, int>::iterator childPointer;
-		
 		int currentNode = 0;
 		string taxon;
 		
 		int level = 0;
 		
+		int numGroups = groupCounts.size();
+		if (numGroups > groupNames.size()) { numGroups = groupNames.size(); }
+		
 		//are there confidence scores, if so remove them
 		if (seqTaxonomy.find_first_of('(') != -1) {  util.removeConfidences(seqTaxonomy);	}
 		
@@ -322,69 +283,50 @@ int PhyloSummary::addSeqToTree(string seqTaxonomy, map<string, bool> containsGro
             
 			if (m->getControl_pressed()) { return 0; }
 			
-			//somehow the parent is getting one too many accnos
-			//use print to reassign the taxa id
 			taxon = getNextTaxon(seqTaxonomy);
 			
-			childPointer = tree[currentNode].children.find(taxon);
+			int child = taxonomy.findChild(currentNode, taxon);
 			
-			if(childPointer != tree[currentNode].children.end()){	//if the node already exists, update count and move on
-                for (map<string, bool>::iterator itGroup = containsGroup.begin(); itGroup != containsGroup.end(); itGroup++) {
-                    if (itGroup->second ) {
-                        tree[childPointer->second].groupCount[itGroup->first]++;
-                    }
-                }
-					
-				tree[childPointer->second].total++;
-				
-				currentNode = childPointer->second;
-			}else{	
-				if (ignore) {
-					
-					tree.push_back(rawTaxNode(taxon));
-					int index = tree.size() - 1;
-					
-					tree[index].parent = currentNode;
-					tree[index].level = level;
-					tree[index].total = 1;
-					tree[currentNode].children[taxon] = index;
-						
-                    for (map<string, bool>::iterator itGroup = containsGroup.begin(); itGroup != containsGroup.end(); itGroup++) {
-                        if (itGroup->second ) {
-                            tree[index].groupCount[itGroup->first]++;
-                        }
-                    }
-					
-					currentNode = index;
-					
+			if (child == -1) {
+				if (ignore) { //otherwise, create it
+					child = addChild(currentNode, taxon, level);
 				}else{ //otherwise, error
-					m->mothurOut("Warning: cannot find taxon " + taxon + " in reference taxonomy tree at level " + toString(tree[currentNode].level) + ". This may cause totals of daughter levels not to add up in summary file."); m->mothurOutEndLine();
+					if (seqName != "") {
+						m->mothurOut("Warning: cannot find taxon " + taxon + " in reference taxonomy tree at level " + toString(tree[currentNode].level) + " for " + seqName + ". This may cause totals of daughter levels not to add up in summary file."); m->mothurOutEndLine();
+					}else {
+						m->mothurOut("Warning: cannot find taxon " + taxon + " in reference taxonomy tree at level " + toString(tree[currentNode].level) + ". This may cause totals of daughter levels not to add up in summary file."); m->mothurOutEndLine();
+					}
 					break;
 				}
 			}
-		}
+			
+			//update count and move on
+			tree[child].total += thisCount;
+			for (int i = 0; i < numGroups; i++) { tree[child].groupCount[i] += groupCounts[i]; }
+			
+			currentNode = child;
+        }
         
         if (level > maxLevel) { maxLevel = level; }
         
 		return 0;
 	}
 	catch(exception& e) {
-		m->errorOut(e, "PhyloSummary", "addSeqToTree");
+		m->errorOut(e, "PhyloSummary", "addToTree");
 		exit(1);
 	}
 }
-
 /**************************************************************************************************/
 
 void PhyloSummary::assignRank(int index){
 	try {
-		map<string,int>::iterator it;
+		const vector<int>& children = taxonomy.getChildren(index);
 		int counter = 1;
         
-		for(it=tree[index].children.begin();it!=tree[index].children.end();it++){
-			tree[it->second].rank = tree[index].rank + '.' + toString(counter);
+		for(int i = 0; i < children.size(); i++){
+			tree[children[i]].rank = tree[index].rank + '.' + toString(counter);
 			counter++;
-			assignRank(it->second);
+			assignRank(children[i]);
 		}
 	}
 	catch(exception& e) {
@@ -417,14 +359,13 @@ string PhyloSummary::findTaxon(string rank){
 
 string PhyloSummary::getTaxons(vector<int> indexes, int index, int i, string& taxon){
     try {
-        int counter = 1;
+        const vector<int>& children = taxonomy.getChildren(i);
         
-        for(map<string,int>::iterator it=tree[i].children.begin();it!=tree[i].children.end();it++){
-            if (counter == indexes[index]) {
-                taxon += tree[it->second].name + ";";
-                getTaxons(indexes, index+1, it->second, taxon);
-            }
-            counter++;
+        //the rank is the position of the child in alphabetical order
+        if ((index < indexes.size()) && (indexes[index] >= 1) && (indexes[index] <= children.size())) {
+            int child = children[indexes[index]-1];
+            taxon += taxonomy.getName(child) + ";";
+            getTaxons(indexes, index+1, child, taxon);
         }
         
         return taxon;
@@ -441,7 +382,6 @@ void PhyloSummary::print(ofstream& out, string output){
 	try {
 		
 		if (ignore)     {  assignRank(0); }
-        vector<string> mGroups;
         
         //print labels
         if (output == "detail") {   out << "taxlevel\trankID\ttaxon\tdaughterlevels\ttotal";  }
@@ -450,86 +390,47 @@ void PhyloSummary::print(ofstream& out, string output){
         if (printlevel == -1) { printlevel = maxLevel; }
         else if (printlevel > maxLevel) { m->mothurOut("[WARNING]: Your printlevel is greater than your maxlevel, adjusting your printlevel to " + toString(maxLevel) + "\n"); printlevel = maxLevel; }
         
-		if (groupmap != NULL) {
-			//so the labels match the counts below, since the map sorts them automatically...
-			//sort(groupmap->namesOfGroups.begin(), groupmap->namesOfGroups.end());
-            mGroups = groupmap->getNamesOfGroups();
-			for (int i = 0; i < mGroups.size(); i++) {
-				out << '\t' << mGroups[i];
-			}
-		}else if (ct != NULL) {
-            if (ct->hasGroupInfo()) {
-                mGroups = ct->getNamesOfGroups();
-                for (int i = 0; i < mGroups.size(); i++) {
-                    out << '\t' << mGroups[i];
-                }
-            }
-        }
+        for (int i = 0; i < groupNames.size(); i++) { out << '\t' << groupNames[i]; }
 		out << endl;
 		
 		int totalChildrenInTree = 0;
-		map<string, int>::iterator itGroup;
-		map<string,int>::iterator it;
-		for(it=tree[0].children.begin();it!=tree[0].children.end();it++){   
-			if (tree[it->second].total != 0)  {   
+		const vector<int>& children = taxonomy.getChildren(0);
+		for(int j = 0; j < children.size(); j++){
+			if (tree[children[j]].total != 0)  {   
 				totalChildrenInTree++; 
-				tree[0].total += tree[it->second].total;
+				tree[0].total += tree[children[j]].total;
 				
-				if (groupmap != NULL) {
-					for (int i = 0; i < mGroups.size(); i++) { tree[0].groupCount[mGroups[i]] += tree[it->second].groupCount[mGroups[i]]; } 
-				}else if ( ct != NULL) {
-                    if (ct->hasGroupInfo()) { for (int i = 0; i < mGroups.size(); i++) { tree[0].groupCount[mGroups[i]] += tree[it->second].groupCount[mGroups[i]]; } }
-                }
+				for (int i = 0; i < groupNames.size(); i++) { tree[0].groupCount[i] += tree[children[j]].groupCount[i]; }
 			}
 		}
 		
-        
-        
-            //print root
-            if (relabund) {
-                out.setf(ios::fixed, ios::floatfield); out.setf(ios::showpoint);
-                
-                if (output == "detail") {
-                    out << tree[0].level << "\t" << tree[0].rank << "\t" << tree[0].name << "\t" << totalChildrenInTree << "\t" << (tree[0].total/(double) tree[0].total);
-                }else{
-                    out << tree[0].name << "\t" << (tree[0].total/(double) tree[0].total);
-                }
-                
-                
-                if (groupmap != NULL) {
-                    for (int i = 0; i < mGroups.size(); i++) {
-                        double thisNum = tree[0].groupCount[mGroups[i]];
-                        thisNum /= (double) groupmap->getNumSeqs(mGroups[i]);
-                        out  << '\t' << thisNum;
-                    }
-                }else if ( ct != NULL) {
-                    if (ct->hasGroupInfo()) {
-                        for (int i = 0; i < mGroups.size(); i++) {
-                            double thisNum = tree[0].groupCount[mGroups[i]];
-                            thisNum /= (double) ct->getGroupCount(mGroups[i]);
-                            out  << '\t' << thisNum;
-                        }
-                    }
-                }
-                out << endl;
-               
-                
-            }else {
-                if (output == "detail") {
-                    out << tree[0].level << "\t" << tree[0].rank << "\t" << tree[0].name << "\t" << totalChildrenInTree << "\t" << tree[0].total;
-                }else{
-                    out << tree[0].name << '\t' << tree[0].total;
-                }
-                
-                if (groupmap != NULL) {
-                    for (int i = 0; i < mGroups.size(); i++) {  out  << '\t'<< tree[0].groupCount[mGroups[i]]; }
-                }else if ( ct != NULL) {
-                    if (ct->hasGroupInfo()) { for (int i = 0; i < mGroups.size(); i++) {  out  << '\t' << tree[0].groupCount[mGroups[i]]; } }
-                }
-                out << endl;
-                
+        //print root
+        if (relabund) {
+            out.setf(ios::fixed, ios::floatfield); out.setf(ios::showpoint);
+            
+            if (output == "detail") {
+                out << tree[0].level << "\t" << tree[0].rank << "\t" << taxonomy.getName(0) << "\t" << totalChildrenInTree << "\t" << (tree[0].total/(double) tree[0].total);
+            }else{
+                out << taxonomy.getName(0) << "\t" << (tree[0].total/(double) tree[0].total);
             }
-        
+            
+            for (int i = 0; i < groupNames.size(); i++) {
+                double thisNum = tree[0].groupCount[i];
+                thisNum /= getGroupSize(i);
+                out  << '\t' << thisNum;
+            }
+            out << endl;
+            
+        }else {
+            if (output == "detail") {
+                out << tree[0].level << "\t" << tree[0].rank << "\t" << taxonomy.getName(0) << "\t" << totalChildrenInTree << "\t" << tree[0].total;
+            }else{
+                out << taxonomy.getName(0) << '\t' << tree[0].total;
+            }
+            
+            for (int i = 0; i < groupNames.size(); i++) {  out  << '\t'<< tree[0].groupCount[i]; }
+            out << endl;
+        }
         
 		//print rest
 		print(0, out, output);
@@ -548,39 +449,24 @@ void PhyloSummary::print(ofstream& out, bool relabund){
 		if (ignore) { assignRank(0); }
 	
 		int totalChildrenInTree = 0;
-		map<string, int>::iterator itGroup;
 		
-		map<string,int>::iterator it;
-		for(it=tree[0].children.begin();it!=tree[0].children.end();it++){
-			if (tree[it->second].total != 0)  {
+		const vector<int>& children = taxonomy.getChildren(0);
+		for(int j = 0; j < children.size(); j++){
+			if (tree[children[j]].total != 0)  {
 				totalChildrenInTree++;
-				tree[0].total += tree[it->second].total;
+				tree[0].total += tree[children[j]].total;
 				
-				if (groupmap != NULL) {
-                    vector<string> mGroups = groupmap->getNamesOfGroups();
-					for (int i = 0; i < mGroups.size(); i++) { tree[0].groupCount[mGroups[i]] += tree[it->second].groupCount[mGroups[i]]; }
-				}else if ( ct != NULL) {
-                    vector<string> mGroups = ct->getNamesOfGroups();
-                    if (ct->hasGroupInfo()) { for (int i = 0; i < mGroups.size(); i++) { tree[0].groupCount[mGroups[i]] += tree[it->second].groupCount[mGroups[i]]; } }
-                }
+				for (int i = 0; i < groupNames.size(); i++) { tree[0].groupCount[i] += tree[children[j]].groupCount[i]; }
 			}
 		}
         
         //print root
-        out << tree[0].name << "\t" << "1.0000"; //root relative abundance is 1, everyone classifies to root
+        out << taxonomy.getName(0) << "\t" << "1.0000"; //root relative abundance is 1, everyone classifies to root
         
-        if (groupmap != NULL) {
-            vector<string> mGroups = groupmap->getNamesOfGroups();
-            for (int i = 0; i < mGroups.size(); i++) {  out  << '\t' << "1.0000"; }
-        }else if ( ct != NULL) {
-            vector<string> mGroups = ct->getNamesOfGroups();
-            if (ct->hasGroupInfo()) { for (int i = 0; i < mGroups.size(); i++) {  out  << '\t' << "1.0000"; } }
-        }
+        for (int i = 0; i < groupNames.size(); i++) {  out  << '\t' << "1.0000"; }
         
         out << endl;
         
-       
-        
 		//print rest
 		print(0, out, relabund);
 		
@@ -594,78 +480,47 @@ void PhyloSummary::print(ofstream& out, bool relabund){
 
 void PhyloSummary::print(int i, ofstream& out, string output){
 	try {
-		map<string,int>::iterator it;
-		for(it=tree[i].children.begin();it!=tree[i].children.end();it++){
+		const vector<int>& children = taxonomy.getChildren(i);
+		for(int j = 0; j < children.size(); j++){
+			int child = children[j];
 			
-			if (tree[it->second].total != 0)  {
+			if (tree[child].total != 0)  {
                 
 				int totalChildrenInTree = 0;
                 
-				map<string,int>::iterator it2;
-				for(it2=tree[it->second].children.begin();it2!=tree[it->second].children.end();it2++){
-					if (tree[it2->second].total != 0)  {   totalChildrenInTree++; }
+				const vector<int>& grandChildren = taxonomy.getChildren(child);
+				for(int k = 0; k < grandChildren.size(); k++){
+					if (tree[grandChildren[k]].total != 0)  {   totalChildrenInTree++; }
 				}
                 
-                if ((output == "detail") && (printlevel >= tree[it->second].level)) {
+                bool printNode = (((output == "detail") && (printlevel >= tree[child].level)) || (printlevel == tree[child].level));
+                
+                if ((output == "detail") && (printlevel >= tree[child].level)) {
                     if (relabund) {
-                        out << tree[it->second].level << "\t" << tree[it->second].rank << "\t" << tree[it->second].name << "\t" << totalChildrenInTree << "\t" << (tree[it->second].total/(double) tree[0].total);
+                        out << tree[child].level << "\t" << tree[child].rank << "\t" << taxonomy.getName(child) << "\t" << totalChildrenInTree << "\t" << (tree[child].total/(double) tree[0].total);
                     }else {
-                        out << tree[it->second].level << "\t" << tree[it->second].rank << "\t" << tree[it->second].name << "\t" << totalChildrenInTree << "\t" << tree[it->second].total;
+                        out << tree[child].level << "\t" << tree[child].rank << "\t" << taxonomy.getName(child) << "\t" << totalChildrenInTree << "\t" << tree[child].total;
                     }
                 }else {
-                    if (printlevel == tree[it->second].level) { //leaf node - we want to print it. Use rank to find full taxonomy
+                    if (printlevel == tree[child].level) { //leaf node - we want to print it. Use rank to find full taxonomy
                         if (relabund) {
-                            out << findTaxon(tree[it->second].rank) << '\t' << tree[it->second].total/(double) tree[0].total;
+                            out << findTaxon(tree[child].rank) << '\t' << tree[child].total/(double) tree[0].total;
                         }else {
-                            out << findTaxon(tree[it->second].rank) << '\t' << tree[it->second].total;
+                            out << findTaxon(tree[child].rank) << '\t' << tree[child].total;
                         }
                     }
                 }
                 
-                if (relabund) {
-                    map<string, int>::iterator itGroup;
-                    if (groupmap != NULL) {
-                        vector<string> mGroups = groupmap->getNamesOfGroups();
-                        for (int i = 0; i < mGroups.size(); i++) {
-                            if (((output == "detail") && (printlevel >= tree[it->second].level)) || (printlevel == tree[it->second].level)) {
-                                out  << '\t' << (tree[it->second].groupCount[mGroups[i]]/(double)groupmap->getNumSeqs(mGroups[i]));
-                            }
-                        }
-                    }else if (ct != NULL) {
-                        if (ct->hasGroupInfo()) {
-                            vector<string> mGroups = ct->getNamesOfGroups();
-                            for (int i = 0; i < mGroups.size(); i++) {
-                                if (((output == "detail") && (printlevel >= tree[it->second].level)) || (printlevel == tree[it->second].level)) {
-                                    out  << '\t' << (tree[it->second].groupCount[mGroups[i]]/(double)ct->getGroupCount(mGroups[i]));
-                                }
-                            }
-                        }
-                    }
-                }else {
-                    map<string, int>::iterator itGroup;
-                    if (groupmap != NULL) {
-                        vector<string> mGroups = groupmap->getNamesOfGroups();
-                        for (int i = 0; i < mGroups.size(); i++) {
-                            if (((output == "detail") && (printlevel >= tree[it->second].level)) || (printlevel == tree[it->second].level)) {
-                                out  << '\t' << tree[it->second].groupCount[mGroups[i]];
-                            }
-                        }
-                    }else if (ct != NULL) {
-                        if (ct->hasGroupInfo()) {
-                            vector<string> mGroups = ct->getNamesOfGroups();
-                            for (int i = 0; i < mGroups.size(); i++) {
-                                if (((output == "detail") && (printlevel >= tree[it->second].level)) || (printlevel == tree[it->second].level)) {
-                                    out  << '\t' << tree[it->second].groupCount[mGroups[i]];
-                                }
-                            }
-                        }
+                if (printNode) {
+                    for (int g = 0; g < groupNames.size(); g++) {
+                        if (relabund)   {  out  << '\t' << (tree[child].groupCount[g]/getGroupSize(g));   }
+                        else            {  out  << '\t' << tree[child].groupCount[g];                      }
                     }
-                    
+                    out << endl;
                 }
-                if (((output == "detail") && (printlevel >= tree[it->second].level)) || (printlevel == tree[it->second].level)) { out << endl; }
 			}
 			
-			print(it->second, out, output);
+			print(child, out, output);
 		}
 	}
 	catch(exception& e) {
@@ -678,52 +533,33 @@ void PhyloSummary::print(int i, ofstream& out, string output){
 
 void PhyloSummary::print(int i, ofstream& out, bool relabund){
 	try {
-		map<string,int>::iterator it;
-		for(it=tree[i].children.begin();it!=tree[i].children.end();it++){
+		const vector<int>& children = taxonomy.getChildren(i);
+		for(int j = 0; j < children.size(); j++){
+			int child = children[j];
 			
-			if (tree[it->second].total != 0)  {
+			if (tree[child].total != 0)  {
 			
-				int totalChildrenInTree = 0;
-		
-				map<string,int>::iterator it2;
-				for(it2=tree[it->second].children.begin();it2!=tree[it->second].children.end();it2++){   
-					if (tree[it2->second].total != 0)  {   totalChildrenInTree++; }
-				}
-                
                 string nodeName = "";
-                int thisNode = it->second;
+                int thisNode = child;
                 while (tree[thisNode].rank != "0") { //while you are not at top
                     if (m->getControl_pressed()) { break; }
-                    nodeName = tree[thisNode].name + "|" + nodeName;
+                    nodeName = taxonomy.getName(thisNode) + "|" + nodeName;
                     thisNode = tree[thisNode].parent;
                 }
                 if (nodeName != "") { nodeName = nodeName.substr(0, nodeName.length()-1); }
                 
-				out << nodeName << "\t" << (tree[it->second].total / (float)tree[i].total);
+				out << nodeName << "\t" << (tree[child].total / (float)tree[i].total);
 				
-				map<string, int>::iterator itGroup;
-				if (groupmap != NULL) {
-					vector<string> mGroups = groupmap->getNamesOfGroups();
-					for (int j = 0; j < mGroups.size(); j++) {
-                        if (tree[i].groupCount[mGroups[j]] == 0) {
-                            out  << '\t' << 0;
-                        }else { out  << '\t' << (tree[it->second].groupCount[mGroups[j]] / (float)tree[i].groupCount[mGroups[j]]); }
-                    }
-				}else if (ct != NULL) {
-                    if (ct->hasGroupInfo()) {
-                        vector<string> mGroups = ct->getNamesOfGroups();
-                        for (int j = 0; j < mGroups.size(); j++) {
-                            if (tree[i].groupCount[mGroups[j]] == 0) {
-                                out  << '\t' << 0 ;
-                            }else { out  << '\t' << (tree[it->second].groupCount[mGroups[j]] / (float)tree[i].groupCount[mGroups[j]]); }
-                        }
-                    }
-                }
+				for (int g = 0; g < groupNames.size(); g++) {
+					if (tree[i].groupCount[g] == 0) {
+						out  << '\t' << 0;
+					}else { out  << '\t' << (tree[child].groupCount[g] / (float)tree[i].groupCount[g]); }
+				}
 				out << endl;
 				
 			}
 			
-			print(it->second, out, relabund);
+			print(child, out, relabund);
 		}
 	}
 	catch(exception& e) {
@@ -742,43 +578,36 @@ void PhyloSummary::readTreeStruct(ifstream& in){
 		
 		in >> num; util.gobble(in);
 		
-		tree.resize(num);
+		tree.resize(num, TaxSummaryNode(-1, 0, groupNames.size()));
 		
 		in >> maxLevel; util.gobble(in);
+		
+		vector< vector<int> > children; children.resize(num);
 	
 		//read the tree file
 		for (int i = 0; i < tree.size(); i++) {
 	
 			in >> tree[i].level >> num; util.gobble(in); //num contains the number of children tree[i] has
-            tree[i].name = util.getline(in); util.gobble(in);
+            string name = util.getline(in); util.gobble(in);
+            taxonomy.addNode(name);
             
-			//set children
+			//set children, the child's name is on its own line
 			string childName;
 			int childIndex;
 			for (int j = 0; j < num; j++) {
 				in >> childIndex; util.gobble(in);
                 childName = util.getline(in); util.gobble(in);
-				tree[i].children[childName] = childIndex;
+				children[i].push_back(childIndex);
 			}
 			
-			//initialize groupcounts
-			if (groupmap != NULL) {
-				for (int j = 0; j < (groupmap->getNamesOfGroups()).size(); j++) {
-					tree[i].groupCount[(groupmap->getNamesOfGroups())[j]] = 0;
-				}
-			}else if (ct != NULL) {
-                if (ct->hasGroupInfo()) {
-                    for (int j = 0; j < (ct->getNamesOfGroups()).size(); j++) {
-                        tree[i].groupCount[(ct->getNamesOfGroups())[j]] = 0;
-                    }
-                }
-            }
-			
-			tree[i].total = 0;
-			
 			util.gobble(in);
-			
-			//if (tree[i].level > maxLevel) {  maxLevel = tree[i].level;  }
+		}
+		
+		for (int i = 0; i < children.size(); i++) {
+			for (int j = 0; j < children[i].size(); j++) {
+				int child = children[i][j];
+				if ((child >= 0) && (child < tree.size())) { taxonomy.addChild(i, child); tree[child].parent = i; }
+			}
 		}
 
 	}
@@ -788,6 +617,3 @@ void PhyloSummary::readTreeStruct(ifstream& in){
 	}
 }
 /**************************************************************************************************/
-
-
-	
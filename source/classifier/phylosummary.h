@@ -15,9 +15,10 @@
 #include "groupmap.h"
 #include "counttable.h"
 #include "utils.hpp"
+#include "taxonomytrie.hpp"
 
 /**************************************************************************************************/
-
+//used by merge.taxsummary, which combines summaries with different groups
 struct rawTaxNode {
 	map<string, int> children;  //childs name to index in tree
 	int parent, level;
@@ -29,6 +30,18 @@ struct rawTaxNode {
 	rawTaxNode(){}
 };
 
+/**************************************************************************************************/
+//a node of the summary, its name and children are kept in the PhyloSummary's TaxonomyTrie
+struct TaxSummaryNode {
+	int parent, level;
+	string rank;
+	vector<int> groupCount; //[numGroups] indexed like PhyloSummary::groupNames
+	int total;
+	
+	TaxSummaryNode(int p, int l, int numGroups) : parent(p), level(l), groupCount(numGroups, 0), total(0) {}
+	TaxSummaryNode() : parent(-1), level(0), total(0) {}
+};
+
 /**************************************************************************************************/
 class PhyloSummary {
 
@@ -48,13 +61,20 @@ public:
 	
 private:
 	string getNextTaxon(string&);
-	vector<rawTaxNode> tree;
+	vector<TaxSummaryNode> tree;
+	TaxonomyTrie taxonomy; //names and children of the nodes in tree
+	vector<string> groupNames; //groups of the group or count file, in the order they are printed
+	unordered_map<string, int> groupIndexes; //group -> index in groupNames
 	void print(int, ofstream&, string);
     void print(int, ofstream&, bool);
 	void assignRank(int);
     string getTaxons(vector<int> indexes, int index, int i, string&);
 	void readTreeStruct(ifstream&);
     string findTaxon(string);
+	void setGroups();
+	int addChild(int, string, int); //parent, taxon, level. Returns the index of the new node
+	int addToTree(string, int, vector<int>&, string); //taxonomy, count and group counts of the seq or otu, name for warnings
+	double getGroupSize(int); //number of seqs in the group
 	GroupMap* groupmap;
     CountTable* ct;
 	bool ignore, relabund;
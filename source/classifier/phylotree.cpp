@@ -18,6 +18,7 @@ PhyloTree::PhyloTree(){
 		numNodes = 1;
 		numSeqs = 0;
 		tree.push_back(TaxNode("Root"));
+		taxonomy.addNode("Root");
 		tree[0].heirarchyID = "0";
         tree[0].level = 0;
 		maxLevel = 0;
@@ -52,6 +53,11 @@ PhyloTree::PhyloTree(ifstream& in, string filename){
         for (int i = 0; i < tree.size(); i++) {
             tree[i].name = util.getline(in); util.gobble(in);
             in >> tree[i].level >> tree[i].parent; util.gobble(in);
+            taxonomy.addNode(tree[i].name);
+        }
+        
+        for (int i = 0; i < tree.size(); i++) {
+            if ((tree[i].parent >= 0) && (tree[i].parent < tree.size())) { taxonomy.addChild(tree[i].parent, i); }
         }
         
         //read genus nodes
@@ -82,6 +88,7 @@ PhyloTree::PhyloTree(string tfile){
 		numNodes = 1;
 		numSeqs = 0;
 		tree.push_back(TaxNode("Root"));
+		taxonomy.addNode("Root");
 		tree[0].heirarchyID = "0";
         tree[0].level = 0;
 		maxLevel = 0;
@@ -146,7 +153,6 @@ vector<string> PhyloTree::getSeqs(string seqTaxonomy){
 	try {
         string taxCopy = seqTaxonomy;
         vector<string> names;
-        map<string, int>::iterator childPointer;
 		
 		int currentNode = 0;
 
@@ -163,16 +169,18 @@ vector<string> PhyloTree::getSeqs(string seqTaxonomy){
 			
 			if (taxon == "") {  m->mothurOut(taxCopy + " has an error in the taxonomy.  This may be due to a ;;"); m->mothurOutEndLine(); break;  }
 			
-			childPointer = tree[currentNode].children.find(taxon);
+			int child = taxonomy.findChild(currentNode, taxon);
 			
-			if(childPointer != tree[currentNode].children.end()){	//if the node already exists, move on
-				currentNode = childPointer->second;
+			if(child != -1){	//if the node already exists, move on
+				currentNode = child;
 			}
 			else{											//otherwise, error this taxonomy is not in tree
 				m->mothurOut("[ERROR]: " + taxCopy + " is not in taxonomy tree, please correct."); m->mothurOutEndLine(); m->setControl_pressed(true); return names;
 			}
             
-			if (seqTaxonomy == "") {   names = tree[currentNode].accessions;	}
+			if (seqTaxonomy == "") {
+                for (int i = 0; i < tree[currentNode].accessions.size(); i++) { names.push_back(seqNames[tree[currentNode].accessions[i]]); }
+            }
 		}
         
         return names;
@@ -189,12 +197,12 @@ int PhyloTree::addSeqToTree(string seqName, string seqTaxonomy){
 	try {
 		numSeqs++;
 		
-		map<string, int>::iterator childPointer;
+		int seqIndex = getSeqIndex(seqName);
 		
 		int currentNode = 0;
 		int level = 0;
 		
-		tree[0].accessions.push_back(seqName);
+		tree[0].accessions.push_back(seqIndex);
 		util.removeConfidences(seqTaxonomy);
         string taxon;// = getNextTaxon(seqTaxonomy);
 	
@@ -212,25 +220,17 @@ int PhyloTree::addSeqToTree(string seqName, string seqTaxonomy){
 			
 			if (taxon == "") {  m->mothurOut(seqName + " has an error in the taxonomy.  This may be due to a ;;"); m->mothurOutEndLine(); if (currentNode != 0) {  uniqueTaxonomies.insert(currentNode); } break;  }
 			
-			childPointer = tree[currentNode].children.find(taxon);
+			int child = taxonomy.findChild(currentNode, taxon);
 			
-			if(childPointer != tree[currentNode].children.end()){	//if the node already exists, move on
-				currentNode = childPointer->second;
-				tree[currentNode].accessions.push_back(seqName);
-				name2Taxonomy[seqName] = currentNode;
+			if(child != -1){	//if the node already exists, move on
+				currentNode = child;
 			}
 			else{											//otherwise, create it
-				tree.push_back(TaxNode(taxon));
-				
-				tree[currentNode].children[taxon] = numNodes;
-                tree[numNodes].level = level;
-				tree[numNodes].parent = currentNode;
-                currentNode = numNodes;
-                numNodes++;
-				
-				tree[currentNode].accessions.push_back(seqName);
-				name2Taxonomy[seqName] = currentNode;
+				currentNode = addChild(currentNode, taxon, level);
 			}
+			
+			tree[currentNode].accessions.push_back(seqIndex);
+			seqNodes[seqIndex] = currentNode;
 	
 			if (seqTaxonomy == "") {   uniqueTaxonomies.insert(currentNode);	}
 
@@ -247,17 +247,55 @@ int PhyloTree::addSeqToTree(string seqName, string seqTaxonomy){
 	}
 }
 /**************************************************************************************************/
+int PhyloTree::addChild(int parent, string taxon, int level){
+	try {
+		tree.push_back(TaxNode(taxon));
+		int index = taxonomy.addNode(taxon);
+		
+		tree[index].level = level;
+		tree[index].parent = parent;
+		taxonomy.addChild(parent, index);
+		numNodes++;
+		
+		return index;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PhyloTree", "addChild");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+int PhyloTree::getSeqIndex(string seqName){
+	try {
+		unordered_map<string, int>::iterator itFind = seqIndexes.find(seqName);
+		if (itFind != seqIndexes.end()) { return itFind->second; }
+		
+		int index = seqNames.size();
+		seqNames.push_back(seqName);
+		seqIndexes[seqName] = index;
+		seqNodes.push_back(-1);
+		
+		return index;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PhyloTree", "getSeqIndex");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
 vector<int> PhyloTree::getGenusNodes()	{
 	try {
 		genusIndex.clear();
 		//generate genusIndexes
 		set<int>::iterator it2;
-        map<int, int> temp;
+        vector<int> temp(tree.size(), -1); //node -> index in genusIndex
 		for (it2=uniqueTaxonomies.begin(); it2!=uniqueTaxonomies.end(); it2++) {  genusIndex.push_back(*it2); 	temp[*it2] = genusIndex.size()-1; }
 		
-        for (map<string, int>::iterator itName = name2Taxonomy.begin(); itName != name2Taxonomy.end(); itName++) {
-            map<int, int>::iterator itTemp = temp.find(itName->second);
-            if (itTemp != temp.end()) { name2GenusNodeIndex[itName->first] = itTemp->second; }
+        seqGenusIndexes.assign(seqNames.size(), -1);
+        for (int i = 0; i < seqNodes.size(); i++) {
+            if (seqNodes[i] == -1) { continue; } //no taxonomy
+            
+            if (temp[seqNodes[i]] != -1) { seqGenusIndexes[i] = temp[seqNodes[i]]; }
             else {  m->mothurOut("[ERROR]: trouble making name2GenusNodeIndex, aborting.\n"); m->setControl_pressed(true); }
         }
         
@@ -293,21 +331,22 @@ vector<int> PhyloTree::getGenusTotals()	{
 
 void PhyloTree::assignHeirarchyIDs(int index){
 	try {
-		map<string,int>::iterator it;
+		const vector<int>& children = taxonomy.getChildren(index);
 		int counter = 1;
         
-		for(it=tree[index].children.begin();it!=tree[index].children.end();it++){
+		for(int i = 0; i < children.size(); i++){
+            int child = children[i];
             
-            if (m->getDebug()) { m->mothurOut(toString(index) +'\t' + tree[it->second].name +'\n'); }
+            if (m->getDebug()) { m->mothurOut(toString(index) +'\t' + tree[child].name +'\n'); }
                 
-			tree[it->second].heirarchyID = tree[index].heirarchyID + '.' + toString(counter);
+			tree[child].heirarchyID = tree[index].heirarchyID + '.' + toString(counter);
 			counter++;
-			//tree[it->second].level = tree[index].level + 1;
+			//tree[child].level = tree[index].level + 1;
 						
 			//save maxLevel for binning the unclassified seqs
-			if (tree[it->second].level > maxLevel) { maxLevel = tree[it->second].level; } 
+			if (tree[child].level > maxLevel) { maxLevel = tree[child].level; } 
 			
-			assignHeirarchyIDs(it->second);
+			assignHeirarchyIDs(child);
 		}
 	}
 	catch(exception& e) {
@@ -333,25 +372,23 @@ void PhyloTree::binUnclassified(string file){
 		ofstream out;
 		util.openOutputFile(file, out);
 		
-		map<string, int>::iterator itBin;
-		map<string, int>::iterator childPointer;
-		
-		vector<TaxNode> copy = tree;
+		//only the shape of the tree is printed, so the copy doesn't need the seqs
+		TaxonomyTrie copy = taxonomy;
+		vector<int> copyLevels;
+		for (int i = 0; i < tree.size(); i++) { copyLevels.push_back(tree[i].level); }
 		
 		//fill out tree
-		fillOutTree(0, copy);
+		fillOutTree(0, copy, copyLevels);
 	
 		//get leaf nodes that may need extension
-		for (int i = 0; i < copy.size(); i++) {  
+		for (int i = 0; i < copy.getNumNodes(); i++) {  
 
-			if (copy[i].children.size() == 0) {
+			if (copy.getNumChildren(i) == 0) {
 				leafNodes[i] = i;
 			}
 		}
 		
         if (m->getDebug()) { m->mothurOut("maxLevel = " + toString(maxLevel) +'\n'); }
-        
-		int copyNodes = copy.size();
 	
 		//go through the seqs and if a sequence finest taxon is not the same level as the most finely defined taxon then classify it as unclassified where necessary
 		map<int, int>::iterator itLeaf;
@@ -359,10 +396,10 @@ void PhyloTree::binUnclassified(string file){
 			
 			if (m->getControl_pressed()) {  out.close(); break;  }
 			
-			int level = copy[itLeaf->second].level;
+			int level = copyLevels[itLeaf->second];
 			int currentNode = itLeaf->second;
             
-            if (m->getDebug()) { m->mothurOut(copy[currentNode].name +'\n'); }
+            if (m->getDebug()) { m->mothurOut(copy.getName(currentNode) +'\n'); }
 			
 			//this sequence is unclassified at some levels
 			while(level < maxLevel){
@@ -373,26 +410,23 @@ void PhyloTree::binUnclassified(string file){
 				string taxon = "unclassified";	
 				
 				//does the parent have a child names 'unclassified'?
-				childPointer = copy[currentNode].children.find(taxon);
+				int child = copy.findChild(currentNode, taxon);
 				
-				if(childPointer != copy[currentNode].children.end()){	//if the node already exists, move on
-					currentNode = childPointer->second; //currentNode becomes 'unclassified'
+				if(child != -1){	//if the node already exists, move on
+					currentNode = child; //currentNode becomes 'unclassified'
 				}
 				else{											//otherwise, create it
-					copy.push_back(TaxNode(taxon));
-					
-					copy[currentNode].children[taxon] = copyNodes;
-					copy[copyNodes].parent = currentNode;
-					copy[copyNodes].level = copy[currentNode].level + 1;
-                    currentNode = copyNodes;
-                    copyNodes++;
+					child = copy.addNode(taxon);
+					copyLevels.push_back(copyLevels[currentNode] + 1);
+					copy.addChild(currentNode, child);
+                    currentNode = child;
 				}
 			}
 		}
 		
 		if (!m->getControl_pressed()) {
 			//print copy tree
-			print(out, copy);
+			print(out, copy, copyLevels);
 		}
 				
 	}
@@ -402,23 +436,19 @@ void PhyloTree::binUnclassified(string file){
 	}
 }
 /**************************************************************************************************/
-void PhyloTree::fillOutTree(int index, vector<TaxNode>& copy) {
+void PhyloTree::fillOutTree(int index, TaxonomyTrie& copy, vector<int>& copyLevels) {
 	try {
 	
-		map<string,int>::iterator it;
-		
-		it = copy[index].children.find("unclassified");
-		if (it == copy[index].children.end()) { //no unclassified at this level
-			string taxon = "unclassified";
-			copy.push_back(TaxNode(taxon));
-			copy[index].children[taxon] = copy.size()-1;
-			copy[copy.size()-1].parent = index;
-			copy[copy.size()-1].level = copy[index].level + 1;
+		if (copy.findChild(index, "unclassified") == -1) { //no unclassified at this level
+			int child = copy.addNode("unclassified");
+			copyLevels.push_back(copyLevels[index] + 1);
+			copy.addChild(index, child);
 		}
 		
 		if (tree[index].level < maxLevel) {
-			for(it=tree[index].children.begin();it!=tree[index].children.end();it++){ //check your children
-				fillOutTree(it->second, copy);
+			const vector<int>& children = taxonomy.getChildren(index);
+			for(int i = 0; i < children.size(); i++){ //check your children
+				fillOutTree(children[i], copy, copyLevels);
 			}
 		}
 
@@ -433,7 +463,9 @@ string PhyloTree::getFullTaxonomy(string seqName) {
 	try {
 		string tax = "";
 		
-		int currentNode = name2Taxonomy[seqName];
+		int currentNode = 0;
+		unordered_map<string, int>::iterator itFind = seqIndexes.find(seqName);
+		if ((itFind != seqIndexes.end()) && (seqNodes[itFind->second] != -1)) { currentNode = seqNodes[itFind->second]; }
 		
 		while (tree[currentNode].parent != -1) {
 			tax = tree[currentNode].name + ";" + tax;
@@ -449,24 +481,24 @@ string PhyloTree::getFullTaxonomy(string seqName) {
 }
 /**************************************************************************************************/
 
-void PhyloTree::print(ofstream& out, vector<TaxNode>& copy){
+void PhyloTree::print(ofstream& out, TaxonomyTrie& copy, vector<int>& copyLevels){
 	try {
 		
 		//output mothur version
 		out << "#" << current->getVersion() << endl;
 		
-		out << copy.size() << endl;
+		out << copy.getNumNodes() << endl;
 		
 		out << maxLevel << endl;
 				
-		for (int i = 0; i < copy.size(); i++) {
+		for (int i = 0; i < copy.getNumNodes(); i++) {
 				
-			out << copy[i].level << '\t' << copy[i].children.size() << endl;
-            out << copy[i].name << endl;
+			out << copyLevels[i] << '\t' << copy.getNumChildren(i) << endl;
+            out << copy.getName(i) << endl;
 			
-			map<string,int>::iterator it;
-			for(it=copy[i].children.begin();it!=copy[i].children.end();it++){
-				out << it->second << '\t' << it->first << endl;
+			const vector<int>& children = copy.getChildren(i);
+			for(int j = 0; j < children.size(); j++){
+				out << children[j] << '\t' << copy.getName(children[j]) << endl;
 			}
 			out << endl;
 		}
@@ -512,7 +544,7 @@ void PhyloTree::printTreeNodes(string treefilename) {
 	}
 }
 /**************************************************************************************************/
-TaxNode PhyloTree::get(int i ){
+const TaxNode& PhyloTree::get(int i ){
 	try {
 		if (i < tree.size()) {  return tree[i];	 }
 		else {  cout << i << '\t' << tree.size() << endl ; m->mothurOut("Mismatch with taxonomy and template files. Cannot continue."); m->mothurOutEndLine(); exit(1); }
@@ -523,11 +555,11 @@ TaxNode PhyloTree::get(int i ){
 	}
 }
 /**************************************************************************************************/
-TaxNode PhyloTree::get(string seqName){
+const TaxNode& PhyloTree::get(string seqName){
 	try {
-		map<string, int>::iterator itFind = name2Taxonomy.find(seqName);
+		unordered_map<string, int>::iterator itFind = seqIndexes.find(seqName);
 	
-		if (itFind != name2Taxonomy.end()) {  return tree[name2Taxonomy[seqName]];  }
+		if ((itFind != seqIndexes.end()) && (seqNodes[itFind->second] != -1)) {  return tree[seqNodes[itFind->second]];  }
 		else { m->mothurOut("Cannot find " + seqName + ". Mismatch with taxonomy and template files. Cannot continue."); m->mothurOutEndLine(); exit(1);}
 	}
 	catch(exception& e) {
@@ -549,9 +581,9 @@ string PhyloTree::getName(int i ){
 /**************************************************************************************************/
 int PhyloTree::getGenusIndex(string seqName){
 	try {
-		map<string, int>::iterator itFind = name2GenusNodeIndex.find(seqName);
+		unordered_map<string, int>::iterator itFind = seqIndexes.find(seqName);
 	
-		if (itFind != name2GenusNodeIndex.end()) {  return itFind->second;  }
+		if ((itFind != seqIndexes.end()) && (itFind->second < seqGenusIndexes.size()) && (seqGenusIndexes[itFind->second] != -1)) {  return seqGenusIndexes[itFind->second];  }
 		else { m->mothurOut("Cannot find " + seqName + ". Could be a mismatch with taxonomy and template files. Cannot continue."); m->mothurOutEndLine(); exit(1);}
 	}
 	catch(exception& e) {
@@ -566,16 +598,19 @@ bool PhyloTree::ErrorCheck(vector<string> templateFileNames){
 		bool okay = true;
 		templateFileNames.push_back("unknown");
 		
-		map<string, int>::iterator itFind;
-		map<string, int> taxonomyFileNames = name2Taxonomy;
+		unordered_map<string, int>::iterator itFind;
+		vector<bool> inTemplate(seqNames.size(), false);
 		
-        if (m->getDebug()) { m->mothurOut("[DEBUG]: in error check. Numseqs in template = " + toString(templateFileNames.size()) + ". Numseqs in taxonomy = " + toString(taxonomyFileNames.size()) + ".\n"); }
+		int numTaxonomyNames = 0;
+		for (int i = 0; i < seqNodes.size(); i++) { if (seqNodes[i] != -1) { numTaxonomyNames++; } }
+		
+        if (m->getDebug()) { m->mothurOut("[DEBUG]: in error check. Numseqs in template = " + toString(templateFileNames.size()) + ". Numseqs in taxonomy = " + toString(numTaxonomyNames) + ".\n"); }
         
 		for (int i = 0; i < templateFileNames.size(); i++) {
-			itFind = taxonomyFileNames.find(templateFileNames[i]);
+			itFind = seqIndexes.find(templateFileNames[i]);
 			
-			if (itFind != taxonomyFileNames.end()) { //found it so erase it
-				taxonomyFileNames.erase(itFind);
+			if ((itFind != seqIndexes.end()) && (seqNodes[itFind->second] != -1) && (!inTemplate[itFind->second])) { //found it so mark it
+				inTemplate[itFind->second] = true;
 			}else {
 				m->mothurOut("'" +templateFileNames[i] + "' is in your template file and is not in your taxonomy file. Please correct."); m->mothurOutEndLine();
 				okay = false;
@@ -586,11 +621,17 @@ bool PhyloTree::ErrorCheck(vector<string> templateFileNames){
 		}
 		templateFileNames.clear();
 		
+		vector<string> taxonomyFileNames;
+		for (int i = 0; i < seqNodes.size(); i++) {
+			if ((seqNodes[i] != -1) && (!inTemplate[i])) { taxonomyFileNames.push_back(seqNames[i]); }
+		}
+		
 		if (taxonomyFileNames.size() > 0) { //there are names in tax file that are not in template
 			okay = false;
 			
-			for (itFind = taxonomyFileNames.begin(); itFind != taxonomyFileNames.end(); itFind++) {
-				m->mothurOut(itFind->first + " is in your taxonomy file and is not in your template file. Please correct."); m->mothurOutEndLine();
+			sort(taxonomyFileNames.begin(), taxonomyFileNames.end());
+			for (int i = 0; i < taxonomyFileNames.size(); i++) {
+				m->mothurOut(taxonomyFileNames[i] + " is in your taxonomy file and is not in your template file. Please correct."); m->mothurOutEndLine();
 			}
 		}
 		
@@ -14,12 +14,12 @@
 #include "mothurout.h"
 #include "utils.hpp"
 #include "currentfile.h"
+#include "taxonomytrie.hpp"
 
 /**************************************************************************************************/
 
 struct TaxNode {
-	vector<string> accessions;	//names of seqs in this branch of tree
-	map<string, int> children;  //childs name to index in tree
+	vector<int> accessions;	//seqs in this branch of tree, see PhyloTree::getSeqName. The children are found with PhyloTree::getChildren
 	int parent, childNumber, level;
 	string name, heirarchyID;
 	
@@ -48,9 +48,11 @@ public:
 	vector<int> getGenusTotals();	
 	void setUp(string);  //used to create file needed for summary file if you use () constructor and add seqs manually instead of passing taxonomyfile
 		
-	TaxNode get(int i);				
-	TaxNode get(string seqName);
+	const TaxNode& get(int i);				
+	const TaxNode& get(string seqName);
+	const vector<int>& getChildren(int i) { return taxonomy.getChildren(i); } //indexes in tree, in alphabetical order of their names
 	string getName(int i);			
+	string getSeqName(int i) { return seqNames[i]; } //the accessions of the nodes are indexes of the seqs names
 	int getGenusIndex(string seqName);	
 	string getFullTaxonomy(string);	 //pass a sequence name return taxonomy
     vector<string> getSeqs(string);	 //returns names of sequences in given taxonomy
@@ -63,15 +65,20 @@ public:
 	
 private:
 	string getNextTaxon(string&, string);
-	void print(ofstream&, vector<TaxNode>&); //used to create static reference taxonomy file
-	void fillOutTree(int, vector<TaxNode>&); //used to create static reference taxonomy file
+	void print(ofstream&, TaxonomyTrie&, vector<int>&); //used to create static reference taxonomy file
+	void fillOutTree(int, TaxonomyTrie&, vector<int>&); //used to create static reference taxonomy file
 	void binUnclassified(string);
+	int addChild(int, string, int); //parent, taxon, level. Returns the index of the new node
+	int getSeqIndex(string); //adds the seq if it is new
 	
 	vector<TaxNode> tree;
+	TaxonomyTrie taxonomy; //names and children of the nodes in tree
 	vector<int> genusIndex; //holds the indexes in tree where the genus level taxonomies are stored
 	vector<int> totals; //holds the numSeqs at each genus level taxonomy
-	map<string, int> name2Taxonomy;  //maps name to index in tree
-    map<string, int> name2GenusNodeIndex;
+	vector<string> seqNames; //each seq added to the tree once
+	unordered_map<string, int> seqIndexes; //name -> index in seqNames
+	vector<int> seqNodes;  //[numSeqNames] index in tree of the seq's taxonomy, -1 if it has none
+    vector<int> seqGenusIndexes; //[numSeqNames] index in genusIndex of the seq's taxonomy
 	set<int> uniqueTaxonomies;  //map of unique taxonomies
 	map<int, int> leafNodes; //used to create static reference taxonomy file
 	//void print(int, ofstream&);
@@ -0,0 +1,55 @@
+//
+//  taxonomytrie.cpp
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "taxonomytrie.hpp"
+
+/**************************************************************************************************/
+
+int TaxonomyTrie::getNameIndex(const string& name) {
+    unordered_map<string, int>::iterator it = nameIndexes.find(name);
+    if (it != nameIndexes.end()) { return it->second; }
+
+    int index = names.size();
+    names.push_back(name);
+    nameIndexes[name] = index;
+
+    return index;
+}
+/**************************************************************************************************/
+
+int TaxonomyTrie::addNode(string name) {
+    nodeNames.push_back(getNameIndex(name));
+    children.push_back(vector<int>());
+
+    return (nodeNames.size() - 1);
+}
+/**************************************************************************************************/
+
+void TaxonomyTrie::addChild(int parent, int child) {
+    vector<int>& siblings = children[parent];
+    const string& childName = getName(child);
+
+    //keep the children in alphabetical order
+    vector<int>::iterator it = siblings.begin();
+    while ((it != siblings.end()) && (getName(*it) < childName)) { it++; }
+    siblings.insert(it, child);
+
+    edges[edgeKey(parent, nodeNames[child])] = child;
+}
+/**************************************************************************************************/
+
+int TaxonomyTrie::findChild(int parent, const string& name) const {
+    unordered_map<string, int>::const_iterator itName = nameIndexes.find(name);
+    if (itName == nameIndexes.end()) { return -1; }
+
+    unordered_map<unsigned long long, int>::const_iterator itEdge = edges.find(edgeKey(parent, itName->second));
+    if (itEdge == edges.end()) { return -1; }
+
+    return itEdge->second;
+}
+/**************************************************************************************************/
@@ -0,0 +1,51 @@
+#ifndef TAXONOMYTRIE_HPP
+#define TAXONOMYTRIE_HPP
+
+//
+//  taxonomytrie.hpp
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "mothurout.h"
+#include <unordered_map>
+
+/**************************************************************************************************/
+//The shape of a taxonomy tree, shared by PhyloTree and PhyloSummary. Each taxon name is stored once, nodes keep the
+//index of their name and a flat array of their children, and a node's child is found by name with one hashed lookup
+//of (parent, name) instead of a search through a map of strings at every level. The children are kept in alphabetical
+//order of their names, so they are visited in the same order as the map<string, int> they replace.
+//The node data (counts, seqs, ranks) is kept by the owner in a vector indexed like the trie's nodes.
+
+class TaxonomyTrie {
+
+public:
+    TaxonomyTrie() {} //the first node added is the root
+    ~TaxonomyTrie() {}
+
+    int addNode(string); //adds a node with no parent, returns its index
+    void addChild(int, int); //parent, child. The child's name must be unique among the parent's children
+    int findChild(int, const string&) const; //parent, child's name. Returns -1 if the parent has no child by that name
+
+    const vector<int>& getChildren(int node) const { return children[node]; } //in alphabetical order of their names
+    int getNumChildren(int node) const { return children[node].size(); }
+    const string& getName(int node) const { return names[nodeNames[node]]; }
+    int getNumNodes() const { return nodeNames.size(); }
+    int getNumNames() const { return names.size(); }
+
+private:
+    vector<string> names; //unique taxon names
+    unordered_map<string, int> nameIndexes; //name -> index in names
+    vector<int> nodeNames; //[numNodes] index in names
+    vector< vector<int> > children; //[numNodes]
+    unordered_map<unsigned long long, int> edges; //parent and name index -> child
+
+    int getNameIndex(const string&); //adds the name if it is new
+    inline unsigned long long edgeKey(int parent, int nameIndex) const { return (((unsigned long long)parent) << 32) | (unsigned int)nameIndex; }
+};
+
+/**************************************************************************************************/
+
+#endif
@@ -58,6 +58,8 @@
 #include <time.h>
 #include <sys/time.h>
 #include <float.h>
+#include <thread>
+#include <atomic>
 
 #include "distclearcut.h"
 #include "dmat.h"
@@ -68,6 +70,134 @@
 #include "prng.h"
 
 
+
+/* 
+ * The scans of the distance matrix which do not consume random numbers 
+ * are split across threads.  Each thread handles a range of rows or
+ * columns, and the results are combined in order so the trees are the
+ * same for any number of threads.
+ */
+
+/* the fewest cells a thread is given, smaller scans are done serially */
+#define NJ_THREAD_MIN_CELLS 8192
+
+static int NJ_nthreads = 1;        /* threads used for the scans */
+static float *NJ_scanbuf = NULL;   /* one value per taxon, filled by the scans */
+
+typedef struct _STRUCT_NJ_SCAN {
+  DMAT *dmat;
+  long int a, b;          /* the rows being examined or joined */
+  long int start, end;    /* the range of rows or columns given to this thread */
+  float min;              /* NJ_check(): the minimum being checked */
+  int check_a;            /* NJ_check(): also scan the vertical of row a */
+  std::atomic<int> *ok;   /* NJ_check(): cleared when a smaller value is found */
+  float a2clade, b2clade; /* NJ_collapse(): distances from a and b to their new node */
+  float smallest;         /* NJ_min_transform(): the minimum found in the range */
+  long int min_i, min_j;  /* NJ_min_transform(): where it was found */
+} NJ_SCAN;
+
+
+
+/*
+ * NJ_scan_threads() - 
+ *
+ * The number of threads to use for a scan of ncells cells
+ *
+ */
+static inline
+int
+NJ_scan_threads(long int ncells) {
+
+  long int n;
+
+  n = ncells / NJ_THREAD_MIN_CELLS;
+  if(n > NJ_nthreads) {
+    n = NJ_nthreads;
+  }
+  if(n < 1) {
+    n = 1;
+  }
+
+  return((int)n);
+}
+
+
+
+/*
+ * NJ_run_scans() - 
+ *
+ * Run scan on each of the nscans ranges, the first on this thread
+ * and the rest on their own threads, and wait for them to finish.
+ *
+ */
+static
+void
+NJ_run_scans(void (*scan)(NJ_SCAN *),
+	     NJ_SCAN *scans,
+	     int nscans) {
+
+  int i;
+  std::thread **workers = NULL;
+
+  if(nscans > 1) {
+    workers = new std::thread*[nscans-1];
+    for(i=1;i<nscans;i++) {
+      workers[i-1] = new std::thread(scan, &(scans[i]));
+    }
+  }
+
+  scan(&(scans[0]));
+
+  for(i=1;i<nscans;i++) {
+    workers[i-1]->join();
+    delete workers[i-1];
+  }
+  if(workers) {
+    delete[] workers;
+  }
+
+  return;
+}
+
+
+
+/*
+ * NJ_split_scans() - 
+ *
+ * Divide the rows or columns [0, n) evenly among nscans scans
+ *
+ */
+static
+void
+NJ_split_scans(NJ_SCAN *scans,
+	       int nscans,
+	       DMAT *dmat,
+	       long int a,
+	       long int b,
+	       long int n) {
+
+  int i;
+
+  for(i=0;i<nscans;i++) {
+    scans[i].dmat     = dmat;
+    scans[i].a        = a;
+    scans[i].b        = b;
+    scans[i].start    = (n * i) / nscans;
+    scans[i].end      = (n * (i+1)) / nscans;
+    scans[i].min      = 0.0;
+    scans[i].check_a  = 0;
+    scans[i].ok       = NULL;
+    scans[i].a2clade  = 0.0;
+    scans[i].b2clade  = 0.0;
+    scans[i].smallest = (float)HUGE_VAL;
+    scans[i].min_i    = 0;
+    scans[i].min_j    = 0;
+  }
+
+  return;
+}
+
+
 /*
  * main() - 
  *
@@ -77,15 +207,7 @@
 int clearcut_main(int argc, char *argv[]) {
 
   DMAT *dmat;         /* The working distance matrix */
-  DMAT *dmat_backup = NULL;/* A backup distance matrix    */
-  NJ_TREE *tree;      /* The phylogenetic tree       */
   NJ_ARGS *nj_args;   /* Structure for holding command-line arguments */
-  long int i;
-
-  /* some variables for tracking time */
-  struct timeval tv;
-  unsigned long long startUs, endUs;
-  
 
   /* check and parse supplied command-line arguments */
   nj_args = NJ_handle_args(argc, argv);
@@ -95,15 +217,6 @@ int clearcut_main(int argc, char *argv[]) {
     exit(-1);
   }
 
-  /* for verbose reporting, print the random number seed to stdout */
-  if(nj_args->verbose_flag) {
-    printf("PRNG SEED: %d\n", nj_args->seed);
-  }
-
-  /* Initialize Mersenne Twister PRNG */
-  init_genrand(nj_args->seed);
-
-
   switch(nj_args->input_mode) {
 
     /* If the input type is a distance matrix */
@@ -135,6 +248,44 @@ int clearcut_main(int argc, char *argv[]) {
     exit(-1);
   }
 
+  return(clearcut_run(nj_args, dmat));
+}
+
+
+
+
+/*
+ * clearcut_run() - 
+ *
+ * Build and output the trees for a distance matrix.  This is the entry 
+ * point for callers which already have the distances in memory: fill 
+ * in a matrix from NJ_alloc_dmat() and arguments from NJ_init_args() 
+ * with at least the output filename or stdout_flag set.
+ *
+ * The distance matrix is freed.
+ *
+ */
+int 
+clearcut_run(NJ_ARGS *nj_args,
+	     DMAT *dmat) {
+
+  DMAT *dmat_backup = NULL;/* A backup distance matrix    */
+  NJ_TREE *tree;      /* The phylogenetic tree       */
+  long int i;
+
+  /* some variables for tracking time */
+  struct timeval tv;
+  unsigned long long startUs, endUs;
+  
+
+  /* for verbose reporting, print the random number seed to stdout */
+  if(nj_args->verbose_flag) {
+    printf("PRNG SEED: %d\n", nj_args->seed);
+  }
+
+  /* Initialize Mersenne Twister PRNG */
+  init_genrand(nj_args->seed);
+
   /*
    * Output the computed distance matrix,
    *  if the user specified one.
@@ -238,6 +389,54 @@ int clearcut_main(int argc, char *argv[]) {
 
 
 
+/*
+ * NJ_init_scans() - 
+ *
+ * Set the number of threads and allocate the scan buffer 
+ * before building a tree
+ *
+ */
+static
+int
+NJ_init_scans(NJ_ARGS *nj_args,
+	      DMAT *dmat) {
+
+  NJ_nthreads = nj_args->nthreads;
+  if(NJ_nthreads < 1) {
+    NJ_nthreads = 1;
+  }
+
+  NJ_scanbuf = (float *)calloc(dmat->size, sizeof(float));
+  if(!NJ_scanbuf) {
+    fprintf(stderr, "Clearcut:  Memory allocation error in NJ_init_scans()\n");
+    return(0);
+  }
+
+  return(1);
+}
+
+
+
+/*
+ * NJ_free_scans() - 
+ */
+static
+void
+NJ_free_scans(void) {
+
+  if(NJ_scanbuf) {
+    free(NJ_scanbuf);
+    NJ_scanbuf = NULL;
+  }
+  NJ_nthreads = 1;
+
+  return;
+}
+
+
+
+
+
 /*
  * NJ_find_hmin() - Find minimum transformed values along horizontal
  * 
@@ -357,6 +556,36 @@ NJ_find_hmin(DMAT *dmat,
 
 
 
+/*
+ * NJ_gather_vertical() - 
+ *
+ * Copy the transformed distances of rows [start, end) along the 
+ * vertical of row a into the scan buffer
+ *
+ */
+static
+void
+NJ_gather_vertical(NJ_SCAN *scan) {
+
+  long int i, a, size;
+  float *ptr, *r2;
+
+  a    = scan->a;
+  r2   = scan->dmat->r2;
+  size = scan->dmat->size;
+
+  ptr = &(scan->dmat->val[NJ_MAP(scan->start, a, size)]);
+  for(i=scan->start;i<scan->end;i++) {
+    NJ_scanbuf[i] = *ptr - (r2[i] + r2[a]);
+    ptr += size-i-1;
+  }
+
+  return;
+}
+
+
+
+
 /*
  * NJ_find_vmin() - Find minimum transformed distance along vertical
  *
@@ -421,6 +650,9 @@ NJ_find_vmin(DMAT *dmat,
   float p, x;
   long int smallcnt;
 
+  int nscans;       /* number of threads gathering the column */
+  NJ_SCAN *scans;
+
   /* initialize the vertical min to something really big */
   vmin = (float)HUGE_VAL;
 
@@ -432,11 +664,28 @@ NJ_find_vmin(DMAT *dmat,
   p        = 1.0;
   smallcnt = 0;
 
+  /* 
+   * With threads, the transformed distances of the column are gathered 
+   * into the scan buffer first, and the buffer is searched here so the 
+   * ties are broken in the same order.
+   */
+  nscans = NJ_scan_threads(a);
+  if(nscans > 1) {
+    scans = new NJ_SCAN[nscans];
+    NJ_split_scans(scans, nscans, dmat, a, 0, a);
+    NJ_run_scans(NJ_gather_vertical, scans, nscans);
+    delete[] scans;
+  }
+
   /* start on the first row and work down */
   ptr = &(val[NJ_MAP(0, a, size)]);  
   for(i=0;i<a;i++) {
 
-    curval = *ptr - (r2[i] + r2[a]);  /* compute transformed distance */
+    if(nscans > 1) {
+      curval = NJ_scanbuf[i];
+    } else {
+      curval = *ptr - (r2[i] + r2[a]);  /* compute transformed distance */
+    }
     
     if(NJ_FLT_EQ(curval, vmin)) {  /* approx. equal */
       
@@ -550,6 +799,44 @@ NJ_permute(long int *perm,
 
 
 
+/*
+ * NJ_decrement_columns() - 
+ *
+ * The column part of NJ_compute_r() for rows [start, end)
+ *
+ */
+static
+void
+NJ_decrement_columns(NJ_SCAN *scan) {
+
+  long int i, a, b, size;
+  float *ptrx, *ptry, *r;
+
+  a    = scan->a;
+  b    = scan->b;
+  size = scan->dmat->size;
+
+  ptrx = &(scan->dmat->val[NJ_MAP(scan->start, a, size)]);
+  ptry = &(scan->dmat->val[NJ_MAP(scan->start, b, size)]);
+  r    = scan->dmat->r + scan->start;
+  for(i=scan->start;i<scan->end;i++) {
+    if(i<a) {
+      *r -= *ptrx;
+      ptrx += size-i-1;
+    }
+
+    *r -= *ptry;
+    ptry += size-i-1;
+    r++;
+  }
+
+  return;
+}
+
+
+
+
+
 /*
  * NJ_compute_r() - Compute post-join changes to r-vector.  In this
  *                  case, we decrement all of the accumulated distances
@@ -596,6 +883,9 @@ NJ_compute_r(DMAT *dmat,
   /* some variables to limit pointer dereferencing in loop */
   long int size; 
   float *r, *val;
+
+  int nscans;  /* number of threads doing the columns */
+  NJ_SCAN *scans;
   
   /* to limit pointer dereferencing */
   size = dmat->size;
@@ -623,6 +913,16 @@ NJ_compute_r(DMAT *dmat,
   }
 
   /* Similar to the above loop, we now do the columns */
+  nscans = NJ_scan_threads(b);
+  if(nscans > 1) {
+    scans = new NJ_SCAN[nscans];
+    NJ_split_scans(scans, nscans, dmat, a, b, b);
+    NJ_run_scans(NJ_decrement_columns, scans, nscans);
+    delete[] scans;
+
+    return;
+  }
+
   ptrx = &(val[NJ_MAP(0, a, size)]);  
   ptry = &(val[NJ_MAP(0, b, size)]);  
   r = dmat->r;
@@ -758,6 +1058,58 @@ NJ_check_additivity(DMAT *dmat,
 
 
 
+/*
+ * NJ_check_vertical() - 
+ *
+ * The vertical part of NJ_check() for rows [start, end)
+ *
+ */
+static
+void
+NJ_check_vertical(NJ_SCAN *scan) {
+
+  long int i, a, b, size;
+  float *val, *r2;
+  float min;
+
+  a    = scan->a;
+  b    = scan->b;
+  min  = scan->min;
+  val  = scan->dmat->val;
+  r2   = scan->dmat->r2;
+  size = scan->dmat->size;
+
+  for(i=scan->start;i<scan->end;i++) {
+
+    /* another thread found a smaller value */
+    if(!(i & 1023) && !scan->ok->load(std::memory_order_relaxed)) {
+      return;
+    }
+
+    if(scan->check_a && i<a) {
+      if( NJ_FLT_LT( (val[NJ_MAP(i, a, size)] - (r2[i] + r2[a])), min) ) {
+	scan->ok->store(0);
+	return;
+      }
+    }
+
+    if(i<b) {
+      if( NJ_FLT_LT( (val[NJ_MAP(i, b, size)] - (r2[i] + r2[b])), min) && i!=a) {
+	scan->ok->store(0);
+	return;
+      }
+    }
+  }
+
+  return;
+}
+
+
+
+
+
+
+
 /*
  * NJ_check() - Check to see if two taxa can be joined
 
@@ -802,6 +1154,11 @@ NJ_check(NJ_ARGS *nj_args,
 
   long int i, size;
   float *ptr, *val, *r2;
+
+  long int n;          /* rows in the longer of the verticals scanned */
+  int nscans;          /* number of threads scanning the verticals */
+  NJ_SCAN *scans;
+  std::atomic<int> ok(1);
   
 
   /* some aliases for speed and readability reasons */
@@ -826,6 +1183,29 @@ NJ_check(NJ_ARGS *nj_args,
     ptr++;
   }
 
+  /* 
+   * with threads, both verticals are scanned together and any 
+   * smaller value clears ok 
+   */
+  n = b;
+  if(nj_args->norandom && a > b) {
+    n = a;
+  }
+  nscans = NJ_scan_threads(n);
+  if(nscans > 1) {
+    scans = new NJ_SCAN[nscans];
+    NJ_split_scans(scans, nscans, dmat, a, b, n);
+    for(i=0;i<nscans;i++) {
+      scans[i].min     = min;
+      scans[i].check_a = nj_args->norandom;
+      scans[i].ok      = &ok;
+    }
+    NJ_run_scans(NJ_check_vertical, scans, nscans);
+    delete[] scans;
+
+    return(ok.load());
+  }
+
   /* scan the vertical component of row a, punt if anything < min */
   if(nj_args->norandom) {  /* if we are doing random joins, we checked this */
     ptr = val + a;
@@ -855,6 +1235,93 @@ NJ_check(NJ_ARGS *nj_args,
 
 
 
+/*
+ * NJ_collapse_distances() - 
+ *
+ * Compute the distances from the node joining a and b to rows 
+ * [start, end) for NJ_collapse(), and update their r and r2.  The 
+ * distances are also saved in the scan buffer.
+ *
+ */
+static
+void
+NJ_collapse_distances(NJ_SCAN *scan) {
+
+  long int i, a, b, size;
+  float cval;
+  float *ptra, *ptrb;
+  float *val, *r, *r2;
+
+  a    = scan->a;
+  b    = scan->b;
+  val  = scan->dmat->val;
+  r    = scan->dmat->r;
+  r2   = scan->dmat->r2;
+  size = scan->dmat->size;
+
+  for(i=scan->start;i<scan->end;i++) {
+
+    if(i == a) {
+      continue;
+    }
+
+    /* the horizontal of a follows the vertical of b up to the diagonal */
+    if(i > a) {
+      ptra = &(val[NJ_MAP(a, i, size)]);
+      if(i <= b) {
+	ptrb = &(val[NJ_MAP(i, b, size)]);
+      } else {
+	ptrb = &(val[NJ_MAP(b, i, size)]);
+      }
+    } else {
+      ptra = &(val[NJ_MAP(i, a, size)]);
+      ptrb = &(val[NJ_MAP(i, b, size)]);
+    }
+
+    cval = 
+      ( (*ptra - scan->a2clade) +
+	(*ptrb - scan->b2clade) ) / 2.0;
+
+    *ptra = cval;
+    NJ_scanbuf[i] = cval;
+
+    r[i] += cval;
+    r2[i] = r[i]/(float)(size-3);
+  }
+
+  return;
+}
+
+
+
+/*
+ * NJ_copy_row0() - 
+ *
+ * Copy row 0 into the vertical of row b for rows [start, end)
+ *
+ */
+static
+void
+NJ_copy_row0(NJ_SCAN *scan) {
+
+  long int i, b, size;
+  float *val;
+
+  b    = scan->b;
+  val  = scan->dmat->val;
+  size = scan->dmat->size;
+
+  for(i=scan->start;i<scan->end;i++) {
+    val[NJ_MAP(i, b, size)] = val[i];
+  }
+
+  return;
+}
+
+
+
+
+
 /*
  * NJ_collapse() - Collapse the distance matrix by removing 
  *                 rows a and b from the distance matrix and
@@ -930,6 +1397,9 @@ NJ_collapse(DMAT *dmat,
 
   float *val, *r, *r2;  /* simply used to limit pointer dereferencing */
 
+  int nscans;     /* number of threads working on the columns */
+  NJ_SCAN *scans = NULL;
+
 
   /* We must assume that a < b */
   if(a >= b) {
@@ -952,66 +1422,91 @@ NJ_collapse(DMAT *dmat,
 
   r[a] = 0.0;  /* we are removing row a, so clear dist. in r */
 
-  /* 
-   * Fill the horizontal part of the "a" row and finish computing r and r2 
-   * we handle the horizontal component first to maximize cache locality
+  /*
+   * With threads, the new distances, r and r2 are computed for ranges 
+   * of the other rows, and the distances are summed into r[a] here in 
+   * the same order as the loops below.
    */
-  ptra = &(val[NJ_MAP(a,   a+1, size)]);   /* start ptra at the horiz. of a  */
-  ptrb = &(val[NJ_MAP(a+1, b,   size)]);   /* start ptrb at comparable place */
-  for(i=a+1;i<size;i++) {
+  nscans = NJ_scan_threads(size);
+  if(nscans > 1) {
+    scans = new NJ_SCAN[nscans];
+    NJ_split_scans(scans, nscans, dmat, a, b, size);
+    for(i=0;i<nscans;i++) {
+      scans[i].a2clade = a2clade;
+      scans[i].b2clade = b2clade;
+    }
+    NJ_run_scans(NJ_collapse_distances, scans, nscans);
+
+    for(i=a+1;i<size;i++) {
+      r[a] += NJ_scanbuf[i];
+    }
+    for(i=0;i<a;i++) {
+      r[a] += NJ_scanbuf[i];
+    }
+
+  } else {
 
     /* 
-     * Compute distance from new internal node to others in 
-     * the distance matrix.
+     * Fill the horizontal part of the "a" row and finish computing r and r2 
+     * we handle the horizontal component first to maximize cache locality
      */
-    cval = 
-      ( (*ptra - a2clade) +
-	(*ptrb - b2clade) ) / 2.0;
-
-    /* incr.  row b pointer differently depending on where i is in loop */
-    if(i<b) {
-      ptrb += size-i-1;  /* traverse vertically  by incrementing by row */
-    } else {
-      ptrb++;            /* traverse horiz. by incrementing by column   */
-    }
+    ptra = &(val[NJ_MAP(a,   a+1, size)]);   /* start ptra at the horiz. of a  */
+    ptrb = &(val[NJ_MAP(a+1, b,   size)]);   /* start ptrb at comparable place */
+    for(i=a+1;i<size;i++) {
+
+      /* 
+       * Compute distance from new internal node to others in 
+       * the distance matrix.
+       */
+      cval = 
+        ( (*ptra - a2clade) +
+  	(*ptrb - b2clade) ) / 2.0;
+
+      /* incr.  row b pointer differently depending on where i is in loop */
+      if(i<b) {
+        ptrb += size-i-1;  /* traverse vertically  by incrementing by row */
+      } else {
+        ptrb++;            /* traverse horiz. by incrementing by column   */
+      }
 
-    /* assign the newly computed distance and increment a ptr by a column */
-    *(ptra++) = cval;  
+      /* assign the newly computed distance and increment a ptr by a column */
+      *(ptra++) = cval;  
 
-    /* accumulate the distance onto the r vector */
-    r[a] += cval;
-    r[i] += cval;
+      /* accumulate the distance onto the r vector */
+      r[a] += cval;
+      r[i] += cval;
     
-    /* scale r2 on the fly here */
-    r2[i] = r[i]/(float)(size-3);
-  }
+      /* scale r2 on the fly here */
+      r2[i] = r[i]/(float)(size-3);
+    }
 
-  /* fill the vertical part of the "a" column and finish computing r and r2 */ 
-  ptra = val + a;  /* start at the top of the columb for "a" */
-  ptrb = val + b;  /* start at the top of the columb for "b" */
-  for(i=0;i<a;i++) {
+    /* fill the vertical part of the "a" column and finish computing r and r2 */ 
+    ptra = val + a;  /* start at the top of the columb for "a" */
+    ptrb = val + b;  /* start at the top of the columb for "b" */
+    for(i=0;i<a;i++) {
 
-    /* 
-     * Compute distance from new internal node to others in 
-     * the distance matrix.
-     */
-    cval = 
-      ( (*ptra - a2clade) + 
-	(*ptrb - b2clade) ) / 2.0;
+      /* 
+       * Compute distance from new internal node to others in 
+       * the distance matrix.
+       */
+      cval = 
+        ( (*ptra - a2clade) + 
+  	(*ptrb - b2clade) ) / 2.0;
     
-    /* assign the newly computed distance and increment a ptr by a column */
-    *ptra = cval;
+      /* assign the newly computed distance and increment a ptr by a column */
+      *ptra = cval;
 
-    /* accumulate the distance onto the r vector */
-    r[a] += cval;
-    r[i] += cval;
+      /* accumulate the distance onto the r vector */
+      r[a] += cval;
+      r[i] += cval;
 
-    /* scale r2 on the fly here */
-    r2[i] = r[i]/(float)(size-3);
+      /* scale r2 on the fly here */
+      r2[i] = r[i]/(float)(size-3);
 
-    /* here, always increment by an entire row */
-    ptra += size-i-1;
-    ptrb += size-i-1;
+      /* here, always increment by an entire row */
+      ptra += size-i-1;
+      ptrb += size-i-1;
+    }
   }
 
 
@@ -1025,11 +1520,19 @@ NJ_collapse(DMAT *dmat,
    * loops to maximize cache locality for writes along the horizontal
    * component of row b.
    */
-  vptr = val;
-  ptrb = val + b;
-  for(i=0;i<b;i++) {
-    *ptrb = *(vptr++);
-    ptrb += size-i-1;
+  if(nscans > 1) {
+    NJ_split_scans(scans, nscans, dmat, a, b, b);
+    NJ_run_scans(NJ_copy_row0, scans, nscans);
+    delete[] scans;
+
+    vptr = val + b;
+  } else {
+    vptr = val;
+    ptrb = val + b;
+    for(i=0;i<b;i++) {
+      *ptrb = *(vptr++);
+      ptrb += size-i-1;
+    }
   }
   vptr++;  /* skip over the diagonal */
   ptrb = &(val[NJ_MAP(b, b+1, size)]); 
@@ -1114,6 +1617,11 @@ NJ_neighbor_joining(NJ_ARGS *nj_args,
     fprintf(stderr, "Clearcut:  Could not initialize vertex in NJ_neighbor_joining()\n");
     return(NULL);
   }
+
+  if(!NJ_init_scans(nj_args, dmat)) {
+    NJ_free_vertex(vertex);
+    return(NULL);
+  }
   
   /* we iterate until the working distance matrix has only 2 entries */
   while(vertex->nactive > 2) {
@@ -1141,6 +1649,8 @@ NJ_neighbor_joining(NJ_ARGS *nj_args,
   /* Properly join the last two nodes on the vertex list */
   tree = NJ_decompose(dmat, vertex, 0, 1, NJ_LAST);
 
+  NJ_free_scans();
+
   /* return the computed tree to the calling function */
   return(tree);
 }
@@ -1244,6 +1754,14 @@ NJ_relaxed_nj(NJ_ARGS *nj_args,
 
   /* allocate and initialize our vertex vector used for tree construction */
   vertex = NJ_init_vertex(dmat);
+
+  if(!NJ_init_scans(nj_args, dmat)) {
+    if(permutation) {
+      free(permutation);
+    }
+    NJ_free_vertex(vertex);
+    return(NULL);
+  }
   
   /* loop until there are only 2 nodes left to join */
   while(vertex->nactive > 2) {
@@ -1377,6 +1895,8 @@ NJ_relaxed_nj(NJ_ARGS *nj_args,
 
   /* Join the last two nodes on the vertex list */
   tree = NJ_decompose(dmat, vertex, 0, 1, NJ_LAST);
+
+  NJ_free_scans();
   
   if(nj_args->verbose_flag) {
     if(additivity_mode) {
@@ -1932,6 +2452,50 @@ NJ_print_permutation(long int *perm,
 
 
 
+/*
+ * NJ_alloc_dmat() - 
+ * 
+ * Allocate an empty distance matrix for ntaxa taxa.  The caller 
+ * sets the taxa names with memory from malloc() and the distances
+ * with val[NJ_MAP(i, j, ntaxa)] for i < j.
+ *
+ */
+DMAT *
+NJ_alloc_dmat(long int ntaxa) {
+  
+  DMAT *dmat;
+  
+  dmat = (DMAT *)calloc(1, sizeof(DMAT));
+  if(!dmat) {
+    fprintf(stderr, "Clearcut: Memory allocation error in NJ_alloc_dmat()\n");
+    return(NULL);
+  }
+
+  dmat->ntaxa = ntaxa;
+  dmat->size  = ntaxa;
+
+  dmat->taxaname = (char **)calloc(ntaxa, sizeof(char *));
+  dmat->val      = (float *)calloc(NJ_NCELLS(ntaxa), sizeof(float));
+  dmat->r        = (float *)calloc(ntaxa, sizeof(float));
+  dmat->r2       = (float *)calloc(ntaxa, sizeof(float));
+
+  /* track some memory addresses */
+  dmat->valhandle = dmat->val;
+  dmat->rhandle   = dmat->r;
+  dmat->r2handle  = dmat->r2;
+
+  if(!dmat->taxaname || !dmat->val || !dmat->r || !dmat->r2) {
+    fprintf(stderr, "Clearcut: Memory allocation error in NJ_alloc_dmat()\n");
+    NJ_free_dmat(dmat);
+    return(NULL);
+  }
+  
+  return(dmat);
+}
+
+
+
+
 /*
  * NJ_dup_dmat() - 
  * 
@@ -2081,6 +2645,93 @@ NJ_free_vertex(NJ_VERTEX *vertex) {
 
 
 
+/*
+ * NJ_balance_rows() - 
+ *
+ * Divide the rows of the upper-diagonal matrix so that each scan 
+ * has about the same number of cells
+ *
+ */
+static
+void
+NJ_balance_rows(NJ_SCAN *scans,
+		int nscans,
+		long int size) {
+
+  long int i, cells, total;
+  int k;
+
+  total = NJ_NCELLS(size);
+  cells = 0;
+  k     = 0;
+
+  scans[0].start = 0;
+  for(i=0;i<size && k<nscans-1;i++) {
+    cells += size-i;
+    if(cells >= (total * (k+1)) / nscans) {
+      scans[k].end     = i+1;
+      scans[k+1].start = i+1;
+      k++;
+    }
+  }
+  for(;k<nscans-1;k++) {
+    scans[k].end     = size;
+    scans[k+1].start = size;
+  }
+  scans[nscans-1].end = size;
+
+  return;
+}
+
+
+
+
+/*
+ * NJ_min_transform_rows() - 
+ *
+ * NJ_min_transform() for rows [start, end)
+ *
+ */
+static
+void
+NJ_min_transform_rows(NJ_SCAN *scan) {
+
+  long int i, j, size;
+  long int tmp_i, tmp_j;
+  float smallest, curval;
+  float *ptr, *r2;
+
+  size = scan->dmat->size;
+  r2   = scan->dmat->r2;
+
+  smallest = (float)HUGE_VAL;
+  tmp_i = 0;
+  tmp_j = 0;
+
+  for(i=scan->start;i<scan->end;i++) {
+    ptr = &(scan->dmat->val[NJ_MAP(i, i+1, size)]);
+    for(j=i+1;j<size;j++) {
+
+      curval = *(ptr++) - (r2[i] + r2[j]);
+
+      if(curval < smallest) {
+	smallest = curval;
+	tmp_i = i;
+	tmp_j = j;
+      }
+    }
+  }
+
+  scan->smallest = smallest;
+  scan->min_i    = tmp_i;
+  scan->min_j    = tmp_j;
+
+  return;
+}
+
+
+
+
 /*
  *
  * NJ_min_transform() - Find the smallest transformed value to identify 
@@ -2119,9 +2770,38 @@ NJ_min_transform(DMAT *dmat,
 
   float *ptr;      /* pointer into distance matrix    */
   float *r2;       /* pointer to r2 matrix for computing transformed dists */
+
+  int nscans;      /* number of threads scanning the matrix */
+  NJ_SCAN *scans;
   
   smallest = (float)HUGE_VAL;
 
+  /* 
+   * With threads, each scans a range of rows and the first of the 
+   * smallest values is kept, as in the serial scan below.
+   */
+  nscans = NJ_scan_threads(NJ_NCELLS(dmat->size));
+  if(nscans > 1) {
+    scans = new NJ_SCAN[nscans];
+    NJ_split_scans(scans, nscans, dmat, 0, 0, dmat->size);
+    NJ_balance_rows(scans, nscans, dmat->size);
+    NJ_run_scans(NJ_min_transform_rows, scans, nscans);
+
+    for(i=0;i<nscans;i++) {
+      if(scans[i].smallest < smallest) {
+	smallest = scans[i].smallest;
+	tmp_i = scans[i].min_i;
+	tmp_j = scans[i].min_j;
+      }
+    }
+    delete[] scans;
+
+    *ret_i = tmp_i;
+    *ret_j = tmp_j;
+
+    return(smallest);
+  }
+
   /* track these here to limit pointer dereferencing in inner loop */
   ptr = dmat->val;
   r2  = dmat->r2;
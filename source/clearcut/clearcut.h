@@ -187,6 +187,10 @@ typedef struct _STRUCT_NJ_VERTEX {
 /* some function prototypes */
 int clearcut_main(int, char**);  
 
+/* build the trees for a distance matrix which is already in memory */
+int
+clearcut_run(NJ_ARGS *nj_args, DMAT *dmat);
+
 /* core function for performing Relaxed Neighbor Joining */
 NJ_TREE *
 NJ_relaxed_nj(NJ_ARGS *nj_args, DMAT *dmat);
@@ -255,6 +259,10 @@ void
 NJ_print_permutation(long int *perm,
 		     long int size);
 
+/* allocate an empty distance matrix to be filled in by the caller */
+DMAT *
+NJ_alloc_dmat(long int ntaxa);
+
 /* duplicate a distance matrix for multiple iterations */
 DMAT *
 NJ_dup_dmat(DMAT *src);
@@ -60,6 +60,48 @@
 #include "cmdargs.h"
 
 
+/*
+ * NJ_init_args() - 
+ *
+ * Set the arguments to their defaults.  Used by callers who fill 
+ * in the arguments directly instead of parsing a command line.
+ *
+ */
+void
+NJ_init_args(NJ_ARGS *nj_args) {
+
+  nj_args->infilename       = NULL;
+  nj_args->outfilename      = NULL;
+  nj_args->matrixout        = NULL;
+  nj_args->seed             = time(0);
+  nj_args->verbose_flag     = 0;
+  nj_args->quiet_flag       = 0;
+  nj_args->input_mode       = NJ_INPUT_MODE_DISTANCE;
+  nj_args->aligned_flag     = 0;
+  nj_args->help             = 0;
+  nj_args->version          = 0;
+  nj_args->norandom         = 0;
+  nj_args->shuffle          = 0;
+  nj_args->stdin_flag       = 0;
+  nj_args->stdout_flag      = 0;
+  nj_args->dna_flag         = 0;
+  nj_args->protein_flag     = 0;
+  nj_args->correction_model = NJ_MODEL_NONE;
+  nj_args->jukes_flag       = 0;
+  nj_args->kimura_flag      = 0;
+  nj_args->neighbor         = 0;
+  nj_args->ntrees           = 1;
+  nj_args->expblen          = 0;
+  nj_args->expdist          = 0;
+  nj_args->nthreads         = 1;
+
+  return;
+}
+
+
+
+
+
 /*
  * NJ_handle_args() - 
  *
@@ -81,6 +123,7 @@ NJ_handle_args(int argc,
     {"seed",      required_argument, NULL, 's'},
     {"matrixout", required_argument, NULL, 'm'},
     {"ntrees",    required_argument, NULL, 'n'},
+    {"processors", required_argument, NULL, 'p'},
 
     /* These options set a flag */
     {"verbose",      no_argument, &(nj_args.verbose_flag),  1},
@@ -108,34 +151,13 @@ NJ_handle_args(int argc,
   };
   
   /* initializes options to their default */
-  nj_args.infilename       = NULL;
-  nj_args.outfilename      = NULL;
-  nj_args.matrixout        = NULL;
-  nj_args.seed             = time(0);
-  nj_args.verbose_flag     = 0;
-  nj_args.quiet_flag       = 0;
-  nj_args.input_mode       = NJ_INPUT_MODE_DISTANCE;
-  nj_args.help             = 0;
-  nj_args.version          = 0;
-  nj_args.norandom         = 0;
-  nj_args.shuffle          = 0;
-  nj_args.stdin_flag       = 0;
-  nj_args.stdout_flag      = 0;
-  nj_args.dna_flag         = 0;
-  nj_args.protein_flag     = 0;
-  nj_args.correction_model = NJ_MODEL_NONE;
-  nj_args.jukes_flag       = 0;
-  nj_args.kimura_flag      = 0;
-  nj_args.neighbor         = 0;
-  nj_args.ntrees           = 1;
-  nj_args.expblen          = 0;
-  nj_args.expdist          = 0;
+  NJ_init_args(&nj_args);
 
   while(1) {
 
     c = getopt_long(argc,
 		    argv,
-		    "i:o:s:m:n:vqduahVSIOrDPjkNeE",
+		    "i:o:s:m:n:p:vqduahVSIOrDPjkNeE",
 		    NJ_long_options,
 		    &option_index);
     if(c == -1) {
@@ -177,6 +199,10 @@ NJ_handle_args(int argc,
       nj_args.ntrees = atoi(optarg);
       break;
 
+    case 'p':
+      nj_args.nthreads = atoi(optarg);
+      break;
+
     case 'v':
       nj_args.verbose_flag = 1;
       break; 
@@ -384,6 +410,13 @@ NJ_handle_args(int argc,
     exit(-1);
   }
   
+  /* make sure that the number of threads is reasonable */
+  if(nj_args.nthreads <= 0) {
+    fprintf(stderr, "Clearcut: Number of processors must be a positive integer.\n");
+    NJ_usage();
+    exit(-1);
+  }
+  
   /* 
    * make sure that if exponential distances are specified, 
    * we are dealing with alignment input
@@ -492,6 +525,7 @@ NJ_usage(void) {
   printf("  -r, --norandom     Attempt joins deterministically.  (Default: OFF)\n");
   printf("  -S, --shuffle      Randomly shuffle the distance matrix.  (Default: OFF)\n");
   printf("  -N, --neighbor     Use traditional Neighbor-Joining algorithm. (Default: OFF)\n");
+  printf("  -p, --processors=<n> Scan the distance matrix with n threads. (Default: 1)\n");
 
   printf("\n");
   printf("INPUT OPTIONS:\n");
@@ -91,6 +91,9 @@ typedef struct _STRUCT_NJ_ARGS {
   /* exponential notation output */
   int expblen;  /* exp notation for tree branch lengths */
   int expdist;  /* exp notation for distances in matrix output */
+
+  /* number of threads used to scan the distance matrix */
+  int nthreads;
   
 } NJ_ARGS;
 
@@ -98,6 +101,9 @@ typedef struct _STRUCT_NJ_ARGS {
 
 /* some function prototypes */
 
+void
+NJ_init_args(NJ_ARGS *nj_args);
+
 NJ_ARGS *
 NJ_handle_args(int argc,
 	       char *argv[]);
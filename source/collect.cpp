@@ -68,11 +68,25 @@ int Collect::getCurve(float percentFreq = 0.01){
 }
 
 /***********************************************************************/
-int Collect::getSharedCurve(float percentFreq = 0.01){
-try {
+struct collectSharedData {
+    SharedOrderVector* sharedorder;
+    vector<Display*> displays;
+    int numSeqs, increment;
+    MothurOut* m;
+    
+    collectSharedData(SharedOrderVector* o, vector<Display*> d, int n, int i) : sharedorder(o), displays(d), numSeqs(n), increment(i) { m = MothurOut::getInstance(); }
+};
+/***********************************************************************/
+//samples all the members for its displays. Each thread has its own copy of the abundances, the order is only read
+void driverSharedCollect(collectSharedData* params) {
+        try {
                 vector<SharedRAbundVector*> lookup;
                 map<string, int> indexLookup;
 				vector<SharedRAbundVector*> subset;
+                SharedOrderVector* sharedorder = params->sharedorder;
+                int increment = params->increment;
+                int numSeqs = params->numSeqs;
+                int totalNumSeq = 0;
 
                 //create and initialize vector of sharedvectors, one for each group
 				vector<string> mGroups = sharedorder->getGroups();
@@ -86,34 +100,12 @@ try {
                 }
 	
                 SharedCollectorsCurveData* ccd = new SharedCollectorsCurveData();
-        
-                //initialize labels for output
-                //makes  'uniqueAB         uniqueAC  uniqueBC' if your groups are A, B, C
-                getGroupComb(mGroups);
-				
-                for(int i=0;i<displays.size();i++){
-                        ccd->registerDisplay(displays[i]); //adds a display[i] to cdd
-						bool hasLciHci = displays[i]->hasLciHci();
-						groupLabel = "";
-						for (int s = 0; s < groupComb.size(); s++) {
-							if (hasLciHci) {  groupLabel = groupLabel + label + groupComb[s] + "\t" + label + groupComb[s] + "lci\t" + label + groupComb[s] + "hci\t"; }
-							else{  groupLabel = groupLabel + label + groupComb[s] + "\t";  }
-						}
-
-						string groupLabelAll = groupLabel + label + "all\t"; 
-						if ((displays[i]->isCalcMultiple() ) && (displays[i]->getAll() )) {   displays[i]->init(groupLabelAll); }
-						else {  displays[i]->init(groupLabel);  }           
-                }
+                for(int i=0;i<params->displays.size();i++){ ccd->registerDisplay(params->displays[i]); } //adds a display[i] to cdd
                 
-				//convert freq percentage to number
-				int increment = 1;
-				if (percentFreq < 1.0) {  increment = numSeqs * percentFreq;  }
-				else { increment = percentFreq;  }
-				
                 //sample all the members
                 for(int i=0;i<numSeqs;i++){
 				
-						if (m->getControl_pressed()) { for (int j = 0; j < lookup.size(); j++) {  delete lookup[j]; } delete ccd;  return 1;  }
+						if (params->m->getControl_pressed()) { break;  }
 						
                         //get first sample
                         individual chosen = sharedorder->get(i);
@@ -153,7 +145,7 @@ try {
                 }
                 
                 //calculate last label if you haven't already
-                if(numSeqs % increment != 0){
+                if((numSeqs % increment != 0) && (!params->m->getControl_pressed())){
                         //how many comparisons to make i.e. for group a, b, c = ab, ac, bc.
                         int n = 1;
 						bool pair = true;
@@ -176,17 +168,78 @@ try {
 						pair = false;
 						ccd->updateSharedData(lookup, totalNumSeq, numGroups, pair, mGroups);
                 }
-	 
-                //resets output files
-                for(int i=0;i<displays.size();i++){
-                        displays[i]->reset();
-                }
 				
 				//memory cleanup
 				delete ccd;
 				for (int i = 0; i < lookup.size(); i++) {
 					delete lookup[i];
 				}
+        }
+        catch(exception& e) {
+                params->m->errorOut(e, "Collect", "driverSharedCollect");
+				exit(1);
+        }
+}
+/***********************************************************************/
+int Collect::getSharedCurve(float percentFreq = 0.01){
+try {
+				vector<string> mGroups = sharedorder->getGroups();
+        
+                //initialize labels for output
+                //makes  'uniqueAB         uniqueAC  uniqueBC' if your groups are A, B, C
+                getGroupComb(mGroups);
+				
+                for(int i=0;i<displays.size();i++){
+						bool hasLciHci = displays[i]->hasLciHci();
+						groupLabel = "";
+						for (int s = 0; s < groupComb.size(); s++) {
+							if (hasLciHci) {  groupLabel = groupLabel + label + groupComb[s] + "\t" + label + groupComb[s] + "lci\t" + label + groupComb[s] + "hci\t"; }
+							else{  groupLabel = groupLabel + label + groupComb[s] + "\t";  }
+						}
+
+						string groupLabelAll = groupLabel + label + "all\t"; 
+						if ((displays[i]->isCalcMultiple() ) && (displays[i]->getAll() )) {   displays[i]->init(groupLabelAll); }
+						else {  displays[i]->init(groupLabel);  }           
+                }
+                
+				//convert freq percentage to number
+				int increment = 1;
+				if (percentFreq < 1.0) {  increment = numSeqs * percentFreq;  }
+				else { increment = percentFreq;  }
+                
+                //the displays write to their own files, so each thread samples the members for some of the displays
+                int numThreads = processors;
+                if (displays.size() < numThreads) { numThreads = displays.size(); }
+                if (numThreads < 1) { numThreads = 1; }
+                
+                vector< vector<Display*> > threadDisplays(numThreads);
+                for(int i=0;i<displays.size();i++){ threadDisplays[i % numThreads].push_back(displays[i]); }
+                
+                vector<thread*> workerThreads;
+                vector<collectSharedData*> data;
+                
+                for (int i = 1; i < numThreads; i++) {
+                    collectSharedData* dataBundle = new collectSharedData(sharedorder, threadDisplays[i], numSeqs, increment);
+                    data.push_back(dataBundle);
+                    workerThreads.push_back(new thread(driverSharedCollect, dataBundle));
+                }
+                
+                collectSharedData* dataBundle = new collectSharedData(sharedorder, threadDisplays[0], numSeqs, increment);
+                driverSharedCollect(dataBundle);
+                delete dataBundle;
+                
+                for (int i = 0; i < workerThreads.size(); i++) {
+                    workerThreads[i]->join();
+                    delete data[i];
+                    delete workerThreads[i];
+                }
+                
+                if (m->getControl_pressed()) { return 1; }
+	 
+                //resets output files
+                for(int i=0;i<displays.size();i++){
+                        displays[i]->reset();
+                }
 				
 				return 0;
 
@@ -12,9 +12,11 @@ class Collect {
 	
 public:
 	Collect(OrderVector* order, vector<Display*> disp) :
-					numSeqs(order->getNumSeqs()), order(order), displays(disp), label(order->getLabel())  { m = MothurOut::getInstance(); };
+					numSeqs(order->getNumSeqs()), order(order), displays(disp), label(order->getLabel()), processors(1)  { m = MothurOut::getInstance(); };
 	Collect(SharedOrderVector* sharedorder, vector<Display*> disp) :
-					numSeqs(sharedorder->getNumSeqs()), sharedorder(sharedorder), displays(disp), label(sharedorder->getLabel())  { m = MothurOut::getInstance(); }
+					numSeqs(sharedorder->getNumSeqs()), sharedorder(sharedorder), displays(disp), label(sharedorder->getLabel()), processors(1)  { m = MothurOut::getInstance(); }
+	Collect(SharedOrderVector* sharedorder, vector<Display*> disp, int p) :
+					numSeqs(sharedorder->getNumSeqs()), sharedorder(sharedorder), displays(disp), label(sharedorder->getLabel()), processors(p)  { m = MothurOut::getInstance(); }
 
 	~Collect(){		};
 	int getCurve(float);
@@ -26,6 +28,7 @@ private:
 	vector<Display*> displays;
 	int numSeqs, numGroupComb, totalNumSeq;
 	string label, groupLabel;
+	int processors;
 	void getGroupComb(vector<string>);
 	vector<string> groupComb;
 	bool validGroup(vector<string>, string);
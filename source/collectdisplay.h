@@ -24,6 +24,45 @@ public:
     void update(vector<SharedRAbundVector*> shared, int numSeqs, int numGroups, vector<string> mGroups){
         timesCalled++;
         data = estimate->getValues(shared);  //passes estimators a shared vector from each group to be compared
+        outputGroupData(shared, numSeqs, numGroups, mGroups);
+    };
+    
+    void update(SharedPairStats& stats, vector<SharedRAbundVector*> shared, int numSeqs, int numGroups, vector<string> mGroups){
+        timesCalled++;
+        data = estimate->getValues(stats);
+        outputGroupData(shared, numSeqs, numGroups, mGroups);
+    };
+    
+    bool hasPairStats() { return estimate->hasPairStats(); }
+									
+	void init(string s)		{	output->initFile(s);	};
+	void reset()			{	output->resetFile();	};
+	void close()			{	output->resetFile();	};
+	void setAll(bool a)		{	all = a;				}
+	bool getAll()			{	return all;				}
+	
+	
+	bool isCalcMultiple()	{ return estimate->getMultiple(); }
+	bool calcNeedsAll()     { return estimate->getNeedsAll(); }
+	bool hasLciHci()	{
+		if (estimate->getCols() == 3) { return true; } 
+		else{ return false; } 
+	}
+	
+	string getName()	{  return estimate->getName();  }
+	
+	
+private:
+	
+	Calculator* estimate;
+	FileOutput* output;
+	int nSeqs, timesCalled, numGroupComb;
+	vector<double> data;
+	vector<double> groupData;
+	bool all;
+    
+    //puts data in the pairs column, and outputs the line once all the pairs are in
+    void outputGroupData(vector<SharedRAbundVector*>& shared, int numSeqs, int numGroups, vector<string>& mGroups){
         
         //figure out what groups are being compared in getValues
         //because we randomizes the order we need to put the results in the correct column in the output file
@@ -73,33 +112,6 @@ public:
 			output->output(numSeqs, groupData);	
 		}
 	};
-									
-	void init(string s)		{	output->initFile(s);	};
-	void reset()			{	output->resetFile();	};
-	void close()			{	output->resetFile();	};
-	void setAll(bool a)		{	all = a;				}
-	bool getAll()			{	return all;				}
-	
-	
-	bool isCalcMultiple()	{ return estimate->getMultiple(); }
-	bool calcNeedsAll()     { return estimate->getNeedsAll(); }
-	bool hasLciHci()	{
-		if (estimate->getCols() == 3) { return true; } 
-		else{ return false; } 
-	}
-	
-	string getName()	{  return estimate->getName();  }
-	
-	
-private:
-	
-	Calculator* estimate;
-	FileOutput* output;
-	int nSeqs, timesCalled, numGroupComb;
-	vector<double> data;
-	vector<double> groupData;
-	bool all;
-	
 };
 
 /***********************************************************************/
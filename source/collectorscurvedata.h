@@ -46,6 +46,8 @@ public:
     void updateSharedData(vector<SharedRAbundVector*> s, int numSeqs, int numGroupComb, bool p, vector<string> g)	{	pairs = p; shared = s; NumSeqs = numSeqs; NumGroupComb = numGroupComb; groups = g; SharedDataChanged();	};
 	
 	void notifyDisplays(){	
+		SharedPairStats* stats = NULL; //made for the first display that can use it, then shared by the rest
+		
 		for(set<Display*>::iterator pos=displays.begin();pos!=displays.end();pos++){
 			
 			if ((*pos)->calcNeedsAll() ) {
@@ -55,13 +57,20 @@ public:
 				if ( ((*pos)->isCalcMultiple() ) && ((*pos)->getAll() ) && (!pairs) ) {
 					(*pos)->update(shared, NumSeqs, NumGroupComb, groups);
 				}else {
+					//the pair goes in its own vector, so the displays after this one still get all the groups
 					vector<SharedRAbundVector*> temp; temp.push_back(shared[0]); temp.push_back(shared[1]);
-					shared = temp; 
 					
-					(*pos)->update(shared, NumSeqs, NumGroupComb, groups);
+					if ((*pos)->hasPairStats()) {
+						if (stats == NULL) { stats = new SharedPairStats(temp[0]->get(), temp[1]->get()); }
+						(*pos)->update(*stats, temp, NumSeqs, NumGroupComb, groups);
+					}else {
+						(*pos)->update(temp, NumSeqs, NumGroupComb, groups);
+					}
 				}
 			}
 		}	
+		
+		if (stats != NULL) { delete stats; }
 	};
 	
 private:
@@ -31,6 +31,7 @@ vector<string> AlignCommand::setParameters(){
 		CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
 		CommandParameter pflip("flip", "Boolean", "", "T", "", "", "","",false,false); parameters.push_back(pflip);
 		CommandParameter pthreshold("threshold", "Number", "", "0.50", "", "", "","",false,false); parameters.push_back(pthreshold);
+		CommandParameter pband("band", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pband);
 		CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
@@ -49,7 +50,7 @@ string AlignCommand::getHelpString(){
 	try {
 		string helpString = "";
 		helpString += "The align.seqs command reads a file containing sequences and creates an alignment file and a report file.";
-		helpString += "The align.seqs command parameters are reference, fasta, search, ksize, align, match, mismatch, gapopen, gapextend and processors.";
+		helpString += "The align.seqs command parameters are reference, fasta, search, ksize, align, match, mismatch, gapopen, gapextend, band and processors.";
 		helpString += "The reference and fasta parameters are required. You may leave fasta blank if you have a valid fasta file. You may enter multiple fasta files by separating their names with dashes. ie. fasta=abrecovery.fasta-amzon.fasta.";
 		helpString += "The search parameter allows you to specify the method to find most similar template.  Your options are: suffix, kmer and blast. The default is kmer.";
 		helpString += "The align parameter allows you to specify the alignment method to use.  Your options are: gotoh, needleman, blast and noalign. The default is needleman.";
@@ -61,6 +62,7 @@ string AlignCommand::getHelpString(){
 		helpString += "The flip parameter is used to specify whether or not you want mothur to try the reverse complement if a sequence falls below the threshold.  The default is false.";
 		helpString += "The threshold is used to specify a cutoff at which an alignment is deemed 'bad' and the reverse complement may be tried. The default threshold is 0.50, meaning 50% of the bases are removed in the alignment.";
 		helpString += "If the flip parameter is set to true the reverse complement of the sequence is aligned and the better alignment is reported. Default=t";
+		helpString += "The band parameter allows you to limit the needleman and gotoh alignments to the diagonals of the ksize kmers the sequence shares with its closest template, plus this many bases on each side. If the alignment reaches the edge of the band, the sequence is realigned without it. The default is 0, meaning no band is used.";
 		helpString += "The default for the threshold parameter is 0.50, meaning at least 50% of the bases must remain or the sequence is reported as potentially reversed.";
 		helpString += "The align.seqs command should be in the following format:";
 		helpString += "align.seqs(reference=yourTemplateFile, fasta=yourCandidateFile, align=yourAlignmentMethod, search=yourSearchmethod, ksize=yourKmerSize, match=yourMatchBonus, mismatch=yourMismatchpenalty, gapopen=yourGapopenPenalty, gapextend=yourGapExtendPenalty)";
@@ -221,6 +223,10 @@ AlignCommand::AlignCommand(string option)  {
 			temp = validParameter.valid(parameters, "threshold");	if (temp == "not found"){	temp = "0.50";			}
 			util.mothurConvert(temp, threshold); 
 			
+			temp = validParameter.valid(parameters, "band");			if (temp == "not found"){	temp = "0";				}
+			util.mothurConvert(temp, band);
+			if (band < 0) { band = 0; }
+			
 			search = validParameter.valid(parameters, "search");		if (search == "not found"){	search = "kmer";		}
 			if ((search != "suffix") && (search != "kmer") && (search != "blast")) { m->mothurOut("invalid search option: choices are kmer, suffix or blast."); m->mothurOutEndLine(); abort=true; }
 			
@@ -332,6 +338,7 @@ struct alignStruct {
     string alignMethod, search;
     float match, misMatch, gapOpen, gapExtend, threshold;
     bool flip;
+    int kmerSize, band;
     long long numSeqs;
     
     vector<long long> flippedResults;
@@ -341,7 +348,7 @@ struct alignStruct {
     AlignmentDB* templateDB;
     Utils util;
     
-       alignStruct (linePair fP, OutputWriter* aFName, OutputWriter* reFName, OutputWriter* ac, string fname, string al, float ma, float misMa, float gOpen, float gExtend, float thr, bool fl, AlignmentDB* tB, string se) {
+       alignStruct (linePair fP, OutputWriter* aFName, OutputWriter* reFName, OutputWriter* ac, string fname, string al, float ma, float misMa, float gOpen, float gExtend, float thr, bool fl, AlignmentDB* tB, string se, int ks, int ba) {
         
         filePos.start = fP.start;
         filePos.end = fP.end;
@@ -360,6 +367,8 @@ struct alignStruct {
         flip = fl;
         templateDB = tB;
         search = se;
+        kmerSize = ks;
+        band = ba;
         flippedResults.resize(2, 0);
     }
     
@@ -369,10 +378,7 @@ void alignDriver(alignStruct* params) {
 	try {
         NastReport report;
 		
-		ifstream inFASTA;
-		params->util.openInputFile(params->inputFilename, inFASTA);
-
-		inFASTA.seekg(params->filePos.start);
+		SequenceReader inFASTA(params->inputFilename, params->filePos.start);
 
 		bool done = false;
         
@@ -382,6 +388,8 @@ void alignDriver(alignStruct* params) {
 		
 		//moved this into driver to avoid deep copies in windows paralellized version
 		Alignment* alignment;
+		int band = 0;									//	only the dynamic programming aligners use a band
+		if ((params->alignMethod == "gotoh") || (params->alignMethod == "needleman")) { band = params->band; }
 		int longestBase = params->templateDB->getLongestBase();
         if (params->m->getDebug()) { params->m->mothurOut("[DEBUG]: template longest base = "  + toString(longestBase) + " \n"); }
 		if(params->alignMethod == "gotoh")			{	alignment = new GotohOverlap(params->gapOpen, params->gapExtend, params->match, params->misMatch, longestBase);			}
@@ -398,7 +406,7 @@ void alignDriver(alignStruct* params) {
 			
 			if (params->m->getControl_pressed()) {  break; }
 			
-			Sequence* candidateSeq = new Sequence(inFASTA);  params->util.gobble(inFASTA);
+			Sequence* candidateSeq = new Sequence(inFASTA);
 			report.setCandidate(candidateSeq);
 
 			int origNumBases = candidateSeq->getNumBases();
@@ -415,7 +423,7 @@ void alignDriver(alignStruct* params) {
 				Sequence temp = params->templateDB->findClosestSequence(candidateSeq, searchScore);
 				Sequence* templateSeq = new Sequence(temp.getName(), temp.getAligned());
 								
-				Nast* nast = new Nast(alignment, candidateSeq, templateSeq);
+				Nast* nast = new Nast(alignment, candidateSeq, templateSeq, params->kmerSize, band);
 		
 				Sequence* copy;
 				
@@ -444,7 +452,7 @@ void alignDriver(alignStruct* params) {
                         
                         if (params->m->getDebug()) { params->m->mothurOut("[DEBUG]: closest template "  + temp2.getName() + " \n"); }
 						
-						nast2 = new Nast(alignment, copy, templateSeq2);
+						nast2 = new Nast(alignment, copy, templateSeq2, params->kmerSize, band);
                         
                         if (params->m->getDebug()) { params->m->mothurOut("[DEBUG]: completed Nast2 "  + candidateSeq->getName() + " flipped numBases = " + toString(copy->getNumBases()) + " old numbases = " + toString(candidateSeq->getNumBases()) +" \n"); }
 			
@@ -487,10 +495,10 @@ void alignDriver(alignStruct* params) {
 			delete candidateSeq;
 			
 			#if defined NON_WINDOWS
-				unsigned long long pos = inFASTA.tellg();
-				if ((pos == -1) || (pos >= params->filePos.end)) { break; }
+				unsigned long long pos = inFASTA.getPosition();
+				if (inFASTA.eof() || (pos >= params->filePos.end)) { break; }
 			#else
-				if (count == params->filePos.end) { break; }
+				if (inFASTA.eof() || (count == params->filePos.end)) { break; }
 			#endif
 			
 			//report progress
@@ -505,7 +513,6 @@ void alignDriver(alignStruct* params) {
         params->flippedResults[1] += numFlipped_1;
         
 		delete alignment;
-		inFASTA.close();
 		
 	}
 	catch(exception& e) {
@@ -542,7 +549,7 @@ long long AlignCommand::createProcesses(string alignFileName, string reportFileN
 
             
             alignStruct* dataBundle = new alignStruct(*lines[i+1], threadAlignWriter, threadReportWriter, threadAccnosWriter, filename,
-                                                        align, match, misMatch, gapOpen, gapExtend, threshold, flip, templateDB, search);
+                                                        align, match, misMatch, gapOpen, gapExtend, threshold, flip, templateDB, search, kmerSize, band);
             data.push_back(dataBundle);
 
             workerThreads.push_back(new thread(alignDriver, dataBundle));
@@ -553,7 +560,7 @@ long long AlignCommand::createProcesses(string alignFileName, string reportFileN
         OutputWriter* threadAccnosWriter = new OutputWriter(synchronizedOutputAccnosFile);
         
         alignStruct* dataBundle = new alignStruct(*lines[0], threadAlignWriter, threadReportWriter, threadAccnosWriter, filename,
-                                                  align, match, misMatch, gapOpen, gapExtend, threshold, flip, templateDB, search);
+                                                  align, match, misMatch, gapOpen, gapExtend, threshold, flip, templateDB, search, kmerSize, band);
         alignDriver(dataBundle);
         numFlipped[0] = dataBundle->flippedResults[0];
         numFlipped[1] = dataBundle->flippedResults[1];
@@ -54,7 +54,7 @@ private:
 		
 	string candidateFileName, templateFileName, distanceFileName, search, align, outputDir;
 	float match, misMatch, gapOpen, gapExtend, threshold;
-	int processors, kmerSize;
+	int processors, kmerSize, band;
 	vector<string> candidateFileNames;
 	vector<string> outputNames;
 	
@@ -11,6 +11,7 @@
  */
 
 #include "command.hpp"
+#include "permutationtest.h"
 class DesignMap;
 
 class AmovaCommand : public Command {
@@ -36,7 +37,6 @@ private:
 	double runAMOVA(ofstream&, map<string, vector<int> >, double);
 	double calcSSWithin(map<string, vector<int> >&);
 	double calcSSTotal(map<string, vector<int> >&);
-	map<string, vector<int> > getRandomizedGroups(map<string, vector<int> >);
 
 	bool abort;
 	vector<string> outputNames, Sets;
@@ -44,9 +44,21 @@ private:
 	string outputDir, inputDir, designFileName, phylipFileName;
 	DesignMap* designMap;
 	vector< vector<double> > distanceMatrix;
-	int iters;
+	int iters, processors;
 	double experimentwiseAlpha;
+	bool earlyStop;
 };
 
+/**************************************************************************************************/
+//sum of squares within groups from the squared distances, the amova randomization statistic
+class AmovaStatistic : public PermutationStatistic {
+	
+public:
+	AmovaStatistic(const vector< vector<double> >& matrix, map<string, vector<int> >& groupSampleMap) { setGroups(matrix, groupSampleMap); }
+	double getStatistic(const vector<int>&);
+};
+
+/**************************************************************************************************/
+
 #endif
 
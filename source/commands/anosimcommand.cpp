@@ -19,6 +19,8 @@ vector<string> AnosimCommand::setParameters(){
 		CommandParameter pphylip("phylip", "InputTypes", "", "", "none", "none", "none","anosim",false,true,true); parameters.push_back(pphylip);
 		CommandParameter piters("iters", "Number", "", "1000", "", "", "","",false,false); parameters.push_back(piters);
 		CommandParameter palpha("alpha", "Number", "", "0.05", "", "", "","",false,false); parameters.push_back(palpha);
+		CommandParameter pearlystop("earlystop", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(pearlystop);
+		CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
 		CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
@@ -38,10 +40,12 @@ string AnosimCommand::getHelpString(){
 		string helpString = "";
 		helpString += "Referenced: Clarke, K. R. (1993). Non-parametric multivariate analysis of changes in community structure.   _Australian Journal of Ecology_ 18, 117-143.\n";
 		helpString += "The anosim command outputs a .anosim file. \n";
-		helpString += "The anosim command parameters are phylip, iters, and alpha.  The phylip and design parameters are required, unless you have valid current files.\n";
+		helpString += "The anosim command parameters are phylip, iters, alpha, earlystop and processors.  The phylip and design parameters are required, unless you have valid current files.\n";
 		helpString += "The design parameter allows you to assign your samples to groups when you are running anosim. It is required. \n";
 		helpString += "The design file looks like the group file.  It is a 2 column tab delimited file, where the first column is the sample name and the second column is the group the sample belongs to.\n";
 		helpString += "The iters parameter allows you to set number of randomization for the P value.  The default is 1000. \n";
+		helpString += "The earlystop parameter allows you to stop the randomizations once the p-value can no longer fall below alpha. The p-value reported is then from the randomizations run. The default is false. \n";
+		helpString += "The processors parameter allows you to specify the number of processors to use for the randomizations. The default is all available. \n";
 		helpString += "The anosim command should be in the following format: anosim(phylip=file.dist, design=file.design).\n";
 		return helpString;
 	}
@@ -158,6 +162,12 @@ AnosimCommand::AnosimCommand(string option) {
 			temp = validParameter.valid(parameters, "alpha");
 			if (temp == "not found") { temp = "0.05"; }
 			util.mothurConvert(temp, experimentwiseAlpha); 
+
+			temp = validParameter.valid(parameters, "processors");	if (temp == "not found"){	temp = current->getProcessors();	}
+			processors = current->setProcessors(temp);
+			
+			temp = validParameter.valid(parameters, "earlystop");		if (temp == "not found"){	temp = "f";	}
+			earlyStop = util.isTrue(temp);
 		}
 		
 	}
@@ -282,14 +292,13 @@ double AnosimCommand::runANOSIM(ofstream& ANOSIMFile, vector<vector<double> > dM
 		vector<vector<double> > rankMatrix = convertToRanks(dMatrix);
 		double RValue = calcR(rankMatrix, groupSampleMap);
 		
-		int pCount = 0;
-		for(int i=0;i<iters;i++){
-			map<string, vector<int> > randGroupSampleMap = getRandomizedGroups(groupSampleMap);
-			double RValueRand = calcR(rankMatrix, randGroupSampleMap);
-			if(RValue <= RValueRand){	pCount++;	}
-		}
-
-		double pValue = (double)pCount / (double) iters;
+		AnosimStatistic statistic(rankMatrix, groupSampleMap);
+		vector<int> labels = statistic.getLabels();
+		
+		PermutationTest test(iters, processors);
+		if (earlyStop) { test.setEarlyStop(alpha); }
+		
+		double pValue = test.getPValue(&statistic, labels, statistic.getStatistic(labels), true);
 		string pString = "";
 		if(pValue < 1/(double)iters){	pString = '<' + toString(1/(double)iters);	}
 		else						{	pString = toString(pValue);					}
@@ -436,36 +445,44 @@ vector<vector<double> > AnosimCommand::convertToRanks(vector<vector<double> > di
 
 //**********************************************************************************************************************
 
-map<string, vector<int> > AnosimCommand::getRandomizedGroups(map<string, vector<int> > origMapping){
-	try{
-		vector<int> sampleIndices;
-		vector<int> samplesPerGroup;
+AnosimStatistic::AnosimStatistic(const vector< vector<double> >& rankMatrix, map<string, vector<int> >& groupSampleMap) {
+	try {
+		setGroups(rankMatrix, groupSampleMap);
 		
-		map<string, vector<int> >::iterator it;
-		for(it=origMapping.begin();it!=origMapping.end();it++){
-			vector<int> indices = it->second;
-			samplesPerGroup.push_back(indices.size());
-			sampleIndices.insert(sampleIndices.end(), indices.begin(), indices.end());
-		}
+		//the number of comparisons only depends on the group sizes
+		int numSamples = labels.size();
+		numWithinComps = 0;
+		for (int i = 0; i < numGroups; i++) { numWithinComps += groupSizes[i] * (groupSizes[i]-1) / 2; }
+		numBetweenComps = numSamples * (numSamples-1) / 2 - numWithinComps;
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "AnosimStatistic", "AnosimStatistic");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
+
+double AnosimStatistic::getStatistic(const vector<int>& sampleLabels) {
+	try {
+		vector<double> withinSums;
+		double between = getWithinSums(sampleLabels, withinSums);
 		
-		util.mothurRandomShuffle(sampleIndices);
+		double within = 0.0;
+		for (int i = 0; i < numGroups; i++) { within += withinSums[i]; }
 		
-		int index = 0;
-		map<string, vector<int> > randomizedGroups = origMapping;
-		for(it=randomizedGroups.begin();it!=randomizedGroups.end();it++){
-			for(int i=0;i<it->second.size();i++){
-				it->second[i] = sampleIndices[index++];				
-			}
-		}
+		within /= (float) numWithinComps;
+		between /= (float) numBetweenComps;
+		
+		int numSamples = sampleLabels.size();
+		double Rvalue = (between - within)/(numSamples * (numSamples-1) / 4.0);
 		
-		return randomizedGroups;		
+		return Rvalue;
 	}
-	catch (exception& e) {
-		m->errorOut(e, "AnosimCommand", "randomizeGroups");
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "AnosimStatistic", "getStatistic");
 		exit(1);
 	}
 }
-
 //**********************************************************************************************************************
 
 
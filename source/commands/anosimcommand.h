@@ -13,6 +13,7 @@
 
 #include "command.hpp"
 
+#include "permutationtest.h"
 class DesignMap;
 
 class AnosimCommand : public Command {
@@ -41,18 +42,32 @@ private:
 	
 	vector<vector<double> > convertToRanks(vector<vector<double> >);
 	double calcR(vector<vector<double> >, map<string, vector<int> >);
-	map<string, vector<int> > getRandomizedGroups(map<string, vector<int> >);
 	double runANOSIM(ofstream&, vector<vector<double> >, map<string, vector<int> >, double);
 	
 	vector< vector<double> > distanceMatrix;
 	vector<string> outputNames;
-	int iters;
+	int iters, processors;
 	double experimentwiseAlpha;
+	bool earlyStop;
 	vector< vector<string> > namesOfGroupCombos;
 	
 	
 };
 
+/**************************************************************************************************/
+//R from the mean rank of the distances within and between groups, the anosim randomization statistic
+class AnosimStatistic : public PermutationStatistic {
+	
+public:
+	AnosimStatistic(const vector< vector<double> >&, map<string, vector<int> >&); //rank matrix
+	double getStatistic(const vector<int>&);
+	
+private:
+	int numWithinComps, numBetweenComps;
+};
+
+/**************************************************************************************************/
+
 #endif
 
 
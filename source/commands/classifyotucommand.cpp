@@ -495,38 +495,42 @@ vector<string> ClassifyOtuCommand::findConsensusTaxonomy(vector<string> names, i
 		//build tree
 		phylo->assignHeirarchyIDs(0);
 		
-		TaxNode currentNode = phylo->get(0);
+		int currentNode = 0;
 		int myLevel = 0; 	
 		//at each level
-		while (currentNode.children.size() != 0) { //you still have more to explore
+		while (phylo->getChildren(currentNode).size() != 0) { //you still have more to explore
 		
-			TaxNode bestChild;
+			int bestChild = -1;
 			int bestChildSize = 0;
 			
 			//go through children
-			for (map<string, int>::iterator itChild = currentNode.children.begin(); itChild != currentNode.children.end(); itChild++) {
+			const vector<int>& children = phylo->getChildren(currentNode);
+			for (int i = 0; i < children.size(); i++) {
 				
-				TaxNode temp = phylo->get(itChild->second);
+				const TaxNode& temp = phylo->get(children[i]);
 				
 				//select child with largest accesions - most seqs assigned to it
 				if (temp.accessions.size() > bestChildSize) {
-					bestChild = phylo->get(itChild->second);
+					bestChild = children[i];
 					bestChildSize = temp.accessions.size();
 				}
 				
 			}
             
+            if (bestChild == -1) { break; }
+            string bestChildName = phylo->get(bestChild).name;
+            
             //phylotree adds an extra unknown so we want to remove that
-            if (bestChild.name == "unknown") { bestChildSize--; }
+            if (bestChildName == "unknown") { bestChildSize--; }
 				
 			//is this taxonomy above cutoff
 			int consensusConfidence = ceil((bestChildSize / (float) size) * 100);
             
 			if (consensusConfidence >= cutoff) { //if yes, add it
 				if (probs) {
-					conTax += bestChild.name + "(" + toString(consensusConfidence) + ");";
+					conTax += bestChildName + "(" + toString(consensusConfidence) + ");";
 				}else{
-					conTax += bestChild.name + ";";
+					conTax += bestChildName + ";";
 				}
 				myLevel++;
 			}else{ //if no, quit
@@ -15,7 +15,7 @@
 //**********************************************************************************************************************
 vector<string> ClassifyRFSharedCommand::setParameters(){	
 	try {
-		//CommandParameter pprocessors("processors", "Number", "", "1", "", "", "",false,false); parameters.push_back(pprocessors);        
+		CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
         CommandParameter pshared("shared", "InputTypes", "", "", "none", "none", "none","summary",false,true,true); parameters.push_back(pshared);		
         CommandParameter pdesign("design", "InputTypes", "", "", "none", "none", "none","",false,true,true); parameters.push_back(pdesign);	
         CommandParameter potupersplit("otupersplit", "Multiple", "log2-squareroot", "log2", "", "", "","",false,false); parameters.push_back(potupersplit);
@@ -50,7 +50,8 @@ string ClassifyRFSharedCommand::getHelpString(){
 	try {
 		string helpString = "";
 		helpString += "The classify.rf command allows you to ....\n";
-		helpString += "The classify.rf command parameters are: shared, design, label, groups, otupersplit.\n";
+		helpString += "The classify.rf command parameters are: shared, design, label, groups, otupersplit, numtrees and processors.\n";
+        helpString += "The processors parameter allows you to specify the number of processors to use. The decision trees are divided among them. Default=1.\n";
         helpString += "The label parameter is used to analyze specific labels in your input.\n";
         //helpString += "The sets parameter allows you to specify which of the sets in your designfile you would like to analyze. The set names are separated by dashes. THe default is all sets in the designfile.\n";
 		helpString += "The groups parameter allows you to specify which of the groups in your designfile you would like analyzed.\n";
@@ -181,6 +182,9 @@ ClassifyRFSharedCommand::ClassifyRFSharedCommand(string option) {
         temp = validParameter.valid(parameters, "numtrees"); if (temp == "not found"){	temp = "100";	}
         util.mothurConvert(temp, numDecisionTrees);
         
+        temp = validParameter.valid(parameters, "processors");	if (temp == "not found"){	temp = current->getProcessors();	}
+        processors = current->setProcessors(temp);
+        
             // parameters for pruning
         temp = validParameter.valid(parameters, "prune");
         if (temp == "not found") { temp = "f"; }
@@ -358,8 +362,11 @@ void ClassifyRFSharedCommand::processSharedAndDesignData(vector<SharedRAbundVect
         //vector<string> groups = designMap.getCategory();
         for (int i = 0; i < lookup.size(); i++) {
             string treatmentName = designMap.get(lookup[i]->getGroup());
-            treatmentToIntMap[treatmentName] = i;
-            intToTreatmentMap[i] = treatmentName;
+            if (treatmentToIntMap.count(treatmentName) == 0) { //outcomes are 0 to numTreatments-1
+                int treatmentIndex = treatmentToIntMap.size();
+                treatmentToIntMap[treatmentName] = treatmentIndex;
+                intToTreatmentMap[treatmentIndex] = treatmentName;
+            }
         }
         
         int numSamples = lookup.size();
@@ -385,7 +392,7 @@ void ClassifyRFSharedCommand::processSharedAndDesignData(vector<SharedRAbundVect
             dataSet[i][j] = treatmentToIntMap[treatmentName];
         }
         
-        RandomForest randomForest(dataSet, numDecisionTrees, treeSplitCriterion, doPruning, pruneAggressiveness, discardHighErrorTrees, highErrorTreeDiscardThreshold, optimumFeatureSubsetSelectionCriteria, featureStandardDeviationThreshold);
+        RandomForest randomForest(dataSet, numDecisionTrees, treeSplitCriterion, doPruning, pruneAggressiveness, discardHighErrorTrees, highErrorTreeDiscardThreshold, optimumFeatureSubsetSelectionCriteria, featureStandardDeviationThreshold, processors);
         
         randomForest.populateDecisionTrees();
         
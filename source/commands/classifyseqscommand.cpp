@@ -624,19 +624,16 @@ struct classifyData {
 //**********************************************************************************************************************
 void driverClassifier(classifyData* params){
     try {
-        ifstream inFASTA;
-        params->util.openInputFile(params->filename, inFASTA);
+        SequenceReader inFASTA(params->filename, params->start);
         
         string taxonomy;
         
-        inFASTA.seekg(params->start);
-        
         bool done = false;
         string taxBuffer = ""; string taxTBuffer = ""; string accnosBuffer = "";
         while (!done) {
             if (params->m->getControl_pressed()) { break; }
             
-            Sequence* candidateSeq = new Sequence(inFASTA); params->util.gobble(inFASTA);
+            Sequence* candidateSeq = new Sequence(inFASTA);
             
             if (candidateSeq->getName() != "") {
                 
@@ -660,10 +657,10 @@ void driverClassifier(classifyData* params){
             delete candidateSeq;
             
 #if defined NON_WINDOWS
-            unsigned long long pos = inFASTA.tellg();
-            if ((pos == -1) || (pos >= params->end)) { break; }
+            unsigned long long pos = inFASTA.getPosition();
+            if (inFASTA.eof() || (pos >= params->end)) { break; }
 #else
-            if (params->count == params->end) { break; }
+            if (inFASTA.eof() || (params->count == params->end)) { break; }
 #endif
             
             //report progress
@@ -683,7 +680,6 @@ void driverClassifier(classifyData* params){
             if (accnosBuffer != "") { params->accnosWriter->write(accnosBuffer); accnosBuffer = ""; }
         }
         
-        inFASTA.close();
     }
     catch(exception& e) {
         params->m->errorOut(e, "ClassifySeqsCommand", "driver");
@@ -11,7 +11,10 @@
 //**********************************************************************************************************************
 vector<string> ClassifySvmSharedCommand::setParameters() {
     try {
-        //CommandParameter pprocessors("processors", "Number", "", "1", "", "", "",false,false); parameters.push_back(pprocessors);
+        CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
+        // memory budget in MB for the cached kernel values
+        CommandParameter pcachesize("cachesize", "Number", "", "512", "", "", "", "", false, false);
+        parameters.push_back(pcachesize);
         CommandParameter pshared("shared", "InputTypes", "", "", "none", "none", "none", "summary", false, true, true);
         parameters.push_back(pshared);
         CommandParameter pdesign("design", "InputTypes", "", "", "none", "none", "none", "", false, true, true);
@@ -74,10 +77,12 @@ string ClassifySvmSharedCommand::getHelpString() {
     try {
         string helpString = "";
         helpString += "The classifysvm.shared command allows you to ....\n";
-        helpString += "The classifysvm.shared command parameters are: shared, design, label, groups.\n";
+        helpString += "The classifysvm.shared command parameters are: shared, design, label, groups, processors and cachesize.\n";
         helpString += "The label parameter is used to analyze specific labels in your input.\n";
         helpString +=
                 "The groups parameter allows you to specify which of the groups in your designfile you would like analyzed.\n";
+        helpString += "The processors parameter allows you to specify the number of processors to use. The kernel and parameter combinations are cross validated in parallel.\n";
+        helpString += "The cachesize parameter allows you to set the memory in megabytes used to store kernel values. Default=512.\n";
         helpString += "The classifysvm.shared should be in the following format: \n";
         helpString += "classifysvm.shared(shared=yourSharedFile, design=yourDesignFile)\n";
         return helpString;
@@ -410,6 +415,18 @@ ClassifySvmSharedCommand::ClassifySvmSharedCommand(string option) {
                 }
             }
 
+            string temp = validParameter.valid(parameters, "processors");
+            if (temp == "not found"){ temp = current->getProcessors(); }
+            processors = current->setProcessors(temp);
+
+            temp = validParameter.valid(parameters, "cachesize");
+            if (temp == "not found"){ temp = "512"; }
+            util.mothurConvert(temp, cacheSize);
+            if (cacheSize <= 0) {
+                m->mothurOut("cachesize set to unsupported value " + temp + " -- must be greater than 0, using 512"); m->mothurOutEndLine();
+                cacheSize = 512;
+            }
+
             // get the std threshold option
             string stdthresholdOption = validParameter.valid(parameters, "stdthreshold");
             if ( stdthresholdOption == "not found" ) {
@@ -607,6 +624,26 @@ void printPerformanceSummary(MultiClassSVM* s, ostream& output) {
 }
 //**********************************************************************************************************************
 
+void ClassifySvmSharedCommand::printRowCacheSummary(OneVsOneMultiClassSvmTrainer& trainer) {
+    try {
+        long long rowsUsed = trainer.getRowCacheHits() + trainer.getRowCacheMisses();
+        double hitRate = 0.0;
+        if (rowsUsed != 0) { hitRate = 100.0 * trainer.getRowCacheHits() / (double) rowsUsed; }
+
+        m->mothurOut("Kernel cache: used " + toString(trainer.getRowCachePeakBytes() / 1048576.0) + " of " + toString(trainer.getRowCacheBytes() / 1048576.0) + " MB, "
+                     + toString(trainer.getRowCacheMisses()) + " rows calculated, " + toString(trainer.getRowCacheEvictions()) + " rows dropped, "
+                     + toString(hitRate) + "% of rows found in the cache."); m->mothurOutEndLine();
+        if (trainer.getRowCacheEvictions() != 0) {
+            m->mothurOut("Kernel rows were dropped to stay within the cachesize, increasing cachesize may speed up training."); m->mothurOutEndLine();
+        }
+    }
+    catch (exception& e) {
+        m->errorOut(e, "ClassifySvmSharedCommand", "printRowCacheSummary");
+        exit(1);
+    }
+}
+//**********************************************************************************************************************
+
 void ClassifySvmSharedCommand::processSharedAndDesignData(vector<SharedRAbundVector*> lookup, vector<string> currentLabels) {
     try {
         OutputFilter outputFilter(verbosity);
@@ -641,13 +678,14 @@ void ClassifySvmSharedCommand::processSharedAndDesignData(vector<SharedRAbundVec
 
         SvmDataset svmDataset(labeledObservationVector, featureVector);
 
-        OneVsOneMultiClassSvmTrainer trainer(svmDataset, evaluationFoldCount, trainingFoldCount, outputFilter);
+        OneVsOneMultiClassSvmTrainer trainer(svmDataset, evaluationFoldCount, trainingFoldCount, outputFilter, processors, (long long)(cacheSize * 1048576.0));
 
         if ( mode == "rfe" ) {
             SvmRfe svmRfe;
             ParameterRange& linearKernelConstantRange = kernelParameterRangeMap["linear"]["constant"];
             ParameterRange& linearKernelSmoCRange = kernelParameterRangeMap["linear"]["smoc"];
             RankedFeatureList rankedFeatureList = svmRfe.getOrderedFeatureList(svmDataset, trainer, linearKernelConstantRange, linearKernelSmoCRange);
+            printRowCacheSummary(trainer);
 
             map<string, string> variables;
             variables["[filename]"] = outputDir + util.getRootName(util.getSimpleName(sharedfile));
@@ -685,6 +723,7 @@ void ClassifySvmSharedCommand::processSharedAndDesignData(vector<SharedRAbundVec
         }
         else {
             MultiClassSVM* mcsvm = trainer.train(kernelParameterRangeMap);
+            printRowCacheSummary(trainer);
 
             map<string, string> variables;
             variables["[filename]"] = outputDir + util.getRootName(util.getSimpleName(sharedfile));
@@ -734,7 +773,7 @@ void ClassifySvmSharedCommand::trainSharedAndDesignData(vector<SharedRAbundVecto
         int evaluationFoldCount = 3;
         int trainFoldCount = 5;
         OutputFilter outputFilter(2);
-        OneVsOneMultiClassSvmTrainer t(svmDataset, evaluationFoldCount, trainFoldCount, outputFilter);
+        OneVsOneMultiClassSvmTrainer t(svmDataset, evaluationFoldCount, trainFoldCount, outputFilter, processors, (long long)(cacheSize * 1048576.0));
         KernelParameterRangeMap kernelParameterRangeMap;
         getDefaultKernelParameterRangeMap(kernelParameterRangeMap);
         t.train(kernelParameterRangeMap);
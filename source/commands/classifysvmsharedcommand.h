@@ -67,10 +67,12 @@ private:
     int verbosity;
 
     double stdthreshold;
+    double cacheSize; //MB
 
 
     void processSharedAndDesignData(vector<SharedRAbundVector*> lookup, vector<string>);
     void trainSharedAndDesignData(vector<SharedRAbundVector*> lookup, vector<string>);
+    void printRowCacheSummary(OneVsOneMultiClassSvmTrainer&);
 
     void getParameterValue(int& target, string pstring, int defaultvalue) {
         if (pstring == "not found" or pstring == "") {
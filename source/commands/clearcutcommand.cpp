@@ -38,6 +38,7 @@ vector<string> ClearcutCommand::setParameters(){
 		CommandParameter pntrees("ntrees", "Number", "", "1", "", "", "","",false,false); parameters.push_back(pntrees);
 		CommandParameter pmatrixout("matrixout", "String", "", "", "", "", "","",false,false); parameters.push_back(pmatrixout);
 		CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
+		CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
 		
@@ -56,7 +57,7 @@ string ClearcutCommand::getHelpString(){
 		string helpString = "";
 		helpString += "The clearcut command interfaces mothur with the clearcut program written by Initiative for Bioinformatics and Evolutionary Studies (IBEST) at the University of Idaho.\n";
 		helpString += "For more information about clearcut refer to http://bioinformatics.hungry.com/clearcut/ \n";
-		helpString += "The clearcut command parameters are phylip, fasta, version, verbose, quiet, seed, norandom, shuffle, neighbor, expblen, expdist, ntrees, matrixout, stdout, kimura, jukes, protein, DNA. \n";
+		helpString += "The clearcut command parameters are phylip, fasta, version, verbose, quiet, seed, norandom, shuffle, neighbor, expblen, expdist, ntrees, matrixout, stdout, kimura, jukes, protein, DNA and processors. \n";
 		helpString += "The phylip parameter allows you to enter your phylip formatted distance matrix. \n";
 		helpString += "The fasta parameter allows you to enter your aligned fasta file, if you enter a fastafile you specify if the sequences are DNA or protein using the DNA or protein parameters. \n";
 		
@@ -67,6 +68,7 @@ string ClearcutCommand::getHelpString(){
 		helpString += "The norandom parameter allows you to attempt joins deterministically, default=F. \n";
 		helpString += "The shuffle parameter allows you to randomly shuffle the distance matrix, default=F. \n";
 		helpString += "The neighbor parameter allows you to use traditional Neighbor-Joining algorithm, default=T. \n";
+		helpString += "The processors parameter allows you to specify the number of threads used to search the distance matrix. Default=1. \n";
 		
 		helpString += "The DNA parameter allows you to indicate your fasta file contains DNA sequences, default=F. \n";
 		helpString += "The protein parameter allows you to indicate your fasta file contains protein sequences, default=F. \n";
@@ -244,6 +246,9 @@ ClearcutCommand::ClearcutCommand(string option)  {
 			temp = validParameter.valid(parameters, "expdist");		if (temp == "not found"){	temp = "F";			}
 			expdist = util.isTrue(temp);
 			
+			temp = validParameter.valid(parameters, "processors");	if (temp == "not found"){	temp = current->getProcessors();	}
+			processors = current->setProcessors(temp);
+			
 			if ((fastafile != "") && ((!DNA) && (!protein))) { m->mothurOut("You must specify the type of sequences you are using: DNA or protein"); m->mothurOutEndLine(); abort=true; }
 		}
 
@@ -265,7 +270,7 @@ int ClearcutCommand::execute() {
 		string outputName = getOutputFileName("tree", variables);
 		outputNames.push_back(outputName); outputTypes["tree"].push_back(outputName);
 		
-        int numArgs = 4; //clearcut, in, out and fastafile or phylipfile
+        int numArgs = 5; //clearcut, in, out, processors and fastafile or phylipfile
         if (version) { numArgs++; } if (verbose) { numArgs++; } if (quiet) { numArgs++; } if (seed != "*")	{ numArgs++; } if (norandom) { numArgs++; }
         if (shuffle) { numArgs++; } if (neighbor) { numArgs++; } if (stdoutWanted) { numArgs++; } if (DNA)	{ numArgs++; } if (protein) { numArgs++; }
         if (jukes) { numArgs++; } if (kimura) { numArgs++; } if (matrixout != "") { numArgs++; } if (ntrees != "1")	{ numArgs++; } if (expblen) { numArgs++; } if (expdist) { numArgs++; }
@@ -333,6 +338,11 @@ int ClearcutCommand::execute() {
 
 		if (expblen)			{ clearcutParameters[parameterCount] = new char[10];  *clearcutParameters[parameterCount] = '\0'; strncat(clearcutParameters[parameterCount], "--expblen", 9);  parameterCount++; 	}
 		if (expdist)			{ clearcutParameters[parameterCount] = new char[10];  *clearcutParameters[parameterCount] = '\0'; strncat(clearcutParameters[parameterCount], "--expdist", 9);  parameterCount++;	}
+		
+		string tempProcessors = "--processors=" + toString(processors);
+		clearcutParameters[parameterCount] = new char[tempProcessors.length()+1];
+		*clearcutParameters[parameterCount] = '\0'; strncat(clearcutParameters[parameterCount], tempProcessors.c_str(), tempProcessors.length());
+		parameterCount++;
         
         errno = 0;
 		clearcut_main(numArgs, clearcutParameters); 
@@ -43,6 +43,7 @@ private:
 	string outputDir, phylipfile, fastafile, matrixout, inputFile, seed, ntrees;
 	bool version, verbose, quiet, norandom, shuffle, neighbor, expblen, expdist, stdoutWanted, kimura, jukes, protein, DNA;
 	bool abort;
+	int processors;
 	vector<string> outputNames;
 	
 };
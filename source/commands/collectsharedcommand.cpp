@@ -63,6 +63,7 @@ vector<string> CollectSharedCommand::setParameters(){
 		CommandParameter pall("all", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(pall);
 		CommandParameter pgroups("groups", "String", "", "", "", "", "","",false,false); parameters.push_back(pgroups);
 		CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
+		CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
 		
@@ -80,7 +81,7 @@ string CollectSharedCommand::getHelpString(){
 	try {
 		string helpString = "";
 		ValidCalculators validCalculator;
-		helpString += "The collect.shared command parameters are shared, label, freq, calc and groups.  shared is required if there is no current sharedfile. \n";
+		helpString += "The collect.shared command parameters are shared, label, freq, calc, processors and groups.  shared is required if there is no current sharedfile. \n";
 		helpString += "The collect.shared command should be in the following format: \n";
 		helpString += "collect.shared(label=yourLabel, freq=yourFreq, calc=yourEstimators, groups=yourGroups).\n";
 		helpString += "Example collect.shared(label=unique-.01-.03, freq=10, groups=B-C, calc=sharedchao-sharedace-jabund-sorensonabund-jclass-sorclass-jest-sorest-thetayc-thetan).\n";
@@ -92,6 +93,7 @@ string CollectSharedCommand::getHelpString(){
 		helpString += "The all parameter is used to specify if you want the estimate of all your groups together.  This estimate can only be made for sharedsobs and sharedchao calculators. The default is false.\n";
 		helpString += "If you use sharedchao and run into memory issues, set all to false. \n";
 		helpString += "The groups parameter allows you to specify which of the groups in your groupfile you would like analyzed.  You must enter at least 2 valid groups.\n";
+		helpString += "The processors parameter allows you to specify the number of processors to use. The calculators are divided between the processors. The default is 1.\n";
 		
 		return helpString;
 	}
@@ -341,6 +343,9 @@ CollectSharedCommand::CollectSharedCommand(string option)  {
 			
 			temp = validParameter.valid(parameters, "all");				if (temp == "not found") { temp = "false"; }
 			all = util.isTrue(temp);
+			
+			temp = validParameter.valid(parameters, "processors");	if (temp == "not found"){	temp = current->getProcessors();	}
+			processors = current->setProcessors(temp);
 						
 			if (!abort) {
 				
@@ -524,7 +529,7 @@ int CollectSharedCommand::execute(){
 			
 				m->mothurOut(order->getLabel()); m->mothurOutEndLine();
 				//create collectors curve
-				cCurve = new Collect(order, cDisplays);
+				cCurve = new Collect(order, cDisplays, processors);
 				cCurve->getSharedCurve(freq);
 				delete cCurve;
 			
@@ -541,7 +546,7 @@ int CollectSharedCommand::execute(){
 				
 				m->mothurOut(order->getLabel()); m->mothurOutEndLine();
 				//create collectors curve
-				cCurve = new Collect(order, cDisplays);
+				cCurve = new Collect(order, cDisplays, processors);
 				cCurve->getSharedCurve(freq);
 				delete cCurve;
 				
@@ -582,7 +587,7 @@ int CollectSharedCommand::execute(){
 			order = input->getSharedOrderVector(lastLabel);
 			
 			m->mothurOut(order->getLabel()); m->mothurOutEndLine();
-			cCurve = new Collect(order, cDisplays);
+			cCurve = new Collect(order, cDisplays, processors);
 			cCurve->getSharedCurve(freq);
 			delete cCurve;
 			
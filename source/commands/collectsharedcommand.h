@@ -45,6 +45,7 @@ private:
 	Collect* cCurve;
 	vector<Display*> cDisplays;
 	float freq;
+	int processors;
 
 	bool abort, allLines, all;
 	set<string> labels; //holds labels to be used
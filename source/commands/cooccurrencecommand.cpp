@@ -17,6 +17,7 @@ vector<string> CooccurrenceCommand::setParameters() {
 		CommandParameter pmatrix("matrixmodel", "Multiple", "sim1-sim2-sim3-sim4-sim5-sim6-sim7-sim8-sim9", "sim2", "", "", "","",false,false); parameters.push_back(pmatrix);
         CommandParameter pruns("iters", "Number", "", "1000", "", "", "","",false,false); parameters.push_back(pruns);
 		CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
+        CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
 		CommandParameter plabel("label", "String", "", "", "", "", "","",false,false); parameters.push_back(plabel);
@@ -35,10 +36,11 @@ vector<string> CooccurrenceCommand::setParameters() {
 string CooccurrenceCommand::getHelpString(){	
 	try {
 		string helpString = "The cooccurrence command calculates four metrics and tests their significance to assess whether presence-absence patterns are different than what one would expect by chance.";
-        helpString += "The cooccurrence command parameters are shared, metric, matrixmodel, iters, label and groups.";
+        helpString += "The cooccurrence command parameters are shared, metric, matrixmodel, iters, label, groups and processors.";
         helpString += "The matrixmodel parameter options are sim1, sim2, sim3, sim4, sim5, sim6, sim7, sim8 and sim9. Default=sim2";
         helpString += "The metric parameter options are cscore, checker, combo and vratio. Default=cscore";
         helpString += "The label parameter is used to analyze specific labels in your input.\n";
+        helpString += "The processors parameter allows you to specify the number of processors to use for generating the null matrices. The default is all available.\n";
 		helpString += "The groups parameter allows you to specify which of the groups you would like analyzed.\n";
         helpString += "The cooccurrence command should be in the following format: \n";
 		helpString += "cooccurrence(shared=yourSharedFile) \n";
@@ -145,7 +147,7 @@ CooccurrenceCommand::CooccurrenceCommand(string option) {
 			outputDir = validParameter.valid(parameters, "outputdir");		if (outputDir == "not found"){	outputDir = util.hasPath(sharedfile);		}
 
 			
-			metric = validParameter.validFile(parameters, "metric");				if (metric == "not found") { metric = "cscore"; }
+			metric = validParameter.valid(parameters, "metric");				if (metric == "not found") { metric = "cscore"; }
 			
 			if ((metric != "cscore") && (metric != "checker") && (metric != "combo") && (metric != "vratio")) {
 				m->mothurOut("[ERROR]: " + metric + " is not a valid metric option for the cooccurrence command. Choices are cscore, checker, combo, vratio."); m->mothurOutEndLine(); abort = true; 
@@ -166,6 +168,9 @@ CooccurrenceCommand::CooccurrenceCommand(string option) {
             
             string temp = validParameter.valid(parameters, "iters");			if (temp == "not found") { temp = "1000"; }
 			util.mothurConvert(temp, runs); 
+            
+            temp = validParameter.valid(parameters, "processors");	if (temp == "not found"){	temp = current->getProcessors();	}
+			processors = current->setProcessors(temp);
 
 		}
 
@@ -286,44 +291,39 @@ int CooccurrenceCommand::getCooccurrence(SharedRAbundVectors*& thisLookUp, ofstr
             return 0;
         }
         
-        vector< vector<int> > co_matrix; co_matrix.resize(thisLookUp->getNumBins());
-        for (int i = 0; i < thisLookUp->getNumBins(); i++) { co_matrix[i].resize((thisLookUp->size()), 0); }
-        vector<int> columntotal; columntotal.resize(thisLookUp->size(), 0);
-        vector<int> rowtotal; rowtotal.resize(numOTUS, 0);
+        //nrows is ncols of inital matrix. All the functions need this value. They assume the transposition has already taken place and nrows and ncols refer to that matrix.
+        //co_matrix is the transposed shared file as presence/absence. The abundancevector is only what was read in ie not a co-occurrence matrix!
+        int nrows = numOTUS;//rows of inital matrix
+        int ncols = thisLookUp->size();//groups
+        
+        PresenceMatrix co_matrix(nrows, ncols);
+        vector<int> columntotal; columntotal.resize(ncols, 0);
+        vector<int> rowtotal; rowtotal.resize(nrows, 0);
         
-        for (int j = 0; j < thisLookUp->getNumBins(); j++) { //cols of original shared file
+        for (int j = 0; j < nrows; j++) { //cols of original shared file
             vector<int> abunds = thisLookUp->getOTU(j);
-        for (int i = 0; i < abunds.size(); i++) { //nrows in the shared file
-            
+            for (int i = 0; i < abunds.size(); i++) { //nrows in the shared file
+                
                 if (m->getControl_pressed()) { return 0; }
-            int abund = abunds[i];
-            
-                if(abund > 0) {
-                    co_matrix[j][i] = 1;
+                
+                if(abunds[i] > 0) {
+                    co_matrix.set(j, i);
                     rowtotal[j]++;
                     columntotal[i]++;
                 }
             }
         }
         
-        
-        //nrows is ncols of inital matrix. All the functions need this value. They assume the transposition has already taken place and nrows and ncols refer to that matrix.
-        //comatrix and initmatrix are still vectors of vectors of ints as in the original script. The abundancevector is only what was read in ie not a co-occurrence matrix!
-        int nrows = numOTUS;//rows of inital matrix
-        int ncols = thisLookUp->size();//groups
         double initscore = 0.0;
-       
-        vector<double> stats;
         vector<double> probabilityMatrix; probabilityMatrix.resize(ncols * nrows, 0);
-        vector<vector<int> > nullmatrix(nrows, vector<int>(ncols, 0));
-       
+        
         TrialSwap2 trial;
         
         int n = accumulate( columntotal.begin(), columntotal.end(), 0 );
         
         //============================================================
         
-        //generate a probability matrix. Only do this once.
+        //generate a cumulative probability matrix. Only do this once. The column models (sim3 and sim5) are stored by column.
         float start = 0.0;
         
         if (matrix == "sim1") {
@@ -336,20 +336,12 @@ int CooccurrenceCommand::getCooccurrence(SharedRAbundVectors*& thisLookUp, ofstr
         }
         //don't need a prob matrix because we just shuffle the rows, may use this in the future
         else if (matrix == "sim2") { }
-//            for(int i=0;i<nrows;i++) {
-//                start = 0.0;
-//                for(int j=0;j<ncols;j++) {
-//                    probabilityMatrix[ncols * i + j] = start + 1/double(ncols);
-//                    start = start + 1/double(ncols);
-//                }
-//            }
-//        }
         
         else if (matrix == "sim3") {
             for(int j=0;j<ncols;j++) {
                 start = 0.0;
                 for(int i=0;i<nrows;i++) {
-                    probabilityMatrix[ncols * i + j] = start + 1/double(nrows);
+                    probabilityMatrix[nrows * j + i] = start + 1/double(nrows);
                     start = start + 1/double(nrows);
                 }
             }
@@ -369,7 +361,7 @@ int CooccurrenceCommand::getCooccurrence(SharedRAbundVectors*& thisLookUp, ofstr
             for(int j=0;j<ncols;j++) {
                 start = 0.0;
                 for(int i=0;i<nrows;i++) {
-                    probabilityMatrix[ncols * i + j] = start + rowtotal[i]/double(n);
+                    probabilityMatrix[nrows * j + i] = start + rowtotal[i]/double(n);
                     start = start + rowtotal[i]/double(n);
                 }
             }
@@ -409,136 +401,19 @@ int CooccurrenceCommand::getCooccurrence(SharedRAbundVectors*& thisLookUp, ofstr
         }
         
         
-        //co_matrix is the transposed shared file, initmatrix is the original shared file
-        if (metric == "cscore") { initscore = trial.calc_c_score(co_matrix, rowtotal, ncols, nrows); }
-        else if (metric == "checker") { initscore = trial.calc_checker(co_matrix, rowtotal, ncols, nrows); }
+        //co_matrix is the transposed shared file
+        if (metric == "cscore") { initscore = trial.calc_c_score(co_matrix, rowtotal); }
+        else if (metric == "checker") { initscore = trial.calc_checker(co_matrix); }
         else if (metric == "vratio") { initscore = trial.calc_vratio(nrows, ncols, rowtotal, columntotal); }
-        else if (metric == "combo") { initscore = trial.calc_combo(nrows, ncols, co_matrix); }
+        else if (metric == "combo") { initscore = trial.calc_combo(co_matrix); }
         else { m->mothurOut("[ERROR]: No metric selected!\n"); m->setControl_pressed(true); return 1; }
         
         m->mothurOut("Initial c score: " + toString(initscore)); m->mothurOutEndLine();
         
-        double previous;
-        double current;
-        double randnum;
-        int count;
-
-        //burn-in for sim9    
-        if(matrix == "sim9") {
-            for(int i=0;i<10000;i++) trial.swap_checkerboards (co_matrix, ncols, nrows);
-        }
-
-        //populate null matrix from probability matrix, do this a lot.
-        for(int k=0;k<runs;k++){
-            nullmatrix.clear();
-            //zero-fill the null matrix
-            nullmatrix.assign(nrows, vector<int>(ncols, 0));
-            
-            if(matrix == "sim1" || matrix == "sim6" || matrix == "sim8" || matrix == "sim7") {
-                count = 0;
-                while(count < n) {
-                    if (m->getControl_pressed()) { return 0; }
-                nextnum2:
-                    previous = 0.0;
-                    randnum = util.getRandomDouble0to1();
-                    for(int i=0;i<nrows;i++) {
-                        for(int j=0;j<ncols;j++) {
-                            current = probabilityMatrix[ncols * i + j];
-                            if(randnum <= current && randnum > previous) {
-                                nullmatrix[i][j] = 1;
-                                count++;
-                                if (count > n) break;
-                                else
-                                    goto nextnum2;
-                            }
-                            previous = current;
-                        }
-                    }
-                }
-            }
-            
-            else if (matrix == "sim2") {
-                for(int i=0;i<nrows;i++) {
-                    util.mothurRandomShuffle(co_matrix[i]);
-                }
-                //do this for the scoring since those all have nullmatrix as a parameter
-                //nullmatrix gets cleared at the begining of each run
-                nullmatrix = co_matrix;
-            }
-            
-            else if(matrix == "sim4") {
-                for(int i=0;i<nrows;i++) {
-                    count = 0;
-                    while(count < rowtotal[i]) {
-                        previous = 0.0;
-                        if (m->getControl_pressed()) { return 0; }
-                        randnum = util.getRandomDouble0to1();
-                        for(int j=0;j<ncols;j++) {
-                            current = probabilityMatrix[ncols * i + j];
-                            if(randnum <= current && randnum > previous && nullmatrix[i][j] != 1) {
-                                nullmatrix[i][j] = 1;
-                                count++;
-                                previous = 0.0;
-                                break;
-                            }
-                            previous = current;
-                        }
-                    }
-                }
-            }
-            
-            else if(matrix == "sim3" || matrix == "sim5") {
-                //columns
-                for(int j=0;j<ncols;j++) {
-                    count = 0;
-                    while(count < columntotal[j]) {
-                        if (m->getControl_pressed()) { return 0; }
-                        randnum = util.getRandomDouble0to1();
-                        for(int i=0;i<nrows;i++) {
-                            current = probabilityMatrix[ncols * i + j];
-                            if(randnum <= current && randnum > previous && nullmatrix[i][j] != 1) {
-                                nullmatrix[i][j] = 1;
-                                count++;
-                                previous = 0.0;
-                                break;
-                            }
-                            previous = current;
-                        }
-                    }
-                }
-            }
-            
-            //swap_checkerboards takes the original matrix and swaps checkerboards
-            else if(matrix == "sim9") {
-                trial.swap_checkerboards (co_matrix, ncols, nrows);
-                nullmatrix = co_matrix;
-            }
-            else {
-                m->mothurOut("[ERROR]: No null model selected!\n\n"); m->setControl_pressed(true);
-                return 1;
-            }
-            
-            //run metric on null matrix and add score to the stats vector
-            if (metric == "cscore"){
-                stats.push_back(trial.calc_c_score(nullmatrix, rowtotal, ncols, nrows));
-            }
-            else if (metric == "checker") {
-                stats.push_back(trial.calc_checker(nullmatrix, rowtotal, ncols, nrows));
-            }
-            else if (metric == "vratio") {
-                stats.push_back(trial.calc_vratio(nrows, ncols, rowtotal, columntotal));
-            }
-            else if (metric == "combo") {
-                stats.push_back(trial.calc_combo(nrows, ncols, nullmatrix));
-            }
-            else {
-                m->mothurOut("[ERROR]: No metric selected!\n\n"); m->setControl_pressed(true);
-                return 1;
-            }
-            
-        }
-        
+        vector<double> stats;
+        createProcesses(co_matrix, rowtotal, columntotal, probabilityMatrix, stats);
         
+        if (m->getControl_pressed()) { return 0; }
         
         double total = 0.0;
         for (int i=0; i<stats.size();i++) { total+=stats[i]; }
@@ -571,5 +446,187 @@ int CooccurrenceCommand::getCooccurrence(SharedRAbundVectors*& thisLookUp, ofstr
     }
 }
 //**********************************************************************************************************************
-
-
+//fills nullmatrix from the model. The cumulative probabilities are searched for the first cell at or above the random number.
+int generateNullMatrix(cooccurrenceData* params, PresenceMatrix& nullmatrix, vector<int>& columns, mt19937_64& engine) {
+    try {
+        int nrows = nullmatrix.getNumRows(); int ncols = nullmatrix.getNumCols();
+        vector<double>& probabilityMatrix = *(params->probabilityMatrix);
+        vector<double>::iterator first = probabilityMatrix.begin();
+        uniform_real_distribution<double> dis(0, 1);
+        
+        nullmatrix.clear();
+        
+        if(params->matrix == "sim1" || params->matrix == "sim6" || params->matrix == "sim8" || params->matrix == "sim7") {
+            int count = 0;
+            while(count < params->n) {
+                if (params->m->getControl_pressed()) { return 0; }
+                
+                long long cell = lower_bound(first, probabilityMatrix.end(), dis(engine)) - first;
+                if (cell < probabilityMatrix.size()) {
+                    nullmatrix.set(cell / ncols, cell % ncols);
+                    count++;
+                }
+            }
+        }
+        
+        //shuffle the rows, only the first rowtotal columns of each shuffle are needed
+        else if (params->matrix == "sim2") {
+            for(int i=0;i<nrows;i++) {
+                for (int j = 0; j < (*params->rowtotal)[i]; j++) {
+                    uniform_int_distribution<int> pick(j, ncols-1);
+                    swap(columns[j], columns[pick(engine)]);
+                    nullmatrix.set(i, columns[j]);
+                }
+            }
+        }
+        
+        else if(params->matrix == "sim4") {
+            for(int i=0;i<nrows;i++) {
+                vector<double>::iterator rowStart = first + (long long)ncols * i;
+                int count = 0;
+                while(count < (*params->rowtotal)[i]) {
+                    if (params->m->getControl_pressed()) { return 0; }
+                    
+                    int j = lower_bound(rowStart, rowStart + ncols, dis(engine)) - rowStart;
+                    if ((j < ncols) && !nullmatrix.get(i, j)) {
+                        nullmatrix.set(i, j);
+                        count++;
+                    }
+                }
+            }
+        }
+        
+        else if(params->matrix == "sim3" || params->matrix == "sim5") {
+            //columns
+            for(int j=0;j<ncols;j++) {
+                vector<double>::iterator colStart = first + (long long)nrows * j;
+                int count = 0;
+                while(count < (*params->columntotal)[j]) {
+                    if (params->m->getControl_pressed()) { return 0; }
+                    
+                    int i = lower_bound(colStart, colStart + nrows, dis(engine)) - colStart;
+                    if ((i < nrows) && !nullmatrix.get(i, j)) {
+                        nullmatrix.set(i, j);
+                        count++;
+                    }
+                }
+            }
+        }
+        else {
+            params->m->mothurOut("[ERROR]: No null model selected!\n\n"); params->m->setControl_pressed(true);
+            return 1;
+        }
+        
+        return 0;
+    }
+    catch(exception& e) {
+        params->m->errorOut(e, "CooccurrenceCommand", "generateNullMatrix");
+        exit(1);
+    }
+}
+//**********************************************************************************************************************
+void driverCooccurrence(cooccurrenceData* params) {
+    try {
+        TrialSwap2 trial;
+        int nrows = params->co_matrix->getNumRows(); int ncols = params->co_matrix->getNumCols();
+        
+        PresenceMatrix nullmatrix(nrows, ncols);
+        vector<int> columns; for (int j = 0; j < ncols; j++) { columns.push_back(j); }
+        
+        for (int c = params->start; c < params->end; c++) {
+            
+            cooccurrenceChain& chain = (*params->chains)[c];
+            mt19937_64 engine(chain.seed);
+            
+            //swap_checkerboards takes the original matrix and swaps checkerboards, burn-in for sim9
+            SwapChain* swapChain = NULL;
+            if (params->matrix == "sim9") {
+                swapChain = new SwapChain(*(params->co_matrix), *(params->rowtotal), engine());
+                swapChain->swap_checkerboards(10000*1000);
+            }
+            
+            for (int k = chain.start; k < (chain.start+chain.runs); k++) {
+                
+                if (params->m->getControl_pressed()) { break; }
+                
+                PresenceMatrix* thisMatrix = &nullmatrix;
+                if (swapChain != NULL)  {   swapChain->swap_checkerboards(1000); thisMatrix = &(swapChain->getMatrix());    }
+                else                    {   generateNullMatrix(params, nullmatrix, columns, engine);                          }
+                
+                //run metric on null matrix, the chain keeps its c-score and checker as it swaps
+                double score = 0.0;
+                if (params->metric == "cscore")         {
+                    if (swapChain != NULL)  { score = swapChain->getCScore();                                  }
+                    else                    { score = trial.calc_c_score(*thisMatrix, *(params->rowtotal));    }
+                }else if (params->metric == "checker")  {
+                    if (swapChain != NULL)  { score = swapChain->getChecker();                                 }
+                    else                    { score = trial.calc_checker(*thisMatrix);                         }
+                }else if (params->metric == "vratio")   { score = trial.calc_vratio(nrows, ncols, *(params->rowtotal), *(params->columntotal)); }
+                else if (params->metric == "combo")     { score = trial.calc_combo(*thisMatrix); }
+                
+                (*params->stats)[k] = score;
+            }
+            
+            delete swapChain;
+            
+            if (params->m->getControl_pressed()) { break; }
+        }
+    }
+    catch(exception& e) {
+        params->m->errorOut(e, "CooccurrenceCommand", "driverCooccurrence");
+        exit(1);
+    }
+}
+//**********************************************************************************************************************
+//each chain gets its own seed, drawn in chain order, so the null matrices do not depend on the number of processors
+int CooccurrenceCommand::createProcesses(PresenceMatrix& co_matrix, vector<int>& rowtotal, vector<int>& columntotal, vector<double>& probabilityMatrix, vector<double>& stats) {
+    try {
+        vector<cooccurrenceChain> chains;
+        for (int k = 0; k < runs; k += COOCCURRENCE_CHAIN_RUNS) {
+            chains.push_back(cooccurrenceChain((unsigned long long)util.getRandomNumber(), k, min(COOCCURRENCE_CHAIN_RUNS, runs-k)));
+        }
+        stats.assign(runs, 0.0);
+        
+        int n = accumulate(columntotal.begin(), columntotal.end(), 0);
+        
+        int numChains = chains.size();
+        int numProcs = processors;
+        if (numChains < numProcs) { numProcs = numChains; }
+        if (numProcs < 1) { return 0; }
+        
+        vector<linePair> lines;
+        int start = 0;
+        for (int p = 0; p < numProcs; p++) {
+            int num = (numChains - p + numProcs - 1) / numProcs;
+            lines.push_back(linePair(start, start+num));
+            start += num;
+        }
+        
+        vector<thread*> workerThreads;
+        vector<cooccurrenceData*> data;
+        
+        //Lauch worker threads
+        for (int i = 0; i < numProcs-1; i++) {
+            cooccurrenceData* dataBundle = new cooccurrenceData(&co_matrix, &rowtotal, &columntotal, &probabilityMatrix, &chains, &stats, metric, matrix, lines[i+1].start, lines[i+1].end, n);
+            data.push_back(dataBundle);
+            workerThreads.push_back(new thread(driverCooccurrence, dataBundle));
+        }
+        
+        cooccurrenceData* dataBundle = new cooccurrenceData(&co_matrix, &rowtotal, &columntotal, &probabilityMatrix, &chains, &stats, metric, matrix, lines[0].start, lines[0].end, n);
+        driverCooccurrence(dataBundle);
+        delete dataBundle;
+        
+        for (int i = 0; i < workerThreads.size(); i++) {
+            workerThreads[i]->join();
+            delete data[i];
+            delete workerThreads[i];
+        }
+        
+        return 0;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "CooccurrenceCommand", "createProcesses");
+        exit(1);
+    }
+}
+//**********************************************************************************************************************
@@ -15,7 +15,17 @@
 #include "trialswap2.h"
 #include "inputdata.h"
 
+#define COOCCURRENCE_CHAIN_RUNS 100  //null matrices generated from one seed, for sim9 the runs taken from one chain of swaps
 
+/**************************************************************************************************/
+//the runs of one chain fill stats[start, start+runs)
+struct cooccurrenceChain {
+    unsigned long long seed;
+    int start, runs;
+    
+    cooccurrenceChain(unsigned long long s, int st, int r) : seed(s), start(st), runs(r) {}
+};
+/**************************************************************************************************/
 
 class CooccurrenceCommand : public Command {
 	
@@ -44,11 +54,41 @@ private:
     bool abort, allLines;
     set<string> labels;
     vector<string> outputNames, Groups;
-    int runs;
+    int runs, processors;
     
     int getCooccurrence(SharedRAbundVectors*&, ofstream&);
+    int createProcesses(PresenceMatrix&, vector<int>&, vector<int>&, vector<double>&, vector<double>&); //matrix, rowtotals, columntotals, probabilities, stats
 	
 };
+/**************************************************************************************************/
+struct cooccurrenceData {
+    PresenceMatrix* co_matrix;
+    vector<int>* rowtotal;
+    vector<int>* columntotal;
+    vector<double>* probabilityMatrix;
+    vector<cooccurrenceChain>* chains;
+    vector<double>* stats;
+    string metric, matrix;
+    int start, end, n;
+    MothurOut* m;
+    
+    cooccurrenceData(){}
+    cooccurrenceData(PresenceMatrix* co, vector<int>* rt, vector<int>* ct, vector<double>* pm, vector<cooccurrenceChain>* ch, vector<double>* st, string me, string ma, int s, int e, int nu) {
+        m = MothurOut::getInstance();
+        co_matrix = co;
+        rowtotal = rt;
+        columntotal = ct;
+        probabilityMatrix = pm;
+        chains = ch;
+        stats = st;
+        metric = me;
+        matrix = ma;
+        start = s;
+        end = e;
+        n = nu;
+    }
+};
+/**************************************************************************************************/
 
 #endif
 
@@ -153,17 +153,11 @@ DistanceCommand::DistanceCommand(string option) {
 			if (fastafile == "not found") { 				
 				fastafile = current->getFastaFile(); 
 				if (fastafile != "") { m->mothurOut("Using " + fastafile + " as input file for the fasta parameter."); m->mothurOutEndLine(); 
-					ifstream inFASTA;
-					util.openInputFile(fastafile, inFASTA);
-					alignDB = SequenceDB(inFASTA); 
-					inFASTA.close();
+					alignDB = SequenceDB(fastafile);
 				}else { 	m->mothurOut("You have no current fastafile and the fasta parameter is required."); m->mothurOutEndLine(); abort = true; }
 			}else if (fastafile == "not open") { abort = true; }	
 			else{
-				ifstream inFASTA;
-				util.openInputFile(fastafile, inFASTA);
-				alignDB = SequenceDB(inFASTA); 
-				inFASTA.close();
+				alignDB = SequenceDB(fastafile);
 				current->setFastaFile(fastafile);
 			}
 			
@@ -600,10 +594,7 @@ void DistanceCommand::createProcesses(string filename) {
         
         SequenceDB oldFastaDB;
         if (fitCalc) {
-            ifstream inFASTA;
-            util.openInputFile(oldfastafile, inFASTA);
-            oldFastaDB = SequenceDB(inFASTA);
-            inFASTA.close();
+            oldFastaDB = SequenceDB(oldfastafile);
             
             lines.clear();
             if (processors > oldFastaDB.getNumSeqs()) { processors = oldFastaDB.getNumSeqs(); }
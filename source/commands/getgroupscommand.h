@@ -13,6 +13,7 @@
 
 #include "command.hpp"
 #include "groupmap.h"
+#include "nameset.hpp"
 
 class GetGroupsCommand : public Command {
     
@@ -41,7 +42,7 @@ public:
 	
 	
 private:
-	set<string> names;
+	NameSet names;
 	map<string, string> uniqueToRedundant; //if a namefile is given and the first column name is not selected
 										   //then the other files need to change the unique name in their file to match.
 										   //only add the names that need to be changed to keep the map search quick
@@ -442,30 +442,29 @@ int GetLineageCommand::readFasta(){
 		util.openOutputFile(outputFileName, out);
 		
 		
-		ifstream in;
-		util.openInputFile(fastafile, in);
+		SequenceReader in(fastafile);
+		TextSpan nameSpan, commentSpan, sequence;
 		string name;
 		
 		bool wroteSomething = false;
 		
-		while(!in.eof()){
-		
-			if (m->getControl_pressed()) { in.close(); out.close(); util.mothurRemove(outputFileName);  return 0; }
+		while(in.readFasta(nameSpan, commentSpan, sequence)){
+			if (m->getControl_pressed()) { out.close();  util.mothurRemove(outputFileName);  return 0; }
 			
-			Sequence currSeq(in);
-			name = currSeq.getName();
+			//skip commented out sequences, only the sequences written are parsed
+			if ((nameSpan.length == 0) || (nameSpan.data[0] == '#')) { continue; }
 			
-			if (name != "") {
-				//if this name is in the accnos file
-				if (names.count(name) != 0) {
-					wroteSomething = true;
-					
-					currSeq.printSequence(out);
-				}
+			name.assign(nameSpan.data, nameSpan.length);
+			util.checkName(name);
+			
+			//if this name is in the accnos file
+			if (names.count(name) != 0) {
+				wroteSomething = true;
+				
+				Sequence currSeq(nameSpan, commentSpan, sequence);
+				currSeq.printSequence(out);
 			}
-			util.gobble(in);
 		}
-		in.close();	
 		out.close();
 		
 		if (wroteSomething == false) { m->mothurOut("Your file contains does not contain any sequences from " + taxons + "."); m->mothurOutEndLine();  }
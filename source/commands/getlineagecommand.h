@@ -13,6 +13,7 @@
 #include "command.hpp"
 #include "sharedrabundvectors.hpp"
 #include "listvector.hpp"
+#include "nameset.hpp"
 
 class GetLineageCommand : public Command {
 	
@@ -37,7 +38,7 @@ class GetLineageCommand : public Command {
 	
 	
 	private:
-		set<string> names;
+		NameSet names;
 		vector<string> outputNames, listOfTaxons;
 		string fastafile, namefile, groupfile, alignfile, countfile, listfile, taxfile, outputDir, taxons, sharedfile, constaxonomy, label;
 		bool abort, dups;
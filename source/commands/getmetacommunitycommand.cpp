@@ -24,6 +24,8 @@ vector<string> GetMetaCommunityCommand::setParameters(){
         CommandParameter pminpartitions("minpartitions", "Number", "", "5", "", "", "","",false,false,true); parameters.push_back(pminpartitions);
         CommandParameter pmaxpartitions("maxpartitions", "Number", "", "100", "", "", "","",false,false,true); parameters.push_back(pmaxpartitions);
         CommandParameter poptimizegap("optimizegap", "Number", "", "3", "", "", "","",false,false,true); parameters.push_back(poptimizegap);
+        CommandParameter prestarts("restarts", "Number", "", "1", "", "", "","",false,false); parameters.push_back(prestarts);
+        CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
    		CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
@@ -42,7 +44,7 @@ vector<string> GetMetaCommunityCommand::setParameters(){
 string GetMetaCommunityCommand::getHelpString(){
 	try {
 		string helpString = "";
-		helpString += "The get.communitytype command parameters are shared, method, label, groups, minpartitions, maxpartitions, optimizegap and processors. The shared file is required. \n";
+		helpString += "The get.communitytype command parameters are shared, method, label, groups, minpartitions, maxpartitions, optimizegap, restarts and processors. The shared file is required. \n";
         helpString += "The label parameter is used to analyze specific labels in your input. labels are separated by dashes.\n";
 		helpString += "The groups parameter allows you to specify which of the groups in your shared file you would like analyzed.  Group names are separated by dashes.\n";
         helpString += "The method parameter allows you to select the method you would like to use.  Options are dmm, kmeans and pam. Default=dmm.\n";
@@ -52,6 +54,8 @@ string GetMetaCommunityCommand::getHelpString(){
 		helpString += "The minpartitions parameter is used to .... Default=5.\n";
         helpString += "The maxpartitions parameter is used to .... Default=10.\n";
         helpString += "The optimizegap parameter is used to .... Default=3.\n";
+        helpString += "The restarts parameter allows you to set the number of random starts fit for each number of partitions with the dmm method. The fit with the lowest NLE is kept. Default=1.\n";
+        helpString += "The processors parameter allows you to specify the number of processors to use. The dmm method fits the restarts at the same time and splits each fit between the processors. Default=1.\n";
 		helpString += "The get.communitytype command should be in the following format: get.communitytype(shared=yourSharedFile).\n";
 		return helpString;
 	}
@@ -166,6 +170,13 @@ GetMetaCommunityCommand::GetMetaCommunityCommand(string option)  {
             temp = validParameter.valid(parameters, "optimizegap");          if (temp == "not found"){	temp = "3";	 }
 			util.mothurConvert(temp, optimizegap);
             
+            temp = validParameter.valid(parameters, "restarts");             if (temp == "not found"){	temp = "1";	 }
+			util.mothurConvert(temp, restarts);
+            if (restarts < 1) { m->mothurOut("[ERROR]: restarts must be at least 1.\n"); abort = true; }
+            
+            temp = validParameter.valid(parameters, "processors");	if (temp == "not found"){	temp = current->getProcessors();	}
+			processors = current->setProcessors(temp);
+            
             string groups = validParameter.valid(parameters, "groups");
 			if (groups == "not found") { groups = ""; }
 			else { util.splitAtDash(groups, Groups); if (Groups.size() != 0) { if (Groups[0]== "all") { Groups.clear(); } } }
@@ -331,17 +342,20 @@ int GetMetaCommunityCommand::createProcesses(SharedRAbundVectors*& thislookup){
 		string outputFileName = getOutputFileName("fit", variables);
         outputNames.push_back(outputFileName); outputTypes["fit"].push_back(outputFileName);
                 
-		//divide the partitions between the processors
-		vector< vector<int> > dividedPartitions;
-        vector< vector<string> > rels, matrix;
-        vector<string> doneFlags;
-        dividedPartitions.resize(1);
-        rels.resize(1);
-        matrix.resize(1);
+		//the partitions are fit in order so the search can stop optimizegap partitions past the best one, the processors are used within each fit
+		vector<int> partitions;
+        vector<string> rels, matrix;
+        for (int i=1; i<=maxpartitions; i++) {
+            partitions.push_back(i);
+            variables["[tag]"] = toString(i);
+            rels.push_back(getOutputFileName("relabund", variables));
+            matrix.push_back(getOutputFileName("matrix", variables));
+        }
+        variables.erase("[tag]");
         int minPartition = 0;
         
         m->mothurOut("K\tNLE\t\tlogDet\tBIC\t\tAIC\t\tLaplace\n");
-		minPartition = processDriver(thislookup, dividedPartitions[0], outputFileName, rels[0], matrix[0], doneFlags, 0);
+		minPartition = processDriver(thislookup, partitions, outputFileName, rels, matrix);
         
         if (m->getControl_pressed()) { return 0; }
         
@@ -360,7 +374,7 @@ int GetMetaCommunityCommand::createProcesses(SharedRAbundVectors*& thislookup){
 	}
 }
 //**********************************************************************************************************************
-int GetMetaCommunityCommand::processDriver(SharedRAbundVectors*& thislookup, vector<int>& parts, string outputFileName, vector<string> relabunds, vector<string> matrix, vector<string> doneFlags, int processID){
+int GetMetaCommunityCommand::processDriver(SharedRAbundVectors*& thislookup, vector<int>& parts, string outputFileName, vector<string> relabunds, vector<string> matrix){
 	try {
         
         double minLaplace = 1e10;
@@ -416,25 +430,13 @@ int GetMetaCommunityCommand::processDriver(SharedRAbundVectors*& thislookup, vec
             
             if (m->getControl_pressed()) { break; }
             
-            //check to see if anyone else is done
-            for (int j = 0; j < doneFlags.size(); j++) {
-                if (!util.isBlank(doneFlags[j])) { //another process has finished
-                    //are they done at a lower partition?
-                    ifstream in;
-                    util.openInputFile(doneFlags[j], in);
-                    int tempNum;
-                    in >> tempNum; in.close();
-                    if (tempNum < numPartitions) { break; } //quit, because someone else has finished
-                }
-            }
-            
             CommunityTypeFinder* finder = NULL;
-            if (method == "dmm")            {   finder = new qFinderDMM(sharedMatrix, numPartitions);   }
+            if (method == "dmm")            {   finder = new qFinderDMM(sharedMatrix, numPartitions, processors, restarts);   }
             else if (method == "kmeans")    {   finder = new KMeans(sharedMatrix, numPartitions);       }
             else if (method == "pam")       {   finder = new Pam(sharedMatrix, dists, numPartitions);                 }
             else {
                 if (i == 0) {  m->mothurOut(method + " is not a valid method option. I will run the command using dmm.\n"); }
-                finder = new qFinderDMM(sharedMatrix, numPartitions);
+                finder = new qFinderDMM(sharedMatrix, numPartitions, processors, restarts);
             }
             
             string relabund = relabunds[i];
@@ -477,14 +479,7 @@ int GetMetaCommunityCommand::processDriver(SharedRAbundVectors*& thislookup, vec
             }
             delete finder;
             
-            if(optimizegap != -1 && (numPartitions - minPartition) >= optimizegap && numPartitions >= minpartitions){
-                string tempDoneFile = util.getRootName(util.getSimpleName(sharedfile)) + toString(processID) + ".done.temp";
-                ofstream outDone;
-                util.openOutputFile(tempDoneFile, outDone);
-                outDone << minPartition << endl;
-                outDone.close();
-                break;
-            }
+            if(optimizegap != -1 && (numPartitions - minPartition) >= optimizegap && numPartitions >= minpartitions){ break; }
         }
         if (method == "dmm") { fitData.close(); }
         
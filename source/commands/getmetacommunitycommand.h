@@ -83,13 +83,13 @@ private:
     string outputDir;
     vector<string> outputNames;
     string sharedfile, method, calc;
-    int minpartitions, maxpartitions, optimizegap, iters, subsampleSize;
+    int minpartitions, maxpartitions, optimizegap, iters, subsampleSize, restarts, processors;
     vector<string> Groups, Estimators;
     set<string> labels;
     
     vector<vector<double> > generateDistanceMatrix(SharedRAbundVectors*& lookup);
     int driver(SharedRAbundVectors*& thisLookup, vector< vector<seqDist> >& calcDists, Calculator*);
-    int processDriver(SharedRAbundVectors*&, vector<int>&, string, vector<string>, vector<string>, vector<string>, int);
+    int processDriver(SharedRAbundVectors*&, vector<int>&, string, vector<string>, vector<string>);
     int createProcesses(SharedRAbundVectors*&);
     vector<double> generateDesignFile(int, map<string,string>);
     int generateSummaryFile(int, map<string,string>, vector<double>);
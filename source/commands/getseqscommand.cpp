@@ -9,6 +9,7 @@
 
 #include "getseqscommand.h"
 #include "sequence.hpp"
+#include "sequenceindex.hpp"
 #include "listvector.hpp"
 #include "counttable.h"
 #include "fastqread.h"
@@ -348,7 +349,7 @@ int GetSeqsCommand::execute(){
 		if (abort) { if (calledHelp) { return 0; }  return 2;	}
 		
 		//get names you want to keep
-		names = util.readAccnos(accnosfile);
+		util.readAccnos(accnosfile, names);
 		
 		if (m->getControl_pressed()) { return 0; }
         
@@ -500,8 +501,8 @@ int GetSeqsCommand::readFasta(){
 		ofstream out;
 		util.openOutputFile(outputFileName, out);
 		
-		ifstream in;
-		util.openInputFile(fastafile, in);
+		SequenceReader in(fastafile);
+		TextSpan nameSpan, commentSpan, sequence;
 		string name;
 		
 		bool wroteSomething = false;
@@ -509,40 +510,54 @@ int GetSeqsCommand::readFasta(){
         
         if (m->getDebug()) { set<string> temp; sanity["fasta"] = temp; }
 		
-        set<string> uniqueNames;
-		while(!in.eof()){
+        //unless names are being changed, only the records whose names hash like a name we want are read
+        SequenceIndex index(fastafile, '>', outputDir);
+        bool useIndex = (uniqueMap.size() == 0) && !in.isGZ() && (index.isValid() || (m->getIndexFiles() && index.build()));
+        if (index.isSaved()) { outputNames.push_back(index.getIndexFileName()); }
+        unordered_set<unsigned int> hashes;
+        if (useIndex) { for (int i = 0; i < names.size(); i++) { hashes.insert(SequenceIndex::hashName(names.getName(i))); } }
+        long long record = 0;
+        
+        NameSet uniqueNames;
+		while(true){
 		
-			if (m->getControl_pressed()) { in.close(); out.close(); util.mothurRemove(outputFileName);  return 0; }
+			if (m->getControl_pressed()) { out.close(); util.mothurRemove(outputFileName);  return 0; }
+			
+			if (useIndex) {
+				while ((record < index.getNumRecords()) && (hashes.count(index.getNameHash(record)) == 0)) { record++; }
+				if (record == index.getNumRecords()) { break; }
+				in.seek(index.getOffset(record)); record++;
+			}
+			
+			if (!in.readFasta(nameSpan, commentSpan, sequence)) { break; }
+			
+			//skip commented out sequences
+			if ((nameSpan.length == 0) || (nameSpan.data[0] == '#')) { continue; }
 			
-			Sequence currSeq(in);
-			name = currSeq.getName();
+			name.assign(nameSpan.data, nameSpan.length);
+			util.checkName(name);
             
             if (!dups) {//adjust name if needed
                 map<string, string>::iterator it = uniqueMap.find(name);
-                if (it != uniqueMap.end()) { currSeq.setName(it->second); }
+                if (it != uniqueMap.end()) { name = it->second; }
             }
-			
-            name = currSeq.getName();
             
-			if (name != "") {
-				//if this name is in the accnos file
-				if (names.count(name) != 0) {
-                    if (uniqueNames.count(name) == 0) { //this name hasn't been seen yet
-                        wroteSomething = true;
-					
-                        currSeq.printSequence(out);
-                        selectedCount++;
-                        uniqueNames.insert(name);
+			//if this name is in the accnos file, only the sequences selected are parsed
+			if (names.count(name) != 0) {
+                if (uniqueNames.insert(name)) { //this name hasn't been seen yet
+                    wroteSomething = true;
                     
-                        if (m->getDebug()) { sanity["fasta"].insert(name); }
-                    }else {
-                        m->mothurOut("[WARNING]: " + name + " is in your fasta file more than once.  Mothur requires sequence names to be unique. I will only add it once.\n");
-                    }
+                    Sequence currSeq(nameSpan, commentSpan, sequence);
+                    currSeq.setName(name);
+                    currSeq.printSequence(out);
+                    selectedCount++;
+                    
+                    if (m->getDebug()) { sanity["fasta"].insert(name); }
+                }else {
+                    m->mothurOut("[WARNING]: " + name + " is in your fasta file more than once.  Mothur requires sequence names to be unique. I will only add it once.\n");
                 }
-			}
-			util.gobble(in);
+            }
 		}
-		in.close();	
 		out.close();
 		
 		
@@ -668,21 +683,33 @@ int GetSeqsCommand::readCount(){
         out << headers << endl;
         string test = headers; vector<string> pieces = util.splitWhiteSpace(test);
         
+        //only the lines whose names hash like a name we want are read
+        SequenceIndex index(countfile, '\n', outputDir);
+        bool useIndex = index.isValid() || (m->getIndexFiles() && index.build());
+        if (index.isSaved()) { outputNames.push_back(index.getIndexFileName()); }
+        unordered_set<unsigned int> hashes;
+        if (useIndex) { for (int i = 0; i < names.size(); i++) { hashes.insert(SequenceIndex::hashName(names.getName(i))); } }
+        long long record = 0;
+        
         string name, rest; int thisTotal; rest = "";
-        set<string> uniqueNames;
+        NameSet uniqueNames;
         while (!in.eof()) {
             
             if (m->getControl_pressed()) { in.close();  out.close();  util.mothurRemove(outputFileName);  return 0; }
             
+            if (useIndex) {
+                while ((record < index.getNumRecords()) && (hashes.count(index.getNameHash(record)) == 0)) { record++; }
+                if (record == index.getNumRecords()) { break; }
+                in.clear(); in.seekg(index.getOffset(record)); record++;
+            }
+            
             in >> name; util.gobble(in); 
             in >> thisTotal; util.gobble(in);
             if (pieces.size() > 2) {  rest = util.getline(in); util.gobble(in);  }
             if (m->getDebug()) { m->mothurOut("[DEBUG]: " + name + '\t' + rest + "\n"); }
             
             if (names.count(name) != 0) {
-                if (uniqueNames.count(name) == 0) { //this name hasn't been seen yet
-                    uniqueNames.insert(name);
-
+                if (uniqueNames.insert(name)) { //this name hasn't been seen yet
                     out << name << '\t' << thisTotal << '\t' << rest << endl;
                     wroteSomething = true;
                     selectedCount+= thisTotal;
@@ -1265,7 +1292,7 @@ int GetSeqsCommand::compareAccnos(){
 		
 		set<string> namesAccnos2;
 		set<string> namesDups;
-		set<string> namesAccnos = names;
+		set<string> namesAccnos = names.getNames();
 		
 		map<string, int> nameCount;
 		
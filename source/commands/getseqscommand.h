@@ -11,6 +11,7 @@
  */
  
 #include "command.hpp"
+#include "nameset.hpp"
 
 class GetSeqsCommand : public Command {
 	
@@ -34,7 +35,7 @@ class GetSeqsCommand : public Command {
 	
 	
 	private:
-		set<string> names;
+		NameSet names;
 		vector<string> outputNames;
 		string accnosfile, accnosfile2, fastafile, fastqfile, namefile, countfile, groupfile, alignfile, listfile, taxfile, qualfile, outputDir, format;
 		bool abort, dups;
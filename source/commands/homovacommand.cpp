@@ -21,6 +21,8 @@ vector<string> HomovaCommand::setParameters(){
         CommandParameter psets("sets", "String", "", "", "", "", "","",false,false); parameters.push_back(psets);
 		CommandParameter piters("iters", "Number", "", "1000", "", "", "","",false,false); parameters.push_back(piters);
 		CommandParameter palpha("alpha", "Number", "", "0.05", "", "", "","",false,false); parameters.push_back(palpha);
+		CommandParameter pearlystop("earlystop", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(pearlystop);
+		CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
 		CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
@@ -40,11 +42,13 @@ string HomovaCommand::getHelpString(){
 		string helpString = "";
 		helpString += "Referenced: Stewart CN, Excoffier L (1996). Assessing population genetic structure and variability with RAPD data: Application to Vaccinium macrocarpon (American Cranberry). J Evol Biol 9: 153-71.\n";
 		helpString += "The homova command outputs a .homova file. \n";
-		helpString += "The homova command parameters are phylip, iters, sets and alpha.  The phylip and design parameters are required, unless valid current files exist.\n";
+		helpString += "The homova command parameters are phylip, iters, sets, alpha, earlystop and processors.  The phylip and design parameters are required, unless valid current files exist.\n";
 		helpString += "The design parameter allows you to assign your samples to groups when you are running homova. It is required. \n";
 		helpString += "The design file looks like the group file.  It is a 2 column tab delimited file, where the first column is the sample name and the second column is the group the sample belongs to.\n";
         helpString += "The sets parameter allows you to specify which of the sets in your designfile you would like to analyze. The set names are separated by dashes. THe default is all sets in the designfile.\n";
 		helpString += "The iters parameter allows you to set number of randomization for the P value.  The default is 1000. \n";
+		helpString += "The earlystop parameter allows you to stop the randomizations once the p-value can no longer fall below alpha. The p-value reported is then from the randomizations run. The default is false. \n";
+		helpString += "The processors parameter allows you to specify the number of processors to use for the randomizations. The default is all available. \n";
 		helpString += "The homova command should be in the following format: homova(phylip=file.dist, design=file.design).\n";
 		return helpString;
 	}
@@ -161,6 +165,12 @@ HomovaCommand::HomovaCommand(string option) {
 			temp = validParameter.valid(parameters, "alpha");
 			if (temp == "not found") { temp = "0.05"; }
 			util.mothurConvert(temp, experimentwiseAlpha); 
+
+			temp = validParameter.valid(parameters, "processors");	if (temp == "not found"){	temp = current->getProcessors();	}
+			processors = current->setProcessors(temp);
+			
+			temp = validParameter.valid(parameters, "earlystop");		if (temp == "not found"){	temp = "f";	}
+			earlyStop = util.isTrue(temp);
             
             string sets = validParameter.valid(parameters, "sets");			
 			if (sets == "not found") { sets = ""; }
@@ -291,15 +301,13 @@ double HomovaCommand::runHOMOVA(ofstream& HOMOVAFile, map<string, vector<int> >
 		vector<double> ssWithinOrigVector;
 		double bValueOrig = calcBValue(groupSampleMap, ssWithinOrigVector);
 		
-		double counter = 0;
-		for(int i=0;i<iters;i++){
-			vector<double> ssWithinRandVector;
-			map<string, vector<int> > randomizedGroup = getRandomizedGroups(groupSampleMap);
-			double bValueRand = calcBValue(randomizedGroup, ssWithinRandVector);
-			if(bValueRand >= bValueOrig){	counter++;	}
-		}
+		HomovaStatistic statistic(distanceMatrix, groupSampleMap);
+		vector<int> labels = statistic.getLabels();
 		
-		double pValue = (double) counter / (double) iters;
+		PermutationTest test(iters, processors);
+		if (earlyStop) { test.setEarlyStop(alpha); }
+		
+		double pValue = test.getPValue(&statistic, labels, statistic.getStatistic(labels), true);
 		string pString = "";
 		if(pValue < 1/(double)iters){	pString = '<' + toString(1/(double)iters);	}
 		else						{	pString = toString(pValue);					}
@@ -400,35 +408,33 @@ double HomovaCommand::calcBValue(map<string, vector<int> > groupSampleMap, vecto
 }
 //**********************************************************************************************************************
 
-map<string, vector<int> > HomovaCommand::getRandomizedGroups(map<string, vector<int> > origMapping){
-	try{
-		vector<int> sampleIndices;
-		vector<int> samplesPerGroup;
-		
-		for(map<string, vector<int> >::iterator it=origMapping.begin();it!=origMapping.end();it++){
-			vector<int> indices = it->second;
-			samplesPerGroup.push_back(indices.size());
-			sampleIndices.insert(sampleIndices.end(), indices.begin(), indices.end());
-		}
-		
-		util.mothurRandomShuffle(sampleIndices);
+double HomovaStatistic::getStatistic(const vector<int>& sampleLabels) {
+	try {
+		vector<double> within;
+		getWithinSums(sampleLabels, within);
 		
-		int index = 0;
-		map<string, vector<int> > randomizedGroups = origMapping;
-		for(map<string, vector<int> >::iterator it=randomizedGroups.begin();it!=randomizedGroups.end();it++){
-			for(int i=0;i<it->second.size();i++){
-				it->second[i] = sampleIndices[index++];				
-			}
+		double totalNumSamples = 0; double ssWithinFull = 0; double secondTermSum = 0; double inverseOneMinusSum = 0;
+		for (int i = 0; i < numGroups; i++) {
+			int numSamplesInGroup = groupSizes[i];
+			double ssWithin = within[i] / (double) numSamplesInGroup;
+			
+			totalNumSamples += numSamplesInGroup;
+			ssWithinFull += ssWithin;
+			secondTermSum += (numSamplesInGroup - 1) * log(ssWithin / (double)(numSamplesInGroup - 1));
+			inverseOneMinusSum += 1.0 / (double)(numSamplesInGroup - 1);
 		}
 		
-		return randomizedGroups;		
+		double B = (totalNumSamples - numGroups) * log(ssWithinFull/(totalNumSamples-numGroups)) - secondTermSum;
+		double denomintor = 1 + 1.0/(3.0 * (numGroups - 1.0)) * (inverseOneMinusSum - 1.0 / (double) (totalNumSamples - numGroups));
+		B /= denomintor;
+		
+		return B;
 	}
-	catch (exception& e) {
-		m->errorOut(e, "AmovaCommand", "randomizeGroups");
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "HomovaStatistic", "getStatistic");
 		exit(1);
 	}
 }
-
 //**********************************************************************************************************************
 
 
@@ -13,6 +13,7 @@
 
 #include "command.hpp"
 
+#include "permutationtest.h"
 class DesignMap;
 
 class HomovaCommand : public Command {
@@ -38,14 +39,25 @@ private:
 	double runHOMOVA(ofstream& , map<string, vector<int> >, double);
 	double calcSigleSSWithin(vector<int>);
 	double calcBValue(map<string, vector<int> >, vector<double>&);
-	map<string, vector<int> > getRandomizedGroups(map<string, vector<int> >);
 
 	bool abort;
 	vector<string> outputNames, Sets;
 	string outputDir, inputDir, designFileName, phylipFileName;
 	vector< vector<double> > distanceMatrix;
-	int iters;
+	int iters, processors;
 	double experimentwiseAlpha;
+	bool earlyStop;
 };
 
+/**************************************************************************************************/
+//Bartlett's B from the squared distances within each group, the homova randomization statistic
+class HomovaStatistic : public PermutationStatistic {
+	
+public:
+	HomovaStatistic(const vector< vector<double> >& matrix, map<string, vector<int> >& groupSampleMap) { setGroups(matrix, groupSampleMap); }
+	double getStatistic(const vector<int>&);
+};
+
+/**************************************************************************************************/
+
 #endif
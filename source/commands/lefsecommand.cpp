@@ -32,6 +32,7 @@ vector<string> LefseCommand::setParameters(){
         CommandParameter pstrict("strict", "Multiple", "0-1-2", "0", "", "", "","",false,false); parameters.push_back(pstrict);
         CommandParameter pminc("minc", "Number", "", "10", "", "", "","",false,false); parameters.push_back(pminc);
         CommandParameter pmulticlass_strat("multiclass", "Multiple", "onevone-onevall", "onevall", "", "", "","",false,false); parameters.push_back(pmulticlass_strat);
+        CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
         //CommandParameter psubject("subject", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(psubject);
 
 
@@ -60,7 +61,7 @@ string LefseCommand::getHelpString(){
 	try {
 		string helpString = "";
 		helpString += "The lefse command allows you to ....\n";
-		helpString += "The lefse command parameters are: shared, design, class, subclass, label, walpha, aalpha, lda, wilc, iters, curv, fboots, strict, minc, multiclass and norm.\n";
+		helpString += "The lefse command parameters are: shared, design, class, subclass, label, walpha, aalpha, lda, wilc, iters, curv, fboots, strict, minc, multiclass, processors and norm.\n";
 		helpString += "The class parameter is used to indicate the which category you would like used for the Kruskal Wallis analysis. If none is provided first category is used.\n";
         helpString += "The subclass parameter is used to indicate the .....If none is provided, second category is used, or if only one category subclass is ignored. \n";
         helpString += "The aalpha parameter is used to set the alpha value for the Krukal Wallis Anova test Default=0.05. \n";
@@ -68,6 +69,7 @@ string LefseCommand::getHelpString(){
         helpString += "The lda parameter is used to set the threshold on the absolute value of the logarithmic LDA score. Default=2.0. \n";
         helpString += "The wilc parameter is used to indicate whether to perform the Wilcoxon test. Default=T. \n";
         helpString += "The iters parameter is used to set the number of bootstrap iteration for LDA. Default=30. \n";
+        helpString += "The processors parameter allows you to specify the number of processors to use. The OTU tests and bootstrap iterations are divided among them. Default=1. \n";
         //helpString += "The wilcsamename parameter is used to indicate whether perform the wilcoxon test only among the subclasses with the same name. Default=F. \n";
         helpString += "The sets parameter allows you to specify which of the sets in your designfile you would like to analyze. The set names are separated by dashes. THe default is all sets in the designfile.\n";
         helpString += "The curv parameter is used to set whether perform the wilcoxon testing the Curtis's approach [BETA VERSION] Default=F. \n";
@@ -230,6 +232,9 @@ LefseCommand::LefseCommand(string option)  {
 			if (temp == "not found") { temp = "30"; }
 			util.mothurConvert(temp, iters);
             
+            temp = validParameter.valid(parameters, "processors");	if (temp == "not found"){	temp = current->getProcessors();	}
+			processors = current->setProcessors(temp);
+            
             temp = validParameter.valid(parameters, "fboots");
 			if (temp == "not found") { temp = "0.67"; }
 			util.mothurConvert(temp, fBoots);
@@ -484,39 +489,80 @@ int LefseCommand::normalize(SharedRAbundFloatVectors*& lookup) {
 	}
 }
 //**********************************************************************************************************************
+void driverLefseKruskalWallis(lefseTestData* params) {
+	try {
+        LinearAlgebra linear;
+        vector<spearmanRank> values;
+        
+        for (int k = params->start; k < params->end; k++) {
+            if (params->m->getControl_pressed()) { break; }
+            
+            int i = (*params->otus)[k];
+            vector<float>& abunds = (*params->abunds)[i];
+            
+            values.clear();
+            for (int j = 0; j < params->treatments.size(); j++) {
+                spearmanRank temp(params->treatments[j], abunds[j]);
+                values.push_back(temp);
+            }
+            
+            double pValue = 0.0;
+            linear.calcKruskalWallis(values, pValue);
+            
+            (*params->pvalues)[i] = pValue;
+        }
+    }
+	catch(exception& e) {
+		params->m->errorOut(e, "LefseCommand", "driverLefseKruskalWallis");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
 map<int, double> LefseCommand::runKruskalWallis(SharedRAbundFloatVectors*& lookup, DesignMap& designMap) {
 	try {        
         map<int, double> significantOtuLabels;
         int numBins = lookup->getNumBins();
         //sanity check to make sure each treatment has a group in the shared file
         set<string> treatments;
+        vector<string> groupTreatments;
         vector<string> namesOfGroups = lookup->getNamesGroups();
         for (int j = 0; j < namesOfGroups.size(); j++) {
             string group = namesOfGroups[j];
             string treatment = designMap.get(group, mclass); //get value for this group in this category
             treatments.insert(treatment);
+            groupTreatments.push_back(treatment);
+        }
+        if (treatments.size() < 2) { m->mothurOut("[ERROR]: need at least 2 things to classes to compare, quitting.\n"); m->setControl_pressed(true); return significantOtuLabels; }
+        
+        vector< vector<float> > abunds; vector<int> otus;
+        for (int i = 0; i < numBins; i++) { abunds.push_back(lookup->getOTU(i)); otus.push_back(i); }
+        vector<double> pvalues; pvalues.resize(numBins, 1.0);
+        
+        vector<linePair> lines = divideWork(numBins);
+        vector<thread*> workerThreads;
+        vector<lefseTestData*> data;
+        
+        //Lauch worker threads
+        for (int i = 1; i < lines.size(); i++) {
+            lefseTestData* dataBundle = new lefseTestData(&abunds, &otus, lines[i].start, lines[i].end);
+            dataBundle->treatments = groupTreatments; dataBundle->pvalues = &pvalues;
+            data.push_back(dataBundle);
+            workerThreads.push_back(new thread(driverLefseKruskalWallis, dataBundle));
         }
-        if (treatments.size() < 2) { m->mothurOut("[ERROR]: need at least 2 things to classes to compare, quitting.\n"); m->setControl_pressed(true); }
         
-        LinearAlgebra linear;
-        for (int i = 0; i < numBins; i++) {
-            if (m->getControl_pressed()) { break; }
-            
-            vector<spearmanRank> values;
-            vector<float> abunds = lookup->getOTU(i);
-            for (int j = 0; j < namesOfGroups.size(); j++) {
-                string group = namesOfGroups[j];
-                string treatment = designMap.get(group, mclass); //get value for this group in this category
-                spearmanRank temp(treatment, abunds[j]);
-                values.push_back(temp);
-            }
-            
-            double pValue = 0.0;
-            linear.calcKruskalWallis(values, pValue);
-             
-            if (pValue < anovaAlpha) {  significantOtuLabels[i] = pValue;  }
+        lefseTestData* dataBundle = new lefseTestData(&abunds, &otus, lines[0].start, lines[0].end);
+        dataBundle->treatments = groupTreatments; dataBundle->pvalues = &pvalues;
+        driverLefseKruskalWallis(dataBundle);
+        delete dataBundle;
+        
+        for (int i = 0; i < workerThreads.size(); i++) {
+            workerThreads[i]->join();
+            delete data[i];
+            delete workerThreads[i];
         }
         
+        for (int i = 0; i < numBins; i++) { if (pvalues[i] < anovaAlpha) {  significantOtuLabels[i] = pvalues[i];  } }
+        
         return significantOtuLabels;
     }
 	catch(exception& e) {
@@ -525,45 +571,15 @@ map<int, double> LefseCommand::runKruskalWallis(SharedRAbundFloatVectors*& looku
 	}
 }
 //**********************************************************************************************************************
-//assumes not neccessarily paired
-map<int, double> LefseCommand::runWilcoxon(SharedRAbundFloatVectors*& lookup, DesignMap& designMap, map<int, double> bins, map<string, set<string> >& class2SubClasses, map<string, vector<int> >& subClass2GroupIndex, map<string, string> subclass2Class) {
-    try {
-        map<int, double> significantOtuLabels;
-        map<int, double>::iterator it;
-        //if it exists and meets the following requirements run Wilcoxon
-        /*
-         1. Subclass members all belong to same main class
-         anything else
-        */
-        
-        int numBins = lookup->getNumBins();
-        for (int i = 0; i < numBins; i++) {
-            if (m->getControl_pressed()) { break; }
-            
-            it = bins.find(i);
-            if (it != bins.end()) { //flagged in Kruskal Wallis
-                
-                vector<float> abunds = lookup->getOTU(i);
-                
-                bool sig = testOTUWilcoxon(class2SubClasses, abunds, subClass2GroupIndex, subclass2Class);
-                if (sig) { significantOtuLabels[i] = it->second;  }
-                
-            }//bins flagged from kw
-        }//for bins
-        
-        return significantOtuLabels;
-    }
-    catch(exception& e) {
-        m->errorOut(e, "LefseCommand", "runWilcoxon");
-        exit(1);
-    }
-}
-//**********************************************************************************************************************
 //lefse.py - test_rep_wilcoxon_r function
-bool LefseCommand::testOTUWilcoxon(map<string, set<string> >& class2SubClasses, vector<float> abunds, map<string, vector<int> >& subClass2GroupIndex, map<string, string> subclass2Class) {
+bool testOTUWilcoxon(lefseTestData* params, vector<float>& abunds) {
     try {
+        map<string, set<string> >& class2SubClasses = params->class2SubClasses;
+        map<string, vector<int> >& subClass2GroupIndex = params->subClass2GroupIndex;
+        map<string, string>& subclass2Class = params->subclass2Class;
+        
         int totalOk = 0;
-        double alphaMtc = wilcoxonAlpha;
+        double alphaMtc = params->wilcoxonAlpha;
         vector< set<string> > allDiffs;
         LinearAlgebra linear;
         
@@ -572,7 +588,7 @@ bool LefseCommand::testOTUWilcoxon(map<string, set<string> >& class2SubClasses,
         for(map<string, set<string> >::iterator it=class2SubClasses.begin();it!=class2SubClasses.end();it++){
             itB = it;itB++;
             for(itB;itB!=class2SubClasses.end();itB++){
-                if (m->getControl_pressed()) { return false; }
+                if (params->m->getControl_pressed()) { return false; }
                 bool first = true;
                 int dirCmp = 0; // not set?? dir_cmp = "not_set" # 0=notset or none, 1=true, 2=false.
                 int curv_sign = 0;
@@ -585,7 +601,7 @@ bool LefseCommand::testOTUWilcoxon(map<string, set<string> >& class2SubClasses,
                         string subclass2 = *itClass2;
                         count++;
                         
-                        if (m->getDebug()) { m->mothurOut( "[DEBUG comparing " + it->first + "-" + *itClass1 + " to " + itB->first + "-" + *itClass2 + "\n"); }
+                        if (params->m->getDebug()) { params->m->mothurOut( "[DEBUG comparing " + it->first + "-" + *itClass1 + " to " + itB->first + "-" + *itClass2 + "\n"); }
                         
                         string treatment1 = subclass2Class[subclass1];
                         string treatment2 = subclass2Class[subclass2];
@@ -593,8 +609,8 @@ bool LefseCommand::testOTUWilcoxon(map<string, set<string> >& class2SubClasses,
                         int numSubs2 = class2SubClasses[treatment2].size();
                         
                         //if mul_cor != 0: alpha_mtc = th*l_subcl1*l_subcl2 if mul_cor == 2 else 1.0-math.pow(1.0-th,l_subcl1*l_subcl2)
-                        if (strict != 0) { alphaMtc = wilcoxonAlpha * numSubs1 * numSubs2 ; }
-                        if (strict == 2) {}else{ alphaMtc = 1.0-pow((1.0-wilcoxonAlpha),(double)(numSubs1 * numSubs2)); }
+                        if (params->strict != 0) { alphaMtc = params->wilcoxonAlpha * numSubs1 * numSubs2 ; }
+                        if (params->strict == 2) {}else{ alphaMtc = 1.0-pow((1.0-params->wilcoxonAlpha),(double)(numSubs1 * numSubs2)); }
                         
                         //fill x and y with this comparisons data
                         vector<double> x; vector<double> y;
@@ -609,10 +625,10 @@ bool LefseCommand::testOTUWilcoxon(map<string, set<string> >& class2SubClasses,
                         //if len(cl1) < min_c or len(cl2) < min_c:
                         //med_comp = True
                         bool medComp = false; // are there enough samples per subclass
-                        if ((xIndexes.size() < minC) || (yIndexes.size() < minC)) { medComp = true; }
+                        if ((xIndexes.size() < params->minC) || (yIndexes.size() < params->minC)) { medComp = true; }
                         
-                        double sx = util.median(x);
-                        double sy = util.median(y);
+                        double sx = params->util.median(x);
+                        double sy = params->util.median(y);
                        
                         //if cl1[0] == cl2[0] and len(set(cl1)) == 1 and  len(set(cl2)) == 1:
                         //tres, first = False, False
@@ -652,19 +668,19 @@ bool LefseCommand::testOTUWilcoxon(map<string, set<string> >& class2SubClasses,
                         
                         if (first) {
                             first = false;
-                            if ((!curv) && (medComp || tres)) {
+                            if ((!params->curv) && (medComp || tres)) {
                                 dirCmp = 2; if (sx<sy) { dirCmp = 1; } //dir_cmp = sx < sy
                                 if (sx == sy) { br = true; }
-                            }else if (curv) {
+                            }else if (params->curv) {
                                 dirCmp = 0;
                                 if (medComp || tres) {
                                     curv_sign++;
                                     dirCmp = 2; if (sx<sy) { dirCmp = 1; } //dir_cmp = sx < sy
                                 }
                             }else { br = true; }
-                        }else if (!curv && medComp) {
+                        }else if (!params->curv && medComp) {
                             if (sxSy != dirCmp || sx == sy) { br = true; }
-                        }else if (curv) {
+                        }else if (params->curv) {
                             if (tres && dirCmp == 0) { curv_sign++; }
                             dirCmp = 2; if (sx<sy) { dirCmp = 1; } //dir_cmp = sx < sy
                             if (tres && dirCmp != sxSy) { //if tres and dir_cmp != (sx < sy):
@@ -678,24 +694,24 @@ bool LefseCommand::testOTUWilcoxon(map<string, set<string> >& class2SubClasses,
                     if (br) { break; }
                 }//for class1 subclasses
                 bool diff = false;
-                if (curv) { diff = false; if (curv_sign > 0) { diff = true; } } //if curv: diff = curv_sign > 0
+                if (params->curv) { diff = false; if (curv_sign > 0) { diff = true; } } //if curv: diff = curv_sign > 0
                 else { //else: diff = (ok == len(cl_hie[pair[1]])*len(cl_hie[pair[0]]))
                     diff = false;
                     if (ok == count) { diff = true; }
                 }
                 if (diff) { totalOk++; }
-                if (!diff && (multiClassStrat == "onevone")) { return false; }
-                if (diff && (multiClassStrat == "onevall")) { //all_diff.append(pair)
+                if (!diff && (params->multiClassStrat == "onevone")) { return false; }
+                if (diff && (params->multiClassStrat == "onevall")) { //all_diff.append(pair)
                     set<string> pair; pair.insert(it->first); pair.insert(itB->first);
                     allDiffs.push_back(pair);
                 }
             }//classes
         }//classes
         
-        if (multiClassStrat == "onevall") {
+        if (params->multiClassStrat == "onevall") {
             int tot_k = class2SubClasses.size();
             for(map<string, set<string> >::iterator it=class2SubClasses.begin();it!=class2SubClasses.end();it++){
-                if (m->getControl_pressed()) { return false; }
+                if (params->m->getControl_pressed()) { return false; }
                 int nk = 0;
                 //is this class okay in all comparisons
                 for (int h = 0; h < allDiffs.size(); h++) {
@@ -709,11 +725,234 @@ bool LefseCommand::testOTUWilcoxon(map<string, set<string> >& class2SubClasses,
         return true;
     }
     catch(exception& e) {
-        m->errorOut(e, "LefseCommand", "testOTUWilcoxon");
+        params->m->errorOut(e, "LefseCommand", "testOTUWilcoxon");
+        exit(1);
+    }
+}
+//**********************************************************************************************************************
+void driverLefseWilcoxon(lefseTestData* params) {
+	try {
+        for (int k = params->start; k < params->end; k++) {
+            if (params->m->getControl_pressed()) { break; }
+            
+            int i = (*params->otus)[k];
+            if (testOTUWilcoxon(params, (*params->abunds)[i])) { (*params->sig)[i] = 1; }
+        }
+    }
+	catch(exception& e) {
+		params->m->errorOut(e, "LefseCommand", "driverLefseWilcoxon");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
+//assumes not neccessarily paired
+map<int, double> LefseCommand::runWilcoxon(SharedRAbundFloatVectors*& lookup, DesignMap& designMap, map<int, double> bins, map<string, set<string> >& class2SubClasses, map<string, vector<int> >& subClass2GroupIndex, map<string, string> subclass2Class) {
+    try {
+        map<int, double> significantOtuLabels;
+        map<int, double>::iterator it;
+        //if it exists and meets the following requirements run Wilcoxon
+        /*
+         1. Subclass members all belong to same main class
+         anything else
+        */
+        
+        //only the otus flagged in Kruskal Wallis are tested
+        int numBins = lookup->getNumBins();
+        vector< vector<float> > abunds; abunds.resize(numBins);
+        vector<int> otus;
+        for (it = bins.begin(); it != bins.end(); it++) { abunds[it->first] = lookup->getOTU(it->first); otus.push_back(it->first); }
+        vector<int> sig; sig.resize(numBins, 0);
+        
+        vector<linePair> lines = divideWork(otus.size());
+        vector<thread*> workerThreads;
+        vector<lefseTestData*> data;
+        
+        for (int i = 0; i < lines.size(); i++) {
+            lefseTestData* dataBundle = new lefseTestData(&abunds, &otus, lines[i].start, lines[i].end);
+            dataBundle->sig = &sig;
+            dataBundle->class2SubClasses = class2SubClasses;
+            dataBundle->subClass2GroupIndex = subClass2GroupIndex;
+            dataBundle->subclass2Class = subclass2Class;
+            dataBundle->wilcoxonAlpha = wilcoxonAlpha;
+            dataBundle->strict = strict;
+            dataBundle->minC = minC;
+            dataBundle->curv = curv;
+            dataBundle->multiClassStrat = multiClassStrat;
+            data.push_back(dataBundle);
+        }
+        
+        //Lauch worker threads
+        for (int i = 1; i < data.size(); i++) { workerThreads.push_back(new thread(driverLefseWilcoxon, data[i])); }
+        
+        driverLefseWilcoxon(data[0]);
+        
+        for (int i = 0; i < workerThreads.size(); i++) {
+            workerThreads[i]->join();
+            delete workerThreads[i];
+        }
+        for (int i = 0; i < data.size(); i++) { delete data[i]; }
+        
+        for (it = bins.begin(); it != bins.end(); it++) { if (sig[it->first] == 1) { significantOtuLabels[it->first] = it->second; } }
+        
+        return significantOtuLabels;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "LefseCommand", "runWilcoxon");
         exit(1);
     }
 }
 //**********************************************************************************************************************
+//modelled after lefse.py contast_within_classes_or_few_per_class function
+bool contastWithinClassesOrFewPerClass(vector< vector<double> >& lookup, vector<int>& rands, int minCl, vector<int>& groupClass, int numClasses, vector<double>& values) {
+    try {
+        MothurOut* m = MothurOut::getInstance();
+        
+        //count the classes represented in the random selection
+        vector<int> cls; cls.resize(numClasses, 0);
+        for (int i = 0; i < rands.size(); i++) { cls[groupClass[rands[i]]]++; }
+        
+        for (int c = 0; c < numClasses; c++) {
+            if (cls[c] == 0) { return true; } //some classes are not present in sampling
+            if (cls[c] < minCl) { return true; } //this sampling has class count below minimum
+        }
+        
+        //for this otu
+        int numBins = lookup.size();
+        for (int i = 0; i < numBins; i++) {
+            if (m->getControl_pressed()) { break; }
+                
+            //break up random sampling by class, are the unique values less than we want
+            //if (len(set(col)) <= min_cl and min_cl > 1) or (min_cl == 1 and len(set(col)) <= 1):
+            for (int c = 0; c < numClasses; c++) {
+                values.clear();
+                for (int j = 0; j < rands.size(); j++) { if (groupClass[rands[j]] == c) { values.push_back(lookup[i][rands[j]]); } }
+                sort(values.begin(), values.end());
+                int numUnique = unique(values.begin(), values.end()) - values.begin();
+                
+                if ((numUnique <= minCl && minCl > 1) || (minCl == 1 && numUnique <= 1)) {  return true; }
+            }
+        }
+        
+        return false;
+    }
+    catch(exception& e) {
+        MothurOut::getInstance()->errorOut(e, "LefseCommand", "contastWithinClassesOrFewPerClass");
+        exit(1);
+    }
+}
+//**********************************************************************************************************************
+//a is scratch space for the sampled abundances [numOTUs][numSampled]
+vector< vector<double> > lefseLDA(vector< vector<double> >& adjustedLookup, vector<int>& rand_s, vector<int>& groupClass, vector<string>& classes, vector< vector<double> >& a) {
+    try {
+        MothurOut* m = MothurOut::getInstance();
+        
+        vector<string> randClass; //classes for rand sample
+        vector<int> counts; counts.resize(classes.size(), 0);
+        for (int i = 0; i < rand_s.size(); i++) {
+            int thisClass = groupClass[rand_s[i]];
+            randClass.push_back(classes[thisClass]);
+            counts[thisClass]++;
+        }
+
+        a.resize(adjustedLookup.size()); //[numOTUs][numSampled]
+        for (int i = 0; i < adjustedLookup.size(); i++) {
+            a[i].resize(rand_s.size());
+            for (int j = 0; j < rand_s.size(); j++) { a[i][j] = adjustedLookup[i][rand_s[j]]; }
+        }
+        
+        LinearAlgebra linear;
+        vector< vector<double> > means; bool ignore;
+        vector< vector<double> > scaling = linear.lda(a, randClass, means, ignore); //means are returned sorted, classes are sorted as well since they come from a map. means[class][otu] =
+        if (ignore) { scaling.clear(); return scaling; }
+        if (m->getControl_pressed()) { return scaling; }
+        
+        vector<double> w; w.resize(a.size(), 0.0); //w.unit <- w/sqrt(sum(w^2))
+        double denom = 0.0;
+        for (int i = 0; i < scaling.size(); i++) { w[i] = scaling[i][0]; denom += (w[i]*w[i]); }
+        denom = sqrt(denom);
+        for (int i = 0; i < w.size(); i++) {  w[i] /= denom;  } //[numOTUs] - w.unit
+        
+        //robjects.r('LD <- xy.matrix%*%w.unit') [numSampled][numOtus] * [numOTUs][1]
+        vector<double> LD; LD.resize(rand_s.size(), 0.0);
+        for (int i = 0; i < a.size(); i++) {
+            for (int j = 0; j < rand_s.size(); j++) { LD[j] += a[i][j] * w[i]; }
+        }
+        
+        //find means for each groups LDs
+        vector<double> LDMeans; LDMeans.resize(classes.size(), 0.0); //means[0] -> average for [group0].
+        for (int i = 0; i < LD.size(); i++) {  LDMeans[groupClass[rand_s[i]]] += LD[i]; } 
+        for (int i = 0; i < LDMeans.size(); i++) { LDMeans[i] /= (double) counts[i];  }
+   
+		//calculate for each comparisons i.e. with groups A,B,C = AB, AC, BC = 3;
+        vector< vector<double> > results;// [numComparison][numOTUs]
+		for (int i = 0; i < LDMeans.size(); i++) {
+			for (int l = 0; l < i; l++) {
+                
+                if (m->getControl_pressed()) { return scaling; }
+                //robjects.r('effect.size <- abs(mean(LD[sub_d[,"class"]=="'+p[0]+'"]) - mean(LD[sub_d[,"class"]=="'+p[1]+'"]))')
+                double effectSize = abs(LDMeans[i] - LDMeans[l]);
+                //scal = robjects.r('wfinal <- w.unit * effect.size')
+                vector<double> compResults;
+                for (int j = 0; j < w.size(); j++) { //[numOTUs][1]
+                    //coeff = [abs(float(v)) if not math.isnan(float(v)) else 0.0 for v in scal]
+                    double coeff = abs(w[j]*effectSize); if (isnan(coeff) || isinf(coeff)) { coeff = 0.0; }
+                    //gm = abs(res[p[0]][j] - res[p[1]][j]) - res is the means for each group for each otu
+                    double gm = abs(means[i][j] - means[l][j]);
+                    //means[k][i].append((gm+coeff[j])*0.5)
+                    compResults.push_back((gm+coeff)*0.5);
+                }
+                results.push_back(compResults);
+            }
+		}
+        
+        return results;
+    }
+    catch(exception& e) {
+        MothurOut::getInstance()->errorOut(e, "LefseCommand", "lefseLDA");
+        exit(1);
+    }
+}
+//**********************************************************************************************************************
+void driverLefseLDA(lefseLDAData* params) {
+	try {
+        int numGroups = params->groupClass->size();
+        int numClasses = params->classes->size();
+        vector<int> rand_s;
+        vector<double> values;
+        vector< vector<double> > a;
+        uniform_int_distribution<int> dis(0, numGroups-1);
+        
+        for (int j = params->start; j < params->end; j++) {
+            if (params->m->getControl_pressed()) { break; }
+            
+            if (params->m->getDebug()) { params->m->mothurOut("[DEBUG]: iter = " + toString(j) + "\n."); }
+            
+            mt19937_64 engine((*params->seeds)[j]);
+            
+            //find "good" random vector
+            bool found = false;
+            for (int h = 0; h < 1000; h++) { //generate a vector of length fractionNumGroups with range 0 to numGroups-1
+                rand_s.clear();
+                for (int k = 0; k < params->fractionNumGroups; k++) {  rand_s.push_back(dis(engine)); }
+                if (!contastWithinClassesOrFewPerClass(*params->adjustedLookup, rand_s, params->minCl, *params->groupClass, numClasses, values)) { found = true; break; }
+            }
+            
+            if (params->m->getControl_pressed()) { break; }
+            
+            if (!found) { (*params->skipped)[j] = 1; }
+            else {
+                //for each pair of classes
+                (*params->results)[j] = lefseLDA(*params->adjustedLookup, rand_s, *params->groupClass, *params->classes, a); //[numComparison][numOTUs]
+                if (params->m->getDebug()) { params->m->mothurOut("[DEBUG]: after lda. \n."); }
+            }
+        }
+    }
+	catch(exception& e) {
+		params->m->errorOut(e, "LefseCommand", "driverLefseLDA");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
 //modelled after lefse.py test_lda_r function
 map<int, double> LefseCommand::testLDA(SharedRAbundFloatVectors*& lookup, map<int, double> bins, map<string, vector<int> >& class2GroupIndex, map<string, vector<int> >& subClass2GroupIndex) {
     try {
@@ -767,63 +1006,61 @@ map<int, double> LefseCommand::testLDA(SharedRAbundFloatVectors*& lookup, map<in
                 
         //go through classes
         int minCl = 1e6;
-        map<int, string> indexToClass;
+        int numGroups = lookup->size(); //lfk
+        vector<int> groupClass; groupClass.resize(numGroups, 0);
         vector<string> classes;
         for (map<string, vector<int> >::iterator it = class2GroupIndex.begin(); it != class2GroupIndex.end(); it++) {
             //class with minimum number of groups
             if ((it->second).size() < minCl) { minCl = (it->second).size(); }
-            for (int i = 0; i < (it->second).size(); i++) { indexToClass[(it->second)[i]] = it->first; }
+            for (int i = 0; i < (it->second).size(); i++) { groupClass[(it->second)[i]] = classes.size(); }
             classes.push_back(it->first);
         }
         
-        int numGroups = lookup->size(); //lfk
         int fractionNumGroups = numGroups * fBoots; //rfk
         minCl = (int)((float)(minCl*fBoots*fBoots*0.05));
         minCl = max(minCl, 1);
  
         if (m->getDebug()) { m->mothurOut("[DEBUG]: about to start iters. FractionGroups = " + toString(fractionNumGroups) + "\n."); }
         
+        //each iteration samples with its own seed, drawn in order so the results don't depend on the number of processors
+        Utils randomUtil;
+        vector<unsigned long long> seeds;
+        for (int j = 0; j < iters; j++) { seeds.push_back((unsigned long long)randomUtil.getRandomNumber()); }
+        
+        vector< vector< vector<double> > > iterResults; iterResults.resize(iters);//[iters][numComparison][numOTUs]
+        vector<int> skipped; skipped.resize(iters, 0);
+        
+        vector<linePair> lines = divideWork(iters);
+        vector<thread*> workerThreads;
+        vector<lefseLDAData*> data;
+        
+        //Lauch worker threads
+        for (int i = 1; i < lines.size(); i++) {
+            lefseLDAData* dataBundle = new lefseLDAData(&adjustedLookup, &groupClass, &classes, &seeds, &iterResults, &skipped, lines[i].start, lines[i].end, minCl, fractionNumGroups);
+            data.push_back(dataBundle);
+            workerThreads.push_back(new thread(driverLefseLDA, dataBundle));
+        }
+        
+        lefseLDAData* dataBundle = new lefseLDAData(&adjustedLookup, &groupClass, &classes, &seeds, &iterResults, &skipped, lines[0].start, lines[0].end, minCl, fractionNumGroups);
+        driverLefseLDA(dataBundle);
+        delete dataBundle;
+        
+        for (int i = 0; i < workerThreads.size(); i++) {
+            workerThreads[i]->join();
+            delete data[i];
+            delete workerThreads[i];
+        }
+        
+        if (m->getControl_pressed()) { return sigOTUS; }
+        
         vector< vector< vector<double> > > results;//[iters][numComparison][numOTUs]
         for (int j = 0; j < iters; j++) {
-            if (m->getControl_pressed()) { return sigOTUS; }
-            
-            if (m->getDebug()) { m->mothurOut("[DEBUG]: iter = " + toString(j) + "\n."); }
-            
-            //find "good" random vector
-            vector<int> rand_s;
-            int save = 0;
-            Utils util;
-            for (int h = 0; h < 1000; h++) { //generate a vector of length fractionNumGroups with range 0 to numGroups-1
-                save = h;
-                rand_s.clear();
-                
-                for (int k = 0; k < fractionNumGroups; k++) {  int index = util.getRandomIndex(numGroups-1); rand_s.push_back(index); }
-                if (!contastWithinClassesOrFewPerClass(adjustedLookup, rand_s, minCl, class2GroupIndex, indexToClass)) { h+=1000; save += 1000; } //break out of loop
-            }
-            
-            if (m->getControl_pressed()) { return sigOTUS; }
-            
-            if (m->getDebug()) { m->mothurOut("[DEBUG]: after 1000. \n."); }
-            
-            //print data in R input format for testing
-            if (false) {
-                //vector<string> groups; for (int h = 0; h < rand_s.size(); h++) {  groups.push_back(lookup[rand_s[h]]->getGroup()); }
-                //for (int h = 0; h < groups.size(); h++) { cout << groups[h]<< endl; }
-                //printToCoutForRTesting(adjustedLookup, rand_s, class2GroupIndex, bins, subClass2GroupIndex, groups);
-            }
-            if (save < 1000) { m->mothurOut("[WARNING]: Skipping iter " + toString(j+1) + " in LDA test. This can be caused by too few groups per class or not enough contrast within the classes. \n"); }
-            else {
-                //for each pair of classes
-                vector< vector<double> > temp = lda(adjustedLookup, rand_s, indexToClass, classes); //[numComparison][numOTUs]
-                if (temp.size() != 0) { results.push_back(temp); }
-                if (m->getDebug()) { m->mothurOut("[DEBUG]: after lda. \n."); }
-            }
+            if (skipped[j] == 1) { m->mothurOut("[WARNING]: Skipping iter " + toString(j+1) + " in LDA test. This can be caused by too few groups per class or not enough contrast within the classes. \n"); }
+            else if (iterResults[j].size() != 0) { results.push_back(iterResults[j]); }
         }
         
         if (results.size() == 0) { return sigOTUS; }
         
-        if (m->getControl_pressed()) { return sigOTUS; }
-        
         //m = max([numpy.mean([means[k][kk][p] for kk in range(boots)]) for p in range(len(pairs))])
         int k = 0;
         for (it = bins.begin(); it != bins.end(); it++) { //[numOTUs] - need to go through bins so we can tie adjustedLookup back to the binNumber. adjustedLookup[0] ->bins entry[0]. 
@@ -851,6 +1088,29 @@ map<int, double> LefseCommand::testLDA(SharedRAbundFloatVectors*& lookup, map<in
     }
 }
 //**********************************************************************************************************************
+//contiguous ranges of items for each processor, never more ranges than items
+vector<linePair> LefseCommand::divideWork(int numItems) {
+    try {
+        vector<linePair> lines;
+        int numProcs = processors;
+        if (numItems < numProcs) { numProcs = numItems; }
+        if (numProcs < 1) { numProcs = 1; }
+        
+        int start = 0;
+        for (int p = 0; p < numProcs; p++) {
+            int num = (numItems - p + numProcs - 1) / numProcs;
+            lines.push_back(linePair(start, start+num));
+            start += num;
+        }
+        
+        return lines;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "LefseCommand", "divideWork");
+        exit(1);
+    }
+}
+//**********************************************************************************************************************
 vector< vector<double> > LefseCommand::getMeans(SharedRAbundFloatVectors*& lookup, map<string, vector<int> >& class2GroupIndex) {
     try {
         int numBins = lookup->getNumBins();
@@ -890,132 +1150,6 @@ vector< vector<double> > LefseCommand::getMeans(SharedRAbundFloatVectors*& looku
     }
 }
 //**********************************************************************************************************************
-vector< vector<double> > LefseCommand::lda(vector< vector<double> >& adjustedLookup, vector<int> rand_s, map<int, string>& indexToClass, vector<string> classes) {
-    try {
-        //shortcut for vectors below
-        map<string, int> quickIndex;
-        for (int i = 0; i < classes.size(); i++) { quickIndex[classes[i]] = i; }
-        
-        vector<string> randClass; //classes for rand sample
-        vector<int> counts; counts.resize(classes.size(), 0);
-        for (int i = 0; i < rand_s.size(); i++) {
-            string thisClass = indexToClass[rand_s[i]];
-            randClass.push_back(thisClass);
-            counts[quickIndex[thisClass]]++;
-        }
-
-        vector< vector<double> > a; //[numOTUs][numSampled]
-        for (int i = 0; i < adjustedLookup.size(); i++) {
-            vector<double> temp;
-            for (int j = 0; j < rand_s.size(); j++) {
-                temp.push_back(adjustedLookup[i][rand_s[j]]);
-            }
-            a.push_back(temp);
-        }
-        
-        LinearAlgebra linear;
-        vector< vector<double> > means; bool ignore;
-        vector< vector<double> > scaling = linear.lda(a, randClass, means, ignore); //means are returned sorted, quickIndex sorts as well since it uses a map. means[class][otu] =
-        if (ignore) { scaling.clear(); return scaling; }
-        if (m->getControl_pressed()) { return scaling; }
-        
-        vector< vector<double> > w; w.resize(a.size()); //w.unit <- w/sqrt(sum(w^2))
-        double denom = 0.0;
-        for (int i = 0; i < scaling.size(); i++) { w[i].push_back(scaling[i][0]); denom += (w[i][0]*w[i][0]); }
-        denom = sqrt(denom);
-        for (int i = 0; i < w.size(); i++) {  w[i][0] /= denom;  } //[numOTUs][1] - w.unit
-        
-        //robjects.r('LD <- xy.matrix%*%w.unit') [numSampled][numOtus] * [numOTUs][1]
-        vector< vector<double> > LD = linear.matrix_mult(linear.transpose(a), w);
-        
-        //find means for each groups LDs
-        vector<double> LDMeans; LDMeans.resize(classes.size(), 0.0); //means[0] -> average for [group0].
-        for (int i = 0; i < LD.size(); i++) {  LDMeans[quickIndex[randClass[i]]] += LD[i][0]; } 
-        for (int i = 0; i < LDMeans.size(); i++) { LDMeans[i] /= (double) counts[i];  }
-   
-		//calculate for each comparisons i.e. with groups A,B,C = AB, AC, BC = 3;
-        vector< vector<double> > results;// [numComparison][numOTUs]
-		for (int i = 0; i < LDMeans.size(); i++) {
-			for (int l = 0; l < i; l++) {
-                
-                if (m->getControl_pressed()) { return scaling; }
-                //robjects.r('effect.size <- abs(mean(LD[sub_d[,"class"]=="'+p[0]+'"]) - mean(LD[sub_d[,"class"]=="'+p[1]+'"]))')
-                double effectSize = abs(LDMeans[i] - LDMeans[l]);
-                //scal = robjects.r('wfinal <- w.unit * effect.size')
-                vector<double> compResults;
-                for (int j = 0; j < w.size(); j++) { //[numOTUs][1]
-                    //coeff = [abs(float(v)) if not math.isnan(float(v)) else 0.0 for v in scal]
-                    double coeff = abs(w[j][0]*effectSize); if (isnan(coeff) || isinf(coeff)) { coeff = 0.0; }
-                    //gm = abs(res[p[0]][j] - res[p[1]][j]) - res is the means for each group for each otu
-                    double gm = abs(means[i][j] - means[l][j]);
-                    //means[k][i].append((gm+coeff[j])*0.5)
-                    compResults.push_back((gm+coeff)*0.5);
-                }
-                results.push_back(compResults);
-            }
-		}
-        
-        return results;
-    }
-    catch(exception& e) {
-        m->errorOut(e, "LefseCommand", "lda");
-        exit(1);
-    }
-}
-
-//**********************************************************************************************************************
-//modelled after lefse.py contast_within_classes_or_few_per_class function
-bool LefseCommand::contastWithinClassesOrFewPerClass(vector< vector<double> >& lookup, vector<int> rands, int minCl, map<string, vector<int> > class2GroupIndex, map<int, string> indexToClass) {
-    try {
-        map<string, int> cls;
-        int countFound = 0;
-        
-        for (int i = 0; i < rands.size(); i++) { //fill cls with the classes represented in the random selection
-            for (map<string, vector<int> >::iterator it = class2GroupIndex.begin(); it != class2GroupIndex.end(); it++) {
-                if (util.inUsersGroups(rands[i], (it->second))) {
-                    map<string, int>::iterator itClass = cls.find(it->first);
-                    if (itClass != cls.end()) { itClass->second++; }
-                    else { cls[it->first] = 1;  }
-                    countFound++;
-                }
-            }
-        }
-        
-        //sanity check
-        if (rands.size() != countFound) { m->mothurOut("oops, should never get here, missing something.\n"); }
-        
-        if (cls.size() < class2GroupIndex.size()) { return true; } //some classes are not present in sampling
-        
-        for (map<string, int>::iterator itClass = cls.begin(); itClass != cls.end(); itClass++) {
-            if (itClass->second < minCl) { return true; } //this sampling has class count below minimum
-        }
-        
-        //for this otu
-        int numBins = lookup.size();
-        for (int i = 0; i < numBins; i++) {
-            if (m->getControl_pressed()) { break; }
-                
-            //break up random sampling by class
-            map<string, set<double> > class2Values; //maps class name -> set of abunds present in random sampling. F003Early -> 0.001, 0.003... 
-            for (int j = 0; j < rands.size(); j++) {
-                class2Values[indexToClass[rands[j]]].insert(lookup[i][rands[j]]);
-                //rands[j] = index of randomly selected group in lookup, randIndex2Class[rands[j]] = class this group belongs to. lookup[rands[j]]->getAbundance(i) = abundance of this group for this OTU.
-            }
-            //are the unique values less than we want
-            //if (len(set(col)) <= min_cl and min_cl > 1) or (min_cl == 1 and len(set(col)) <= 1):
-            for (map<string, set<double> >::iterator it = class2Values.begin(); it != class2Values.end(); it++) {
-                if (((it->second).size() <= minCl && minCl > 1) || (minCl == 1 && (it->second).size() <= 1)) {  return true; }
-            }
-        }
-        
-        return false;
-    }
-    catch(exception& e) {
-        m->errorOut(e, "LefseCommand", "contastWithinClassesOrFewPerClass");
-        exit(1);
-    }
-}
-//**********************************************************************************************************************
 int LefseCommand::printResults(vector< vector<double> > means, map<int, double> sigKW, map<int, double> sigLDA, string label, vector<string> classes, vector<string> currentLabels) {
     try {
         map<string, string> variables;
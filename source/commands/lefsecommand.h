@@ -53,16 +53,14 @@ private:
     vector<string> outputNames, Sets;
     set<string> labels;
     double anovaAlpha, wilcoxonAlpha, fBoots, ldaThreshold;
-    int nlogs, iters, strict, minC;
+    int nlogs, iters, strict, minC, processors;
     
     int process(SharedRAbundFloatVectors*&, DesignMap&);
     int normalize(SharedRAbundFloatVectors*&);
     map<int, double> runKruskalWallis(SharedRAbundFloatVectors*&, DesignMap&);
     map<int, double> runWilcoxon(SharedRAbundFloatVectors*&, DesignMap&, map<int, double>, map<string, set<string> >& class2SubClasses, map<string, vector<int> >& subClass2GroupIndex, map<string, string>);
-    bool testOTUWilcoxon(map<string, set<string> >& class2SubClasses, vector<float> abunds, map<string, vector<int> >& subClass2GroupIndex, map<string, string>);
     map<int, double> testLDA(SharedRAbundFloatVectors*&, map<int, double>, map<string, vector<int> >& class2GroupIndex, map<string, vector<int> >&);
-    bool contastWithinClassesOrFewPerClass(vector< vector<double> >&, vector<int> rands, int minCl, map<string, vector<int> > class2GroupIndex,  map<int, string> indexToClass);
-    vector< vector<double> > lda(vector< vector<double> >& adjustedLookup, vector<int> rand_s, map<int, string>& indexToClass, vector<string>);
+    vector<linePair> divideWork(int); //splits the items between the processors
     vector< vector<double> > getMeans(SharedRAbundFloatVectors*& lookup, map<string, vector<int> >& class2GroupIndex);
     int printResults(vector< vector<double> >, map<int, double>, map<int, double>, string, vector<string>, vector<string>);
     
@@ -72,8 +70,63 @@ private:
 };
 
 /**************************************************************************************************/
-
-
-
+//the tests run on each feature. Each thread tests otus[start, end), the kruskal wallis fields or wilcoxon fields are
+//set depending on the test.
+struct lefseTestData {
+    vector< vector<float> >* abunds; //[numOTUs][numGroups]
+    vector<int>* otus;
+    vector<string> treatments;   //class of each group, kruskal wallis
+    vector<double>* pvalues;     //kruskal wallis pvalue of each otu
+    vector<int>* sig;            //1 if the otu passed the wilcoxon tests
+    map<string, set<string> > class2SubClasses;
+    map<string, vector<int> > subClass2GroupIndex;
+    map<string, string> subclass2Class;
+    double wilcoxonAlpha;
+    int start, end, strict, minC;
+    bool curv;
+    string multiClassStrat;
+    Utils util;
+    MothurOut* m;
+    
+    lefseTestData(){}
+    lefseTestData(vector< vector<float> >* a, vector<int>* o, int st, int en) {
+        m = MothurOut::getInstance();
+        abunds = a;
+        otus = o;
+        start = st;
+        end = en;
+        pvalues = NULL;
+        sig = NULL;
+        wilcoxonAlpha = 0.05; strict = 0; minC = 10; curv = false;
+    }
+};
+/**************************************************************************************************/
+//the LDA bootstrap iterations [start, end), each sampled with its own seed
+struct lefseLDAData {
+    vector< vector<double> >* adjustedLookup; //[numSigOTUs][numGroups]
+    vector<int>* groupClass; //index in classes of each group's class
+    vector<string>* classes;
+    vector<unsigned long long>* seeds;
+    vector< vector< vector<double> > >* results; //[iters][numComparison][numOTUs], empty if the iter was skipped or ignored
+    vector<int>* skipped; //1 if no sampling with enough contrast was found
+    int start, end, minCl, fractionNumGroups;
+    MothurOut* m;
+    
+    lefseLDAData(){}
+    lefseLDAData(vector< vector<double> >* a, vector<int>* gc, vector<string>* c, vector<unsigned long long>* se, vector< vector< vector<double> > >* r, vector<int>* sk, int st, int en, int mc, int f) {
+        m = MothurOut::getInstance();
+        adjustedLookup = a;
+        groupClass = gc;
+        classes = c;
+        seeds = se;
+        results = r;
+        skipped = sk;
+        start = st;
+        end = en;
+        minCl = mc;
+        fractionNumGroups = f;
+    }
+};
+/**************************************************************************************************/
 
 #endif /* defined(__Mothur__lefsecommand__) */
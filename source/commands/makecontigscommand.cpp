@@ -957,42 +957,20 @@ int setNameType(string forwardFile, string reverseFile, char delim, int& offByOn
         string forward = ""; string reverse = "";
         Utils util;
         
-        ifstream inForward, inReverse;
-#ifdef USE_BOOST
-        boost::iostreams::filtering_istream inFF, inRF;
-#endif
-        if (!gz) { //plain text files
-            util.openInputFile(forwardFile, inForward);
-            util.openInputFile(reverseFile, inReverse);
-            
-            if (delim == '>') {
-                Sequence fread(inForward);
-                forward = fread.getName();
-                Sequence rread(inReverse);
-                reverse = rread.getName();
-            }else {
-                FastqRead fread(inForward, error, format);
-                forward = fread.getName();
-                FastqRead rread(inReverse, error, format);
-                reverse = rread.getName();
-            }
-        }else { //compressed files
-#ifdef USE_BOOST
-            util.openInputFileBinary(forwardFile, inForward, inFF);
-            util.openInputFileBinary(reverseFile, inReverse, inRF);
-            
-            if (delim == '>') {
-                Sequence fread(inFF);
-                forward = fread.getName();
-                Sequence rread(inRF);
-                reverse = rread.getName();
-            }else {
-                FastqRead fread(inFF, error, format);
-                forward = fread.getName();
-                FastqRead rread(inRF, error, format);
-                reverse = rread.getName();
-            }
-#endif
+        //the readers decompress .gz files themselves
+        SequenceReader inForward(forwardFile);
+        SequenceReader inReverse(reverseFile);
+        
+        if (delim == '>') {
+            Sequence fread(inForward);
+            forward = fread.getName();
+            Sequence rread(inReverse);
+            reverse = rread.getName();
+        }else {
+            FastqRead fread(inForward, error, format);
+            forward = fread.getName();
+            FastqRead rread(inReverse, error, format);
+            reverse = rread.getName();
         }
         
         type = setNameType(forward, reverse, offByOneTrimLength);
@@ -1470,106 +1448,18 @@ vector<int> assembleFragments(vector< vector<double> >&qual_match_simple_bayesia
     }
 }
 /**************************************************************************************************/
-#ifdef USE_BOOST
-//ignore = read(fSeq, rSeq, fQual, rQual, savedFQual, savedRQual, findexBarcode, rindexBarcode, delim,  inFF, inRF, inFQ, inRQ);
-bool read(Sequence& fSeq, Sequence& rSeq, QualityScores*& fQual, QualityScores*& rQual, QualityScores*& savedFQual, QualityScores*& savedRQual, Sequence& findexBarcode, Sequence& rindexBarcode, char delim, boost::iostreams::filtering_istream& inFF, boost::iostreams::filtering_istream& inRF, boost::iostreams::filtering_istream& inFQ, boost::iostreams::filtering_istream& inRQ, string thisfqualindexfile, string thisrqualindexfile, string format, int nameType, int offByOneTrimLength, MothurOut* m) {
-    try {
-        bool ignore = false;
-        Utils util;
-        if (delim == '@') { //fastq files
-            bool tignore;
-            FastqRead fread(inFF, tignore, format);  util.gobble(inFF);
-            FastqRead rread(inRF, ignore, format); util.gobble(inRF);
-            if (!checkName(fread, rread, nameType, offByOneTrimLength)) {
-                FastqRead f2read(inFF, tignore, format);
-                if (!checkName(f2read, rread, nameType, offByOneTrimLength)) {
-                    FastqRead r2read(inRF, ignore, format);
-                    if (!checkName(fread, r2read, nameType, offByOneTrimLength)) {
-                        m->mothurOut("[WARNING]: name mismatch in forward and reverse fastq file. Ignoring, " + fread.getName() + ".\n"); ignore = true;
-                    }else { rread = r2read; }
-                }else { fread = f2read; }
-            }
-            if (tignore) { ignore=true; }
-            fSeq.setName(fread.getName()); fSeq.setAligned(fread.getSeq());
-            rSeq.setName(rread.getName()); rSeq.setAligned(rread.getSeq());
-            fQual = new QualityScores(fread.getName(), fread.getScores());
-            rQual = new QualityScores(rread.getName(), rread.getScores());
-            savedFQual = new QualityScores(fQual->getName(), fQual->getQualityScores());
-            savedRQual = new QualityScores(rQual->getName(), rQual->getQualityScores());
-            if (thisfqualindexfile != "") { //forward index file
-                FastqRead firead(inFQ, tignore, format);
-                if (tignore) { ignore=true; }
-                findexBarcode.setAligned(firead.getSeq());
-                if (!checkName(fread, firead, nameType, offByOneTrimLength)) {
-                    FastqRead f2iread(inFQ, tignore, format);
-                    if (tignore) { ignore=true; }
-                    if (!checkName(fread, f2iread, nameType, offByOneTrimLength)) {
-                        m->mothurOut("[WARNING]: name mismatch in forward index file. Ignoring, " + fread.getName() + ".\n"); ignore = true;
-                    }else { firead = f2iread; findexBarcode.setAligned(firead.getSeq()); }
-                }
-            }
-            if (thisrqualindexfile != "") { //reverse index file
-                FastqRead riread(inRQ, tignore, format);
-                if (tignore) { ignore=true; }
-                rindexBarcode.setAligned(riread.getSeq());
-                if (!checkName(fread, riread, nameType, offByOneTrimLength)) {
-                    FastqRead r2iread(inRQ, tignore, format); util.gobble(inRQ);
-                    if (tignore) { ignore=true; }
-                    if (!checkName(fread, r2iread, nameType, offByOneTrimLength)) {
-                        m->mothurOut("[WARNING]: name mismatch in reverse index file. Ignoring, " + fread.getName() + ".\n"); ignore = true;
-                    }else { riread = r2iread; rindexBarcode.setAligned(riread.getSeq()); }
-                }
-            }
-        }else { //reading fasta and maybe qual
-            Sequence tfSeq(inFF);
-            Sequence trSeq(inRF);
-            if (!checkName(tfSeq, trSeq, nameType, offByOneTrimLength)) {
-                Sequence t2fSeq(inFF);
-                if (!checkName(t2fSeq, trSeq, nameType, offByOneTrimLength)) {
-                    Sequence t2rSeq(inRF);
-                    if (!checkName(tfSeq, t2rSeq, nameType, offByOneTrimLength)) {
-                        m->mothurOut("[WARNING]: name mismatch in forward and reverse fasta file. Ignoring, " + tfSeq.getName() + ".\n"); ignore = true;
-                    }else { trSeq = t2fSeq; }
-                }else { tfSeq = t2fSeq; }
-            }
-            fSeq.setName(tfSeq.getName()); fSeq.setAligned(tfSeq.getAligned());
-            rSeq.setName(trSeq.getName()); rSeq.setAligned(trSeq.getAligned());
-            if (thisfqualindexfile != "") {
-                fQual = new QualityScores(inFQ); util.gobble(inFQ);
-                rQual = new QualityScores(inRQ); util.gobble(inRQ);
-                if (!checkName(*fQual, *rQual, nameType, offByOneTrimLength)) {
-                    m->mothurOut("[WARNING]: name mismatch in forward and reverse qual file. Ignoring, " + fQual->getName() + ".\n"); ignore = true;
-                }
-                savedFQual = new QualityScores(fQual->getName(), fQual->getQualityScores());
-                savedRQual = new QualityScores(rQual->getName(), rQual->getQualityScores());
-                if (fQual->getName() != tfSeq.getName()) { m->mothurOut("[WARNING]: name mismatch in forward quality file. Ignoring, " + tfSeq.getName() + ".\n"); ignore = true; }
-                if (rQual->getName() != trSeq.getName()) { m->mothurOut("[WARNING]: name mismatch in reverse quality file. Ignoring, " + trSeq.getName() + ".\n"); ignore = true; }
-            }
-            if (tfSeq.getName() != trSeq.getName()) { m->mothurOut("[WARNING]: name mismatch in forward and reverse fasta file. Ignoring, " + tfSeq.getName() + ".\n"); ignore = true; }
-        }
-        return ignore;
-        
-    }
-    catch(exception& e) {
-        m->errorOut(e, "MakeContigsCommand", "read");
-        exit(1);
-    }
-}
-#endif
-/**************************************************************************************************/
 
-bool read(Sequence& fSeq, Sequence& rSeq, QualityScores*& fQual, QualityScores*& rQual, QualityScores*& savedFQual, QualityScores*& savedRQual, Sequence& findexBarcode, Sequence& rindexBarcode, char delim, ifstream& inFFasta, ifstream& inRFasta, ifstream& inFQualIndex, ifstream& inRQualIndex, string thisfqualindexfile, string thisrqualindexfile, string format, int nameType, int offByOneTrimLength, MothurOut* m) {
+bool read(Sequence& fSeq, Sequence& rSeq, QualityScores*& fQual, QualityScores*& rQual, QualityScores*& savedFQual, QualityScores*& savedRQual, Sequence& findexBarcode, Sequence& rindexBarcode, char delim, SequenceReader& inFFasta, SequenceReader& inRFasta, SequenceReader* inFQualIndex, SequenceReader* inRQualIndex, string thisfqualindexfile, string thisrqualindexfile, string format, int nameType, int offByOneTrimLength, MothurOut* m) {
     try {
         bool ignore = false;
-        Utils util;
         if (delim == '@') { //fastq files
             bool tignore;
-            FastqRead fread(inFFasta, tignore, format); util.gobble(inFFasta);
-            FastqRead rread(inRFasta, ignore, format); util.gobble(inRFasta);
+            FastqRead fread(inFFasta, tignore, format);
+            FastqRead rread(inRFasta, ignore, format);
             if (!checkName(fread, rread, nameType, offByOneTrimLength)) {
-                FastqRead f2read(inFFasta, tignore, format); util.gobble(inFFasta);
+                FastqRead f2read(inFFasta, tignore, format);
                 if (!checkName(f2read, rread, nameType, offByOneTrimLength)) {
-                    FastqRead r2read(inRFasta, ignore, format); util.gobble(inRFasta);
+                    FastqRead r2read(inRFasta, ignore, format);
                     if (!checkName(fread, r2read, nameType, offByOneTrimLength)) {
                         m->mothurOut("[WARNING]: name mismatch in forward and reverse fastq file. Ignoring, " + fread.getName() + ".\n"); ignore = true;
                     }else { rread = r2read; }
@@ -1583,11 +1473,11 @@ bool read(Sequence& fSeq, Sequence& rSeq, QualityScores*& fQual, QualityScores*&
             savedFQual = new QualityScores(fQual->getName(), fQual->getQualityScores());
             savedRQual = new QualityScores(rQual->getName(), rQual->getQualityScores());
             if (thisfqualindexfile != "") { //forward index file
-                FastqRead firead(inFQualIndex, tignore, format); util.gobble(inFQualIndex);
+                FastqRead firead(*inFQualIndex, tignore, format);
                 if (tignore) { ignore=true; }
                 findexBarcode.setAligned(firead.getSeq());
                 if (!checkName(fread, firead, nameType, offByOneTrimLength)) {
-                    FastqRead f2iread(inFQualIndex, tignore, format); util.gobble(inFQualIndex);
+                    FastqRead f2iread(*inFQualIndex, tignore, format);
                     if (tignore) { ignore=true; }
                     if (!checkName(fread, f2iread, nameType, offByOneTrimLength)) {
                         m->mothurOut("[WARNING]: name mismatch in forward index file. Ignoring, " + fread.getName() + ".\n"); ignore = true;
@@ -1595,11 +1485,11 @@ bool read(Sequence& fSeq, Sequence& rSeq, QualityScores*& fQual, QualityScores*&
                 }
             }
             if (thisrqualindexfile != "") { //reverse index file
-                FastqRead riread(inRQualIndex, tignore, format); util.gobble(inRQualIndex);
+                FastqRead riread(*inRQualIndex, tignore, format);
                 if (tignore) { ignore=true; }
                 rindexBarcode.setAligned(riread.getSeq());
                 if (!checkName(fread, riread, nameType, offByOneTrimLength)) {
-                    FastqRead r2iread(inRQualIndex, tignore, format); util.gobble(inRQualIndex);
+                    FastqRead r2iread(*inRQualIndex, tignore, format);
                     if (tignore) { ignore=true; }
                     if (!checkName(fread, r2iread, nameType, offByOneTrimLength)) {
                         m->mothurOut("[WARNING]: name mismatch in reverse index file. Ignoring, " + fread.getName() + ".\n"); ignore = true;
@@ -1607,12 +1497,12 @@ bool read(Sequence& fSeq, Sequence& rSeq, QualityScores*& fQual, QualityScores*&
                 }
             }
         }else { //reading fasta and maybe qual
-            Sequence tfSeq(inFFasta); util.gobble(inFFasta);
-            Sequence trSeq(inRFasta); util.gobble(inRFasta);
+            Sequence tfSeq(inFFasta);
+            Sequence trSeq(inRFasta);
             if (!checkName(tfSeq, trSeq, nameType, offByOneTrimLength)) {
-                Sequence t2fSeq(inFFasta); util.gobble(inFFasta);
+                Sequence t2fSeq(inFFasta);
                 if (!checkName(t2fSeq, trSeq, nameType, offByOneTrimLength)) {
-                    Sequence t2rSeq(inRFasta); util.gobble(inRFasta);
+                    Sequence t2rSeq(inRFasta);
                     if (!checkName(tfSeq, t2rSeq, nameType, offByOneTrimLength)) {
                         m->mothurOut("[WARNING]: name mismatch in forward and reverse fasta file. Ignoring, " + tfSeq.getName() + ".\n"); ignore = true;
                     }else { trSeq = t2fSeq; }
@@ -1621,8 +1511,8 @@ bool read(Sequence& fSeq, Sequence& rSeq, QualityScores*& fQual, QualityScores*&
             fSeq.setName(tfSeq.getName()); fSeq.setAligned(tfSeq.getAligned());
             rSeq.setName(trSeq.getName()); rSeq.setAligned(trSeq.getAligned());
             if (thisfqualindexfile != "") {
-                fQual = new QualityScores(inFQualIndex); util.gobble(inFQualIndex);
-                rQual = new QualityScores(inRQualIndex); util.gobble(inRQualIndex);
+                fQual = new QualityScores(*inFQualIndex);
+                rQual = new QualityScores(*inRQualIndex);
                 if (!checkName(*fQual, *rQual, nameType, offByOneTrimLength)) {
                     m->mothurOut("[WARNING]: name mismatch in forward and reverse qual file. Ignoring, " + fQual->getName() + ".\n"); ignore = true;
                 }
@@ -1667,46 +1557,21 @@ void driverContigs(contigsData* params){
         
         if (params->m->getDebug()) {  params->m->mothurOut("[DEBUG]: ffasta = " + thisffastafile + ".\n[DEBUG]: rfasta = " + thisrfastafile + ".\n[DEBUG]: fqualindex = " + thisfqualindexfile + ".\n[DEBUG]: rqualindex = " + thisfqualindexfile + ".\n"); }
         
-        ifstream inFFasta, inRFasta, inFQualIndex, inRQualIndex;
-#ifdef USE_BOOST
-        boost::iostreams::filtering_istream inFF, inRF, inFQ, inRQ;
-#endif
-        if (!params->gz) { //plain text files
-            params->util.openInputFile(thisffastafile, inFFasta);
-            params->util.openInputFile(thisrfastafile, inRFasta);
-            
-            inFFasta.seekg(params->linesInput.start);
-            inRFasta.seekg(params->linesInputReverse.start);
-        }else { //compressed files - no need to seekg because compressed files divide workload differently
-#ifdef USE_BOOST
-            params->util.openInputFileBinary(thisffastafile, inFFasta, inFF);
-            params->util.openInputFileBinary(thisrfastafile, inRFasta, inRF);
-#endif
+        //compressed files are read from the start, they divide the workload by file instead of by position
+        unsigned long long fStart = 0, rStart = 0, fqStart = 0, rqStart = 0;
+        if (!params->gz) {
+            fStart = params->linesInput.start; rStart = params->linesInputReverse.start;
+            fqStart = params->qlinesInput.start; rqStart = params->qlinesInputReverse.start;
         }
         
-        ofstream outFasta, outMisMatch, outScrapFasta, outQual, outScrapQual;
+        SequenceReader inFFasta(thisffastafile, fStart);
+        SequenceReader inRFasta(thisrfastafile, rStart);
+        
+        SequenceReader* inFQualIndex = NULL; SequenceReader* inRQualIndex = NULL;
         if (thisfqualindexfile != "") {
-            if (thisfqualindexfile != "NONE") {
-                if (!params->gz) { //plain text files
-                    params->util.openInputFile(thisfqualindexfile, inFQualIndex);
-                    inFQualIndex.seekg(params->qlinesInput.start);
-                }else {
-#ifdef USE_BOOST
-                    params->util.openInputFileBinary(thisfqualindexfile, inFQualIndex, inFQ);
-#endif
-                } //compressed files - no need to seekg because compressed files divide workload differently
-            }
+            if (thisfqualindexfile != "NONE") { inFQualIndex = new SequenceReader(thisfqualindexfile, fqStart);  }
             else {  thisfqualindexfile = ""; }
-            if (thisrqualindexfile != "NONE") {
-                if (!params->gz) { //plain text files
-                    params->util.openInputFile(thisrqualindexfile, inRQualIndex);
-                    inRQualIndex.seekg(params->qlinesInputReverse.start);
-                }else {
-#ifdef USE_BOOST
-                    params->util.openInputFileBinary(thisrqualindexfile, inRQualIndex, inRQ);
-#endif
-                } //compressed files - no need to seekg because compressed files divide workload differently
-            }
+            if (thisrqualindexfile != "NONE") { inRQualIndex = new SequenceReader(thisrqualindexfile, rqStart);  }
             else { thisrqualindexfile = ""; }
         }
         
@@ -1748,13 +1613,7 @@ void driverContigs(contigsData* params){
             Sequence findexBarcode("findex", "NONE");  Sequence rindexBarcode("rindex", "NONE");
             
             //read from input files
-            if (params->gz) {
-#ifdef USE_BOOST
-                ignore = read(fSeq, rSeq, fQual, rQual, savedFQual, savedRQual, findexBarcode, rindexBarcode, params->delim, inFF, inRF, inFQ, inRQ, thisfqualindexfile, thisrqualindexfile, params->format, params->nameType, params->offByOneTrimLength, params->m);
-#endif
-            }else    {
-                ignore = read(fSeq, rSeq, fQual, rQual, savedFQual, savedRQual, findexBarcode, rindexBarcode, params->delim, inFFasta, inRFasta, inFQualIndex, inRQualIndex, thisfqualindexfile, thisrqualindexfile, params->format, params->nameType, params->offByOneTrimLength, params->m);
-            }
+            ignore = read(fSeq, rSeq, fQual, rQual, savedFQual, savedRQual, findexBarcode, rindexBarcode, params->delim, inFFasta, inRFasta, inFQualIndex, inRQualIndex, thisfqualindexfile, thisrqualindexfile, params->format, params->nameType, params->offByOneTrimLength, params->m);
             
             //remove primers and barcodes if neccessary
             if (!ignore) {
@@ -1908,21 +1767,13 @@ void driverContigs(contigsData* params){
             
 #if defined NON_WINDOWS
             if (!params->gz) {
-                unsigned long long pos = inFFasta.tellg();
-                if ((pos == -1) || (pos >= params->linesInput.end)) { good = false; break; }
-            }else {
-#ifdef USE_BOOST
-                if (inFF.eof() || inRF.eof()) { good = false; break; }
-#endif
-            }
+                unsigned long long pos = inFFasta.getPosition();
+                if (inFFasta.eof() || (pos >= params->linesInput.end)) { good = false; break; }
+            }else if (inFFasta.eof() || inRFasta.eof()) { good = false; break; }
 #else
             if (!params->gz) {
-                if (params->count >= params->linesInput.end) { good = false; break; }
-            }else {
-#ifdef USE_BOOST
-                if (inFF.eof() || inRF.eof()) { good = false; break; }
-#endif
-            }
+                if (inFFasta.eof() || (params->count >= params->linesInput.end)) { good = false; break; }
+            }else if (inFFasta.eof() || inRFasta.eof()) { good = false; break; }
 #endif
             
             //report progress
@@ -1933,40 +1784,8 @@ void driverContigs(contigsData* params){
         if((params->count) % 1000 != 0){	params->m->mothurOutJustToScreen(toString(params->count)+"\n"); }
         
         //close files
-        inFFasta.close();
-        inRFasta.close();
-        if (params->gz) {
-#ifdef USE_BOOST
-            inFF.pop(); inRF.pop();
-#endif
-        }
-        
-        if (params->delim == '@') {
-            if (thisfqualindexfile != "") { inFQualIndex.close();
-                if (params->gz) {
-#ifdef USE_BOOST
-                    inFQ.pop();
-#endif
-                }
-            }
-            if (thisrqualindexfile != "") { inRQualIndex.close();
-                if (params->gz) {
-#ifdef USE_BOOST
-                    inRQ.pop();
-#endif
-                }
-            }
-        }else{
-            if (hasQuality) {
-                inFQualIndex.close();
-                inRQualIndex.close();
-                if (params->gz) {
-#ifdef USE_BOOST
-                    inFQ.pop(); inRQ.pop();
-#endif
-                }
-            }
-        }
+        if (inFQualIndex != NULL) { delete inFQualIndex; }
+        if (inRQualIndex != NULL) { delete inRQualIndex; }
         
         //cleanup memory
         delete alignment;
@@ -18,6 +18,7 @@ vector<string> MantelCommand::setParameters(){
 		CommandParameter pphylip2("phylip2", "InputTypes", "", "", "none", "none", "none","mantel",false,true,true); parameters.push_back(pphylip2);
 		CommandParameter piters("iters", "Number", "", "1000", "", "", "","",false,false); parameters.push_back(piters);
 		CommandParameter pmethod("method", "Multiple", "pearson-spearman-kendall", "pearson", "", "", "","",false,false); parameters.push_back(pmethod);
+		CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
 		CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
@@ -37,9 +38,10 @@ string MantelCommand::getHelpString(){
 		string helpString = "";
 		helpString += "Sokal, R. R., & Rohlf, F. J. (1995). Biometry, 3rd edn. New York: Freeman.\n";
 		helpString += "The mantel command reads two distance matrices and calculates the mantel correlation coefficient.\n";
-		helpString += "The mantel command parameters are phylip1, phylip2, iters and method.  The phylip1 and phylip2 parameters are required.  Matrices must be the same size and contain the same names.\n";
+		helpString += "The mantel command parameters are phylip1, phylip2, iters, method and processors.  The phylip1 and phylip2 parameters are required.  Matrices must be the same size and contain the same names.\n";
 		helpString += "The method parameter allows you to select what method you would like to use. Options are pearson, spearman and kendall. Default=pearson.\n";
 		helpString += "The iters parameter allows you to set number of randomization for the P value.  The default is 1000. \n";
+		helpString += "The processors parameter allows you to specify the number of processors to use for the randomizations. The default is all available. \n";
 		helpString += "The mantel command should be in the following format: mantel(phylip1=veg.dist, phylip2=env.dist).\n";
 		helpString += "The mantel command outputs a .mantel file.\n";
 		return helpString;
@@ -142,6 +144,9 @@ MantelCommand::MantelCommand(string option)  {
 			string temp = validParameter.valid(parameters, "iters");			if (temp == "not found") { temp = "1000"; }
 			util.mothurConvert(temp, iters);
 			
+			temp = validParameter.valid(parameters, "processors");	if (temp == "not found"){	temp = current->getProcessors();	}
+			processors = current->setProcessors(temp);
+			
 			if ((method != "pearson") && (method != "spearman") && (method != "kendall")) { m->mothurOut(method + " is not a valid method. Valid methods are pearson, spearman, and kendall."); m->mothurOutEndLine(); abort = true; }
 		}
 	}
@@ -199,25 +204,12 @@ int MantelCommand::execute(){
 		
 		
 		//calc signifigance
-		int count = 0;
-		for (int i = 0; i < iters; i++) {
-			
-			if (m->getControl_pressed()) { return 0; }
-			
-			//randomize matrix2
-			vector< vector<double> > matrix2Copy = matrix2;
-			util.mothurRandomShuffle(matrix2Copy);
-		
-			//calc random mantel
-			double randomMantel = 0.0;
-			if (method == "pearson")		{  randomMantel = linear.calcPearson(matrix1, matrix2Copy);	}
-			else if (method == "spearman")	{  randomMantel = linear.calcSpearman(matrix1, matrix2Copy);	}
-			else if (method == "kendall")	{  randomMantel = linear.calcKendall(matrix1, matrix2Copy);	}
-			
-			if (randomMantel >= mantel) { count++; }
-		}
+		MantelStatistic statistic(matrix1, matrix2, method);
+		vector<int> labels(matrix2.size());
+		for (int i = 0; i < labels.size(); i++) { labels[i] = i; }
 		
-		double pValue = count / (float) iters;
+		PermutationTest test(iters, processors);
+		double pValue = test.getPValue(&statistic, labels, statistic.getStatistic(labels), true);
 		
 		if (m->getControl_pressed()) { return 0; }
 		
@@ -251,6 +243,90 @@ int MantelCommand::execute(){
 	}
 }
 
+//**********************************************************************************************************************
+//the x average does not change between permutations
+MantelStatistic::MantelStatistic(vector< vector<double> >& m1, vector< vector<double> >& m2, string me) : matrix1(m1), matrix2(m2), method(me) {
+	try {
+		int count = 0;
+		averageX = 0.0;
+		for (int i = 0; i < matrix1.size(); i++) {
+			for (int j = 0; j < i; j++) {
+				averageX += matrix1[i][j];
+				count++;
+			}
+		}
+		averageX = averageX / (float) count;
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "MantelStatistic", "MantelStatistic");
+		exit(1);
+	}
+}
 //**********************************************************************************************************************
 
-
+double MantelStatistic::getStatistic(const vector<int>& rows) {
+	try {
+		if (method == "pearson") { return calcPearson(rows); }
+		
+		vector< vector<double> > matrix2Copy(rows.size());
+		for (int i = 0; i < rows.size(); i++) { matrix2Copy[i] = matrix2[rows[i]]; }
+		
+		LinearAlgebra linear;
+		double mantel = 0.0;
+		if (method == "spearman")		{  mantel = linear.calcSpearman(matrix1, matrix2Copy);	}
+		else if (method == "kendall")	{  mantel = linear.calcKendall(matrix1, matrix2Copy);	}
+		
+		return mantel;
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "MantelStatistic", "getStatistic");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
+//LinearAlgebra::calcPearson reading the reordered rows in place
+double MantelStatistic::calcPearson(const vector<int>& rows) {
+	try {
+		int count = 0;
+		float averageY = 0.0;
+		for (int i = 0; i < rows.size(); i++) {
+			const double* row = matrix2[rows[i]].data();
+			for (int j = 0; j < i; j++) {
+				averageY += row[j];
+				count++;
+			}
+		}
+		averageY = averageY / (float) count;
+		
+		double numerator = 0.0;
+		double denomTerm1 = 0.0;
+		double denomTerm2 = 0.0;
+		
+		for (int i = 0; i < rows.size(); i++) {
+			const double* rowX = matrix1[i].data();
+			const double* rowY = matrix2[rows[i]].data();
+			
+			for (int k = 0; k < i; k++) { //just lt dists
+				float Yi = rowY[k];
+				float Xi = rowX[k];
+				
+				numerator += ((Xi - averageX) * (Yi - averageY));
+				denomTerm1 += ((Xi - averageX) * (Xi - averageX));
+				denomTerm2 += ((Yi - averageY) * (Yi - averageY));
+			}
+		}
+		
+		double denom = (sqrt(denomTerm1) * sqrt(denomTerm2));
+		double r = numerator / denom;
+		
+		//divide by zero error
+		if (isnan(r) || isinf(r)) { r = 0.0; }
+		
+		return r;
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "MantelStatistic", "calcPearson");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
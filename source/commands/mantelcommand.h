@@ -12,6 +12,7 @@
 
 #include "command.hpp"
 #include "linearalgebra.h"
+#include "permutationtest.h"
 
 class MantelCommand : public Command {
 public:
@@ -35,11 +36,31 @@ private:
 	
 	string phylipfile1, phylipfile2, outputDir, method;
 	bool abort;
-	int iters;
+	int iters, processors;
 	
 	vector<string> outputNames;
 };
 
+/**************************************************************************************************/
+//correlation between the first matrix and the second with its rows reordered. The labels are the row of the second
+//matrix to use for each row of the first.
+class MantelStatistic : public PermutationStatistic {
+	
+public:
+	MantelStatistic(vector< vector<double> >&, vector< vector<double> >&, string);
+	double getStatistic(const vector<int>&);
+	
+private:
+	vector< vector<double> >& matrix1;
+	vector< vector<double> >& matrix2;
+	string method;
+	float averageX;
+	
+	double calcPearson(const vector<int>&);
+};
+
+/**************************************************************************************************/
+
 
 #endif
 
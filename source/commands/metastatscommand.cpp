@@ -50,7 +50,7 @@ string MetaStatsCommand::getHelpString(){
 		helpString += "The threshold parameter allows you to set the significance level to reject null hypotheses (default 0.05).\n";
 		helpString += "The groups parameter allows you to specify which of the groups in your groupfile you would like included. The group names are separated by dashes.\n";
 		helpString += "The label parameter allows you to select what distance levels you would like, and are also separated by dashes.\n";
-		helpString += "The processors parameter allows you to specify how many processors you would like to use.  The default is 1. \n";
+		helpString += "The processors parameter allows you to specify how many processors you would like to use. Pairs of sets are run in parallel, and processors left over run the permutations within each pair.  The default is all available. \n";
 		helpString += "The metastats command should be in the following format: metastats(design=yourDesignFile).\n";
 		helpString += "Example metastats(design=temp.design, groups=A-B-C).\n";
 		helpString += "The default value for groups is all the groups in your groupfile, and all labels in your inputfile will be used.\n";
@@ -237,8 +237,7 @@ int MetaStatsCommand::execute(){
 			}
 		}
 	
-		if (numGroups == 2) { processors = 1; }
-		else if (numGroups < 2)	{ m->mothurOut("Not enough sets, I need at least 2 valid sets. Unable to complete command.\n");  m->setControl_pressed(true); }
+		if (numGroups < 2)	{ m->mothurOut("Not enough sets, I need at least 2 valid sets. Unable to complete command.\n");  m->setControl_pressed(true); }
 
 		//as long as you are not at the end of the file or done wih the lines you want
 		while((lookup != NULL) && ((allLines == 1) || (userLabels.size() != 0))) {
@@ -321,13 +320,13 @@ struct metastatsData {
     SharedRAbundVectors* thisLookUp;
     vector< vector<string> > namesOfGroupCombos;
     vector<string> designMapGroups, outputNames;
-    int start, num, iters, count;
+    int start, num, iters, count, processors;
     float threshold;
     Utils util;
     MothurOut* m;
     
     metastatsData(){}
-    metastatsData(int st, int en, vector<string> on, vector< vector<string> > ns, SharedRAbundVectors*& lu, vector<string> dg, int i, float thr) {
+    metastatsData(int st, int en, vector<string> on, vector< vector<string> > ns, SharedRAbundVectors*& lu, vector<string> dg, int i, float thr, int p) {
         m = MothurOut::getInstance();
         outputNames = on;
         start = st;
@@ -337,6 +336,7 @@ struct metastatsData {
         designMapGroups = dg;
         iters = i;
         threshold = thr;
+        processors = p;
         count=0;
     }
 };
@@ -381,7 +381,7 @@ int driver(metastatsData* params) {
                 }
                 
                 params->m->mothurOut("\nComparing " + setA + " and " + setB + "...\n");
-                MothurMetastats mothurMeta(params->threshold, params->iters);
+                MothurMetastats mothurMeta(params->threshold, params->iters, params->processors);
                 mothurMeta.runMetastats(outputFileName , data2, setACount, params->thisLookUp->getOTUNames());
                 params->m->mothurOutEndLine();
             }
@@ -407,8 +407,15 @@ int MetaStatsCommand::process(SharedRAbundVectors*& thisLookUp){
         
         int remainingPairs = namesOfGroupCombos.size();
         int startIndex = 0;
+        
+        //a thread for each pair, the processors left over run the permutations within each pair
+        int pairProcessors = processors;
+        if (remainingPairs < pairProcessors) { pairProcessors = remainingPairs; }
+        if (pairProcessors < 1) { pairProcessors = 1; }
+        int permutationProcessors = processors / pairProcessors;
+        
         vector<vector<string> > outputFileNames;
-        for (int remainingProcessors = processors; remainingProcessors > 0; remainingProcessors--) {
+        for (int remainingProcessors = pairProcessors; remainingProcessors > 0; remainingProcessors--) {
             int numPairs = remainingPairs; //case for last processor
             if (remainingProcessors != 1) { numPairs = ceil(remainingPairs / remainingProcessors); }
             lines.push_back(linePair(startIndex, numPairs)); //startIndex, numPairs
@@ -435,21 +442,21 @@ int MetaStatsCommand::process(SharedRAbundVectors*& thisLookUp){
         for (int j = 0; j < designMapGroups.size(); j++) {  designMapGroups[j] = designMap->get(designMapGroups[j]); }
         
         //Lauch worker threads
-        for (int i = 0; i < processors-1; i++) {
+        for (int i = 0; i < pairProcessors-1; i++) {
             //make copy of lookup so we don't get access violations
             SharedRAbundVectors* newLookup = new SharedRAbundVectors(*lookup);
             
-            metastatsData* dataBundle = new metastatsData(lines[i+1].start, lines[i+1].end, outputNames, namesOfGroupCombos, newLookup, designMapGroups, iters, threshold);
+            metastatsData* dataBundle = new metastatsData(lines[i+1].start, lines[i+1].end, outputNames, namesOfGroupCombos, newLookup, designMapGroups, iters, threshold, permutationProcessors);
             data.push_back(dataBundle);
             
             thread* thisThread = new thread(driver, dataBundle);
             workerThreads.push_back(thisThread);
         }
 
-        metastatsData* dataBundle = new metastatsData(lines[0].start, lines[0].end, outputNames, namesOfGroupCombos, lookup, designMapGroups, iters, threshold);
+        metastatsData* dataBundle = new metastatsData(lines[0].start, lines[0].end, outputNames, namesOfGroupCombos, lookup, designMapGroups, iters, threshold, permutationProcessors);
         driver(dataBundle);
         
-        for (int i = 0; i < processors-1; i++) {
+        for (int i = 0; i < pairProcessors-1; i++) {
             workerThreads[i]->join();
             
             delete data[i]->thisLookUp;
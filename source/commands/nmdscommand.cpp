@@ -20,6 +20,7 @@ vector<string> NMDSCommand::setParameters(){
 		CommandParameter piters("iters", "Number", "", "10", "", "", "","",false,false); parameters.push_back(piters);
 		CommandParameter pmaxiters("maxiters", "Number", "", "500", "", "", "","",false,false); parameters.push_back(pmaxiters);
 		CommandParameter pepsilon("epsilon", "Number", "", "0.000000000001", "", "", "","",false,false); parameters.push_back(pepsilon);
+		CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
 		CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
@@ -38,7 +39,7 @@ string NMDSCommand::getHelpString(){
 	try {
 		string helpString = "";
 		helpString += "The nmds command is modelled after the nmds code written in R by Sarah Goslee, using Non-metric multidimensional scaling function using the majorization algorithm from Borg & Groenen 1997, Modern Multidimensional Scaling.\n";
-		helpString += "The nmds command parameters are phylip, axes, mindim, maxdim, maxiters, iters and epsilon.\n"; 
+		helpString += "The nmds command parameters are phylip, axes, mindim, maxdim, maxiters, iters, epsilon and processors.\n"; 
 		helpString += "The phylip parameter allows you to enter your distance file.\n"; 
 		helpString += "The axes parameter allows you to enter a file containing a starting configuration.\n";
 		helpString += "The maxdim parameter allows you to select the maximum dimensions to use. Default=2\n"; 
@@ -46,6 +47,7 @@ string NMDSCommand::getHelpString(){
 		helpString += "The maxiters parameter allows you to select the maximum number of iters to try with each random configuration. Default=500\n"; 
 		helpString += "The iters parameter allows you to select the number of random configuration to try. Default=10\n"; 
 		helpString += "The epsilon parameter allows you to select set an acceptable stopping point. Default=1e-12.\n"; 
+		helpString += "The processors parameter allows you to specify how many processors you would like to use. The random configurations are divided between the processors. The default is 1.\n";
 		helpString += "Example nmds(phylip=yourDistanceFile).\n";
 		return helpString;
 	}
@@ -173,6 +175,9 @@ NMDSCommand::NMDSCommand(string option)  {
 			temp = validParameter.valid(parameters, "epsilon");	if (temp == "not found") {	temp = "0.000000000001";	}
 			util.mothurConvert(temp, epsilon); 
 			
+			temp = validParameter.valid(parameters, "processors");	if (temp == "not found"){	temp = current->getProcessors();	}
+			processors = current->setProcessors(temp);
+			
 			if (mindim < 1) { m->mothurOut("mindim must be at least 1."); m->mothurOutEndLine(); abort = true; }
 			if (maxdim < mindim) { maxdim = mindim; }
 		}
@@ -222,57 +227,45 @@ int NMDSCommand::execute(){
 		
 		out2 << "Dimension\tIter\tStress\tRsq" << endl;
 		
+		//one run per dimension and random configuration. Each run gets its own seed drawn here in run order,
+		//so the results do not depend on the number of processors.
+		vector<nmdsRun> runs;
+		for (int i = mindim; i <= maxdim; i++) {
+			for (int j = 0; j < iters; j++) { runs.push_back(nmdsRun(i, j, (unsigned long long)util.getRandomNumber())); }
+		}
+		
+		createProcesses(matrix, axes, runs);
+		if (m->getControl_pressed()) { out.close(); out2.close(); for (int k = 0; k < outputNames.size(); k++) {	util.mothurRemove(outputNames[k]);	} return 0; }
+		
 		double bestStress = 10000000;
 		double bestR2 = 10000000;
-		vector< vector<double> > bestConfig;
+		int bestRun = -1;
 		int bestDim = 0;
 		
-		for (int i = mindim; i <= maxdim; i++) {
-			m->mothurOut("Processing Dimension: " + toString(i)); m->mothurOutEndLine();
+		for (int k = 0; k < runs.size(); k++) {
+			int i = runs[k].dimension;
+			int j = runs[k].iter;
 			
-			for (int j = 0; j < iters; j++) {
-				m->mothurOut(toString(j+1)); m->mothurOutEndLine(); 
-				
-				//get configuration - either randomly generate or resize to this dimension
-				vector< vector<double> > thisConfig;
-				if (axesfile == "") {	thisConfig = generateStartingConfiguration(names.size(), i);		}
-				else				{	thisConfig = getConfiguration(axes, i);								}
-				if (m->getControl_pressed()) { out.close(); out2.close(); for (int k = 0; k < outputNames.size(); k++) {	util.mothurRemove(outputNames[k]);	} return 0; }
-				
-				//calc nmds for this dimension
-				double stress;
-				vector< vector<double> > endConfig = nmdsCalc(matrix, thisConfig, stress);
-				if (m->getControl_pressed()) { out.close(); out2.close(); for (int k = 0; k < outputNames.size(); k++) {	util.mothurRemove(outputNames[k]);	} return 0; }
-				
-				//calc euclid distances for new config
-				vector< vector<double> > newEuclid = linearCalc.calculateEuclidianDistance(endConfig);
-				if (m->getControl_pressed()) { out.close(); out2.close(); for (int k = 0; k < outputNames.size(); k++) {	util.mothurRemove(outputNames[k]);	} return 0; }
-				
-				//calc correlation between original distances and euclidean distances from this config
-				double rsquared = linearCalc.calcPearson(newEuclid, matrix);
-				rsquared *= rsquared;
-				if (m->getControl_pressed()) { out.close(); out2.close(); for (int k = 0; k < outputNames.size(); k++) {	util.mothurRemove(outputNames[k]);	} return 0; }
-				
-				//output results
-				out << "Config" << (j+1);
-				for (int k = 0; k < i; k++) { out  << '\t' << "axis" << (k+1); }
-				out << endl;
-				out2 << i << '\t' << (j+1) << '\t' << stress << '\t' << rsquared << endl;
-				
-				output(endConfig, names, out);
-				
-				//save best
-				if (stress < bestStress) {
-					bestDim = i;
-					bestStress = stress;
-					bestR2 = rsquared;
-					bestConfig = endConfig;
-				}
-				
-				if (m->getControl_pressed()) { out.close(); out2.close(); for (int k = 0; k < outputNames.size(); k++) {	util.mothurRemove(outputNames[k]);	} return 0; }
+			//output results
+			out << "Config" << (j+1);
+			for (int l = 0; l < i; l++) { out  << '\t' << "axis" << (l+1); }
+			out << endl;
+			out2 << i << '\t' << (j+1) << '\t' << runs[k].stress << '\t' << runs[k].rsquared << endl;
+			
+			output(runs[k].config, names, out);
+			
+			//save best, ties go to the earlier run
+			if (runs[k].stress < bestStress) {
+				bestDim = i;
+				bestStress = runs[k].stress;
+				bestR2 = runs[k].rsquared;
+				bestRun = k;
 			}
 		}
 		
+		vector< vector<double> > bestConfig;
+		if (bestRun != -1) { bestConfig = runs[bestRun].config; }
+		
 		out.close(); out2.close();
 		
 		//output best config
@@ -309,102 +302,226 @@ int NMDSCommand::execute(){
 	}
 }
 //**********************************************************************************************************************
-vector< vector<double> > NMDSCommand::nmdsCalc(vector< vector<double> >& matrix, vector< vector<double> >& config, double& stress1) {
-	try {
-		
-		vector< vector<double> > newConfig = config;
+//generate random config, values between -1 and 1 with precision 5. Points are stored contiguously, config[i*dimension+k]
+void generateStartingConfiguration(vector<double>& config, int numNames, int dimension, mt19937_64& engine) {
+	uniform_int_distribution<int> dis(0, 99999);
+	
+	//filled axis by axis to match the layout of the axes file
+	config.assign(numNames*dimension, 0.0);
+	for (int k = 0; k < dimension; k++) {
+		for (int i = 0; i < numNames; i++) {
+			//generate random int between 0 and 99999
+			int myrand = dis(engine);
+			
+			//generate random sign, if mysign is even then sign = positive, else sign = negative
+			int mysign = dis(engine);
+			if ((mysign % 2) == 0) { mysign = 1.0; }
+			else { mysign = -1.0; }
+			
+			config[i*dimension+k] = mysign * myrand / (float) 100000;
+		}
+	}
+}
+//**********************************************************************************************************************
+//fills the lower triangle of euclidean distances for config and returns the normalized stress against userDists
+double calcDistancesAndStress(vector<double>& config, vector<double>& userDists, vector<double>& dists, int numNames, int dimension) {
+	double rawStress = 0.0;
+	double denom = 0.0;
+	
+	long long index = 0;
+	for (int i = 0; i < numNames; i++) {
+		double* pointI = &config[i*dimension];
+		for (int j = 0; j < i; j++) {
+			double* pointJ = &config[j*dimension];
+			
+			double sum = 0.0;
+			for (int k = 0; k < dimension; k++) { sum += ((pointI[k] - pointJ[k]) * (pointI[k] - pointJ[k])); }
+			double dist = sqrt(sum);
+			dists[index] = dist;
+			
+			rawStress += ((userDists[index] - dist) * (userDists[index] - dist));
+			denom += (dist * dist);
+			index++;
+		}
+	}
+	
+	//normalize stress
+	double normStress = 0.0;
+	if ((rawStress != 0.0) && (denom != 0.0)) { normStress = sqrt((rawStress / denom)); }
+	
+	return normStress;
+}
+//**********************************************************************************************************************
+//majorization (guttman transform) without building the n x n B matrix. newConfig[j] = (colSum[j] * config[j] - sum_i b[i][j] * config[i]) / n
+vector< vector<double> > nmdsCalc(nmdsData* params, vector<double>& config, int dimension, double& stress1) {
+	int numNames = params->numNames;
+	vector<double>& userDists = *(params->userDists);
+	
+	vector<double> dists(userDists.size(), 0.0);
+	vector<double> newConfig(config.size(), 0.0);
+	vector<double> columnSums(numNames, 0.0);
+	
+	double stress2 = calcDistancesAndStress(config, userDists, dists, numNames, dimension);
+	stress1 = stress2 + 1.0 + params->epsilon;
+	
+	int count = 0;
+	while ((count < params->maxIters) && (abs(stress1 - stress2) > params->epsilon)) {
+		count++;
+		
+		stress1 = stress2;
+		
+		if (params->m->getControl_pressed()) { break; }
+		
+		std::fill(newConfig.begin(), newConfig.end(), 0.0);
+		std::fill(columnSums.begin(), columnSums.end(), 0.0);
+		
+		long long index = 0;
+		for (int i = 0; i < numNames; i++) {
+			double* pointI = &config[i*dimension];
+			double* newI = &newConfig[i*dimension];
+			for (int j = 0; j < i; j++) {
+				//eliminate divide by zero error
+				if (dists[index] != 0) {
+					double b = userDists[index] / dists[index];
+					columnSums[i] += b;
+					columnSums[j] += b;
+					
+					double* pointJ = &config[j*dimension];
+					double* newJ = &newConfig[j*dimension];
+					for (int k = 0; k < dimension; k++) {
+						newI[k] -= b * pointJ[k];
+						newJ[k] -= b * pointI[k];
+					}
+				}
+				index++;
+			}
+		}
 		
-		//calc euclid distances
-		vector< vector<double> > euclid = linearCalc.calculateEuclidianDistance(newConfig);
-		if (m->getControl_pressed()) { return newConfig; }		
+		for (int i = 0; i < numNames; i++) {
+			for (int k = 0; k < dimension; k++) {
+				newConfig[i*dimension+k] = (newConfig[i*dimension+k] + columnSums[i] * config[i*dimension+k]) * (1.0 / (double) numNames);
+			}
+		}
+		config.swap(newConfig);
 		
-		double stress2 = calculateStress(matrix, euclid);
-		stress1 = stress2 + 1.0 + epsilon;
+		stress2 = calcDistancesAndStress(config, userDists, dists, numNames, dimension);
+	}
+	
+	//return in axes by names form for output
+	vector< vector<double> > axes(dimension);
+	for (int k = 0; k < dimension; k++) {
+		axes[k].resize(numNames);
+		for (int i = 0; i < numNames; i++) { axes[k][i] = config[i*dimension+k]; }
+	}
+	
+	return axes;
+}
+//**********************************************************************************************************************
+void driverNMDS(nmdsData* params) {
+	try {
+		LinearAlgebra linearCalc;
+		vector<double> config;
 		
-		int count = 0;
-		while ((count < maxIters) && (abs(stress1 - stress2) > epsilon)) {
-			count++;
+		for (int k = params->start; k < params->end; k++) {
 			
-			stress1 = stress2;
+			if (params->m->getControl_pressed()) { break; }
 			
-			if (m->getControl_pressed()) { return newConfig; }
+			nmdsRun& run = (*params->runs)[k];
+			int dimension = run.dimension;
 			
-			vector< vector<double> > b; b.resize(euclid.size());
-			for (int i = 0; i < b.size(); i++) { b[i].resize(euclid[i].size(), 0.0); }
+			params->m->mothurOut("Processing Dimension: " + toString(dimension) + ", configuration " + toString(run.iter+1) + "\n");
 			
-			vector<double> columnSums; columnSums.resize(euclid.size(), 0.0);
-			for (int i = 0; i < euclid.size(); i++) {
-				for (int j = 0; j < euclid[i].size(); j++) {
-					//eliminate divide by zero error
-					if (euclid[i][j] != 0) { 
-						b[i][j] = matrix[i][j] / euclid[i][j];
-						columnSums[j] += b[i][j];
-						b[i][j] *= -1.0;
-					}
+			//get configuration - either randomly generate from this runs seed or resize to this dimension
+			if (params->axes->size() == 0) {
+				mt19937_64 engine(run.seed);
+				generateStartingConfiguration(config, params->numNames, dimension, engine);
+			}else {
+				config.assign(params->numNames*dimension, 0.0);
+				for (int l = 0; l < dimension; l++) {
+					for (int i = 0; i < params->numNames; i++) { config[i*dimension+l] = (*params->axes)[l][i]; }
 				}
 			}
 			
-			//put in diagonal sums
-			for (int i = 0; i < euclid.size(); i++) {  b[i][i] = columnSums[i]; }
-			
-			int numInLowerTriangle = matrix.size() * (matrix.size()-1) / 2.0;
-			double n = (1.0 + sqrt(1.0 + 8.0 * numInLowerTriangle)) / 2.0;
-			
-			//matrix mult
-			newConfig = linearCalc.matrix_mult(newConfig, b);
-			for (int i = 0; i < newConfig.size(); i++) {
-				for (int j = 0; j < newConfig[i].size(); j++) {
-					newConfig[i][j] *= (1.0 / n);
-				}
-			}
+			//calc nmds for this dimension
+			run.config = nmdsCalc(params, config, dimension, run.stress);
+			if (params->m->getControl_pressed()) { break; }
 			
-			euclid = linearCalc.calculateEuclidianDistance(newConfig);
+			//calc correlation between original distances and euclidean distances from this config
+			vector< vector<double> > newEuclid = linearCalc.calculateEuclidianDistance(run.config);
+			if (params->m->getControl_pressed()) { break; }
 			
-			stress2 = calculateStress(matrix, euclid);
+			double rsquared = linearCalc.calcPearson(newEuclid, *(params->matrix));
+			run.rsquared = rsquared * rsquared;
 		}
-		
-		return newConfig;
 	}
 	catch(exception& e) {
-		m->errorOut(e, "NMDSCommand", "generateStartingConfiguration");
+		params->m->errorOut(e, "NMDSCommand", "driverNMDS");
 		exit(1);
 	}
 }
-
 //**********************************************************************************************************************
-//generate random config
-vector< vector<double> > NMDSCommand::generateStartingConfiguration(int numNames, int dimension) {
+int NMDSCommand::createProcesses(vector< vector<double> >& matrix, vector< vector<double> >& axes, vector<nmdsRun>& runs) {
 	try {
-		vector< vector<double> > axes;  axes.resize(dimension);
-		for (int i = 0; i < axes.size(); i++) {  axes[i].resize(numNames); }
-		Utils util;
-		//generate random number between -1 and 1, precision 6
-		for (int i = 0; i < axes.size(); i++) {
-			for (int j = 0; j < axes[i].size(); j++) {
-				
-				if (m->getControl_pressed()) { return axes; }
-				
-				//generate random int between 0 and 99999
-                int myrand = util.getRandomIndex(99999);
-                
-				//generate random sign
-				int mysign = util.getRandomIndex(99999);
-				
-				//if mysign is even then sign = positive, else sign = negative
-				if ((mysign % 2) == 0) { mysign = 1.0; }
-				else { mysign = -1.0; }
-				
-				axes[i][j] = mysign * myrand / (float) 100000;
-			}
+		int numNames = matrix.size();
+		
+		//lower triangle of the users distances, shared by all the runs
+		vector<double> userDists;
+		userDists.reserve(((long long)numNames * (numNames-1)) / 2);
+		for (int i = 0; i < numNames; i++) {
+			for (int j = 0; j < i; j++) { userDists.push_back(matrix[i][j]); }
 		}
-
-		return axes;
+		
+		//higher dimensions take longer, so deal the runs out round robin and hand each processor its share as one block
+		int numRuns = runs.size();
+		int numProcs = processors;
+		if (numRuns < numProcs) { numProcs = numRuns; }
+		if (numProcs < 1) { return 0; }
+		
+		vector<int> order;
+		for (int p = 0; p < numProcs; p++) { for (int k = p; k < numRuns; k += numProcs) { order.push_back(k); } }
+		vector<nmdsRun> ordered;
+		for (int k = 0; k < order.size(); k++) { ordered.push_back(runs[order[k]]); }
+		
+		vector<linePair> lines;
+		int start = 0;
+		for (int p = 0; p < numProcs; p++) {
+			int num = (numRuns - p + numProcs - 1) / numProcs;
+			lines.push_back(linePair(start, start+num));
+			start += num;
+		}
+		
+		//create array of worker threads
+		vector<thread*> workerThreads;
+		vector<nmdsData*> data;
+		
+		//Lauch worker threads
+		for (int i = 1; i < numProcs; i++) {
+			nmdsData* dataBundle = new nmdsData(&matrix, &userDists, &axes, &ordered, lines[i].start, lines[i].end, maxIters, epsilon);
+			data.push_back(dataBundle);
+			workerThreads.push_back(new thread(driverNMDS, dataBundle));
+		}
+		
+		nmdsData* dataBundle = new nmdsData(&matrix, &userDists, &axes, &ordered, lines[0].start, lines[0].end, maxIters, epsilon);
+		driverNMDS(dataBundle);
+		delete dataBundle;
+		
+		for (int i = 0; i < workerThreads.size(); i++) {
+			workerThreads[i]->join();
+			delete data[i];
+			delete workerThreads[i];
+		}
+		
+		//put runs back in dimension, iter order
+		for (int k = 0; k < order.size(); k++) { runs[order[k]] = ordered[k]; }
+		
+		return 0;
 	}
 	catch(exception& e) {
-		m->errorOut(e, "NMDSCommand", "generateStartingConfiguration");
+		m->errorOut(e, "NMDSCommand", "createProcesses");
 		exit(1);
 	}
 }
+
 //**********************************************************************************************************************
 //normalize configuration
 int NMDSCommand::normalizeConfiguration(vector< vector<double> >& axes, int numNames, int dimension) {
@@ -441,53 +558,6 @@ int NMDSCommand::normalizeConfiguration(vector< vector<double> >& axes, int numN
 		exit(1);
 	}
 }
-//**********************************************************************************************************************
-//get configuration
-vector< vector<double> > NMDSCommand::getConfiguration(vector< vector<double> >& axes, int dimension) {
-	try {
-		vector< vector<double> > newAxes; newAxes.resize(dimension);
-		
-		for (int i = 0; i < dimension; i++) {
-			newAxes[i] = axes[i];
-		}
-				
-		return newAxes;
-	}
-	catch(exception& e) {
-		m->errorOut(e, "NMDSCommand", "getConfiguration");
-		exit(1);
-	}
-}
-//**********************************************************************************************************************
-//find raw stress, and normalize using
-double NMDSCommand::calculateStress(vector< vector<double> >& matrix, vector< vector<double> >& config) {
-	try {
-		double normStress = 0.0;
-		double denom = 0.0;
-		double rawStress = 0.0;
-		
-		//find raw stress
-		for (int i = 0; i < matrix.size(); i++) {
-			for (int j = 0; j < matrix[i].size(); j++) {
-				if (m->getControl_pressed()) { return normStress; }
-				
-				rawStress += ((matrix[i][j] - config[i][j]) * (matrix[i][j] - config[i][j]));
-				denom += (config[i][j] * config[i][j]);
-			}
-		}
-		
-		//normalize stress
-		if ((rawStress != 0.0) && (denom != 0.0)) {
-			normStress = sqrt((rawStress / denom));
-		}
-
-		return normStress;
-	}
-	catch(exception& e) {
-		m->errorOut(e, "NMDSCommand", "calculateStress");
-		exit(1);
-	}
-}
 
 //**********************************************************************************************************************
 int NMDSCommand::output(vector< vector<double> >& config, vector<string>& names, ofstream& out) {
@@ -26,6 +26,16 @@
  
  */
 
+/*****************************************************************/
+//one random start (or the users axes) at one dimension
+struct nmdsRun {
+	int dimension, iter;
+	unsigned long long seed;
+	double stress, rsquared;
+	vector< vector<double> > config; //final configuration [dimension][numNames]
+	
+	nmdsRun(int d, int i, unsigned long long s) : dimension(d), iter(i), seed(s), stress(0.0), rsquared(0.0) {}
+};
 /*****************************************************************/
 class NMDSCommand : public Command {
 	
@@ -50,20 +60,41 @@ private:
 	
 	bool abort;
 	string phylipfile, outputDir, axesfile;
-	int maxdim, mindim, maxIters, iters;
+	int maxdim, mindim, maxIters, iters, processors;
 	double epsilon;
 	vector<string> outputNames;
 	LinearAlgebra linearCalc;
 	
-	vector< vector<double> > nmdsCalc(vector< vector<double> >&, vector< vector<double> >&, double&);
-	vector< vector<double> > getConfiguration(vector< vector<double> >&, int);
-	vector< vector<double> > generateStartingConfiguration(int, int); //pass in numNames, return axes
+	int createProcesses(vector< vector<double> >&, vector< vector<double> >&, vector<nmdsRun>&); //distances, axes, runs
 	int normalizeConfiguration(vector< vector<double> >&, int, int);
-	double calculateStress(vector< vector<double> >&, vector< vector<double> >&);
 	vector< vector<double> > readAxes(vector<string>);
 	int output(vector< vector<double> >&, vector<string>&, ofstream&);	
 };
 
+/*****************************************************************/
+struct nmdsData {
+	vector< vector<double> >* matrix; //users distances
+	vector<double>* userDists; //lower triangle of matrix
+	vector< vector<double> >* axes; //starting configuration if the user gave one
+	vector<nmdsRun>* runs;
+	int start, end, numNames, maxIters;
+	double epsilon;
+	MothurOut* m;
+	
+	nmdsData(){}
+	nmdsData(vector< vector<double> >* mat, vector<double>* ud, vector< vector<double> >* ax, vector<nmdsRun>* r, int st, int en, int mi, double ep) {
+		m = MothurOut::getInstance();
+		matrix = mat;
+		userDists = ud;
+		axes = ax;
+		runs = r;
+		start = st;
+		end = en;
+		numNames = matrix->size();
+		maxIters = mi;
+		epsilon = ep;
+	}
+};
 /*****************************************************************/
 
 #endif
@@ -234,10 +234,7 @@ int PairwiseSeqsCommand::execute(){
 			
 			if (outputDir == "") {  outputDir += util.hasPath(fastaFileNames[s]); }
 			
-			ifstream inFASTA;
-			util.openInputFile(fastaFileNames[s], inFASTA);
-			alignDB = SequenceDB(inFASTA); 
-			inFASTA.close();
+			alignDB = SequenceDB(fastaFileNames[s]);
 			
 			int numSeqs = alignDB.getNumSeqs();
 			int startTime = time(NULL);
@@ -18,6 +18,7 @@ vector<string> PCACommand::setParameters(){
 		CommandParameter pgroups("groups", "String", "", "", "", "", "","",false,false); parameters.push_back(pgroups);
 		CommandParameter pmetric("metric", "Boolean", "", "T", "", "", "","",false,false); parameters.push_back(pmetric);
 		CommandParameter plabel("label", "String", "", "", "", "", "","",false,false); parameters.push_back(plabel);
+		CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
 		CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
@@ -35,10 +36,11 @@ vector<string> PCACommand::setParameters(){
 string PCACommand::getHelpString(){	
 	try {
 		string helpString = "";
-		helpString += "The pca command parameters are shared, relabund, label, groups and metric.  shared or relabund is required unless you have a valid current file."; 
+		helpString += "The pca command parameters are shared, relabund, label, groups, metric and processors.  shared or relabund is required unless you have a valid current file."; 
 		helpString += "The label parameter is used to analyze specific labels in your input. Default is the first label in your shared or relabund file. Multiple labels may be separated by dashes.\n";
 		helpString += "The groups parameter allows you to specify which groups you would like analyzed. Groupnames are separated by dashes.\n";
 		helpString += "The metric parameter allows you to indicate if would like the pearson correlation coefficient calculated. Default=True";
+		helpString += "The processors parameter allows you to specify how many processors you would like to use for the matrix multiplications.  The default is 1. \n";
 		helpString += "Example pca(groups=yourGroups).\n";
 		helpString += "Example pca(groups=A-B-C).\n";
 		
@@ -168,6 +170,10 @@ PCACommand::PCACommand(string option)  {
 			string temp = validParameter.valid(parameters, "metric");	if (temp == "not found"){	temp = "T";				}
 			metric = util.isTrue(temp); 
 			
+			temp = validParameter.valid(parameters, "processors");	if (temp == "not found"){	temp = current->getProcessors();	}
+			processors = current->setProcessors(temp);
+			linearCalc.setProcessors(processors);
+			
 			label = validParameter.valid(parameters, "label");			
 			if (label == "not found") { label = ""; if(labels.size() == 0) {  m->mothurOut("You did not provide a label, I will use the first label in your inputfile."); m->mothurOutEndLine(); } }
 			else { util.splitAtDash(label, labels); }
@@ -328,17 +334,15 @@ int PCACommand::process(SharedRAbundFloatVectors*& lookupFloat){
 		int numOTUs = lookupFloat->getNumBins();
 		int numSamples = lookupFloat->getNumGroups();
 		
-		vector< vector<double> > matrix(numSamples);
+		DenseMatrix centered(numSamples, numOTUs);
 		vector<double> colMeans(numOTUs);
 		
 		//fill matrix with shared relative abundances, re-center
         vector<SharedRAbundFloatVector*> data = lookupFloat->getSharedRAbundFloatVectors();
 		for (int i = 0; i < numSamples; i++) {
-			matrix[i].resize(numOTUs, 0);
-			
 			for (int j = 0; j < numOTUs; j++) {
-				matrix[i][j] = data[i]->get(j);
-				colMeans[j] += matrix[i][j];
+				centered(i, j) = data[i]->get(j);
+				colMeans[j] += centered(i, j);
 			}
             delete data[i];
 		}
@@ -348,24 +352,14 @@ int PCACommand::process(SharedRAbundFloatVectors*& lookupFloat){
 			colMeans[j] = colMeans[j] / (double)numSamples;
 		}
 		
-		vector<vector<double> > centered = matrix;
 		for(int i=0;i<numSamples;i++){
+			double* row = centered.getRow(i);
 			for(int j=0;j<numOTUs;j++){
-				centered[i][j] = centered[i][j] - colMeans[j];				
-			}
-		}
-
-		
-		vector< vector<double> > transpose(numOTUs);
-		for (int i = 0; i < numOTUs; i++) {
-			transpose[i].resize(numSamples, 0);
-			
-			for (int j = 0; j < numSamples; j++) {
-				transpose[i][j] = centered[j][i];
+				row[j] = row[j] - colMeans[j];
 			}
 		}
 
-		vector<vector<double> > crossProduct = linearCalc.matrix_mult(transpose, centered);	
+		DenseMatrix crossProduct = linearCalc.matrix_mult(centered.transpose(), centered);
 		
 		vector<double> d;
 		vector<double> e;
@@ -373,7 +367,7 @@ int PCACommand::process(SharedRAbundFloatVectors*& lookupFloat){
 		linearCalc.tred2(crossProduct, d, e);		if (m->getControl_pressed()) { return 0; }
 		linearCalc.qtli(d, e, crossProduct);		if (m->getControl_pressed()) { return 0; }
 		
-		vector<vector<double> > X = linearCalc.matrix_mult(centered, crossProduct);
+		DenseMatrix X = linearCalc.matrix_mult(centered, crossProduct);
 		
 		if (m->getControl_pressed()) { return 0; }
 		
@@ -383,7 +377,8 @@ int PCACommand::process(SharedRAbundFloatVectors*& lookupFloat){
 		
 		if (metric) {   
 			
-			vector<vector<double> > observedEuclideanDistance = linearCalc.getObservedEuclideanDistance(centered);
+			vector<vector<double> > centeredVector = centered.toVector();
+			vector<vector<double> > observedEuclideanDistance = linearCalc.getObservedEuclideanDistance(centeredVector);
 			
 			for (int i = 1; i < 4; i++) {
 				
@@ -408,7 +403,7 @@ int PCACommand::process(SharedRAbundFloatVectors*& lookupFloat){
 }
 /*********************************************************************************************************************************/
 
-void PCACommand::output(string fbase, string label, vector<string> name_list, vector<vector<double> >& G, vector<double> d) {
+void PCACommand::output(string fbase, string label, vector<string> name_list, DenseMatrix& G, vector<double> d) {
 	try {
 
 		int numEigenValues = d.size();
@@ -449,7 +444,7 @@ void PCACommand::output(string fbase, string label, vector<string> name_list, ve
 		
 		for(int i=0;i<name_list.size();i++){
 			pcaData << name_list[i];
-			for(int j=0;j<numEigenValues;j++){  pcaData << '\t' << G[i][j];  }
+			for(int j=0;j<numEigenValues;j++){  pcaData << '\t' << G(i, j);  }
 			pcaData << endl;
 		}
 	}
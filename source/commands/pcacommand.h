@@ -39,6 +39,7 @@ public:
 private:
 
 	bool abort, metric;
+	int processors;
 	string outputDir, mode, inputFile, label, groups, sharedfile, relabundfile;
 	vector<string> outputNames, Groups;
 	set<string> labels;
@@ -46,7 +47,7 @@ private:
 	
 	//vector< vector<double> > createMatrix(vector<SharedRAbundFloatVector*>);
 	int process(SharedRAbundFloatVectors*&);
-	void output(string, string, vector<string>, vector<vector<double> >&, vector<double>);
+	void output(string, string, vector<string>, DenseMatrix&, vector<double>);
 	
 };
 
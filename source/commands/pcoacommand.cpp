@@ -171,13 +171,13 @@ int PCOACommand::execute(){
 		double offset = 0.0000;
 		vector<double> d;
 		vector<double> e;
-		vector<vector<double> > G = D;
-		//vector<vector<double> > copy_G;
+		DenseMatrix distances(D);
+		DenseMatrix G;
 				
 		m->mothurOut("\nProcessing...\n");
 		
 		for(int count=0;count<2;count++){
-			linearCalc.recenter(offset, D, G);		if (m->getControl_pressed()) { return 0; }
+			linearCalc.recenter(offset, distances, G);		if (m->getControl_pressed()) { return 0; }
 			linearCalc.tred2(G, d, e);				if (m->getControl_pressed()) { return 0; }
 			linearCalc.qtli(d, e, G);				if (m->getControl_pressed()) { return 0; }
 			offset = d[d.size()-1];
@@ -231,15 +231,15 @@ void PCOACommand::get_comment(istream& f, char begin, char end){
 }	
 /*********************************************************************************************************************************/
 
-void PCOACommand::output(string fnameRoot, vector<string> name_list, vector<vector<double> >& G, vector<double> d) {
+void PCOACommand::output(string fnameRoot, vector<string> name_list, DenseMatrix& G, vector<double> d) {
 	try {
 		int rank = name_list.size();
 		double dsum = 0.0000;
 		for(int i=0;i<rank;i++){
 			dsum += d[i];
 			for(int j=0;j<rank;j++){
-				if(d[j] >= 0)	{	G[i][j] *= pow(d[j],0.5);	}
-				else			{	G[i][j] = 0.00000;			}
+				if(d[j] >= 0)	{	G(i, j) *= pow(d[j],0.5);	}
+				else			{	G(i, j) = 0.00000;			}
 			}
 		}
 		
@@ -275,7 +275,7 @@ void PCOACommand::output(string fnameRoot, vector<string> name_list, vector<vect
 		for(int i=0;i<rank;i++){
 			pcaData << name_list[i];
 			for(int j=0;j<rank;j++){
-				pcaData  << '\t' << G[i][j];
+				pcaData  << '\t' << G(i, j);
 			}
 			pcaData << endl;
 		}
@@ -42,7 +42,7 @@ private:
 	LinearAlgebra linearCalc;
 	
 	void get_comment(istream&, char, char);
-	void output(string, vector<string>, vector<vector<double> >&, vector<double>);
+	void output(string, vector<string>, DenseMatrix&, vector<double>);
 	
 };
 	
@@ -432,240 +432,182 @@ int PhyloDiversityCommand::execute(){
 }
 
 //**********************************************************************************************************************
-//need a vector of floats one branch length for every group the node represents.
-vector<float> calcBranchLength(Tree* t, int leaf, vector< map<string, bool> >& counted, map<string, int> roots, MothurOut* m){
-    try {
-        
-        //calc the branch length
-        //while you aren't at root
-        vector<float> sums;
-        int index = leaf;
-        
-        vector<string> groups = t->tree[leaf].getGroup();
-        sums.resize(groups.size(), 0.0);
-        
-        
-        //you are a leaf
-        if(t->tree[index].getBranchLength() != -1){
-            for (int k = 0; k < groups.size(); k++) {
-                sums[k] += abs(t->tree[index].getBranchLength());
-            }
+/***********************************************************************/
+//flat copy of the parts of the tree the randomizations need, built once and shared by the threads.
+//A group's "root" is the highest node with descendants from the group in both children, branches above it aren't counted.
+struct phylodivIndex {
+    int numNodes;
+    vector<int> parent;
+    vector<float> branchLength; //absolute value, 0 if the node has no branch length
+    vector<int> groupRoot; //indexed by the users groups
+    vector< vector< pair<int, int> > > leafGroups; //leaf -> users groups it contains and the number of seqs from each
+    
+    phylodivIndex(Tree* t, vector<string> Groups, MothurOut* m) {
+        numNodes = t->getNumNodes();
+        parent.resize(numNodes, -1);
+        branchLength.resize(numNodes, 0.0);
+        for (int i = 0; i < numNodes; i++) {
+            parent[i] = t->tree[i].getParent();
+            float length = t->tree[i].getBranchLength();
+            if (length != -1) { branchLength[i] = abs(length); }
         }
         
+        map<string, int> groupIndex;
+        for (int j = 0; j < Groups.size(); j++) { groupIndex[Groups[j]] = j; }
         
-        index = t->tree[index].getParent();
-        
-        //while you aren't at root
-        while(t->tree[index].getParent() != -1){
-            
-            if (m->getControl_pressed()) {  return sums; }
-            
+        //the root starts at the group's first leaf
+        groupRoot.resize(Groups.size(), -1);
+        leafGroups.resize(t->getNumLeaves());
+        for (int i = 0; i < t->getNumLeaves(); i++) {
+            vector<string> groups = t->tree[i].getGroup();
             for (int k = 0; k < groups.size(); k++) {
+                map<string, int>::iterator itIndex = groupIndex.find(groups[k]);
+                if (itIndex == groupIndex.end()) { continue; }
                 
-                if (index >= roots[groups[k]]) { counted[index][groups[k]] = true; } //if you are at this groups "root", then say we are done
+                int numSeqs = 0;
+                map<string, int>::iterator it = t->tree[i].pcount.find(groups[k]);
+                if (it != t->tree[i].pcount.end()) { numSeqs = it->second; }
+                leafGroups[i].push_back(pair<int, int>(itIndex->second, numSeqs));
                 
-                if (!counted[index][groups[k]]){ //if counted[index][groups[k] is true this groups has already added all br from here to root, so quit early
-                    if (t->tree[index].getBranchLength() != -1) {
-                        sums[k] += abs(t->tree[index].getBranchLength());
-                    }
-                    counted[index][groups[k]] = true;
-                }
+                if (groupRoot[itIndex->second] == -1) { groupRoot[itIndex->second] = i; }
             }
-            index = t->tree[index].getParent();
         }
         
-        return sums;
-        
-    }
-    catch(exception& e) {
-        m->errorOut(e, "PhyloDiversityCommand", "calcBranchLength");
-        exit(1);
-    }
-}
-//**********************************************************************************************************************
-map<string, int> getRootForGroups(Tree* t, MothurOut* m){
-    try {
-        map<string, int> roots; //maps group to root for group, may not be root of tree
-        map<string, bool> done;
-        
-        //initialize root for all groups to -1
-        for (int k = 0; k < (t->getCountTable())->getNamesOfGroups().size(); k++) { done[(t->getCountTable())->getNamesOfGroups()[k]] = false; }
-        
-        for (int i = 0; i < t->getNumLeaves(); i++) {
+        //then moves to the highest node below the tree's root that has the group in both children
+        for (int i = t->getNumLeaves(); i < numNodes; i++) {
+            if (m->getControl_pressed()) { break; }
+            if (parent[i] == -1) { continue; }
             
-            vector<string> groups = t->tree[i].getGroup();
-            
-            int index = t->tree[i].getParent();
+            int lc = t->tree[i].getLChild();
+            int rc = t->tree[i].getRChild();
+            if ((lc == -1) || (rc == -1)) { continue; }
             
-            for (int j = 0; j < groups.size(); j++) {
+            for (map<string, int>::iterator it = t->tree[lc].pcount.begin(); it != t->tree[lc].pcount.end(); it++) {
+                map<string, int>::iterator itIndex = groupIndex.find(it->first);
+                if (itIndex == groupIndex.end()) { continue; }
                 
-                if (done[groups[j]] == false) { //we haven't found the root for this group yet, initialize it
-                    done[groups[j]] = true;
-                    roots[groups[j]] = i; //set root to self to start
-                }
-                
-                //while you aren't at root
-                while(t->tree[index].getParent() != -1){
-                    
-                    if (m->getControl_pressed()) {  return roots; }
-                    
-                    //do both your chidren have have descendants from the users groups?
-                    int lc = t->tree[index].getLChild();
-                    int rc = t->tree[index].getRChild();
-                    
-                    int LpcountSize = 0;
-                    map<string, int>:: iterator itGroup = t->tree[lc].pcount.find(groups[j]);
-                    if (itGroup != t->tree[lc].pcount.end()) { LpcountSize++;  }
-                    
-                    int RpcountSize = 0;
-                    itGroup = t->tree[rc].pcount.find(groups[j]);
-                    if (itGroup != t->tree[rc].pcount.end()) { RpcountSize++;  }
-                    
-                    if ((LpcountSize != 0) && (RpcountSize != 0)) { //possible root
-                        if (index > roots[groups[j]]) {  roots[groups[j]] = index; }
-                    }else { ;}
-                    
-                    index = t->tree[index].getParent();
+                if (t->tree[rc].pcount.count(it->first) != 0) {
+                    if (i > groupRoot[itIndex->second]) { groupRoot[itIndex->second] = i; }
                 }
             }
         }
-        
-        return roots;
-        
     }
-    catch(exception& e) {
-        m->errorOut(e, "PhyloDiversityCommand", "getRootForGroups");
-        exit(1);
+    
+    //branch length added to the group by sampling the leaf. visited marks the nodes already counted for the group in this
+    //iteration, every node above a visited node was counted with it, so only the new branches are walked.
+    float addLeaf(int leaf, int group, vector<int>& visited, int iteration) {
+        int* seen = &visited[(long long)group*numNodes];
+        float sum = branchLength[leaf];
+        
+        int index = parent[leaf];
+        while ((index != -1) && (parent[index] != -1) && (seen[index] != iteration)) {
+            if (index < groupRoot[group]) { sum += branchLength[index]; }
+            seen[index] = iteration;
+            index = parent[index];
+        }
+        
+        return sum;
     }
-}
+};
 /***********************************************************************/
 struct phylodivData {
-    int numIters;
+    int start, numIters;
     MothurOut* m;
-    map< string, vector<float> > div;
-    map<string, vector<float> > sumDiv;
-    vector< vector<int> > randomLeaf; //each iters randomized nodes
-    set<int> numSampledList;
-    int increment, subsampleSize;
-    string collectName, sumName;
-    Tree* t;
-    CountTable* ct;
-    bool includeRoot, subsample, rarefy, collect, summary, doCollect, doSum, scale;
-    Utils util;
-    vector<string> Groups;
-    
+    phylodivIndex* index;
+    vector< vector<float> > firstDiv; //diversity of the first iteration, for the collect and summary files
+    vector< vector<double> > sumDiv;
+    vector<int> randomLeaf;
+    vector<unsigned long long> seeds; //one per iteration
+    vector<int> groupSizes;
+    int subsampleSize;
+    bool subsample, rarefy, keepFirst;
     
     phylodivData(){}
-    phylodivData(int ni,  map< string, vector<float> > cd, map< string, vector<float> > csd, Tree* tree, CountTable* count, int incre, vector< vector<int> > crl, set<int> nsl, bool su, int suS, vector<string> gps, bool ds, bool dc, bool rar, bool sc, string coln, string sumn) {
+    phylodivData(int st, int ni, phylodivIndex* ind, vector<int> rl, vector<unsigned long long> se, vector<int> gs, bool su, int suS, bool rar, bool kf) {
         m = MothurOut::getInstance();
-        t = tree;
-        ct = count;
-        div = cd;
+        start = st;
         numIters = ni;
-        sumDiv = csd;
-        increment = incre;
-        randomLeaf = crl;
-        numSampledList = nsl;
+        index = ind;
+        randomLeaf = rl;
+        seeds = se;
+        groupSizes = gs;
         subsample = su;
         subsampleSize = suS;
-        Groups = gps;
-        doSum = ds;
-        doCollect = dc;
-        collect = false;
-        collectName = coln; if (coln != "") { collect = true; }
-        summary = false;
-        sumName = sumn; if (sumn != "") { summary = true; }
         rarefy = rar;
-        scale = sc;
+        keepFirst = kf;
+        
+        for (int j = 0; j < groupSizes.size(); j++) { sumDiv.push_back(vector<double>(groupSizes[j]+1, 0.0)); }
     }
 };
 //**********************************************************************************************************************
 int driverPhylo(phylodivData* params){
 	try {
-		int numLeafNodes = params->randomLeaf[0].size();
+        phylodivIndex* index = params->index;
+		int numLeafNodes = params->randomLeaf.size();
+        int numGroups = params->groupSizes.size();
         
-        map<string, int> rootForGroup = getRootForGroups(params->t, params->m); //maps groupName to root node in tree. "root" for group may not be the trees root and we don't want to include the extra branches.
+        vector< vector<float> > div(numGroups);
+        for (int j = 0; j < numGroups; j++) { div[j].resize(params->groupSizes[j]+1, 0.0); }
         
+        vector<int> visited((long long)numGroups*index->numNodes, 0);
+        vector<int> counts(numGroups, 0);
+        vector<bool> metCount(numGroups, false);
+        vector<int> thisItersRandomLeaves;
         
-		for (int l = 0; l < params->numIters; l++) {
-            vector<int> thisItersRandomLeaves = params->randomLeaf[l];
+		for (int l = params->start; l < (params->start+params->numIters); l++) {
             
-            //initialize counts
-            map<string, int> counts;
-            vector< map<string, bool> > countedBranch;
-            for (int i = 0; i < params->t->getNumNodes(); i++) {
-                map<string, bool> temp;
-                for (int j = 0; j < params->Groups.size(); j++) { temp[params->Groups[j]] = false; }
-                countedBranch.push_back(temp);
-            }
+            //each iteration has its own random stream, so the results don't depend on the number of processors
+            mt19937_64 engine(params->seeds[l]);
+            thisItersRandomLeaves = params->randomLeaf;
+            shuffle(thisItersRandomLeaves.begin(), thisItersRandomLeaves.end(), engine);
             
-            for (int j = 0; j < params->Groups.size(); j++) {  counts[params->Groups[j]] = false;   }
+            int iteration = l - params->start + 1;
+            counts.assign(numGroups, 0);
+            metCount.assign(numGroups, false);
+            int numMet = 0; bool allDone = false;
             
-            map<string, int> metCount; bool allDone = false;
             for(int k = 0; k < numLeafNodes; k++){
                 
                 if (params->m->getControl_pressed()) { return 0; }
                 
-                //calc branch length of randomLeaf k
-                vector<float> br = calcBranchLength(params->t, thisItersRandomLeaves[k], countedBranch, rootForGroup, params->m);
-                
-                //for each group in the groups update the total branch length accounting for the names file
-                vector<string> groups = params->t->tree[thisItersRandomLeaves[k]].getGroup();
+                int leaf = thisItersRandomLeaves[k];
+                vector< pair<int, int> >& groups = index->leafGroups[leaf];
                 
                 for (int j = 0; j < groups.size(); j++) {
+                    int group = groups[j].first;
+                    int numSeqsInGroupJ = groups[j].second;
+                    vector<float>& groupDiv = div[group];
+                    
+                    float br = index->addLeaf(leaf, group, visited, iteration);
                     
-                    if (params->util.inUsersGroups(groups[j], params->Groups)) {
-                        int numSeqsInGroupJ = 0;
-                        map<string, int>::iterator it;
-                        it = params->t->tree[thisItersRandomLeaves[k]].pcount.find(groups[j]);
-                        if (it != params->t->tree[thisItersRandomLeaves[k]].pcount.end()) { //this leaf node contains seqs from group j
-                            numSeqsInGroupJ = it->second;
-                        }
-                        
-                        if (numSeqsInGroupJ != 0) {	params->div[groups[j]][(counts[groups[j]]+1)] = params->div[groups[j]][counts[groups[j]]] + br[j];  }
-                        
-                        for (int s = (counts[groups[j]]+2); s <= (counts[groups[j]]+numSeqsInGroupJ); s++) {
-                            params->div[groups[j]][s] = params->div[groups[j]][s-1];  //update counts, but don't add in redundant branch lengths
-                        }
-                        counts[groups[j]] += numSeqsInGroupJ;
-                        if (params->subsample) {
-                            if (counts[groups[j]] >= params->subsampleSize) { metCount[groups[j]] = true; }
-                            bool allTrue = true;
-                            for (int h = 0; h < params->Groups.size(); h++) { if (!metCount[params->Groups[h]]) { allTrue = false; } }
-                            
-                            if (allTrue) { allDone = true; }
-                        }
-                        if (allDone) { j+=groups.size(); k+=numLeafNodes; }
+                    if (numSeqsInGroupJ != 0) {	groupDiv[counts[group]+1] = groupDiv[counts[group]] + br;  }
+                    
+                    for (int s = (counts[group]+2); s <= (counts[group]+numSeqsInGroupJ); s++) {
+                        groupDiv[s] = groupDiv[s-1];  //update counts, but don't add in redundant branch lengths
+                    }
+                    counts[group] += numSeqsInGroupJ;
+                    
+                    if (params->subsample) {
+                        if ((counts[group] >= params->subsampleSize) && (!metCount[group])) { metCount[group] = true; numMet++; }
+                        if (numMet == numGroups) { allDone = true; break; }
                     }
                 }
+                if (allDone) { break; }
             }
             
             //if you subsample then rarefy=t
             if (params->rarefy) {
                 //add this diversity to the sum
-                for (int j = 0; j < params->Groups.size(); j++) {
-                    for (int g = 0; g < params->div[params->Groups[j]].size(); g++) {
-                        params->sumDiv[params->Groups[j]][g] += params->div[params->Groups[j]][g];
-                    }
+                for (int j = 0; j < numGroups; j++) {
+                    for (int g = 0; g < div[j].size(); g++) { params->sumDiv[j][g] += div[j][g]; }
                 }
             }
             
-            if ((params->collect) && params->doCollect) {
-                ofstream outCollect; params->util.openOutputFile(params->collectName, outCollect);
-                printData(params->numSampledList, params->div, outCollect, 1, params->Groups, params->scale);
-                params->doCollect = false;
-            }
-            if ((params->summary) && params->doSum) {
-                ofstream outSum; params->util.openOutputFile(params->sumName, outSum);
-                printSumData(params->div, outSum, 1, params->Groups, params->subsampleSize, params->subsample, params->scale);
-                params->doSum = false;
-            }
+            if (params->keepFirst && (l == params->start)) { params->firstDiv = div; }
             
             if((l+1) % 100 == 0){	params->m->mothurOutJustToScreen(toString(l+1)+"\n"); 		}
         }
        
-        if((params->numIters) % 100 != 0){	params->m->mothurOutJustToScreen(toString(params->numIters)+"\n"); 		}
-        
         return 0;
 	}
 	catch(exception& e) {
@@ -676,14 +618,26 @@ int driverPhylo(phylodivData* params){
 //**********************************************************************************************************************
 int PhyloDiversityCommand::createProcesses(Tree* t, CountTable* ct, map< string, vector<float> >& div, map<string, vector<float> >& sumDiv, int numIters, int increment, vector<int>& randomLeaf, set<int>& numSampledList, string outCollect, string outSum){
     try {
-        vector<string> Treenames = t->getTreeNames();
-        vector<int> procIters;
-        if (iters < processors) { iters = processors;  }
-        int numItersPerProcessor = iters / processors;
+        phylodivIndex index(t, Groups, m);
+        
+        if (m->getControl_pressed()) { return 0; }
+        
+        vector<int> groupSizes;
+        for (int j = 0; j < Groups.size(); j++) { groupSizes.push_back(div[Groups[j]].size()-1); }
+        
+        vector<unsigned long long> seeds;
+        for (int l = 0; l < numIters; l++) { seeds.push_back((unsigned long long)util.getRandomNumber()); }
+        
+        int numThreads = processors;
+        if (numIters < numThreads) { numThreads = numIters; }
+        if (numThreads < 1) { numThreads = 1; }
         
         //divide iters between processes
-        for (int h = 0; h < processors; h++) {
-            if(h == processors - 1){ numItersPerProcessor = iters - h * numItersPerProcessor; }
+        vector<int> startIters, procIters;
+        int numItersPerProcessor = numIters / numThreads;
+        for (int h = 0; h < numThreads; h++) {
+            startIters.push_back(h * numItersPerProcessor);
+            if(h == numThreads - 1){ numItersPerProcessor = numIters - h * numItersPerProcessor; }
             procIters.push_back(numItersPerProcessor);
         }
         
@@ -691,64 +645,47 @@ int PhyloDiversityCommand::createProcesses(Tree* t, CountTable* ct, map< string,
         vector<thread*> workerThreads;
         vector<phylodivData*> data;
         
-        //Lauch worker threads
-        vector<int> origRandomLeaf = randomLeaf;
-        for (int i = 0; i < processors-1; i++) {
-            
-            //create randomize randomLeaf for each iter
-            vector< vector<int> > thisRandomLeaf;
-            for (int j = 0; j < procIters[i+1]; j++) {
-                randomLeaf = origRandomLeaf;
-                util.mothurRandomShuffle(randomLeaf);
-                thisRandomLeaf.push_back(randomLeaf);
-            }
-
-            CountTable* copyCount = new CountTable();
-            copyCount->copy(ct);
-            Tree* copyTree = new Tree(copyCount, Treenames);
-            copyTree->getCopy(t);
-            
-            phylodivData* dataBundle = new phylodivData(procIters[i+1], div, sumDiv, copyTree, copyCount, increment, thisRandomLeaf, numSampledList, subsample, subsampleSize, Groups, false, false, rarefy, scale, "", "");
-            
+        //Lauch worker threads, the index is read only so they can share it
+        for (int i = 0; i < numThreads-1; i++) {
+            phylodivData* dataBundle = new phylodivData(startIters[i+1], procIters[i+1], &index, randomLeaf, seeds, groupSizes, subsample, subsampleSize, rarefy, false);
             data.push_back(dataBundle);
-
             workerThreads.push_back(new thread(driverPhylo, dataBundle));
         }
         
-        vector< vector<int> > thisRandomLeaf;
-        for (int j = 0; j < procIters[0]; j++) {
-            randomLeaf = origRandomLeaf;
-            util.mothurRandomShuffle(randomLeaf);
-            thisRandomLeaf.push_back(randomLeaf);
-        }
-        
-        CountTable* copyCount = new CountTable();
-        copyCount->copy(ct);
-        Tree* copyTree = new Tree(copyCount, Treenames);
-        copyTree->getCopy(t);
-        
-        phylodivData* dataBundle = new phylodivData(procIters[0], div, sumDiv, copyTree, copyCount, increment, thisRandomLeaf, numSampledList, subsample, subsampleSize, Groups, true, true, rarefy, scale, outCollect, outSum);
-        
+        phylodivData* dataBundle = new phylodivData(startIters[0], procIters[0], &index, randomLeaf, seeds, groupSizes, subsample, subsampleSize, rarefy, true);
         driverPhylo(dataBundle);
-        sumDiv = dataBundle->sumDiv;
         
-        delete copyTree; delete copyCount;
+        vector< vector<double> > totals = dataBundle->sumDiv;
         
-        for (int i = 0; i < processors-1; i++) {
+        for (int i = 0; i < workerThreads.size(); i++) {
             workerThreads[i]->join();
             
-            for (map<string, vector<float> >::iterator itSum = data[i]->sumDiv.begin(); itSum != data[i]->sumDiv.end(); itSum++) {
-                for (int k = 0; k < (itSum->second).size(); k++) {
-                    sumDiv[itSum->first][k] += (itSum->second)[k];
-                }
+            for (int j = 0; j < totals.size(); j++) {
+                for (int k = 0; k < totals[j].size(); k++) { totals[j][k] += data[i]->sumDiv[j][k]; }
             }
-            delete data[i]->t; delete data[i]->ct;
             delete data[i];
             delete workerThreads[i];
         }
         
+        if((numIters) % 100 != 0){	m->mothurOutJustToScreen(toString(numIters)+"\n"); 		}
+        
+        for (int j = 0; j < Groups.size(); j++) {
+            for (int k = 0; k < totals[j].size(); k++) { sumDiv[Groups[j]][k] = totals[j][k]; }
+            if (dataBundle->firstDiv.size() != 0) { div[Groups[j]] = dataBundle->firstDiv[j]; }
+        }
         delete dataBundle;
         
+        if (m->getControl_pressed()) { return 0; }
+        
+        if (collect) {
+            ofstream outCollectFile; util.openOutputFile(outCollect, outCollectFile);
+            printData(numSampledList, div, outCollectFile, 1, Groups, scale);
+        }
+        if (summary) {
+            ofstream outSumFile; util.openOutputFile(outSum, outSumFile);
+            printSumData(div, outSumFile, 1, Groups, subsampleSize, subsample, scale);
+        }
+        
         return 0;
     }
     catch(exception& e) {
@@ -757,6 +694,3 @@ int PhyloDiversityCommand::createProcesses(Tree* t, CountTable* ct, map< string,
     }
 }
 //**********************************************************************************************************************
-
-
-
@@ -282,10 +282,11 @@ int PhylotypeCommand::execute(){
 				for (itCurrent = currentNodes.begin(); itCurrent != currentNodes.end(); itCurrent++) {
 			
 					//get parents
-					TaxNode node = tree->get(itCurrent->first);
+					const TaxNode& node = tree->get(itCurrent->first);
 					parentNodes[node.parent] = node.parent;
 					
-					vector<string> names = node.accessions;
+					vector<string> names;
+					for (int i = 0; i < node.accessions.size(); i++) { names.push_back(tree->getSeqName(node.accessions[i])); }
 					
 					//make the names compatable with listvector
 					string name = "";
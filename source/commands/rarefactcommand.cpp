@@ -42,6 +42,8 @@ vector<string> RareFactCommand::setParameters(){
         CommandParameter palpha("alpha", "Multiple", "0-1-2", "1", "", "", "","",false,false,true); parameters.push_back(palpha);
 		CommandParameter pgroupmode("groupmode", "Boolean", "", "T", "", "", "","",false,false); parameters.push_back(pgroupmode);
 		CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
+        CommandParameter panalytic("analytic", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(panalytic);
+        CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
 		
@@ -59,13 +61,15 @@ string RareFactCommand::getHelpString(){
 	try {
 		ValidCalculators validCalculator;
 		string helpString = "";
-		helpString += "The rarefaction.single command parameters are list, sabund, rabund, shared, label, iters, freq, calc, groupmode, groups and abund.  list, sabund, rabund or shared is required unless you have a valid current file. \n";
+		helpString += "The rarefaction.single command parameters are list, sabund, rabund, shared, label, iters, freq, calc, groupmode, groups, analytic, processors and abund.  list, sabund, rabund or shared is required unless you have a valid current file. \n";
 		helpString += "The freq parameter is used indicate when to output your data, by default it is set to 100. But you can set it to a percentage of the number of sequence. For example freq=0.10, means 10%. \n";
 		helpString += "The rarefaction.single command should be in the following format: \n";
 		helpString += "rarefaction.single(label=yourLabel, iters=yourIters, freq=yourFreq, calc=yourEstimators).\n";
 		helpString += "Example rarefaction.single(label=unique-.01-.03, iters=10000, freq=10, calc=sobs-rchao-race-rjack-rbootstrap-rshannon-rnpshannon-rsimpson).\n";
 		helpString += "The default values for iters is 1000, freq is 100, and calc is rarefaction which calculates the rarefaction curve for the observed richness.\n";
         helpString += "The alpha parameter is used to set the alpha value for the shannonrange calculator.\n";
+        helpString += "The analytic parameter allows you to calculate the sobs curve from the expected number of OTUs in a subsample instead of by resampling. The curve is exact and its confidence intervals come from the variance of the expectation. Default=F.\n";
+        helpString += "The processors parameter allows you to specify the number of processors to use. The iterations are split between the processors. Default=1.\n";
 		validCalculator.printCalc("rarefaction");
 		helpString += "If you are running rarefaction.single with a shared file and would like your results collated in one file, set groupmode=t. (Default=true).\n";
 		helpString += "The label parameter is used to analyze specific labels in your input.\n";
@@ -301,6 +305,12 @@ RareFactCommand::RareFactCommand(string option)  {
 			temp = validParameter.valid(parameters, "groupmode");		if (temp == "not found") { temp = "T"; }
 			groupMode = util.isTrue(temp);
             
+            temp = validParameter.valid(parameters, "analytic");		if (temp == "not found") { temp = "F"; }
+			analytic = util.isTrue(temp);
+            
+            temp = validParameter.valid(parameters, "processors");	if (temp == "not found"){	temp = current->getProcessors();	}
+			processors = current->setProcessors(temp);
+            
             string groups = validParameter.valid(parameters, "groups");
             if (groups == "not found") { groups = ""; }
             else {  util.splitAtDash(groups, Groups);
@@ -399,10 +409,21 @@ int RareFactCommand::execute(){
                     if (inputFileNames.size() > 1) { file2Group[outputNames.size()-1] = Groups[p]; }
 				}
 			}
+            
+            //each extra thread needs its own calculators, in the same order as rDisplays
+            threadDisplays.resize(processors-1);
+            for (int t = 0; t < threadDisplays.size(); t++) {
+                for (i=0; i<Estimators.size(); i++) {
+                    if (validCalculator.isValidCalculator("rarefaction", Estimators[i]) ) {
+                        Calculator* calculator = getCalculator(Estimators[i]);
+                        if (calculator != NULL) { threadDisplays[t].push_back(new RareDisplay(calculator, NULL)); }
+                    }
+                }
+            }
 			
 			
 			//if the users entered no valid calculators don't execute command
-			if (rDisplays.size() == 0) { for(int i=0;i<rDisplays.size();i++){	delete rDisplays[i];	}  return 0; }
+			if (rDisplays.size() == 0) { for(int i=0;i<rDisplays.size();i++){	delete rDisplays[i];	} deleteThreadDisplays();  return 0; }
 			
 			InputData input(inputFileNames[p], format, nullVector);
 			OrderVector* order = input.getOrderVector();
@@ -412,12 +433,12 @@ int RareFactCommand::execute(){
 			set<string> processedLabels;
 			set<string> userLabels = labels;
 			
-			if (m->getControl_pressed()) { for(int i=0;i<rDisplays.size();i++){	delete rDisplays[i];	}    delete order;  for (int i = 0; i < outputNames.size(); i++) {	util.mothurRemove(outputNames[i]); } return 0; }
+			if (m->getControl_pressed()) { for(int i=0;i<rDisplays.size();i++){	delete rDisplays[i];	} deleteThreadDisplays();    delete order;  for (int i = 0; i < outputNames.size(); i++) {	util.mothurRemove(outputNames[i]); } return 0; }
 			
 			//as long as you are not at the end of the file or done wih the lines you want
 			while((order != NULL) && ((allLines == 1) || (userLabels.size() != 0))) {
 				
-				if (m->getControl_pressed()) { for(int i=0;i<rDisplays.size();i++){	delete rDisplays[i];	}    delete order;  for (int i = 0; i < outputNames.size(); i++) {	util.mothurRemove(outputNames[i]); } return 0; }
+				if (m->getControl_pressed()) { for(int i=0;i<rDisplays.size();i++){	delete rDisplays[i];	} deleteThreadDisplays();    delete order;  for (int i = 0; i < outputNames.size(); i++) {	util.mothurRemove(outputNames[i]); } return 0; }
 
 				
 				if(allLines == 1 || labels.count(order->getLabel()) == 1){
@@ -426,7 +447,7 @@ int RareFactCommand::execute(){
                     map<string, set<int> >::iterator itEndings = labelToEnds.find(order->getLabel());
                     set<int> ends;
                     if (itEndings != labelToEnds.end()) { ends = itEndings->second; }
-					rCurve = new Rarefact(*order, rDisplays, ends);
+					rCurve = new Rarefact(*order, rDisplays, ends, analytic, threadDisplays);
 					rCurve->getCurve(freq, nIters);
 					delete rCurve;
 					
@@ -444,7 +465,7 @@ int RareFactCommand::execute(){
 					map<string, set<int> >::iterator itEndings = labelToEnds.find(order->getLabel());
                     set<int> ends;
                     if (itEndings != labelToEnds.end()) { ends = itEndings->second; }
-					rCurve = new Rarefact(*order, rDisplays, ends);
+					rCurve = new Rarefact(*order, rDisplays, ends, analytic, threadDisplays);
 
 					rCurve->getCurve(freq, nIters);
 					delete rCurve;
@@ -462,7 +483,7 @@ int RareFactCommand::execute(){
 				order = (input.getOrderVector());
 			}
 			
-			if (m->getControl_pressed()) { for(int i=0;i<rDisplays.size();i++){	delete rDisplays[i];	}    for (int i = 0; i < outputNames.size(); i++) {	util.mothurRemove(outputNames[i]); } return 0; }
+			if (m->getControl_pressed()) { for(int i=0;i<rDisplays.size();i++){	delete rDisplays[i];	} deleteThreadDisplays();    for (int i = 0; i < outputNames.size(); i++) {	util.mothurRemove(outputNames[i]); } return 0; }
 
 			//output error messages about any remaining user labels
 			set<string>::iterator it;
@@ -477,7 +498,7 @@ int RareFactCommand::execute(){
 				}
 			}
 			
-			if (m->getControl_pressed()) { for(int i=0;i<rDisplays.size();i++){	delete rDisplays[i];	}    for (int i = 0; i < outputNames.size(); i++) {	util.mothurRemove(outputNames[i]); } return 0; }
+			if (m->getControl_pressed()) { for(int i=0;i<rDisplays.size();i++){	delete rDisplays[i];	} deleteThreadDisplays();    for (int i = 0; i < outputNames.size(); i++) {	util.mothurRemove(outputNames[i]); } return 0; }
 
 			//run last label if you need to
 			if (needToRun )  {
@@ -488,7 +509,7 @@ int RareFactCommand::execute(){
 				map<string, set<int> >::iterator itEndings = labelToEnds.find(order->getLabel());
                 set<int> ends;
                 if (itEndings != labelToEnds.end()) { ends = itEndings->second; }
-                rCurve = new Rarefact(*order, rDisplays, ends);
+                rCurve = new Rarefact(*order, rDisplays, ends, analytic, threadDisplays);
 
 				rCurve->getCurve(freq, nIters);
 				delete rCurve;
@@ -498,7 +519,7 @@ int RareFactCommand::execute(){
 			
 			
 			for(int i=0;i<rDisplays.size();i++){	delete rDisplays[i];	}	
-			rDisplays.clear();
+			rDisplays.clear(); deleteThreadDisplays();
 		}
 		
 		
@@ -726,3 +747,46 @@ vector<string> RareFactCommand::parseSharedFile(string filename, map<string, set
 
 
 
+//new copy of the calculator for the estimator, for the displays of the extra threads
+Calculator* RareFactCommand::getCalculator(string estimator) {
+	try {
+		Calculator* calculator = NULL;
+		
+		if (estimator == "sobs")                    { calculator = new Sobs();              }
+		else if (estimator == "chao")               { calculator = new Chao1();             }
+		else if (estimator == "ace")                { calculator = new Ace(abund);          }
+		else if (estimator == "jack")               { calculator = new Jackknife();         }
+		else if (estimator == "shannon")            { calculator = new Shannon();           }
+		else if (estimator == "shannoneven")        { calculator = new ShannonEven();       }
+		else if (estimator == "heip")               { calculator = new Heip();              }
+		else if (estimator == "r_shannonrange")     { calculator = new RangeShannon(alpha); }
+		else if (estimator == "smithwilson")        { calculator = new SmithWilson();       }
+		else if (estimator == "npshannon")          { calculator = new NPShannon();         }
+		else if (estimator == "simpson")            { calculator = new Simpson();           }
+		else if (estimator == "simpsoneven")        { calculator = new SimpsonEven();       }
+		else if (estimator == "invsimpson")         { calculator = new InvSimpson();        }
+		else if (estimator == "bootstrap")          { calculator = new Bootstrap();         }
+		else if (estimator == "coverage")           { calculator = new Coverage();          }
+		else if (estimator == "nseqs")              { calculator = new NSeqs();             }
+		
+		return calculator;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "RareFactCommand", "getCalculator");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
+void RareFactCommand::deleteThreadDisplays() {
+	try {
+		for (int t = 0; t < threadDisplays.size(); t++) {
+			for (int i = 0; i < threadDisplays[t].size(); i++) { delete threadDisplays[t][i]; }
+		}
+		threadDisplays.clear();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "RareFactCommand", "deleteThreadDisplays");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
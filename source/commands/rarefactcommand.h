@@ -38,11 +38,12 @@ public:
 private:
 	
 	vector<Display*> rDisplays;
+	vector< vector<Display*> > threadDisplays; //copies of rDisplays for the extra processors
 	Rarefact* rCurve;
 	int nIters, abund, processors, alpha;
 	float freq;
 	
-	bool abort, allLines, groupMode;
+	bool abort, allLines, groupMode, analytic;
 	set<string> labels; //holds labels to be used
 	string label, calc, sharedfile, listfile, rabundfile, sabundfile, format, inputfile;
 	vector<string>  Estimators;
@@ -52,6 +53,8 @@ private:
 	
 	vector<string> parseSharedFile(string, map<string, set<int> >&);
 	vector<string> createGroupFile(vector<string>&, map<int, string>);
+	Calculator* getCalculator(string);
+	void deleteThreadDisplays();
 };
 
 #endif
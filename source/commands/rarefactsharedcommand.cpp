@@ -30,6 +30,8 @@ vector<string> RareFactSharedCommand::setParameters(){
         CommandParameter psets("sets", "String", "", "", "", "", "","",false,false); parameters.push_back(psets);
 		CommandParameter pgroupmode("groupmode", "Boolean", "", "T", "", "", "","",false,false); parameters.push_back(pgroupmode);
         CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
+        CommandParameter panalytic("analytic", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(panalytic);
+        CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
 		CommandParameter poutputdir("outputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(poutputdir);
 		
@@ -47,7 +49,7 @@ string RareFactSharedCommand::getHelpString(){
 	try {
 		string helpString = "";
 		ValidCalculators validCalculator;
-		helpString += "The rarefaction.shared command parameters are shared, design, label, iters, groups, sets, jumble, groupmode and calc.  shared is required if there is no current sharedfile. \n";
+		helpString += "The rarefaction.shared command parameters are shared, design, label, iters, groups, sets, jumble, groupmode, analytic, processors and calc.  shared is required if there is no current sharedfile. \n";
         helpString += "The design parameter allows you to assign your groups to sets. If provided mothur will run rarefaction.shared on a per set basis. \n";
         helpString += "The sets parameter allows you to specify which of the sets in your designfile you would like to analyze. The set names are separated by dashes. THe default is all sets in the designfile.\n";
 		helpString += "The rarefaction command should be in the following format: \n";
@@ -58,6 +60,8 @@ string RareFactSharedCommand::getHelpString(){
         helpString += "The subsampleiters parameter allows you to choose the number of times you would like to run the subsample.\n";
         helpString += "The subsample parameter allows you to enter the size pergroup of the sample or you can set subsample=T and mothur will use the size of your smallest group.\n";
 		helpString += "The default value for groups is all the groups in your groupfile, and jumble is true.\n";
+        helpString += "The analytic parameter allows you to calculate the sharedobserved curve from the expected number of OTUs in a random set of groups instead of by resampling. It is used when jumble is true. Default=F.\n";
+        helpString += "The processors parameter allows you to specify the number of processors to use. The iterations are split between the processors. Default=1.\n";
 		helpString += validCalculator.printCalc("sharedrarefaction");
 		helpString += "The label parameter is used to analyze specific labels in your input.\n";
 		helpString += "The groups parameter allows you to specify which of the groups in your groupfile you would like analyzed.  You must enter at least 2 valid groups.\n";
@@ -221,6 +225,12 @@ RareFactSharedCommand::RareFactSharedCommand(string option)  {
             temp = validParameter.valid(parameters, "groupmode");		if (temp == "not found") { temp = "T"; }
 			groupMode = util.isTrue(temp);
             
+            temp = validParameter.valid(parameters, "analytic");		if (temp == "not found") { temp = "F"; }
+			analytic = util.isTrue(temp);
+            
+            temp = validParameter.valid(parameters, "processors");	if (temp == "not found"){	temp = current->getProcessors();	}
+			processors = current->setProcessors(temp);
+            
             temp = validParameter.valid(parameters, "subsampleiters");			if (temp == "not found") { temp = "1000"; }
 			util.mothurConvert(temp, iters); 
             
@@ -341,12 +351,13 @@ int RareFactSharedCommand::process(DesignMap& designMap, string thisSet){
 			}
             file2Group[outputNames.size()-1] = thisSet;
 		}
+        vector< vector<Display*> > threadDisplays = getThreadDisplays();
 		
 		//if the users entered no valid calculators don't execute command
         if (rDisplays.size() == 0) { delete lookup;  delete subset; return 0; }
 		
 		if (m->getControl_pressed()) { 
-			for(int i=0;i<rDisplays.size();i++){	delete rDisplays[i];	}
+			for(int i=0;i<rDisplays.size();i++){	delete rDisplays[i];	} deleteThreadDisplays(threadDisplays);
 			for (int i = 0; i < outputNames.size(); i++) {	util.mothurRemove(outputNames[i]); 	}
 			delete lookup; delete subset;
 			return 0;
@@ -361,7 +372,7 @@ int RareFactSharedCommand::process(DesignMap& designMap, string thisSet){
 		//as long as you are not at the end of the file or done wih the lines you want
 		while((subset != NULL) && ((allLines == 1) || (userLabels.size() != 0))) {
 			if (m->getControl_pressed()) { 
-				for(int i=0;i<rDisplays.size();i++){	delete rDisplays[i];	}
+				for(int i=0;i<rDisplays.size();i++){	delete rDisplays[i];	} deleteThreadDisplays(threadDisplays);
 				for (int i = 0; i < outputNames.size(); i++) {	util.mothurRemove(outputNames[i]); 	}
                 delete lookup; delete subset;
 				return 0;
@@ -370,7 +381,7 @@ int RareFactSharedCommand::process(DesignMap& designMap, string thisSet){
 			if(allLines == 1 || labels.count(subset->getLabel()) == 1){
 				m->mothurOut(subset->getLabel() + '\t' + thisSet); m->mothurOutEndLine();
                 vector<SharedRAbundVector*> rabunds = subset->getSharedRAbundVectors();
-				rCurve = new Rarefact(rabunds, rDisplays, jumble);
+				rCurve = new Rarefact(rabunds, rDisplays, jumble, analytic, threadDisplays);
 				rCurve->getSharedCurve(freq, nIters);
 				delete rCurve;
                 for (int i = 0; i < rabunds.size(); i++) {	delete rabunds[i]; 	}
@@ -396,7 +407,7 @@ int RareFactSharedCommand::process(DesignMap& designMap, string thisSet){
                 
                 m->mothurOut(subset->getLabel() + '\t' + thisSet); m->mothurOutEndLine();
                 vector<SharedRAbundVector*> rabunds = subset->getSharedRAbundVectors();
-                rCurve = new Rarefact(rabunds, rDisplays, jumble);
+                rCurve = new Rarefact(rabunds, rDisplays, jumble, analytic, threadDisplays);
                 rCurve->getSharedCurve(freq, nIters);
                 delete rCurve;
                 for (int i = 0; i < rabunds.size(); i++) {	delete rabunds[i]; 	}
@@ -427,7 +438,7 @@ int RareFactSharedCommand::process(DesignMap& designMap, string thisSet){
 		}
 		
 		if (m->getControl_pressed()) { 
-			for(int i=0;i<rDisplays.size();i++){	delete rDisplays[i];	}
+			for(int i=0;i<rDisplays.size();i++){	delete rDisplays[i];	} deleteThreadDisplays(threadDisplays);
 			for (int i = 0; i < outputNames.size(); i++) {	util.mothurRemove(outputNames[i]); 	}
 			return 0;
 		}
@@ -441,7 +452,7 @@ int RareFactSharedCommand::process(DesignMap& designMap, string thisSet){
 		}
 		
 		if (m->getControl_pressed()) { 
-			for(int i=0;i<rDisplays.size();i++){	delete rDisplays[i];	}
+			for(int i=0;i<rDisplays.size();i++){	delete rDisplays[i];	} deleteThreadDisplays(threadDisplays);
 			for (int i = 0; i < outputNames.size(); i++) {	util.mothurRemove(outputNames[i]); 	}
 			return 0;
 		}
@@ -460,7 +471,7 @@ int RareFactSharedCommand::process(DesignMap& designMap, string thisSet){
             
 			m->mothurOut(subset->getLabel() + '\t' + thisSet); m->mothurOutEndLine();
             vector<SharedRAbundVector*> rabunds = subset->getSharedRAbundVectors();
-			rCurve = new Rarefact(rabunds, rDisplays, jumble);
+			rCurve = new Rarefact(rabunds, rDisplays, jumble, analytic, threadDisplays);
 			rCurve->getSharedCurve(freq, nIters);
 			delete rCurve;
             for (int i = 0; i < rabunds.size(); i++) {	delete rabunds[i]; 	}
@@ -470,7 +481,7 @@ int RareFactSharedCommand::process(DesignMap& designMap, string thisSet){
 			delete lookup; delete subset;
 		}
 		
-		for(int i=0;i<rDisplays.size();i++){	delete rDisplays[i];	}	
+		for(int i=0;i<rDisplays.size();i++){	delete rDisplays[i];	} deleteThreadDisplays(threadDisplays);	
 
         
         return 0;
@@ -511,15 +522,16 @@ int RareFactSharedCommand::subsampleLookup(SharedRAbundVectors*& thisLookup, str
                     }
                 }
             }
+            vector< vector<Display*> > threadDisplays = getThreadDisplays();
             
             vector<SharedRAbundVector*> rabunds = thisItersLookup->getSharedRAbundVectors();
-            rCurve = new Rarefact(rabunds, rDisplays, jumble);
+            rCurve = new Rarefact(rabunds, rDisplays, jumble, analytic, threadDisplays);
 			rCurve->getSharedCurve(freq, nIters);
 			delete rCurve;
             for (int i = 0; i < rabunds.size(); i++) {	delete rabunds[i]; 	}
             
             //clean up memory
-            for(int i=0;i<rDisplays.size();i++){	delete rDisplays[i];	}
+            for(int i=0;i<rDisplays.size();i++){	delete rDisplays[i];	} deleteThreadDisplays(threadDisplays);
             delete thisItersLookup;
         }
         
@@ -776,3 +788,39 @@ vector<string> RareFactSharedCommand::createGroupFile(vector<string>& outputName
 	}
 }
 //**********************************************************************************************************************
+//copies of the calculators for the extra processors, in the same order as the displays
+vector< vector<Display*> > RareFactSharedCommand::getThreadDisplays() {
+	try {
+		vector< vector<Display*> > threadDisplays(processors-1);
+		ValidCalculators validCalculator;
+		
+		for (int t = 0; t < threadDisplays.size(); t++) {
+			for (int i=0; i<Estimators.size(); i++) {
+				if (validCalculator.isValidCalculator("sharedrarefaction", Estimators[i]) ) {
+					if (Estimators[i] == "sharedobserved")      { threadDisplays[t].push_back(new RareDisplay(new SharedSobs(), NULL));     }
+					else if (Estimators[i] == "sharednseqs")    { threadDisplays[t].push_back(new RareDisplay(new SharedNSeqs(), NULL));    }
+				}
+			}
+		}
+		
+		return threadDisplays;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "RareFactSharedCommand", "getThreadDisplays");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
+void RareFactSharedCommand::deleteThreadDisplays(vector< vector<Display*> >& threadDisplays) {
+	try {
+		for (int t = 0; t < threadDisplays.size(); t++) {
+			for (int i = 0; i < threadDisplays[t].size(); i++) { delete threadDisplays[t][i]; }
+		}
+		threadDisplays.clear();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "RareFactSharedCommand", "deleteThreadDisplays");
+		exit(1);
+	}
+}
+//**********************************************************************************************************************
@@ -37,12 +37,12 @@ public:
 	
 	
 private:
-	int nIters, subsampleSize, iters;
+	int nIters, subsampleSize, iters, processors;
 	string format;
 	float freq;
 	
      map<int, string> file2Group; //index in outputNames[i] -> group
-	bool abort, allLines, jumble, groupMode, subsample;
+	bool abort, allLines, jumble, groupMode, subsample, analytic;
 	set<string> labels; //holds labels to be used
 	string label, calc, groups, outputDir, sharedfile, designfile;
 	vector<string>  Estimators, Groups, outputNames, Sets;
@@ -50,6 +50,8 @@ private:
     int process(DesignMap&, string);
     vector<string> createGroupFile(vector<string>&);
     int subsampleLookup(SharedRAbundVectors*&, string);
+    vector< vector<Display*> > getThreadDisplays();
+    void deleteThreadDisplays(vector< vector<Display*> >&);
 
 };
 
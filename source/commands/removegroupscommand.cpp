@@ -524,37 +524,38 @@ int RemoveGroupsCommand::readFasta(){
 		ofstream out;
 		util.openOutputFile(outputFileName, out);
 		
-		ifstream in;
-		util.openInputFile(fastafile, in);
+		SequenceReader in(fastafile);
+		TextSpan nameSpan, commentSpan, sequence;
 		string name;
 		
 		bool wroteSomething = false;
 		int removedCount = 0;
 		
-		while(!in.eof()){
-			if (m->getControl_pressed()) { in.close();  out.close();  util.mothurRemove(outputFileName);  return 0; }
+		while(in.readFasta(nameSpan, commentSpan, sequence)){
+			if (m->getControl_pressed()) { out.close();  util.mothurRemove(outputFileName);  return 0; }
+			
+			//skip commented out sequences, only the sequences written are parsed
+			if ((nameSpan.length == 0) || (nameSpan.data[0] == '#')) { continue; }
 			
-			Sequence currSeq(in);
-			name = currSeq.getName();
+			name.assign(nameSpan.data, nameSpan.length);
+			util.checkName(name);
 			
-			if (name != "") {
-				//if this name is in the accnos file
-				if (names.count(name) == 0) {
+			//if this name is in the accnos file
+			if (names.count(name) == 0) {
+				wroteSomething = true;
+				Sequence currSeq(nameSpan, commentSpan, sequence);
+				currSeq.printSequence(out);
+			}else { 
+				//if you are not in the accnos file check if you are a name that needs to be changed
+				map<string, string>::iterator it = uniqueToRedundant.find(name);
+				if (it != uniqueToRedundant.end()) {
 					wroteSomething = true;
-					currSeq.printSequence(out); 
-				}else { 
-					//if you are not in the accnos file check if you are a name that needs to be changed
-					map<string, string>::iterator it = uniqueToRedundant.find(name);
-					if (it != uniqueToRedundant.end()) {
-						wroteSomething = true;
-						currSeq.setName(it->second);
-						currSeq.printSequence(out);
-					}else { removedCount++; }
-				}
+					Sequence currSeq(nameSpan, commentSpan, sequence);
+					currSeq.setName(it->second);
+					currSeq.printSequence(out);
+				}else { removedCount++; }
 			}
-			util.gobble(in);
 		}
-		in.close();	
 		out.close();
 		
 		if (wroteSomething == false) {  m->mothurOut("Your file contains only sequences from the groups you wish to remove."); m->mothurOutEndLine();  }
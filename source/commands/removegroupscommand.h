@@ -13,6 +13,7 @@
 
 #include "command.hpp"
 #include "groupmap.h"
+#include "nameset.hpp"
 
 class RemoveGroupsCommand : public Command {
     
@@ -40,7 +41,7 @@ public:
 	
 	
 private:
-	set<string> names;
+	NameSet names;
 	string accnosfile, fastafile, namefile, groupfile, countfile, designfile, listfile, taxfile, outputDir, groups, sharedfile, phylipfile, columnfile;
 	bool abort;
 	vector<string> outputNames, Groups;
@@ -13,6 +13,7 @@
 #include "command.hpp"
 #include "sharedrabundvectors.hpp"
 #include "listvector.hpp"
+#include "nameset.hpp"
 
 
 class RemoveLineageCommand : public Command {
@@ -36,7 +37,7 @@ class RemoveLineageCommand : public Command {
 		void help() { m->mothurOut(getHelpString()); }	
 	
 	private:
-		set<string> names;
+		NameSet names;
 		vector<string> outputNames, listOfTaxons;
 		string fastafile, namefile, groupfile, alignfile, listfile, countfile, taxfile, outputDir, taxons, sharedfile, constaxonomy, label;
 		bool abort, dups;
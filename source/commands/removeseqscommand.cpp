@@ -332,7 +332,7 @@ int RemoveSeqsCommand::execute(){
 		if (abort) { if (calledHelp) { return 0; }  return 2;	}
 		
 		//get names you want to keep
-		names = util.readAccnos(accnosfile);
+		util.readAccnos(accnosfile, names);
 		
 		if (m->getControl_pressed()) { return 0; }
         
@@ -421,42 +421,41 @@ int RemoveSeqsCommand::readFasta(){
 		ofstream out;
 		util.openOutputFile(outputFileName, out);
 		
-		ifstream in;
-		util.openInputFile(fastafile, in);
+		SequenceReader in(fastafile);
+		TextSpan nameSpan, commentSpan, sequence;
 		string name;
 		
 		bool wroteSomething = false;
 		int removedCount = 0;
 		
-        set<string> uniqueNames;
-		while(!in.eof()){
-			if (m->getControl_pressed()) { in.close();  out.close();  util.mothurRemove(outputFileName);  return 0; }
+        NameSet uniqueNames;
+		while(in.readFasta(nameSpan, commentSpan, sequence)){
+			if (m->getControl_pressed()) { out.close();  util.mothurRemove(outputFileName);  return 0; }
+			
+			//skip commented out sequences, only the sequences written are parsed
+			if ((nameSpan.length == 0) || (nameSpan.data[0] == '#')) { continue; }
 			
-			Sequence currSeq(in);
+			name.assign(nameSpan.data, nameSpan.length);
+			util.checkName(name);
             
             if (!dups) {//adjust name if needed
-                map<string, string>::iterator it = uniqueMap.find(currSeq.getName());
-                if (it != uniqueMap.end()) { currSeq.setName(it->second); }
+                map<string, string>::iterator it = uniqueMap.find(name);
+                if (it != uniqueMap.end()) { name = it->second; }
             }
-
-			name = currSeq.getName();
 			
-			if (name != "") {
-				//if this name is in the accnos file
-				if (names.count(name) == 0) {
-                    if (uniqueNames.count(name) == 0) { //this name hasn't been seen yet
-                        uniqueNames.insert(name);
-                        wroteSomething = true;
-					
-                        currSeq.printSequence(out);
-                    }else {
-                        m->mothurOut("[WARNING]: " + name + " is in your fasta file more than once.  Mothur requires sequence names to be unique. I will only add it once.\n");
-                    }
-				}else {  removedCount++;  }
-			}
-			util.gobble(in);
+			//if this name is in the accnos file
+			if (names.count(name) == 0) {
+                if (uniqueNames.insert(name)) { //this name hasn't been seen yet
+                    wroteSomething = true;
+                    
+                    Sequence currSeq(nameSpan, commentSpan, sequence);
+                    currSeq.setName(name);
+                    currSeq.printSequence(out);
+                }else {
+                    m->mothurOut("[WARNING]: " + name + " is in your fasta file more than once.  Mothur requires sequence names to be unique. I will only add it once.\n");
+                }
+			}else {  removedCount++;  }
 		}
-		in.close();	
 		out.close();
 		
 		if (wroteSomething == false) {  m->mothurOut("Your file contains only sequences from the .accnos file."); m->mothurOutEndLine();  }
@@ -11,6 +11,7 @@
  */
  
 #include "command.hpp"
+#include "nameset.hpp"
 
 class RemoveSeqsCommand : public Command {
 	
@@ -34,7 +35,7 @@ class RemoveSeqsCommand : public Command {
 	
 	
 	private:
-		set<string> names;
+		NameSet names;
 		string accnosfile, fastafile, fastqfile, namefile, groupfile, countfile, alignfile, listfile, taxfile, qualfile, outputDir, format;
 		bool abort, dups;
 		vector<string> outputNames;
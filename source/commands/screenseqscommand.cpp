@@ -1035,13 +1035,7 @@ int ScreenSeqsCommand::getSummary(){
 
 void driverScreen(sumScreenData* params){
 	try {
-		ifstream inFASTA;
-		params->util.openInputFile(params->filename, inFASTA);
-
-        inFASTA.seekg(params->start);
-
-        //print header if you are process 0
-        if (params->start == 0) { params->util.zapGremlins(inFASTA); params->util.gobble(inFASTA); }
+		SequenceReader inFASTA(params->filename, params->start);
 
 		bool done = false;
 		params->count = 0;
@@ -1050,7 +1044,7 @@ void driverScreen(sumScreenData* params){
 		
 			if (params->m->getControl_pressed()) {  break; }
 			
-			Sequence currSeq(inFASTA); params->util.gobble(inFASTA);
+			Sequence currSeq(inFASTA);
 			if (currSeq.getName() != "") {
 				bool goodSeq = 1;		//	innocent until proven guilty
                 string trashCode = "";
@@ -1084,10 +1078,10 @@ void driverScreen(sumScreenData* params){
 			}
 			
 			#if defined NON_WINDOWS
-				unsigned long long pos = inFASTA.tellg();
-				if ((pos == -1) || (pos >= params->end)) { break; }
+				unsigned long long pos = inFASTA.getPosition();
+				if (inFASTA.eof() || (pos >= params->end)) { break; }
 			#else
-				if (params->end == params->count) { break; }
+				if (inFASTA.eof() || (params->end == params->count)) { break; }
 			#endif
 			
 			//report progress
@@ -1095,8 +1089,6 @@ void driverScreen(sumScreenData* params){
 		}
 		//report progress
 		if((params->count) % 1000 != 0){	params->m->mothurOutJustToScreen(toString(params->count)+"\n"); 	}
-		
-		inFASTA.close();
 	}
 	catch(exception& e) {
 		params->m->errorOut(e, "ScreenSeqsCommand", "driverScreen");
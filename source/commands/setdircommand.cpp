@@ -17,6 +17,8 @@ vector<string> SetDirectoryCommand::setParameters(){
         CommandParameter pdebug("debug", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(pdebug);
         CommandParameter pseed("seed", "Number", "", "0", "", "", "","",false,false); parameters.push_back(pseed);
         CommandParameter pmodnames("modifynames", "Boolean", "", "T", "", "", "","",false,false); parameters.push_back(pmodnames);
+        CommandParameter pindex("index", "Boolean", "", "F", "", "", "","",false,false); parameters.push_back(pindex);
+        CommandParameter psortmemory("sortmemory", "Number", "", "1024", "", "", "","",false,false); parameters.push_back(psortmemory);
 		CommandParameter pinput("input", "String", "", "", "", "", "","",false,false,true); parameters.push_back(pinput);
 		CommandParameter poutput("output", "String", "", "", "", "", "","",false,false,true); parameters.push_back(poutput);
         CommandParameter pinputdir("inputdir", "String", "", "", "", "", "","",false,false); parameters.push_back(pinputdir);
@@ -42,7 +44,9 @@ string SetDirectoryCommand::getHelpString(){
         helpString += "The set.dir command can also be used to run mothur in debug mode.\n";
         helpString += "The set.dir command can also be used to seed random.\n";
         helpString += "The set.dir command can also be used to set the modifynames parameter. Default=t, meaning if your sequence names contain ':' change them to '_' to avoid issues while making trees.  modifynames=F will leave sequence names as they are.\n";
-		helpString += "The set.dir command parameters are input, output, tempdefault and debug and one is required.\n";
+        helpString += "The set.dir command can also be used to set the index parameter. Default=f. index=T saves the record offsets of the fasta, fastq and count files mothur scans to yourFile.idx, in the output directory if you set one, so later commands can skip the scan. Existing index files are used either way.\n";
+        helpString += "The set.dir command can also be used to set the sortmemory parameter, the megabytes of records sort.seqs with large=T and the sorts of large distance files hold in memory before writing sorted runs to disk. Default=1024.\n";
+		helpString += "The set.dir command parameters are input, output, tempdefault, blastdir, debug, seed, modifynames, index and sortmemory and one is required.\n";
         helpString += "To run mothur in debug mode set debug=true. Default debug=false.\n";
         helpString += "To seed random set seed=yourRandomValue. By default mothur seeds random with the start time.\n";
 		helpString += "To return the output to the same directory as the input files you may enter: output=clear.\n";
@@ -109,6 +113,21 @@ SetDirectoryCommand::SetDirectoryCommand(string option)  {
             else {  modifyNames = util.isTrue(temp); }
             m->setChangedSeqNames(modifyNames);
             
+            bool noindex = false;
+            temp = validParameter.valid(parameters, "index");
+            if (temp == "not found") {  noindex = true; }
+            else {  m->setIndexFiles(util.isTrue(temp)); }
+            
+            bool nosortmemory = false;
+            temp = validParameter.valid(parameters, "sortmemory");
+            if (temp == "not found") {  nosortmemory = true; }
+            else {
+                int megabytes = 0;
+                if (util.isInteger(temp)) { util.mothurConvert(temp, megabytes); }
+                if (megabytes > 0) { m->setSortMemory((unsigned long long)megabytes * 1048576); }
+                else { m->mothurOut("[ERROR]: sortmemory must be a positive number of megabytes for the set.dir command.\n"); abort = true; }
+            }
+            
             bool seed = false;
             temp = validParameter.valid(parameters, "seed");
             if (temp == "not found") { random = 0; }
@@ -123,8 +142,8 @@ SetDirectoryCommand::SetDirectoryCommand(string option)  {
                 m->mothurOut("Setting random seed to " + toString(random) + ".\n\n");
             }
             
-			if ((input == "") && (output == "") && (tempdefault == "") && (blastLocation == "") && nodebug && nomod && !seed) {
-				m->mothurOut("[ERROR]: You must provide either an input, output, tempdefault, blastdir, debug or modifynames for the set.dir command."); m->mothurOutEndLine(); abort = true;
+			if ((input == "") && (output == "") && (tempdefault == "") && (blastLocation == "") && nodebug && nomod && noindex && nosortmemory && !seed) {
+				m->mothurOut("[ERROR]: You must provide either an input, output, tempdefault, blastdir, debug, seed, modifynames, index or sortmemory for the set.dir command."); m->mothurOutEndLine(); abort = true;
 			}else if((input == "") && (output == "") && (tempdefault == "") && (blastLocation == "")) { debugorSeedOnly = true; }
 		}
 	}
@@ -17,6 +17,7 @@ vector<string> ShhherCommand::setParameters(){
 		CommandParameter plookup("lookup", "InputTypes", "", "", "none", "none", "none","",false,false,true); parameters.push_back(plookup);
 		CommandParameter pcutoff("cutoff", "Number", "", "0.01", "", "", "","",false,false); parameters.push_back(pcutoff);
 		CommandParameter pmaxiter("maxiter", "Number", "", "1000", "", "", "","",false,false); parameters.push_back(pmaxiter);
+        CommandParameter pprocessors("processors", "Number", "", "1", "", "", "","",false,false,true); parameters.push_back(pprocessors);
         CommandParameter plarge("large", "Number", "", "-1", "", "", "","",false,false); parameters.push_back(plarge);
 		CommandParameter psigma("sigma", "Number", "", "60", "", "", "","",false,false); parameters.push_back(psigma);
 		CommandParameter pmindelta("mindelta", "Number", "", "0.000001", "", "", "","",false,false); parameters.push_back(pmindelta);
@@ -42,6 +43,7 @@ string ShhherCommand::getHelpString(){
         helpString += "The flow parameter is used to input your flow file.\n";
         helpString += "The file parameter is used to input the *flow.files file created by trim.flows.\n";
         helpString += "The lookup parameter is used specify the lookup file you would like to use. http://www.mothur.org/wiki/Lookup_files.\n";
+        helpString += "The processors parameter allows you to specify how many processors you would like to use.  The default is 1. \n";
         helpString += "The order parameter options are A, B or I.  Default=A. A = TACG and B = TACGTACGTACGATGTAGTCGAGCATCATCTGACGCAGTACGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATAGATCGCATGACGATCGCATATCGTCAGTGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCATAGATCGCATGACGATCGCATATCGTCAGTGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCATAGATCGCATGACGATCGCATATCGTCAGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATAGATCGCATGACGATCGCATATCGTCAGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCATAGATCGCATGACGATCGCATATCGTCAGTGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATAGATCGCATGACGATCGCATATCGTCAGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCATAGATCGCATGACGATCGCATATCGTCAGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCATAGATCGCATGACGATCGCATATCGTCAGTGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATAGATCGCATGACGATCGCATATCGTCAGTGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATAGATCGCATGACGATCGCATATCGTCAGTGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATAGATCGCATGACGATCGCATATCGTCAGTGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCATAGATCGCATGACGATCGCATATCGTCAGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATGTAGTCGAGCATCATCTGACGCAGTACGTGCATGATCTCAGTCAGCAGCTATGTCAGTGCATGCATAGATCGCATGACGATCGCATATCGTCAGTGCAGTGACTGATCGTCATCAGCTAGCATCGACTGCATGATCTCAGTCAGCAGC and I = TACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGCTACGTACGTCTGAGCATCGATCGATGTACAGC.\n";
 		return helpString;
 	}
@@ -347,6 +349,9 @@ ShhherCommand::ShhherCommand(string option) {
 			temp = validParameter.valid(parameters, "maxiter");	if (temp == "not found"){	temp = "1000";		}
 			util.mothurConvert(temp, maxIters); 
             
+            temp = validParameter.valid(parameters, "processors");	if (temp == "not found"){	temp = current->getProcessors();	}
+			processors = current->setProcessors(temp);
+            
             temp = validParameter.valid(parameters, "large");	if (temp == "not found"){	temp = "0";		}
 			util.mothurConvert(temp, largeSize); 
             if (largeSize != 0) { large = true; }
@@ -387,6 +392,7 @@ int ShhherCommand::execute(){
 		
 		getSingleLookUp();	if (m->getControl_pressed()) { return 0; }
 		getJointLookUp();	if (m->getControl_pressed()) { return 0; }
+		getPairLookUp();	if (m->getControl_pressed()) { return 0; }
 		
         int numFiles = flowFileVector.size();
 		
@@ -518,9 +524,9 @@ int ShhherCommand::driver(vector<string> filenames, string thisCompositeFASTAFil
                 vector<string> seqNameVector;
                 vector<int> lengths;
                 vector<short> flowDataIntI;
-                vector<double> flowDataPrI;
                 map<string, int> nameMap;
                 vector<short> uniqueFlowgrams;
+                vector<short> uniqueFlowDataIntI;
                 vector<int> uniqueCount;
                 vector<int> mapSeqToUnique;
                 vector<int> mapUniqueToSeq;
@@ -533,29 +539,26 @@ int ShhherCommand::driver(vector<string> filenames, string thisCompositeFASTAFil
                 if (m->getControl_pressed()) { break; }
                 
                 m->mothurOut("Identifying unique flowgrams...\n");
-                int numUniques = getUniques(numSeqs, numFlowCells, uniqueFlowgrams, uniqueCount, uniqueLengths, mapSeqToUnique, mapUniqueToSeq, lengths, flowDataPrI, flowDataIntI);
+                int numUniques = getUniques(numSeqs, numFlowCells, uniqueFlowgrams, uniqueCount, uniqueLengths, mapSeqToUnique, mapUniqueToSeq, lengths, uniqueFlowDataIntI, flowDataIntI);
                 
                 if (m->getControl_pressed()) { break; }
                 
                 m->mothurOut("Calculating distances between flowgrams...\n");
-                string distFileName = flowFileName.substr(0,flowFileName.find_last_of('.')) + ".shhh.dist";
                 begTime = time(NULL);
-               
                 
-                flowDistParentFork(numFlowCells, distFileName, numUniques, mapUniqueToSeq, mapSeqToUnique, lengths, flowDataPrI, flowDataIntI);
+                //distances are handed straight to the clustering instead of round tripping through a column file
+                SparseDistanceMatrix* distMatrix = new SparseDistanceMatrix();
+                flowDistParentFork(numFlowCells, distMatrix, numUniques, mapUniqueToSeq, lengths, uniqueFlowDataIntI);
                 
                 m->mothurOutEndLine();
                 m->mothurOut("Total time: " + toString(time(NULL) - begTime) + '\t' + toString((clock() - begClock)/CLOCKS_PER_SEC) + '\n');
                 
+                if (m->getControl_pressed()) { delete distMatrix; break; }
                 
-                string namesFileName = flowFileName.substr(0,flowFileName.find_last_of('.')) + ".shhh.names";
-                createNamesFile(numSeqs, numUniques, namesFileName, seqNameVector, mapSeqToUnique, mapUniqueToSeq);
-                
-                if (m->getControl_pressed()) { break; }
+                ListVector uniqueList = createUniqueList(numSeqs, numUniques, seqNameVector, mapSeqToUnique);
                 
                 m->mothurOut("\nClustering flowgrams...\n");
-                string listFileName = flowFileName.substr(0,flowFileName.find_last_of('.')) + ".shhh.list";
-                cluster(listFileName, distFileName, namesFileName);
+                vector<string> otus = cluster(distMatrix, uniqueList);
                 
                 if (m->getControl_pressed()) { break; }
                 
@@ -568,14 +571,10 @@ int ShhherCommand::driver(vector<string> filenames, string thisCompositeFASTAFil
                 vector<int> seqIndex;		//tMaster->anI;		the index that corresponds to seqNumber
                 
                 
-                int numOTUs = getOTUData(numSeqs, listFileName, otuData, cumNumSeqs, nSeqsPerOTU, aaP, aaI, seqNumber, seqIndex, nameMap);
+                int numOTUs = getOTUData(numSeqs, otus, otuData, cumNumSeqs, nSeqsPerOTU, aaP, aaI, seqNumber, seqIndex, nameMap);
                 
                 if (m->getControl_pressed()) { break; }
                 
-                util.mothurRemove(distFileName);
-                util.mothurRemove(namesFileName);
-                util.mothurRemove(listFileName);
-                
                 vector<double> dist;		//adDist - distance of sequences to centroids
                 vector<short> change;		//did the centroid sequence change? 0 = no; 1 = yes
                 vector<int> centroids;		//the representative flowgram for each cluster m
@@ -794,92 +793,163 @@ int ShhherCommand::getFlowData(string filename, vector<string>& thisSeqNameVecto
 	}
 }
 /**************************************************************************************************/
-
-int ShhherCommand::flowDistParentFork(int numFlowCells, string distFileName, int stopSeq, vector<int>& mapUniqueToSeq, vector<int>& mapSeqToUnique, vector<int>& lengths, vector<double>& flowDataPrI, vector<short>& flowDataIntI){
-	try{		
-        
-		ostringstream outStream;
-		outStream.setf(ios::fixed, ios::floatfield);
-		outStream.setf(ios::dec, ios::basefield);
-		outStream.setf(ios::showpoint);
-		outStream.precision(6);
+//the distances used to be written to a column file with 6 decimals and read back in, keep that precision so the clustering is unchanged
+inline float getColumnPrecision(float dist){
+	char buffer[32];
+	snprintf(buffer, 32, "%.6f", dist);
+	return strtof(buffer, NULL);
+}
+/**************************************************************************************************/
+//computes the rows [start, end) of the lower triangle in tiles so the flowgrams being compared stay in cache
+void driverFlowDist(flowDistData* params){
+	try{
+		int numFlowCells = params->numFlowCells;
+		const short* flowData = params->uniqueFlowDataIntI->data();
+		const double* lookUp = params->pairLookUp->data();
+		vector<int>& rowLengths = *params->uniqueRowLengths;
+		vector<int>& seqLengths = *params->uniqueSeqLengths;
 		
 		int begTime = time(NULL);
 		double begClock = clock();
-        
-		for(int i=0;i<stopSeq;i++){
+		
+		for(int ii=params->start;ii<params->end;ii+=FLOWDIST_BLOCK_SIZE){
 			
-			if (m->getControl_pressed()) { break; }
+			if (params->m->getControl_pressed()) { break; }
 			
-			for(int j=0;j<i;j++){
-				float flowDistance = calcPairwiseDist(numFlowCells, mapUniqueToSeq[i], mapUniqueToSeq[j], mapSeqToUnique, lengths, flowDataPrI, flowDataIntI);
-                
-				if(flowDistance < 1e-6){
-					outStream << mapUniqueToSeq[i] << '\t' << mapUniqueToSeq[j] << '\t' << 0.000000 << endl;
-				}
-				else if(flowDistance <= cutoff){
-					outStream << mapUniqueToSeq[i] << '\t' << mapUniqueToSeq[j] << '\t' << flowDistance << endl;
+			int iEnd = min(ii+FLOWDIST_BLOCK_SIZE, params->end);
+			
+			for(int jj=0;jj<iEnd-1;jj+=FLOWDIST_BLOCK_SIZE){
+				int jEnd = min(jj+FLOWDIST_BLOCK_SIZE, iEnd-1);
+				
+				for(int i=ii;i<iEnd;i++){
+					const short* flowA = flowData + (size_t)i * numFlowCells;
+					vector<PDistCell>& row = params->dists[i-params->start];
+					int jStop = min(jEnd, i);
+					
+					for(int j=jj;j<jStop;j++){
+						const short* flowB = flowData + (size_t)j * numFlowCells;
+						
+						int minLength = rowLengths[i];
+						if(seqLengths[j] < minLength){	minLength = rowLengths[j];	}
+						
+						//the terms are non-negative up to rounding, so once the running sum clears the cutoff
+						//by more than the remaining flows could take back the pair can be dropped
+						float dist = 0;
+						bool aboveCutoff = false;
+						for(int k=0;k<minLength;){
+							int stop = min(k+FLOWDIST_BLOCK_SIZE, minLength);
+							for(;k<stop;k++){ dist += lookUp[flowA[k] * NUMBINS + flowB[k]]; }
+							if (dist > ((params->cutoff * minLength + (minLength - k) * params->slack) * 1.001)) { aboveCutoff = true; break; }
+						}
+						if (aboveCutoff) { continue; }
+						
+						dist /= (float) minLength;
+						
+						if(dist <= params->cutoff){
+							float value = 0;
+							if(dist >= 1e-6){ value = getColumnPrecision(dist); }
+							if(value < params->cutoff){ row.push_back(PDistCell(j, value)); }
+						}
+					}
 				}
 			}
-			if(i % 100 == 0){
-				m->mothurOutJustToScreen(toString(i) + "\t" + toString(time(NULL) - begTime));
-				m->mothurOutJustToScreen("\t" + toString((clock()-begClock)/CLOCKS_PER_SEC)+"\n");
+			
+			if (params->start == 0) {
+				params->m->mothurOutJustToScreen(toString(iEnd-1) + "\t" + toString(time(NULL) - begTime));
+				params->m->mothurOutJustToScreen("\t" + toString((clock()-begClock)/CLOCKS_PER_SEC)+"\n");
 			}
 		}
-		
-		ofstream distFile(distFileName.c_str());
-		distFile << outStream.str();		
-		distFile.close();
-		
-		if (m->getControl_pressed()) {}
-		else {
-			m->mothurOutJustToScreen(toString(stopSeq-1) + "\t" + toString(time(NULL) - begTime));
-			m->mothurOutJustToScreen("\t" + toString((clock()-begClock)/CLOCKS_PER_SEC)+"\n");
-		}
-        
-        return 0;
 	}
 	catch(exception& e) {
-		m->errorOut(e, "ShhherCommand", "flowDistParentFork");
+		params->m->errorOut(e, "ShhherCommand", "driverFlowDist");
 		exit(1);
 	}
 }
 /**************************************************************************************************/
 
-float ShhherCommand::calcPairwiseDist(int numFlowCells, int seqA, int seqB, vector<int>& mapSeqToUnique, vector<int>& lengths, vector<double>& flowDataPrI, vector<short>& flowDataIntI){
+int ShhherCommand::flowDistParentFork(int numFlowCells, SparseDistanceMatrix* distMatrix, int stopSeq, vector<int>& mapUniqueToSeq, vector<int>& lengths, vector<short>& uniqueFlowDataIntI){
 	try{
-		int minLength = lengths[mapSeqToUnique[seqA]];
-		if(lengths[seqB] < minLength){	minLength = lengths[mapSeqToUnique[seqB]];	}
 		
-		int ANumFlowCells = seqA * numFlowCells;
-		int BNumFlowCells = seqB * numFlowCells;
+		int begTime = time(NULL);
+		double begClock = clock();
 		
-		float dist = 0;
+		vector<int> uniqueRowLengths(stopSeq, 0);
+		vector<int> uniqueSeqLengths(stopSeq, 0);
+		for(int i=0;i<stopSeq;i++){
+			uniqueRowLengths[i] = lengths[i];
+			uniqueSeqLengths[i] = lengths[mapUniqueToSeq[i]];
+		}
 		
-		for(int i=0;i<minLength;i++){
-			
-			if (m->getControl_pressed()) { break; }
-			
-			int flowAIntI = flowDataIntI[ANumFlowCells + i];
-			float flowAPrI = flowDataPrI[ANumFlowCells + i];
+		int numProcs = processors;
+		if (numProcs > stopSeq) { numProcs = stopSeq; }
+		if (numProcs < 1) { numProcs = 1; }
+		
+		//rows get longer as i grows, so split the triangle into pieces with the same number of pairs
+		vector<linePair> lines;
+		for (int i = 0; i < numProcs; i++) {
+			int start = int (sqrt(float(i)/float(numProcs)) * stopSeq);
+			int end = int (sqrt(float(i+1)/float(numProcs)) * stopSeq);
+			if (i == (numProcs-1)) { end = stopSeq; }
+			lines.push_back(linePair(start, end));
+		}
+		
+		//create array of worker threads
+		vector<thread*> workerThreads;
+		vector<flowDistData*> data;
+		
+		//Lauch worker threads
+		for (int i = 0; i < numProcs-1; i++) {
+			flowDistData* dataBundle = new flowDistData(&uniqueFlowDataIntI, &uniqueRowLengths, &uniqueSeqLengths, &pairLookUp, lines[i+1].start, lines[i+1].end, numFlowCells, cutoff, pairLookUpSlack);
+			data.push_back(dataBundle);
 			
-			int flowBIntI = flowDataIntI[BNumFlowCells + i];
-			float flowBPrI = flowDataPrI[BNumFlowCells + i];
-			dist += jointLookUp[flowAIntI * NUMBINS + flowBIntI] - flowAPrI - flowBPrI;
+			workerThreads.push_back(new thread(driverFlowDist, dataBundle));
 		}
 		
-		dist /= (float) minLength;
-		return dist;
+		flowDistData* dataBundle = new flowDistData(&uniqueFlowDataIntI, &uniqueRowLengths, &uniqueSeqLengths, &pairLookUp, lines[0].start, lines[0].end, numFlowCells, cutoff, pairLookUpSlack);
+		driverFlowDist(dataBundle);
+		data.insert(data.begin(), dataBundle);
+		
+		for (int i = 0; i < workerThreads.size(); i++) {
+			workerThreads[i]->join();
+			delete workerThreads[i];
+		}
+		
+		//add the cells in the same order the column file listed them
+		distMatrix->resize(stopSeq);
+		for (int i = 0; i < data.size(); i++) {
+			for (int j = 0; j < data[i]->dists.size(); j++) {
+				int row = data[i]->start + j;
+				vector<PDistCell>& cells = data[i]->dists[j];
+				for (int k = 0; k < cells.size(); k++) { distMatrix->addCell(cells[k].index, PDistCell(row, cells[k].dist)); }
+			}
+			delete data[i];
+		}
+		
+		if (!m->getControl_pressed()) {
+			m->mothurOutJustToScreen(toString(stopSeq-1) + "\t" + toString(time(NULL) - begTime));
+			m->mothurOutJustToScreen("\t" + toString((clock()-begClock)/CLOCKS_PER_SEC)+"\n");
+		}
+        
+        return 0;
 	}
 	catch(exception& e) {
-		m->errorOut(e, "ShhherCommand", "calcPairwiseDist");
+		m->errorOut(e, "ShhherCommand", "flowDistParentFork");
 		exit(1);
 	}
 }
-
+/**************************************************************************************************/
+//FNV-1a hash of the first length quantised flows
+inline unsigned long long hashFlowgram(const vector<short>& flowgram, int length){
+	unsigned long long hash = 14695981039346656037ULL;
+	for(int i=0;i<length;i++){
+		hash ^= (unsigned short)flowgram[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
 /**************************************************************************************************/
 
-int ShhherCommand::getUniques(int numSeqs, int numFlowCells, vector<short>& uniqueFlowgrams, vector<int>& uniqueCount, vector<int>& uniqueLengths, vector<int>& mapSeqToUnique, vector<int>& mapUniqueToSeq, vector<int>& lengths, vector<double>& flowDataPrI, vector<short>& flowDataIntI){
+int ShhherCommand::getUniques(int numSeqs, int numFlowCells, vector<short>& uniqueFlowgrams, vector<int>& uniqueCount, vector<int>& uniqueLengths, vector<int>& mapSeqToUnique, vector<int>& mapUniqueToSeq, vector<int>& lengths, vector<short>& uniqueFlowDataIntI, vector<short>& flowDataIntI){
 	try{
 		int numUniques = 0;
 		uniqueFlowgrams.assign(numFlowCells * numSeqs, -1);
@@ -888,20 +958,30 @@ int ShhherCommand::getUniques(int numSeqs, int numFlowCells, vector<short>& uniq
 		mapSeqToUnique.assign(numSeqs, -1);
 		mapUniqueToSeq.assign(numSeqs, -1);
 		
-		vector<short> uniqueFlowDataIntI(numFlowCells * numSeqs, -1);
+		uniqueFlowDataIntI.assign(numFlowCells * numSeqs, -1);
+		
+		//a flowgram matches a unique when they agree over the shorter of their lengths, so any match
+		//agrees over the shortest length in the file. Bucketing on that prefix leaves only real candidates to scan.
+		int keyLength = numFlowCells;
+		for(int i=0;i<numSeqs;i++){	if(lengths[i] < keyLength){	keyLength = lengths[i];	}	}
+		if(keyLength < 0){	keyLength = 0;	}
 		
+		map<unsigned long long, vector<int> > buckets; //prefix hash -> uniques with that prefix, in the order they were found
+		
+		vector<short> current(numFlowCells);
 		for(int i=0;i<numSeqs;i++){
 			
 			if (m->getControl_pressed()) { break; }
 			
-			int index = 0;
-			
-			vector<short> current(numFlowCells);
 			for(int j=0;j<numFlowCells;j++){
 				current[j] = short(((flowDataIntI[i * numFlowCells + j] + 50.0)/100.0));
 			}
-            
-			for(int j=0;j<numUniques;j++){
+			
+			vector<int>& candidates = buckets[hashFlowgram(current, keyLength)];
+			
+			int index = -1;
+			for(int c=0;c<candidates.size();c++){
+				int j = candidates[c];
 				int offset = j * numFlowCells;
 				bool toEnd = 1;
 				
@@ -923,10 +1003,9 @@ int ShhherCommand::getUniques(int numSeqs, int numFlowCells, vector<short>& uniq
 					if(lengths[i] > uniqueLengths[j])	{	uniqueLengths[j] = lengths[i];	}
 					break;
 				}
-				index++;
 			}
 			
-			if(index == numUniques){
+			if(index == -1){
 				uniqueLengths[numUniques] = lengths[i];
 				uniqueCount[numUniques] = 1;
 				mapSeqToUnique[i] = numUniques;//anMap
@@ -937,14 +1016,12 @@ int ShhherCommand::getUniques(int numSeqs, int numFlowCells, vector<short>& uniq
 					uniqueFlowDataIntI[numUniques * numFlowCells + k] = flowDataIntI[i * numFlowCells + k];
 				}
 				
+				candidates.push_back(numUniques);
 				numUniques++;
 			}
 		}
 		uniqueFlowDataIntI.resize(numFlowCells * numUniques);
 		uniqueLengths.resize(numUniques);	
-		
-		flowDataPrI.resize(numSeqs * numFlowCells, 0);
-		for(int i=0;i<flowDataPrI.size();i++)	{	if (m->getControl_pressed()) { break; } flowDataPrI[i] = getProbIntensity(flowDataIntI[i]);		}
         
         return numUniques;
 	}
@@ -954,7 +1031,8 @@ int ShhherCommand::getUniques(int numSeqs, int numFlowCells, vector<short>& uniq
 	}
 }
 /**************************************************************************************************/
-int ShhherCommand::createNamesFile(int numSeqs, int numUniques, string filename, vector<string>& seqNameVector, vector<int>& mapSeqToUnique, vector<int>& mapUniqueToSeq){
+//one bin per unique flowgram holding the names of the reads it represents
+ListVector ShhherCommand::createUniqueList(int numSeqs, int numUniques, vector<string>& seqNameVector, vector<int>& mapSeqToUnique){
 	try{
 		
 		vector<string> duplicateNames(numUniques, "");
@@ -962,44 +1040,38 @@ int ShhherCommand::createNamesFile(int numSeqs, int numUniques, string filename,
 			duplicateNames[mapSeqToUnique[i]] += seqNameVector[i] + ',';
 		}
 		
-		ofstream nameFile;
-		util.openOutputFile(filename, nameFile);
-		
+		ListVector uniqueList;
 		for(int i=0;i<numUniques;i++){
 			
 			if (m->getControl_pressed()) { break; }
 			
-            //			nameFile << seqNameVector[mapUniqueToSeq[i]] << '\t' << duplicateNames[i].substr(0, duplicateNames[i].find_last_of(',')) << endl;
-			nameFile << mapUniqueToSeq[i] << '\t' << duplicateNames[i].substr(0, duplicateNames[i].find_last_of(',')) << endl;
+			uniqueList.push_back(duplicateNames[i].substr(0, duplicateNames[i].find_last_of(',')));
 		}
-		
-		nameFile.close();
         
-		return 0;
+		return uniqueList;
 	}
 	catch(exception& e) {
-		m->errorOut(e, "ShhherCommand", "createNamesFile");
+		m->errorOut(e, "ShhherCommand", "createUniqueList");
 		exit(1);
 	}
 }
 //**********************************************************************************************************************
+//sorts biggest to smallest
+inline bool compareOTUSizes(const string& left, const string& right){
+    int countLeft = 0;
+    if (left != "") { countLeft = 1 + count(left.begin(), left.end(), ','); }
+    
+    int countRight = 0;
+    if (right != "") { countRight = 1 + count(right.begin(), right.end(), ','); }
+    
+    return (countLeft > countRight);
+}
+//**********************************************************************************************************************
 
-int ShhherCommand::cluster(string filename, string distFileName, string namesFileName){
+vector<string> ShhherCommand::cluster(SparseDistanceMatrix* matrix, ListVector& uniqueList){
 	try {
 		
-		ReadMatrix* read = new ReadColumnMatrix(distFileName); 	
-		read->setCutoff(cutoff);
-		
-		NameAssignment* clusterNameMap = new NameAssignment(namesFileName);
-		clusterNameMap->readMap();
-		read->read(clusterNameMap);
-        
-		ListVector* list = read->getListVector();
-		SparseDistanceMatrix* matrix = read->getDMatrix();
-		
-		delete read; 
-		delete clusterNameMap; 
-        
+		ListVector* list = new ListVector(uniqueList);
 		RAbundVector* rabund = new RAbundVector(list->getRAbundVector());
 		
         float adjust = -1.0;
@@ -1016,14 +1088,17 @@ int ShhherCommand::cluster(string filename, string distFileName, string namesFil
 		
 		list->setLabel(toString(cutoff));
 		
-		ofstream listFile;
-		util.openOutputFile(filename, listFile);
-		list->print(listFile, true);
-		listFile.close();
+		//largest otus first, the same order the list file was printed in
+		vector<string> hold;
+		for (int i = 0; i < list->size(); i++) { hold.push_back(list->get(i)); }
+		sort(hold.begin(), hold.end(), compareOTUSizes);
+		
+		vector<string> otus;
+		for (int i = 0; i < hold.size(); i++) { if (hold[i] != "") { otus.push_back(hold[i]); } }
 		
 		delete matrix;	delete cluster;	delete rabund; delete list;
         
-		return 0;
+		return otus;
 	}
 	catch(exception& e) {
 		m->errorOut(e, "ShhherCommand", "cluster");
@@ -1032,7 +1107,7 @@ int ShhherCommand::cluster(string filename, string distFileName, string namesFil
 }
 /**************************************************************************************************/
 
-int ShhherCommand::getOTUData(int numSeqs, string fileName,  vector<int>& otuData,
+int ShhherCommand::getOTUData(int numSeqs, vector<string>& otus,  vector<int>& otuData,
                                vector<int>& cumNumSeqs,
                                vector<int>& nSeqsPerOTU,
                                vector<vector<int> >& aaP,	//tMaster->aanP:	each row is a different otu / each col contains the sequence indices
@@ -1041,11 +1116,7 @@ int ShhherCommand::getOTUData(int numSeqs, string fileName,  vector<int>& otuDat
                                vector<int>& seqIndex,
                                map<string, int>& nameMap){
 	try {
-        InputData input(fileName, "list", nullVector);
-        ListVector* list = input.getListVector();
-        
-        string label = list->getLabel();
-        int numOTUs = list->getNumBins();
+        int numOTUs = otus.size();
         
         if (m->getDebug()) { m->mothurOut("[DEBUG]: Getting OTU Data...\n"); }
         
@@ -1063,9 +1134,7 @@ int ShhherCommand::getOTUData(int numSeqs, string fileName,  vector<int>& otuDat
 			if (m->getControl_pressed()) { break; }
             if (m->getDebug()) { m->mothurOut("[DEBUG]: processing OTU " + toString(i) + ".\n"); }
             
-			string singleOTU = list->get(i);
-			
-            vector<string> otuSeqs; util.splitAtComma(singleOTU, otuSeqs);
+            vector<string> otuSeqs; util.splitAtComma(otus[i], otuSeqs);
             
 			for(int j=0;j<otuSeqs.size();j++){
 				
@@ -1087,7 +1156,6 @@ int ShhherCommand::getOTUData(int numSeqs, string fileName,  vector<int>& otuDat
 		for(int i=1;i<numOTUs;i++){ cumNumSeqs[i] = cumNumSeqs[i-1] + nSeqsPerOTU[i-1]; }
 		aaI = aaP;
 		seqIndex = seqNumber;
-        delete list;
       
         return numOTUs;
 	}
@@ -1097,29 +1165,65 @@ int ShhherCommand::getOTUData(int numSeqs, string fileName,  vector<int>& otuDat
 	}		
 }
 /**************************************************************************************************/
-
-int ShhherCommand::calcCentroidsDriver(int numOTUs, 
-                                          vector<int>& cumNumSeqs,
-                                          vector<int>& nSeqsPerOTU,
-                                          vector<int>& seqIndex,
-                                          vector<short>& change,		//did the centroid sequence change? 0 = no; 1 = yes
-                                          vector<int>& centroids,		//the representative flowgram for each cluster m
-                                          vector<double>& singleTau,	//tMaster->adTau:	1-D Tau vector (1xnumSeqs)
-                                          vector<int>& mapSeqToUnique,
-                                          vector<short>& uniqueFlowgrams,
-                                          vector<short>& flowDataIntI,
-                                          vector<int>& lengths,
-                                          int numFlowCells,
-                                          vector<int>& seqNumber){                          
+//distances from one flowgram to several centroids. Each sum is still accumulated flow by flow in the
+//same order, but the sums are interleaved so they don't wait on each other
+inline void getDistsToCentroids(const short* flow, int length, const short* const* cents, int numCents, const double* lookUp, double* dists){
 	
-	//this function gets the most likely homopolymer length at a flow position for a group of sequences
-	//within an otu
+	int c = 0;
+	for(;c+4<=numCents;c+=4){
+		const short* centA = cents[c];
+		const short* centB = cents[c+1];
+		const short* centC = cents[c+2];
+		const short* centD = cents[c+3];
+		
+		double distA = 0; double distB = 0; double distC = 0; double distD = 0;
+		for(int i=0;i<length;i++){
+			int flowValue = flow[i];
+			distA += lookUp[centA[i] * NUMBINS + flowValue];
+			distB += lookUp[centB[i] * NUMBINS + flowValue];
+			distC += lookUp[centC[i] * NUMBINS + flowValue];
+			distD += lookUp[centD[i] * NUMBINS + flowValue];
+		}
+		dists[c] = distA / (double)length;
+		dists[c+1] = distB / (double)length;
+		dists[c+2] = distC / (double)length;
+		dists[c+3] = distD / (double)length;
+	}
 	
+	for(;c<numCents;c++){
+		const short* cent = cents[c];
+		double dist = 0;
+		for(int i=0;i<length;i++){	dist += lookUp[cent[i] * NUMBINS + flow[i]];	}
+		dists[c] = dist / (double)length;
+	}
+}
+/**************************************************************************************************/
+//this function gets the most likely homopolymer length at a flow position for a group of sequences
+//within an otu
+void driverCentroids(shhhEMData* params){
 	try{
-		
-		for(int i=0;i<numOTUs;i++){
-			
-			if (m->getControl_pressed()) { break; }
+		vector<int>& cumNumSeqs = *params->cumNumSeqs;
+		vector<int>& nSeqsPerOTU = *params->nSeqsPerOTU;
+		vector<int>& seqIndex = *params->seqIndex;
+		vector<int>& seqNumber = *params->seqNumber;
+		vector<int>& mapSeqToUnique = *params->mapSeqToUnique;
+		vector<int>& lengths = *params->lengths;
+		vector<int>& centroids = *params->centroids;
+		vector<short>& change = *params->change;
+		vector<double>& singleTau = *params->singleTau;
+		const short* uniqueFlowgrams = params->uniqueFlowgrams->data();
+		const short* flowDataIntI = params->flowDataIntI->data();
+		const double* lookUp = params->singleLookUp->data();
+		int numFlowCells = params->numFlowCells;
+		
+		vector<double> adF;
+		vector<int> anL;
+		vector<const short*> cents;
+		vector<double> dists;
+		
+		for(int i=params->start;i<params->end;i++){
+			
+			if (params->m->getControl_pressed()) { break; }
 			
 			double count = 0;
 			int position = 0;
@@ -1132,8 +1236,8 @@ int ShhherCommand::calcCentroidsDriver(int numOTUs,
 			}
             
 			if(nSeqsPerOTU[i] > 0 && count > MIN_COUNT){
-				vector<double> adF(nSeqsPerOTU[i]);
-				vector<int> anL(nSeqsPerOTU[i]);
+				adF.assign(nSeqsPerOTU[i], 0);
+				anL.assign(nSeqsPerOTU[i], 0);
 				
 				for(int j=0;j<nSeqsPerOTU[i];j++){
 					int index = cumNumSeqs[i] + j;
@@ -1153,15 +1257,19 @@ int ShhherCommand::calcCentroidsDriver(int numOTUs,
 					}						
 				}
 				
+				cents.resize(position);
+				dists.resize(position);
+				for(int k=0;k<position;k++){	cents[k] = uniqueFlowgrams + (size_t)anL[k] * numFlowCells;	}
+				
 				for(int j=0;j<nSeqsPerOTU[i];j++){
 					int index = cumNumSeqs[i] + j;
 					int nI = seqIndex[index];
 					
 					double tauValue = singleTau[seqNumber[index]];
 					
+					getDistsToCentroids(flowDataIntI + (size_t)nI * numFlowCells, lengths[nI], cents.data(), position, lookUp, dists.data());
 					for(int k=0;k<position;k++){
-						double dist = getDistToCentroid(anL[k], nI, lengths[nI], uniqueFlowgrams, flowDataIntI, numFlowCells);
-						adF[k] += dist * tauValue;
+						adF[k] += dists[k] * tauValue;
 					}
 				}
 				
@@ -1182,48 +1290,148 @@ int ShhherCommand::calcCentroidsDriver(int numOTUs,
 				centroids[i] = -1;			
 			}
 		}
-        
-        return 0;
 	}
 	catch(exception& e) {
-		m->errorOut(e, "ShhherCommand", "calcCentroidsDriver");
+		params->m->errorOut(e, "ShhherCommand", "driverCentroids");
 		exit(1);	
 	}		
 }
 /**************************************************************************************************/
-
-double ShhherCommand::getDistToCentroid(int cent, int flow, int length, vector<short>& uniqueFlowgrams,
-                                        vector<short>& flowDataIntI, int numFlowCells){
+//splits [0, num) into contiguous pieces, one per processor, with about the same amount of work in each
+vector<linePair> ShhherCommand::divideEMWork(int num, vector<double>& work){
 	try{
+		vector<linePair> lines;
 		
-		int flowAValue = cent * numFlowCells;
-		int flowBValue = flow * numFlowCells;
+		int numProcs = processors;
+		if (numProcs > num) { numProcs = num; }
+		if (numProcs < 1) { numProcs = 1; }
 		
-		double dist = 0;
-        
-		for(int i=0;i<length;i++){
-			dist += singleLookUp[uniqueFlowgrams[flowAValue] * NUMBINS + flowDataIntI[flowBValue]];
-			flowAValue++;
-			flowBValue++;
+		if (work.size() == 0) {
+			for (int i = 0; i < numProcs; i++) {
+				int start = int((float(i)/float(numProcs)) * num);
+				int end = int((float(i+1)/float(numProcs)) * num);
+				lines.push_back(linePair(start, end));
+			}
+			return lines;
+		}
+		
+		double totalWork = 0;
+		for (int i = 0; i < num; i++) { totalWork += work[i]; }
+		
+		double sum = 0;
+		int start = 0;
+		for (int i = 0; i < num; i++) {
+			sum += work[i];
+			if ((lines.size() < (numProcs-1)) && (sum >= (totalWork * (lines.size()+1) / (double)numProcs))) {
+				lines.push_back(linePair(start, i+1));
+				start = i+1;
+			}
+		}
+		lines.push_back(linePair(start, num));
+		
+		return lines;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ShhherCommand", "divideEMWork");
+		exit(1);	
+	}		
+}
+/**************************************************************************************************/
+//runs driver on each piece of lines, the first on this thread. The caller owns the returned bundles.
+vector<shhhEMData*> ShhherCommand::runEMDriver(void (*driver)(shhhEMData*), shhhEMData& shared, vector<linePair>& lines){
+	try{
+		vector<thread*> workerThreads;
+		vector<shhhEMData*> data;
+		
+		for (int i = 0; i < lines.size(); i++) {
+			shhhEMData* dataBundle = new shhhEMData(shared);
+			dataBundle->start = lines[i].start;
+			dataBundle->end = lines[i].end;
+			data.push_back(dataBundle);
+		}
+		
+		//Lauch worker threads
+		for (int i = 1; i < data.size(); i++) {
+			workerThreads.push_back(new thread(driver, data[i]));
+		}
+		
+		if (data.size() != 0) { driver(data[0]); }
+		
+		for (int i = 0; i < workerThreads.size(); i++) {
+			workerThreads[i]->join();
+			delete workerThreads[i];
 		}
 		
-		return dist / (double)length;
+		return data;
 	}
 	catch(exception& e) {
-		m->errorOut(e, "ShhherCommand", "getDistToCentroid");
+		m->errorOut(e, "ShhherCommand", "runEMDriver");
 		exit(1);	
 	}		
 }
 /**************************************************************************************************/
 
-double ShhherCommand::getNewWeights(int numOTUs, vector<int>& cumNumSeqs, vector<int>& nSeqsPerOTU, vector<double>& singleTau, vector<int>& seqNumber, vector<double>& weight){
+int ShhherCommand::calcCentroidsDriver(int numOTUs, 
+                                          vector<int>& cumNumSeqs,
+                                          vector<int>& nSeqsPerOTU,
+                                          vector<int>& seqIndex,
+                                          vector<short>& change,		//did the centroid sequence change? 0 = no; 1 = yes
+                                          vector<int>& centroids,		//the representative flowgram for each cluster m
+                                          vector<double>& singleTau,	//tMaster->adTau:	1-D Tau vector (1xnumSeqs)
+                                          vector<int>& mapSeqToUnique,
+                                          vector<short>& uniqueFlowgrams,
+                                          vector<short>& flowDataIntI,
+                                          vector<int>& lengths,
+                                          int numFlowCells,
+                                          vector<int>& seqNumber){                          
 	try{
 		
+		shhhEMData shared;
+		shared.cumNumSeqs = &cumNumSeqs;
+		shared.nSeqsPerOTU = &nSeqsPerOTU;
+		shared.seqIndex = &seqIndex;
+		shared.seqNumber = &seqNumber;
+		shared.change = &change;
+		shared.centroids = &centroids;
+		shared.singleTau = &singleTau;
+		shared.mapSeqToUnique = &mapSeqToUnique;
+		shared.uniqueFlowgrams = &uniqueFlowgrams;
+		shared.flowDataIntI = &flowDataIntI;
+		shared.lengths = &lengths;
+		shared.singleLookUp = &singleLookUp;
+		shared.numFlowCells = numFlowCells;
+		shared.numOTUs = numOTUs;
+		
+		//the work in an otu grows with the square of its size and the biggest otus come first
+		vector<double> work(numOTUs, 0);
+		for (int i = 0; i < numOTUs; i++) { work[i] = 1.0 + (double)nSeqsPerOTU[i] * (double)nSeqsPerOTU[i]; }
+		
+		vector<linePair> lines = divideEMWork(numOTUs, work);
+		vector<shhhEMData*> data = runEMDriver(driverCentroids, shared, lines);
+		for (int i = 0; i < data.size(); i++) { delete data[i]; }
+        
+        return 0;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ShhherCommand", "calcCentroidsDriver");
+		exit(1);	
+	}		
+}
+/**************************************************************************************************/
+
+void driverNewWeights(shhhEMData* params){
+	try{
+		vector<int>& cumNumSeqs = *params->cumNumSeqs;
+		vector<int>& nSeqsPerOTU = *params->nSeqsPerOTU;
+		vector<int>& seqNumber = *params->seqNumber;
+		vector<double>& singleTau = *params->singleTau;
+		vector<double>& weight = *params->weight;
+		
 		double maxChange = 0;
 		
-		for(int i=0;i<numOTUs;i++){
+		for(int i=params->start;i<params->end;i++){
 			
-			if (m->getControl_pressed()) { break; }
+			if (params->m->getControl_pressed()) { break; }
 			
 			double difference = weight[i];
 			weight[i] = 0;
@@ -1237,6 +1445,39 @@ double ShhherCommand::getNewWeights(int numOTUs, vector<int>& cumNumSeqs, vector
 			difference = fabs(weight[i] - difference);
 			if(difference > maxChange){	maxChange = difference;	}
 		}
+		
+		params->maxChange = maxChange;
+	}
+	catch(exception& e) {
+		params->m->errorOut(e, "ShhherCommand", "driverNewWeights");
+		exit(1);	
+	}		
+}
+/**************************************************************************************************/
+
+double ShhherCommand::getNewWeights(int numOTUs, vector<int>& cumNumSeqs, vector<int>& nSeqsPerOTU, vector<double>& singleTau, vector<int>& seqNumber, vector<double>& weight){
+	try{
+		
+		shhhEMData shared;
+		shared.cumNumSeqs = &cumNumSeqs;
+		shared.nSeqsPerOTU = &nSeqsPerOTU;
+		shared.singleTau = &singleTau;
+		shared.seqNumber = &seqNumber;
+		shared.weight = &weight;
+		shared.numOTUs = numOTUs;
+		
+		vector<double> work(numOTUs, 0);
+		for (int i = 0; i < numOTUs; i++) { work[i] = 1.0 + nSeqsPerOTU[i]; }
+		
+		vector<linePair> lines = divideEMWork(numOTUs, work);
+		vector<shhhEMData*> data = runEMDriver(driverNewWeights, shared, lines);
+		
+		double maxChange = 0;
+		for (int i = 0; i < data.size(); i++) {
+			if(data[i]->maxChange > maxChange){	maxChange = data[i]->maxChange;	}
+			delete data[i];
+		}
+		
 		return maxChange;
 	}
 	catch(exception& e) {
@@ -1244,7 +1485,34 @@ double ShhherCommand::getNewWeights(int numOTUs, vector<int>& cumNumSeqs, vector
 		exit(1);	
 	}		
 }
+/**************************************************************************************************/
 
+void driverLikelihoodTerms(shhhEMData* params){
+	try{
+		vector<int>& cumNumSeqs = *params->cumNumSeqs;
+		vector<int>& nSeqsPerOTU = *params->nSeqsPerOTU;
+		vector<int>& seqNumber = *params->seqNumber;
+		vector<double>& dist = *params->dist;
+		vector<double>& weight = *params->weight;
+		vector<double>& terms = *params->terms;
+		
+		for(int i=params->start;i<params->end;i++){
+			
+			if (params->m->getControl_pressed()) { break; }
+			
+			for(int j=0;j<nSeqsPerOTU[i];j++){
+				int index = cumNumSeqs[i] + j;
+				double singleDist = dist[seqNumber[index]];
+				
+				terms[index] = weight[i] * exp(-singleDist * params->sigma);
+			}
+		}
+	}
+	catch(exception& e) {
+		params->m->errorOut(e, "ShhherCommand", "driverLikelihoodTerms");
+		exit(1);	
+	}		
+}
 /**************************************************************************************************/
 
 double ShhherCommand::getLikelihood(int numSeqs, int numOTUs, vector<int>& nSeqsPerOTU, vector<int>& seqNumber, vector<int>& cumNumSeqs, vector<int>& seqIndex, vector<double>& dist, vector<double>& weight){
@@ -1260,7 +1528,28 @@ double ShhherCommand::getLikelihood(int numSeqs, int numOTUs, vector<int>& nSeqs
 			}
 		}
 		
-		string hold;
+		int numTerms = 0;
+		for(int i=0;i<numOTUs;i++){ numTerms += nSeqsPerOTU[i]; }
+		vector<double> terms(numTerms, 0);
+		
+		//the exponentials are done in parallel, the sums are still added up in otu order
+		shhhEMData shared;
+		shared.cumNumSeqs = &cumNumSeqs;
+		shared.nSeqsPerOTU = &nSeqsPerOTU;
+		shared.seqNumber = &seqNumber;
+		shared.dist = &dist;
+		shared.weight = &weight;
+		shared.terms = &terms;
+		shared.sigma = sigma;
+		shared.numOTUs = numOTUs;
+		
+		vector<double> work(numOTUs, 0);
+		for (int i = 0; i < numOTUs; i++) { work[i] = 1.0 + nSeqsPerOTU[i]; }
+		
+		vector<linePair> lines = divideEMWork(numOTUs, work);
+		vector<shhhEMData*> data = runEMDriver(driverLikelihoodTerms, shared, lines);
+		for (int i = 0; i < data.size(); i++) { delete data[i]; }
+		
 		for(int i=0;i<numOTUs;i++){
 			
 			if (m->getControl_pressed()) { break; }
@@ -1268,9 +1557,8 @@ double ShhherCommand::getLikelihood(int numSeqs, int numOTUs, vector<int>& nSeqs
 			for(int j=0;j<nSeqsPerOTU[i];j++){
 				int index = cumNumSeqs[i] + j;
 				int nI = seqIndex[index];
-				double singleDist = dist[seqNumber[index]];
 				
-				P[nI] += weight[i] * exp(-singleDist * sigma);
+				P[nI] += terms[index];
 			}
 		}
 		double nLL = 0.00;
@@ -1331,43 +1619,53 @@ int ShhherCommand::checkCentroids(int numOTUs, vector<int>& centroids, vector<do
 }
 /**************************************************************************************************/
 
-void ShhherCommand::calcNewDistances(int numSeqs, int numOTUs, vector<int>& nSeqsPerOTU, vector<double>& dist, 
-                                     vector<double>& weight, vector<short>& change, vector<int>& centroids,
-                                     vector<vector<int> >& aaP,	vector<double>& singleTau, vector<vector<int> >& aaI,	
-                                     vector<int>& seqNumber, vector<int>& seqIndex,
-                                     vector<short>& uniqueFlowgrams,
-                                     vector<short>& flowDataIntI, int numFlowCells, vector<int>& lengths){
-	
+void driverNewDistances(shhhEMData* params){
 	try{
+		vector<double>& dist = *params->dist;
+		vector<double>& weight = *params->weight;
+		vector<short>& change = *params->change;
+		vector<int>& centroids = *params->centroids;
+		vector<int>& lengths = *params->lengths;
+		const short* uniqueFlowgrams = params->uniqueFlowgrams->data();
+		const short* flowDataIntI = params->flowDataIntI->data();
+		const double* lookUp = params->singleLookUp->data();
+		int numFlowCells = params->numFlowCells;
+		int numOTUs = params->numOTUs;
 		
-		int total = 0;
 		vector<double> newTau(numOTUs,0);
-		vector<double> norms(numSeqs, 0);
-		nSeqsPerOTU.assign(numOTUs, 0);
-        
-		for(int i=0;i<numSeqs;i++){
+		
+		//the otus whose centroid moved, their distances are the only ones that need updating
+		vector<int> changed;
+		vector<const short*> cents;
+		for(int j=0;j<numOTUs;j++){
+			if(weight[j] > MIN_WEIGHT && change[j] == 1){
+				changed.push_back(j);
+				cents.push_back(uniqueFlowgrams + (size_t)centroids[j] * numFlowCells);
+			}
+		}
+		vector<double> dists(changed.size(), 0);
+		
+		for(int i=params->start;i<params->end;i++){
 			
-			if (m->getControl_pressed()) { break; }
+			if (params->m->getControl_pressed()) { break; }
 			
-			int indexOffset = i * numOTUs;
+			size_t indexOffset = (size_t)i * numOTUs;
             
-			double offset = 1e8;
+			getDistsToCentroids(flowDataIntI + (size_t)i * numFlowCells, lengths[i], cents.data(), cents.size(), lookUp, dists.data());
+			for(int k=0;k<changed.size();k++){	dist[indexOffset + changed[k]] = dists[k];	}
 			
+			double offset = 1e8;
 			for(int j=0;j<numOTUs;j++){
-                
-				if(weight[j] > MIN_WEIGHT && change[j] == 1){
-					dist[indexOffset + j] = getDistToCentroid(centroids[j], i, lengths[i], uniqueFlowgrams, flowDataIntI, numFlowCells);
-				}
-                
 				if(weight[j] > MIN_WEIGHT && dist[indexOffset + j] < offset){
 					offset = dist[indexOffset + j];
 				}
 			}
             
+			double norm = 0;
 			for(int j=0;j<numOTUs;j++){
 				if(weight[j] > MIN_WEIGHT){
-					newTau[j] = exp(sigma * (-dist[indexOffset + j] + offset)) * weight[j];
-					norms[i] += newTau[j];
+					newTau[j] = exp(params->sigma * (-dist[indexOffset + j] + offset)) * weight[j];
+					norm += newTau[j];
 				}
 				else{
 					newTau[j] = 0.0;
@@ -1375,36 +1673,83 @@ void ShhherCommand::calcNewDistances(int numSeqs, int numOTUs, vector<int>& nSeq
 			}
             
 			for(int j=0;j<numOTUs;j++){
-				newTau[j] /= norms[i];
+				newTau[j] /= norm;
 			}
             
 			for(int j=0;j<numOTUs;j++){
 				if(newTau[j] > MIN_TAU){
-					
-					int oldTotal = total;
-					
-					total++;
-					
-					singleTau.resize(total, 0);
-					seqNumber.resize(total, 0);
-					seqIndex.resize(total, 0);
-					
-					singleTau[oldTotal] = newTau[j];
-					
-					aaP[j][nSeqsPerOTU[j]] = oldTotal;
-					aaI[j][nSeqsPerOTU[j]] = i;
-					nSeqsPerOTU[j]++;
+					params->tauSeqs.push_back(i);
+					params->tauOTUs.push_back(j);
+					params->tauValues.push_back(newTau[j]);
 				}
 			}
-            
 		}
-        
+	}
+	catch(exception& e) {
+		params->m->errorOut(e, "ShhherCommand", "driverNewDistances");
+		exit(1);	
+	}		
+}
+/**************************************************************************************************/
+
+void ShhherCommand::calcNewDistances(int numSeqs, int numOTUs, vector<int>& nSeqsPerOTU, vector<double>& dist, 
+                                     vector<double>& weight, vector<short>& change, vector<int>& centroids,
+                                     vector<vector<int> >& aaP,	vector<double>& singleTau, vector<vector<int> >& aaI,	
+                                     vector<int>& seqNumber, vector<int>& seqIndex,
+                                     vector<short>& uniqueFlowgrams,
+                                     vector<short>& flowDataIntI, int numFlowCells, vector<int>& lengths){
+	
+	try{
+		
+		shhhEMData shared;
+		shared.dist = &dist;
+		shared.weight = &weight;
+		shared.change = &change;
+		shared.centroids = &centroids;
+		shared.lengths = &lengths;
+		shared.uniqueFlowgrams = &uniqueFlowgrams;
+		shared.flowDataIntI = &flowDataIntI;
+		shared.singleLookUp = &singleLookUp;
+		shared.numFlowCells = numFlowCells;
+		shared.numOTUs = numOTUs;
+		shared.sigma = sigma;
+		
+		vector<double> work;
+		vector<linePair> lines = divideEMWork(numSeqs, work);
+		vector<shhhEMData*> data = runEMDriver(driverNewDistances, shared, lines);
+		
+		//the sequences are added to the otus in the same order as a single pass would
+		int total = 0;
+		nSeqsPerOTU.assign(numOTUs, 0);
+		
+		for (int t = 0; t < data.size(); t++) {
+			for (int k = 0; k < data[t]->tauValues.size(); k++) {
+				int i = data[t]->tauSeqs[k];
+				int j = data[t]->tauOTUs[k];
+				
+				int oldTotal = total;
+				
+				total++;
+				
+				singleTau.resize(total, 0);
+				seqNumber.resize(total, 0);
+				seqIndex.resize(total, 0);
+				
+				singleTau[oldTotal] = data[t]->tauValues[k];
+				
+				aaP[j][nSeqsPerOTU[j]] = oldTotal;
+				aaI[j][nSeqsPerOTU[j]] = i;
+				nSeqsPerOTU[j]++;
+			}
+			delete data[t];
+		}
 	}
 	catch(exception& e) {
 		m->errorOut(e, "ShhherCommand", "calcNewDistances");
 		exit(1);	
 	}		
 }
+
 /**************************************************************************************************/
 
 int ShhherCommand::fill(int numOTUs, vector<int>& seqNumber, vector<int>& seqIndex, vector<int>& cumNumSeqs, vector<int>& nSeqsPerOTU, vector<vector<int> >& aaP, vector<vector<int> >& aaI){
@@ -1812,6 +2157,35 @@ void ShhherCommand::getJointLookUp(){
 	}
 }
 
+/**************************************************************************************************/
+//	the per flow term of the distance between two flowgrams: jointLookUp less the probability of each intensity
+void ShhherCommand::getPairLookUp(){
+	try{
+		
+		vector<float> probIntensity(NUMBINS, 0);
+		for(int i=0;i<NUMBINS;i++){	probIntensity[i] = getProbIntensity(i);	}
+		
+		pairLookUp.resize(NUMBINS * NUMBINS, 0);
+		pairLookUpSlack = 0;
+		
+		for(int i=0;i<NUMBINS;i++){
+			
+			if (m->getControl_pressed()) { break; }
+			
+			for(int j=0;j<NUMBINS;j++){
+				pairLookUp[i * NUMBINS + j] = jointLookUp[i * NUMBINS + j] - probIntensity[i] - probIntensity[j];
+				
+				//the joint minimum can't be below the sum of the single minimums, anything negative here is rounding
+				if(-pairLookUp[i * NUMBINS + j] > pairLookUpSlack)	{	pairLookUpSlack = -pairLookUp[i * NUMBINS + j];	}
+			}
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "ShhherCommand", "getPairLookUp");
+		exit(1);
+	}
+}
+
 /**************************************************************************************************/
 
 double ShhherCommand::getProbIntensity(int intIntensity){                          
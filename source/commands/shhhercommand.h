@@ -29,8 +29,11 @@
 #define MIN_WEIGHT 0.1
 #define MIN_TAU 0.0001
 #define MIN_ITER 10
+#define FLOWDIST_BLOCK_SIZE 64
 //**********************************************************************************************************************
 
+struct shhhEMData;
+
 class ShhherCommand : public Command {
 	
 public:
@@ -54,26 +57,28 @@ private:
 	bool abort, large;
 	string outputDir, flowFileName, flowFilesFileName, lookupFileName, compositeFASTAFileName, compositeNamesFileName;
 
-	int maxIters, largeSize;
+	int maxIters, largeSize, processors;
 	float cutoff, sigma, minDelta;
 	string flowOrder;
     
     vector<string> outputNames;
 	vector<double> singleLookUp;
 	vector<double> jointLookUp;
+	vector<double> pairLookUp;
+	float pairLookUpSlack;
     vector<string> flowFileVector;
 	
     vector<string> parseFlowFiles(string);
     int driver(vector<string>, string, string);
     int getFlowData(string, vector<string>&, vector<int>&, vector<short>&, map<string, int>&, int&);
-    int getUniques(int, int, vector<short>&, vector<int>&, vector<int>&, vector<int>&, vector<int>&, vector<int>&, vector<double>&, vector<short>&);
-    int flowDistParentFork(int, string, int, vector<int>&, vector<int>&, vector<int>&, vector<double>&, vector<short>&);
-    float calcPairwiseDist(int, int, int, vector<int>&, vector<int>&, vector<double>&, vector<short>&);
-    int createNamesFile(int, int, string, vector<string>&, vector<int>&, vector<int>&);
-    int cluster(string, string, string);
-    int getOTUData(int numSeqs, string,  vector<int>&, vector<int>&, vector<int>&, vector<vector<int> >&, vector<vector<int> >&, vector<int>&, vector<int>&,map<string, int>&);
+    int getUniques(int, int, vector<short>&, vector<int>&, vector<int>&, vector<int>&, vector<int>&, vector<int>&, vector<short>&, vector<short>&);
+    int flowDistParentFork(int, SparseDistanceMatrix*, int, vector<int>&, vector<int>&, vector<short>&);
+    ListVector createUniqueList(int, int, vector<string>&, vector<int>&);
+    vector<string> cluster(SparseDistanceMatrix*, ListVector&);
+    int getOTUData(int numSeqs, vector<string>&,  vector<int>&, vector<int>&, vector<int>&, vector<vector<int> >&, vector<vector<int> >&, vector<int>&, vector<int>&,map<string, int>&);
     int calcCentroidsDriver(int numOTUs, vector<int>&, vector<int>&, vector<int>&, vector<short>&, vector<int>&, vector<double>&, vector<int>&, vector<short>&, vector<short>&, vector<int>&, int, vector<int>&);
-    double getDistToCentroid(int, int, int, vector<short>&, vector<short>&, int);
+    vector<linePair> divideEMWork(int, vector<double>&);
+    vector<shhhEMData*> runEMDriver(void (*)(shhhEMData*), shhhEMData&, vector<linePair>&);
     double getNewWeights(int, vector<int>&, vector<int>&, vector<double>&, vector<int>&, vector<double>&);
     
     double getLikelihood(int, int, vector<int>&, vector<int>&, vector<int>&, vector<int>&, vector<double>&, vector<double>&);
@@ -90,9 +95,71 @@ private:
     
 	void getSingleLookUp();
 	void getJointLookUp();
+	void getPairLookUp();
     double getProbIntensity(int);
 };
 
+//**********************************************************************************************************************
+struct flowDistData {
+	vector<short>* uniqueFlowDataIntI;
+	vector<int>* uniqueRowLengths;      //lengths[i] for unique i
+	vector<int>* uniqueSeqLengths;      //lengths[mapUniqueToSeq[i]] for unique i
+	vector<double>* pairLookUp;
+	vector< vector<PDistCell> > dists;  //dists[i-start] holds the cells within the cutoff for row i, ordered by column
+	int start, end, numFlowCells;
+	float cutoff, slack;
+	MothurOut* m;
+	
+	flowDistData(){}
+	flowDistData(vector<short>* intI, vector<int>* rowLengths, vector<int>* seqLengths, vector<double>* lookUp, int st, int en, int nf, float cut, float sl) {
+		m = MothurOut::getInstance();
+		uniqueFlowDataIntI = intI;
+		uniqueRowLengths = rowLengths;
+		uniqueSeqLengths = seqLengths;
+		pairLookUp = lookUp;
+		start = st;
+		end = en;
+		numFlowCells = nf;
+		cutoff = cut;
+		slack = sl;
+		if (end > start) { dists.resize(end-start); }
+	}
+};
+//**********************************************************************************************************************
+//shared by the EM steps, each thread gets a copy with its own range of otus or sequences
+struct shhhEMData {
+	vector<int>* cumNumSeqs;
+	vector<int>* nSeqsPerOTU;
+	vector<int>* seqNumber;
+	vector<int>* seqIndex;
+	vector<int>* mapSeqToUnique;
+	vector<int>* lengths;
+	vector<int>* centroids;
+	vector<short>* change;
+	vector<short>* uniqueFlowgrams;
+	vector<short>* flowDataIntI;
+	vector<double>* singleTau;
+	vector<double>* weight;
+	vector<double>* dist;
+	vector<double>* singleLookUp;
+	vector<double>* terms;
+	int numOTUs, numFlowCells, start, end;
+	double sigma, maxChange;
+	
+	//new tau values over MIN_TAU found by calcNewDistances, in sequence then otu order
+	vector<int> tauSeqs, tauOTUs;
+	vector<double> tauValues;
+	MothurOut* m;
+	
+	shhhEMData() {
+		m = MothurOut::getInstance();
+		cumNumSeqs = NULL; nSeqsPerOTU = NULL; seqNumber = NULL; seqIndex = NULL; mapSeqToUnique = NULL; lengths = NULL; centroids = NULL;
+		change = NULL; uniqueFlowgrams = NULL; flowDataIntI = NULL;
+		singleTau = NULL; weight = NULL; dist = NULL; singleLookUp = NULL; terms = NULL;
+		numOTUs = 0; numFlowCells = 0; start = 0; end = 0;
+		sigma = 0; maxChange = 0;
+	}
+};
 //**********************************************************************************************************************
 
 #endif
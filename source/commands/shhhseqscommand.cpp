@@ -268,6 +268,7 @@ int driver(seqNoise& noise,
             otuFreq.assign(numOTUs, 0);
             
             int total = 0;
+            vector<double> currentTau(numOTUs);
             
             for(int i=0;i<numSeqs;i++){
                 if (m->getControl_pressed()) { return 0; }
@@ -275,7 +276,6 @@ int driver(seqNoise& noise,
                 double offset = 1e6;
                 double norm = 0.0000;
                 double minWeight = 0.1;
-                vector<double> currentTau(numOTUs);
                 
                 for(int j=0;j<numOTUs;j++){
                     if (m->getControl_pressed()) { return 0; }
@@ -377,6 +377,7 @@ int ShhhSeqsCommand::execute() {
 			vector<int> seqFreq;
 			
 			seqNoise noise;
+			noise.setProcessors(processors);
 			correctDist* correct = new correctDist(processors);
 			
 			//reads fasta and name file and loads them in order
@@ -9,6 +9,7 @@
 #include "sortseqscommand.h"
 #include "sequence.hpp"
 #include "qualityscores.h"
+#include "externalsort.hpp"
 
 //**********************************************************************************************************************
 vector<string> SortSeqsCommand::setParameters(){	
@@ -279,7 +280,8 @@ int SortSeqsCommand::execute(){
         if (accnosfile != "")		{		
             vector<string> temp;
             util.readAccnos(accnosfile, temp);
-            for (int i = 0; i < temp.size(); i++) {  names[temp[i]] = i;  }
+            //a repeated name keeps its first place, so the places run from 0 to names.size()-1 and can index the records
+            for (int i = 0; i < temp.size(); i++) {  names.insert(make_pair(temp[i], (int)names.size()));  }
             m->mothurOut("\nUsing " + accnosfile + " to determine the order. It contains " + toString(temp.size()) + " representative sequences.\n");	
         }
         
@@ -367,14 +369,14 @@ int SortSeqsCommand::readFasta(){
 		
         if (names.size() != 0) {//this is not the first file we are reading so we need to use the order we already have
             
-            if (large) { //if the file is too large to fit in memory we can still process it, but the io will be very time consuming.
-                //read through the file looking for 1000 seqs at a time. Once we find them output them and start looking for the next 1000.
-                //this way we only store 1000 seqs in memory at a time.
-                
+            if (large) { //if the file is too large to fit in memory, the records are sorted by their place in the order in runs written to disk and merged
                 int numNames = names.size();
                 int numNamesInFile = 0;
+                vector<bool> added; added.resize(names.size(), false);
+                
+                int processors = 1; util.mothurConvert(current->getProcessors(), processors);
+                ExternalSort sorter(outputFileName, processors, m->getSortMemory(), false);
                 
-                //to make sure we dont miss any seqs, add any seqs that are not in names but in the file to the end of names
                 while(!in.eof()){
                     if (m->getControl_pressed()) { in.close();  out.close();  util.mothurRemove(outputFileName);  return 0; }
                     
@@ -385,75 +387,22 @@ int SortSeqsCommand::readFasta(){
                         numNamesInFile++;
                         map<string, int>::iterator it = names.find(name);
                         if (it == names.end()) { 
-                            names[name] = numNames; numNames++;
+                            it = names.insert(make_pair(name, numNames)).first; numNames++; added.push_back(false);
                             m->mothurOut(name + " was not in the contained the file which determined the order, adding it to the end.\n");
                         }
+                        
+                        if (!added[it->second]) { //the first record with a name is kept
+                            added[it->second] = true;
+                            ostringstream record; currSeq.printSequence(record);
+                            sorter.add(ExternalSort::encodeKey((unsigned long long)it->second), record.str());
+                        }
                     }
                     util.gobble(in);
                 }
                 in.close();
                 out.close();
                 
-                int numLeft = names.size();
-                if (numNamesInFile < numLeft) { numLeft = numNamesInFile; }
-                
-                int size = 1000; //assume that user can hold 1000 seqs in memory
-                if (numLeft < size) { size = numLeft; }
-                int times = 0;
-                
-                vector<Sequence> seqs; seqs.resize(size);
-                for (int i = 0; i < seqs.size(); i++) { seqs[i].setName(""); } //this is so if some of the seqs are missing we dont print out garbage
-                
-                while (numLeft > 0) {
-                    
-                    ifstream in2;
-                    util.openInputFile(fastafile, in2);
-                    
-                    if (m->getControl_pressed()) { in2.close();  util.mothurRemove(outputFileName);  return 0; }
-                    
-                    int found = 0;
-                    int needToFind = size;
-                    if (numLeft < size) { needToFind = numLeft; }
-                    
-                    while(!in2.eof()){
-                        if (m->getControl_pressed()) { in2.close();   util.mothurRemove(outputFileName);  return 0; }
-                        
-                        //stop reading if we already found the seqs we are looking for
-                        if (found >= needToFind) { break; }
-                        
-                        Sequence currSeq(in2);
-                        name = currSeq.getName();
-                        
-                        if (name != "") {
-                            map<string, int>::iterator it = names.find(name);
-                            if (it != names.end()) { //we found it, so put it in the vector in the right place.
-                                //is it in the set of seqs we are looking for this time around
-                                int thisSeqsPlace = it->second;
-                                thisSeqsPlace -= (times * size);
-                                if ((thisSeqsPlace < size) && (thisSeqsPlace >= 0)) {
-                                    seqs[thisSeqsPlace] = currSeq; 
-                                    found++;
-                                }
-                            }else { m->mothurOut("[ERROR]: in logic of readFasta function.\n"); m->setControl_pressed(true); }
-                        }
-                        util.gobble(in2);
-                    }
-                    in2.close();	
-
-                    ofstream out2;
-                    util.openOutputFileAppend(outputFileName, out2);
-                    
-                    int output = seqs.size();
-                    if (numLeft < seqs.size()) { output = numLeft; }
-                        
-                    for (int i = 0; i < output; i++) {
-                        if (seqs[i].getName() != "") { seqs[i].printSequence(out2); }
-                    }
-                    out2.close();
-                    
-                    times++;
-                    numLeft -= output;
-                }
+                sorter.output(outputFileName);
                 
                 m->mothurOut("Ordered " + toString(numNamesInFile) + " sequences from " + fastafile + ".\n");
             }else {
@@ -503,7 +452,7 @@ int SortSeqsCommand::readFasta(){
                 
                 if (name != "") {
                     //if this name is in the accnos file
-                    names[name] = count;
+                    names.insert(make_pair(name, (int)names.size()));
                     count++;
                     currSeq.printSequence(out);
                 }
@@ -546,14 +495,14 @@ int SortSeqsCommand::readFlow(){
 		
         if (names.size() != 0) {//this is not the first file we are reading so we need to use the order we already have
             
-            if (large) { //if the file is too large to fit in memory we can still process it, but the io will be very time consuming.
-                //read through the file looking for 1000 seqs at a time. Once we find them output them and start looking for the next 1000.
-                //this way we only store 1000 seqs in memory at a time.
-                
+            if (large) { //if the file is too large to fit in memory, the records are sorted by their place in the order in runs written to disk and merged
                 int numNames = names.size();
                 int numNamesInFile = 0;
+                vector<bool> added; added.resize(names.size(), false);
+                
+                int processors = 1; util.mothurConvert(current->getProcessors(), processors);
+                ExternalSort sorter(outputFileName, processors, m->getSortMemory(), false);
                 
-                //to make sure we dont miss any seqs, add any seqs that are not in names but in the file to the end of names
                 while(!in.eof()){
                     if (m->getControl_pressed()) { in.close();  out.close();  util.mothurRemove(outputFileName);  return 0; }
                     
@@ -564,76 +513,21 @@ int SortSeqsCommand::readFlow(){
                         numNamesInFile++;
                         map<string, int>::iterator it = names.find(name);
                         if (it == names.end()) { 
-                            names[name] = numNames; numNames++;
+                            it = names.insert(make_pair(name, numNames)).first; numNames++; added.push_back(false);
                             m->mothurOut(name + " was not in the contained the file which determined the order, adding it to the end.\n");
                         }
+                        
+                        if (!added[it->second]) { //the first record with a name is kept
+                            added[it->second] = true;
+                            sorter.add(ExternalSort::encodeKey((unsigned long long)it->second), name + '\t' + rest + '\n');
+                        }
                     }
                     util.gobble(in);
                 }
                 in.close();
                 out.close();
                 
-                int numLeft = names.size();
-                if (numNamesInFile < numLeft) { numLeft = numNamesInFile; }
-                
-                int size = 1000; //assume that user can hold 1000 seqs in memory
-                if (numLeft < size) { size = numLeft; }
-                int times = 0;
-                
-                vector<string> seqs; seqs.resize(size, "");
-                
-                while (numLeft > 0) {
-                    
-                    ifstream in2;
-                    util.openInputFile(flowfile, in2); in2 >> numFlows; util.gobble(in2);
-                    
-                    if (m->getControl_pressed()) { in2.close();  util.mothurRemove(outputFileName);  return 0; }
-                    
-                    int found = 0;
-                    int needToFind = size;
-                    if (numLeft < size) { needToFind = numLeft; }
-                    
-                    while(!in2.eof()){
-                        if (m->getControl_pressed()) { in2.close();   util.mothurRemove(outputFileName);  return 0; }
-                        
-                        //stop reading if we already found the seqs we are looking for
-                        if (found >= needToFind) { break; }
-                        
-                        in2 >> name;	
-                        string rest = util.getline(in2);
-                        
-                        if (name != "") {
-                            map<string, int>::iterator it = names.find(name);
-                            if (it != names.end()) { //we found it, so put it in the vector in the right place.
-                                //is it in the set of seqs we are looking for this time around
-                                int thisSeqsPlace = it->second;
-                                thisSeqsPlace -= (times * size);
-                                if ((thisSeqsPlace < size) && (thisSeqsPlace >= 0)) {
-                                    seqs[thisSeqsPlace] = (name +'\t' + rest); 
-                                    found++;
-                                }
-                            }else { m->mothurOut("[ERROR]: in logic of readFlow function.\n"); m->setControl_pressed(true); }
-                        }
-                        util.gobble(in2);
-                    }
-                    in2.close();	
-                    
-                    ofstream out2;
-                    util.openOutputFileAppend(outputFileName, out2);
-                    
-                    int output = seqs.size();
-                    if (numLeft < seqs.size()) { output = numLeft; }
-                    
-                    for (int i = 0; i < output; i++) {
-                        if (seqs[i] != "") {
-                            out2 << seqs[i] << endl;
-                        }
-                    }
-                    out2.close();
-                    
-                    times++;
-                    numLeft -= output;
-                }
+                sorter.output(outputFileName);
                 
                 m->mothurOut("Ordered " + toString(numNamesInFile) + " flows from " + flowfile + ".\n");
             }else {
@@ -683,7 +577,7 @@ int SortSeqsCommand::readFlow(){
                 
                 if (name != "") {
                     //if this name is in the accnos file
-                    names[name] = count;
+                    names.insert(make_pair(name, (int)names.size()));
                     count++;
                     out << name << '\t' << rest << endl;
                 }
@@ -724,14 +618,14 @@ int SortSeqsCommand::readQual(){
 		
         if (names.size() != 0) {//this is not the first file we are reading so we need to use the order we already have
             
-            if (large) { //if the file is too large to fit in memory we can still process it, but the io will be very time consuming.
-                //read through the file looking for 1000 seqs at a time. Once we find them output them and start looking for the next 1000.
-                //this way we only store 1000 seqs in memory at a time.
-                
+            if (large) { //if the file is too large to fit in memory, the records are sorted by their place in the order in runs written to disk and merged
                 int numNames = names.size();
                 int numNamesInFile = 0;
+                vector<bool> added; added.resize(names.size(), false);
+                
+                int processors = 1; util.mothurConvert(current->getProcessors(), processors);
+                ExternalSort sorter(outputFileName, processors, m->getSortMemory(), false);
                 
-                //to make sure we dont miss any seqs, add any seqs that are not in names but in the file to the end of names
                 while(!in.eof()){
                     if (m->getControl_pressed()) { in.close();  out.close();  util.mothurRemove(outputFileName);  return 0; }
                     
@@ -743,82 +637,24 @@ int SortSeqsCommand::readQual(){
                         numNamesInFile++;
                         map<string, int>::iterator it = names.find(name);
                         if (it == names.end()) { 
-                            names[name] = numNames; numNames++;
+                            it = names.insert(make_pair(name, numNames)).first; numNames++; added.push_back(false);
                             m->mothurOut(name + " was not in the contained the file which determined the order, adding it to the end.\n");
                         }
+                        
+                        if (!added[it->second]) { //the first record with a name is kept
+                            added[it->second] = true;
+                            ostringstream record; currQual.printQScores(record);
+                            sorter.add(ExternalSort::encodeKey((unsigned long long)it->second), record.str());
+                        }
                     }
                     util.gobble(in);
                 }
                 in.close();
                 out.close();
                 
-                int numLeft = names.size();
-                if (numNamesInFile < numLeft) { numLeft = numNamesInFile; }
-                
-                int size = 1000; //assume that user can hold 1000 seqs in memory
-                if (numLeft < size) { size = numLeft; }
-                int times = 0;
-
-                
-                vector<QualityScores> seqs; seqs.resize(size);
-                for (int i = 0; i < seqs.size(); i++) { seqs[i].setName(""); } //this is so if some of the seqs are missing we dont print out garbage
-                
-                while (numLeft > 0) {
-                    
-                    ifstream in2;
-                    util.openInputFile(qualfile, in2);
-                    
-                    if (m->getControl_pressed()) { in2.close();  util.mothurRemove(outputFileName);  return 0; }
-                    
-                    int found = 0;
-                    int needToFind = size;
-                    if (numLeft < size) { needToFind = numLeft; }
-                    
-                    while(!in2.eof()){
-                        if (m->getControl_pressed()) { in2.close();   util.mothurRemove(outputFileName);  return 0; }
-                        
-                        //stop reading if we already found the seqs we are looking for
-                        if (found >= needToFind) { break; }
-                        
-                        QualityScores currQual;
-                        currQual = QualityScores(in2); 
-                        name = currQual.getName();
-                        
-                        if (name != "") {
-                            map<string, int>::iterator it = names.find(name);
-                            if (it != names.end()) { //we found it, so put it in the vector in the right place.
-                                //is it in the set of seqs we are looking for this time around
-                                int thisSeqsPlace = it->second;
-                                thisSeqsPlace -= (times * size);
-                                if ((thisSeqsPlace < size) && (thisSeqsPlace >= 0)) {
-                                    seqs[thisSeqsPlace] = currQual; 
-                                    found++;
-                                }
-                            }else { m->mothurOut("[ERROR]: in logic of readQual function.\n"); m->setControl_pressed(true); }
-                        }
-                        util.gobble(in2);
-                    }
-                    in2.close();	
-                    
-                    ofstream out2;
-                    util.openOutputFileAppend(outputFileName, out2);
-                    
-                    int output = seqs.size();
-                    if (numLeft < seqs.size()) { output = numLeft; }
-                    
-                    for (int i = 0; i < output; i++) {
-                        if (seqs[i].getName() != "") {
-                            seqs[i].printQScores(out2);
-                        }
-                    }
-                    out2.close();
-                    
-                    times++;
-                    numLeft -= output;
-                }
-                
-                 m->mothurOut("Ordered " + toString(numNamesInFile) + " sequences from " + qualfile + ".\n");
+                sorter.output(outputFileName);
                 
+                m->mothurOut("Ordered " + toString(numNamesInFile) + " sequences from " + qualfile + ".\n");
             }else {
                 
                 vector<QualityScores> seqs; seqs.resize(names.size());
@@ -867,7 +703,7 @@ int SortSeqsCommand::readQual(){
                 
                 if (currQual.getName() != "") {
                     //if this name is in the accnos file
-                    names[currQual.getName()] = count;
+                    names.insert(make_pair(currQual.getName(), (int)names.size()));
                     count++;
                     currQual.printQScores(out);
                 }
@@ -947,7 +783,7 @@ int SortSeqsCommand::readName(){
                 
                 if (firstCol != "") {
                     //if this name is in the accnos file
-                    names[firstCol] = count;
+                    names.insert(make_pair(firstCol, (int)names.size()));
                     count++;
                     out << firstCol << '\t' << secondCol << endl;
                 }
@@ -1032,7 +868,7 @@ int SortSeqsCommand::readCount(){
                 
                 if (firstCol != "") {
                     //if this name is in the accnos file
-                    names[firstCol] = count;
+                    names.insert(make_pair(firstCol, (int)names.size()));
                     count++;
                     out << firstCol << '\t' << rest << endl;
                 }
@@ -1111,7 +947,7 @@ int SortSeqsCommand::readGroup(){
                 
                 if (name != "") {
                     //if this name is in the accnos file
-                    names[name] = count;
+                    names.insert(make_pair(name, (int)names.size()));
                     count++;
                     out << name << '\t' << group << endl;
                 }
@@ -1191,7 +1027,7 @@ int SortSeqsCommand::readTax(){
                 
                 if (name != "") {
                     //if this name is in the accnos file
-                    names[name] = count;
+                    names.insert(make_pair(name, (int)names.size()));
                     count++;
                     out << name << '\t' << tax << endl;
                 }
@@ -648,6 +648,13 @@ void driverSummaryShared(summarySharedData* params) {
         ofstream outputFileHandle;
         params->util.openOutputFile(params->sumFile, outputFileHandle);
         
+        //the calcs that only need the pair's sums share one pass over the otus
+        bool usePairStats = false;
+        for(int i=0;i<sumCalculators.size();i++) { if (sumCalculators[i]->hasPairStats()) { usePairStats = true; } }
+        
+        vector< vector<int> > abunds;
+        if (usePairStats) { for (int k = 0; k < params->thisLookup.size(); k++) { abunds.push_back(params->thisLookup[k]->get()); } }
+        
         vector<SharedRAbundVector*> subset;
         for (int k = params->start; k < params->end; k++) { // pass cdd each set of groups to compare
             
@@ -668,6 +675,9 @@ void driverSummaryShared(summarySharedData* params) {
                     outputFileHandle << (params->thisLookup[k]->getGroup() +'\t' + params->thisLookup[l]->getGroup()) << '\t'; //print out groups
                 }
                 
+                SharedPairStats* stats = NULL;
+                if (usePairStats) { stats = new SharedPairStats(abunds[k], abunds[l]); }
+                
                 for(int i=0;i<sumCalculators.size();i++) {
                     
                     //if this calc needs all groups to calculate the pair load all groups
@@ -678,7 +688,9 @@ void driverSummaryShared(summarySharedData* params) {
                         }
                     }
                     
-                    vector<double> tempdata = sumCalculators[i]->getValues(subset); //saves the calculator outputs
+                    vector<double> tempdata;
+                    if (sumCalculators[i]->hasPairStats())  { tempdata = sumCalculators[i]->getValues(*stats);      }
+                    else                                    { tempdata = sumCalculators[i]->getValues(subset); } //saves the calculator outputs
                     
                     if (params->m->getControl_pressed()) { break; }
                     
@@ -689,6 +701,8 @@ void driverSummaryShared(summarySharedData* params) {
                     params->calcDists[i].push_back(temp);
                 }
                 outputFileHandle << endl;
+                
+                if (stats != NULL) { delete stats; }
             }
         }
         
@@ -659,15 +659,10 @@ int driverTrim(trimData* params) {
         numLinkers = params->linker.size();
         numSpacers = params->spacer.size();
 		
-		ifstream inFASTA;
-		params->util.openInputFile(params->filename, inFASTA);
-		inFASTA.seekg(params->lineStart);
+		SequenceReader inFASTA(params->filename, params->lineStart);
 		
-		ifstream qFile;
-		if(params->qFileName != "")	{
-			params->util.openInputFile(params->qFileName, qFile);
-			qFile.seekg(params->qlineStart);
-		}
+		SequenceReader* qFile = NULL;
+		if(params->qFileName != "")	{ qFile = new SequenceReader(params->qFileName, params->qlineStart); }
 		
 		bool moreSeqs = 1;
         int numBarcodes = params->barcodes.size();
@@ -716,12 +711,12 @@ int driverTrim(trimData* params) {
             string commentString = "";
 			int currentSeqsDiffs = 0;
 
-			Sequence currSeq(inFASTA); params->util.gobble(inFASTA);
+			Sequence currSeq(inFASTA);
             Sequence savedSeq(currSeq.getName(), currSeq.getAligned());
             
 			QualityScores currQual; QualityScores savedQual;
 			if(params->qFileName != ""){
-				currQual = QualityScores(qFile);  params->util.gobble(qFile);
+				currQual = QualityScores(*qFile);
                 savedQual.setName(currQual.getName()); savedQual.setScores(currQual.getScores());
 			}
 			  
@@ -934,8 +929,8 @@ int driverTrim(trimData* params) {
 			}
 			
 			#if defined NON_WINDOWS
-				unsigned long long pos = inFASTA.tellg();
-				if ((pos == -1) || (pos >= params->lineEnd)) { break; }
+				unsigned long long pos = inFASTA.getPosition();
+				if (inFASTA.eof() || (pos >= params->lineEnd)) { break; }
 			#else
 				if ((params->count == params->lineEnd) || (inFASTA.eof())) { break; }
 			#endif
@@ -949,8 +944,7 @@ int driverTrim(trimData* params) {
 		
 		delete trimOligos;
         if (params->reorient) { delete rtrimOligos; }
-		inFASTA.close();
-		if(params->qFileName != "")	{	qFile.close();		}
+		if(params->qFileName != "")	{	delete qFile;		}
     }
 	catch(exception& e) {
 		params->m->errorOut(e, "TrimSeqsCommand", "driverTrim");
@@ -198,12 +198,12 @@ void CommunityTypeFinder::printRelAbund(string fileName, vector<string> otuNames
 
 /**************************************************************************************************/
 
-vector<vector<double> > CommunityTypeFinder::getHessian(){
+vector<vector<double> > CommunityTypeFinder::getHessian(int partition){
     try {
         vector<double> alpha(numOTUs, 0.0000);
         double alphaSum = 0.0000;
         
-        vector<double> pi = zMatrix[currentPartition];
+        vector<double> pi = zMatrix[partition];
         vector<double> psi_ajk(numOTUs, 0.0000);
         vector<double> psi_cjk(numOTUs, 0.0000);
         vector<double> psi1_ajk(numOTUs, 0.0000);
@@ -213,7 +213,7 @@ vector<vector<double> > CommunityTypeFinder::getHessian(){
             
             if (m->getControl_pressed()) {  break; }
             
-            alpha[j] = exp(lambdaMatrix[currentPartition][j]);
+            alpha[j] = exp(lambdaMatrix[partition][j]);
             alphaSum += alpha[j];
             
             for(int i=0;i<numSamples;i++){
@@ -371,6 +371,22 @@ double CommunityTypeFinder::cheb_eval(const double seriesData[], int order, doub
 /**************************************************************************************************/
 
 int CommunityTypeFinder::findkMeans(){
+    try {
+        //randomize samples
+        vector<int> temp;
+        for (int i = 0; i < numSamples; i++) { temp.push_back(i); }
+        util.mothurRandomShuffle(temp);
+        
+        return findkMeans(temp);
+    }
+    catch(exception& e){
+        m->errorOut(e, "CommunityTypeFinder", "kMeans");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+
+int CommunityTypeFinder::findkMeans(vector<int>& temp){
     try {
         error.resize(numPartitions); for (int i = 0; i < numPartitions; i++) { error[i].resize(numOTUs, 0.0); }
         vector<vector<double> > relativeAbundance(numSamples);
@@ -404,11 +420,6 @@ int CommunityTypeFinder::findkMeans(){
             zMatrix[i].assign(numSamples, 0);
         }
         
-        //randomize samples
-        vector<int> temp;
-        for (int i = 0; i < numSamples; i++) { temp.push_back(i); }
-        util.mothurRandomShuffle(temp);
-        
         //assign each partition at least one random sample
         int numAssignedSamples = 0;
         for (int i = 0; i < numPartitions; i++) {
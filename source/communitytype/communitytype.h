@@ -44,7 +44,8 @@ public:
 protected:
     
     int findkMeans();
-    vector<vector<double> > getHessian();
+    int findkMeans(vector<int>&); //starts from the samples in this order
+    vector<vector<double> > getHessian(int); //partition
     double psi1(double);
     double psi(double);
     double cheb_eval(const double[], int, double);
@@ -64,7 +65,6 @@ protected:
     int numPartitions;
     int numSamples;
     int numOTUs;
-    int currentPartition;
     
     double currNLL, aic, bic, logDeterminant, laplace;
      
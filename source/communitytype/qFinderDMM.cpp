@@ -14,20 +14,151 @@
 
 qFinderDMM::qFinderDMM(vector<vector<int> > cm, int p) : CommunityTypeFinder() {
     try {
-        //cout << "here" << endl;
+        initialize(cm, p, 1, 1);
+    }
+	catch(exception& e) {
+		m->errorOut(e, "qFinderDMM", "qFinderDMM");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+qFinderDMM::qFinderDMM(vector<vector<int> > cm, int p, int proc, int restarts) : CommunityTypeFinder() {
+    try {
+        initialize(cm, p, proc, restarts);
+    }
+	catch(exception& e) {
+		m->errorOut(e, "qFinderDMM", "qFinderDMM");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//fits the restarts start, start+increment, ...
+void driverDMMRestarts(dmmRestartData* params){
+    try {
+        for (int i = params->start; i < params->fits->size(); i += params->increment) {
+            if (params->m->getControl_pressed()) { break; }
+            (*params->fits)[i]->fit((*params->orders)[i]);
+        }
+    }
+    catch(exception& e) {
+        params->m->errorOut(e, "qFinderDMM", "driverDMMRestarts");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+
+void driverDMMErrors(dmmData* params){ params->finder->calculateErrors(params->start, params->end); }
+
+/**************************************************************************************************/
+
+void qFinderDMM::initialize(vector<vector<int> >& cm, int p, int proc, int restarts){
+    try {
         numPartitions = p;
         countMatrix = cm;
         numSamples = (int)countMatrix.size();
         numOTUs = (int)countMatrix[0].size();
+        processors = max(proc, 1);
+        restarts = max(restarts, 1);
         
-       // if (m->getDebug()) { m->mothurOut("before kmeans\n"); }
-        findkMeans();
-       //if (m->getDebug()) { m->mothurOut("done kMeans\n"); }
+        otuSamples.resize(numOTUs); otuCounts.resize(numOTUs);
+        sampleOTUs.resize(numSamples); sampleCounts.resize(numSamples);
+        sampleTotals.assign(numSamples, 0.0000); sampleFactors.assign(numSamples, 0.0000);
         
-        optimizeLambda();
+        for(int j=0;j<numSamples;j++){
+            for(int i=0;i<numOTUs;i++){
+                if (countMatrix[j][i] != 0) {
+                    double X = countMatrix[j][i];
+                    otuSamples[i].push_back(j); otuCounts[i].push_back(X);
+                    sampleOTUs[j].push_back(i); sampleCounts[j].push_back(X);
+                    sampleTotals[j] += X;
+                    sampleFactors[j] += lgamma(X + 1.0000);
+                }
+            }
+            sampleFactors[j] -= lgamma(sampleTotals[j] + 1.0);
+        }
+        
+        //the start orders are drawn in restart order, the first is the order a single fit would use
+        vector< vector<int> > orders(restarts);
+        for (int r = 0; r < restarts; r++) {
+            for (int i = 0; i < numSamples; i++) { orders[r].push_back(i); }
+            util.mothurRandomShuffle(orders[r]);
+        }
+        
+        int numThreads = min(processors, restarts);
+        
+        //each fit gets an even share of the processors
+        processors = max(processors / numThreads, 1);
+        vector<qFinderDMM*> fits(restarts, this);
+        for (int r = 1; r < restarts; r++) { fits[r] = new qFinderDMM(*this); }
+        
+        vector<thread*> workerThreads;
+        vector<dmmRestartData*> data;
+        
+        for (int i = 1; i < numThreads; i++) {
+            dmmRestartData* dataBundle = new dmmRestartData(&fits, &orders, i, numThreads);
+            data.push_back(dataBundle);
+            workerThreads.push_back(new thread(driverDMMRestarts, dataBundle));
+        }
+        
+        dmmRestartData* dataBundle = new dmmRestartData(&fits, &orders, 0, numThreads);
+        driverDMMRestarts(dataBundle);
+        delete dataBundle;
+        
+        for (int i = 0; i < workerThreads.size(); i++) {
+            workerThreads[i]->join();
+            delete data[i];
+            delete workerThreads[i];
+        }
+        
+        //keep the restart with the lowest NLL, the first on ties
+        int best = 0;
+        for (int r = 1; r < restarts; r++) { if (fits[r]->currNLL < fits[best]->currNLL) { best = r; } }
+        
+        if (best != 0) {
+            zMatrix = fits[best]->zMatrix;
+            lambdaMatrix = fits[best]->lambdaMatrix;
+            weights = fits[best]->weights;
+            currNLL = fits[best]->currNLL;
+        }
+        for (int r = 1; r < restarts; r++) { delete fits[r]; }
+        
+        if (restarts > 1) { m->mothurOutJustToLog("Kept restart " + toString(best+1) + " of " + toString(restarts) + " for " + toString(numPartitions) + " partitions.\n"); }
+        
+        if (m->getControl_pressed()) { return; }
+        
+        processors = max(proc, 1);
+        
+        error.resize(numPartitions);
+        partitionLogDeterminants.assign(numPartitions, 0.0000);
+        
+        runThreads(driverDMMErrors, numPartitions);
         
+        logDeterminant = 0.0000;
+        for(int k=0;k<numPartitions;k++){
+            if(k > 0){
+                logDeterminant += (2.0 * log(numSamples) - log(weights[k]));
+            }
+            logDeterminant += partitionLogDeterminants[k];
+        }
+        
+        int numParameters = numPartitions * numOTUs + numPartitions - 1;
+        laplace = currNLL + 0.5 * logDeterminant - 0.5 * numParameters * log(2.0 * 3.14159);
+        bic = currNLL + 0.5 * log(numSamples) * numParameters;
+        aic = currNLL + numParameters;
+    }
+	catch(exception& e) {
+		m->errorOut(e, "qFinderDMM", "initialize");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+void qFinderDMM::fit(vector<int>& order){
+    try {
+        findkMeans(order);
         
-         //if (m->getDebug()) { m->mothurOut("done optimizeLambda\n"); }
+        optimizeLambda();
         
         double change = 1.0000;
         currNLL = 0.0000;
@@ -36,20 +167,17 @@ qFinderDMM::qFinderDMM(vector<vector<int> > cm, int p) : CommunityTypeFinder() {
         
         while(change > 1.0e-6 && iter < 100){
             
-           // if (m->getDebug()) { m->mothurOut("Calc_Z: \n"); }
+            if (m->getControl_pressed()) { return; }
+            
             calculatePiK();
             
             optimizeLambda();
             
-              // if (m->getDebug()) { m->mothurOut("Iter: " + toString(iter) + "\n"); }
-            
             for(int i=0;i<numPartitions;i++){
                 weights[i] = 0.0000;
                 for(int j=0;j<numSamples;j++){
                     weights[i] += zMatrix[i][j];
                 }
-                           // printf("w_%d=%.3f\t",i,weights[i]);
-                
             }
             
             double nLL = getNegativeLogLikelihood();
@@ -58,44 +186,65 @@ qFinderDMM::qFinderDMM(vector<vector<int> > cm, int p) : CommunityTypeFinder() {
             
             currNLL = nLL;
             
-                  //  printf("NLL=%.5f\tDelta=%.4e\n",currNLL, change);
-            
             iter++;
         }
-        //if (m->getDebug()) { m->mothurOut("done while loop\n"); }
-        error.resize(numPartitions);
+    }
+	catch(exception& e) {
+		m->errorOut(e, "qFinderDMM", "fit");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+void qFinderDMM::runThreads(void (*driver)(dmmData*), int numItems){
+    try {
+        int numThreads = max(min(processors, numItems), 1);
         
-        logDeterminant = 0.0000;
+        vector<thread*> workerThreads;
+        vector<dmmData*> data;
+        
+        for (int i = 1; i < numThreads; i++) {
+            dmmData* dataBundle = new dmmData(this, (i * numItems) / numThreads, ((i+1) * numItems) / numThreads);
+            data.push_back(dataBundle);
+            workerThreads.push_back(new thread(driver, dataBundle));
+        }
         
+        dmmData dataBundle(this, 0, numItems / numThreads);
+        driver(&dataBundle);
+        
+        for (int i = 0; i < workerThreads.size(); i++) {
+            workerThreads[i]->join();
+            delete data[i];
+            delete workerThreads[i];
+        }
+    }
+	catch(exception& e) {
+		m->errorOut(e, "qFinderDMM", "runThreads");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+void qFinderDMM::calculateErrors(int start, int end){
+    try {
         LinearAlgebra l;
         
-        for(currentPartition=0;currentPartition<numPartitions;currentPartition++){
+        for(int k=start;k<end;k++){
+            if (m->getControl_pressed()) { return; }
             
-            error[currentPartition].assign(numOTUs, 0.0000);
+            error[k].assign(numOTUs, 0.0000);
             
-            if (m->getDebug()) { m->mothurOut("current partition = " + toString(currentPartition) + "\n"); }
-            
-            if(currentPartition > 0){
-                logDeterminant += (2.0 * log(numSamples) - log(weights[currentPartition]));
-            }
-            //if (m->getDebug()) { m->mothurOut("before hession\n"); }
-            vector<vector<double> > hessian = getHessian();
-            //if (m->getDebug()) { m->mothurOut("after hession\n"); }
+            vector<vector<double> > hessian = getHessian(k);
             vector<vector<double> > invHessian = l.getInverse(hessian);
-            //if (m->getDebug()) { m->mothurOut("after inverse\n"); }
+            
             for(int i=0;i<numOTUs;i++){
-                logDeterminant += log(abs(hessian[i][i]));
-                error[currentPartition][i] = invHessian[i][i];
+                partitionLogDeterminants[k] += log(abs(hessian[i][i]));
+                error[k][i] = invHessian[i][i];
             }
         }
-        
-        int numParameters = numPartitions * numOTUs + numPartitions - 1;
-        laplace = currNLL + 0.5 * logDeterminant - 0.5 * numParameters * log(2.0 * 3.14159);
-        bic = currNLL + 0.5 * log(numSamples) * numParameters;
-        aic = currNLL + numParameters;
     }
 	catch(exception& e) {
-		m->errorOut(e, "qFinderDMM", "qFinderDMM");
+		m->errorOut(e, "qFinderDMM", "calculateErrors");
 		exit(1);
 	}
 }
@@ -319,7 +468,7 @@ double interpolate (double a, double fa, double fpa,
 
 /**************************************************************************************************/
 
-int qFinderDMM::lineMinimizeFletcher(vector<double>& x, vector<double>& p, double f0, double df0, double alpha1, double& alphaNew, double& fAlpha, vector<double>& xalpha, vector<double>& gradient ){
+int qFinderDMM::lineMinimizeFletcher(vector<double>& x, vector<double>& p, double f0, double df0, double alpha1, double& alphaNew, double& fAlpha, vector<double>& xalpha, vector<double>& gradient, int partition){
     try {
         
         double rho = 0.01;
@@ -349,7 +498,7 @@ int qFinderDMM::lineMinimizeFletcher(vector<double>& x, vector<double>& p, doubl
                 xalpha[i] = x[i] + alpha * p[i];
             }
             
-            fAlpha = negativeLogEvidenceLambdaPi(xalpha);
+            fAlpha = negativeLogEvidenceLambdaPi(xalpha, partition);
             
             if(fAlpha > f0 + alpha * rho * df0 || fAlpha >= falpha_prev){
                 a = alpha_prev;         b = alpha;
@@ -358,7 +507,7 @@ int qFinderDMM::lineMinimizeFletcher(vector<double>& x, vector<double>& p, doubl
                 break;
             }
             
-            negativeLogDerivEvidenceLambdaPi(xalpha, gradient);
+            negativeLogDerivEvidenceLambdaPi(xalpha, gradient, partition);
             double dfalpha = 0.0000;
             for(int i=0;i<numOTUs;i++){ dfalpha += gradient[i] * p[i]; }
             
@@ -402,7 +551,7 @@ int qFinderDMM::lineMinimizeFletcher(vector<double>& x, vector<double>& p, doubl
                 xalpha[i] = x[i] + alpha * p[i];
             }
             
-            fAlpha = negativeLogEvidenceLambdaPi(xalpha);
+            fAlpha = negativeLogEvidenceLambdaPi(xalpha, partition);
             
             if((a - alpha) * dfa <= EPSILON){
                 return 0;
@@ -416,7 +565,7 @@ int qFinderDMM::lineMinimizeFletcher(vector<double>& x, vector<double>& p, doubl
             else{
                 double dfalpha = 0.0000;
                 
-                negativeLogDerivEvidenceLambdaPi(xalpha, gradient);
+                negativeLogDerivEvidenceLambdaPi(xalpha, gradient, partition);
                 dfalpha = 0.0000;
                 for(int i=0;i<numOTUs;i++){ dfalpha += gradient[i] * p[i]; }
                 
@@ -449,7 +598,7 @@ int qFinderDMM::lineMinimizeFletcher(vector<double>& x, vector<double>& p, doubl
 
 /**************************************************************************************************/
 
-int qFinderDMM::bfgs2_Solver(vector<double>& x){
+int qFinderDMM::bfgs2_Solver(vector<double>& x, int partition){
     try{
 //        cout << "bfgs2_Solver" << endl;
         int bfgsIter = 0;
@@ -457,11 +606,11 @@ int qFinderDMM::bfgs2_Solver(vector<double>& x){
         double delta_f = 0.0000;//f-f0;
 
         vector<double> gradient;
-        double f = negativeLogEvidenceLambdaPi(x);
+        double f = negativeLogEvidenceLambdaPi(x, partition);
         
 //        cout << "after negLE" << endl;
         
-        negativeLogDerivEvidenceLambdaPi(x, gradient);
+        negativeLogDerivEvidenceLambdaPi(x, gradient, partition);
 
 //        cout << "after negLDE" << endl;
 
@@ -507,7 +656,7 @@ int qFinderDMM::bfgs2_Solver(vector<double>& x){
                 alphaOld = step;
             }
             
-            int success = lineMinimizeFletcher(x0, p, f0, df0, alphaOld, alphaNew, f, x, gradient);
+            int success = lineMinimizeFletcher(x0, p, f0, df0, alphaOld, alphaNew, f, x, gradient, partition);
             
             if(!success){
                 x = x0;
@@ -592,12 +741,11 @@ int qFinderDMM::bfgs2_Solver(vector<double>& x){
 
 
 /**************************************************************************************************/
-
-double qFinderDMM::negativeLogEvidenceLambdaPi(vector<double>& x){
+//a zero count adds lgamma(alpha) to both the alpha and alpha+X terms, so only the nonzero counts are summed
+double qFinderDMM::negativeLogEvidenceLambdaPi(vector<double>& x, int partition){
     try{
-        vector<double> sumAlphaX(numSamples, 0.0000);
+        vector<double>& z = zMatrix[partition];
         
-        double logEAlpha = 0.0000;
         double sumLambda = 0.0000;
         double sumAlpha = 0.0000;
         double logE = 0.0000;
@@ -606,33 +754,32 @@ double qFinderDMM::negativeLogEvidenceLambdaPi(vector<double>& x){
         
         double weight = 0.00000;
         for(int i=0;i<numSamples;i++){
-            weight += zMatrix[currentPartition][i];
+            weight += z[i];
         }
         
         for(int i=0;i<numOTUs;i++){
             if (m->getControl_pressed()) {  return 0; }
             double lambda = x[i];
             double alpha = exp(x[i]);
-            logEAlpha += lgamma(alpha);
             sumLambda += lambda;
             sumAlpha += alpha;
             
-            for(int j=0;j<numSamples;j++){
-                double X = countMatrix[j][i];
-                double alphaX = alpha + X;
-                sumAlphaX[j] += alphaX;
-                
-                logE -= zMatrix[currentPartition][j] * lgamma(alphaX);
+            double weightX = 0.0000;
+            for(int j=0;j<otuSamples[i].size();j++){
+                double zj = z[otuSamples[i][j]];
+                weightX += zj;
+                logE -= zj * lgamma(alpha + otuCounts[i][j]);
             }
+            logE += weightX * lgamma(alpha);
         }
         
-        logEAlpha -= lgamma(sumAlpha);
+        logE -= weight * lgamma(sumAlpha);
 
         for(int i=0;i<numSamples;i++){
-            logE += zMatrix[currentPartition][i] * lgamma(sumAlphaX[i]);
+            logE += z[i] * lgamma(sumAlpha + sampleTotals[i]);
         }
 
-        return logE + weight * logEAlpha + nu * sumAlpha - eta * sumLambda;
+        return logE + nu * sumAlpha - eta * sumLambda;
     }
     catch(exception& e){
         m->errorOut(e, "qFinderDMM", "negativeLogEvidenceLambdaPi");
@@ -642,11 +789,10 @@ double qFinderDMM::negativeLogEvidenceLambdaPi(vector<double>& x){
 
 /**************************************************************************************************/
 
-void qFinderDMM::negativeLogDerivEvidenceLambdaPi(vector<double>& x, vector<double>& df){
+void qFinderDMM::negativeLogDerivEvidenceLambdaPi(vector<double>& x, vector<double>& df, int partition){
     try{
-//        cout << "\tstart negativeLogDerivEvidenceLambdaPi" << endl;
+        vector<double>& z = zMatrix[partition];
         
-        vector<double> storeVector(numSamples, 0.0000);
         vector<double> derivative(numOTUs, 0.0000);
         vector<double> alpha(numOTUs, 0.0000);
         
@@ -656,40 +802,27 @@ void qFinderDMM::negativeLogDerivEvidenceLambdaPi(vector<double>& x, vector<doub
         
         double weight = 0.0000;
         for(int i=0;i<numSamples;i++){
-            weight += zMatrix[currentPartition][i];
+            weight += z[i];
         }
 
-        
         for(int i=0;i<numOTUs;i++){
             if (m->getControl_pressed()) {  return; }
-//            cout << "start i loop" << endl;
-//            
-//            cout << i << '\t' << alpha[i] << '\t' << x[i] << '\t' << exp(x[i]) << '\t' << store << endl;
             
             alpha[i] = exp(x[i]);
             store += alpha[i];
             
-//            cout << "before derivative" << endl;
-            
-            derivative[i] = weight * psi(alpha[i]);
-
-//            cout << "after derivative" << endl;
-
-//            cout << i << '\t' << alpha[i] << '\t' << psi(alpha[i]) << '\t' << derivative[i] << endl;
-
-            for(int j=0;j<numSamples;j++){
-                double X = countMatrix[j][i];
-                double alphaX = X + alpha[i];
-                
-                derivative[i] -= zMatrix[currentPartition][j] * psi(alphaX);
-                storeVector[j] += alphaX;
+            double weightX = 0.0000;
+            for(int j=0;j<otuSamples[i].size();j++){
+                double zj = z[otuSamples[i][j]];
+                weightX += zj;
+                derivative[i] -= zj * psi(alpha[i] + otuCounts[i][j]);
             }
-//            cout << "end i loop" << endl;
+            derivative[i] += weightX * psi(alpha[i]);
         }
 
         double sumStore = 0.0000;
         for(int i=0;i<numSamples;i++){
-            sumStore += zMatrix[currentPartition][i] * psi(storeVector[i]);
+            sumStore += z[i] * psi(store + sampleTotals[i]);
         }
         
         store = weight * psi(store);
@@ -698,10 +831,7 @@ void qFinderDMM::negativeLogDerivEvidenceLambdaPi(vector<double>& x, vector<doub
         
         for(int i=0;i<numOTUs;i++){
             df[i] = alpha[i] * (nu + derivative[i] - store + sumStore) - eta;
-//            cout << i << '\t' << df[i] << endl;
         }
-//        cout << df.size() << endl;
-//        cout << "\tend negativeLogDerivEvidenceLambdaPi" << endl;
     }
     catch(exception& e){
          m->errorOut(e, "qFinderDMM", "negativeLogDerivEvidenceLambdaPi");
@@ -710,31 +840,21 @@ void qFinderDMM::negativeLogDerivEvidenceLambdaPi(vector<double>& x, vector<doub
 }
 
 /**************************************************************************************************/
-
-double qFinderDMM::getNegativeLogEvidence(vector<double>& lambda, int group){
+//uses the alphas set by setPartitionAlphas
+double qFinderDMM::getNegativeLogEvidence(int partition, int group){
     try {
-        double sumAlpha = 0.0000;
-        double sumAlphaX = 0.0000;
-        double sumLnGamAlpha = 0.0000;
+        vector<double>& alpha = partitionAlphas[partition];
+        vector<double>& lnGammaAlpha = partitionLnGammaAlphas[partition];
         double logEvidence = 0.0000;
         
-        for(int i=0;i<numOTUs;i++){
-            if (m->getControl_pressed()) {  return 0; }
-            double alpha = exp(lambda[i]);
-            double X = countMatrix[group][i];
-            double alphaX = alpha + X;
-            
-            sumLnGamAlpha += lgamma(alpha);
-            sumAlpha += alpha;
-            sumAlphaX += alphaX;
-            
-            logEvidence -= lgamma(alphaX);
+        for(int i=0;i<sampleOTUs[group].size();i++){
+            int otu = sampleOTUs[group][i];
+            logEvidence -= lgamma(alpha[otu] + sampleCounts[group][i]) - lnGammaAlpha[otu];
         }
         
-        sumLnGamAlpha -= lgamma(sumAlpha);
-        logEvidence += lgamma(sumAlphaX);
+        double sumAlpha = partitionSumAlphas[partition];
         
-        return logEvidence + sumLnGamAlpha;
+        return logEvidence + lgamma(sumAlpha + sampleTotals[group]) - lgamma(sumAlpha);
     }
     catch(exception& e){
         m->errorOut(e, "qFinderDMM", "getNegativeLogEvidence");
@@ -744,11 +864,53 @@ double qFinderDMM::getNegativeLogEvidence(vector<double>& lambda, int group){
 
 /**************************************************************************************************/
 
-void qFinderDMM::optimizeLambda(){    
+void qFinderDMM::setPartitionAlphas(){
+    try {
+        partitionAlphas.resize(numPartitions);
+        partitionLnGammaAlphas.resize(numPartitions);
+        partitionSumAlphas.assign(numPartitions, 0.0000);
+        
+        for(int k=0;k<numPartitions;k++){
+            partitionAlphas[k].resize(numOTUs);
+            partitionLnGammaAlphas[k].resize(numOTUs);
+            
+            for(int i=0;i<numOTUs;i++){
+                partitionAlphas[k][i] = exp(lambdaMatrix[k][i]);
+                partitionLnGammaAlphas[k][i] = lgamma(partitionAlphas[k][i]);
+                partitionSumAlphas[k] += partitionAlphas[k][i];
+            }
+        }
+    }
+    catch(exception& e){
+        m->errorOut(e, "qFinderDMM", "setPartitionAlphas");
+        exit(1);
+    }
+}
+
+/**************************************************************************************************/
+
+void driverDMMLambda(dmmData* params){ params->finder->optimizeLambda(params->start, params->end); }
+
+/**************************************************************************************************/
+
+void qFinderDMM::optimizeLambda(){
+    try {
+        runThreads(driverDMMLambda, numPartitions);
+        
+        setPartitionAlphas();
+    }
+    catch(exception& e){
+        m->errorOut(e, "qFinderDMM", "optimizeLambda");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+
+void qFinderDMM::optimizeLambda(int start, int end){
     try {
-        for(currentPartition=0;currentPartition<numPartitions;currentPartition++){
+        for(int k=start;k<end;k++){
             if (m->getControl_pressed()) {  return; }
-            bfgs2_Solver(lambdaMatrix[currentPartition]);
+            bfgs2_Solver(lambdaMatrix[k], k);
         }
     }
     catch(exception& e){
@@ -758,17 +920,32 @@ void qFinderDMM::optimizeLambda(){
 }
 /**************************************************************************************************/
 
+void driverDMMPiK(dmmData* params){ params->finder->calculatePiK(params->start, params->end); }
+
+/**************************************************************************************************/
+
 void qFinderDMM::calculatePiK(){
+    try {
+        runThreads(driverDMMPiK, numSamples);
+    }
+    catch(exception& e){
+        m->errorOut(e, "qFinderDMM", "calculatePiK");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+
+void qFinderDMM::calculatePiK(int start, int end){
     try {
         vector<double> store(numPartitions);
         
-        for(int i=0;i<numSamples;i++){
+        for(int i=start;i<end;i++){
             if (m->getControl_pressed()) {  return; }
             double sum = 0.0000;
             double minNegLogEvidence =numeric_limits<double>::max();
             
             for(int j=0;j<numPartitions;j++){
-                double negLogEvidenceJ = getNegativeLogEvidence(lambdaMatrix[j], i);
+                double negLogEvidenceJ = getNegativeLogEvidence(j, i);
                 
                 if(negLogEvidenceJ < minNegLogEvidence){
                     minNegLogEvidence = negLogEvidenceJ;
@@ -777,7 +954,6 @@ void qFinderDMM::calculatePiK(){
             }
             
             for(int j=0;j<numPartitions;j++){
-                if (m->getControl_pressed()) {  return; }
                 zMatrix[j][i] = weights[j] * exp(-(store[j] - minNegLogEvidence));
                 sum += zMatrix[j][i];
             }
@@ -797,73 +973,53 @@ void qFinderDMM::calculatePiK(){
 
 /**************************************************************************************************/
 
-double qFinderDMM::getNegativeLogLikelihood(){
+void driverDMMLikelihood(dmmData* params){ params->finder->calculateLogLikelihoods(params->start, params->end); }
+
+/**************************************************************************************************/
+
+void qFinderDMM::calculateLogLikelihoods(int start, int end){
     try {
-        double eta = 0.10000;
-        double nu = 0.10000;
-        
-        vector<double> pi(numPartitions, 0.0000);
-        vector<double> logBAlpha(numPartitions, 0.0000);
-        
-        double doubleSum = 0.0000;
-        
-        for(int i=0;i<numPartitions;i++){
-            if (m->getControl_pressed()) {  return 0; }
-            double sumAlphaK = 0.0000;
-            
-            pi[i] = weights[i] / (double)numSamples;
-            
-            for(int j=0;j<numOTUs;j++){
-                double alpha = exp(lambdaMatrix[i][j]);
-                sumAlphaK += alpha;
-                
-                logBAlpha[i] += lgamma(alpha);
-            }
-            logBAlpha[i] -= lgamma(sumAlphaK);
-        }
+        vector<double> logStore(numPartitions, 0.0000);
         
-        for(int i=0;i<numSamples;i++){
-            if (m->getControl_pressed()) {  return 0; }
+        for(int i=start;i<end;i++){
+            if (m->getControl_pressed()) {  return; }
             
             double probability = 0.0000;
-            double factor = 0.0000;
-            double sum = 0.0000;
-            vector<double> logStore(numPartitions, 0.0000);
             double offset = -numeric_limits<double>::max();
             
-            for(int j=0;j<numOTUs;j++){
-                sum += countMatrix[i][j];
-                factor += lgamma(countMatrix[i][j] + 1.0000);
-            }
-            factor -= lgamma(sum + 1.0);
-            
             for(int k=0;k<numPartitions;k++){
-                
-                double sumAlphaKX = 0.0000;
-                double logBAlphaX = 0.0000;
-                
-                for(int j=0;j<numOTUs;j++){
-                    double alphaX = exp(lambdaMatrix[k][j]) + (double)countMatrix[i][j];
-                    
-                    sumAlphaKX += alphaX;
-                    logBAlphaX += lgamma(alphaX);
-                }
-                
-                logBAlphaX -= lgamma(sumAlphaKX);
-                
-                logStore[k] = logBAlphaX - logBAlpha[k] - factor;
+                logStore[k] = -getNegativeLogEvidence(k, i) - sampleFactors[i];
                 if(logStore[k] > offset){
                     offset = logStore[k];
                 }
-                
             }
             
             for(int k=0;k<numPartitions;k++){
-                probability += pi[k] * exp(-offset + logStore[k]);
+                probability += (weights[k] / (double)numSamples) * exp(-offset + logStore[k]);
             }
-            doubleSum += log(probability) + offset;
-            
+            sampleLogLikelihoods[i] = log(probability) + offset;
         }
+    }
+    catch(exception& e){
+        m->errorOut(e, "qFinderDMM", "calculateLogLikelihoods");
+        exit(1);
+    }
+}
+
+/**************************************************************************************************/
+
+double qFinderDMM::getNegativeLogLikelihood(){
+    try {
+        double eta = 0.10000;
+        double nu = 0.10000;
+        
+        sampleLogLikelihoods.assign(numSamples, 0.0000);
+        runThreads(driverDMMLikelihood, numSamples);
+        
+        if (m->getControl_pressed()) {  return 0; }
+        
+        double doubleSum = 0.0000;
+        for(int i=0;i<numSamples;i++){ doubleSum += sampleLogLikelihoods[i]; }
         
         double L5 = - numOTUs * numPartitions * lgamma(eta);
         double L6 = eta * numPartitions * numOTUs * log(nu);
@@ -873,8 +1029,7 @@ double qFinderDMM::getNegativeLogLikelihood(){
         
         for(int i=0;i<numPartitions;i++){
             for(int j=0;j<numOTUs;j++){
-                if (m->getControl_pressed()) {  return 0; }
-                alphaSum += exp(lambdaMatrix[i][j]);
+                alphaSum += partitionAlphas[i][j];
                 lambdaSum += lambdaMatrix[i][j];
             }
         }
@@ -13,30 +13,78 @@
 
 /**************************************************************************************************/
 
+struct dmmData;
+
+/**************************************************************************************************/
+//The fit is split between processors threads. The restarts, each from its own random k-means start, are fit at the same
+//time and the one with the lowest NLL is kept. Within a fit the partitions' lambdas are optimized in parallel and the
+//posteriors and likelihood are calculated in parallel over the samples. Each value is calculated by one thread and sums
+//are taken in order, so the fit does not depend on the number of processors.
+
 class qFinderDMM : public CommunityTypeFinder {
   
 public:
     qFinderDMM(vector<vector<int> >, int);
+    qFinderDMM(vector<vector<int> >, int, int, int); //countMatrix, numPartitions, processors, restarts
     void printFitData(ofstream&);
     void printFitData(ostream&, double);
     
+    //used by the threads, each works on its own range of partitions or samples
+    void fit(vector<int>&); //k-means start order
+    void optimizeLambda(int, int);
+    void calculatePiK(int, int);
+    void calculateLogLikelihoods(int, int);
+    void calculateErrors(int, int);
+    
 private:
    
+    void initialize(vector<vector<int> >&, int, int, int);
+    void runThreads(void (*)(dmmData*), int); //driver, number of partitions or samples
+    void setPartitionAlphas();
+    
     void optimizeLambda();
     void calculatePiK();
 
-    double negativeLogEvidenceLambdaPi(vector<double>&);
-    void negativeLogDerivEvidenceLambdaPi(vector<double>&, vector<double>&);
-    double getNegativeLogEvidence(vector<double>&, int);
+    double negativeLogEvidenceLambdaPi(vector<double>&, int);
+    void negativeLogDerivEvidenceLambdaPi(vector<double>&, vector<double>&, int);
+    double getNegativeLogEvidence(int, int); //partition, sample
     double getNegativeLogLikelihood();
     
     
-    int lineMinimizeFletcher(vector<double>&, vector<double>&, double, double, double, double&, double&, vector<double>&, vector<double>&);
-    int bfgs2_Solver(vector<double>&);//, double, double);
+    int lineMinimizeFletcher(vector<double>&, vector<double>&, double, double, double, double&, double&, vector<double>&, vector<double>&, int);
+    int bfgs2_Solver(vector<double>&, int);//, double, double);
     
-   
+    int processors;
+    
+    //the counts are sparse, so only the nonzero counts are visited
+    vector<vector<int> > otuSamples, sampleOTUs; //[numOTUs] samples with a count, [numSamples] otus with a count
+    vector<vector<double> > otuCounts, sampleCounts; //the counts, in the same order
+    vector<double> sampleTotals, sampleFactors; //[numSamples] sum of the counts, log multinomial coefficient
+    
+    vector<vector<double> > partitionAlphas, partitionLnGammaAlphas; //[numPartitions][numOTUs] exp(lambda), lgamma(alpha)
+    vector<double> partitionSumAlphas;
+    vector<double> sampleLogLikelihoods; //[numSamples]
+    vector<double> partitionLogDeterminants; //[numPartitions] sum of the log of the hessian's diagonal
+};
+
+/**************************************************************************************************/
+
+struct dmmData {
+    qFinderDMM* finder;
+    int start, end;
+    
+    dmmData(qFinderDMM* f, int s, int e) : finder(f), start(s), end(e) {}
+};
 
-        
+/**************************************************************************************************/
+//fits the restarts start, start+increment, ...
+struct dmmRestartData {
+    vector<qFinderDMM*>* fits;
+    vector< vector<int> >* orders;
+    int start, increment;
+    MothurOut* m;
+    
+    dmmRestartData(vector<qFinderDMM*>* f, vector< vector<int> >* o, int s, int i) : fits(f), orders(o), start(s), increment(i) { m = MothurOut::getInstance(); }
 };
 
 /**************************************************************************************************/
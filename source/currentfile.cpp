@@ -7,6 +7,10 @@
 //
 
 #include "currentfile.h"
+#include "sequencedb.h"
+#include "counttable.h"
+#include "listvector.hpp"
+#include "sharedrabundvectors.hpp"
 
 /*********************************************************************************************/
 set<string> CurrentFile::getCurrentTypes()  {
@@ -196,6 +200,7 @@ void CurrentFile::clearCurrentFiles()  {
         unsigned concurentThreadsSupported = std::thread::hardware_concurrency();
         if (concurentThreadsSupported < 1) { concurentThreadsSupported = 1; } //in case thread errors
         processors = toString(concurentThreadsSupported);
+        clearPipelineCache();
     }
     catch(exception& e) {
         m->errorOut(e, "CurrentFile", "clearCurrentFiles");
@@ -273,3 +278,366 @@ void CurrentFile::setBlastPath(string pathname)  {
 
 
 /*********************************************************************************************/
+/*********************************************************************************************/
+void CurrentFile::setPipelineMode(bool t)  {
+    try {
+        pipelineMode = t;
+        if (!pipelineMode) { clearPipelineCache(); }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "CurrentFile", "setPipelineMode");
+        exit(1);
+    }
+}
+/*********************************************************************************************/
+//size and modification time of the file, blank if the file can't be found
+string CurrentFile::getPipelineStamp(string filename)  {
+    try {
+        string stamp = "";
+        
+#if defined NON_WINDOWS
+        struct stat st;
+        if (stat(filename.c_str(), &st) == 0) {
+            long long nanoSeconds = 0;
+    #if defined (__APPLE__) || (__MACH__)
+            nanoSeconds = st.st_mtimespec.tv_nsec;
+    #else
+            nanoSeconds = st.st_mtim.tv_nsec;
+    #endif
+            stamp = toString((long long)st.st_size) + ":" + toString((long long)st.st_mtime) + ":" + toString(nanoSeconds);
+        }
+#else
+        ifstream in;
+        if (util.openInputFile(filename, in, "no error")) {
+            in.seekg(0, ios::end);
+            long long size = in.tellg();
+            in.close();
+            stamp = toString(size) + ":" + toString(util.getTimeStamp(filename));
+        }
+#endif
+        
+        return stamp;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "CurrentFile", "getPipelineStamp");
+        exit(1);
+    }
+}
+/*********************************************************************************************/
+//assumes pipelineLock is held. removes the stored objects if the file has changed since they were stored
+bool CurrentFile::isPipelineCurrent(string filename)  {
+    try {
+        map<string, string>::iterator it = pipelineStamps.find(filename);
+        if (it == pipelineStamps.end()) { return false; }
+        
+        if (it->second != getPipelineStamp(filename)) { removePipelineFile(filename); return false; }
+        
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "CurrentFile", "isPipelineCurrent");
+        exit(1);
+    }
+}
+/*********************************************************************************************/
+//assumes pipelineLock is held
+void CurrentFile::removePipelineFile(string filename)  {
+    try {
+        map<string, SequenceDB*>::iterator itFasta = pipelineFasta.find(filename);
+        if (itFasta != pipelineFasta.end()) { delete itFasta->second; pipelineFasta.erase(itFasta); }
+        
+        map<string, CountTable*>::iterator itCount = pipelineCount.find(filename);
+        if (itCount != pipelineCount.end()) { delete itCount->second; pipelineCount.erase(itCount); }
+        
+        map<string, vector<ListVector*> >::iterator itList = pipelineList.find(filename);
+        if (itList != pipelineList.end()) {
+            for (int i = 0; i < itList->second.size(); i++) { delete itList->second[i]; }
+            pipelineList.erase(itList);
+        }
+        
+        map<string, vector<SharedRAbundVectors*> >::iterator itShared = pipelineShared.find(filename);
+        if (itShared != pipelineShared.end()) {
+            for (int i = 0; i < itShared->second.size(); i++) { delete itShared->second[i]; }
+            pipelineShared.erase(itShared);
+        }
+        
+        pipelineStamps.erase(filename);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "CurrentFile", "removePipelineFile");
+        exit(1);
+    }
+}
+/*********************************************************************************************/
+void CurrentFile::setPipelineSequenceDB(string filename, SequenceDB* db)  {
+    try {
+        lock_guard<std::mutex> guard(pipelineLock);
+        
+        filename = util.getFullPathName(filename);
+        string stamp = getPipelineStamp(filename);
+        
+        if (!pipelineMode || (stamp == "")) { delete db; return; }
+        
+        removePipelineFile(filename);
+        pipelineFasta[filename] = db;
+        pipelineStamps[filename] = stamp;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "CurrentFile", "setPipelineSequenceDB");
+        exit(1);
+    }
+}
+/*********************************************************************************************/
+bool CurrentFile::getPipelineSequenceDB(string filename, SequenceDB& db)  {
+    try {
+        lock_guard<std::mutex> guard(pipelineLock);
+        
+        if (!pipelineMode) { return false; }
+        
+        filename = util.getFullPathName(filename);
+        if (!isPipelineCurrent(filename)) { return false; }
+        
+        map<string, SequenceDB*>::iterator it = pipelineFasta.find(filename);
+        if (it == pipelineFasta.end()) { return false; }
+        
+        db = *(it->second);
+        
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "CurrentFile", "getPipelineSequenceDB");
+        exit(1);
+    }
+}
+/*********************************************************************************************/
+void CurrentFile::setPipelineCountTable(string filename, CountTable* ct)  {
+    try {
+        lock_guard<std::mutex> guard(pipelineLock);
+        
+        filename = util.getFullPathName(filename);
+        string stamp = getPipelineStamp(filename);
+        
+        if (!pipelineMode || (stamp == "")) { delete ct; return; }
+        
+        removePipelineFile(filename);
+        pipelineCount[filename] = ct;
+        pipelineStamps[filename] = stamp;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "CurrentFile", "setPipelineCountTable");
+        exit(1);
+    }
+}
+/*********************************************************************************************/
+bool CurrentFile::getPipelineCountTable(string filename, CountTable& ct)  {
+    try {
+        lock_guard<std::mutex> guard(pipelineLock);
+        
+        if (!pipelineMode) { return false; }
+        
+        filename = util.getFullPathName(filename);
+        if (!isPipelineCurrent(filename)) { return false; }
+        
+        map<string, CountTable*>::iterator it = pipelineCount.find(filename);
+        if (it == pipelineCount.end()) { return false; }
+        
+        ct = *(it->second);
+        
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "CurrentFile", "getPipelineCountTable");
+        exit(1);
+    }
+}
+/*********************************************************************************************/
+void CurrentFile::setPipelineListVectors(string filename, vector<ListVector*>& lists)  {
+    try {
+        lock_guard<std::mutex> guard(pipelineLock);
+        
+        filename = util.getFullPathName(filename);
+        string stamp = getPipelineStamp(filename);
+        
+        if (!pipelineMode || (stamp == "")) {
+            for (int i = 0; i < lists.size(); i++) { delete lists[i]; }
+            lists.clear(); return;
+        }
+        
+        removePipelineFile(filename);
+        pipelineList[filename] = lists;
+        pipelineStamps[filename] = stamp;
+        lists.clear();
+    }
+    catch(exception& e) {
+        m->errorOut(e, "CurrentFile", "setPipelineListVectors");
+        exit(1);
+    }
+}
+/*********************************************************************************************/
+bool CurrentFile::hasPipelineListVectors(string filename)  {
+    try {
+        lock_guard<std::mutex> guard(pipelineLock);
+        
+        if (!pipelineMode) { return false; }
+        
+        filename = util.getFullPathName(filename);
+        if (!isPipelineCurrent(filename)) { return false; }
+        
+        return (pipelineList.count(filename) != 0);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "CurrentFile", "hasPipelineListVectors");
+        exit(1);
+    }
+}
+/*********************************************************************************************/
+ListVector* CurrentFile::getPipelineListVector(string filename, int index)  {
+    try {
+        lock_guard<std::mutex> guard(pipelineLock);
+        
+        map<string, vector<ListVector*> >::iterator it = pipelineList.find(util.getFullPathName(filename));
+        if (it == pipelineList.end()) { return NULL; }
+        if ((index < 0) || (index >= it->second.size())) { return NULL; }
+        
+        return (new ListVector(*(it->second[index])));
+    }
+    catch(exception& e) {
+        m->errorOut(e, "CurrentFile", "getPipelineListVector");
+        exit(1);
+    }
+}
+/*********************************************************************************************/
+int CurrentFile::getPipelineListIndex(string filename, string label)  {
+    try {
+        lock_guard<std::mutex> guard(pipelineLock);
+        
+        map<string, vector<ListVector*> >::iterator it = pipelineList.find(util.getFullPathName(filename));
+        if (it == pipelineList.end()) { return -1; }
+        
+        for (int i = 0; i < it->second.size(); i++) { if (it->second[i]->getLabel() == label) { return i; } }
+        
+        return -1;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "CurrentFile", "getPipelineListIndex");
+        exit(1);
+    }
+}
+/*********************************************************************************************/
+void CurrentFile::setPipelineSharedRAbundVectors(string filename, vector<SharedRAbundVectors*>& lookups)  {
+    try {
+        lock_guard<std::mutex> guard(pipelineLock);
+        
+        filename = util.getFullPathName(filename);
+        string stamp = getPipelineStamp(filename);
+        
+        if (!pipelineMode || (stamp == "")) {
+            for (int i = 0; i < lookups.size(); i++) { delete lookups[i]; }
+            lookups.clear(); return;
+        }
+        
+        removePipelineFile(filename);
+        pipelineShared[filename] = lookups;
+        pipelineStamps[filename] = stamp;
+        lookups.clear();
+    }
+    catch(exception& e) {
+        m->errorOut(e, "CurrentFile", "setPipelineSharedRAbundVectors");
+        exit(1);
+    }
+}
+/*********************************************************************************************/
+bool CurrentFile::hasPipelineSharedRAbundVectors(string filename)  {
+    try {
+        lock_guard<std::mutex> guard(pipelineLock);
+        
+        if (!pipelineMode) { return false; }
+        
+        filename = util.getFullPathName(filename);
+        if (!isPipelineCurrent(filename)) { return false; }
+        
+        return (pipelineShared.count(filename) != 0);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "CurrentFile", "hasPipelineSharedRAbundVectors");
+        exit(1);
+    }
+}
+/*********************************************************************************************/
+SharedRAbundVectors* CurrentFile::getPipelineSharedRAbundVectors(string filename, int index)  {
+    try {
+        lock_guard<std::mutex> guard(pipelineLock);
+        
+        map<string, vector<SharedRAbundVectors*> >::iterator it = pipelineShared.find(util.getFullPathName(filename));
+        if (it == pipelineShared.end()) { return NULL; }
+        if ((index < 0) || (index >= it->second.size())) { return NULL; }
+        
+        //built by hand because the copy constructor removes zero otus, which the file reader does not
+        SharedRAbundVectors* stored = it->second[index];
+        SharedRAbundVectors* shared = new SharedRAbundVectors();
+        vector<SharedRAbundVector*> data = stored->getSharedRAbundVectors();
+        for (int i = 0; i < data.size(); i++) { shared->push_back(data[i]); }
+        shared->setLabels(stored->getLabel());
+        shared->setOTUNames(stored->getOTUNames());
+        
+        return shared;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "CurrentFile", "getPipelineSharedRAbundVectors");
+        exit(1);
+    }
+}
+/*********************************************************************************************/
+int CurrentFile::getPipelineSharedIndex(string filename, string label)  {
+    try {
+        lock_guard<std::mutex> guard(pipelineLock);
+        
+        map<string, vector<SharedRAbundVectors*> >::iterator it = pipelineShared.find(util.getFullPathName(filename));
+        if (it == pipelineShared.end()) { return -1; }
+        
+        for (int i = 0; i < it->second.size(); i++) { if (it->second[i]->getLabel() == label) { return i; } }
+        
+        return -1;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "CurrentFile", "getPipelineSharedIndex");
+        exit(1);
+    }
+}
+/*********************************************************************************************/
+//run by the engines after each command so only the current files stay in memory
+void CurrentFile::trimPipelineCache()  {
+    try {
+        lock_guard<std::mutex> guard(pipelineLock);
+        
+        set<string> keep;
+        keep.insert(fastafile); keep.insert(countfile); keep.insert(listfile); keep.insert(sharedfile);
+        
+        vector<string> remove;
+        for (map<string, string>::iterator it = pipelineStamps.begin(); it != pipelineStamps.end(); it++) {
+            if (keep.count(it->first) == 0) { remove.push_back(it->first); }
+        }
+        
+        for (int i = 0; i < remove.size(); i++) { removePipelineFile(remove[i]); }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "CurrentFile", "trimPipelineCache");
+        exit(1);
+    }
+}
+/*********************************************************************************************/
+void CurrentFile::clearPipelineCache()  {
+    try {
+        lock_guard<std::mutex> guard(pipelineLock);
+        
+        vector<string> remove;
+        for (map<string, string>::iterator it = pipelineStamps.begin(); it != pipelineStamps.end(); it++) { remove.push_back(it->first); }
+        
+        for (int i = 0; i < remove.size(); i++) { removePipelineFile(remove[i]); }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "CurrentFile", "clearPipelineCache");
+        exit(1);
+    }
+}
+/*********************************************************************************************/
@@ -16,6 +16,11 @@
 #include "mothurout.h"
 #include "utils.hpp"
 
+class SequenceDB;
+class CountTable;
+class ListVector;
+class SharedRAbundVectors;
+
 /***********************************************/
 
 class CurrentFile {
@@ -120,6 +125,25 @@ class CurrentFile {
         void setGroupMode(string t)                     { groupMode = t;                    }
         string getTestDirectory()                       { return testDirectory;             }
         void setTestDirectory(string t)                 { testDirectory = t;                }
+    
+        //pipeline mode - keeps the parsed fasta, count, list and shared files in memory between commands so the next command can skip rereading them.
+        //objects are keyed by the full path of their file and dropped if the file on disk changes. Stored objects are owned by CurrentFile, the get functions return copies.
+        bool getPipelineMode()                          { return pipelineMode;              }
+        void setPipelineMode(bool);
+        void setPipelineSequenceDB(string, SequenceDB*);
+        bool getPipelineSequenceDB(string, SequenceDB&);
+        void setPipelineCountTable(string, CountTable*);
+        bool getPipelineCountTable(string, CountTable&);
+        void setPipelineListVectors(string, vector<ListVector*>&);
+        bool hasPipelineListVectors(string);
+        ListVector* getPipelineListVector(string, int); //filename, index of label in file. returns NULL if past the end
+        int getPipelineListIndex(string, string); //filename, label. returns -1 if not found
+        void setPipelineSharedRAbundVectors(string, vector<SharedRAbundVectors*>&);
+        bool hasPipelineSharedRAbundVectors(string);
+        SharedRAbundVectors* getPipelineSharedRAbundVectors(string, int);
+        int getPipelineSharedIndex(string, string);
+        void trimPipelineCache(); //removes objects whose files are no longer current
+        void clearPipelineCache();
    
 	
 	private:
@@ -131,7 +155,17 @@ class CurrentFile {
     
         string accnosfile, phylipfile, columnfile, listfile, rabundfile, sabundfile, namefile, groupfile, designfile, taxonomyfile, biomfile, filefile, testFilePath, contigsreportfile;
         string orderfile, treefile, sharedfile, ordergroupfile, relabundfile, fastafile, qualfile, sfffile, oligosfile, processors, flowfile, countfile, summaryfile, constaxonomyfile, groupMode, testDirectory, sharedHeaderMode;
-    bool mothurCalling;
+    bool mothurCalling, pipelineMode;
+    
+        std::mutex pipelineLock;
+        map<string, string> pipelineStamps; //filename -> size and modification time when stored
+        map<string, SequenceDB*> pipelineFasta;
+        map<string, CountTable*> pipelineCount;
+        map<string, vector<ListVector*> > pipelineList;
+        map<string, vector<SharedRAbundVectors*> > pipelineShared;
+        string getPipelineStamp(string);
+        bool isPipelineCurrent(string);
+        void removePipelineFile(string);
 		
 		static CurrentFile* instance;
 		CurrentFile( const CurrentFile& ); // Disable copy constructor
@@ -191,8 +225,9 @@ class CurrentFile {
             groupMode = "group";
             sharedHeaderMode = "otu";
             mothurCalling = false;
+            pipelineMode = false;
 		}
-		~CurrentFile() { instance = 0; }
+		~CurrentFile() { clearPipelineCache(); instance = 0; }
 };
 /***********************************************/
 
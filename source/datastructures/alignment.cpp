@@ -9,24 +9,21 @@
  *  
  */
 
-#include "alignmentcell.hpp"
 #include "alignment.hpp"
-
+#include "overlap.hpp"
 
 /**************************************************************************************************/
 
-Alignment::Alignment() {	m = MothurOut::getInstance(); current = CurrentFile::getInstance(); /*	do nothing	*/	}
+Alignment::Alignment() : banded(false), bandTouched(false), traceStride(0) {	m = MothurOut::getInstance(); current = CurrentFile::getInstance(); /*	do nothing	*/	}
 
 /**************************************************************************************************/
 
-Alignment::Alignment(int A) : nCols(A), nRows(A) {
+Alignment::Alignment(int A) : nCols(A), nRows(A), banded(false), bandTouched(false), traceStride(0) {
 	try {
         current = CurrentFile::getInstance();
 		m = MothurOut::getInstance();
-		alignment.resize(nRows);			//	For the Gotoh and Needleman-Wunsch we initialize the dynamic programming
-		for(int i=0;i<nRows;i++){			//	matrix by initializing a matrix that is A x A.  By default we will set A
-			alignment[i].resize(nCols);		//	at 2000 for 16S rRNA gene sequences
-		}	
+		firstRow.resize(nCols, 'x');		//	For the Gotoh and Needleman-Wunsch we size the edges of the dynamic programming
+		firstColumn.resize(nRows, 'x');		//	matrix to A.  By default we will set A at 2000 for 16S rRNA gene sequences
 	}
 	catch(exception& e) {
 		m->errorOut(e, "Alignment", "Alignment");
@@ -35,14 +32,12 @@ Alignment::Alignment(int A) : nCols(A), nRows(A) {
 }
 /**************************************************************************************************/
 
-Alignment::Alignment(int A, int nk) : nCols(A), nRows(A) {
+Alignment::Alignment(int A, int nk) : nCols(A), nRows(A), banded(false), bandTouched(false), traceStride(0) {
     try {
         current = CurrentFile::getInstance();
         m = MothurOut::getInstance();
-        alignment.resize(nRows);			//	For the Gotoh and Needleman-Wunsch we initialize the dynamic programming
-        for(int i=0;i<nRows;i++){			//	matrix by initializing a matrix that is A x A.  By default we will set A
-            alignment[i].resize(nCols);		//	at 2000 for 16S rRNA gene sequences
-        }
+        firstRow.resize(nCols, 'x');
+        firstColumn.resize(nRows, 'x');
     }
     catch(exception& e) {
         m->errorOut(e, "Alignment", "Alignment");
@@ -50,15 +45,14 @@ Alignment::Alignment(int A, int nk) : nCols(A), nRows(A) {
     }
 }
 /**************************************************************************************************/
+//new edge cells point nowhere, as new cells of the full matrix did
 void Alignment::resize(int A) {
 	try {
 		nCols = A;
 		nRows = A;
 
-		alignment.resize(nRows);			
-		for(int i=0;i<nRows;i++){			
-			alignment[i].resize(nCols);		
-		}	
+		firstRow.resize(nCols, 'x');
+		firstColumn.resize(nRows, 'x');
 	}
 	catch(exception& e) {
 		m->errorOut(e, "Alignment", "resize");
@@ -66,6 +60,120 @@ void Alignment::resize(int A) {
 	}
 }
 /**************************************************************************************************/
+//the Gotoh and Needleman-Wunsch aligners will only fill the cells whose diagonal, column - row, is between low and high.
+//The first row and column are always available, so the alignment can still start anywhere along the edges.
+void Alignment::setBand(int low, int high) {
+	try {
+		if (low > high) { int temp = low; low = high; high = temp; }
+		
+		banded = true;
+		bandLow = low;
+		bandHigh = high;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Alignment", "setBand");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//first > last if the band misses the row
+void Alignment::getBandColumns(int row, int& first, int& last) {
+	first = 1; last = lA-1;
+	
+	if (banded) {
+		first = max(1, row+bandLow);
+		last = min(lA-1, row+bandHigh);
+	}
+}
+/**************************************************************************************************/
+
+void Alignment::setBandedLastRow(vector<float>& bottomRow) {
+	try {
+		if (lB < 2) { lastRowScores.assign(lA, 0); return; } //there is only the top row
+		
+		lastRowScores.assign(lA, BAND_EDGE_SCORE);
+		lastRowScores[0] = 0;
+		
+		int first, last;
+		getBandColumns(lB-1, first, last);
+		for (int j = first; j <= last; j++) { lastRowScores[j] = bottomRow[j]; }
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Alignment", "setBandedLastRow");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//sizes the packed traceback for the current lA and lB, every interior cell is then set once by align
+void Alignment::resetTraceMatrix() {
+	try {
+		traceStride = 0;
+		unsigned long long numRows = 0;
+		if ((lA > 1) && (lB > 1)) { traceStride = (lA-1+3)/4; numRows = lB-1; }
+		
+		traceMatrix.assign(traceStride * numRows, 0);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Alignment", "resetTraceMatrix");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+void Alignment::setPrevCell(int row, int column, char direction) {
+	try {
+		if (row == 0)           {   if (column < firstRow.size()) { firstRow[column] = direction; }     }
+		else if (column == 0)   {   if (row < firstColumn.size()) { firstColumn[row] = direction; }     }
+		else {
+			unsigned char code = TRACE_DIAGONAL;
+			if (direction == 'l')       { code = TRACE_LEFT;    }
+			else if (direction == 'u')  { code = TRACE_UP;      }
+			
+			unsigned char* traceRow = getTraceRow(row);
+			int shift = ((column-1) & 3) << 1;
+			traceRow[(column-1) >> 2] = (traceRow[(column-1) >> 2] & ~(3 << shift)) | (code << shift);
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Alignment", "setPrevCell");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+char Alignment::getPrevCell(int row, int column) {
+	if (row == 0)           {   if (column < firstRow.size()) { return firstRow[column]; } return 'x';  }
+	else if (column == 0)   {   if (row < firstColumn.size()) { return firstColumn[row]; } return 'x';  }
+	
+	int code = (getTraceRow(row)[(column-1) >> 2] >> (((column-1) & 3) << 1)) & 3;
+	
+	if (code == TRACE_LEFT)     { return 'l';   }
+	else if (code == TRACE_UP)  { return 'u';   }
+	return 'd';
+}
+/**************************************************************************************************/
+//Fix the gaps at the 3' end of the sequences, see Overlap
+void Alignment::fixOverlap() {
+	try {
+		int row = lB-1;
+		int column = lA-1;
+		int index = 0;
+		
+		Overlap over;
+		char direction = over.setOverlap(lastRowScores, lastColumnScores, lA, lB, index, 0);
+		
+		if (direction == 'u') {
+			for(int i=index+1;i<lB;i++)     {   setPrevCell(i, column, 'u');    }
+		}else if (direction == 'l') {
+			for(int i=index+1;i<lA;i++)     {   setPrevCell(row, i, 'l');       }
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Alignment", "fixOverlap");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
 
 void Alignment::traceBack(){			//	This traceback routine is used by the dynamic programming algorithms
 	try {	
@@ -73,40 +181,51 @@ void Alignment::traceBack(){			//	This traceback routine is used by the dynamic
         ABaseMap.clear(); //	to fill the values of seqAaln and seqBaln
 		seqAaln = "";
 		seqBaln = "";
+		bandTouched = false;
 		int row = lB-1;
 		int column = lA-1;
 		//	seqAstart = 1;
 		//	seqAend = column;
 		
-		AlignmentCell currentCell = alignment[row][column];	//	Start the traceback from the bottom-right corner of the
+		char prevCell = getPrevCell(row, column);	//	Start the traceback from the bottom-right corner of the
 		//	matrix
 		
-		if(currentCell.prevCell == 'x'){	seqAaln = seqBaln = "NOALIGNMENT";		}//If there's an 'x' in the bottom-
+		if(prevCell == 'x'){	seqAaln = seqBaln = "NOALIGNMENT";		}//If there's an 'x' in the bottom-
 		else{	//	right corner bail out because it means nothing got aligned
             int count = 0;
-			while(currentCell.prevCell != 'x'){				//	while the previous cell isn't an 'x', keep going...
+            string reverseA, reverseB; //built backwards and flipped at the end
+			while(prevCell != 'x'){				//	while the previous cell isn't an 'x', keep going...
+				
+				if (banded && (row > 0) && (column > 0)) {	//	the end gaps added by fixOverlap run along the last row
+					if (((row < lB-1) && (column < lA-1)) || (prevCell == 'd')) {	//	or column and may leave the band
+						int diagonal = column - row;
+						if ((diagonal <= bandLow) || (diagonal >= bandHigh)) { bandTouched = true; }
+					}
+				}
 				
-				if(currentCell.prevCell == 'u'){			//	if the pointer to the previous cell is 'u', go up in the
-					seqAaln = '-' + seqAaln;				//	matrix.  this indicates that we need to insert a gap in
-					seqBaln = seqB[row] + seqBaln;			//	seqA and a base in seqB
+				if(prevCell == 'u'){			//	if the pointer to the previous cell is 'u', go up in the
+					reverseA += '-';				//	matrix.  this indicates that we need to insert a gap in
+					reverseB += seqB[row];			//	seqA and a base in seqB
                     BBaseMap[row] = count;
-					currentCell = alignment[--row][column];
+					prevCell = getPrevCell(--row, column);
 				}
-				else if(currentCell.prevCell == 'l'){		//	if the pointer to the previous cell is 'l', go to the left
-					seqBaln = '-' + seqBaln;				//	in the matrix.  this indicates that we need to insert a gap
-					seqAaln = seqA[column] + seqAaln;		//	in seqB and a base in seqA
+				else if(prevCell == 'l'){		//	if the pointer to the previous cell is 'l', go to the left
+					reverseB += '-';				//	in the matrix.  this indicates that we need to insert a gap
+					reverseA += seqA[column];		//	in seqB and a base in seqA
                     ABaseMap[column] = count;
-					currentCell = alignment[row][--column];
+					prevCell = getPrevCell(row, --column);
 				}
 				else{
-					seqAaln = seqA[column] + seqAaln;		//	otherwise we need to go diagonally up and to the left,
-					seqBaln = seqB[row] + seqBaln;			//	here we add a base to both alignments
+					reverseA += seqA[column];		//	otherwise we need to go diagonally up and to the left,
+					reverseB += seqB[row];			//	here we add a base to both alignments
                     BBaseMap[row] = count;
                     ABaseMap[column] = count;
-					currentCell = alignment[--row][--column];
+					prevCell = getPrevCell(--row, --column);
 				}
                 count++;
 			}
+            seqAaln.assign(reverseA.rbegin(), reverseA.rend());
+            seqBaln.assign(reverseB.rbegin(), reverseB.rend());
 		}
 		
        
@@ -152,17 +271,7 @@ void Alignment::traceBack(){			//	This traceback routine is used by the dynamic
 }
 /**************************************************************************************************/
 
-Alignment::~Alignment(){
-	try {
-		for (int i = 0; i < alignment.size(); i++) {
-			for (int j = (alignment[i].size()-1); j >= 0; j--) {  alignment[i].pop_back();  }
-		}
-	}
-	catch(exception& e) {
-		m->errorOut(e, "Alignment", "~Alignment");
-		exit(1);
-	}
-}
+Alignment::~Alignment(){	/*	do nothing	*/	}
 
 /**************************************************************************************************/
 
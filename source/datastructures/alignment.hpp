@@ -14,9 +14,13 @@
  */
 
 #include "mothur.h"
-#include "alignmentcell.hpp"
 #include "currentfile.h"
 
+#define TRACE_DIAGONAL 0
+#define TRACE_LEFT 1
+#define TRACE_UP 2
+#define BAND_EDGE_SCORE -1e9f	//score of the cells just outside a band, low enough that no path goes through them
+
 /**************************************************************************************************/
 
 class Alignment {
@@ -43,17 +47,40 @@ public:
 	int getPairwiseLength();
 	void resize(int);
 	int getnRows() { return nRows; }
+	void setBand(int, int);		//lowest and highest diagonal (column - row) filled by align, until clearBand is called
+	void clearBand() { banded = false; }
+	bool getBandTouched() { return bandTouched; }	//true if the last banded alignment ran along the edge of its band
 //	int getLongestTemplateGap();
 
 protected:
 	void traceBack();
+	void resetTraceMatrix();
+	unsigned char* getTraceRow(int row) { //row > 0, column j is in byte (j-1)/4. NULL if there are no interior cells, lA or lB is 1
+		if (traceStride == 0) { return NULL; }
+		return traceMatrix.data() + ((unsigned long long)(row-1) * traceStride);
+	}
+	void setPrevCell(int, int, char);     //row, column, direction
+	char getPrevCell(int, int);           //row, column
+	void fixOverlap();
+	void getBandColumns(int, int&, int&);  //row, first column, last column to fill in that row
+	void setBandedLastRow(vector<float>&); //scores of the bottom row, the cells outside the band are BAND_EDGE_SCORE
 	string seqA, seqAaln;
 	string seqB, seqBaln;
 	int seqAstart, seqAend;
 	int seqBstart, seqBend;
 	int pairwiseLength;
 	int nRows, nCols, lA, lB;
-	vector<vector<AlignmentCell> > alignment;
+	bool banded, bandTouched;
+	int bandLow, bandHigh;
+	
+	//The dynamic programming algorithms only keep a row or two of scores, so the traceback is all that is stored for
+	//each cell. It is packed 2 bits per cell for rows 1 to lB-1 and columns 1 to lA-1, each row starting on a new byte.
+	//The top row and left column are never written by align, so their pointers are kept separately and sized by nCols
+	//and nRows.
+	vector<unsigned char> traceMatrix;
+	unsigned long long traceStride;       //bytes per row of traceMatrix
+	vector<char> firstRow, firstColumn;
+	vector<float> lastRowScores, lastColumnScores; //scores along the bottom row and right column, used by Overlap
     map<int, int> ABaseMap;
     map<int, int> BBaseMap;
 	MothurOut* m;
@@ -7,6 +7,7 @@
 //
 
 #include "counttable.h"
+#include "currentfile.h"
 
 /************************************************************/
 int CountTable::createTable(set<string>& n, map<string, string>& g, set<string>& gs) {
@@ -152,6 +153,7 @@ int CountTable::createTable(string namefile, string groupfile, bool createGroup)
         indexGroupMap.clear();
         indexNameMap.clear();
         counts.clear();
+        totals.clear();
         map<int, string> originalGroupIndexes;
         
         if (groupfile != "") { 
@@ -313,6 +315,11 @@ int CountTable::readTable(string file, string format) {
 int CountTable::readTable(string file, bool readGroups, bool mothurRunning) {
     try {
         filename = file;
+        
+        //in pipeline mode the table may already be in memory from the command that wrote or read it
+        CurrentFile* current = CurrentFile::getInstance();
+        if (current->getPipelineCountTable(file, *this)) { filename = file; return finishPipelineTable(readGroups, mothurRunning); }
+        
         ifstream in;
         util.openInputFile(filename, in);
         
@@ -371,6 +378,11 @@ int CountTable::readTable(string file, bool readGroups, bool mothurRunning) {
         }
         in.close();
         
+        if (!error && readGroups && current->getPipelineMode()) { //save the table as it is in the file
+            CountTable* stored = new CountTable(); *stored = *this;
+            current->setPipelineCountTable(filename, stored);
+        }
+        
         if (error) { m->setControl_pressed(true); }
         else { //check for zero groups
             if (hasGroups) {
@@ -388,6 +400,38 @@ int CountTable::readTable(string file, bool readGroups, bool mothurRunning) {
 	}
 }
 /************************************************************/
+//applies the readGroups and mothurRunning options to a table copied from the pipeline cache, the same way readTable does for a file
+int CountTable::finishPipelineTable(bool readGroups, bool mothurRunning) {
+    try {
+        bool error = false;
+        
+        if (!readGroups) { hasGroups = false; counts.clear(); totalGroups.assign(groups.size(), 0); }
+        
+        if (!mothurRunning) {
+            map<int, string> reverse;
+            for (map<string, int>::iterator it = indexNameMap.begin(); it != indexNameMap.end(); it++) { reverse[it->second] = it->first; }
+            for (map<int, string>::iterator it = reverse.begin(); it != reverse.end(); it++) {
+                if (totals[it->first] == 0) { error=true; m->mothurOut("[ERROR]: Your count table contains a sequence named " + it->second + " with a total=0. Please correct."); m->mothurOutEndLine(); }
+            }
+        }
+        
+        if (error) { m->setControl_pressed(true); }
+        else { //check for zero groups
+            if (hasGroups) {
+                for (int i = 0; i < totalGroups.size(); i++) {
+                    if (totalGroups[i] == 0) { m->mothurOut("\nRemoving group: " + groups[i] + " because all sequences have been removed.\n"); removeGroup(groups[i]); i--; }
+                }
+            }
+        }
+        
+        return 0;
+    }
+	catch(exception& e) {
+		m->errorOut(e, "CountTable", "finishPipelineTable");
+		exit(1);
+	}
+}
+/************************************************************/
 int CountTable::printTable(string file) {
     try {
         ofstream out;
@@ -413,6 +457,9 @@ int CountTable::printTable(string file) {
             }
         }
         out.close();
+        
+        if (CurrentFile::getInstance()->getPipelineMode()) { savePipelineTable(file, reverse); }
+        
         return 0;
     }
 	catch(exception& e) {
@@ -421,6 +468,47 @@ int CountTable::printTable(string file) {
 	}
 }
 /************************************************************/
+//stores a copy of the table as readTable would build it from the file printTable just wrote
+int CountTable::savePipelineTable(string file, map<int, string>& reverse) {
+    try {
+        if (hasGroups != (groups.size() != 0)) { return 0; } //headers and rows would not match
+        
+        CountTable* stored = new CountTable();
+        stored->hasGroups = hasGroups;
+        stored->groups = groups;
+        sort(stored->groups.begin(), stored->groups.end());
+        stored->totalGroups.resize(groups.size(), 0);
+        
+        vector<int> sortedIndex(groups.size(), 0); //index in groups -> index in stored groups
+        for (int i = 0; i < stored->groups.size(); i++) { stored->indexGroupMap[stored->groups[i]] = i; }
+        for (int i = 0; i < groups.size(); i++) { sortedIndex[i] = stored->indexGroupMap[groups[i]]; }
+        
+        for (int i = 0; i < totals.size(); i++) {
+            map<int, string>::iterator itR = reverse.find(i);
+            if (itR == reverse.end()) { continue; } //removed seq
+            
+            if (hasGroups) {
+                vector<int> groupCounts(groups.size(), 0);
+                for (int j = 0; j < groups.size(); j++) { groupCounts[sortedIndex[j]] = counts[i][j]; stored->totalGroups[sortedIndex[j]] += counts[i][j]; }
+                stored->counts.push_back(groupCounts);
+            }
+            stored->indexNameMap[itR->second] = stored->uniques;
+            stored->totals.push_back(totals[i]);
+            stored->total += totals[i];
+            stored->uniques++;
+        }
+        stored->filename = file;
+        
+        CurrentFile::getInstance()->setPipelineCountTable(file, stored);
+        
+        return 0;
+    }
+	catch(exception& e) {
+		m->errorOut(e, "CountTable", "savePipelineTable");
+		exit(1);
+	}
+}
+/************************************************************/
 vector<string> CountTable::getHardCodedHeaders() {
     try {
         vector<string> headers; headers.push_back("Representative_Sequence"); headers.push_back("total");
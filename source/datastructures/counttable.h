@@ -107,6 +107,9 @@ class CountTable {
         map<string, int> indexNameMap;
         map<string, int> indexGroupMap;
     
+        int finishPipelineTable(bool, bool);
+        int savePipelineTable(string, map<int, string>&);
+    
 };
 
 #endif
@@ -0,0 +1,61 @@
+//
+//  densematrix.cpp
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "densematrix.hpp"
+
+#define DENSE_BLOCK_SIZE 64
+
+/***********************************************************************/
+DenseMatrix::DenseMatrix(const vector< vector<double> >& matrix) : numRows(0), numCols(0) {
+    numRows = matrix.size();
+    if (numRows != 0) { numCols = matrix[0].size(); }
+
+    data.resize((size_t)numRows*(size_t)numCols, 0.0);
+    for (int i = 0; i < numRows; i++) {
+        int rowSize = min((int)matrix[i].size(), numCols);
+        std::copy(matrix[i].begin(), matrix[i].begin()+rowSize, data.begin()+(size_t)i*numCols);
+    }
+}
+/***********************************************************************/
+void DenseMatrix::resize(int r, int c, double value) {
+    numRows = r; numCols = c;
+    data.assign((size_t)r*(size_t)c, value);
+}
+/***********************************************************************/
+void DenseMatrix::swapRows(int i, int j) {
+    if (i == j) { return; }
+    std::swap_ranges(data.begin()+(size_t)i*numCols, data.begin()+(size_t)(i+1)*numCols, data.begin()+(size_t)j*numCols);
+}
+/***********************************************************************/
+//transposes in tiles so both the reads and the writes stay in cache
+DenseMatrix DenseMatrix::transpose() const {
+    DenseMatrix trans(numCols, numRows);
+
+    for (int ii = 0; ii < numRows; ii += DENSE_BLOCK_SIZE) {
+        int iEnd = min(ii+DENSE_BLOCK_SIZE, numRows);
+        for (int jj = 0; jj < numCols; jj += DENSE_BLOCK_SIZE) {
+            int jEnd = min(jj+DENSE_BLOCK_SIZE, numCols);
+            for (int i = ii; i < iEnd; i++) {
+                const double* row = getRow(i);
+                for (int j = jj; j < jEnd; j++) { trans(j, i) = row[j]; }
+            }
+        }
+    }
+
+    return trans;
+}
+/***********************************************************************/
+vector< vector<double> > DenseMatrix::toVector() const {
+    vector< vector<double> > matrix(numRows);
+    for (int i = 0; i < numRows; i++) {
+        const double* row = getRow(i);
+        matrix[i].assign(row, row+numCols);
+    }
+    return matrix;
+}
+/***********************************************************************/
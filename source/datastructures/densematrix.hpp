@@ -0,0 +1,50 @@
+#ifndef Mothur_densematrix_hpp
+#define Mothur_densematrix_hpp
+
+//
+//  densematrix.hpp
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "mothur.h"
+
+/***********************************************************************/
+//row-major matrix stored in one contiguous block. Used by LinearAlgebra so the
+//inner loops walk memory sequentially and matrices can be moved instead of copied.
+class DenseMatrix {
+
+public:
+	DenseMatrix() : numRows(0), numCols(0) {}
+	DenseMatrix(int r, int c, double value=0.0) : numRows(r), numCols(c), data((size_t)r*(size_t)c, value) {}
+	DenseMatrix(const vector< vector<double> >&);
+	DenseMatrix(const DenseMatrix&) = default;
+	DenseMatrix(DenseMatrix&&) = default;
+	DenseMatrix& operator=(const DenseMatrix&) = default;
+	DenseMatrix& operator=(DenseMatrix&&) = default;
+	~DenseMatrix() {}
+
+	int getNumRows() const { return numRows; }
+	int getNumCols() const { return numCols; }
+	bool empty() const { return data.empty(); }
+	void resize(int, int, double value=0.0); //clears existing values
+	void fill(double value) { std::fill(data.begin(), data.end(), value); }
+
+	double& operator()(int i, int j) { return data[(size_t)i*numCols+j]; }
+	const double& operator()(int i, int j) const { return data[(size_t)i*numCols+j]; }
+	double* getRow(int i) { return &data[(size_t)i*numCols]; }
+	const double* getRow(int i) const { return &data[(size_t)i*numCols]; }
+
+	void swapRows(int, int);
+	DenseMatrix transpose() const;
+	vector< vector<double> > toVector() const;
+
+private:
+	int numRows, numCols;
+	vector<double> data;
+};
+/***********************************************************************/
+
+#endif
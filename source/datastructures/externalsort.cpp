@@ -0,0 +1,376 @@
+//
+//  externalsort.cpp
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "externalsort.hpp"
+
+/**************************************************************************************************/
+//memcmp, with a shorter string first if it is a prefix of the longer
+inline int compareBytes(const char* a, size_t aLength, const char* b, size_t bLength) {
+    size_t length = min(aLength, bLength);
+    if (length != 0) { int result = memcmp(a, b, length); if (result != 0) { return result; } }
+    if (aLength < bLength) { return -1; }
+    if (aLength > bLength) { return 1; }
+    return 0;
+}
+/**************************************************************************************************/
+//the length of a record without its final '\n', so a line that starts another sorts first like it does in sort
+inline size_t lineLength(const char* record, size_t length) {
+    if ((length != 0) && (record[length-1] == '\n')) { return length-1; }
+    return length;
+}
+/**************************************************************************************************/
+struct externalSortLess {
+    const char* data;
+    bool compareRecords;
+
+    externalSortLess(const char* d, bool c) : data(d), compareRecords(c) {}
+    bool operator()(const ExternalSortItem& a, const ExternalSortItem& b) const {
+        if (a.prefix != b.prefix) { return (a.prefix < b.prefix); }
+        int result = compareBytes(data + a.offset, a.keyLength, data + b.offset, b.keyLength);
+        if ((result == 0) && compareRecords) {
+            const char* recordA = data + a.offset + a.keyLength; const char* recordB = data + b.offset + b.keyLength;
+            result = compareBytes(recordA, lineLength(recordA, a.recordLength), recordB, lineLength(recordB, b.recordLength));
+        }
+        return (result < 0);
+    }
+};
+/**************************************************************************************************/
+struct externalSortData {
+    vector<ExternalSortItem>::iterator start, end;
+    externalSortLess less;
+
+    externalSortData(vector<ExternalSortItem>::iterator s, vector<ExternalSortItem>::iterator e, externalSortLess l) : start(s), end(e), less(l) {}
+};
+/**************************************************************************************************/
+void driverExternalSort(externalSortData* params) {
+    stable_sort(params->start, params->end, params->less);
+}
+/**************************************************************************************************/
+//a run file being merged, each record is its key length, record length, key and record
+struct externalSortRun {
+    ifstream in;
+    string key, record;
+    int index; //the run's place in the input, so equal records come out in the order they were added
+
+    bool next() {
+        unsigned int lengths[2];
+        if (!in.read((char*)lengths, sizeof(lengths))) { return false; }
+        key.resize(lengths[0]); record.resize(lengths[1]);
+        if (lengths[0] != 0) { in.read(&key[0], lengths[0]); }
+        if (lengths[1] != 0) { in.read(&record[0], lengths[1]); }
+        return true;
+    }
+};
+/**************************************************************************************************/
+struct externalSortRunGreater { //the run with the smallest record is on top of the heap
+    vector<externalSortRun*>* runs;
+    bool compareRecords;
+
+    externalSortRunGreater(vector<externalSortRun*>* r, bool c) : runs(r), compareRecords(c) {}
+    bool operator()(int a, int b) const {
+        externalSortRun* runA = (*runs)[a]; externalSortRun* runB = (*runs)[b];
+        int result = compareBytes(runA->key.data(), runA->key.length(), runB->key.data(), runB->key.length());
+        if ((result == 0) && compareRecords) { result = compareBytes(runA->record.data(), lineLength(runA->record.data(), runA->record.length()), runB->record.data(), lineLength(runB->record.data(), runB->record.length())); }
+        if (result == 0) { return (runA->index > runB->index); }
+        return (result > 0);
+    }
+};
+/**************************************************************************************************/
+struct externalSortMergeData {
+    vector<string> runFiles;
+    string outputFile;
+    bool justRecords, compareRecords;
+    long long count;
+    MothurOut* m;
+    Utils util;
+
+    externalSortMergeData(vector<string> r, string o, bool j, bool c) : runFiles(r), outputFile(o), justRecords(j), compareRecords(c) { count = 0; m = MothurOut::getInstance(); }
+};
+/**************************************************************************************************/
+//merges the runs into the output file, either as a new run or just the records. The runs are removed
+void driverExternalSortMerge(externalSortMergeData* params) {
+    try {
+        ofstream out(params->outputFile.c_str(), ios_base::out | ios_base::binary | ios_base::trunc);
+        if (!out) { params->m->mothurOut("[ERROR]: Could not open " + params->outputFile + "\n"); params->m->setControl_pressed(true); return; }
+
+        vector<externalSortRun*> runs;
+        externalSortRunGreater greater(&runs, params->compareRecords);
+        priority_queue<int, vector<int>, externalSortRunGreater> heap(greater);
+
+        for (int i = 0; i < params->runFiles.size(); i++) {
+            externalSortRun* run = new externalSortRun();
+            run->in.open(params->runFiles[i].c_str(), ios_base::in | ios_base::binary);
+            run->index = i;
+            runs.push_back(run);
+            if (run->next()) { heap.push(i); }
+        }
+
+        while (!heap.empty()) {
+            if (params->m->getControl_pressed()) { break; }
+
+            int smallest = heap.top(); heap.pop();
+            externalSortRun* run = runs[smallest];
+
+            if (!params->justRecords) {
+                unsigned int lengths[2] = { (unsigned int)run->key.length(), (unsigned int)run->record.length() };
+                out.write((char*)lengths, sizeof(lengths));
+                out.write(run->key.data(), run->key.length());
+            }
+            out.write(run->record.data(), run->record.length());
+            params->count++;
+
+            if (run->next()) { heap.push(smallest); }
+        }
+        out.close();
+
+        for (int i = 0; i < runs.size(); i++) { runs[i]->in.close(); params->util.mothurRemove(params->runFiles[i]); delete runs[i]; }
+    }
+    catch(exception& e) {
+        params->m->errorOut(e, "ExternalSort", "driverExternalSortMerge");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+
+ExternalSort::ExternalSort(string r, int p, unsigned long long mem, bool c) {
+    try {
+        m = MothurOut::getInstance();
+        rootName = r; processors = p; memory = mem; compareRecords = c;
+        if (processors < 1) { processors = 1; }
+        numRecords = 0;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "ExternalSort", "ExternalSort");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+
+ExternalSort::~ExternalSort() {
+    for (int i = 0; i < runFiles.size(); i++) { util.mothurRemove(runFiles[i]); }
+}
+/**************************************************************************************************/
+
+string ExternalSort::encodeKey(unsigned long long value) {
+    string key(8, '\0');
+    for (int i = 7; i >= 0; i--) { key[i] = (char)(value & 0xff); value >>= 8; }
+    return key;
+}
+/**************************************************************************************************/
+
+string ExternalSort::encodeKey(double value) {
+    if (value == 0) { value = 0; } //-0 is 0
+
+    unsigned long long bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    if (bits & 0x8000000000000000ull) { bits = ~bits; }
+    else { bits |= 0x8000000000000000ull; }
+
+    return encodeKey(bits);
+}
+/**************************************************************************************************/
+
+void ExternalSort::add(const string& key, const char* record, size_t length) {
+    try {
+        ExternalSortItem item;
+        item.prefix = 0;
+        for (int i = 0; i < 8; i++) { item.prefix <<= 8; if (i < key.length()) { item.prefix |= (unsigned char)key[i]; } }
+        item.keyLength = key.length();
+        item.recordLength = length;
+
+        size_t needed = key.length() + length;
+        if (!makeRoom(needed)) {
+            writeRun();
+            if (!makeRoom(needed)) { //a record larger than the budget is held on its own
+                vector<char>().swap(buffer); vector<ExternalSortItem>().swap(items);
+                buffer.reserve(needed); items.reserve(1);
+            }
+        }
+
+        item.offset = buffer.size();
+        buffer.insert(buffer.end(), key.begin(), key.end());
+        buffer.insert(buffer.end(), record, record + length);
+        items.push_back(item);
+        numRecords++;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "ExternalSort", "add");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//the capacity to grow a buffer to, doubling it if the budget allows. Growing holds the old and new copies at once.
+//0 if even the bytes needed would go over the budget
+unsigned long long ExternalSort::getGrowth(unsigned long long capacity, unsigned long long needed, unsigned long long others) {
+    if ((capacity + others) >= memory) { return 0; }
+    unsigned long long available = memory - others - capacity;
+
+    unsigned long long grown = max(needed, 2 * capacity);
+    if (grown > available) { grown = available; }
+    if (grown < needed) { return 0; }
+    return grown;
+}
+/**************************************************************************************************/
+
+bool ExternalSort::makeRoom(size_t needed) {
+    try {
+        //stable_sort and inplace_merge work in a copy of the items, so each item is counted twice
+        unsigned long long itemSize = 2 * sizeof(ExternalSortItem);
+
+        if ((buffer.size() + needed) > buffer.capacity()) {
+            unsigned long long grown = getGrowth(buffer.capacity(), buffer.size() + needed, items.capacity() * itemSize);
+            if (grown == 0) { return false; }
+            buffer.reserve(grown);
+        }
+
+        if (items.size() == items.capacity()) {
+            unsigned long long grown = getGrowth(items.capacity() * itemSize, (items.size() + 1) * itemSize, buffer.capacity());
+            if (grown == 0) { return false; }
+            items.reserve(grown / itemSize);
+        }
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "ExternalSort", "makeRoom");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//each processor sorts a slice of the items, then the slices are merged
+void ExternalSort::sortItems() {
+    try {
+        externalSortLess less(buffer.data(), compareRecords);
+
+        int numSlices = processors;
+        if (items.size() < (numSlices * 1000)) { numSlices = 1; } //not worth the threads
+
+        vector<size_t> bounds;
+        for (int i = 0; i <= numSlices; i++) { bounds.push_back((items.size() * i) / numSlices); }
+
+        vector<thread*> workerThreads;
+        vector<externalSortData*> data;
+        for (int i = 1; i < numSlices; i++) {
+            externalSortData* dataBundle = new externalSortData(items.begin() + bounds[i], items.begin() + bounds[i+1], less);
+            data.push_back(dataBundle);
+            workerThreads.push_back(new thread(driverExternalSort, dataBundle));
+        }
+
+        externalSortData* dataBundle = new externalSortData(items.begin() + bounds[0], items.begin() + bounds[1], less);
+        driverExternalSort(dataBundle);
+        delete dataBundle;
+
+        for (int i = 0; i < workerThreads.size(); i++) {
+            workerThreads[i]->join();
+            delete data[i];
+            delete workerThreads[i];
+        }
+
+        //merge neighboring slices until there is one
+        for (int width = 1; width < numSlices; width *= 2) {
+            for (int i = 0; (i + width) < numSlices; i += (2 * width)) {
+                int last = min(i + (2 * width), numSlices);
+                inplace_merge(items.begin() + bounds[i], items.begin() + bounds[i+width], items.begin() + bounds[last], less);
+            }
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "ExternalSort", "sortItems");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+
+void ExternalSort::writeRun() {
+    try {
+        if (items.size() == 0) { return; }
+
+        sortItems();
+
+        string runFile = rootName + toString(runFiles.size()) + ".sortrun.temp";
+        ofstream out(runFile.c_str(), ios_base::out | ios_base::binary | ios_base::trunc);
+        if (!out) { m->mothurOut("[ERROR]: Could not open " + runFile + "\n"); m->setControl_pressed(true); return; }
+        runFiles.push_back(runFile);
+
+        for (size_t i = 0; i < items.size(); i++) {
+            unsigned int lengths[2] = { items[i].keyLength, items[i].recordLength };
+            out.write((char*)lengths, sizeof(lengths));
+            out.write(buffer.data() + items[i].offset, items[i].keyLength + items[i].recordLength);
+        }
+        out.close();
+
+        buffer.clear(); items.clear();
+    }
+    catch(exception& e) {
+        m->errorOut(e, "ExternalSort", "writeRun");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+
+long long ExternalSort::output(string outputFile) {
+    try {
+        //everything fit in memory
+        if (runFiles.size() == 0) {
+            sortItems();
+
+            ofstream out(outputFile.c_str(), ios_base::out | ios_base::binary | ios_base::trunc);
+            if (!out) { m->mothurOut("[ERROR]: Could not open " + outputFile + "\n"); m->setControl_pressed(true); return 0; }
+            for (size_t i = 0; i < items.size(); i++) { out.write(buffer.data() + items[i].offset + items[i].keyLength, items[i].recordLength); }
+            out.close();
+
+            buffer.clear(); items.clear();
+            return numRecords;
+        }
+
+        writeRun();
+        vector<char>().swap(buffer); vector<ExternalSortItem>().swap(items);
+
+        //merge groups of runs in parallel until there are few enough to merge at once
+        int round = 0;
+        while (runFiles.size() > EXTERNAL_SORT_MAX_RUNS) {
+            if (m->getControl_pressed()) { return 0; }
+
+            vector<string> mergedFiles;
+            vector<externalSortMergeData*> data;
+            for (int i = 0; i < runFiles.size(); i += EXTERNAL_SORT_MAX_RUNS) {
+                int last = min((int)runFiles.size(), i + EXTERNAL_SORT_MAX_RUNS);
+                vector<string> group(runFiles.begin() + i, runFiles.begin() + last);
+                string mergedFile = rootName + toString(round) + "." + toString(mergedFiles.size()) + ".sortmerge.temp";
+                mergedFiles.push_back(mergedFile);
+                data.push_back(new externalSortMergeData(group, mergedFile, false, compareRecords));
+            }
+
+            //the groups are merged processors at a time
+            for (int i = 0; i < data.size(); i += processors) {
+                int last = min((int)data.size(), i + processors);
+                vector<thread*> workerThreads;
+                for (int j = i + 1; j < last; j++) { workerThreads.push_back(new thread(driverExternalSortMerge, data[j])); }
+                driverExternalSortMerge(data[i]);
+                for (int j = 0; j < workerThreads.size(); j++) { workerThreads[j]->join(); delete workerThreads[j]; }
+            }
+            for (int i = 0; i < data.size(); i++) { delete data[i]; }
+
+            runFiles = mergedFiles;
+            round++;
+        }
+
+        externalSortMergeData* dataBundle = new externalSortMergeData(runFiles, outputFile, true, compareRecords);
+        driverExternalSortMerge(dataBundle);
+        delete dataBundle;
+        runFiles.clear();
+
+        return numRecords;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "ExternalSort", "output");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
@@ -0,0 +1,68 @@
+#ifndef EXTERNALSORT_HPP
+#define EXTERNALSORT_HPP
+
+//
+//  externalsort.hpp
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "mothurout.h"
+#include "utils.hpp"
+#include <queue>
+
+#define EXTERNAL_SORT_MAX_RUNS 64 //runs merged at once
+
+/**************************************************************************************************/
+//Sorts records that may not fit in memory. Records are added with a binary key and held until the memory budget is
+//used, then the processors sort them in parallel and the sorted run is written to a temporary file. The runs are merged
+//into the output, in rounds of EXTERNAL_SORT_MAX_RUNS if there are more, so the whole file is never in memory.
+//The budget, set with set.dir(sortmemory=), covers the capacity of the buffers, the copy made while one grows and the
+//space the sort works in, not just the records.
+//Keys are compared byte by byte; encodeKey makes keys whose bytes sort in numeric order. Records with equal keys are
+//ordered by their text without a final '\n', like sort orders equal lines, if compareRecords is set, else they keep the
+//order they were added in.
+
+struct ExternalSortItem {
+    unsigned long long prefix; //the first 8 bytes of the key as a big endian number, so most compares don't read the buffer
+    unsigned long long offset; //of the key in the buffer, the record follows it
+    unsigned int keyLength, recordLength;
+};
+
+class ExternalSort {
+
+public:
+    ExternalSort(string, int, unsigned long long, bool); //root name for the run files, processors, memory budget in bytes, compareRecords
+    ~ExternalSort(); //removes any run files left
+
+    void add(const string&, const char*, size_t); //key, record, record length
+    void add(const string& key, const string& record) { add(key, record.c_str(), record.length()); }
+    long long output(string); //writes the records in order to the file, returns the number of records
+
+    static string encodeKey(unsigned long long); //big endian
+    static string encodeKey(double); //flips the bits so negative numbers sort first
+
+private:
+    MothurOut* m;
+    Utils util;
+    string rootName;
+    int processors;
+    unsigned long long memory;
+    bool compareRecords;
+
+    vector<char> buffer; //keys and records added since the last run
+    vector<ExternalSortItem> items;
+    vector<string> runFiles;
+    long long numRecords;
+
+    bool makeRoom(size_t); //grows the buffers to hold a record of the size, false if that would go over the budget
+    unsigned long long getGrowth(unsigned long long, unsigned long long, unsigned long long); //bytes held, bytes needed, bytes held by the other buffer
+    void sortItems();
+    void writeRun();
+};
+
+/**************************************************************************************************/
+
+#endif
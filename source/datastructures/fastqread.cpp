@@ -173,6 +173,65 @@ FastqRead::FastqRead(ifstream& in, bool& ignore, string f) {
     }
 }
 //**********************************************************************************************************************
+FastqRead::FastqRead(SequenceReader& reader, bool& ignore, string f) {
+    try {
+        m = MothurOut::getInstance();
+        
+        ignore = false;
+        format = f;
+        
+        TextSpan header, seqLine, header2, qualLine;
+        if (!reader.readFastq(header, seqLine, header2, qualLine)) { ignore = true; }
+        else {
+            //only solexa scores are converted with the tables
+            if (format == "solexa") {
+                for (int i = -64; i < 65; i++) {
+                    char temp = (char) ((int)(33 + 10*log(1+pow(10,(i/10.0)))/log(10)+0.499));
+                    convertTable.push_back(temp);
+                    convertBackTable.push_back(((int)(33 + 10*log(1+pow(10,(i/10.0)))/log(10)+0.499)));
+                }
+            }
+            
+            //read sequence name
+            vector<string> pieces = util.splitWhiteSpace(header.toString());
+            name = "";  if (pieces.size() != 0) { name = pieces[0]; }
+            if (name == "") {  m->mothurOut("[WARNING]: Blank fasta name, ignoring read."); m->mothurOutEndLine(); ignore=true;  }
+            else if (name[0] != '@') { m->mothurOut("[WARNING]: reading " + name + " expected a name with @ as a leading character, ignoring read."); m->mothurOutEndLine(); ignore=true; }
+            else { name = name.substr(1); }
+            if (pieces.size() > 1) { pieces.erase(pieces.begin()); comment = util.getStringFromVector(pieces, " "); }
+            
+            //read sequence
+            sequence = seqLine.toString();
+            if (sequence == "") {  m->mothurOut("[WARNING]: missing sequence for " + name + ", ignoring."); ignore=true; }
+            
+            //read sequence name
+            pieces = util.splitWhiteSpace(header2.toString());
+            string name2 = "";  if (pieces.size() != 0) { name2 = pieces[0]; }
+            if (name2 == "") {  m->mothurOut("[WARNING]: expected a name with + as a leading character, ignoring."); ignore=true; }
+            else if (name2[0] != '+') { m->mothurOut("[WARNING]: reading " + name2 + " expected a name with + as a leading character, ignoring."); ignore=true; }
+            else { name2 = name2.substr(1); if (name2 == "") { name2 = name; } }
+            
+            //read quality scores
+            string quality = qualLine.toString();
+            if (quality == "") {  m->mothurOut("[WARNING]: missing quality for " + name2 + ", ignoring."); ignore=true; }
+            
+            //sanity check sequence length and number of quality scores match
+            if (name2 != "") { if (name != name2) { m->mothurOut("[WARNING]: names do not match. read " + name + " for fasta and " + name2 + " for quality, ignoring."); ignore=true; } }
+            if (quality.length() != sequence.length()) { m->mothurOut("[WARNING]: Lengths do not match for sequence " + name + ". Read " + toString(sequence.length()) + " characters for fasta and " + toString(quality.length()) + " characters for quality scores, ignoring read."); ignore=true; }
+            
+            scores = convertQual(quality);
+            scoreString = quality;
+            util.checkName(name);
+            
+            if (m->getDebug()) { m->mothurOut("[DEBUG]: " + name + " " + sequence + " " + quality + "\n"); }
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "FastqRead", "FastqRead");
+        exit(1);
+    }
+}
+//**********************************************************************************************************************
 #ifdef USE_BOOST
 FastqRead::FastqRead(boost::iostreams::filtering_istream& in, bool& ignore, string f) {
     try {
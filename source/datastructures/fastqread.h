@@ -41,6 +41,7 @@ public:
     #ifdef USE_BOOST
     FastqRead(boost::iostreams::filtering_istream&, bool&, string f);
     #endif
+    FastqRead(SequenceReader&, bool&, string f); //next record, ignore is set at the end of the file
     ~FastqRead() {}
     
     void setFormat(string f) { format = f; }
@@ -65,6 +65,63 @@ vector< map<int, int> > Kmer::getKmerCounts(string sequence){	//	Calculate kmer
 }
 	
 	
+/**************************************************************************************************/
+//	Returns the offset, position in seqA - position in seqB, of every kmer found exactly once in each sequence, sorted.
+//	A kmer that repeats can't say where the two sequences line up, so it is skipped.
+vector<int> Kmer::getSeedDiagonals(const string& seqA, const string& seqB){
+	
+	vector< pair<int, int> > kmersA, kmersB;	//	kmer number, position
+	getUniqueKmers(seqA, kmersA);
+	getUniqueKmers(seqB, kmersB);
+	
+	vector<int> diagonals;
+	int a = 0; int b = 0;
+	while((a < kmersA.size()) && (b < kmersB.size())){
+		if(kmersA[a].first < kmersB[b].first)		{	a++;	}
+		else if(kmersA[a].first > kmersB[b].first)	{	b++;	}
+		else{
+			diagonals.push_back(kmersA[a].second - kmersB[b].second);
+			a++; b++;
+		}
+	}
+	sort(diagonals.begin(), diagonals.end());
+	
+	return diagonals;
+}
+/**************************************************************************************************/
+//	fills kmers with the kmers that occur once in the sequence, sorted by kmer number. Kmers with a base other than
+//	A, C, G, T or U are skipped.
+void Kmer::getUniqueKmers(const string& sequence, vector< pair<int, int> >& kmers){
+	
+	kmers.clear();
+	int length = sequence.length();
+	int mask = maxKmer - 2;						//	4^kmerSize - 1
+	int kmer = 0;
+	int validBases = 0;							//	number of valid bases in a row ending at i
+	
+	for(int i=0;i<length;i++){
+		int base = 0;
+		char c = toupper(sequence[i]);
+		if(c == 'A')					{	base = 0;	}
+		else if(c == 'C')				{	base = 1;	}
+		else if(c == 'G')				{	base = 2;	}
+		else if((c == 'T') || (c == 'U'))	{	base = 3;	}
+		else							{	validBases = 0; kmer = 0; continue;	}
+		
+		kmer = ((kmer << 2) | base) & mask;
+		validBases++;
+		if(validBases >= kmerSize){	kmers.push_back(pair<int, int>(kmer, i-kmerSize+1));	}
+	}
+	
+	sort(kmers.begin(), kmers.end());
+	
+	int numUnique = 0;
+	for(int i=0;i<kmers.size();i++){
+		bool repeated = ((i > 0) && (kmers[i-1].first == kmers[i].first)) || ((i+1 < kmers.size()) && (kmers[i+1].first == kmers[i].first));
+		if(!repeated){	kmers[numUnique++] = kmers[i];	}
+	}
+	kmers.resize(numUnique);
+}
 /**************************************************************************************************/
 
 int Kmer::getKmerNumber(string sequence, int index){
@@ -24,8 +24,10 @@ public:
 	string getKmerBases(int);
 	int getReverseKmerNumber(int);
 	vector< map<int, int> > getKmerCounts(string sequence);  //for use in chimeraCheck
+	vector<int> getSeedDiagonals(const string&, const string&);  //for use in banded alignments
 	
 private:
+	void getUniqueKmers(const string&, vector< pair<int, int> >&);
 	char getASCII(int);
 	int getNumber(char);
 	int kmerSize;
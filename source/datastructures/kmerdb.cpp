@@ -157,17 +157,23 @@ void KmerDB::addSequence(Sequence seq) {
 		
 		string unaligned = seq.getUnaligned();	//	...take the unaligned sequence...
 		int numKmers = unaligned.length() - kmerSize + 1;
-			
-		vector<int> seenBefore(maxKmer+1,0);
+		
+		vector<int> kmerNumbers;
 		for(int j=0;j<numKmers;j++){						//	...step though the sequence and get each kmer...
-			int kmerNumber = kmer.getKmerNumber(unaligned, j);
-			if(seenBefore[kmerNumber] == 0){
-				kmerLocations[kmerNumber].push_back(count);		//	...insert the sequence index into kmerLocations for
-			}												//	the appropriate kmer number
-			seenBefore[kmerNumber] = 1;
-		}													
+			kmerNumbers.push_back(kmer.getKmerNumber(unaligned, j));
+		}
+		
+		//each kmer is only recorded once per sequence. Sorting the sequence's own kmers avoids clearing a table the size of
+		//maxKmer for every sequence, so adding one sequence to a large database stays cheap
+		sort(kmerNumbers.begin(), kmerNumbers.end());
+		kmerNumbers.erase(unique(kmerNumbers.begin(), kmerNumbers.end()), kmerNumbers.end());
+		
+		for(int j=0;j<kmerNumbers.size();j++){
+			kmerLocations[kmerNumbers[j]].push_back(count);	//	...insert the sequence index into kmerLocations for
+		}												//	the appropriate kmer number
 	
 		count++;
+		numSeqs = count; //the sequence can be searched right away, generateDB only writes the shortcut file
 	}
 	catch(exception& e) {
 		m->errorOut(e, "KmerDB", "addSequence");
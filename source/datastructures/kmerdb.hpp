@@ -30,7 +30,7 @@ public:
 	~KmerDB();
 	
 	void generateDB();
-	void addSequence(Sequence);
+	void addSequence(Sequence);  //appends to the in memory index, so the database can keep growing between searches
 	vector<int> findClosestSequences(Sequence*, int, vector<float>&);
 	void readKmerDB(ifstream&);
 	int getCount(int);  //returns number of sequences with that kmer number
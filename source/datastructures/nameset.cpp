@@ -0,0 +1,94 @@
+//
+//  nameset.cpp
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "nameset.hpp"
+
+/**************************************************************************************************/
+
+NameSet::NameSet(const set<string>& names) {
+    numNames = 0;
+    for (set<string>::const_iterator it = names.begin(); it != names.end(); it++) { insert(*it); }
+}
+/**************************************************************************************************/
+//FNV-1a
+unsigned int NameSet::hash(const char* name, size_t length) const {
+    unsigned int h = 2166136261u;
+    for (size_t i = 0; i < length; i++) { h ^= (unsigned char)name[i]; h *= 16777619u; }
+    return h;
+}
+/**************************************************************************************************/
+
+int NameSet::findSlot(const char* name, size_t length, unsigned int h) const {
+    size_t mask = slots.size() - 1;
+    size_t slot = h & mask;
+
+    while (slots[slot] != -1) {
+        int index = slots[slot];
+        if ((hashes[index] == h) && ((starts[index+1] - starts[index]) == length) && (memcmp(pool.data() + starts[index], name, length) == 0)) { break; }
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+/**************************************************************************************************/
+
+void NameSet::grow() {
+    size_t newSize = 16;
+    if (slots.size() != 0) { newSize = slots.size() * 2; }
+    slots.assign(newSize, -1);
+
+    size_t mask = newSize - 1;
+    for (int i = 0; i < numNames; i++) {
+        size_t slot = hashes[i] & mask;
+        while (slots[slot] != -1) { slot = (slot + 1) & mask; }
+        slots[slot] = i;
+    }
+}
+/**************************************************************************************************/
+
+bool NameSet::insert(const char* name, size_t length) {
+    //keep the table at most half full
+    if ((size_t)((numNames + 1) * 2) > slots.size()) { grow(); }
+
+    unsigned int h = hash(name, length);
+    int slot = findSlot(name, length, h);
+    if (slots[slot] != -1) { return false; }
+
+    if (starts.size() == 0) { starts.push_back(0); }
+    pool.insert(pool.end(), name, name + length);
+    starts.push_back(pool.size());
+    hashes.push_back(h);
+    slots[slot] = numNames;
+    numNames++;
+
+    return true;
+}
+/**************************************************************************************************/
+
+int NameSet::count(const char* name, size_t length) const {
+    if (numNames == 0) { return 0; }
+
+    int slot = findSlot(name, length, hash(name, length));
+    if (slots[slot] != -1) { return 1; }
+
+    return 0;
+}
+/**************************************************************************************************/
+
+void NameSet::clear() {
+    pool.clear(); starts.clear(); hashes.clear(); slots.clear();
+    numNames = 0;
+}
+/**************************************************************************************************/
+
+set<string> NameSet::getNames() const {
+    set<string> names;
+    for (int i = 0; i < numNames; i++) { names.insert(getName(i)); }
+    return names;
+}
+/**************************************************************************************************/
@@ -0,0 +1,51 @@
+#ifndef NAMESET_HPP
+#define NAMESET_HPP
+
+//
+//  nameset.hpp
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "mothur.h"
+
+/**************************************************************************************************/
+//The names chosen by an accnos file or a set of groups, for the get and remove commands. The names are copied once into
+//a shared pool and found with a hashed lookup, so checking a record is a hash and one compare instead of a search through
+//a set<string>, and a name can be checked straight from a reader's buffer without making a string.
+
+class NameSet {
+
+public:
+    NameSet() { numNames = 0; }
+    NameSet(const set<string>&);
+    ~NameSet() {}
+
+    bool insert(const string& name) { return insert(name.c_str(), name.length()); } //true if the name is new
+    bool insert(const char*, size_t);
+    int count(const string& name) const { return count(name.c_str(), name.length()); } //1 if the name is in the set, else 0
+    int count(const char*, size_t) const;
+
+    int size() const { return numNames; }
+    bool empty() const { return (numNames == 0); }
+    void clear();
+    string getName(int i) const { return string(pool.begin() + starts[i], pool.begin() + starts[i+1]); } //in the order they were added
+    set<string> getNames() const;
+
+private:
+    vector<char> pool; //the names, one after another
+    vector<unsigned long long> starts; //[numNames+1] offset of each name in the pool
+    vector<unsigned int> hashes; //[numNames]
+    vector<int> slots; //open addressed table of name indexes, -1 if empty. Its size is a power of 2
+    int numNames;
+
+    unsigned int hash(const char*, size_t) const;
+    int findSlot(const char*, size_t, unsigned int) const; //the slot holding the name, or the empty slot it belongs in
+    void grow();
+};
+
+/**************************************************************************************************/
+
+#endif
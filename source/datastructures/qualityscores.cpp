@@ -90,6 +90,46 @@ QualityScores::QualityScores(ifstream& qFile){
 	
 }
 /**************************************************************************************************/
+
+QualityScores::QualityScores(SequenceReader& reader){
+	try {
+		m = MothurOut::getInstance();
+		
+		TextSpan nameSpan, commentSpan, body;
+		if (!reader.readFasta(nameSpan, commentSpan, body)) { m->mothurOut("Error in reading your qfile, at position " + toString(reader.getPosition()) + ". Blank name."); m->mothurOutEndLine(); m->setControl_pressed(true); }
+		
+		seqName = nameSpan.toString();
+		util.checkName(seqName);
+		
+		if (!m->getControl_pressed()) {
+			size_t i = 0;
+			while (i < body.length) {
+				while ((i < body.length) && isspace((unsigned char)body.data[i])) { i++; }
+				if (i == body.length) { break; }
+				
+				size_t start = i;
+				bool isNumber = true;
+				int score = 0;
+				while ((i < body.length) && !isspace((unsigned char)body.data[i])) {
+					if ((body.data[i] > 47) && (body.data[i] < 58)) { score = (score * 10) + (body.data[i] - 48); }
+					else { isNumber = false; }
+					i++;
+				}
+				
+				if (!isNumber) { m->mothurOut("[ERROR]: In sequence " + seqName + "'s quality scores, expected a number and got " + string(body.data+start, i-start) + ", setting score to 0."); m->mothurOutEndLine(); score = 0; }
+				
+				qScores.push_back(score);
+			}
+		}
+		
+		seqLength = qScores.size();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "QualityScores", "QualityScores");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
 #ifdef USE_BOOST
 QualityScores::QualityScores(boost::iostreams::filtering_istream& qFile){
     try {
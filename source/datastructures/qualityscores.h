@@ -30,6 +30,7 @@ public:
     #ifdef USE_BOOST
     QualityScores(boost::iostreams::filtering_istream&);
     #endif
+    QualityScores(SequenceReader&); //next record
     int read(ifstream&);
 	string getName();
 	int getLength(){    return (int)qScores.size();  }
@@ -189,6 +189,72 @@ Sequence::Sequence(ifstream& fastaFile){
 	}							
 }
 //********************************************************************************************************************
+//this function will jump over commented out sequences
+Sequence::Sequence(SequenceReader& reader){
+	try {
+		m = MothurOut::getInstance();
+		initialize();
+		
+		TextSpan nameSpan, commentSpan, body;
+		bool found = false;
+		while (reader.readFasta(nameSpan, commentSpan, body)) {
+			if ((nameSpan.length != 0) && (nameSpan.data[0] == '#')) { continue; }
+			found = true; break;
+		}
+		
+		if (found) { setRecord(nameSpan, commentSpan, body); }
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Sequence", "Sequence");
+		exit(1);
+	}
+}
+//********************************************************************************************************************
+Sequence::Sequence(const TextSpan& nameSpan, const TextSpan& commentSpan, const TextSpan& body){
+	try {
+		m = MothurOut::getInstance();
+		initialize();
+		setRecord(nameSpan, commentSpan, body);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Sequence", "Sequence");
+		exit(1);
+	}
+}
+//********************************************************************************************************************
+void Sequence::setRecord(const TextSpan& nameSpan, const TextSpan& commentSpan, const TextSpan& body){
+	try {
+		name = nameSpan.toString();
+		util.checkName(name);
+		comment = commentSpan.toString();
+		
+		int numAmbig = 0;
+		string sequence; sequence.reserve(body.length);
+		for (size_t i = 0; i < body.length; i++) {
+			char letter = body.data[i];
+			if (letter == ' ') {;}
+			else if(isprint(letter)){
+				letter = toupper(letter);
+				if(letter == 'U'){letter = 'T';}
+				if(letter != '.' && letter != '-' && letter != 'A' && letter != 'T' && letter != 'G'  && letter != 'C' && letter != 'N'){
+					letter = 'N';
+					numAmbig++;
+				}
+				sequence += letter;
+			}
+		}
+		
+		//setAligned sets the unaligned sequence too
+		setAligned(sequence);
+		
+		if ((numAmbig / (float) numBases) > 0.25) { m->mothurOut("[WARNING]: We found more than 25% of the bases in sequence " + name + " to be ambiguous. Mothur is not setup to process protein sequences."); m->mothurOutEndLine(); }
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Sequence", "setRecord");
+		exit(1);
+	}
+}
+//********************************************************************************************************************
 //this function will jump over commented out sequences, but if the last sequence in a file is commented out it makes a blank seq
 #ifdef USE_BOOST
 Sequence::Sequence(boost::iostreams::filtering_istream& fastaFile){
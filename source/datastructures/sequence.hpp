@@ -21,6 +21,7 @@
 #include "mothurout.h"
 #include "utils.hpp"
 #include "writer.h"
+#include "sequencereader.hpp"
 
 /**************************************************************************************************/
 
@@ -43,6 +44,8 @@ public:
     #ifdef USE_BOOST
     Sequence(boost::iostreams::filtering_istream&);
     #endif
+    Sequence(SequenceReader&); //next record, a blank sequence at the end of the file
+    Sequence(const TextSpan&, const TextSpan&, const TextSpan&); //name, comment and body of a record from SequenceReader::readFasta
     ~Sequence() {}
 	
 	void setName(string);
@@ -92,6 +95,7 @@ private:
     string getSequenceName(boost::iostreams::filtering_istream&);
     #endif
     string getSequenceName(istringstream&);
+    void setRecord(const TextSpan&, const TextSpan&, const TextSpan&);
 	string name;
 	string unaligned;
 	string aligned;
@@ -11,6 +11,7 @@
 #include "sequence.hpp"
 #include "mothur.h"
 #include "calculator.h"
+#include "currentfile.h"
 
 
 /***********************************************************************/
@@ -31,7 +32,43 @@ SequenceDB::SequenceDB(int newSize) {
 
 SequenceDB::SequenceDB(ifstream& filehandle) {
 	try{
+		m = MothurOut::getInstance();
 		length = 0; samelength = true;
+		readFile(filehandle);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SequenceDB", "SequenceDB");
+		exit(1);
+	}
+}
+/***********************************************************************/
+//in pipeline mode the sequences are copied from memory if a previous command already read this file
+SequenceDB::SequenceDB(string fastafile) {
+	try{
+		m = MothurOut::getInstance();
+		length = 0; samelength = true;
+		
+		CurrentFile* current = CurrentFile::getInstance();
+		if (current->getPipelineSequenceDB(fastafile, *this)) { return; }
+		
+		Utils util;
+		ifstream in;
+		util.openInputFile(fastafile, in);
+		readFile(in);
+		
+		if (current->getPipelineMode()) {
+			SequenceDB* stored = new SequenceDB(); *stored = *this;
+			current->setPipelineSequenceDB(fastafile, stored);
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "SequenceDB", "SequenceDB");
+		exit(1);
+	}
+}
+/***********************************************************************/
+void SequenceDB::readFile(ifstream& filehandle) {
+	try{
         Utils util;
 		//read through file
 		while (!filehandle.eof()) {
@@ -52,7 +89,7 @@ SequenceDB::SequenceDB(ifstream& filehandle) {
 		
 	}
 	catch(exception& e) {
-		m->errorOut(e, "SequenceDB", "SequenceDB");
+		m->errorOut(e, "SequenceDB", "readFile");
 		exit(1);
 	}
 }
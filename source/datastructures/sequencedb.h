@@ -24,7 +24,9 @@ public:
 	SequenceDB();
 	SequenceDB(int);           //makes data that size
 	SequenceDB(ifstream&);	   //reads file to fill data
+	SequenceDB(string);	       //fasta filename, uses the pipeline copy if there is one
 	SequenceDB(const SequenceDB& sdb) : data(sdb.data) {};
+	SequenceDB& operator=(const SequenceDB& sdb) { data = sdb.data; m = sdb.m; samelength = sdb.samelength; length = sdb.length; return *this; }
 	~SequenceDB();             //loops through data and delete each sequence
 
 	int getNumSeqs();
@@ -37,6 +39,8 @@ private:
 	MothurOut* m;
 	bool samelength;
 	int length;
+	
+	void readFile(ifstream&);
 
 };
 
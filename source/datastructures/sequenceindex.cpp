@@ -0,0 +1,305 @@
+//
+//  sequenceindex.cpp
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "sequenceindex.hpp"
+
+/**************************************************************************************************/
+
+SequenceIndex::SequenceIndex(string f, char d, string outputDir) {
+    try {
+        m = MothurOut::getInstance();
+        filename = util.getFullPathName(f);
+        delim = d;
+        numRecords = 0; fileSize = 0; timeStamp = 0; checksum = 0;
+        saved = false;
+
+        //the index in the output directory is used first, then the one next to the file
+        string localIndex = filename + ".idx";
+        indexFileName = localIndex;
+        if (outputDir != "") { indexFileName = outputDir + util.getSimpleName(filename) + ".idx"; }
+
+        valid = load(indexFileName);
+        if (!valid && (indexFileName != localIndex)) {
+            if (load(localIndex)) { indexFileName = localIndex; valid = true; }
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SequenceIndex", "SequenceIndex");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+
+unsigned int SequenceIndex::hashName(const char* name, size_t length) {
+    unsigned int h = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        char c = name[i];
+        if (c == ':') { c = '_'; }
+        h ^= (unsigned char)c; h *= 16777619u;
+    }
+    return h;
+}
+/**************************************************************************************************/
+
+bool SequenceIndex::getFileInfo(unsigned long long& size, unsigned long long& stamp, unsigned long long& sum) {
+    try {
+        ifstream in(filename.c_str(), ios_base::in | ios_base::binary);
+        if (!in) { return false; }
+
+        in.seekg(0, ios_base::end);
+        size = in.tellg();
+
+        vector<char> buffer(SEQUENCE_INDEX_CHECK_SIZE);
+        unsigned long long numStart = min(size, (unsigned long long)SEQUENCE_INDEX_CHECK_SIZE);
+        unsigned long long endStart = size - numStart;
+
+        //hash the start and end of the file with 64 bit FNV-1a
+        sum = 14695981039346656037ull;
+        for (int part = 0; part < 2; part++) {
+            in.clear();
+            if (part == 0) { in.seekg(0); }
+            else { in.seekg(endStart); }
+            in.read(&buffer[0], numStart);
+            size_t numRead = in.gcount();
+
+            //compressed files can't be read from an offset
+            if ((part == 0) && (numRead >= 2) && ((unsigned char)buffer[0] == 0x1f) && ((unsigned char)buffer[1] == 0x8b)) { return false; }
+
+            for (size_t i = 0; i < numRead; i++) { sum ^= (unsigned char)buffer[i]; sum *= 1099511628211ull; }
+        }
+        in.close();
+
+        stamp = util.getTimeStamp(filename);
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SequenceIndex", "getFileInfo");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+
+bool SequenceIndex::load(string indexName) {
+    try {
+        ifstream in(indexName.c_str(), ios_base::in | ios_base::binary);
+        if (!in) { return false; }
+
+        unsigned long long size, stamp, sum;
+        if (!getFileInfo(size, stamp, sum)) { return false; }
+
+        char magic[8]; int version; char indexDelim;
+        in.read(magic, 8);
+        in.read((char*)&version, sizeof(int));
+        in.read(&indexDelim, 1);
+        in.read((char*)&fileSize, sizeof(unsigned long long));
+        in.read((char*)&timeStamp, sizeof(unsigned long long));
+        in.read((char*)&checksum, sizeof(unsigned long long));
+        in.read((char*)&numRecords, sizeof(long long));
+
+        if (!in || (memcmp(magic, "MOTHURIX", 8) != 0) || (version != SEQUENCE_INDEX_VERSION) || (indexDelim != delim)) { numRecords = 0; return false; }
+        if ((fileSize != size) || (timeStamp != stamp) || (checksum != sum) || (numRecords < 0)) {
+            if (m->getDebug()) { m->mothurOut("[DEBUG]: " + filename + " has changed, ignoring " + indexName + ".\n"); }
+            numRecords = 0; return false;
+        }
+
+        offsets.resize(numRecords+1); nameHashes.resize(numRecords); lengths.resize(numRecords);
+        in.read((char*)&offsets[0], (numRecords+1) * sizeof(unsigned long long));
+        if (numRecords != 0) {
+            in.read((char*)&nameHashes[0], numRecords * sizeof(unsigned int));
+            in.read((char*)&lengths[0], numRecords * sizeof(unsigned int));
+        }
+
+        if (!in) { numRecords = 0; offsets.clear(); nameHashes.clear(); lengths.clear(); return false; }
+        in.close();
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SequenceIndex", "load");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+
+bool SequenceIndex::save() {
+    try {
+        //only an old index is replaced, never a file that happens to have the same name
+        ifstream inTest(indexFileName.c_str(), ios_base::in | ios_base::binary);
+        if (inTest) {
+            char magic[8];
+            inTest.read(magic, 8);
+            if (!inTest || (memcmp(magic, "MOTHURIX", 8) != 0)) {
+                m->mothurOut("[WARNING]: " + indexFileName + " is not a mothur index file, not replacing it with the index of " + filename + ".\n"); return false;
+            }
+        }
+        inTest.close();
+
+        //the offsets are wrong if the file changed while it was scanned
+        unsigned long long size, stamp, sum;
+        if (!getFileInfo(size, stamp, sum) || (size != fileSize) || (stamp != timeStamp) || (sum != checksum)) { return false; }
+
+        //written to a temporary file and renamed, so a command reading the index never sees part of one
+        string tempName = indexFileName + "." + toString(std::hash<std::thread::id>()(std::this_thread::get_id())) + toString(std::chrono::steady_clock::now().time_since_epoch().count()) + ".temp";
+        ofstream out(tempName.c_str(), ios_base::out | ios_base::binary | ios_base::trunc);
+        if (!out) { if (m->getDebug()) { m->mothurOut("[DEBUG]: Unable to write " + tempName + ".\n"); } return false; }
+
+        int version = SEQUENCE_INDEX_VERSION;
+        out.write("MOTHURIX", 8);
+        out.write((char*)&version, sizeof(int));
+        out.write(&delim, 1);
+        out.write((char*)&fileSize, sizeof(unsigned long long));
+        out.write((char*)&timeStamp, sizeof(unsigned long long));
+        out.write((char*)&checksum, sizeof(unsigned long long));
+        out.write((char*)&numRecords, sizeof(long long));
+        out.write((char*)&offsets[0], (numRecords+1) * sizeof(unsigned long long));
+        if (numRecords != 0) {
+            out.write((char*)&nameHashes[0], numRecords * sizeof(unsigned int));
+            out.write((char*)&lengths[0], numRecords * sizeof(unsigned int));
+        }
+        out.close();
+
+        if (!out) { util.mothurRemove(tempName); return false; }
+
+#if defined NON_WINDOWS
+        int renameOk = rename(tempName.c_str(), indexFileName.c_str());
+#else
+        util.mothurRemove(indexFileName);
+        int renameOk = rename(tempName.c_str(), indexFileName.c_str());
+#endif
+        if (renameOk != 0) { util.mothurRemove(tempName); return false; }
+
+        m->mothurOut("Saved the index of " + filename + " to " + indexFileName + ".\n");
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SequenceIndex", "save");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+
+void SequenceIndex::addRecord(unsigned long long offset, unsigned int hash, unsigned int length) {
+    offsets.push_back(offset); nameHashes.push_back(hash); lengths.push_back(length);
+}
+/**************************************************************************************************/
+
+bool SequenceIndex::build() {
+    try {
+        valid = false; saved = false; numRecords = 0;
+        offsets.clear(); nameHashes.clear(); lengths.clear();
+
+        if (!getFileInfo(fileSize, timeStamp, checksum)) { return false; }
+
+        ifstream in(filename.c_str(), ios_base::in | ios_base::binary);
+        if (!in) { return false; }
+
+        //the name, header and body of a fasta record, or the line being read in a fastq or count file
+        enum { BEFORE, NAME, HEADER, BODY, LINESTART, LINE } state = BEFORE;
+        if (delim != '>') { state = LINESTART; }
+
+        unsigned int hash = 0, length = 0;
+        unsigned long long lineNumber = 0; //non blank lines in a fastq or count file
+        bool inName = false;
+
+        vector<char> buffer(SEQUENCE_READER_BLOCK_SIZE);
+        unsigned long long bufferOffset = 0;
+
+        while (in) {
+            if (m->getControl_pressed()) { return false; }
+
+            in.read(&buffer[0], buffer.size());
+            size_t numRead = in.gcount();
+            if (numRead == 0) { break; }
+
+            for (size_t i = 0; i < numRead; i++) {
+                char c = buffer[i];
+
+                if (delim == '>') {
+                    if (c == '>') {
+                        if (state != BEFORE) { lengths.back() = length; nameHashes.back() = hash; }
+                        addRecord(bufferOffset + i, 0, 0);
+                        hash = 2166136261u; length = 0; state = NAME;
+                    }else if (state == NAME) {
+                        if (isspace((unsigned char)c)) { state = ((c == '\n') || (c == '\r')) ? BODY : HEADER; }
+                        else { if (c == ':') { c = '_'; } hash ^= (unsigned char)c; hash *= 16777619u; }
+                    }else if (state == HEADER) {
+                        if ((c == '\n') || (c == '\r')) { state = BODY; }
+                    }else if (state == BODY) {
+                        if (!isspace((unsigned char)c)) { length++; }
+                    }
+                }else { //fastq and count files are read by line, blank lines are skipped
+                    if (state == LINESTART) {
+                        if (isspace((unsigned char)c)) { continue; }
+
+                        state = LINE; length = 0;
+                        long long recordLine = lineNumber;
+                        if (delim == '@') { recordLine = lineNumber % 4; }
+                        else if (lineNumber == 0) { recordLine = -1; } //count file headers
+
+                        if ((delim == '@') && (recordLine == 0)) {
+                            addRecord(bufferOffset + i, 0, 0);
+                            hash = 2166136261u; inName = true;
+                            continue; //the '@'
+                        }else if ((delim != '@') && (recordLine != -1)) {
+                            addRecord(bufferOffset + i, 0, 0);
+                            hash = 2166136261u; inName = true;
+                        }else { inName = false; }
+                    }
+
+                    if ((c == '\n') || (c == '\r') || (c == '\f')) {
+                        if ((delim != '@') && (lineNumber != 0)) { lengths.back() = length; }
+                        else if ((delim == '@') && ((lineNumber % 4) == 1)) { lengths.back() = length; }
+                        if (inName) { nameHashes.back() = hash; inName = false; }
+                        lineNumber++; state = LINESTART;
+                        continue;
+                    }
+
+                    length++;
+                    if (inName) {
+                        if (isspace((unsigned char)c)) { nameHashes.back() = hash; inName = false; }
+                        else { if (c == ':') { c = '_'; } hash ^= (unsigned char)c; hash *= 16777619u; }
+                    }
+                }
+            }
+
+            bufferOffset += numRead;
+        }
+        in.close();
+
+        //the last record runs to the end of the file
+        if (offsets.size() != 0) {
+            if (delim == '>') { if (state != BEFORE) { lengths.back() = length; nameHashes.back() = hash; } }
+            else if (state == LINE) {
+                if ((delim != '@') || ((lineNumber % 4) == 1)) { lengths.back() = length; }
+                if (inName) { nameHashes.back() = hash; }
+            }
+        }
+
+        numRecords = nameHashes.size();
+        offsets.push_back(fileSize);
+
+        valid = true;
+        saved = save();
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SequenceIndex", "build");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+
+vector<unsigned long long> SequenceIndex::getPositions() {
+    vector<unsigned long long> positions = offsets;
+    positions[0] = 0;
+    return positions;
+}
+/**************************************************************************************************/
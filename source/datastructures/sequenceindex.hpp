@@ -0,0 +1,71 @@
+#ifndef SEQUENCEINDEX_HPP
+#define SEQUENCEINDEX_HPP
+
+//
+//  sequenceindex.hpp
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "mothurout.h"
+#include "utils.hpp"
+#include "sequencereader.hpp"
+#include <unordered_set>
+
+#define SEQUENCE_INDEX_VERSION 1
+#define SEQUENCE_INDEX_CHECK_SIZE 65536 //bytes from the start and end of the file hashed to check the index is current
+
+/**************************************************************************************************/
+//The record offsets of a fasta, qual, fastq or count file, saved as filename.idx so the file only has to be scanned once.
+//Commands use the offsets to split a file between processors and to seek to the records they want by name.
+//The index keeps the size, modification time and a checksum of the file, and is ignored if any of them change.
+//An existing index is always used, but new ones are only saved after set.dir(index=T), in the output directory if
+//there is one and next to the file if not.
+//
+//Each record has its offset, the hash of its name and its length: the number of sequence characters in a fasta, qual or
+//fastq record, or the length of the line in a count file. Fasta and qual records start at every '>' like setFilePosFasta,
+//fastq records are four lines like SequenceReader::readFastq, and count file records are the lines after the headers.
+
+class SequenceIndex {
+
+public:
+    SequenceIndex(string, char, string); //filename, '>' for fasta and qual files, '@' for fastq and '\n' for count files, output directory. Loads the index if it is current
+    ~SequenceIndex() {}
+
+    bool isValid() { return valid; }
+    bool build(); //scans the file and saves the index. False if the file is missing or compressed
+    bool isSaved() { return saved; } //true if build wrote the index file
+
+    long long getNumRecords() { return numRecords; }
+    unsigned long long getOffset(long long i) { return offsets[i]; } //getOffset(numRecords) is the file size
+    unsigned int getNameHash(long long i) { return nameHashes[i]; }
+    unsigned int getLength(long long i) { return lengths[i]; }
+    vector<unsigned long long> getPositions(); //record offsets then the file size, the first offset set to 0 like setFilePosFasta
+    string getIndexFileName() { return indexFileName; }
+
+    //FNV-1a of the name with ':' read as '_', so names changed by Utils::checkName hash the same
+    static unsigned int hashName(const char*, size_t);
+    static unsigned int hashName(const string& name) { return hashName(name.c_str(), name.length()); }
+
+private:
+    MothurOut* m;
+    Utils util;
+    string filename, indexFileName;
+    char delim;
+    bool valid, saved;
+    unsigned long long fileSize, timeStamp, checksum;
+    long long numRecords;
+    vector<unsigned long long> offsets; //[numRecords+1]
+    vector<unsigned int> nameHashes, lengths; //[numRecords]
+
+    bool getFileInfo(unsigned long long&, unsigned long long&, unsigned long long&); //size, time stamp, checksum. False if the file can't be indexed
+    bool load(string); //index file name
+    bool save();
+    void addRecord(unsigned long long, unsigned int, unsigned int); //offset, name hash, length
+};
+
+/**************************************************************************************************/
+
+#endif
@@ -0,0 +1,245 @@
+//
+//  sequencereader.cpp
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "sequencereader.hpp"
+
+/**************************************************************************************************/
+
+SequenceReader::SequenceReader(string f) {
+    try {
+        m = MothurOut::getInstance();
+        openFile(f, 0);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SequenceReader", "SequenceReader");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+
+SequenceReader::SequenceReader(string f, unsigned long long start) {
+    try {
+        m = MothurOut::getInstance();
+        openFile(f, start);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SequenceReader", "SequenceReader");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+
+SequenceReader::~SequenceReader() {
+    try {
+#ifdef USE_BOOST
+        if (gz) { gzIn.pop(); }
+#endif
+        if (in.is_open()) { in.close(); }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SequenceReader", "~SequenceReader");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+
+void SequenceReader::openFile(string f, unsigned long long start) {
+    try {
+        filename = util.getFullPathName(f);
+        open = false; gz = false; atEnd = true;
+        cursor = 0; bufferEnd = 0; bufferOffset = 0;
+
+        in.open(filename.c_str(), ios_base::in | ios_base::binary);
+        if (!in) { m->mothurOut("[ERROR]: Could not open " + filename + "\n"); return; }
+
+        open = true; atEnd = false;
+        buffer.resize(SEQUENCE_READER_BLOCK_SIZE);
+
+        //gzip files start with 0x1f 0x8b
+        unsigned char magic[2] = { 0, 0 };
+        in.read((char*)magic, 2);
+        gz = ((in.gcount() == 2) && (magic[0] == 0x1f) && (magic[1] == 0x8b));
+        in.clear();
+        in.seekg(0);
+
+        if (gz) {
+#ifdef USE_BOOST
+            gzIn.push(boost::iostreams::gzip_decompressor());
+            gzIn.push(in);
+            if (start != 0) { m->mothurOut("[ERROR]: " + filename + " is compressed, it can only be read from the start.\n"); m->setControl_pressed(true); }
+#else
+            m->mothurOut("[ERROR]: " + filename + " is compressed. Reading .gz files requires mothur to be built with boost.\n"); m->setControl_pressed(true);
+            atEnd = true;
+#endif
+        }else if (start != 0) {
+            in.seekg(start);
+            bufferOffset = start;
+        }
+
+        //zap leading nulls
+        while (available(0) && (buffer[cursor] == '\0')) { cursor++; }
+        skipWhiteSpace();
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SequenceReader", "openFile");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+
+bool SequenceReader::refill() {
+    try {
+        if (atEnd) { return false; }
+
+        if (cursor != 0) {
+            size_t numUnread = bufferEnd - cursor;
+            if (numUnread != 0) { memmove(&buffer[0], &buffer[cursor], numUnread); }
+            bufferOffset += cursor;
+            bufferEnd = numUnread;
+            cursor = 0;
+        }
+
+        //the record doesn't fit in the buffer
+        if (bufferEnd == buffer.size()) { buffer.resize(buffer.size() * 2); }
+
+        size_t numRead = 0;
+        if (gz) {
+#ifdef USE_BOOST
+            try {
+                gzIn.read(&buffer[bufferEnd], buffer.size() - bufferEnd);
+                numRead = gzIn.gcount();
+            }
+            catch (boost::iostreams::gzip_error& e) {
+                m->mothurOut("[ERROR]: " + filename + " is not a valid gzip file.\n"); m->setControl_pressed(true);
+            }
+#endif
+        }else {
+            in.read(&buffer[bufferEnd], buffer.size() - bufferEnd);
+            numRead = in.gcount();
+        }
+
+        if (numRead == 0) { atEnd = true; return false; }
+
+        bufferEnd += numRead;
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SequenceReader", "refill");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+
+void SequenceReader::seek(unsigned long long offset) {
+    try {
+        if (!open) { return; }
+        if (gz) { m->mothurOut("[ERROR]: " + filename + " is compressed, it can only be read from the start.\n"); m->setControl_pressed(true); return; }
+
+        //the offset may already be in the buffer
+        if ((offset >= bufferOffset) && (offset <= (bufferOffset + bufferEnd))) { cursor = offset - bufferOffset; return; }
+
+        in.clear();
+        in.seekg(offset);
+        bufferOffset = offset; cursor = 0; bufferEnd = 0;
+        atEnd = false;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SequenceReader", "seek");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+
+bool SequenceReader::fill(size_t offset) {
+    while ((cursor + offset) >= bufferEnd) {
+        if (!refill()) { return false; }
+    }
+    return true;
+}
+/**************************************************************************************************/
+
+void SequenceReader::skipWhiteSpace() {
+    while (available(0) && isspace((unsigned char)buffer[cursor])) { cursor++; }
+}
+/**************************************************************************************************/
+
+bool SequenceReader::eof() {
+    skipWhiteSpace();
+    return !available(0);
+}
+/**************************************************************************************************/
+//parses like Sequence(ifstream&): the name is the first word of the header, the comment the rest of the header line and the
+//body runs to the next '>'
+bool SequenceReader::readFasta(TextSpan& name, TextSpan& comment, TextSpan& body) {
+    try {
+        name = TextSpan(); comment = TextSpan(); body = TextSpan();
+
+        skipWhiteSpace();
+        if (!available(0)) { return false; }
+
+        //offsets from the cursor, they stay valid when the buffer is refilled
+        size_t i = 1;
+        while (available(i) && !isspace((unsigned char)buffer[cursor+i])) { i++; }
+        size_t nameEnd = i;
+
+        while (available(i) && (buffer[cursor+i] != '\r') && (buffer[cursor+i] != '\n')) { i++; }
+        size_t commentEnd = i;
+
+        while (available(i) && isspace((unsigned char)buffer[cursor+i])) { i++; }
+        size_t bodyStart = i;
+
+        while (available(i) && (buffer[cursor+i] != '>')) { i++; }
+        size_t bodyEnd = i;
+
+        const char* record = &buffer[cursor];
+        name.data = record + 1;                 name.length = nameEnd - 1;
+        comment.data = record + nameEnd;        comment.length = commentEnd - nameEnd;
+        body.data = record + bodyStart;         body.length = bodyEnd - bodyStart;
+
+        cursor += bodyEnd;
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SequenceReader", "readFasta");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+//four lines, each followed by any whitespace, like FastqRead(ifstream&). Lines end at '\n', '\r' or '\f' like Utils::getline
+bool SequenceReader::readFastq(TextSpan& header, TextSpan& sequence, TextSpan& header2, TextSpan& quality) {
+    try {
+        skipWhiteSpace();
+        if (!available(0)) { header = TextSpan(); sequence = TextSpan(); header2 = TextSpan(); quality = TextSpan(); return false; }
+
+        size_t starts[4], ends[4];
+        size_t i = 0;
+        for (int l = 0; l < 4; l++) {
+            starts[l] = i;
+            while (available(i) && (buffer[cursor+i] != '\n') && (buffer[cursor+i] != '\r') && (buffer[cursor+i] != '\f')) { i++; }
+            ends[l] = i;
+            while (available(i) && isspace((unsigned char)buffer[cursor+i])) { i++; }
+        }
+
+        TextSpan* lines[4] = { &header, &sequence, &header2, &quality };
+        for (int l = 0; l < 4; l++) {
+            lines[l]->data = &buffer[cursor] + starts[l];
+            lines[l]->length = ends[l] - starts[l];
+        }
+
+        cursor += i;
+
+        return true;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SequenceReader", "readFastq");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
@@ -0,0 +1,77 @@
+#ifndef SEQUENCEREADER_HPP
+#define SEQUENCEREADER_HPP
+
+//
+//  sequencereader.hpp
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "mothurout.h"
+#include "utils.hpp"
+
+#define SEQUENCE_READER_BLOCK_SIZE 1048576 //bytes read from the file at a time
+
+/**************************************************************************************************/
+//characters in the reader's buffer, valid until the next record is read
+struct TextSpan {
+    const char* data;
+    size_t length;
+
+    TextSpan() : data(NULL), length(0) {}
+    string toString() const { if (length == 0) { return ""; } return string(data, length); }
+};
+
+/**************************************************************************************************/
+//Reads fasta, quality and fastq files a block at a time and parses each record in place, so the records are returned
+//as spans of the buffer instead of being copied a character at a time. The buffer is reused, and only grows if a record
+//is larger than the block. Compressed .gz files are decompressed as they are read when mothur is built with boost.
+//Sequence, QualityScores and FastqRead have constructors that read the next record from a reader.
+
+class SequenceReader {
+
+public:
+    SequenceReader(string); //filename, read from the start
+    SequenceReader(string, unsigned long long); //filename, byte offset to start from. Offsets only apply to plain text files
+    ~SequenceReader();
+
+    //'>' or '#' record, the name without its marker, the rest of the header line and the body up to the next '>' with its line
+    //breaks. Returns false at the end of the file
+    bool readFasta(TextSpan&, TextSpan&, TextSpan&);
+    bool readFastq(TextSpan&, TextSpan&, TextSpan&, TextSpan&); //the header, sequence, '+' and quality lines. Returns false at the end of the file
+
+    unsigned long long getPosition() { return bufferOffset + cursor; } //offset of the next record, in the decompressed file if gzipped
+    void seek(unsigned long long); //moves to a record offset, such as one from a SequenceIndex. Only plain text files can seek
+    bool eof(); //true if there is nothing but whitespace left
+    bool isOpen() { return open; }
+    bool isGZ() { return gz; }
+    string getFileName() { return filename; }
+
+private:
+    MothurOut* m;
+    Utils util;
+    string filename;
+    bool open, gz, atEnd;
+
+    ifstream in;
+#ifdef USE_BOOST
+    boost::iostreams::filtering_istream gzIn;
+#endif
+
+    vector<char> buffer;
+    size_t cursor, bufferEnd; //start of the unread data and end of the valid data in the buffer
+    unsigned long long bufferOffset; //file offset of buffer[0]
+
+    void openFile(string, unsigned long long);
+    bool refill(); //keeps the unread data and reads the next block, false if there was nothing left to read
+    //true if the character offset characters past the cursor is in the buffer, reading more of the file if needed
+    inline bool available(size_t offset) { return ((cursor + offset) < bufferEnd) || fill(offset); }
+    bool fill(size_t);
+    void skipWhiteSpace();
+};
+
+/**************************************************************************************************/
+
+#endif
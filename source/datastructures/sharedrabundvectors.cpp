@@ -547,11 +547,11 @@ RAbundVector SharedRAbundVectors::getRAbundVector(string group){
         RAbundVector rav;
         rav.setLabel(label);
         
-        for (vector<SharedRAbundVector*>::iterator it = lookup.begin(); it != lookup.end();) {
-            //if this sharedrabund is not from a group the user wants then delete it.
+        for (vector<SharedRAbundVector*>::iterator it = lookup.begin(); it != lookup.end(); it++) {
             if ((*it)->getGroup() == group) {
                 for (int i = 0; i < (*it)->getNumBins(); i++) { rav.push_back((*it)->get(i)); }
-            }else { ++it; }
+                break;
+            }
         }
         
         return rav;
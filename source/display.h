@@ -11,12 +11,16 @@ class Display {
 public:
 	virtual void update(SAbundVector* rank) = 0;
 	virtual void update(vector<SharedRAbundVector*> shared, int numSeqs, int numGroupComb, vector<string>) = 0;
+	virtual void update(SharedPairStats&, vector<SharedRAbundVector*>, int, int, vector<string>) {} //for calcs with pair stats, the pair's stats and vectors
+	virtual bool hasPairStats() { return false; }
 	virtual void init(string) = 0;
 	virtual void reset() = 0;
 	virtual void close() = 0;
     virtual bool isCalcMultiple() = 0;
 	virtual void outputTempFiles(string) {}
 	virtual void inputTempFiles(string) {}
+	virtual void updateExact(int, vector<double>) {} //values computed without sampling, the estimate, lci and hci
+	virtual void mergeResults(Display*) {} //adds the results of another thread's display of the same calculator
 	virtual void setAll(bool){}
 	virtual bool hasLciHci(){ return false; }
 	virtual bool getAll()	{	bool a; return a;	}
@@ -97,6 +97,7 @@ bool InteractEngine::getInput(){
                 
                 Command* command = cFactory->getCommand(commandName, options);
                 quitCommandCalled = command->execute();
+                current->trimPipelineCache(); //only keep the current files in memory
                 
                 //if we aborted command
                 if (quitCommandCalled == 2) {  mout->mothurOut("[ERROR]: did not complete " + commandName + ".\n");  }
@@ -237,6 +238,7 @@ bool BatchEngine::getInput(){
 							
 					Command* command = cFactory->getCommand(commandName, options);
 					quitCommandCalled = command->execute();
+					current->trimPipelineCache(); //only keep the current files in memory
 							
 					//if we aborted command
 					if (quitCommandCalled == 2) {  mout->mothurOut("[ERROR]: did not complete " + commandName + ".\n");  }
@@ -353,6 +355,7 @@ bool ScriptEngine::getInput(){
                
                 Command* command = cFactory->getCommand(commandName, options);
                 quitCommandCalled = command->execute();
+                current->trimPipelineCache(); //only keep the current files in memory
                 
                 //if we aborted command
                 if (quitCommandCalled == 2) {  mout->mothurOut("[ERROR]: did not complete " + commandName + ".\n");  }
@@ -18,7 +18,6 @@
  */
 
 
-#include "alignmentcell.hpp"
 #include "overlap.hpp"
 #include "alignment.hpp"
 #include "gotohoverlap.hpp"
@@ -30,17 +29,12 @@ GotohOverlap::GotohOverlap(float gO, float gE, float f, float mm, int r) :
 	
 	try {
 		for(int i=1;i<nCols;i++){				//	we initialize the dynamic programming matrix by setting the pointers in
-			alignment[0][i].prevCell = 'l';		//	the first row to the left
-			alignment[0][i].cValue = 0;
-			alignment[0][i].dValue = 0;
+			firstRow[i] = 'l';					//	the first row to the left
 		}
 		
 		for(int i=1;i<nRows;i++){				//	we initialize the dynamic programming matrix by setting the pointers in
-			alignment[i][0].prevCell = 'u';		//	the first column upward
-			alignment[i][0].cValue = 0;
-			alignment[i][0].iValue = 0;
+			firstColumn[i] = 'u';				//	the first column upward
 		}
-		
 	}
 	catch(exception& e) {
 		m->errorOut(e, "GotohOverlap", "GotohOverlap");
@@ -49,49 +43,75 @@ GotohOverlap::GotohOverlap(float gO, float gE, float f, float mm, int r) :
 }
 
 /**************************************************************************************************/
-
+//	the recursion here is shown in Webb and Miller, Fig. 1A. Only the previous row of scores is kept, the pointers are
+//	stored 2 bits per cell. The edges of the matrix score zero.
 void GotohOverlap::align(string A, string B){
 	try {
 		seqA = ' ' + A;	lA = seqA.length();		//	the algorithm requires that the first character be a dummy value
 		seqB = ' ' + B;	lB = seqB.length();		//	the algorithm requires that the first character be a dummy value
 		
-		for(int i=1;i<lB;i++){					//	the recursion here is shown in Webb and Miller, Fig. 1A.  Note that 
-			for(int j=1;j<lA;j++){				//	if we need to conserve on space we should see Fig. 1B, which is linear
-				//	in space, which I think is unnecessary
-				float diagonal;
-				if(seqB[i] == seqA[j])	{	diagonal = alignment[i-1][j-1].cValue + match;		}
-				else					{	diagonal = alignment[i-1][j-1].cValue + mismatch;	}
-				
-				alignment[i][j].iValue = max(alignment[i][j-1].iValue, alignment[i][j-1].cValue + gapOpen) + gapExtend;
-				alignment[i][j].dValue = max(alignment[i-1][j].dValue, alignment[i-1][j].cValue + gapOpen) + gapExtend;
+		resetTraceMatrix();
+		prevCValues.assign(lA, 0); prevDValues.assign(lA, 0);
+		cValues.assign(lA, 0); dValues.assign(lA, 0);
+		diagonals.resize(lA);
+		lastColumnScores.assign(lB, 0);
+		
+		const char* a = seqA.c_str();
+		
+		for(int i=1;i<lB;i++){
+			
+			const char base = seqB[i];
+			const float* prevC = &prevCValues[0];
+			const float* prevD = &prevDValues[0];
+			float* diag = &diagonals[0];
+			float* d = &dValues[0];
+			
+			int first, last;
+			getBandColumns(i, first, last);		//	the whole row unless a band was set
+			
+			for(int j=first;j<=last;j++){		//	the diagonal and up scores only depend on the previous row
+				diag[j] = prevC[j-1] + ((base == a[j]) ? match : mismatch);
+				d[j] = max(prevD[j], prevC[j] + gapOpen) + gapExtend;
+			}
+			
+			float* c = &cValues[0];
+			unsigned char* traceRow = getTraceRow(i);
+			float leftC = 0; float leftI = 0;
+			if (first > 1) { leftC = BAND_EDGE_SCORE; leftI = BAND_EDGE_SCORE; }
+			
+			for(int j=first;j<=last;j++){
+				float iValue = max(leftI, leftC + gapOpen) + gapExtend;
+				float dValue = d[j];
+				float diagonal = diag[j];
+				unsigned char code;
 				
-				if(alignment[i][j].iValue > alignment[i][j].dValue){
-					if(alignment[i][j].iValue > diagonal){
-						alignment[i][j].cValue = alignment[i][j].iValue;
-						alignment[i][j].prevCell = 'l';
-					}
-					else{
-						alignment[i][j].cValue = diagonal;
-						alignment[i][j].prevCell = 'd';
-					}
+				if(iValue > dValue){
+					if(iValue > diagonal){	leftC = iValue;		code = TRACE_LEFT;		}
+					else{					leftC = diagonal;	code = TRACE_DIAGONAL;	}
 				}
 				else{
-					if(alignment[i][j].dValue > diagonal){
-						alignment[i][j].cValue = alignment[i][j].dValue;
-						alignment[i][j].prevCell = 'u';
-					}
-					else{
-						alignment[i][j].cValue = diagonal;
-						alignment[i][j].prevCell = 'd';
-					}
+					if(dValue > diagonal){	leftC = dValue;		code = TRACE_UP;		}
+					else{					leftC = diagonal;	code = TRACE_DIAGONAL;	}
 				}
 				
+				c[j] = leftC; leftI = iValue;
+				traceRow[(j-1) >> 2] |= (code << (((j-1) & 3) << 1));
+			}
+			
+			if (banded) {						//	the next row reads one cell past the end of this row's band
+				if ((last+1 >= 1) && (last+1 < lA)) { c[last+1] = BAND_EDGE_SCORE; d[last+1] = BAND_EDGE_SCORE; }
+				if ((lA > 1) && ((last != lA-1) || (first > last))) { c[lA-1] = BAND_EDGE_SCORE; }
 			}
+			
+			lastColumnScores[i] = c[lA-1];
+			prevCValues.swap(cValues); prevDValues.swap(dValues);
 		}
-		Overlap over;
-		over.setOverlap(alignment, lA, lB, 0);	//	Fix the gaps at the ends of the sequences
-		traceBack();							//	Construct the alignment and set seqAaln and seqBaln
 		
+		if (banded) { setBandedLastRow(prevCValues); }
+		else { lastRowScores = prevCValues; }	//	the bottom row, all zero if seqB is empty
+		
+		fixOverlap();							//	Fix the gaps at the ends of the sequences
+		traceBack();							//	Construct the alignment and set seqAaln and seqBaln
 	}
 	catch(exception& e) {
 		m->errorOut(e, "GotohOverlap", "align");
@@ -38,6 +38,7 @@ private:
 	float gapExtend;
 	float match;
 	float mismatch;
+	vector<float> cValues, dValues, prevCValues, prevDValues, diagonals; //one row of the scoring matrix, reused between alignments
 };
 
 /**************************************************************************************************/
@@ -12,6 +12,7 @@
 #include "listvector.hpp"
 #include "rabundvector.hpp"
 #include "sharedrabundvectors.hpp"
+#include "currentfile.h"
 
 /***********************************************************************/
 
@@ -22,6 +23,7 @@ InputData::InputData(string fName, string f, vector<string> userGroups) : format
 	nextDistanceLabel = "";
     groups = userGroups;
     otuTag = util.getTag(fName);
+    pipelineChecked = false; usePipeline = false; pipelineIndex = 0;
 }
 /***********************************************************************/
 
@@ -52,6 +54,7 @@ InputData::InputData(string fName, string orderFileName, string f) : format(f){
 		util.openInputFile(fName, fileHandle);
 		nextDistanceLabel = "";
         otuTag = util.getTag(fName);
+        pipelineChecked = false; usePipeline = false; pipelineIndex = 0;
 		
 	}
 	catch(exception& e) {
@@ -60,9 +63,77 @@ InputData::InputData(string fName, string orderFileName, string f) : format(f){
 	}
 }
 /***********************************************************************/
+//in pipeline mode list and shared files are parsed once and kept by CurrentFile, so the next InputData for the same file reads from memory.
+//shared files are only kept when all groups are used, because the group selection is applied while parsing.
+bool InputData::usingPipeline(){
+	try {
+        if (pipelineChecked) { return usePipeline; }
+        pipelineChecked = true;
+        
+        CurrentFile* current = CurrentFile::getInstance();
+        if (!current->getPipelineMode()) { return false; }
+        
+        if (format == "list") {
+            if (!current->hasPipelineListVectors(filename)) {
+                vector<ListVector*> lists;
+                ListVector* thisList = getListVector();
+                while (thisList != NULL) {
+                    if (m->getControl_pressed()) { delete thisList; break; }
+                    lists.push_back(thisList);
+                    thisList = getListVector();
+                }
+                
+                if (m->getControl_pressed()) { for (int i = 0; i < lists.size(); i++) { delete lists[i]; } lists.clear(); }
+                else { current->setPipelineListVectors(filename, lists); }
+                
+                if (!current->hasPipelineListVectors(filename)) { //start over from the file
+                    fileHandle.clear(); fileHandle.seekg(0); nextDistanceLabel = "";
+                    return false;
+                }
+            }
+            usePipeline = true;
+        }else if ((format == "sharedfile") && (groups.size() == 0)) {
+            if (!current->hasPipelineSharedRAbundVectors(filename)) {
+                vector<SharedRAbundVectors*> lookups;
+                SharedRAbundVectors* thisLookup = getSharedRAbundVectors();
+                while (thisLookup != NULL) {
+                    if (m->getControl_pressed()) { delete thisLookup; break; }
+                    lookups.push_back(thisLookup);
+                    thisLookup = getSharedRAbundVectors();
+                }
+                
+                if (m->getControl_pressed()) { for (int i = 0; i < lookups.size(); i++) { delete lookups[i]; } lookups.clear(); }
+                else { current->setPipelineSharedRAbundVectors(filename, lookups); }
+                
+                if (!current->hasPipelineSharedRAbundVectors(filename)) {
+                    fileHandle.clear(); fileHandle.seekg(0); nextDistanceLabel = ""; groups.clear();
+                    return false;
+                }
+            }
+            usePipeline = true;
+        }
+        
+        return usePipeline;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "InputData", "usingPipeline");
+		exit(1);
+	}
+}
+/***********************************************************************/
 
 ListVector* InputData::getListVector(){
 	try {
+        if (usingPipeline()) {
+            list = CurrentFile::getInstance()->getPipelineListVector(filename, pipelineIndex);
+            if (list != NULL) {
+                pipelineIndex++;
+                if (currentLabels.size() == 0) { currentLabels = list->getLabels(); }
+                else { list->setLabels(currentLabels);  }
+            }
+            return list;
+        }
+        
 		if(!fileHandle.eof()){
 			if(format == "list") {
 				list = new ListVector(fileHandle, nextDistanceLabel, otuTag);
@@ -89,6 +160,17 @@ ListVector* InputData::getListVector(){
 /***********************************************************************/
 ListVector* InputData::getListVector(string label){
 	try {
+        if (usingPipeline()) {
+            CurrentFile* current = CurrentFile::getInstance();
+            list = current->getPipelineListVector(filename, current->getPipelineListIndex(filename, label));
+            if (list != NULL) {
+                nextDistanceLabel = list->getLabel();
+                if (currentLabels.size() == 0) { currentLabels = list->getLabels(); }
+                else { list->setLabels(currentLabels);  }
+            }
+            return list;
+        }
+        
 		ifstream in;
 		util.openInputFile(filename, in);
         nextDistanceLabel = "";
@@ -131,6 +213,19 @@ ListVector* InputData::getListVector(string label){
 /***********************************************************************/
 ListVector* InputData::getListVector(string label, bool resetFP){
 	try {
+        if (usingPipeline()) { //next call to getListVector() returns the label after this one
+            CurrentFile* current = CurrentFile::getInstance();
+            int index = current->getPipelineListIndex(filename, label);
+            list = current->getPipelineListVector(filename, index);
+            if (list != NULL) {
+                pipelineIndex = index+1;
+                nextDistanceLabel = list->getLabel();
+                if (currentLabels.size() == 0) { currentLabels = list->getLabels(); }
+                else { list->setLabels(currentLabels);  }
+            }else { pipelineIndex = INT_MAX; }
+            return list;
+        }
+        
 		fileHandle.clear();
 		fileHandle.seekg(0);
         nextDistanceLabel = "";
@@ -453,6 +548,16 @@ OrderVector* InputData::getOrderVector(string label){
 /***********************************************************************/
 SharedRAbundVectors* InputData::getSharedRAbundVectors(){
     try {
+        if (usingPipeline()) {
+            SharedRAbundVectors* shared = CurrentFile::getInstance()->getPipelineSharedRAbundVectors(filename, pipelineIndex);
+            if (shared != NULL) {
+                pipelineIndex++;
+                if (currentLabels.size() == 0) { currentLabels = shared->getOTUNames(); }
+                else { shared->setOTUNames(currentLabels);  }
+            }
+            return shared;
+        }
+        
         if(fileHandle){
             if (format == "sharedfile")  {
                 SharedRAbundVectors* shared = new SharedRAbundVectors(fileHandle, groups, nextDistanceLabel, otuTag);
@@ -491,6 +596,16 @@ SharedRAbundVectors* InputData::getSharedRAbundVectors(){
 /***********************************************************************/
 SharedRAbundVectors* InputData::getSharedRAbundVectors(string label){
 	try {
+        if (usingPipeline()) {
+            CurrentFile* current = CurrentFile::getInstance();
+            SharedRAbundVectors* shared = current->getPipelineSharedRAbundVectors(filename, current->getPipelineSharedIndex(filename, label));
+            if (shared != NULL) {
+                if (currentLabels.size() == 0) { currentLabels = shared->getOTUNames(); }
+                else { shared->setOTUNames(currentLabels);  }
+            }
+            return shared;
+        }
+        
 		ifstream in;
 		string  thisLabel;
 		
@@ -52,6 +52,9 @@ private:
     vector<string> groups;
     string nextDistanceLabel;
     string otuTag;
+    bool pipelineChecked, usePipeline;
+    int pipelineIndex;
+    bool usingPipeline();
 };
 
 
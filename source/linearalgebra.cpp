@@ -236,30 +236,102 @@ double LinearAlgebra::betacf(const double a, const double b, const double x) {
 }
 /*********************************************************************************************************************************/
 //[3][4] * [4][5] - columns in first must match rows in second, returns matrix[3][5]
-vector<vector<double> > LinearAlgebra::matrix_mult(vector<vector<double> > first, vector<vector<double> > second){
+vector<vector<double> > LinearAlgebra::matrix_mult(const vector<vector<double> >& first, const vector<vector<double> >& second){
 	try {
-		vector<vector<double> > product;
+		DenseMatrix product = matrix_mult(DenseMatrix(first), DenseMatrix(second));
 		
-		int first_rows = first.size();
-		int first_cols = first[0].size();
-		int second_cols = second[0].size();
+		return product.toVector();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "LinearAlgebra", "matrix_mult");
+		exit(1);
+	}
+	
+}
+/*********************************************************************************************************************************/
+//multiplies rows [start, end) of first by second in cache sized tiles. Summation order over k matches the naive loop.
+void driverMatrixMult(matrixMultData* params){
+	try {
+		const DenseMatrix& first = *(params->first);
+		const DenseMatrix& second = *(params->second);
+		DenseMatrix& product = *(params->product);
 		
-		product.resize(first_rows);
-		for(int i=0;i<first_rows;i++){
-			product[i].resize(second_cols);
-		}
+		int first_cols = first.getNumCols();
+		int second_cols = second.getNumCols();
 		
-		for(int i=0;i<first_rows;i++){
-			for(int j=0;j<second_cols;j++){
-				
-				if (m->getControl_pressed()) { return product; }
+		for (int ii = params->start; ii < params->end; ii += MATRIX_BLOCK_SIZE) {
+			
+			if (params->m->getControl_pressed()) { break; }
+			
+			int iEnd = min(ii+MATRIX_BLOCK_SIZE, params->end);
+			for (int kk = 0; kk < first_cols; kk += MATRIX_BLOCK_SIZE) {
+				int kEnd = min(kk+MATRIX_BLOCK_SIZE, first_cols);
+				for (int jj = 0; jj < second_cols; jj += MATRIX_BLOCK_SIZE) {
+					int jEnd = min(jj+MATRIX_BLOCK_SIZE, second_cols);
 					
-				product[i][j] = 0.0;
-				for(int k=0;k<first_cols;k++){
-					product[i][j] += first[i][k] * second[k][j];
+					for (int i = ii; i < iEnd; i++) {
+						const double* firstRow = first.getRow(i);
+						double* productRow = product.getRow(i);
+						for (int k = kk; k < kEnd; k++) {
+							double value = firstRow[k];
+							const double* secondRow = second.getRow(k);
+							for (int j = jj; j < jEnd; j++) { productRow[j] += value * secondRow[j]; }
+						}
+					}
 				}
 			}
 		}
+	}
+	catch(exception& e) {
+		params->m->errorOut(e, "LinearAlgebra", "driverMatrixMult");
+		exit(1);
+	}
+}
+/*********************************************************************************************************************************/
+//[3][4] * [4][5] - columns in first must match rows in second, returns matrix[3][5]
+DenseMatrix LinearAlgebra::matrix_mult(const DenseMatrix& first, const DenseMatrix& second){
+	try {
+		int first_rows = first.getNumRows();
+		int first_cols = first.getNumCols();
+		int second_cols = second.getNumCols();
+		
+		DenseMatrix product(first_rows, second_cols, 0.0);
+		
+		if ((first_rows == 0) || (second_cols == 0)) { return product; }
+		if (second.getNumRows() < first_cols) { m->mothurOut("[ERROR]: matrix dimensions do not agree in matrix_mult, cannot multiply.\n"); m->setControl_pressed(true); return product; }
+		
+		//only split the rows if there is enough work to cover the thread overhead
+		int numThreads = processors;
+		double work = (double)first_rows * (double)first_cols * (double)second_cols;
+		if (work < MATRIX_THREAD_MIN_WORK) { numThreads = 1; }
+		if (first_rows < numThreads) { numThreads = first_rows; }
+		
+		vector<linePair> lines;
+		int rowsPerThread = first_rows / numThreads;
+		for (int i = 0; i < numThreads; i++) {
+			int start = i * rowsPerThread;
+			int end = (i == (numThreads-1)) ? first_rows : start + rowsPerThread;
+			lines.push_back(linePair(start, end));
+		}
+		
+		vector<thread*> workerThreads;
+		vector<matrixMultData*> data;
+		
+		for (int i = 1; i < numThreads; i++) {
+			matrixMultData* dataBundle = new matrixMultData(&first, &second, &product, lines[i].start, lines[i].end);
+			data.push_back(dataBundle);
+			workerThreads.push_back(new thread(driverMatrixMult, dataBundle));
+		}
+		
+		matrixMultData* dataBundle = new matrixMultData(&first, &second, &product, lines[0].start, lines[0].end);
+		driverMatrixMult(dataBundle);
+		delete dataBundle;
+		
+		for (int i = 0; i < workerThreads.size(); i++) {
+			workerThreads[i]->join();
+			delete data[i];
+			delete workerThreads[i];
+		}
 		
 		return product;
 	}
@@ -271,14 +343,9 @@ vector<vector<double> > LinearAlgebra::matrix_mult(vector<vector<double> > first
 }
 /*********************************************************************************************************************************/
 
-vector<vector<double> > LinearAlgebra::transpose(vector<vector<double> >matrix){
+vector<vector<double> > LinearAlgebra::transpose(const vector<vector<double> >& matrix){
 	try {
-		vector<vector<double> > trans; trans.resize(matrix[0].size());
-        for (int i = 0; i < trans.size(); i++) {
-            for (int j = 0; j < matrix.size(); j++) { trans[i].push_back(matrix[j][i]); }
-        }
- 				
-		return trans;
+		return DenseMatrix(matrix).transpose().toVector();
 	}
 	catch(exception& e) {
 		m->errorOut(e, "LinearAlgebra", "transpose");
@@ -288,30 +355,49 @@ vector<vector<double> > LinearAlgebra::transpose(vector<vector<double> >matrix){
 }
 /*********************************************************************************************************************************/
 
-void LinearAlgebra::recenter(double offset, vector<vector<double> > D, vector<vector<double> >& G){
+void LinearAlgebra::recenter(double offset, const vector<vector<double> >& D, vector<vector<double> >& G){
+	try {
+		DenseMatrix centered;
+		recenter(offset, DenseMatrix(D), centered);
+		G = centered.toVector();
+	}
+	catch(exception& e) {
+		m->errorOut(e, "LinearAlgebra", "recenter");
+		exit(1);
+	}
+	
+}
+/*********************************************************************************************************************************/
+//G = C * A * C where C is the centering matrix I - 1/n. Multiplying by C on both sides double centers A, so
+//G[i][j] = A[i][j] - rowMean[i] - colMean[j] + grandMean, which avoids the two n^3 matrix multiplications.
+void LinearAlgebra::recenter(double offset, const DenseMatrix& D, DenseMatrix& G){
 	try {
-		int rank = D.size();
+		int rank = D.getNumRows();
 		
-		vector<vector<double> > A(rank);
-		vector<vector<double> > C(rank);
+		G.resize(rank, rank, 0.0);
 		for(int i=0;i<rank;i++){
-			A[i].resize(rank);
-			C[i].resize(rank);
+			for(int j=i+1;j<rank;j++){
+				G(i, j) = G(j, i) = -0.5 * D(i, j) * D(i, j) + offset;
+			}
 		}
 		
-		double scale = -1.0000 / (double) rank;
-		
+		//A is symmetric so the row means are also the column means
+		vector<double> means(rank, 0.0);
+		double grandMean = 0.0;
 		for(int i=0;i<rank;i++){
-			A[i][i] = 0.0000;
-			C[i][i] = 1.0000 + scale;
-			for(int j=i+1;j<rank;j++){
-				A[i][j] = A[j][i] = -0.5 * D[i][j] * D[i][j] + offset;
-				C[i][j] = C[j][i] = scale;
-			}
+			const double* row = G.getRow(i);
+			for(int j=0;j<rank;j++){ means[i] += row[j]; }
+			grandMean += means[i];
+			means[i] /= (double) rank;
 		}
+		grandMean /= ((double) rank * (double) rank);
 		
-		A = matrix_mult(C,A);
-		G = matrix_mult(A,C);
+		for(int i=0;i<rank;i++){
+			if (m->getControl_pressed()) { break; }
+			
+			double* row = G.getRow(i);
+			for(int j=0;j<rank;j++){ row[j] = row[j] - means[i] - means[j] + grandMean; }
+		}
 	}
 	catch(exception& e) {
 		m->errorOut(e, "LinearAlgebra", "recenter");
@@ -321,13 +407,28 @@ void LinearAlgebra::recenter(double offset, vector<vector<double> > D, vector<ve
 }
 /*********************************************************************************************************************************/
 
+int LinearAlgebra::tred2(vector<vector<double> >& a, vector<double>& d, vector<double>& e){
+	try {
+		DenseMatrix matrix(a);
+		int result = tred2(matrix, d, e);
+		a = matrix.toVector();
+		
+		return result;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "LinearAlgebra", "tred2");
+		exit(1);
+	}
+}
+/*********************************************************************************************************************************/
+
 //  This function is taken from Numerical Recipes in C++ by Press et al., 2nd edition, pg. 479
 
-int LinearAlgebra::tred2(vector<vector<double> >& a, vector<double>& d, vector<double>& e){
+int LinearAlgebra::tred2(DenseMatrix& a, vector<double>& d, vector<double>& e){
 	try {
 		double scale, hh, h, g, f;
 		
-		int n = a.size();
+		int n = a.getNumRows();
 		
 		d.resize(n);
 		e.resize(n);
@@ -337,46 +438,46 @@ int LinearAlgebra::tred2(vector<vector<double> >& a, vector<double>& d, vector<d
 			h = scale = 0.0000;
 			if(l>0){
 				for(int k=0;k<l+1;k++){
-					scale += fabs(a[i][k]);
+					scale += fabs(a(i, k));
 				}
 				if(scale == 0.0){
-					e[i] = a[i][l];
+					e[i] = a(i, l);
 				}
 				else{
 					for(int k=0;k<l+1;k++){
-						a[i][k] /= scale;
-						h += a[i][k] * a[i][k];
+						a(i, k) /= scale;
+						h += a(i, k) * a(i, k);
 					}
-					f = a[i][l];
+					f = a(i, l);
 					g = (f >= 0.0 ? -sqrt(h) : sqrt(h));
 					e[i] = scale * g;
 					h -= f * g;
-					a[i][l] = f - g;
+					a(i, l) = f - g;
 					f = 0.0;
 					for(int j=0;j<l+1;j++){
-						a[j][i] = a[i][j] / h;
+						a(j, i) = a(i, j) / h;
 						g = 0.0;
 						for(int k=0;k<j+1;k++){
-							g += a[j][k] * a[i][k];
+							g += a(j, k) * a(i, k);
 						}
 						for(int k=j+1;k<l+1;k++){
-							g += a[k][j] * a[i][k];
+							g += a(k, j) * a(i, k);
 						}
 						e[j] = g / h;
-						f += e[j] * a[i][j];
+						f += e[j] * a(i, j);
 					}
 					hh = f / (h + h);
 					for(int j=0;j<l+1;j++){
-						f = a[i][j];
+						f = a(i, j);
 						e[j] = g = e[j] - hh * f;
 						for(int k=0;k<j+1;k++){
-							a[j][k] -= (f * e[k] + g * a[i][k]);
+							a(j, k) -= (f * e[k] + g * a(i, k));
 						}
 					}
 				}
 			}
 			else{
-				e[i] = a[i][l];
+				e[i] = a(i, l);
 			}
 			
 			d[i] = h;
@@ -391,17 +492,17 @@ int LinearAlgebra::tred2(vector<vector<double> >& a, vector<double>& d, vector<d
 				for(int j=0;j<l;j++){
 					g = 0.0000;
 					for(int k=0;k<l;k++){
-						g += a[i][k] * a[k][j];
+						g += a(i, k) * a(k, j);
 					}
 					for(int k=0;k<l;k++){
-						a[k][j] -= g * a[k][i];
+						a(k, j) -= g * a(k, i);
 					}
 				}
 			}
-			d[i] = a[i][i];
-			a[i][i] = 1.0000;
+			d[i] = a(i, i);
+			a(i, i) = 1.0000;
 			for(int j=0;j<l;j++){
-				a[j][i] = a[i][j] = 0.0;
+				a(j, i) = a(i, j) = 0.0;
 			}
 		}
 		
@@ -419,9 +520,24 @@ double LinearAlgebra::pythag(double a, double b)	{	return(pow(a*a+b*b,0.5));	}
 
 /*********************************************************************************************************************************/
 
+int LinearAlgebra::qtli(vector<double>& d, vector<double>& e, vector<vector<double> >& z) {
+	try {
+		DenseMatrix matrix(z);
+		int result = qtli(d, e, matrix);
+		z = matrix.toVector();
+		
+		return result;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "LinearAlgebra", "qtli");
+		exit(1);
+	}
+}
+/*********************************************************************************************************************************/
+
 //  This function is taken from Numerical Recipes in C++ by Press et al., 2nd edition, pg. 479
 
-int LinearAlgebra::qtli(vector<double>& d, vector<double>& e, vector<vector<double> >& z) {
+int LinearAlgebra::qtli(vector<double>& d, vector<double>& e, DenseMatrix& z) {
 	try {
 		int myM, i, iter;
 		double s, r, p, g, f, dd, c, b;
@@ -462,9 +578,9 @@ int LinearAlgebra::qtli(vector<double>& d, vector<double>& e, vector<vector<doub
 						d[i+1] = g + ( p = s * r);
 						g = c * r - b;
 						for(int k=0;k<n;k++){
-							f = z[k][i+1];
-							z[k][i+1] = s * z[k][i] + c * f;
-							z[k][i] = c * z[k][i] - s * f;
+							f = z(k, i+1);
+							z(k, i+1) = s * z(k, i) + c * f;
+							z(k, i) = c * z(k, i) - s * f;
 						}
 					}
 					if(r == 0.00 && i >= l) continue;
@@ -487,9 +603,9 @@ int LinearAlgebra::qtli(vector<double>& d, vector<double>& e, vector<vector<doub
 				d[k]=d[i];
 				d[i]=p;
 				for(int j=0;j<n;j++){
-					p=z[j][i];
-					z[j][i] = z[j][k];
-					z[j][k] = p;
+					p=z(j, i);
+					z(j, i) = z(j, k);
+					z(j, k) = p;
 				}
 			}
 		}
@@ -548,6 +664,41 @@ vector< vector<double> > LinearAlgebra::calculateEuclidianDistance(vector< vecto
 	}
 }
 /*********************************************************************************************************************************/
+//groups by dimension
+vector< vector<double> > LinearAlgebra::calculateEuclidianDistance(const DenseMatrix& axes, int dimensions){
+	try {
+		int numRows = axes.getNumRows();
+		
+		//make square matrix
+		vector< vector<double> > dists; dists.resize(numRows);
+		for (int i = 0; i < dists.size(); i++) {  dists[i].resize(numRows, 0.0); }
+		
+		for (int i = 0; i < numRows; i++) {
+			
+			if (m->getControl_pressed()) { return dists; }
+			
+			const double* rowI = axes.getRow(i);
+			for (int j = 0; j < i; j++) {
+				const double* rowJ = axes.getRow(j);
+				
+				if (dimensions == 1) { dists[i][j] = abs(rowI[0] - rowJ[0]); } //one dimension calc = abs(x-y)
+				else if (dimensions > 1) { //two dimension calc = sqrt ((x1 - y1)^2 + (x2 - y2)^2)...
+					double sum = 0.0;
+					for (int k = 0; k < dimensions; k++) { sum += ((rowI[k] - rowJ[k]) * (rowI[k] - rowJ[k])); }
+					dists[i][j] = sqrt(sum);
+				}
+				dists[j][i] = dists[i][j];
+			}
+		}
+		
+		return dists;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "LinearAlgebra", "calculateEuclidianDistance");
+		exit(1);
+	}
+}
+/*********************************************************************************************************************************/
 //returns groups by dimensions from dimensions by groups
 vector< vector<double> > LinearAlgebra::calculateEuclidianDistance(vector< vector<double> >& axes){
 	try {
@@ -1762,16 +1913,16 @@ vector<vector<double> > LinearAlgebra::getObservedEuclideanDistance(vector<vecto
 }
 
 /*********************************************************************************************************************************/
-vector<double> LinearAlgebra::solveEquations(vector<vector<double> > A, vector<double> b){
+vector<double> LinearAlgebra::solveEquations(const vector<vector<double> >& A, vector<double> b){
     try {
         int length = (int)b.size();
-        vector<double> x(length, 0);
         vector<int> index(length);
         for(int i=0;i<length;i++){  index[i] = i;   }
         double d;
         
-        ludcmp(A, index, d);  if (m->getControl_pressed()) { return b; }
-        lubksb(A, index, b);
+        DenseMatrix LU(A);
+        ludcmp(LU, index, d);  if (m->getControl_pressed()) { return b; }
+        lubksb(LU, index, b);
         
         return b;
     }
@@ -1801,21 +1952,42 @@ vector<float> LinearAlgebra::solveEquations(vector<vector<float> > A, vector<flo
 }
 
 /*********************************************************************************************************************************/
-
-void LinearAlgebra::ludcmp(vector<vector<double> >& A, vector<int>& index, double& d){
+//rank one update of the trailing submatrix for rows [start, end) after pivot column j has been scaled
+void driverLUUpdate(luUpdateData* params){
+	try {
+		DenseMatrix& A = *(params->A);
+		int j = params->pivot;
+		int n = A.getNumCols();
+		const double* pivotRow = A.getRow(j);
+		
+		for (int i = params->start; i < params->end; i++) {
+			double* row = A.getRow(i);
+			double factor = row[j];
+			for (int k = j+1; k < n; k++) { row[k] -= factor * pivotRow[k]; }
+		}
+	}
+	catch(exception& e) {
+		params->m->errorOut(e, "LinearAlgebra", "driverLUUpdate");
+		exit(1);
+	}
+}
+/*********************************************************************************************************************************/
+//right looking form of the Numerical Recipes ludcmp with implicit pivoting. The rows are contiguous, so the trailing
+//update streams through memory and is divided between threads once the remaining submatrix is large enough.
+void LinearAlgebra::ludcmp(DenseMatrix& A, vector<int>& index, double& d){
     try {
         double tiny = 1e-20;
         
-        int n = (int)A.size();
+        int n = A.getNumRows();
         vector<double> vv(n, 0.0);
-        int imax;
         
         d = 1.0;
         
         for(int i=0;i<n;i++){
-            float big = 0.0;
+            double big = 0.0;
+            const double* row = A.getRow(i);
             for(int j=0;j<n;j++){
-                float thisValue = fabs(A[i][j]);
+                double thisValue = fabs(row[j]);
                 if (thisValue > big)  { big = thisValue;  }
             }
 
@@ -1825,39 +1997,55 @@ void LinearAlgebra::ludcmp(vector<vector<double> >& A, vector<int>& index, doubl
         
         for(int j=0;j<n;j++){
             if (m->getControl_pressed()) { break; }
-            for(int i=0;i<j;i++){
-                double sum = A[i][j];
-                for(int k=0;k<i;k++){   sum -= A[i][k] * A[k][j];   }
-                A[i][j] = sum;
-            }
             
             double big = 0.0;
+            int imax = j;
             for(int i=j;i<n;i++){
-                double sum = A[i][j];
-                for(int k=0;k<j;k++){   sum -= A[i][k] * A[k][j];   }
-                A[i][j] = sum;
                 double dum;
-                if((dum = vv[i] * fabs(sum)) >= big){
+                if((dum = vv[i] * fabs(A(i, j))) >= big){
                     big = dum;
                     imax = i;
                 }
             }
             if(j != imax){
-                for(int k=0;k<n;k++){
-                    double dum = A[imax][k];
-                    A[imax][k] = A[j][k];
-                    A[j][k] = dum;
-                }
+                A.swapRows(imax, j);
                 d = -d;
                 vv[imax] = vv[j];
             }
             index[j] = imax;
             
-            if(A[j][j] == 0.0){ A[j][j] = tiny; }
+            if(A(j, j) == 0.0){ A(j, j) = tiny; }
             
             if(j != n-1){
-                double dum = 1.0/A[j][j];
-                for(int i=j+1;i<n;i++){ A[i][j] *= dum; }
+                double dum = 1.0/A(j, j);
+                for(int i=j+1;i<n;i++){ A(i, j) *= dum; }
+                
+                int remainingRows = n-j-1;
+                int numThreads = processors;
+                if (((double)remainingRows * (double)remainingRows) < LU_THREAD_MIN_WORK) { numThreads = 1; }
+                if (remainingRows < numThreads) { numThreads = remainingRows; }
+                
+                int rowsPerThread = remainingRows / numThreads;
+                vector<thread*> workerThreads;
+                vector<luUpdateData*> data;
+                
+                for (int t = 1; t < numThreads; t++) {
+                    int start = j+1+t*rowsPerThread;
+                    int end = (t == (numThreads-1)) ? n : start + rowsPerThread;
+                    luUpdateData* dataBundle = new luUpdateData(&A, j, start, end);
+                    data.push_back(dataBundle);
+                    workerThreads.push_back(new thread(driverLUUpdate, dataBundle));
+                }
+                
+                luUpdateData* dataBundle = new luUpdateData(&A, j, j+1, (numThreads == 1) ? n : j+1+rowsPerThread);
+                driverLUUpdate(dataBundle);
+                delete dataBundle;
+                
+                for (int t = 0; t < workerThreads.size(); t++) {
+                    workerThreads[t]->join();
+                    delete data[t];
+                    delete workerThreads[t];
+                }
             }
         }
     }
@@ -1869,37 +2057,31 @@ void LinearAlgebra::ludcmp(vector<vector<double> >& A, vector<int>& index, doubl
 
 /*********************************************************************************************************************************/
 
-void LinearAlgebra::lubksb(vector<vector<double> >& A, vector<int>& index, vector<double>& b){
+void LinearAlgebra::lubksb(const DenseMatrix& A, const vector<int>& index, vector<double>& b){
     try {
-        //if(m->debug){   m->mothurOut("lubksb\n");    }
         double total;
-        int n = (int)A.size();
+        int n = A.getNumRows();
         int ii = 0;
         
         for(int i=0;i<n;i++){
-            //if(m->debug){   m->mothurOut("i loop " + toString(i) + "\n");    }
             if (m->getControl_pressed()) { break; }
             int ip = index[i];
             total = b[ip];
             b[ip] = b[i];
             
             if (ii != 0) {
-                for(int j=ii-1;j<i;j++){
-                    //if(m->debug){   m->mothurOut("j loop " + toString(j) + "\n");    }
-                    total -= A[i][j] * b[j];
-                }
+                const double* row = A.getRow(i);
+                for(int j=ii-1;j<i;j++){ total -= row[j] * b[j]; }
             }
             else if(total != 0){  ii = i+1;   }
             b[i] = total;
         }
         for(int i=n-1;i>=0;i--){
-            //if(m->debug){   m->mothurOut("i loop " + toString(i) + "\n");    }
+            const double* row = A.getRow(i);
             total = b[i];
-            for(int j=i+1;j<n;j++){ total -= A[i][j] * b[j];   }
-            b[i] = total / A[i][i];
-            //if (A[i][i] == 0) { cout << "ohno!!" << endl; }
+            for(int j=i+1;j<n;j++){ total -= row[j] * b[j];   }
+            b[i] = total / row[i];
         }
-        //if(m->debug){   m->mothurOut("end lubksb\n");    }
     }
 	catch(exception& e) {
 		m->errorOut(e, "LinearAlgebra", "lubksb");
@@ -2016,12 +2198,21 @@ void LinearAlgebra::lubksb(vector<vector<float> >& A, vector<int>& index, vector
 
 /*********************************************************************************************************************************/
 
-vector<vector<double> > LinearAlgebra::getInverse(vector<vector<double> > matrix){
+vector<vector<double> > LinearAlgebra::getInverse(const vector<vector<double> >& matrix){
+    try {
+        return getInverse(DenseMatrix(matrix)).toVector();
+    }
+	catch(exception& e) {
+		m->errorOut(e, "LinearAlgebra", "getInverse");
+		exit(1);
+	}
+}
+/*********************************************************************************************************************************/
+DenseMatrix LinearAlgebra::getInverse(DenseMatrix matrix){
     try {
-        int n = (int)matrix.size();
+        int n = matrix.getNumRows();
         
-        vector<vector<double> > inverse(n);
-        for(int i=0;i<n;i++){   inverse[i].assign(n, 0.0000);   }
+        DenseMatrix inverse(n, n, 0.0000);
         
         vector<double> column(n, 0.0000);
         vector<int> index(n, 0);
@@ -2038,7 +2229,7 @@ vector<vector<double> > LinearAlgebra::getInverse(vector<vector<double> > matrix
             
             lubksb(matrix, index, column);
             
-            for(int i=0;i<n;i++){   inverse[i][j] = column[i];  }
+            for(int i=0;i<n;i++){   inverse(i, j) = column[i];  }
         }
         
         return inverse;
@@ -2050,7 +2241,7 @@ vector<vector<double> > LinearAlgebra::getInverse(vector<vector<double> > matrix
 }
 /*********************************************************************************************************************************/
 //modelled R lda function - MASS:::lda.default
-vector< vector<double> > LinearAlgebra::lda(vector< vector<double> >& a, vector<string> groups, vector< vector<double> >& means, bool& ignore) {
+vector< vector<double> > LinearAlgebra::lda(vector< vector<double> >& a, const vector<string>& groups, vector< vector<double> >& means, bool& ignore) {
     try {
         
         set<string> uniqueGroups;
@@ -2064,11 +2255,12 @@ vector< vector<double> > LinearAlgebra::lda(vector< vector<double> >& a, vector<
         int numSampled = groups.size(); //number of sampled groups
         int numOtus = a.size(); //number of flagged bins
         
+        vector<int> groupIndex(numSampled); //avoids the map lookups in the loops below
+        for (int j = 0; j < numSampled; j++) { groupIndex[j] = quickIndex[groups[j]]; }
+        
         //counts <- as.vector(table(g)) //number of samples from each class in random sampling
         vector<int> counts; counts.resize(numGroups, 0);
-        for (int i = 0; i < groups.size(); i++) {
-            counts[quickIndex[groups[i]]]++;
-        }
+        for (int i = 0; i < numSampled; i++) { counts[groupIndex[i]]++; }
         
         vector<double> proportions; proportions.resize(numGroups, 0.0);
         for (int i = 0; i < numGroups; i++) {  proportions[i] = counts[i] / (double) numSampled; }
@@ -2076,172 +2268,89 @@ vector< vector<double> > LinearAlgebra::lda(vector< vector<double> >& a, vector<
         means.clear(); //means[0] -> means[0][0] average for [group0][OTU0].
         means.resize(numGroups); for (int i = 0; i < means.size(); i++) { means[i].resize(numOtus, 0.0); }
         for (int j = 0; j < numSampled; j++) { //total for each class for each OTU
-            for (int i = 0; i < numOtus; i++) { means[quickIndex[groups[j]]][i] += a[i][j]; }
+            for (int i = 0; i < numOtus; i++) { means[groupIndex[j]][i] += a[i][j]; }
         }
         //average for each class for each OTU
         for (int j = 0; j < numGroups; j++) { for (int i = 0; i < numOtus; i++) { means[j][i] /= counts[j]; }  }
         
         //randCov <- x - group.means[g, ]
-        vector< vector<double> > randCov; //randCov[0][0] -> (random sample value0 for OTU0 - average for samples group in OTU0). example OTU0, random sample 0.01 from class early. average of class early for OTU0 is 0.005. randCov[0][0] = (0.01-0.005)
+        //randCov(0,0) -> (random sample value0 for OTU0 - average for samples group in OTU0). example OTU0, random sample 0.01 from class early. average of class early for OTU0 is 0.005. randCov(0,0) = (0.01-0.005)
+        DenseMatrix randCov(numOtus, numSampled);
         for (int i = 0; i < numOtus; i++) { //for each flagged OTU
-            vector<double> tempRand;
-            for (int j = 0; j < numSampled; j++) { tempRand.push_back(a[i][j] - means[quickIndex[groups[j]]][i]);  }
-            randCov.push_back(tempRand);
+            for (int j = 0; j < numSampled; j++) { randCov(i, j) = a[i][j] - means[groupIndex[j]][i];  }
         }
         
         //find variance and std for each OTU
         //f1 <- sqrt(diag(var(x - group.means[g, ])))
-        vector<double> stdF1;
-        vector<double> ave;
-        for (int i = 0; i < numOtus; i++) {
-            stdF1.push_back(0.0);
-            ave.push_back(util.getAverage(randCov[i]));
-        }
-        
+        vector<double> stdF1(numOtus, 0.0);
         for (int i = 0; i < numOtus; i++) {
-            for (int j = 0; j < numSampled; j++) { stdF1[i] += ((randCov[i][j] - ave[i]) * (randCov[i][j] - ave[i]));  }
+            const double* row = randCov.getRow(i);
+            double ave = 0.0;
+            for (int j = 0; j < numSampled; j++) { ave += row[j]; }
+            ave /= (double) numSampled;
+            for (int j = 0; j < numSampled; j++) { stdF1[i] += ((row[j] - ave) * (row[j] - ave));  }
+            stdF1[i] /= (double) (numSampled-1);
+            stdF1[i] = sqrt(stdF1[i]);
         }
         
         //fac <- 1/(n - ng)
         double fac = 1 / (double) (numSampled-numGroups);
         
-        for (int i = 0; i < stdF1.size(); i++) {
-            stdF1[i] /= (double) (numSampled-1);
-            stdF1[i] = sqrt(stdF1[i]);
-        }
-        
-        vector< vector<double> > scaling; //[numOTUS][numOTUS]
-        for (int i = 0; i < numOtus; i++) {
-            vector<double> temp;
-            for (int j = 0; j < numOtus; j++) {
-                if (i == j) { temp.push_back(1.0/stdF1[i]); }
-                else { temp.push_back(0.0); }
-                
-            }
-            scaling.push_back(temp);
-        }
-        /*
-         cout << "scaling = " << endl;
-         for (int i = 0; i < scaling.size(); i++) {
-         for (int j = 0; j < scaling[i].size(); j++) { cout << scaling[i][j] << '\t'; }
-         cout << endl;
-         }*/
+        //scaling is the [numOTUS][numOTUS] diagonal matrix 1/stdF1, so multiplying by it just scales the rows
+        vector<double> scaling(numOtus, 0.0);
+        for (int i = 0; i < numOtus; i++) { scaling[i] = 1.0/stdF1[i]; }
         
         //X <- sqrt(fac) * ((x - group.means[g, ]) %*% scaling)
-        vector< vector<double> > X = randCov; //[numOTUS][numSampled]
-        //((x - group.means[g, ]) %*% scaling)
-        //matrix multiplication of randCov and scaling
-        LinearAlgebra linear;
-        X = linear.matrix_mult(scaling, randCov); //[numOTUS][numOTUS] * [numOTUS][numSampled] = [numOTUS][numSampled]
+        //[numOTUS][numOTUS] * [numOTUS][numSampled] = [numOTUS][numSampled]
         fac = sqrt(fac);
-        
-        for (int i = 0; i < X.size(); i++) {
-            for (int j = 0; j < X[i].size(); j++) { X[i][j] *= fac;  }
+        DenseMatrix X = std::move(randCov);
+        for (int i = 0; i < numOtus; i++) {
+            double* row = X.getRow(i);
+            for (int j = 0; j < numSampled; j++) { row[j] = (row[j] * scaling[i]) * fac;  }
         }
         
         vector<double> d;
-        vector< vector<double> > v;
-        vector< vector<double> > Xcopy; //X = [numOTUS][numSampled]
+        DenseMatrix v;
+        DenseMatrix Xcopy; //X = [numOTUS][numSampled]
         bool transpose = false; //svd requires rows < columns, so if they are not then I need to transpose and look for the results in v.
-        if (X.size() < X[0].size()) { Xcopy = linear.transpose(X); transpose=true; }
-        else                        { Xcopy = X;                    }
-        linear.svd(Xcopy, d, v); //Xcopy gets the results we want for v below, because R's version is [numSampled][numOTUS]
-        
-        /*cout << "Xcopy = " << endl;
-        for (int i = 0; i < Xcopy.size(); i++) {
-            for (int j = 0; j < Xcopy[i].size(); j++) { cout << Xcopy[i][j] << '\t'; }
-            cout << endl;
-        }
-        cout << "v = " << endl;
-        for (int i = 0; i < v.size(); i++) {
-            for (int j = 0; j < v[i].size(); j++) { cout << v[i][j] << '\t'; }
-            cout << endl;
-        }
-         */
+        if (X.getNumRows() < X.getNumCols()) { Xcopy = X.transpose(); transpose=true; }
+        else                                  { Xcopy = std::move(X);                 }
+        svd(Xcopy, d, v); //Xcopy gets the results we want for v below, because R's version is [numSampled][numOTUS]
         
         int rank = 0;
-        set<int> goodColumns;
-        //cout << "d = " << endl;
-        for (int i = 0; i < d.size(); i++) {  if (d[i] > 0.0000000001) { rank++; goodColumns.insert(i); } } //cout << d[i] << endl;
+        vector<int> goodColumns;
+        for (int i = 0; i < d.size(); i++) {  if (d[i] > 0.0000000001) { rank++; goodColumns.push_back(i); } }
         
         if (rank == 0) {
             ignore=true; //m->mothurOut("[ERROR]: rank = 0: variables are numerically const\n"); m->setControl_pressed(true);
-            return scaling; }
+            vector< vector<double> > diagScaling(numOtus);
+            for (int i = 0; i < numOtus; i++) { diagScaling[i].resize(numOtus, 0.0); diagScaling[i][i] = scaling[i]; }
+            return diagScaling; }
         
         //scaling <- scaling %*% X.s$v[, 1L:rank] %*% diag(1/X.s$d[1L:rank], , rank)
         //X.s$v[, 1L:rank] = columns in Xcopy that correspond to "good" d values
         //diag(1/X.s$d[1L:rank], , rank) = matrix size rank * rank where the diagonal is 1/"good" dvalues
-        /*example:
-         d
-         [1] 3.721545e+00 3.034607e+00 2.296649e+00 7.986927e-16 6.922408e-16
-         [6] 5.471102e-16
-         
-         $v
-         [,1]        [,2]        [,3]        [,4]        [,5]        [,6]
-         [1,]  0.31122175  0.10944725  0.20183340 -0.30136820  0.60786235 -0.13537095
-         [2,] -0.29563726 -0.20568893  0.11233366 -0.05073289  0.48234270  0.21965978
-         ...
-         
-         [1] "X.s$v[, 1L:rank]"
-         [,1]        [,2]        [,3]
-         [1,]  0.31122175  0.10944725  0.20183340
-         [2,] -0.29563726 -0.20568893  0.11233366
-         ...
-         [1] "1/X.s$d[1L:rank]"
-         [1] 0.2687056 0.3295320 0.4354170
-         
-         [1] "diag(1/X.s$d[1L:rank], , rank)"
-         [,1]     [,2]     [,3]
-         [1,] 0.2687056 0.000000 0.000000
-         [2,] 0.0000000 0.329532 0.000000
-         [3,] 0.0000000 0.000000 0.435417
-         */
-        if (transpose) {
-            Xcopy = linear.transpose(v);
-            /*
-            cout << "Xcopy = " << endl;
-            for (int i = 0; i < Xcopy.size(); i++) {
-                for (int j = 0; j < Xcopy[i].size(); j++) { cout << Xcopy[i][j] << '\t'; }
-                cout << endl;
-            }*/
-        }
-        v.clear(); //store "good" columns - X.s$v[, 1L:rank]
-        v.resize(Xcopy.size()); //[numOTUS]["good" columns]
-        for (set<int>::iterator it = goodColumns.begin(); it != goodColumns.end(); it++) {
-            for (int i = 0; i < Xcopy.size(); i++) {
-                v[i].push_back(Xcopy[i][*it]);
-            }
+        //both outer matrices are diagonal, so scaledV[i][c] = scaling[i] * v[i][good c] / d[good c]
+        if (transpose) { Xcopy = v.transpose(); }
+        DenseMatrix scaledV(numOtus, rank); //[numOTUS]["good" columns]
+        for (int i = 0; i < numOtus; i++) {
+            for (int c = 0; c < rank; c++) {  scaledV(i, c) = (scaling[i] * Xcopy(i, goodColumns[c])) * (1.0 / d[goodColumns[c]]); }
         }
         
-        vector< vector<double> > diagRanks; diagRanks.resize(rank);
-        for (int i = 0; i < rank; i++) { diagRanks[i].resize(rank, 0.0); }
-        count = 0;
-        for (set<int>::iterator it = goodColumns.begin(); it != goodColumns.end(); it++) {  diagRanks[count][count] = 1.0 / d[*it]; count++; }
-        
-        scaling = linear.matrix_mult(linear.matrix_mult(scaling, v), diagRanks); //([numOTUS][numOTUS]*[numOTUS]["good" columns]) = [numOTUS]["good" columns] then ([numOTUS]["good" columns] * ["good" columns]["good" columns] = scaling = [numOTUS]["good" columns]
-        
-        /*cout << "scaling = " << endl;
-        for (int i = 0; i < scaling.size(); i++) {
-            for (int j = 0; j < scaling[i].size(); j++) { cout << scaling[i][j] << '\t'; }
-            cout << endl;
-        }*/
-        
-        //Note: linear.matrix_mult [1][numGroups] * [numGroups][numOTUs] - columns in first must match rows in second, returns matrix[1][numOTUs]
-        vector< vector<double> > prior; prior.push_back(proportions);
-        vector< vector<double> >  xbar = linear.matrix_mult(prior, means);
-        vector<double> xBar = xbar[0]; //length numOTUs
+        //Note: [1][numGroups] * [numGroups][numOTUs] returns matrix[1][numOTUs]
+        vector<double> xBar(numOtus, 0.0); //length numOTUs
+        for (int j = 0; j < numOtus; j++) {
+            for (int g = 0; g < numGroups; g++) { xBar[j] += proportions[g] * means[g][j]; }
+        }
         
-        /*cout << "xbar" << endl;
-        for (int j = 0; j < numOtus; j++) {  cout << xBar[j] <<'\t'; }cout <<  endl;*/
         //fac <- 1/(ng - 1)
         fac = 1 / (double) (numGroups-1);
         //scale(group.means, center = xbar, scale = FALSE) %*% scaling
-        vector< vector<double> > scaledMeans = means; //[numGroups][numOTUs]
+        DenseMatrix centeredMeans(numGroups, numOtus); //[numGroups][numOTUs]
         for (int i = 0; i < numGroups; i++) {
-            for (int j = 0; j < numOtus; j++) {  scaledMeans[i][j] -= xBar[j]; }
+            for (int j = 0; j < numOtus; j++) {  centeredMeans(i, j) = means[i][j] - xBar[j]; }
         }
-        scaledMeans = linear.matrix_mult(scaledMeans, scaling); //[numGroups][numOTUS]*[numOTUS]["good"columns] = [numGroups]["good"columns]
-        
+        DenseMatrix scaledMeans = matrix_mult(centeredMeans, scaledV); //[numGroups][numOTUS]*[numOTUS]["good"columns] = [numGroups]["good"columns]
         
         //sqrt((n * prior) * fac)
         vector<double> temp = proportions; //[numGroups]
@@ -2249,68 +2358,37 @@ vector< vector<double> > LinearAlgebra::lda(vector< vector<double> >& a, vector<
         
         //X <- sqrt((n * prior) * fac) * (scale(group.means, center = xbar, scale = FALSE) %*% scaling)
         //X <- temp * scaledMeans
-        X.clear(); X = scaledMeans; //[numGroups]["good"columns]
-        for (int i = 0; i < X.size(); i++) {
-            for (int j = 0; j < X[i].size(); j++) {  X[i][j] *= temp[j];  }
-        }
-        /*
-        cout << "X = " << endl;
-        for (int i = 0; i < X.size(); i++) {
-            for (int j = 0; j < X[i].size(); j++) { cout << X[i][j] << '\t'; }
-            cout << endl;
+        X = std::move(scaledMeans); //[numGroups]["good"columns]
+        for (int i = 0; i < X.getNumRows(); i++) {
+            for (int j = 0; j < X.getNumCols(); j++) {  X(i, j) *= temp[i];  }
         }
-        */
         
-        d.clear(); v.clear();
+        d.clear();
         //we want to transpose so results are in Xcopy, but if that makes rows > columns then we don't since svd requires rows < cols.
         transpose=false;
-        if (X.size() > X[0].size()) {   Xcopy = X;  transpose=true;     }
-        else                        {   Xcopy = linear.transpose(X);    }
-        linear.svd(Xcopy, d, v); //Xcopy gets the results we want for v below
-        /*cout << "Xcopy = " << endl;
-        for (int i = 0; i < Xcopy.size(); i++) {
-            for (int j = 0; j < Xcopy[i].size(); j++) { cout << Xcopy[i][j] << '\t'; }
-            cout << endl;
-        }
-        
-        cout << "v = " << endl;
-        for (int i = 0; i < v.size(); i++) {
-            for (int j = 0; j < v[i].size(); j++) { cout << v[i][j] << '\t'; }
-            cout << endl;
-        }
-        
-        cout << "d = " << endl;
-        for (int i = 0; i < d.size(); i++) { cout << d[i] << endl; }*/
+        if (X.getNumRows() > X.getNumCols()) {   Xcopy = std::move(X);  transpose=true;     }
+        else                                 {   Xcopy = X.transpose();                     }
+        svd(Xcopy, d, v); //Xcopy gets the results we want for v below
         
         //rank <- sum(X.s$d > tol * X.s$d[1L])
         //X.s$d[1L] = larger value in d vector
         double largeD = util.max(d);
         rank = 0; goodColumns.clear();
-        for (int i = 0; i < d.size(); i++) { if (d[i] > (0.0000000001*largeD)) { rank++; goodColumns.insert(i); } }
+        for (int i = 0; i < d.size(); i++) { if (d[i] > (0.0000000001*largeD)) { rank++; goodColumns.push_back(i); } }
         
         if (rank == 0) {
             ignore=true;//m->mothurOut("[ERROR]: rank = 0: class means are numerically identical.\n"); m->setControl_pressed(true);
-            return scaling; }
+            return scaledV.toVector(); }
         
-        if (transpose) { Xcopy = linear.transpose(v);  }
+        if (transpose) { Xcopy = v.transpose();  }
         //scaling <- scaling %*% X.s$v[, 1L:rank] - scaling * "good" columns
-        v.clear(); //store "good" columns - X.s$v[, 1L:rank]
-        v.resize(Xcopy.size()); //Xcopy = ["good"columns][numGroups]
-        for (set<int>::iterator it = goodColumns.begin(); it != goodColumns.end(); it++) {
-            for (int i = 0; i < Xcopy.size(); i++) {
-                v[i].push_back(Xcopy[i][*it]);
-            }
+        DenseMatrix goodV(Xcopy.getNumRows(), rank); //Xcopy = ["good"columns][numGroups]
+        for (int i = 0; i < Xcopy.getNumRows(); i++) {
+            for (int c = 0; c < rank; c++) { goodV(i, c) = Xcopy(i, goodColumns[c]); }
         }
         
-        scaling = linear.matrix_mult(scaling, v); //[numOTUS]["good" columns] * ["good"columns][new "good" columns]
-        
-        /*cout << "scaling = " << endl;
-        for (int i = 0; i < scaling.size(); i++) {
-            for (int j = 0; j < scaling[i].size(); j++) { cout << scaling[i][j] << '\t'; }
-            cout << endl;
-        }*/
         ignore=false;
-        return scaling;
+        return matrix_mult(scaledV, goodV).toVector(); //[numOTUS]["good" columns] * ["good"columns][new "good" columns]
     }
 	catch(exception& e) {
 		m->errorOut(e, "LinearAlgebra", "lda");
@@ -2318,6 +2396,20 @@ vector< vector<double> > LinearAlgebra::lda(vector< vector<double> >& a, vector<
 	}
 }
 /*********************************************************************************************************************************/
+int LinearAlgebra::svd(vector< vector<double> >& a, vector<double>& w, vector< vector<double> >& v) {
+    try {
+        DenseMatrix A(a), V;
+        int result = svd(A, w, V);
+        a = A.toVector(); v = V.toVector();
+        
+        return result;
+    }
+	catch(exception& e) {
+		m->errorOut(e, "LinearAlgebra", "svd");
+		exit(1);
+	}
+}
+/*********************************************************************************************************************************/
 //Singular value decomposition (SVD) - adapted from http://svn.lirec.eu/libs/magicsquares/src/SVD.cpp
 /*
  * svdcomp - SVD decomposition routine.
@@ -2336,18 +2428,18 @@ vector< vector<double> > LinearAlgebra::lda(vector< vector<double> >& a, vector<
  *   v = returns the right orthogonal transformation matrix
  */
 
-int LinearAlgebra::svd(vector< vector<double> >& a, vector<double>& w, vector< vector<double> >& v) {
+int LinearAlgebra::svd(DenseMatrix& a, vector<double>& w, DenseMatrix& v) {
     try {
         
         int flag, i, its, j, jj, k, l, nm;
         double c, f, h, s, x, y, z;
         double anorm = 0.0, g = 0.0, scale = 0.0;
 
-        int numRows = a.size(); if (numRows == 0) { return 0; }
-        int numCols = a[0].size();
+        int numRows = a.getNumRows(); if (numRows == 0) { return 0; }
+        int numCols = a.getNumCols();
         if (numCols == 0) {  return 0; }
         w.resize(numCols, 0.0);
-        v.resize(numCols); for (int i = 0; i < numCols; i++) { v[i].resize(numRows, 0.0); }
+        v.resize(numCols, numRows, 0.0);
     
         vector<double> rv1; rv1.resize(numCols, 0.0);
         if (numRows < numCols){  m->mothurOut("[ERROR]: numRows < numCols\n"); m->setControl_pressed(true); return 0; }
@@ -2362,31 +2454,31 @@ int LinearAlgebra::svd(vector< vector<double> >& a, vector<double>& w, vector< v
             if (i < numRows)
             {
                 for (k = i; k < numRows; k++)
-                    scale += fabs((double)a[k][i]);
+                    scale += fabs((double)a(k, i));
                 if (scale)
                 {
                     for (k = i; k < numRows; k++)
                     {
-                        a[k][i] = (double)((double)a[k][i]/scale);
-                        s += ((double)a[k][i] * (double)a[k][i]);
+                        a(k, i) = (double)((double)a(k, i)/scale);
+                        s += ((double)a(k, i) * (double)a(k, i));
                     }
-                    f = (double)a[i][i];
+                    f = (double)a(i, i);
                     g = -SIGN(sqrt(s), f);
                     h = f * g - s;
-                    a[i][i] = (double)(f - g);
+                    a(i, i) = (double)(f - g);
                     if (i != numCols - 1)
                     {
                         for (j = l; j < numCols; j++)
                         {
                             for (s = 0.0, k = i; k < numRows; k++)
-                                s += ((double)a[k][i] * (double)a[k][j]);
+                                s += ((double)a(k, i) * (double)a(k, j));
                             f = s / h;
                             for (k = i; k < numRows; k++)
-                                a[k][j] += (double)(f * (double)a[k][i]);
+                                a(k, j) += (double)(f * (double)a(k, i));
                         }
                     }
                     for (k = i; k < numRows; k++)
-                        a[k][i] = (double)((double)a[k][i]*scale);
+                        a(k, i) = (double)((double)a(k, i)*scale);
                 }
             }
             w[i] = (double)(scale * g);
@@ -2396,32 +2488,32 @@ int LinearAlgebra::svd(vector< vector<double> >& a, vector<double>& w, vector< v
             if (i < numRows && i != numCols - 1)
             {
                 for (k = l; k < numCols; k++)
-                    scale += fabs((double)a[i][k]);
+                    scale += fabs((double)a(i, k));
                 if (scale)
                 {
                     for (k = l; k < numCols; k++)
                     {
-                        a[i][k] = (double)((double)a[i][k]/scale);
-                        s += ((double)a[i][k] * (double)a[i][k]);
+                        a(i, k) = (double)((double)a(i, k)/scale);
+                        s += ((double)a(i, k) * (double)a(i, k));
                     }
-                    f = (double)a[i][l];
+                    f = (double)a(i, l);
                     g = -SIGN(sqrt(s), f);
                     h = f * g - s;
-                    a[i][l] = (double)(f - g);
+                    a(i, l) = (double)(f - g);
                     for (k = l; k < numCols; k++)
-                        rv1[k] = (double)a[i][k] / h;
+                        rv1[k] = (double)a(i, k) / h;
                     if (i != numRows - 1)
                     {
                         for (j = l; j < numRows; j++)
                         {
                             for (s = 0.0, k = l; k < numCols; k++)
-                                s += ((double)a[j][k] * (double)a[i][k]);
+                                s += ((double)a(j, k) * (double)a(i, k));
                             for (k = l; k < numCols; k++)
-                                a[j][k] += (double)(s * rv1[k]);
+                                a(j, k) += (double)(s * rv1[k]);
                         }
                     }
                     for (k = l; k < numCols; k++)
-                        a[i][k] = (double)((double)a[i][k]*scale);
+                        a(i, k) = (double)((double)a(i, k)*scale);
                 }
             }
             anorm = max(anorm, (fabs((double)w[i]) + fabs(rv1[i])));
@@ -2435,20 +2527,20 @@ int LinearAlgebra::svd(vector< vector<double> >& a, vector<double>& w, vector< v
                 if (g)
                 {
                     for (j = l; j < numCols; j++)
-                        v[j][i] = (double)(((double)a[i][j] / (double)a[i][l]) / g);
+                        v(j, i) = (double)(((double)a(i, j) / (double)a(i, l)) / g);
                     /* double division to avoid underflow */
                     for (j = l; j < numCols; j++)
                     {
                         for (s = 0.0, k = l; k < numCols; k++)
-                            s += ((double)a[i][k] * (double)v[k][j]);
+                            s += ((double)a(i, k) * (double)v(k, j));
                         for (k = l; k < numCols; k++)
-                            v[k][j] += (double)(s * (double)v[k][i]);
+                            v(k, j) += (double)(s * (double)v(k, i));
                     }
                 }
                 for (j = l; j < numCols; j++)
-                    v[i][j] = v[j][i] = 0.0;
+                    v(i, j) = v(j, i) = 0.0;
             }
-            v[i][i] = 1.0;
+            v(i, i) = 1.0;
             g = rv1[i];
             l = i;
         }
@@ -2460,7 +2552,7 @@ int LinearAlgebra::svd(vector< vector<double> >& a, vector<double>& w, vector< v
             g = (double)w[i];
             if (i < numCols - 1)
                 for (j = l; j < numCols; j++)
-                    a[i][j] = 0.0;
+                    a(i, j) = 0.0;
             if (g)
             {
                 g = 1.0 / g;
@@ -2469,21 +2561,21 @@ int LinearAlgebra::svd(vector< vector<double> >& a, vector<double>& w, vector< v
                     for (j = l; j < numCols; j++)
                     {
                         for (s = 0.0, k = l; k < numRows; k++)
-                            s += ((double)a[k][i] * (double)a[k][j]);
-                        f = (s / (double)a[i][i]) * g;
+                            s += ((double)a(k, i) * (double)a(k, j));
+                        f = (s / (double)a(i, i)) * g;
                         for (k = i; k < numRows; k++)
-                            a[k][j] += (double)(f * (double)a[k][i]);
+                            a(k, j) += (double)(f * (double)a(k, i));
                     }
                 }
                 for (j = i; j < numRows; j++)
-                    a[j][i] = (double)((double)a[j][i]*g);
+                    a(j, i) = (double)((double)a(j, i)*g);
             }
             else
             {
                 for (j = i; j < numRows; j++)
-                    a[j][i] = 0.0;
+                    a(j, i) = 0.0;
             }
-            ++a[i][i];
+            ++a(i, i);
         }
         
         /* diagonalize the bidiagonal form */
@@ -2520,10 +2612,10 @@ int LinearAlgebra::svd(vector< vector<double> >& a, vector<double>& w, vector< v
                             s = (- f * h);
                             for (j = 0; j < numRows; j++)
                             {
-                                y = (double)a[j][nm];
-                                z = (double)a[j][i];
-                                a[j][nm] = (double)(y * c + z * s);
-                                a[j][i] = (double)(z * c - y * s);
+                                y = (double)a(j, nm);
+                                z = (double)a(j, i);
+                                a(j, nm) = (double)(y * c + z * s);
+                                a(j, i) = (double)(z * c - y * s);
                             }
                         }
                     }
@@ -2535,7 +2627,7 @@ int LinearAlgebra::svd(vector< vector<double> >& a, vector<double>& w, vector< v
                     {              /* make singular value nonnegative */
                         w[k] = (double)(-z);
                         for (j = 0; j < numCols; j++)
-                            v[j][k] = (-v[j][k]);
+                            v(j, k) = (-v(j, k));
                     }
                     break;
                 }
@@ -2573,10 +2665,10 @@ int LinearAlgebra::svd(vector< vector<double> >& a, vector<double>& w, vector< v
                     y = y * c;
                     for (jj = 0; jj < numCols; jj++)
                     {
-                        x = (double)v[jj][j];
-                        z = (double)v[jj][i];
-                        v[jj][j] = (float)(x * c + z * s);
-                        v[jj][i] = (float)(z * c - x * s);
+                        x = (double)v(jj, j);
+                        z = (double)v(jj, i);
+                        v(jj, j) = (float)(x * c + z * s);
+                        v(jj, i) = (float)(z * c - x * s);
                     }
                     z = pythag(f, h);
                     w[j] = (float)z;
@@ -2590,10 +2682,10 @@ int LinearAlgebra::svd(vector< vector<double> >& a, vector<double>& w, vector< v
                     x = (c * y) - (s * g);
                     for (jj = 0; jj < numRows; jj++)
                     {
-                        y = (double)a[jj][j];
-                        z = (double)a[jj][i];
-                        a[jj][j] = (double)(y * c + z * s);
-                        a[jj][i] = (double)(z * c - y * s);
+                        y = (double)a(jj, j);
+                        z = (double)a(jj, i);
+                        a(jj, j) = (double)(y * c + z * s);
+                        a(jj, i) = (double)(z * c - y * s);
                     }
                 }
                 rv1[l] = 0.0;
@@ -12,22 +12,39 @@
 
 #include "mothurout.h"
 #include "utils.hpp"
+#include "densematrix.hpp"
+
+#define MATRIX_BLOCK_SIZE 64            //tile edge used by matrix_mult
+#define MATRIX_THREAD_MIN_WORK 1000000  //multiply-adds before matrix_mult uses more than one thread
+#define LU_THREAD_MIN_WORK 250000       //trailing submatrix cells before ludcmp uses more than one thread
 
 
 class LinearAlgebra {
 	
 public:
-	LinearAlgebra() { m = MothurOut::getInstance(); }
+	LinearAlgebra() { m = MothurOut::getInstance(); processors = 1; }
 	~LinearAlgebra() {}
+    
+    void setProcessors(int p) { processors = max(p, 1); } //threads used by matrix_mult and ludcmp on large matrices
 	
-	vector<vector<double> > matrix_mult(vector<vector<double> >, vector<vector<double> >);
-    vector<vector<double> >transpose(vector<vector<double> >);
-	void recenter(double, vector<vector<double> >, vector<vector<double> >&);
+	vector<vector<double> > matrix_mult(const vector<vector<double> >&, const vector<vector<double> >&);
+    vector<vector<double> > transpose(const vector<vector<double> >&);
+	void recenter(double, const vector<vector<double> >&, vector<vector<double> >&);
 	//eigenvectors
     int tred2(vector<vector<double> >&, vector<double>&, vector<double>&);
 	int qtli(vector<double>&, vector<double>&, vector<vector<double> >&);
     
+    //contiguous versions - the vector<vector<double> > functions above convert and call these
+    DenseMatrix matrix_mult(const DenseMatrix&, const DenseMatrix&);
+    DenseMatrix transpose(const DenseMatrix& matrix) { return matrix.transpose(); }
+    void recenter(double, const DenseMatrix&, DenseMatrix&);
+    int tred2(DenseMatrix&, vector<double>&, vector<double>&);
+    int qtli(vector<double>&, vector<double>&, DenseMatrix&);
+    DenseMatrix getInverse(DenseMatrix);
+    int svd(DenseMatrix& a, vector<double>& w, DenseMatrix& v);
+    
 	vector< vector<double> > calculateEuclidianDistance(vector<vector<double> >&, int); //pass in axes and number of dimensions
+    vector< vector<double> > calculateEuclidianDistance(const DenseMatrix&, int); //pass in axes and number of dimensions
 	vector< vector<double> > calculateEuclidianDistance(vector<vector<double> >&); //pass in axes
 	vector<vector<double> > getObservedEuclideanDistance(vector<vector<double> >&);
 	double calcPearson(vector<vector<double> >&, vector<vector<double> >&);
@@ -44,16 +61,17 @@ public:
     double calcPearsonSig(double, double); //length, coeff.
     double calcKendallSig(double, double); //length, coeff.
     
-    vector<double> solveEquations(vector<vector<double> >, vector<double>);
+    vector<double> solveEquations(const vector<vector<double> >&, vector<double>);
     vector<float> solveEquations(vector<vector<float> >, vector<float>);
-    vector<vector<double> > getInverse(vector<vector<double> >);
+    vector<vector<double> > getInverse(const vector<vector<double> >&);
     double choose(double, double);
     double normalvariate(double mu, double sigma);
-    vector< vector<double> > lda(vector< vector<double> >& a, vector<string> groups, vector< vector<double> >& means, bool&); //Linear discriminant analysis - a is [features][valuesFromGroups] groups indicates which group each sampling comes from. For example if groups = early, late, mid, early, early. a[0][0] = value for feature0 from groupEarly.
+    vector< vector<double> > lda(vector< vector<double> >& a, const vector<string>& groups, vector< vector<double> >& means, bool&); //Linear discriminant analysis - a is [features][valuesFromGroups] groups indicates which group each sampling comes from. For example if groups = early, late, mid, early, early. a[0][0] = value for feature0 from groupEarly.
     int svd(vector< vector<double> >& a, vector<double>& w, vector< vector<double> >& v); //Singular value decomposition
 private:
 	MothurOut* m;
     Utils util;
+    int processors;
 	
 	double pythag(double, double);
     double betacf(const double, const double, const double);
@@ -73,13 +91,48 @@ private:
     double ran4(int&); //for testing
     void psdes(unsigned long &, unsigned long &); //for testing
     
-    void ludcmp(vector<vector<double> >&, vector<int>&, double&);
-    void lubksb(vector<vector<double> >&, vector<int>&, vector<double>&);
+    void ludcmp(DenseMatrix&, vector<int>&, double&);
+    void lubksb(const DenseMatrix&, const vector<int>&, vector<double>&);
     
     void ludcmp(vector<vector<float> >&, vector<int>&, float&);
     void lubksb(vector<vector<float> >&, vector<int>&, vector<float>&);
     
 };
+/***********************************************************************/
+struct matrixMultData {
+    const DenseMatrix* first;
+    const DenseMatrix* second;
+    DenseMatrix* product;
+    int start, end; //rows of first
+    MothurOut* m;
+    
+    matrixMultData(){}
+    matrixMultData(const DenseMatrix* f, const DenseMatrix* s, DenseMatrix* p, int st, int en) {
+        m = MothurOut::getInstance();
+        first = f;
+        second = s;
+        product = p;
+        start = st;
+        end = en;
+    }
+};
+/***********************************************************************/
+struct luUpdateData {
+    DenseMatrix* A;
+    int pivot;
+    int start, end; //rows below the pivot
+    MothurOut* m;
+    
+    luUpdateData(){}
+    luUpdateData(DenseMatrix* a, int p, int st, int en) {
+        m = MothurOut::getInstance();
+        A = a;
+        pivot = p;
+        start = st;
+        end = en;
+    }
+};
+/***********************************************************************/
 
 #endif
 
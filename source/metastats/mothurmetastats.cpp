@@ -12,11 +12,13 @@
 #include "utils.hpp"
 
 /***********************************************************/
-MothurMetastats::MothurMetastats(double t, int n) {
+MothurMetastats::MothurMetastats(double t, int n, int p) {
 	try {
 		m = MothurOut::getInstance(); 
 		threshold = t;
 		numPermutations = n;
+		processors = p;
+		if (processors < 1) { processors = 1; }
 		
 	}catch(exception& e) {
 		m->errorOut(e, "MothurMetastats", "MothurMetastats");
@@ -244,52 +246,162 @@ int MothurMetastats::runMetastats(string outputFileName, vector< vector<double>
     }	
 }
 /***********************************************************/
+//t-statistics for each taxa with the columns in the order given, ie group abundances randomized
+void calcPermutedTs(vector< vector<double> >& Imatrix, vector<int>& order, int secondGroupingStart, vector<double>& Ts) {
+    int row = Imatrix.size();
+    int column = order.size();
+    
+    for(int i = 0; i < row; i++){ // for each taxa
+        vector<double>& permutedRow = Imatrix[i];
+        
+        //# find the mean of each group
+        double g1Total = 0.0; double g2Total = 0.0;
+        for (int j = 0; j < secondGroupingStart; j++)       {     g1Total += permutedRow[order[j]]; }
+        double mean1 = g1Total/(double)(secondGroupingStart);
+        for (int j = secondGroupingStart; j < column; j++)  {     g2Total += permutedRow[order[j]]; }
+        double mean2 = g2Total/(double)(column-secondGroupingStart);
+        
+        //# find the variance of each group
+        double g1Var = 0.0; double g2Var = 0.0;
+        for (int j = 0; j < secondGroupingStart; j++)       {     g1Var += pow((permutedRow[order[j]]-mean1), 2);  }
+        double var1 = g1Var/(double)(secondGroupingStart-1);
+        for (int j = secondGroupingStart; j < column; j++)  {     g2Var += pow((permutedRow[order[j]]-mean2), 2);  }
+        double var2 = g2Var/(double)(column-secondGroupingStart-1);
+        
+        //# two sample t-statistic from the std err^2 of each group
+        double xbar_diff = mean1 - mean2;
+        double denom = sqrt(var1/(double)(secondGroupingStart) + var2/(double)(column-secondGroupingStart));
+        Ts[i] = abs(xbar_diff/denom);
+    }
+}
+/***********************************************************/
+void driverMetastatsPermutations(metastatsPermutationData* params) {
+    try {
+        vector<double>& thresholds = *(params->thresholds);
+        vector<int>& pooledTaxa = *(params->pooledTaxa);
+        vector<double> Ts; Ts.resize(params->Imatrix->size(), 0.0);
+        
+        vector<int> order;
+        for (int b = params->start; b < params->end; b++) {
+            
+            mt19937_64 engine((*params->seeds)[b]);
+            
+            for (int p = 0; p < (*params->sizes)[b]; p++) {
+                if (params->m->getControl_pressed()) { return; }
+                
+                //randomize columns, ie group abundances.
+                order.clear();
+                for (int i = 0; i < params->column; i++) { order.push_back(i); }
+                shuffle(order.begin(), order.end(), engine);
+                
+                calcPermutedTs(*(params->Imatrix), order, params->secondGroupingStart, Ts);
+                
+                if (!params->pool) {
+                    for (int i = 0; i < Ts.size(); i++) { if (Ts[i] > thresholds[i]) { params->counts[i]++; } }
+                }else {
+                    //count the pooled t by how many of the sorted thresholds are below it
+                    for (int k = 0; k < pooledTaxa.size(); k++) {
+                        double t = Ts[pooledTaxa[k]];
+                        if (isnan(t)) { continue; }
+                        params->counts[lower_bound(thresholds.begin(), thresholds.end(), t) - thresholds.begin()]++;
+                    }
+                }
+            }
+        }
+    }
+    catch(exception& e) {
+        params->m->errorOut(e, "MothurMetastats", "driverMetastatsPermutations");
+        exit(1);
+    }
+}
+/***********************************************************/
+//the permutations run in blocks, each with its own seed drawn in block order, so the pvalues do not depend on the number of processors
 vector<double> MothurMetastats::permuted_pvalues(vector< vector<double> >& Imatrix, vector<double>& tstats, vector< vector<double> >& Fmatrix) {
 	try {
-        //# matrix stores tstats for each taxa(row) for each permuted trial(column)
         vector<double> ps;  ps.resize(row, 0.0); //# to store the pvalues
-        vector< vector<double> > permuted_ttests; permuted_ttests.resize(numPermutations);            
-        for (int i = 0; i < numPermutations; i++) { permuted_ttests[i].resize(row, 0.0);  } 
- 
-        //# calculate null version of tstats using B permutations.
-        for (int i = 0; i < numPermutations; i++) {   
-            permuted_ttests[i] = permute_and_calc_ts(Imatrix);
+        
+        vector<unsigned long long> seeds; vector<int> sizes;
+        for (int i = 0; i < numPermutations; i += METASTATS_BLOCK_SIZE) {
+            seeds.push_back((unsigned long long)util.getRandomNumber());
+            sizes.push_back(min(METASTATS_BLOCK_SIZE, numPermutations-i));
         }
         
-        //# calculate each pvalue using the null ts
-        if ((secondGroupingStart) < 8 || (column-secondGroupingStart) < 8){
-            vector< vector<double> > cleanedpermuted_ttests; cleanedpermuted_ttests.resize(numPermutations);  //# the array pooling just the frequently observed ts
-            //# then pool the t's together!
-            //# count how many high freq taxa there are
-            int hfc = 1;
+        //# when the groups are small, the ts of the frequently observed taxa are pooled together
+        //# count how many high freq taxa there are
+        vector<int> pooledTaxa;
+        int hfc = 1;
+        bool pool = ((secondGroupingStart) < 8 || (column-secondGroupingStart) < 8);
+        if (pool) {
             for (int i = 0; i < row; i++) {                 // # for each taxa
                 double group1Total = 0.0; double group2Total = 0.0;
                 for(int j = 0; j < secondGroupingStart; j++)		{ group1Total += Fmatrix[i][j];	}
-				for(int j = secondGroupingStart; j < column; j++)	{ group2Total += Fmatrix[i][j];	}
+                for(int j = secondGroupingStart; j < column; j++)	{ group2Total += Fmatrix[i][j];	}
                 
-                if (group1Total >= secondGroupingStart || group2Total >= (column-secondGroupingStart)){ 
-                    hfc++;
-                    for (int j = 0; j < numPermutations; j++) {   cleanedpermuted_ttests[j].push_back(permuted_ttests[j][i]); }
-                }
+                if (group1Total >= secondGroupingStart || group2Total >= (column-secondGroupingStart)){ hfc++; pooledTaxa.push_back(i); }
+            }
+            
+            //with no frequently observed taxa there is nothing to pool, so each taxa is compared to its own permuted ts
+            if (pooledTaxa.size() == 0) { pool = false; }
+        }
+        
+        //pooled ts are compared to every taxa's t, so they are counted against the sorted thresholds. A nan t is never exceeded.
+        vector<double> thresholds;
+        for (int i = 0; i < row; i++) {
+            if (!pool)                          { thresholds.push_back(abs(tstats[i]));     }
+            else if (!isnan(tstats[i]))         { thresholds.push_back(abs(tstats[i]));     }
+        }
+        if (pool) { sort(thresholds.begin(), thresholds.end()); }
+        
+        int numBlocks = seeds.size();
+        int numProcs = processors;
+        if (numBlocks < numProcs) { numProcs = numBlocks; }
+        
+        vector<double> counts; counts.resize(thresholds.size()+1, 0);
+        if (numProcs > 0) {
+            vector<thread*> workerThreads;
+            vector<metastatsPermutationData*> data;
+            
+            //divide the blocks between the processors
+            vector<int> startBlocks;
+            for (int p = 0; p <= numProcs; p++) { startBlocks.push_back((int)(((long long)numBlocks * p) / numProcs)); }
+            
+            //Lauch worker threads
+            for (int i = 1; i < numProcs; i++) {
+                metastatsPermutationData* dataBundle = new metastatsPermutationData(&Imatrix, &seeds, &sizes, &thresholds, &pooledTaxa, pool, startBlocks[i], startBlocks[i+1], column, secondGroupingStart);
+                data.push_back(dataBundle);
+                workerThreads.push_back(new thread(driverMetastatsPermutations, dataBundle));
             }
             
+            metastatsPermutationData* dataBundle = new metastatsPermutationData(&Imatrix, &seeds, &sizes, &thresholds, &pooledTaxa, pool, startBlocks[0], startBlocks[1], column, secondGroupingStart);
+            driverMetastatsPermutations(dataBundle);
+            for (int j = 0; j < counts.size(); j++) { counts[j] += dataBundle->counts[j]; }
+            delete dataBundle;
+            
+            for (int i = 0; i < workerThreads.size(); i++) {
+                workerThreads[i]->join();
+                for (int j = 0; j < counts.size(); j++) { counts[j] += data[i]->counts[j]; }
+                delete data[i];
+                delete workerThreads[i];
+            }
+        }
+        
+        //# calculate each pvalue using the null ts
+        if (pool){
+            //number of pooled ts above each count of thresholds and above
+            for (int j = counts.size()-2; j >= 0; j--) { counts[j] += counts[j+1]; }
+            
             //#now for each taxa
             for (int i = 0; i < row; i++) { 
-                //number of cleanedpermuted_ttests greater than tstat[i]
-                int numGreater = 0;
-                for (int j = 0; j < numPermutations; j++) {
-                    for (int k = 0; k < hfc; k++) {
-                        if (cleanedpermuted_ttests[j][k] > abs(tstats[i])) { numGreater++; }
-                    }
-                }
+                //number of pooled ts greater than tstat[i]
+                double numGreater = 0;
+                if (!isnan(tstats[i])) { numGreater = counts[upper_bound(thresholds.begin(), thresholds.end(), abs(tstats[i])) - thresholds.begin()]; }
                 
                 ps[i] = (1/(double)(numPermutations*hfc))*numGreater;
             }
         }else{
             for (int i = 0; i < row; i++) { 
-                //number of permuted_ttests[i] greater than tstat[i] //(sum(permuted_ttests[i,] > abs(tstats[i]))+1)
-                int numGreater = 1;
-                for (int j = 0; j < numPermutations; j++) { if (permuted_ttests[j][i] > abs(tstats[i])) { numGreater++; }   }
+                //number of permuted ts greater than tstat[i] //(sum(permuted_ttests[i,] > abs(tstats[i]))+1)
+                double numGreater = 1 + counts[i];
                 ps[i] = (1/(double)(numPermutations+1))*numGreater;
             }
         }
@@ -302,67 +414,6 @@ vector<double> MothurMetastats::permuted_pvalues(vector< vector<double> >& Imatr
     }	
 }
 /***********************************************************/
-vector<double> MothurMetastats::permute_and_calc_ts(vector< vector<double> >& Imatrix) {
-	try {
-        vector< vector<double> > permutedMatrix = Imatrix;
-        
-        //randomize columns, ie group abundances.
-        map<int, int> randomMap;
-        vector<int> randoms;
-        for (int i = 0; i < column; i++) { randoms.push_back(i); }
-        util.mothurRandomShuffle(randoms);
-        for (int i = 0; i < randoms.size(); i++) {   randomMap[i] = randoms[i];   }
-        
-        //calc ts
-        vector< vector<double> > C1; C1.resize(row);
-        for (int i = 0; i < row; i++) { C1[i].resize(3, 0.0);  } // statistic profiles for class1 and class 2
-        vector< vector<double> > C2; C2.resize(row);            // mean[1], variance[2], standard error[3] 
-        for (int i = 0; i < row; i++) { C2[i].resize(3, 0.0);  } 
-        vector<double> Ts; Ts.resize(row, 0.0); // a place to store the true t-statistics 
-
-        //#*************************************
-        //#  generate statistics mean, var, stderr    
-        //#*************************************
-        for(int i = 0; i < row; i++){ // for each taxa
-            //# find the mean of each group
-            double g1Total = 0.0; double g2Total = 0.0;
-            for (int j = 0; j < secondGroupingStart; j++)       {     g1Total += permutedMatrix[i][randomMap[j]]; }
-            C1[i][0] = g1Total/(double)(secondGroupingStart);
-            for (int j = secondGroupingStart; j < column; j++)  {     g2Total += permutedMatrix[i][randomMap[j]]; }
-            C2[i][0] = g2Total/(double)(column-secondGroupingStart);
-            
-            //# find the variance of each group
-            double g1Var = 0.0; double g2Var = 0.0;
-            for (int j = 0; j < secondGroupingStart; j++)       {     g1Var += pow((permutedMatrix[i][randomMap[j]]-C1[i][0]), 2);  }
-            C1[i][1] = g1Var/(double)(secondGroupingStart-1);
-            for (int j = secondGroupingStart; j < column; j++)  {     g2Var += pow((permutedMatrix[i][randomMap[j]]-C2[i][0]), 2);  }
-            C2[i][1] = g2Var/(double)(column-secondGroupingStart-1);
-            
-            //# find the std error of each group -std err^2 (will change to std err at end)
-            C1[i][2] = C1[i][1]/(double)(secondGroupingStart);    
-            C2[i][2] = C2[i][1]/(double)(column-secondGroupingStart);
-        }
-        
-        
-
-        //#*************************************
-        //#  two sample t-statistics
-        //#*************************************
-        for(int i = 0; i < row; i++){                  // # for each taxa
-            double xbar_diff = C1[i][0] - C2[i][0]; 
-            double denom = sqrt(C1[i][2] + C2[i][2]);
-            Ts[i] = abs(xbar_diff/denom);  // calculate two sample t-statistic
-        }
-
-        return Ts;
-
-        
-    }catch(exception& e) {
-        m->errorOut(e, "MothurMetastats", "permuted_ttests");
-        exit(1);
-    }	
-}
-/***********************************************************/
 int MothurMetastats::OrderPValues(int low, int high, vector<double>& p, vector<int>& order) {
 	try {
 		
@@ -14,22 +14,23 @@
 #include "mothurout.h"
 #include "utils.hpp"
 
+#define METASTATS_BLOCK_SIZE 100  //permutations run from one seed, the unit of work handed to a thread
+
 class MothurMetastats {
 	
 	public:
-		MothurMetastats(double, int); //threshold, numPermutations
+		MothurMetastats(double, int, int); //threshold, numPermutations, processors
 		~MothurMetastats();
 	
 		int runMetastats(string, vector< vector<double> >&, int, vector<string>); //outputFileName, data, secondGroupingStart, otuNames
 	
 	private:
 		MothurOut* m;
-		int row, column, numPermutations, secondGroupingStart;
+		int row, column, numPermutations, secondGroupingStart, processors;
 		double threshold;
         Utils util;
         
         vector<double> permuted_pvalues(vector< vector<double> >&, vector<double>&, vector< vector<double> >&);
-        vector<double> permute_and_calc_ts(vector< vector<double> >&);
     
 		int start(vector<double>&, int, vector<double>&, vector< vector<double> >&); //Find the initial values for the matrix
 		int meanvar(vector<double>&, int, vector<double>&);
@@ -42,6 +43,37 @@ class MothurMetastats {
 		vector<int> getSequence(int, int, int);
 		
 };
+/**************************************************************************************************/
+//the permutations run by one thread. Only counts are kept, either for each taxa the permuted ts greater than its own t,
+//or when the ts are pooled, how many pooled ts fall above each number of the sorted thresholds.
+struct metastatsPermutationData {
+    vector< vector<double> >* Imatrix;
+    vector<unsigned long long>* seeds;
+    vector<int>* sizes;
+    vector<double>* thresholds; //abs(t) for each taxa, or sorted for pooling
+    vector<int>* pooledTaxa;    //high frequency taxa whose ts are pooled
+    vector<double> counts;
+    int start, end, column, secondGroupingStart;
+    bool pool;
+    MothurOut* m;
+    
+    metastatsPermutationData(){}
+    metastatsPermutationData(vector< vector<double> >* im, vector<unsigned long long>* se, vector<int>* si, vector<double>* th, vector<int>* pt, bool po, int st, int en, int co, int sgs) {
+        m = MothurOut::getInstance();
+        Imatrix = im;
+        seeds = se;
+        sizes = si;
+        thresholds = th;
+        pooledTaxa = pt;
+        pool = po;
+        start = st;
+        end = en;
+        column = co;
+        secondGroupingStart = sgs;
+        counts.assign(thresholds->size()+1, 0);
+    }
+};
+/**************************************************************************************************/
 	
 #endif
 
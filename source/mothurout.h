@@ -66,6 +66,10 @@ class MothurOut {
         }
         bool getChangedSeqNames()                       { return changedSeqNames;           }
         void setChangedSeqNames(bool t)                 { changedSeqNames = t;              }
+        bool getIndexFiles()                            { return indexFiles;                }
+        void setIndexFiles(bool t)                      { indexFiles = t;                   }
+        unsigned long long getSortMemory()              { return sortMemory;                }
+        void setSortMemory(unsigned long long t)        { sortMemory = t;                   }
         bool getExecuting()                             { return executing;                 }
         void setExecuting(bool t)                       { executing = t;                    }
     
@@ -78,6 +82,8 @@ class MothurOut {
             debug = false;
             quietMode = false;
             changedSeqNames = true;
+            indexFiles = false;
+            sortMemory = 1073741824; //1GB
             silenceLog = false;
             numErrors = 0;
             numWarnings = 0;
@@ -89,9 +95,10 @@ class MothurOut {
 		
 		ofstream out;
         unsigned seed;
+        unsigned long long sortMemory; //bytes a sort of a file too large for memory holds before writing to disk
         int numErrors, numWarnings;
         string logFileName, buffer;
-        bool changedSeqNames, silenceLog, control_pressed, executing, debug, quietMode;
+        bool changedSeqNames, indexFiles, silenceLog, control_pressed, executing, debug, quietMode;
 };
 /***********************************************/
 
@@ -18,6 +18,9 @@
 #include "sequence.hpp"
 #include "alignment.hpp"
 #include "nast.hpp"
+#include "kmer.hpp"
+
+#define MIN_BAND_SEEDS 4	//fewer shared kmers than this and the full alignment is used
 
 /**************************************************************************************************/
 
@@ -25,6 +28,25 @@ Nast::Nast(Alignment* method, Sequence* cand, Sequence* temp) : alignment(method
 	try {
 		m = MothurOut::getInstance();
 		maxInsertLength = 0;
+		kmerSize = 0; bandWidth = 0;
+	
+		pairwiseAlignSeqs();	//	This is part A in Fig. 2 of DeSantis et al.
+		regapSequences();		//	This is parts B-F in Fig. 2 of DeSantis et al.
+		
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Nast", "Nast");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//	the pairwise alignment is limited to a band around the diagonals of the kmers the candidate and template share. If
+//	the alignment runs along the edge of the band, it is redone without one.
+Nast::Nast(Alignment* method, Sequence* cand, Sequence* temp, int ksize, int band) : alignment(method), candidateSeq(cand), templateSeq(temp) {
+	try {
+		m = MothurOut::getInstance();
+		maxInsertLength = 0;
+		kmerSize = ksize; bandWidth = band;
 	
 		pairwiseAlignSeqs();	//	This is part A in Fig. 2 of DeSantis et al.
 		regapSequences();		//	This is parts B-F in Fig. 2 of DeSantis et al.
@@ -41,7 +63,18 @@ Nast::Nast(Alignment* method, Sequence* cand, Sequence* temp) : alignment(method
 void Nast::pairwiseAlignSeqs(){	//	Here we call one of the pairwise alignment methods to align our unaligned candidate
 								//	and template sequences
 	try {	
-		alignment->align(candidateSeq->getUnaligned(), templateSeq->getUnaligned());
+		string candidate = candidateSeq->getUnaligned();
+		string templ = templateSeq->getUnaligned();
+		
+		if (bandWidth > 0) {	setBand(candidate, templ);	}
+		
+		alignment->align(candidate, templ);
+		
+		if (alignment->getBandTouched()) {		//	the best alignment may lie outside the band
+			alignment->clearBand();
+			alignment->align(candidate, templ);
+		}
+		alignment->clearBand();
 
 		string candAln = alignment->getSeqAAln();
 		string tempAln = alignment->getSeqBAln();
@@ -86,6 +119,24 @@ void Nast::pairwiseAlignSeqs(){	//	Here we call one of the pairwise alignment me
 	}	
 }
 
+/**************************************************************************************************/
+//	the band covers the middle 90% of the seed diagonals, so a few chance matches don't widen it, plus bandWidth on each side
+void Nast::setBand(const string& candidate, const string& templ){
+	try {
+		Kmer kmer(kmerSize);
+		vector<int> diagonals = kmer.getSeedDiagonals(candidate, templ);
+		
+		if (diagonals.size() < MIN_BAND_SEEDS) { return; }
+		
+		int trim = diagonals.size() / 20;
+		alignment->setBand(diagonals[trim] - bandWidth, diagonals[diagonals.size()-1-trim] + bandWidth);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Nast", "setBand");
+		exit(1);
+	}
+}
+
 /**************************************************************************************************/
 
 void Nast::removeExtraGaps(string& candAln, string tempAln, string newTemplateAlign){
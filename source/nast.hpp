@@ -30,12 +30,14 @@ class Nast {
 	
 public:
 	Nast(Alignment*, Sequence*, Sequence*);
+	Nast(Alignment*, Sequence*, Sequence*, int, int);	//kmer size and band width for a banded pairwise alignment
 	~Nast(){};
 	float getSimilarityScore();
 	int getMaxInsertLength();
 	
 private:
 	void pairwiseAlignSeqs();
+	void setBand(const string&, const string&);
 	void regapSequences();
 	void removeExtraGaps(string&, string, string);
 	
@@ -44,6 +46,7 @@ private:
 	Sequence* templateSeq;
 	
 	int maxInsertLength;
+	int kmerSize, bandWidth;
 	MothurOut* m;
 };
 
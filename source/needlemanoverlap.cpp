@@ -17,7 +17,6 @@
  *
  */
 
-#include "alignmentcell.hpp"
 #include "alignment.hpp"
 #include "overlap.hpp"
 #include "needlemanoverlap.hpp"
@@ -26,17 +25,15 @@
 
 NeedlemanOverlap::NeedlemanOverlap(float gO, float f, float mm, int r) ://	note that we don't have a gap extend
 gap(gO), match(f), mismatch(mm), Alignment(r) {							//	the gap openning penalty is assessed for
+	
 	try {																	//	every gapped position
 		for(int i=1;i<nCols;i++){
-			alignment[0][i].prevCell = 'l';					//	initialize first row by pointing all poiters to the left
-			alignment[0][i].cValue = 0;						//	and the score to zero
-		}
+			firstRow[i] = 'l';								//	initialize first row by pointing all poiters to the left
+		}													//	the edges of the matrix score zero
 		
 		for(int i=1;i<nRows;i++){
-			alignment[i][0].prevCell = 'u';					//	initialize first column by pointing all poiters upwards
-			alignment[i][0].cValue = 0;						//	and the score to zero
+			firstColumn[i] = 'u';							//	initialize first column by pointing all poiters upwards
 		}
-	
 	}
 	catch(exception& e) {
 		m->errorOut(e, "NeedlemanOverlap", "NeedlemanOverlap");
@@ -51,113 +48,143 @@ NeedlemanOverlap::~NeedlemanOverlap(){	/*	do nothing	*/	}
 
 void NeedlemanOverlap::align(string A, string B){
 	try {
-	
 		seqA = ' ' + A;	lA = seqA.length();		//	algorithm requires a dummy space at the beginning of each string
 		seqB = ' ' + B;	lB = seqB.length();		//	algorithm requires a dummy space at the beginning of each string
-
+		
 		if (lA > nRows) { m->mothurOut("One of your candidate sequences is longer than you longest template sequence. Your longest template sequence is " + toString(nRows) + ". Your candidate is " + toString(lA) + "."); m->mothurOutEndLine();  }
 		
-		for(int i=1;i<lB;i++){					//	This code was largely translated from Perl code provided in Ex 3.1 
+		startRows();
 		
-			for(int j=1;j<lA;j++){				//	of the O'Reilly BLAST book.  I found that the example output had a
-	
-				//	number of errors
-				float diagonal;
-				if(seqB[i] == seqA[j])	{	diagonal = alignment[i-1][j-1].cValue + match;		}
-				else					{	diagonal = alignment[i-1][j-1].cValue + mismatch;	}
+		const char* a = seqA.c_str();
+		
+		for(int i=1;i<lB;i++){					//	This code was largely translated from Perl code provided in Ex 3.1
+			const char base = seqB[i];			//	of the O'Reilly BLAST book.  I found that the example output had a
+			float* diag = &diagonals[0];		//	number of errors
+			int first, last;
+			getBandColumns(i, first, last);
+			for(int j=first;j<=last;j++){	diag[j] = ((base == a[j]) ? match : mismatch);	}
 			
-				float up	= alignment[i-1][j].cValue + gap;
-				float left	= alignment[i][j-1].cValue + gap;
-				
-				if(diagonal >= up){
-					if(diagonal >= left){
-						alignment[i][j].cValue = diagonal;
-						alignment[i][j].prevCell = 'd';
-					}
-					else{
-						alignment[i][j].cValue = left;
-						alignment[i][j].prevCell = 'l';
-					}
-				}
-				else{
-					if(up >= left){
-						alignment[i][j].cValue = up;
-						alignment[i][j].prevCell = 'u';
-					}
-					else{
-						alignment[i][j].cValue = left;
-						alignment[i][j].prevCell = 'l';
-					}
-				}
-			}
+			fillRow(i);
 		}
-
-		Overlap over;						
-		over.setOverlap(alignment, lA, lB, 0);		//	Fix gaps at the beginning and end of the sequences
-		traceBack();								//	Traceback the alignment to populate seqAaln and seqBaln
-	
+		
+		finishRows();
 	}
 	catch(exception& e) {
 		m->errorOut(e, "NeedlemanOverlap", "align");
 		exit(1);
 	}
-
 }
 /**************************************************************************************************/
 
 void NeedlemanOverlap::alignPrimer(string A, string B){
 	try {
-        
 		seqA = ' ' + A;	lA = seqA.length();		//	algorithm requires a dummy space at the beginning of each string
 		seqB = ' ' + B;	lB = seqB.length();		//	algorithm requires a dummy space at the beginning of each string
-        
+		
 		if (lA > nRows) { m->mothurOut("One of your candidate sequences is longer than you longest template sequence. Your longest template sequence is " + toString(nRows) + ". Your candidate is " + toString(lA) + "."); m->mothurOutEndLine();  }
 		
-		for(int i=1;i<lB;i++){					//	This code was largely translated from Perl code provided in Ex 3.1
-            
-			for(int j=1;j<lA;j++){				//	of the O'Reilly BLAST book.  I found that the example output had a
-                
-				//	number of errors
-				float diagonal;
-				if(isEquivalent(seqB[i],seqA[j]))	{	diagonal = alignment[i-1][j-1].cValue + match;		}
-				else                                {	diagonal = alignment[i-1][j-1].cValue + mismatch;	}
-                
-				float up	= alignment[i-1][j].cValue + gap;
-				float left	= alignment[i][j-1].cValue + gap;
-				
-				if(diagonal >= up){
-					if(diagonal >= left){
-						alignment[i][j].cValue = diagonal;
-						alignment[i][j].prevCell = 'd';
-					}
-					else{
-						alignment[i][j].cValue = left;
-						alignment[i][j].prevCell = 'l';
-					}
-				}
-				else{
-					if(up >= left){
-						alignment[i][j].cValue = up;
-						alignment[i][j].prevCell = 'u';
-					}
-					else{
-						alignment[i][j].cValue = left;
-						alignment[i][j].prevCell = 'l';
-					}
-				}
+		startRows();
+		
+		for(int i=1;i<lB;i++){
+			float* diag = &diagonals[0];
+			int first, last;
+			getBandColumns(i, first, last);
+			for(int j=first;j<=last;j++){
+				if(isEquivalent(seqB[i],seqA[j]))	{	diag[j] = match;	}
+				else                                {	diag[j] = mismatch;	}
 			}
+			
+			fillRow(i);
 		}
-        
-		Overlap over;
-		over.setOverlap(alignment, lA, lB, 0);		//	Fix gaps at the beginning and end of the sequences
-		traceBack();								//	Traceback the alignment to populate seqAaln and seqBaln
-        
+		
+		finishRows();
 	}
 	catch(exception& e) {
 		m->errorOut(e, "NeedlemanOverlap", "alignPrimer");
 		exit(1);
 	}
-    
+}
+/**************************************************************************************************/
+
+void NeedlemanOverlap::startRows(){
+	try {
+		resetTraceMatrix();
+		prevCValues.assign(lA, 0); cValues.assign(lA, 0);
+		diagonals.resize(lA); ups.resize(lA);
+		lastColumnScores.assign(lB, 0);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "NeedlemanOverlap", "startRows");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//fills row i of the scoring matrix from the previous row, diagonals holds the match or mismatch score for each column
+void NeedlemanOverlap::fillRow(int i){
+	try {
+		const float* prevC = &prevCValues[0];
+		float* diag = &diagonals[0];
+		float* up = &ups[0];
+		
+		int first, last;
+		getBandColumns(i, first, last);			//	the whole row unless a band was set
+		
+		for(int j=first;j<=last;j++){			//	the diagonal and up scores only depend on the previous row
+			diag[j] = prevC[j-1] + diag[j];
+			up[j] = prevC[j] + gap;
+		}
+		
+		float* c = &cValues[0];
+		unsigned char* traceRow = getTraceRow(i);
+		float leftC = 0;
+		if (first > 1) { leftC = BAND_EDGE_SCORE; }
+		
+		for(int j=first;j<=last;j++){
+			float diagonal = diag[j];
+			float upValue = up[j];
+			float left = leftC + gap;
+			unsigned char code;
+			
+			if(diagonal >= upValue){
+				if(diagonal >= left){	leftC = diagonal;	code = TRACE_DIAGONAL;	}
+				else{					leftC = left;		code = TRACE_LEFT;		}
+			}
+			else{
+				if(upValue >= left){	leftC = upValue;	code = TRACE_UP;		}
+				else{					leftC = left;		code = TRACE_LEFT;		}
+			}
+			
+			c[j] = leftC;
+			traceRow[(j-1) >> 2] |= (code << (((j-1) & 3) << 1));
+		}
+		
+		if (banded) {							//	the next row reads one cell past the end of this row's band
+			if ((last+1 >= 1) && (last+1 < lA)) { c[last+1] = BAND_EDGE_SCORE; }
+			if ((lA > 1) && ((last != lA-1) || (first > last))) { c[lA-1] = BAND_EDGE_SCORE; }
+		}
+		
+		lastColumnScores[i] = c[lA-1];
+		prevCValues.swap(cValues);
+	}
+	catch(exception& e) {
+		m->errorOut(e, "NeedlemanOverlap", "fillRow");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+void NeedlemanOverlap::finishRows(){
+	try {
+		if (banded) { setBandedLastRow(prevCValues); }
+		else { lastRowScores = prevCValues; }		//	the bottom row, all zero if seqB is empty
+		
+		fixOverlap();								//	Fix gaps at the beginning and end of the sequences
+		traceBack();								//	Traceback the alignment to populate seqAaln and seqBaln
+	}
+	catch(exception& e) {
+		m->errorOut(e, "NeedlemanOverlap", "finishRows");
+		exit(1);
+	}
 }
 //********************************************************************/
 bool NeedlemanOverlap::isEquivalent(char oligo, char seq){
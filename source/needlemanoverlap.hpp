@@ -38,7 +38,11 @@ private:
 	float gap;
 	float match;
 	float mismatch;
+	vector<float> cValues, prevCValues, diagonals, ups; //one row of the scoring matrix, reused between alignments
     bool isEquivalent(char, char);
+	void startRows();
+	void fillRow(int);
+	void finishRows();
 };
 
 /**************************************************************************************************/
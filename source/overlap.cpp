@@ -13,22 +13,21 @@
  *
  */
 
-#include "alignmentcell.hpp"
 #include "overlap.hpp"
 
 
 /**************************************************************************************************/
 
-int Overlap::maxRow(vector<vector<AlignmentCell> >& alignment, const int band){
+int Overlap::maxRow(vector<float>& columnScores, const int band){
 	
 	float max = -100;
 	int end = lA - 1;
 	int index = end;
 	
 	for(int i=band;i<lB;i++){					//	find the row where the right most column has the highest alignment
-		if(alignment[i][end].cValue >= max){	//	score.
+		if(columnScores[i] >= max){				//	score.
 			index = i;
-			max = alignment[i][end].cValue;
+			max = columnScores[i];
 		}
 	}
 	return index;
@@ -36,47 +35,43 @@ int Overlap::maxRow(vector<vector<AlignmentCell> >& alignment, const int band){
 
 /**************************************************************************************************/
 
-int Overlap::maxColumn(vector<vector<AlignmentCell> >& alignment, const int band){
+int Overlap::maxColumn(vector<float>& rowScores, const int band){
 	
 	float max = -100;
 	int end = lB - 1;
 	int index = end;
 	
 	for(int i=band;i<lA;i++){					//	find the column where the bottom most column has the highest
-		if(alignment[end][i].cValue >= max){	//	alignment score.
+		if(rowScores[i] >= max){				//	alignment score.
 			index = i;
-			max = alignment[end][i].cValue;
+			max = rowScores[i];
 		}
 	}
 	return index;
 }
 
 /**************************************************************************************************/
-
-void Overlap::setOverlap(vector<vector<AlignmentCell> >& alignment, const int nA, const int nB, const int band=0){
+//returns 'u' if the cells below index in the right column should point up, 'l' if the cells right of index in the
+//bottom row should point left, or 'x' if the lower right corner is already the best place to end
+char Overlap::setOverlap(vector<float>& rowScores, vector<float>& columnScores, const int nA, const int nB, int& index, const int band=0){
 	
 	lA = nA;
 	lB = nB;	
 	
-	int rowIndex = maxRow(alignment, band);		//	get the index for the row with the highest right hand side score
-	int colIndex = maxColumn(alignment, band);	//	get the index for the column with the highest bottom row score
-		
+	int rowIndex = maxRow(columnScores, band);	//	get the index for the row with the highest right hand side score
+	int colIndex = maxColumn(rowScores, band);	//	get the index for the column with the highest bottom row score
+
 	int row = lB-1;
 	int column = lA-1;
 	
-	if(colIndex == column && rowIndex == row){}	//	if the max values are the lower right corner, then we're good
-	else if(alignment[row][colIndex].cValue < alignment[rowIndex][column].cValue){
-		for(int i=rowIndex+1;i<lB;i++){			//	decide whether sequence A or B needs the gaps at the end either set 
-			alignment[i][column].prevCell = 'u';//	the pointer upwards or...
-		}
-		
-	}
-	else {
-		for(int i=colIndex+1;i<lA;i++){
-			alignment[row][i].prevCell = 'l';	//	...to the left
-		}
+	if(colIndex == column && rowIndex == row){	index = row; return 'x';	}	//	if the max values are the lower right corner, then we're good
+	else if(rowScores[colIndex] < columnScores[rowIndex]){
+		index = rowIndex;						//	decide whether sequence A or B needs the gaps at the end either set
+		return 'u';								//	the pointer upwards or...
 	}
+	
+	index = colIndex;
+	return 'l';									//	...to the left
 }												//	the traceback should take care of the gaps at the 5' end
 
 /**************************************************************************************************/
-
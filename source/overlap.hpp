@@ -25,10 +25,10 @@ class Overlap {
 public:
 	Overlap(){};
 	~Overlap(){};
-	void setOverlap(vector<vector<AlignmentCell> >&, const int, const int, const int);
+	char setOverlap(vector<float>&, vector<float>&, const int, const int, int&, const int); //bottom row scores, right column scores, lA, lB, index, band
 private:
-	int maxRow(vector<vector<AlignmentCell> >&, const int);
-	int maxColumn(vector<vector<AlignmentCell> >&, const int);
+	int maxRow(vector<float>&, const int);
+	int maxColumn(vector<float>&, const int);
 	int lA, lB;
 };
 
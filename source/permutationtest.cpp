@@ -0,0 +1,179 @@
+//
+//  permutationtest.cpp
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "permutationtest.h"
+
+/**************************************************************************************************/
+
+void PermutationStatistic::setGroups(const vector< vector<double> >& matrix, map<string, vector<int> >& groupSampleMap){
+	try {
+		vector< pair<int, int> > samples; //row in matrix, group
+		for (map<string, vector<int> >::iterator it = groupSampleMap.begin(); it != groupSampleMap.end(); it++) {
+			for (int i = 0; i < it->second.size(); i++) { samples.push_back(pair<int, int>(it->second[i], numGroups)); }
+			groupSizes.push_back(it->second.size());
+			numGroups++;
+		}
+		sort(samples.begin(), samples.end());
+
+		int numSamples = samples.size();
+		labels.resize(numSamples);
+		distances.resize((long long)numSamples*(numSamples-1)/2);
+
+		for (int i = 0; i < numSamples; i++) {
+			labels[i] = samples[i].second;
+			double* row = distances.data() + (long long)i*(i-1)/2;
+			for (int j = 0; j < i; j++) { row[j] = matrix[samples[i].first][samples[j].first]; }
+		}
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "PermutationStatistic", "setGroups");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+double PermutationStatistic::getWithinSums(const vector<int>& sampleLabels, vector<double>& sums){
+	sums.assign(numGroups, 0);
+	double between = 0;
+
+	for (int i = 1; i < sampleLabels.size(); i++) {
+		const double* row = distances.data() + (long long)i*(i-1)/2;
+		int group = sampleLabels[i];
+		double within = 0;
+
+		for (int j = 0; j < i; j++) {
+			if (sampleLabels[j] == group)	{	within += row[j];	}
+			else							{	between += row[j];	}
+		}
+		sums[group] += within;
+	}
+
+	return between;
+}
+/**************************************************************************************************/
+
+PermutationTest::PermutationTest(int i, int p) : iters(i), processors(p) {
+	try {
+		m = MothurOut::getInstance();
+		numPermutations = 0;
+		stopAlpha = -1;
+		if (processors < 1) { processors = 1; }
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PermutationTest", "PermutationTest");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+//runs blocks until they are all taken or the test is decided. Each block starts from the original labels, so its
+//result only depends on its seed.
+void driverPermutations(permutationData* params){
+	try {
+		permutationBlocks* blocks = params->blocks;
+		vector<int> labels;
+
+		while (true) {
+
+			int block = 0;
+			{
+				lock_guard<std::mutex> guard(blocks->mutex);
+				if ((blocks->next >= blocks->seeds.size()) || (blocks->decided != -1) || params->m->getControl_pressed()) { break; }
+				block = blocks->next++;
+			}
+
+			mt19937_64 engine(blocks->seeds[block]);
+			labels = params->labels;
+
+			int count = 0;
+			for (int i = 0; i < blocks->sizes[block]; i++) {
+				shuffle(labels.begin(), labels.end(), engine);
+
+				double value = params->statistic->getStatistic(labels);
+
+				if (params->greater)	{	if (value >= params->observed) { count++; }	}
+				else					{	if (value <= params->observed) { count++; }	}
+			}
+
+			lock_guard<std::mutex> guard(blocks->mutex);
+			blocks->counts[block] = count;
+
+			//the test is decided when the finished blocks at the start reach the limit
+			if ((blocks->stopLimit >= 0) && (blocks->decided == -1)) {
+				double total = 0;
+				for (int b = 0; b < blocks->counts.size(); b++) {
+					if (blocks->counts[b] == -1) { break; }
+					total += blocks->counts[b];
+					if (total > blocks->stopLimit) { blocks->decided = b; break; }
+				}
+			}
+		}
+	}
+	catch(exception& e) {
+		params->m->errorOut(e, "PermutationTest", "driverPermutations");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+double PermutationTest::getPValue(PermutationStatistic* statistic, const vector<int>& labels, double observed, bool greater){
+	try {
+		numPermutations = 0;
+		if (iters < 1) { return 0; }
+
+		permutationBlocks blocks;
+		for (int i = 0; i < iters; i += PERMUTATION_BLOCK_SIZE) {
+			blocks.seeds.push_back((unsigned long long)util.getRandomNumber());
+			blocks.sizes.push_back(min(PERMUTATION_BLOCK_SIZE, iters-i));
+		}
+		blocks.counts.resize(blocks.seeds.size(), -1);
+
+		//once more than alpha * iters permutations are as extreme, the p-value can't drop below alpha
+		if (stopAlpha > 0) { blocks.stopLimit = stopAlpha * iters; }
+
+		int numThreads = min(processors, (int)blocks.seeds.size());
+
+		vector<thread*> workerThreads;
+		vector<permutationData*> data;
+
+		for (int i = 1; i < numThreads; i++) {
+			permutationData* dataBundle = new permutationData(statistic, &blocks, labels, observed, greater);
+			data.push_back(dataBundle);
+			workerThreads.push_back(new thread(driverPermutations, dataBundle));
+		}
+
+		permutationData* dataBundle = new permutationData(statistic, &blocks, labels, observed, greater);
+		driverPermutations(dataBundle);
+		delete dataBundle;
+
+		for (int i = 0; i < workerThreads.size(); i++) {
+			workerThreads[i]->join();
+			delete data[i];
+			delete workerThreads[i];
+		}
+
+		//blocks past the deciding one may have been run by other threads, they are ignored
+		int lastBlock = blocks.seeds.size()-1;
+		if (blocks.decided != -1) { lastBlock = blocks.decided; }
+
+		double count = 0;
+		for (int b = 0; b <= lastBlock; b++) {
+			if (blocks.counts[b] == -1) { break; } //only if control was pressed
+			count += blocks.counts[b];
+			numPermutations += blocks.sizes[b];
+		}
+
+		if (numPermutations == 0) { return 0; }
+
+		return count / (double) numPermutations;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "PermutationTest", "getPValue");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
@@ -0,0 +1,100 @@
+#ifndef Mothur_permutationtest_h
+#define Mothur_permutationtest_h
+
+//
+//  permutationtest.h
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "mothurout.h"
+#include "utils.hpp"
+
+#define PERMUTATION_BLOCK_SIZE 100  //permutations run from one seed, the unit of work handed to a thread
+
+/**************************************************************************************************/
+//the value tested by a permutation test, calculated from the label (group) of each sample. getStatistic is called
+//by several threads at once, so it must not change the object.
+class PermutationStatistic {
+
+public:
+	PermutationStatistic() : numGroups(0) {}
+	virtual ~PermutationStatistic() {}
+
+	virtual double getStatistic(const vector<int>&) = 0;
+	vector<int> getLabels() { return labels; } //the observed labels, set by setGroups
+
+protected:
+	//for tests of groups of samples from a distance matrix. Fills labels, groupSizes and distances for the samples in the
+	//groups, in matrix order.
+	void setGroups(const vector< vector<double> >&, map<string, vector<int> >&);
+	double getWithinSums(const vector<int>&, vector<double>&); //labels, sums by group. Returns the sum between groups
+
+	vector<int> labels, groupSizes;
+	vector<double> distances; //lower triangle of the samples' distances, row i starts at i*(i-1)/2
+	int numGroups;
+};
+
+/**************************************************************************************************/
+//Shuffles the labels iters times and counts the shuffles whose statistic is at least as extreme as the observed value.
+//The permutations are run in blocks, each with its own seed drawn in block order, so the p-value does not depend on the
+//number of processors.
+class PermutationTest {
+
+public:
+	PermutationTest(int, int); //iters, processors
+	~PermutationTest() {}
+
+	//the permutations stop once the p-value can no longer fall below alpha, the p-value is then from the permutations run
+	void setEarlyStop(double alpha) { stopAlpha = alpha; }
+
+	//statistic, labels, observed value, true if larger values are more extreme. Returns the p-value
+	double getPValue(PermutationStatistic*, const vector<int>&, double, bool);
+	int getNumPermutations() { return numPermutations; } //permutations run by the last getPValue
+
+private:
+	MothurOut* m;
+	Utils util;
+	int iters, processors, numPermutations;
+	double stopAlpha;
+};
+
+/**************************************************************************************************/
+//shared by the threads running one test
+struct permutationBlocks {
+	vector<unsigned long long> seeds;
+	vector<int> sizes, counts; //counts are -1 until the block is run
+	int next;       //next block to hand out
+	int decided;    //block where the test was decided, -1 if it hasn't been
+	double stopLimit; //count that decides the test, -1 to run every block
+	std::mutex mutex;
+
+	permutationBlocks() : next(0), decided(-1), stopLimit(-1) {}
+};
+
+/**************************************************************************************************/
+
+struct permutationData {
+	PermutationStatistic* statistic;
+	permutationBlocks* blocks;
+	vector<int> labels;
+	double observed;
+	bool greater;
+	MothurOut* m;
+
+	permutationData(){}
+	permutationData(PermutationStatistic* s, permutationBlocks* b, const vector<int>& l, double o, bool g) {
+		m = MothurOut::getInstance();
+		statistic = s;
+		blocks = b;
+		labels = l;
+		observed = o;
+		greater = g;
+	}
+};
+
+/**************************************************************************************************/
+
+#endif
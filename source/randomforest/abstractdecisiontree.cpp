@@ -10,37 +10,34 @@
 
 /**************************************************************************************************/
 
-AbstractDecisionTree::AbstractDecisionTree(vector<vector<int> >& baseDataSet,
-                                         vector<int> globalDiscardedFeatureIndices,
+AbstractDecisionTree::AbstractDecisionTree(const RFDataSet& dataSet,
+                                         const vector<int>& globalDiscardedFeatureIndices,
                                          OptimumFeatureSubsetSelector optimumFeatureSubsetSelector, 
-                                         string treeSplitCriterion)
+                                         string treeSplitCriterion,
+                                         unsigned long long seed)
 
-                    : baseDataSet(baseDataSet),
-                    numSamples((int)baseDataSet.size()),
-                    numFeatures((int)(baseDataSet[0].size() - 1)),
-                    numOutputClasses(0),
+                    : dataSet(dataSet),
+                    numSamples(dataSet.getNumSamples()),
+                    numFeatures(dataSet.getNumFeatures()),
+                    numOutputClasses(dataSet.getNumOutputClasses()),
                     rootNode(NULL),
                     nodeIdCount(0),
                     globalDiscardedFeatureIndices(globalDiscardedFeatureIndices),
                     optimumFeatureSubsetSize(optimumFeatureSubsetSelector.getOptimumFeatureSubsetSize(numFeatures)),
-                    treeSplitCriterion(treeSplitCriterion) {
+                    treeSplitCriterion(treeSplitCriterion),
+                    engine(seed) {
 
     try {
-        // TODO: istead of calculating this for every DecisionTree
-        // clacualte this once in the RandomForest class and pass the values
         m = MothurOut::getInstance();
-        for (int i = 0;  i < numSamples; i++) {
-            if (m->getControl_pressed()) { break; }
-            int outcome = baseDataSet[i][numFeatures];
-            vector<int>::iterator it = find(outputClasses.begin(), outputClasses.end(), outcome);
-            if (it == outputClasses.end()){       // find() will return classes.end() if the element is not found
-                outputClasses.push_back(outcome);
-                numOutputClasses++;
-            }
-        }
+        
+        isGlobalDiscardedFeature.resize(numFeatures, false);
+        for (int i = 0; i < globalDiscardedFeatureIndices.size(); i++) { isGlobalDiscardedFeature[globalDiscardedFeatureIndices[i]] = true; }
+        
+        nodeSampleCounts.resize(numSamples, 0);
+        lessClassCounts.resize(numOutputClasses, 0);
+        greaterClassCounts.resize(numOutputClasses, 0);
         
         if (m->getDebug()) {
-            //m->mothurOut("outputClasses = " + toStringVectorInt(outputClasses));
             m->mothurOut("numOutputClasses = " + toString(numOutputClasses) + '\n');
         }
 
@@ -54,35 +51,18 @@ AbstractDecisionTree::AbstractDecisionTree(vector<vector<int> >& baseDataSet,
 int AbstractDecisionTree::createBootStrappedSamples(){
     try {    
         vector<bool> isInTrainingSamples(numSamples, false);
-        Utils util;
+        uniform_int_distribution<int> dis(0, numSamples-1);
         for (int i = 0; i < numSamples; i++) {
             if (m->getControl_pressed()) { return 0; }
         
-            int randomIndex = util.getRandomIndex(numSamples-1);
-            bootstrappedTrainingSamples.push_back(baseDataSet[randomIndex]);
+            int randomIndex = dis(engine);
+            bootstrappedTrainingSamples.push_back(randomIndex);
             isInTrainingSamples[randomIndex] = true;
         }
         
         for (int i = 0; i < numSamples; i++) {
-            if (m->getControl_pressed()) { return 0; }
             if (isInTrainingSamples[i]){ bootstrappedTrainingSampleIndices.push_back(i); }
-            else{
-                bootstrappedTestSamples.push_back(baseDataSet[i]);
-                bootstrappedTestSampleIndices.push_back(i);
-            }
-        }
-        
-            // do the transpose of Test Samples
-        for (int i = 0; i < bootstrappedTestSamples[0].size(); i++) {
-            if (m->getControl_pressed()) { return 0; }
-            
-            vector<int> tmpFeatureVector(bootstrappedTestSamples.size(), 0);
-            for (int j = 0; j < bootstrappedTestSamples.size(); j++) {
-                if (m->getControl_pressed()) { return 0; }
-                
-                tmpFeatureVector[j] = bootstrappedTestSamples[j][i];
-            }
-            testSampleFeatureVectors.push_back(tmpFeatureVector);
+            else{ bootstrappedTestSampleIndices.push_back(i); }
         }
         
         return 0;
@@ -93,54 +73,55 @@ int AbstractDecisionTree::createBootStrappedSamples(){
 	} 
 }
 /**************************************************************************************************/
-int AbstractDecisionTree::getMinEntropyOfFeature(vector<int> featureVector,
-                                                 vector<int> outputVector,
+//nodeSampleCounts must hold the node's samples. Walks the feature's presorted samples, so each split point between
+//two values is scored from running class counts instead of sorting and recounting the node's samples.
+int AbstractDecisionTree::getMinEntropyOfFeature(RFTreeNode* node,
+                                                 int featureIndex,
                                                  double& minEntropy,
                                                  int& featureSplitValue,
                                                  double& intrinsicValue){
     try {
-
-        vector< pair<int, int> > featureOutputPair(featureVector.size(), pair<int, int>(0, 0));
-        
-        for (int i = 0; i < featureVector.size(); i++) { 
-            if (m->getControl_pressed()) { return 0; }
+        const vector<int>& sortedSamples = dataSet.getSortedSamples(featureIndex);
+        const vector<int>& featureVector = dataSet.getFeatureVector(featureIndex);
+        int numNodeSamples = node->getNumSamples();
+        
+        fill(lessClassCounts.begin(), lessClassCounts.end(), 0);
+        fill(greaterClassCounts.begin(), greaterClassCounts.end(), 0);
+        const vector<int>& outputVector = node->getBootstrappedOutputVector();
+        for (int i = 0; i < outputVector.size(); i++) { greaterClassCounts[outputVector[i]]++; }
+        
+        minEntropy = numeric_limits<double>::infinity();
+        intrinsicValue = numeric_limits<double>::infinity();
+        featureSplitValue = -1;
+        
+        int numLessThanValueAtSplitPoint = 0;
+        int previousValue = 0;
+        for (int i = 0; i < sortedSamples.size(); i++) {
+            int sample = sortedSamples[i];
+            int count = nodeSampleCounts[sample];
+            if (count == 0) { continue; }
             
-            featureOutputPair[i].first = featureVector[i];
-            featureOutputPair[i].second = outputVector[i];
-        }
-        // TODO: using default behavior to sort(), need to specify the comparator for added safety and compiler portability,
-        
-        IntPairVectorSorter intPairVectorSorter;
-        sort(featureOutputPair.begin(), featureOutputPair.end(), intPairVectorSorter);
-        
-        vector<int> splitPoints;
-        vector<int> uniqueFeatureValues(1, featureOutputPair[0].first);
-        
-        for (int i = 0; i < featureOutputPair.size(); i++) {
-
-            if (m->getControl_pressed()) { return 0; }
-            int featureValue = featureOutputPair[i].first;
-
-            vector<int>::iterator it = find(uniqueFeatureValues.begin(), uniqueFeatureValues.end(), featureValue);
-            if (it == uniqueFeatureValues.end()){                 // NOT FOUND
-                uniqueFeatureValues.push_back(featureValue);
-                splitPoints.push_back(i);
+            int featureValue = featureVector[sample];
+            if ((numLessThanValueAtSplitPoint != 0) && (featureValue != previousValue)) { //split point
+                int numGreaterThanValueAtSplitPoint = numNodeSamples - numLessThanValueAtSplitPoint;
+                
+                double upperEntropyOfSplit = calcSplitEntropy(lessClassCounts, numLessThanValueAtSplitPoint);
+                double lowerEntropyOfSplit = calcSplitEntropy(greaterClassCounts, numGreaterThanValueAtSplitPoint);
+                
+                double totalEntropy = (numLessThanValueAtSplitPoint * upperEntropyOfSplit + numGreaterThanValueAtSplitPoint * lowerEntropyOfSplit) / (double)numNodeSamples;
+                
+                if (totalEntropy < minEntropy) {
+                    minEntropy = totalEntropy;                                                                                                      // OUTPUT
+                    intrinsicValue = calcIntrinsicValue(numLessThanValueAtSplitPoint, numGreaterThanValueAtSplitPoint, numNodeSamples);     // OUTPUT
+                    featureSplitValue = featureValue;                                                                                       // OUTPUT
+                }
             }
-        }
-        
-
-        
-        int bestSplitIndex = -1;
-        if (splitPoints.size() == 0){
-            // TODO: trying out C++'s infitinity, don't know if this will work properly
-            // TODO: check the caller function of this function, there check the value if minEntropy and comapre to inf
-            // so that no wrong calculation is done
-            minEntropy = numeric_limits<double>::infinity();                          // OUTPUT
-            intrinsicValue = numeric_limits<double>::infinity();                      // OUTPUT
-            featureSplitValue = -1;                                                   // OUTPUT
-        }else{
-            getBestSplitAndMinEntropy(featureOutputPair, splitPoints, minEntropy, bestSplitIndex, intrinsicValue);  // OUTPUT
-            featureSplitValue = featureOutputPair[splitPoints[bestSplitIndex]].first;    // OUTPUT
+            
+            int outcome = dataSet.getOutcome(sample);
+            lessClassCounts[outcome] += count;
+            greaterClassCounts[outcome] -= count;
+            numLessThanValueAtSplitPoint += count;
+            previousValue = featureValue;
         }
         
         return 0;
@@ -172,76 +153,11 @@ double AbstractDecisionTree::calcIntrinsicValue(int numLessThanValueAtSplitPoint
 }
 /**************************************************************************************************/
 
-int AbstractDecisionTree::getBestSplitAndMinEntropy(vector< pair<int, int> > featureOutputPairs, vector<int> splitPoints,
-                                                    double& minEntropy, int& minEntropyIndex, double& relatedIntrinsicValue){
+double AbstractDecisionTree::calcSplitEntropy(const vector<int>& classCounts, int totalClassCounts) {
     try {
-        
-        int numSamples = (int)featureOutputPairs.size();
-        vector<double> entropies;
-        vector<double> intrinsicValues;
-        
-        for (int i = 0; i < splitPoints.size(); i++) {
-            if (m->getControl_pressed()) { return 0; }
-            int index = splitPoints[i];
-            int valueAtSplitPoint = featureOutputPairs[index].first;
-
-            int numLessThanValueAtSplitPoint = 0;
-            int numGreaterThanValueAtSplitPoint = 0;
-            
-            for (int j = 0; j < featureOutputPairs.size(); j++) {
-                if (m->getControl_pressed()) { return 0; }
-                pair<int, int> record = featureOutputPairs[j];
-                if (record.first < valueAtSplitPoint){ numLessThanValueAtSplitPoint++; }
-                else{ numGreaterThanValueAtSplitPoint++; }
-            }
-            
-            double upperEntropyOfSplit = calcSplitEntropy(featureOutputPairs, index, numOutputClasses, true);
-            double lowerEntropyOfSplit = calcSplitEntropy(featureOutputPairs, index, numOutputClasses, false);
-            
-            double totalEntropy = (numLessThanValueAtSplitPoint * upperEntropyOfSplit + numGreaterThanValueAtSplitPoint * lowerEntropyOfSplit) / (double)numSamples;
-            double intrinsicValue = calcIntrinsicValue(numLessThanValueAtSplitPoint, numGreaterThanValueAtSplitPoint, numSamples);
-            entropies.push_back(totalEntropy);
-            intrinsicValues.push_back(intrinsicValue);
-            
-        }
-                
-        // set output values
-        vector<double>::iterator it = min_element(entropies.begin(), entropies.end());
-        minEntropy = *it;                                                         // OUTPUT
-        minEntropyIndex = (int)(it - entropies.begin());                          // OUTPUT
-        relatedIntrinsicValue = intrinsicValues[minEntropyIndex];                 // OUTPUT
-        
-        return 0;
-    }
-	catch(exception& e) {
-		m->errorOut(e, "AbstractDecisionTree", "getBestSplitAndMinEntropy");
-		exit(1);
-	} 
-}
-/**************************************************************************************************/
-
-double AbstractDecisionTree::calcSplitEntropy(vector< pair<int, int> > featureOutputPairs, int splitIndex, int numOutputClasses, bool isUpperSplit = true) {
-    try {
-        vector<int> classCounts(numOutputClasses, 0);
-        
-        if (isUpperSplit) { 
-            for (int i = 0; i < splitIndex; i++) {
-                if (m->getControl_pressed()) { return 0; }
-                classCounts[featureOutputPairs[i].second]++;
-            }
-        } else {
-            for (int i = splitIndex; i < featureOutputPairs.size(); i++) { 
-                if (m->getControl_pressed()) { return 0; }
-                classCounts[featureOutputPairs[i].second]++;
-            }
-        }
-        
-        int totalClassCounts = accumulate(classCounts.begin(), classCounts.end(), 0);
-        
         double splitEntropy = 0.0;
         
         for (int i = 0; i < classCounts.size(); i++) {
-            if (m->getControl_pressed()) { return 0; }
             if (classCounts[i] == 0) { continue; }
             double probability = (double) classCounts[i] / (double) totalClassCounts;
             splitEntropy += -(probability * log2(probability));
@@ -257,24 +173,14 @@ double AbstractDecisionTree::calcSplitEntropy(vector< pair<int, int> > featureOu
 
 /**************************************************************************************************/
 
-int AbstractDecisionTree::getSplitPopulation(RFTreeNode* node, vector< vector<int> >& leftChildSamples, vector< vector<int> >& rightChildSamples){    
+int AbstractDecisionTree::getSplitPopulation(RFTreeNode* node, vector<int>& leftChildSamples, vector<int>& rightChildSamples){    
     try {
-        // TODO: there is a possibility of optimization if we can recycle the samples in each nodes
-        // we just need to pointers to the samples i.e. vector<int> and use it everywhere and not create the sample 
-        // sample over and over again
-        // we need to make this const so that it is not modified by all the function calling
-        // currently purgeTreeNodesDataRecursively() is used for the same purpose, but this can be avoided altogher
-        // if re-using the same data over the classes
-        
         int splitFeatureGlobalIndex = node->getSplitFeatureIndex();
+        const vector<int>& samples = node->getBootstrappedTrainingSamples();
         
-        for (int i = 0; i < node->getBootstrappedTrainingSamples().size(); i++) {
-            if (m->getControl_pressed()) { return 0; }
-            vector<int> sample =  node->getBootstrappedTrainingSamples()[i];
-            if (m->getControl_pressed()) { return 0; }
-            
-            if (sample[splitFeatureGlobalIndex] < node->getSplitFeatureValue()) { leftChildSamples.push_back(sample); }
-            else { rightChildSamples.push_back(sample); }
+        for (int i = 0; i < samples.size(); i++) {
+            if (dataSet.getValue(splitFeatureGlobalIndex, samples[i]) < node->getSplitFeatureValue()) { leftChildSamples.push_back(samples[i]); }
+            else { rightChildSamples.push_back(samples[i]); }
         }
         
         return 0;
@@ -285,24 +191,15 @@ int AbstractDecisionTree::getSplitPopulation(RFTreeNode* node, vector< vector<in
 	} 
 }
 /**************************************************************************************************/
-// TODO: checkIfAlreadyClassified() verify code
-// TODO: use bootstrappedOutputVector for easier calculation instead of using getBootstrappedTrainingSamples()
 bool AbstractDecisionTree::checkIfAlreadyClassified(RFTreeNode* treeNode, int& outputClass) {
     try {
-
-        vector<int> tempOutputClasses;
-        for (int i = 0; i < treeNode->getBootstrappedTrainingSamples().size(); i++) {
-            if (m->getControl_pressed()) { return 0; }
-            int sampleOutputClass = treeNode->getBootstrappedTrainingSamples()[i][numFeatures];
-            vector<int>::iterator it = find(tempOutputClasses.begin(), tempOutputClasses.end(), sampleOutputClass);
-            if (it == tempOutputClasses.end()) {               // NOT FOUND
-                tempOutputClasses.push_back(sampleOutputClass);
-            }
-        }
+        const vector<int>& outputVector = treeNode->getBootstrappedOutputVector();
         
-        if (tempOutputClasses.size() < 2) { outputClass = tempOutputClasses[0]; return true; }
-        else { outputClass = -1; return false; }
+        for (int i = 1; i < outputVector.size(); i++) {
+            if (outputVector[i] != outputVector[0]) { outputClass = -1; return false; }
+        }
         
+        outputClass = outputVector[0]; return true;
     }
 	catch(exception& e) {
 		m->errorOut(e, "AbstractDecisionTree", "checkIfAlreadyClassified");
@@ -18,55 +18,48 @@
 
 /**************************************************************************************************/
 
-struct IntPairVectorSorter{
-    bool operator() (const pair<int, int>& firstPair, const pair<int, int>& secondPair) {
-        return firstPair.first < secondPair.first;
-    }
-};
-
-/**************************************************************************************************/
-
 class AbstractDecisionTree{
   
 public:
   
-    AbstractDecisionTree(vector<vector<int> >& baseDataSet,
-                           vector<int> globalDiscardedFeatureIndices, 
+    AbstractDecisionTree(const RFDataSet& dataSet,
+                           const vector<int>& globalDiscardedFeatureIndices, 
                            OptimumFeatureSubsetSelector optimumFeatureSubsetSelector, 
-                           string treeSplitCriterion);    
+                           string treeSplitCriterion,
+                           unsigned long long seed);    
     virtual ~AbstractDecisionTree(){}
     
   
 protected:
   
     virtual int createBootStrappedSamples();
-    virtual int getMinEntropyOfFeature(vector<int> featureVector, vector<int> outputVector, double& minEntropy, int& featureSplitValue, double& intrinsicValue);
-        virtual int getBestSplitAndMinEntropy(vector< pair<int, int> > featureOutputPairs, vector<int> splitPoints, double& minEntropy, int& minEntropyIndex, double& relatedIntrinsicValue);
+    virtual int getMinEntropyOfFeature(RFTreeNode* node, int featureIndex, double& minEntropy, int& featureSplitValue, double& intrinsicValue);
     virtual double calcIntrinsicValue(int numLessThanValueAtSplitPoint, int numGreaterThanValueAtSplitPoint, int numSamples);
-    virtual double calcSplitEntropy(vector< pair<int, int> > featureOutputPairs, int splitIndex, int numOutputClasses, bool);
+    virtual double calcSplitEntropy(const vector<int>& classCounts, int totalClassCounts);
 
-    virtual int getSplitPopulation(RFTreeNode* node, vector< vector<int> >& leftChildSamples, vector< vector<int> >& rightChildSamples);
+    virtual int getSplitPopulation(RFTreeNode* node, vector<int>& leftChildSamples, vector<int>& rightChildSamples);
     virtual bool checkIfAlreadyClassified(RFTreeNode* treeNode, int& outputClass);
 
-    vector< vector<int> >& baseDataSet;
+    const RFDataSet& dataSet;
     int numSamples;
     int numFeatures;
     int numOutputClasses;
-    vector<int> outputClasses;
     
-    vector< vector<int> > bootstrappedTrainingSamples;
+    vector<int> bootstrappedTrainingSamples; //indexes in dataSet of the bootstrap sample, with repeats
     vector<int> bootstrappedTrainingSampleIndices;
-    vector< vector<int> > bootstrappedTestSamples;
     vector<int> bootstrappedTestSampleIndices;
     
-    vector<vector<int> > testSampleFeatureVectors;
-    
     RFTreeNode* rootNode;
     int nodeIdCount;
     map<int, int> nodeMisclassificationCounts;
     vector<int> globalDiscardedFeatureIndices;
+    vector<bool> isGlobalDiscardedFeature; //[numFeatures]
     int optimumFeatureSubsetSize;
     string treeSplitCriterion;
+    mt19937_64 engine; //all the random choices of the tree, so it only depends on its seed
+    
+    vector<int> nodeSampleCounts; //[numSamples] times each sample is in the node being split
+    vector<int> lessClassCounts, greaterClassCounts; //[numOutputClasses] scratch for getMinEntropyOfFeature
     MothurOut* m;
   
 private:
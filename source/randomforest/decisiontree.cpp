@@ -9,17 +9,21 @@
 #include "decisiontree.hpp"
 #include "utils.hpp"
 
-DecisionTree::DecisionTree(vector< vector<int> >& baseDataSet,
-                           vector<int> globalDiscardedFeatureIndices,
+DecisionTree::DecisionTree(const RFDataSet& dataSet,
+                           const vector<int>& globalDiscardedFeatureIndices,
                            OptimumFeatureSubsetSelector optimumFeatureSubsetSelector,
                            string treeSplitCriterion,
-                           float featureStandardDeviationThreshold)
-            : AbstractDecisionTree(baseDataSet,
+                           float featureStandardDeviationThreshold,
+                           unsigned long long seed)
+            : AbstractDecisionTree(dataSet,
                                    globalDiscardedFeatureIndices,
                                    optimumFeatureSubsetSelector,
-                                   treeSplitCriterion),
+                                   treeSplitCriterion,
+                                   seed),
             variableImportanceList(numFeatures, 0),
-            featureStandardDeviationThreshold(featureStandardDeviationThreshold) {
+            featureStandardDeviationThreshold(featureStandardDeviationThreshold),
+            featureCheckedNodeId(numFeatures, -1),
+            isLocalDiscardedFeature(numFeatures, false) {
                 
     try {
         m = MothurOut::getInstance();
@@ -34,63 +38,42 @@ DecisionTree::DecisionTree(vector< vector<int> >& baseDataSet,
 
 /***********************************************************************/
 
+//Only the features the tree splits on can change its predictions, so only they are shuffled. Each feature is shuffled
+//on its own, with the others at their real values.
 int DecisionTree::calcTreeVariableImportanceAndError(int& numCorrect, double& treeErrorRate) {
     try {
-        vector< vector<int> > randomlySampledTestData(bootstrappedTestSamples.size(), vector<int>(bootstrappedTestSamples[0].size(), 0));
+        set<int> splitFeatures;
+        getSplitFeatures(rootNode, splitFeatures);
         
-            // TODO: is is possible to further speed up the following O(N^2) by using std::copy?
-        for (int i = 0; i < bootstrappedTestSamples.size(); i++) {
-            for (int j = 0; j < bootstrappedTestSamples[i].size(); j++) {
-                randomlySampledTestData[i][j] = bootstrappedTestSamples[i][j];
-            }
-        }
-        Utils util;
-        for (int i = 0; i < numFeatures; i++) {
+        int numTestSamples = bootstrappedTestSampleIndices.size();
+        vector<int> shuffledValues(numTestSamples, 0);
+        
+        for (set<int>::iterator it = splitFeatures.begin(); it != splitFeatures.end(); it++) {
             if (m->getControl_pressed()) { return 0; }
             
-                // if the index is in globalDiscardedFeatureIndices (i.e, null feature) we don't want to shuffle them
-            vector<int>::iterator it = find(globalDiscardedFeatureIndices.begin(), globalDiscardedFeatureIndices.end(), i);
-            if (it == globalDiscardedFeatureIndices.end()) {        // NOT FOUND
-                // if the standard deviation is very low, we know it's not a good feature at all
-                // we can save some time here by discarding that feature
+            int featureIndex = *it;
+            
+            // if the index is in globalDiscardedFeatureIndices (i.e, null feature) we don't want to shuffle them
+            if (isGlobalDiscardedFeature[featureIndex]) { continue; }
+            
+            // if the standard deviation is very low, we know it's not a good feature at all
+            // we can save some time here by discarding that feature
+            if (dataSet.getStandardDeviation(featureIndex, bootstrappedTestSampleIndices) > featureStandardDeviationThreshold) {
+                //This randomizes abundances for a given OTU/feature.
+                for (int j = 0; j < numTestSamples; j++) { shuffledValues[j] = dataSet.getValue(featureIndex, bootstrappedTestSampleIndices[j]); }
+                shuffle(shuffledValues.begin(), shuffledValues.end(), engine);
                 
-                vector<int> featureVector = testSampleFeatureVectors[i];
-                if (util.getStandardDeviation(featureVector) > featureStandardDeviationThreshold) {
-                    // NOTE: only shuffle the features, never shuffle the output vector
-                    // so i = 0 and i will be alwaays <= (numFeatures - 1) as the index at numFeatures will denote
-                    // the feature vector
-                    randomlyShuffleAttribute(bootstrappedTestSamples, i, i - 1, randomlySampledTestData);
-
-                    int numCorrectAfterShuffle = 0;
-                    for (int j = 0; j < randomlySampledTestData.size(); j++) {
-                        if (m->getControl_pressed()) {return 0; }
-                        
-                        vector<int> shuffledSample = randomlySampledTestData[j];
-                        int actualSampleOutputClass = shuffledSample[numFeatures];
-                        int predictedSampleOutputClass = evaluateSample(shuffledSample);
-                        if (actualSampleOutputClass == predictedSampleOutputClass) { numCorrectAfterShuffle++; }
-                    }
-                    variableImportanceList[i] += (numCorrect - numCorrectAfterShuffle);
+                int numCorrectAfterShuffle = 0;
+                for (int j = 0; j < numTestSamples; j++) {
+                    int sampleIndex = bootstrappedTestSampleIndices[j];
+                    int actualSampleOutputClass = dataSet.getOutcome(sampleIndex);
+                    int predictedSampleOutputClass = evaluateSample(sampleIndex, featureIndex, shuffledValues[j]);
+                    if (actualSampleOutputClass == predictedSampleOutputClass) { numCorrectAfterShuffle++; }
                 }
+                variableImportanceList[featureIndex] += (numCorrect - numCorrectAfterShuffle);
             }
         }
         
-        // TODO: do we need to save the variableRanks in the DecisionTree, do we need it later?
-        vector< pair<int, int> > variableRanks;
-        
-        for (int i = 0; i < variableImportanceList.size(); i++) {
-            if (m->getControl_pressed()) {return 0; }
-            if (variableImportanceList[i] > 0) {
-                // TODO: is there a way to optimize the follow line's code?
-                pair<int, int> variableRank(0, 0);
-                variableRank.first = i;
-                variableRank.second = variableImportanceList[i];
-                variableRanks.push_back(variableRank);
-            }
-        }
-        VariableRankDescendingSorter variableRankDescendingSorter;
-        sort(variableRanks.begin(), variableRanks.end(), variableRankDescendingSorter);
-        
         return 0;
     }
 	catch(exception& e) {
@@ -101,20 +84,15 @@ int DecisionTree::calcTreeVariableImportanceAndError(int& numCorrect, double& tr
 }
 /***********************************************************************/
 
-// TODO: there must be a way to optimize this function
-int DecisionTree::evaluateSample(vector<int> testSample) {
+int DecisionTree::evaluateSample(int sampleIndex) {
     try {
         RFTreeNode *node = rootNode;
-        while (true) {
-            if (m->getControl_pressed()) { return 0; }
-            
-            if (node->checkIsLeaf()) { return node->getOutputClass(); }
-            
-            int sampleSplitFeatureValue = testSample[node->getSplitFeatureIndex()];
+        while (!node->checkIsLeaf()) {
+            int sampleSplitFeatureValue = dataSet.getValue(node->getSplitFeatureIndex(), sampleIndex);
             if (sampleSplitFeatureValue < node->getSplitFeatureValue()) { node = node->getLeftChildNode(); }
             else { node = node->getRightChildNode(); } 
         }
-        return 0;
+        return node->getOutputClass();
     }
 	catch(exception& e) {
 		m->errorOut(e, "DecisionTree", "evaluateSample");
@@ -124,24 +102,42 @@ int DecisionTree::evaluateSample(vector<int> testSample) {
 }
 /***********************************************************************/
 
+int DecisionTree::evaluateSample(int sampleIndex, int featureIndex, int featureValue) {
+    try {
+        RFTreeNode *node = rootNode;
+        while (!node->checkIsLeaf()) {
+            int sampleSplitFeatureValue = featureValue;
+            if (node->getSplitFeatureIndex() != featureIndex) { sampleSplitFeatureValue = dataSet.getValue(node->getSplitFeatureIndex(), sampleIndex); }
+            if (sampleSplitFeatureValue < node->getSplitFeatureValue()) { node = node->getLeftChildNode(); }
+            else { node = node->getRightChildNode(); }
+        }
+        return node->getOutputClass();
+    }
+	catch(exception& e) {
+		m->errorOut(e, "DecisionTree", "evaluateSample");
+		exit(1);
+	}
+    
+}
+/***********************************************************************/
+
 int DecisionTree::calcTreeErrorRate(int& numCorrect, double& treeErrorRate){
     numCorrect = 0;
     try {
-        for (int i = 0; i < bootstrappedTestSamples.size(); i++) {
+        for (int i = 0; i < bootstrappedTestSampleIndices.size(); i++) {
              if (m->getControl_pressed()) {return 0; }
             
-            vector<int> testSample = bootstrappedTestSamples[i];
             int testSampleIndex = bootstrappedTestSampleIndices[i];
             
-            int actualSampleOutputClass = testSample[numFeatures];
-            int predictedSampleOutputClass = evaluateSample(testSample);
+            int actualSampleOutputClass = dataSet.getOutcome(testSampleIndex);
+            int predictedSampleOutputClass = evaluateSample(testSampleIndex);
             
             if (actualSampleOutputClass == predictedSampleOutputClass) { numCorrect++; } 
             
             outOfBagEstimates[testSampleIndex] = predictedSampleOutputClass;
         }
         
-        treeErrorRate = 1 - ((double)numCorrect / (double)bootstrappedTestSamples.size());   
+        treeErrorRate = 1 - ((double)numCorrect / (double)bootstrappedTestSampleIndices.size());   
         
         return 0;
     }
@@ -151,54 +147,12 @@ int DecisionTree::calcTreeErrorRate(int& numCorrect, double& treeErrorRate){
 	} 
 }
 
-/***********************************************************************/
-// TODO: optimize the algo, instead of transposing two time, we can extarct the feature,
-// shuffle it and then re-insert in the original place, thus iproving runnting time
-//This function randomize abundances for a given OTU/feature.
-
-void DecisionTree::randomlyShuffleAttribute(const vector< vector<int> >& samples,
-                               const int featureIndex,
-                               const int prevFeatureIndex,
-                               vector< vector<int> >& shuffledSample) {
-    try {
-        // NOTE: we need (numFeatures + 1) featureVecotors, the last extra vector is actually outputVector
-        
-        // restore previously shuffled feature
-        if (prevFeatureIndex > -1) {
-            for (int j = 0; j < samples.size(); j++) {
-                if (m->getControl_pressed()) { return; }
-                shuffledSample[j][prevFeatureIndex] = samples[j][prevFeatureIndex];
-            }
-        }
-        
-        // now do the shuffling
-        vector<int> featureVectors(samples.size(), 0);
-        for (int j = 0; j < samples.size(); j++) {
-            if (m->getControl_pressed()) { return; }
-            featureVectors[j] = samples[j][featureIndex];
-        }
-        Utils util; util.mothurRandomShuffle(featureVectors);
-        for (int j = 0; j < samples.size(); j++) {
-            if (m->getControl_pressed()) { return; }
-            shuffledSample[j][featureIndex] = featureVectors[j];
-        }
-    }
-	catch(exception& e) {
-        m->errorOut(e, "DecisionTree", "randomlyShuffleAttribute");
-		exit(1);
-	}
-    
-}
-
 /***********************************************************************/
 
 int DecisionTree::purgeTreeNodesDataRecursively(RFTreeNode* treeNode) {
     try {
         treeNode->bootstrappedTrainingSamples.clear();
-        treeNode->bootstrappedFeatureVectors.clear();
         treeNode->bootstrappedOutputVector.clear();
-        treeNode->localDiscardedFeatureIndices.clear();
-        treeNode->globalDiscardedFeatureIndices.clear();
         
         if (treeNode->leftChildNode != NULL) { purgeTreeNodesDataRecursively(treeNode->leftChildNode); }
         if (treeNode->rightChildNode != NULL) { purgeTreeNodesDataRecursively(treeNode->rightChildNode); }
@@ -215,7 +169,7 @@ void DecisionTree::buildDecisionTree(){
     try {
     
         int generation = 0;
-        rootNode = new RFTreeNode(bootstrappedTrainingSamples, globalDiscardedFeatureIndices, numFeatures, numSamples, numOutputClasses, generation, nodeIdCount, featureStandardDeviationThreshold);
+        rootNode = new RFTreeNode(bootstrappedTrainingSamples, dataSet, numFeatures, numSamples, numOutputClasses, generation, nodeIdCount, featureStandardDeviationThreshold);
         nodeIdCount++;
         
         splitRecursively(rootNode);
@@ -234,7 +188,7 @@ int DecisionTree::splitRecursively(RFTreeNode* rootNode) {
        
         if (rootNode->getNumSamples() < 2){
             rootNode->setIsLeaf(true);
-            rootNode->setOutputClass(rootNode->getBootstrappedTrainingSamples()[0][rootNode->getNumFeatures()]);
+            rootNode->setOutputClass(rootNode->getBootstrappedOutputVector()[0]);
             return 0;
         }
         
@@ -246,7 +200,14 @@ int DecisionTree::splitRecursively(RFTreeNode* rootNode) {
             return 0;
         }
         if (m->getControl_pressed()) { return 0; }
-        vector<int> featureSubsetIndices = selectFeatureSubsetRandomly(globalDiscardedFeatureIndices, rootNode->getLocalDiscardedFeatureIndices());
+        vector<int> featureSubsetIndices = selectFeatureSubsetRandomly(rootNode);
+        
+        // every feature is constant in this node, so it can't be split
+        if (featureSubsetIndices.size() == 0) {
+            rootNode->setIsLeaf(true);
+            updateOutputClassOfNode(rootNode);
+            return 0;
+        }
         
             // TODO: need to check if the value is actually copied correctly
         rootNode->setFeatureSubsetIndices(featureSubsetIndices);
@@ -260,16 +221,16 @@ int DecisionTree::splitRecursively(RFTreeNode* rootNode) {
         
         if (m->getControl_pressed()) { return 0; }
         
-        vector< vector<int> > leftChildSamples;
-        vector< vector<int> > rightChildSamples;
+        vector<int> leftChildSamples;
+        vector<int> rightChildSamples;
         getSplitPopulation(rootNode, leftChildSamples, rightChildSamples);
         
         if (m->getControl_pressed()) { return 0; }
         
         // TODO: need to write code to clear this memory
-        RFTreeNode* leftChildNode = new RFTreeNode(leftChildSamples, globalDiscardedFeatureIndices, numFeatures, (int)leftChildSamples.size(), numOutputClasses, rootNode->getGeneration() + 1, nodeIdCount, featureStandardDeviationThreshold);
+        RFTreeNode* leftChildNode = new RFTreeNode(leftChildSamples, dataSet, numFeatures, (int)leftChildSamples.size(), numOutputClasses, rootNode->getGeneration() + 1, nodeIdCount, featureStandardDeviationThreshold);
         nodeIdCount++;
-        RFTreeNode* rightChildNode = new RFTreeNode(rightChildSamples, globalDiscardedFeatureIndices, numFeatures, (int)rightChildSamples.size(), numOutputClasses, rootNode->getGeneration() + 1, nodeIdCount, featureStandardDeviationThreshold);
+        RFTreeNode* rightChildNode = new RFTreeNode(rightChildSamples, dataSet, numFeatures, (int)rightChildSamples.size(), numOutputClasses, rootNode->getGeneration() + 1, nodeIdCount, featureStandardDeviationThreshold);
         nodeIdCount++;
         
         rootNode->setLeftChildNode(leftChildNode);
@@ -296,12 +257,10 @@ int DecisionTree::splitRecursively(RFTreeNode* rootNode) {
 int DecisionTree::findAndUpdateBestFeatureToSplitOn(RFTreeNode* node){
     try {
 
-        vector< vector<int> > bootstrappedFeatureVectors = node->getBootstrappedFeatureVectors();
-        if (m->getControl_pressed()) { return 0; }
-        vector<int> bootstrappedOutputVector = node->getBootstrappedOutputVector();
-        if (m->getControl_pressed()) { return 0; }
-        vector<int> featureSubsetIndices = node->getFeatureSubsetIndices();
-        if (m->getControl_pressed()) { return 0; }
+        const vector<int>& nodeSamples = node->getBootstrappedTrainingSamples();
+        for (int i = 0; i < nodeSamples.size(); i++) { nodeSampleCounts[nodeSamples[i]]++; }
+        
+        const vector<int>& featureSubsetIndices = node->getFeatureSubsetIndices();
         
         vector<double> featureSubsetEntropies;
         vector<int> featureSubsetSplitValues;
@@ -309,7 +268,7 @@ int DecisionTree::findAndUpdateBestFeatureToSplitOn(RFTreeNode* node){
         vector<double> featureSubsetGainRatios;
         
         for (int i = 0; i < featureSubsetIndices.size(); i++) {
-            if (m->getControl_pressed()) { return 0; }
+            if (m->getControl_pressed()) { break; }
             
             int tryIndex = featureSubsetIndices[i];
                        
@@ -317,8 +276,7 @@ int DecisionTree::findAndUpdateBestFeatureToSplitOn(RFTreeNode* node){
             int featureSplitValue;
             double featureIntrinsicValue;
             
-            getMinEntropyOfFeature(bootstrappedFeatureVectors[tryIndex], bootstrappedOutputVector, featureMinEntropy, featureSplitValue, featureIntrinsicValue);
-            if (m->getControl_pressed()) { return 0; }
+            getMinEntropyOfFeature(node, tryIndex, featureMinEntropy, featureSplitValue, featureIntrinsicValue);
             
             featureSubsetEntropies.push_back(featureMinEntropy);
             featureSubsetSplitValues.push_back(featureSplitValue);
@@ -330,6 +288,9 @@ int DecisionTree::findAndUpdateBestFeatureToSplitOn(RFTreeNode* node){
             
         }
         
+        for (int i = 0; i < nodeSamples.size(); i++) { nodeSampleCounts[nodeSamples[i]] = 0; }
+        if (m->getControl_pressed()) { return 0; }
+        
         vector<double>::iterator minEntropyIterator = min_element(featureSubsetEntropies.begin(), featureSubsetEntropies.end());
         vector<double>::iterator maxGainRatioIterator = max_element(featureSubsetGainRatios.begin(), featureSubsetGainRatios.end());
         double featureMinEntropy = *minEntropyIterator;
@@ -369,40 +330,40 @@ int DecisionTree::findAndUpdateBestFeatureToSplitOn(RFTreeNode* node){
 	} 
 }
 /***********************************************************************/
-vector<int> DecisionTree::selectFeatureSubsetRandomly(vector<int> globalDiscardedFeatureIndices, vector<int> localDiscardedFeatureIndices){
+//Draws features until it has optimumFeatureSubsetSize that are not constant in the node. A feature is only checked
+//when it is drawn, the node's other features are only checked if the draws suggest few are left.
+vector<int> DecisionTree::selectFeatureSubsetRandomly(RFTreeNode* node){
     try {
 
         vector<int> featureSubsetIndices;
         
-        vector<int> combinedDiscardedFeatureIndices;
-        combinedDiscardedFeatureIndices.insert(combinedDiscardedFeatureIndices.end(), globalDiscardedFeatureIndices.begin(), globalDiscardedFeatureIndices.end());
-        combinedDiscardedFeatureIndices.insert(combinedDiscardedFeatureIndices.end(), localDiscardedFeatureIndices.begin(), localDiscardedFeatureIndices.end());
+        int currentFeatureSubsetSize = optimumFeatureSubsetSize;
+        bool countedRemainingFeatures = false;
+        long long numDraws = 0;
         
-        sort(combinedDiscardedFeatureIndices.begin(), combinedDiscardedFeatureIndices.end());
-        
-        int numberOfRemainingSuitableFeatures = (int)(numFeatures - combinedDiscardedFeatureIndices.size());
-        int currentFeatureSubsetSize = numberOfRemainingSuitableFeatures < optimumFeatureSubsetSize ? numberOfRemainingSuitableFeatures : optimumFeatureSubsetSize;
-        
-        Utils util;
+        uniform_int_distribution<int> dis(0, numFeatures-1);
         while (featureSubsetIndices.size() < currentFeatureSubsetSize) {
             
             if (m->getControl_pressed()) { return featureSubsetIndices; }
             
-            int randomIndex = util.getRandomIndex(numFeatures-1);
+            int randomIndex = dis(engine);
             vector<int>::iterator it = find(featureSubsetIndices.begin(), featureSubsetIndices.end(), randomIndex);
             if (it == featureSubsetIndices.end()){    // NOT FOUND
-                vector<int>::iterator it2 = find(combinedDiscardedFeatureIndices.begin(), combinedDiscardedFeatureIndices.end(), randomIndex);
-                if (it2 == combinedDiscardedFeatureIndices.end()){  // NOT FOUND AGAIN
+                if (!isDiscardedFeature(node, randomIndex)){  // NOT FOUND AGAIN
                     featureSubsetIndices.push_back(randomIndex);
                 }
             }
+            numDraws++;
+            
+            if (!countedRemainingFeatures && (numDraws >= numFeatures)) {
+                int numberOfRemainingSuitableFeatures = 0;
+                for (int i = 0; i < numFeatures; i++) { if (!isDiscardedFeature(node, i)) { numberOfRemainingSuitableFeatures++; } }
+                if (numberOfRemainingSuitableFeatures < currentFeatureSubsetSize) { currentFeatureSubsetSize = numberOfRemainingSuitableFeatures; }
+                countedRemainingFeatures = true;
+            }
         }
         sort(featureSubsetIndices.begin(), featureSubsetIndices.end());
         
-        //#ifdef DEBUG_LEVEL_3
-        //    PRINT_VAR(featureSubsetIndices);
-        //#endif
-        
         return featureSubsetIndices;
     }
 	catch(exception& e) {
@@ -411,6 +372,39 @@ vector<int> DecisionTree::selectFeatureSubsetRandomly(vector<int> globalDiscarde
 	} 
 }
 /***********************************************************************/
+//discarded globally or constant (standard deviation at or below the threshold) in the node's samples
+bool DecisionTree::isDiscardedFeature(RFTreeNode* node, int featureIndex){
+    try {
+        if (isGlobalDiscardedFeature[featureIndex]) { return true; }
+        
+        if (featureCheckedNodeId[featureIndex] != node->nodeId) {
+            featureCheckedNodeId[featureIndex] = node->nodeId;
+            double standardDeviation = dataSet.getStandardDeviation(featureIndex, node->getBootstrappedTrainingSamples());
+            isLocalDiscardedFeature[featureIndex] = (standardDeviation <= featureStandardDeviationThreshold);
+        }
+        
+        return isLocalDiscardedFeature[featureIndex];
+    }
+	catch(exception& e) {
+		m->errorOut(e, "DecisionTree", "isDiscardedFeature");
+		exit(1);
+	}
+}
+/***********************************************************************/
+void DecisionTree::getSplitFeatures(RFTreeNode* treeNode, set<int>& splitFeatures){
+    try {
+        if ((treeNode == NULL) || treeNode->checkIsLeaf()) { return; }
+        
+        splitFeatures.insert(treeNode->getSplitFeatureIndex());
+        getSplitFeatures(treeNode->getLeftChildNode(), splitFeatures);
+        getSplitFeatures(treeNode->getRightChildNode(), splitFeatures);
+    }
+	catch(exception& e) {
+		m->errorOut(e, "DecisionTree", "getSplitFeatures");
+		exit(1);
+	}
+}
+/***********************************************************************/
 
 // TODO: printTree() needs a check if correct
 int DecisionTree::printTree(RFTreeNode* treeNode, string caption){
@@ -453,11 +447,10 @@ void DecisionTree::deleteTreeNodesRecursively(RFTreeNode* treeNode) {
 void DecisionTree::pruneTree(double pruneAggressiveness = 0.9) {
     
     // find out the number of misclassification by each of the nodes
-    for (int i = 0; i < bootstrappedTestSamples.size(); i++) {
+    for (int i = 0; i < bootstrappedTestSampleIndices.size(); i++) {
         if (m->getControl_pressed()) { return; }
         
-        vector<int> testSample = bootstrappedTestSamples[i];
-        updateMisclassificationCountRecursively(rootNode, testSample);
+        updateMisclassificationCountRecursively(rootNode, bootstrappedTestSampleIndices[i]);
     }
     
     // do the actual pruning
@@ -478,10 +471,10 @@ void DecisionTree::pruneRecursively(RFTreeNode* treeNode, double pruneAggressive
         
         if (subTreeMisclassificationCount * pruneAggressiveness > ownMisclassificationCount) {
                 // TODO: need to check the effect of these two delete calls
-            delete treeNode->leftChildNode;
+            deleteTreeNodesRecursively(treeNode->leftChildNode);
             treeNode->leftChildNode = NULL;
             
-            delete treeNode->rightChildNode;
+            deleteTreeNodesRecursively(treeNode->rightChildNode);
             treeNode->rightChildNode = NULL;
             
             treeNode->isLeaf = true;
@@ -491,9 +484,9 @@ void DecisionTree::pruneRecursively(RFTreeNode* treeNode, double pruneAggressive
 }
 /***********************************************************************/
 
-void DecisionTree::updateMisclassificationCountRecursively(RFTreeNode* treeNode, vector<int> testSample) {
+void DecisionTree::updateMisclassificationCountRecursively(RFTreeNode* treeNode, int sampleIndex) {
     
-    int actualSampleOutputClass = testSample[numFeatures];
+    int actualSampleOutputClass = dataSet.getOutcome(sampleIndex);
     int nodePredictedOutputClass = treeNode->outputClass;
     
     if (actualSampleOutputClass != nodePredictedOutputClass) {
@@ -506,11 +499,11 @@ void DecisionTree::updateMisclassificationCountRecursively(RFTreeNode* treeNode,
     }
     
     if (treeNode->checkIsLeaf() == false) { // NOT A LEAF
-        int sampleSplitFeatureValue = testSample[treeNode->splitFeatureIndex];
+        int sampleSplitFeatureValue = dataSet.getValue(treeNode->splitFeatureIndex, sampleIndex);
         if (sampleSplitFeatureValue < treeNode->splitFeatureValue) {
-            updateMisclassificationCountRecursively(treeNode->leftChildNode, testSample);
+            updateMisclassificationCountRecursively(treeNode->leftChildNode, sampleIndex);
         } else {
-            updateMisclassificationCountRecursively(treeNode->rightChildNode, testSample);
+            updateMisclassificationCountRecursively(treeNode->rightChildNode, sampleIndex);
         }
     }
 }
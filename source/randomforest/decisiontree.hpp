@@ -33,29 +33,27 @@ class DecisionTree: public AbstractDecisionTree{
     
 public:
     
-    DecisionTree(vector< vector<int> >& baseDataSet,
-                 vector<int> globalDiscardedFeatureIndices,
+    DecisionTree(const RFDataSet& dataSet,
+                 const vector<int>& globalDiscardedFeatureIndices,
                  OptimumFeatureSubsetSelector optimumFeatureSubsetSelector,
                  string treeSplitCriterion,
-                 float featureStandardDeviationThreshold);
+                 float featureStandardDeviationThreshold,
+                 unsigned long long seed);
     
     virtual ~DecisionTree(){ deleteTreeNodesRecursively(rootNode); }
     
     int calcTreeVariableImportanceAndError(int& numCorrect, double& treeErrorRate);
-    int evaluateSample(vector<int> testSample);
+    int evaluateSample(int sampleIndex);
+    int evaluateSample(int sampleIndex, int featureIndex, int featureValue); //as if the sample had featureValue for featureIndex
     int calcTreeErrorRate(int& numCorrect, double& treeErrorRate);
     
-    void randomlyShuffleAttribute(const vector< vector<int> >& samples,
-                                  const int featureIndex,
-                                  const int prevFeatureIndex,
-                                  vector< vector<int> >& shuffledSample);
-    
+    int printTree() { return printTree(rootNode, "ROOT"); }
     void purgeDataSetsFromTree() { purgeTreeNodesDataRecursively(rootNode); }
     int purgeTreeNodesDataRecursively(RFTreeNode* treeNode);
     
     void pruneTree(double pruneAggressiveness);
     void pruneRecursively(RFTreeNode* treeNode, double pruneAggressiveness);
-    void updateMisclassificationCountRecursively(RFTreeNode* treeNode, vector<int> testSample);
+    void updateMisclassificationCountRecursively(RFTreeNode* treeNode, int sampleIndex);
     void updateOutputClassOfNode(RFTreeNode* treeNode);
     
     
@@ -64,7 +62,9 @@ private:
     void buildDecisionTree();
     int splitRecursively(RFTreeNode* rootNode);
     int findAndUpdateBestFeatureToSplitOn(RFTreeNode* node);
-    vector<int> selectFeatureSubsetRandomly(vector<int> globalDiscardedFeatureIndices, vector<int> localDiscardedFeatureIndices);
+    vector<int> selectFeatureSubsetRandomly(RFTreeNode* node);
+    bool isDiscardedFeature(RFTreeNode* node, int featureIndex);
+    void getSplitFeatures(RFTreeNode* treeNode, set<int>& splitFeatures);
     int printTree(RFTreeNode* treeNode, string caption);
     void deleteTreeNodesRecursively(RFTreeNode* treeNode);
     
@@ -72,6 +72,8 @@ private:
     map<int, int> outOfBagEstimates;
   
     float featureStandardDeviationThreshold;
+    vector<int> featureCheckedNodeId; //[numFeatures] node the local discard check was last made for, -1 if none
+    vector<bool> isLocalDiscardedFeature; //[numFeatures] result of that check
 };
 
 #endif
@@ -7,10 +7,9 @@
 //
 
 #include "forest.h"
-#include "utils.hpp"
 
 /***********************************************************************/
-Forest::Forest(const std::vector < std::vector<int> > dataSet,
+Forest::Forest(const std::vector < std::vector<int> >& dataSet,
                const int numDecisionTrees,
                const string treeSplitCriterion = "gainratio",
                const bool doPruning = false,
@@ -18,11 +17,13 @@ Forest::Forest(const std::vector < std::vector<int> > dataSet,
                const bool discardHighErrorTrees = true,
                const float highErrorTreeDiscardThreshold = 0.4,
                const string optimumFeatureSubsetSelectionCriteria = "log2",
-               const float featureStandardDeviationThreshold = 0.0)
+               const float featureStandardDeviationThreshold = 0.0,
+               const int processors = 1)
       : dataSet(dataSet),
         numDecisionTrees(numDecisionTrees),
         numSamples((int)dataSet.size()),
         numFeatures((int)(dataSet[0].size() - 1)),
+        processors(processors),
         globalVariableImportanceList(numFeatures, 0),
         treeSplitCriterion(treeSplitCriterion),
         doPruning(doPruning),
@@ -42,24 +43,15 @@ Forest::Forest(const std::vector < std::vector<int> > dataSet,
 
 vector<int> Forest::getGlobalDiscardedFeatureIndices() {
     try {
-        Utils util;
-        
-        // calculate feature vectors
-        vector< vector<int> > featureVectors(numFeatures, vector<int>(numSamples, 0) );
-        for (int i = 0; i < numSamples; i++) {
-            if (m->getControl_pressed()) { return globalDiscardedFeatureIndices; }
-            for (int j = 0; j < numFeatures; j++) { featureVectors[j][i] = dataSet[i][j]; }
-        }
-        
-        for (int i = 0; i < featureVectors.size(); i++) {
+        for (int i = 0; i < numFeatures; i++) {
             if (m->getControl_pressed()) { return globalDiscardedFeatureIndices; }
-            double standardDeviation = util.getStandardDeviation(featureVectors[i]);
+            double standardDeviation = dataSet.getStandardDeviation(i);
             if (standardDeviation <= featureStandardDeviationThreshold){ globalDiscardedFeatureIndices.push_back(i); }
         }
         
         if (m->getDebug()) {
             m->mothurOut("number of global discarded features:  " + toString(globalDiscardedFeatureIndices.size())+ "\n");
-            m->mothurOut("total features: " + toString(featureVectors.size())+ "\n");
+            m->mothurOut("total features: " + toString(numFeatures)+ "\n");
         }
         
         return globalDiscardedFeatureIndices;
@@ -13,13 +13,14 @@
 #include "macros.h"
 #include "decisiontree.hpp"
 #include "abstractdecisiontree.hpp"
+#include "rfdataset.hpp"
 /***********************************************************************/
 //this is a re-implementation of the abstractrandomforest class
 
 class Forest{
 public:
     // intialization with vectors
-    Forest(const std::vector < std::vector<int> > dataSet,
+    Forest(const std::vector < std::vector<int> >& dataSet,
            const int numDecisionTrees,
            const string treeSplitCriterion,
            const bool doPruning,
@@ -27,7 +28,8 @@ public:
            const bool discardHighErrorTrees,
            const float highErrorTreeDiscardThreshold,
            const string optimumFeatureSubsetSelectionCriteria,
-           const float featureStandardDeviationThreshold);
+           const float featureStandardDeviationThreshold,
+           const int processors);
     virtual ~Forest(){ }
     virtual int populateDecisionTrees() = 0;
     virtual int calcForrestErrorRate() = 0;
@@ -54,7 +56,8 @@ protected:
     int numDecisionTrees;
     int numSamples;
     int numFeatures;
-    vector< vector<int> > dataSet;
+    int processors;
+    RFDataSet dataSet; //shared by the trees
     vector<int> globalDiscardedFeatureIndices;
     vector<double> globalVariableImportanceList;
     string treeSplitCriterion;
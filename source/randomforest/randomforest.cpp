@@ -11,7 +11,7 @@
 
 /***********************************************************************/
 
-RandomForest::RandomForest(const vector <vector<int> > dataSet,
+RandomForest::RandomForest(const vector <vector<int> >& dataSet,
                            const int numDecisionTrees,
                            const string treeSplitCriterion = "gainratio",
                            const bool doPruning = false,
@@ -19,8 +19,9 @@ RandomForest::RandomForest(const vector <vector<int> > dataSet,
                            const bool discardHighErrorTrees = true,
                            const float highErrorTreeDiscardThreshold = 0.4,
                            const string optimumFeatureSubsetSelectionCriteria = "log2",
-                           const float featureStandardDeviationThreshold = 0.0)
-            : Forest(dataSet, numDecisionTrees, treeSplitCriterion, doPruning, pruneAggressiveness, discardHighErrorTrees, highErrorTreeDiscardThreshold, optimumFeatureSubsetSelectionCriteria, featureStandardDeviationThreshold) {
+                           const float featureStandardDeviationThreshold = 0.0,
+                           const int processors = 1)
+            : Forest(dataSet, numDecisionTrees, treeSplitCriterion, doPruning, pruneAggressiveness, discardHighErrorTrees, highErrorTreeDiscardThreshold, optimumFeatureSubsetSelectionCriteria, featureStandardDeviationThreshold, processors) {
     m = MothurOut::getInstance();
 }
 
@@ -37,7 +38,7 @@ int RandomForest::calcForrestErrorRate() {
             vector<int> predictedOutComes = it->second;
             vector<int>::iterator maxPredictedOutComeIterator = max_element(predictedOutComes.begin(), predictedOutComes.end());
             int majorityVotedOutcome = (int)(maxPredictedOutComeIterator - predictedOutComes.begin());
-            int realOutcome = dataSet[indexOfSample][numFeatures];
+            int realOutcome = dataSet.getOutcome(indexOfSample);
                                    
             if (majorityVotedOutcome == realOutcome) { numCorrect++; }
         }
@@ -70,7 +71,7 @@ int RandomForest::printConfusionMatrix(map<int, string> intToTreatmentMap) {
             vector<int> predictedOutComes = it->second; //value, vector of all predicted classes
             vector<int>::iterator maxPredictedOutComeIterator = max_element(predictedOutComes.begin(), predictedOutComes.end());
             int majorityVotedOutcome = (int)(maxPredictedOutComeIterator - predictedOutComes.begin());
-            int realOutcome = dataSet[indexOfSample][numFeatures];                       
+            int realOutcome = dataSet.getOutcome(indexOfSample);                       
             cm[realOutcome][majorityVotedOutcome] = cm[realOutcome][majorityVotedOutcome] + 1;
         }
         
@@ -120,7 +121,7 @@ int RandomForest::getMissclassifications(string filename, map<int, string> intTo
             vector<int> predictedOutComes = it->second;
             vector<int>::iterator maxPredictedOutComeIterator = max_element(predictedOutComes.begin(), predictedOutComes.end());
             int majorityVotedOutcome = (int)(maxPredictedOutComeIterator - predictedOutComes.begin());
-            int realOutcome = dataSet[indexOfSample][numFeatures];
+            int realOutcome = dataSet.getOutcome(indexOfSample);
                                    
             if (majorityVotedOutcome != realOutcome) {             
                 out << names[indexOfSample] << "\t" << intToTreatmentMap[majorityVotedOutcome] << "\t" << intToTreatmentMap[realOutcome] << endl;
@@ -184,22 +185,19 @@ int RandomForest::calcForrestVariableImportance(string filename) {
 	}  
 }
 /***********************************************************************/
-int RandomForest::populateDecisionTrees() {
+void driverBuildDecisionTrees(randomForestData* params) {
     try {
-        
-        vector<double> errorRateImprovements;
-        
-        for (int i = 0; i < numDecisionTrees; i++) {
+        int numDecisionTrees = params->seeds->size();
+        for (int i = params->start; i < numDecisionTrees; i += params->increment) {
           
-            if (m->getControl_pressed()) { return 0; }
-            if (((i+1) % 100) == 0) {  m->mothurOut("Creating " + toString(i+1) + " (th) Decision tree\n");  }
+            if (params->m->getControl_pressed()) { break; }
+            if (((i+1) % 100) == 0) {  params->m->mothurOut("Creating " + toString(i+1) + " (th) Decision tree\n");  }
           
-            // TODO: need to first fix if we are going to use pointer based system or anything else
-            DecisionTree* decisionTree = new DecisionTree(dataSet, globalDiscardedFeatureIndices, OptimumFeatureSubsetSelector(optimumFeatureSubsetSelectionCriteria), treeSplitCriterion, featureStandardDeviationThreshold);
+            DecisionTree* decisionTree = new DecisionTree(*params->dataSet, *params->globalDiscardedFeatureIndices, OptimumFeatureSubsetSelector(params->optimumFeatureSubsetSelectionCriteria), params->treeSplitCriterion, params->featureStandardDeviationThreshold, (*params->seeds)[i]);
           
-            if (m->getDebug() && doPruning) {
-                m->mothurOut("Before pruning\n");
-                decisionTree->printTree(decisionTree->rootNode, "ROOT");
+            if (params->m->getDebug() && params->doPruning) {
+                params->m->mothurOut("Before pruning\n");
+                decisionTree->printTree();
             }
             
             int numCorrect;
@@ -208,15 +206,15 @@ int RandomForest::populateDecisionTrees() {
             decisionTree->calcTreeErrorRate(numCorrect, treeErrorRate);
             double prePrunedErrorRate = treeErrorRate;
             
-            if (m->getDebug()) {
-                m->mothurOut("treeErrorRate: " + toString(treeErrorRate) + " numCorrect: " + toString(numCorrect) + "\n");
+            if (params->m->getDebug()) {
+                params->m->mothurOut("treeErrorRate: " + toString(treeErrorRate) + " numCorrect: " + toString(numCorrect) + "\n");
             }
             
-            if (doPruning) {
-                decisionTree->pruneTree(pruneAggressiveness);
-                if (m->getDebug()) {
-                    m->mothurOut("After pruning\n");
-                    decisionTree->printTree(decisionTree->rootNode, "ROOT");
+            if (params->doPruning) {
+                decisionTree->pruneTree(params->pruneAggressiveness);
+                if (params->m->getDebug()) {
+                    params->m->mothurOut("After pruning\n");
+                    decisionTree->printTree();
                 }
                 decisionTree->calcTreeErrorRate(numCorrect, treeErrorRate);
             }
@@ -226,34 +224,82 @@ int RandomForest::populateDecisionTrees() {
             decisionTree->calcTreeVariableImportanceAndError(numCorrect, treeErrorRate);
             double errorRateImprovement = (prePrunedErrorRate - postPrunedErrorRate) / prePrunedErrorRate;
 
-            if (m->getDebug()) {
-                m->mothurOut("treeErrorRate: " + toString(treeErrorRate) + " numCorrect: " + toString(numCorrect) + "\n");
-                if (doPruning) {
-                    m->mothurOut("errorRateImprovement: " + toString(errorRateImprovement) + "\n");
+            if (params->m->getDebug()) {
+                params->m->mothurOut("treeErrorRate: " + toString(treeErrorRate) + " numCorrect: " + toString(numCorrect) + "\n");
+                if (params->doPruning) {
+                    params->m->mothurOut("errorRateImprovement: " + toString(errorRateImprovement) + "\n");
                 }
             }
             
-            
-            if (discardHighErrorTrees) {
-                if (treeErrorRate < highErrorTreeDiscardThreshold) {
-                    updateGlobalOutOfBagEstimates(decisionTree);
-                    decisionTree->purgeDataSetsFromTree();
-                    decisionTrees.push_back(decisionTree);
-                    if (doPruning) {
-                        errorRateImprovements.push_back(errorRateImprovement);
-                    }
-                } else {
-                    delete decisionTree;
-                }
-            } else {
-                updateGlobalOutOfBagEstimates(decisionTree);
+            if (params->discardHighErrorTrees && !(treeErrorRate < params->highErrorTreeDiscardThreshold)) { delete decisionTree; }
+            else {
                 decisionTree->purgeDataSetsFromTree();
-                decisionTrees.push_back(decisionTree);
-                if (doPruning) {
-                    errorRateImprovements.push_back(errorRateImprovement);
-                }
-            }          
+                (*params->decisionTrees)[i] = decisionTree;
+                (*params->errorRateImprovements)[i] = errorRateImprovement;
+            }
+        }
+    }
+    catch(exception& e) {
+        params->m->errorOut(e, "RandomForest", "driverBuildDecisionTrees");
+        exit(1);
+    }
+}
+/***********************************************************************/
+int RandomForest::populateDecisionTrees() {
+    try {
+        
+        vector<double> errorRateImprovements;
+        
+        //each tree gets its own seed, drawn in order so the forest doesn't depend on the number of processors
+        Utils util;
+        vector<unsigned long long> seeds;
+        for (int i = 0; i < numDecisionTrees; i++) { seeds.push_back((unsigned long long)util.getRandomNumber()); }
+        
+        vector<DecisionTree*> builtTrees(numDecisionTrees, NULL);
+        vector<double> treeErrorRateImprovements(numDecisionTrees, 0.0);
+        
+        int numThreads = processors;
+        if (numDecisionTrees < numThreads) { numThreads = numDecisionTrees; }
+        if (numThreads < 1) { numThreads = 1; }
+        
+        vector<thread*> workerThreads;
+        vector<randomForestData*> data;
+        
+        for (int i = 0; i < numThreads; i++) {
+            randomForestData* dataBundle = new randomForestData(&dataSet, &globalDiscardedFeatureIndices, &seeds, &builtTrees, &treeErrorRateImprovements, i, numThreads);
+            dataBundle->treeSplitCriterion = treeSplitCriterion;
+            dataBundle->optimumFeatureSubsetSelectionCriteria = optimumFeatureSubsetSelectionCriteria;
+            dataBundle->doPruning = doPruning;
+            dataBundle->pruneAggressiveness = pruneAggressiveness;
+            dataBundle->discardHighErrorTrees = discardHighErrorTrees;
+            dataBundle->highErrorTreeDiscardThreshold = highErrorTreeDiscardThreshold;
+            dataBundle->featureStandardDeviationThreshold = featureStandardDeviationThreshold;
+            data.push_back(dataBundle);
+        }
+        
+        //Lauch worker threads
+        for (int i = 1; i < numThreads; i++) { workerThreads.push_back(new thread(driverBuildDecisionTrees, data[i])); }
+        
+        driverBuildDecisionTrees(data[0]);
+        
+        for (int i = 0; i < workerThreads.size(); i++) {
+            workerThreads[i]->join();
+            delete workerThreads[i];
         }
+        for (int i = 0; i < data.size(); i++) { delete data[i]; }
+        
+        //add the kept trees in order
+        for (int i = 0; i < numDecisionTrees; i++) {
+            if (builtTrees[i] == NULL) { continue; }
+            
+            if (m->getControl_pressed()) { delete builtTrees[i]; continue; }
+            
+            updateGlobalOutOfBagEstimates(builtTrees[i]);
+            decisionTrees.push_back(builtTrees[i]);
+            if (doPruning) { errorRateImprovements.push_back(treeErrorRateImprovements[i]); }
+        }
+        
+        if (m->getControl_pressed()) { return 0; }
         
         double avgErrorRateImprovement = -1.0;
         if (errorRateImprovements.size() > 0) {
@@ -17,7 +17,7 @@ class RandomForest: public Forest {
     
 public:
     
-    RandomForest(const vector <vector<int> > dataSet,
+    RandomForest(const vector <vector<int> >& dataSet,
                  const int numDecisionTrees,
                  const string treeSplitCriterion,
                  const bool doPruning,
@@ -25,7 +25,8 @@ public:
                  const bool discardHighErrorTrees,
                  const float highErrorTreeDiscardThreshold,
                  const string optimumFeatureSubsetSelectionCriteria,
-                 const float featureStandardDeviationThreshold);
+                 const float featureStandardDeviationThreshold,
+                 const int processors);
     
     
     //NOTE:: if you are going to dynamically cast, aren't you undoing the advantage of abstraction. Why abstract at all?
@@ -50,5 +51,32 @@ private:
     MothurOut* m;
     
 };
+/***********************************************************************/
+//the trees built by one thread, every processors-th tree starting at start. Each tree is built from its own seed.
+struct randomForestData {
+    RFDataSet* dataSet;
+    vector<int>* globalDiscardedFeatureIndices;
+    vector<unsigned long long>* seeds;
+    vector<DecisionTree*>* decisionTrees; //NULL for the discarded trees
+    vector<double>* errorRateImprovements;
+    int start, increment;
+    string treeSplitCriterion, optimumFeatureSubsetSelectionCriteria;
+    bool doPruning, discardHighErrorTrees;
+    float pruneAggressiveness, highErrorTreeDiscardThreshold, featureStandardDeviationThreshold;
+    MothurOut* m;
+    
+    randomForestData(){}
+    randomForestData(RFDataSet* d, vector<int>* g, vector<unsigned long long>* se, vector<DecisionTree*>* dt, vector<double>* e, int st, int inc) {
+        m = MothurOut::getInstance();
+        dataSet = d;
+        globalDiscardedFeatureIndices = g;
+        seeds = se;
+        decisionTrees = dt;
+        errorRateImprovements = e;
+        start = st;
+        increment = inc;
+    }
+};
+/***********************************************************************/
 
 #endif
@@ -0,0 +1,99 @@
+//
+//  rfdataset.cpp
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#include "rfdataset.hpp"
+
+/***********************************************************************/
+struct RFSampleValueSorter {
+    const vector<int>& values;
+    RFSampleValueSorter(const vector<int>& v) : values(v) {}
+    bool operator() (int first, int second) const { return values[first] < values[second]; }
+};
+/***********************************************************************/
+
+RFDataSet::RFDataSet(const vector< vector<int> >& dataSet)
+        : numSamples((int)dataSet.size()),
+        numFeatures((int)(dataSet[0].size() - 1)),
+        numOutputClasses(0) {
+    try {
+        m = MothurOut::getInstance();
+
+        featureVectors.resize(numFeatures, vector<int>(numSamples, 0));
+        outcomes.resize(numSamples, 0);
+
+        vector<int> outputClasses;
+        for (int i = 0; i < numSamples; i++) {
+            if (m->getControl_pressed()) { return; }
+
+            for (int j = 0; j < numFeatures; j++) { featureVectors[j][i] = dataSet[i][j]; }
+            outcomes[i] = dataSet[i][numFeatures];
+
+            if (find(outputClasses.begin(), outputClasses.end(), outcomes[i]) == outputClasses.end()) { outputClasses.push_back(outcomes[i]); }
+        }
+        numOutputClasses = outputClasses.size();
+
+        vector<int> samples(numSamples, 0);
+        for (int i = 0; i < numSamples; i++) { samples[i] = i; }
+
+        sortedSamples.resize(numFeatures);
+        for (int j = 0; j < numFeatures; j++) {
+            if (m->getControl_pressed()) { return; }
+
+            sortedSamples[j] = samples;
+            stable_sort(sortedSamples[j].begin(), sortedSamples[j].end(), RFSampleValueSorter(featureVectors[j]));
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "RFDataSet", "RFDataSet");
+        exit(1);
+    }
+}
+/***********************************************************************/
+
+double RFDataSet::getStandardDeviation(int featureIndex) const {
+    try {
+        const vector<int>& featureVector = featureVectors[featureIndex];
+
+        double average = 0;
+        for (int i = 0; i < numSamples; i++) { average += featureVector[i]; }
+        average /= (double) numSamples;
+
+        double stdDev = 0;
+        for (int i = 0; i < numSamples; i++) { stdDev += ((featureVector[i] - average) * (featureVector[i] - average)); }
+        stdDev /= (double) numSamples;
+
+        return sqrt(stdDev);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "RFDataSet", "getStandardDeviation");
+        exit(1);
+    }
+}
+/***********************************************************************/
+
+double RFDataSet::getStandardDeviation(int featureIndex, const vector<int>& sampleIndexes) const {
+    try {
+        const vector<int>& featureVector = featureVectors[featureIndex];
+        int numValues = sampleIndexes.size();
+
+        double average = 0;
+        for (int i = 0; i < numValues; i++) { average += featureVector[sampleIndexes[i]]; }
+        average /= (double) numValues;
+
+        double stdDev = 0;
+        for (int i = 0; i < numValues; i++) { stdDev += ((featureVector[sampleIndexes[i]] - average) * (featureVector[sampleIndexes[i]] - average)); }
+        stdDev /= (double) numValues;
+
+        return sqrt(stdDev);
+    }
+    catch(exception& e) {
+        m->errorOut(e, "RFDataSet", "getStandardDeviation");
+        exit(1);
+    }
+}
+/***********************************************************************/
@@ -0,0 +1,51 @@
+//
+//  rfdataset.hpp
+//  Mothur
+//
+//  Created by agent on 10/19/26.
+//  Copyright (c) 2026 Schloss Lab. All rights reserved.
+//
+
+#ifndef RF_RFDATASET_HPP
+#define RF_RFDATASET_HPP
+
+#include "mothurout.h"
+
+/***********************************************************************/
+//The training data shared by all the trees of a forest. The values are stored by feature, and each feature keeps the
+//samples sorted by its value, so the trees can find splits without sorting. Read only after construction, so the
+//trees can be built by several threads at once.
+
+class RFDataSet {
+
+public:
+
+    RFDataSet(const vector< vector<int> >& dataSet); //[numSamples][numFeatures+1], the last column is the outcome
+    ~RFDataSet(){}
+
+    int getNumSamples() const { return numSamples; }
+    int getNumFeatures() const { return numFeatures; }
+    int getNumOutputClasses() const { return numOutputClasses; }
+
+    int getValue(int featureIndex, int sampleIndex) const { return featureVectors[featureIndex][sampleIndex]; }
+    int getOutcome(int sampleIndex) const { return outcomes[sampleIndex]; }
+    const vector<int>& getFeatureVector(int featureIndex) const { return featureVectors[featureIndex]; }
+    const vector<int>& getSortedSamples(int featureIndex) const { return sortedSamples[featureIndex]; } //sample indexes in ascending order of value
+
+    double getStandardDeviation(int featureIndex) const; //of all the samples
+    double getStandardDeviation(int featureIndex, const vector<int>& sampleIndexes) const;
+
+private:
+
+    int numSamples;
+    int numFeatures;
+    int numOutputClasses;
+    vector< vector<int> > featureVectors; //[numFeatures][numSamples]
+    vector< vector<int> > sortedSamples; //[numFeatures][numSamples]
+    vector<int> outcomes; //[numSamples]
+    MothurOut* m;
+};
+
+/***********************************************************************/
+
+#endif
@@ -10,8 +10,8 @@
 #include "utils.hpp"
 
 /***********************************************************************/
-RFTreeNode::RFTreeNode(vector< vector<int> > bootstrappedTrainingSamples,
-                       vector<int> globalDiscardedFeatureIndices,
+RFTreeNode::RFTreeNode(vector<int> bootstrappedTrainingSamples,
+                       const RFDataSet& dataSet,
                        int numFeatures,
                        int numSamples,
                        int numOutputClasses,
@@ -20,7 +20,7 @@ RFTreeNode::RFTreeNode(vector< vector<int> > bootstrappedTrainingSamples,
                        float featureStandardDeviationThreshold)
 
             : bootstrappedTrainingSamples(bootstrappedTrainingSamples),
-            globalDiscardedFeatureIndices(globalDiscardedFeatureIndices),
+            bootstrappedOutputVector(numSamples, 0),
             numFeatures(numFeatures),
             numSamples(numSamples),
             numOutputClasses(numOutputClasses),
@@ -34,47 +34,17 @@ RFTreeNode::RFTreeNode(vector< vector<int> > bootstrappedTrainingSamples,
             splitFeatureEntropy(-1.0),
             ownEntropy(-1.0),
             featureStandardDeviationThreshold(featureStandardDeviationThreshold),
-            bootstrappedFeatureVectors(numFeatures, vector<int>(numSamples, 0)),
-            bootstrappedOutputVector(numSamples, 0),
             leftChildNode(NULL),
             rightChildNode(NULL),
             parentNode(NULL) {
                 
     m = MothurOut::getInstance();
     
-    for (int i = 0; i < numSamples; i++) {    // just doing a simple transpose of the matrix
-        if (m->getControl_pressed()) { break; }
-        for (int j = 0; j < numFeatures; j++) { bootstrappedFeatureVectors[j][i] = bootstrappedTrainingSamples[i][j]; }
-    }
-    
-    for (int i = 0; i < numSamples; i++) { if (m->getControl_pressed()) { break; }
-        bootstrappedOutputVector[i] = bootstrappedTrainingSamples[i][numFeatures]; }
+    for (int i = 0; i < numSamples; i++) { bootstrappedOutputVector[i] = dataSet.getOutcome(bootstrappedTrainingSamples[i]); }
     
-    createLocalDiscardedFeatureList();
     updateNodeEntropy();
 }
 /***********************************************************************/
-int RFTreeNode::createLocalDiscardedFeatureList(){
-    try {
-        Utils util;
-        for (int i = 0; i < numFeatures; i++) {
-                // TODO: need to check if bootstrappedFeatureVectors == numFeatures, in python code we are using bootstrappedFeatureVectors instead of numFeatures
-            if (m->getControl_pressed()) { return 0; } 
-            vector<int>::iterator it = find(globalDiscardedFeatureIndices.begin(), globalDiscardedFeatureIndices.end(), i);
-            if (it == globalDiscardedFeatureIndices.end()) {                           // NOT FOUND
-                double standardDeviation = util.getStandardDeviation(bootstrappedFeatureVectors[i]);  
-                if (standardDeviation <= featureStandardDeviationThreshold) { localDiscardedFeatureIndices.push_back(i); }
-            }
-        }
-        
-        return 0;
-    }
-    catch(exception& e) {
-        m->errorOut(e, "RFTreeNode", "createLocalDiscardedFeatureList");
-        exit(1);
-    }  
-}
-/***********************************************************************/
 int RFTreeNode::updateNodeEntropy() {
     try {
         
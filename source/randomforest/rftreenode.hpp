@@ -11,13 +11,14 @@
 
 #include "mothurout.h"
 #include "macros.h"
+#include "rfdataset.hpp"
 
 class RFTreeNode{
     
 public:
     
-    RFTreeNode(vector< vector<int> > bootstrappedTrainingSamples,
-               vector<int> globalDiscardedFeatureIndices,
+    RFTreeNode(vector<int> bootstrappedTrainingSamples, //indexes of the node's samples in dataSet, with repeats
+               const RFDataSet& dataSet,
                int numFeatures,
                int numSamples,
                int numOutputClasses,
@@ -32,7 +33,7 @@ public:
     // plus we do not modify the value as well
     const int getSplitFeatureIndex() { return splitFeatureIndex; }
     // TODO: check if this works properly or returs a shallow copy of the data
-    const vector< vector<int> >& getBootstrappedTrainingSamples() { return bootstrappedTrainingSamples; }
+    const vector<int>& getBootstrappedTrainingSamples() { return bootstrappedTrainingSamples; }
     const int getSplitFeatureValue() { return splitFeatureValue; }
     const int getGeneration() { return generation; }
     const bool checkIsLeaf() { return isLeaf; }
@@ -43,8 +44,6 @@ public:
     const int getOutputClass() { return outputClass; }
     const int getNumSamples() { return numSamples; }
     const int getNumFeatures() { return numFeatures; }
-    const vector<int>& getLocalDiscardedFeatureIndices() { return localDiscardedFeatureIndices; }
-    const vector< vector<int> >& getBootstrappedFeatureVectors() { return bootstrappedFeatureVectors; }
     const vector<int>& getBootstrappedOutputVector() { return bootstrappedOutputVector; }
     const vector<int>& getFeatureSubsetIndices() { return featureSubsetIndices; }
     const double getOwnEntropy() { return ownEntropy; }
@@ -67,10 +66,7 @@ public:
     friend class AbstractDecisionTree;
     
 private:
-    vector<vector<int> > bootstrappedTrainingSamples;
-    vector<int> globalDiscardedFeatureIndices;
-    vector<int> localDiscardedFeatureIndices;
-    vector<vector<int> > bootstrappedFeatureVectors;
+    vector<int> bootstrappedTrainingSamples;
     vector<int> bootstrappedOutputVector;
     vector<int> featureSubsetIndices;
 
@@ -95,7 +91,6 @@ private:
     
     MothurOut* m;
     
-    int createLocalDiscardedFeatureList();
     int updateNodeEntropy();
     
 };
@@ -9,37 +9,117 @@
 
 #include "rarecalc.h"
 
+/***********************************************************************/
+//the size of an otu is its abundance
+RareCalc::RareCalc(SAbundVector* rank) : numSeqs(rank->getNumSeqs()), numBins(rank->getNumBins()) {
+	try {
+		m = MothurOut::getInstance();
+		
+		int maxRank = rank->getMaxRank();
+		for (int i = 1; i <= maxRank; i++) {
+			if (rank->get(i) != 0) { sizes.push_back(i); sizeCounts.push_back(rank->get(i)); }
+		}
+		
+		//a pair misses n_i + n_j sequences
+		pairCounts.resize(2*maxRank+1, 0);
+		for (int i = 0; i < sizes.size(); i++) {
+			for (int j = 0; j < sizes.size(); j++) {
+				if (i == j)	{	pairCounts[sizes[i]+sizes[j]] += sizeCounts[i] * (sizeCounts[i] - 1);	}
+				else		{	pairCounts[sizes[i]+sizes[j]] += sizeCounts[i] * sizeCounts[j];			}
+			}
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "RareCalc", "RareCalc");
+		exit(1);
+	}
+}
+/***********************************************************************/
+//the size of an otu is the number of groups it is found in. Otus found in the same groups are counted together, so
+//the pairs are of distinct patterns of presence
+RareCalc::RareCalc(vector<SharedRAbundVector*> lookup) : numSeqs(lookup.size()), numBins(0) {
+	try {
+		m = MothurOut::getInstance();
+		
+		int numWords = (numSeqs + 63) / 64;
+		map<vector<unsigned long long>, double> patterns;
+		
+		for (int k = 0; k < lookup[0]->getNumBins(); k++) {
+			vector<unsigned long long> pattern(numWords, 0);
+			bool found = false;
+			for (int i = 0; i < lookup.size(); i++) {
+				if (lookup[i]->get(k) != 0) { pattern[i/64] |= (1ULL << (i%64)); found = true; }
+			}
+			if (found) { patterns[pattern]++; numBins++; }
+		}
+		
+		vector< vector<unsigned long long> > distinct;
+		vector<double> distinctCounts;
+		vector<int> distinctSizes;
+		for (map<vector<unsigned long long>, double>::iterator it = patterns.begin(); it != patterns.end(); it++) {
+			distinct.push_back(it->first); distinctCounts.push_back(it->second);
+			
+			int size = 0;
+			for (int w = 0; w < numWords; w++) { unsigned long long word = it->first[w]; while (word != 0) { word &= (word-1); size++; } }
+			distinctSizes.push_back(size);
+		}
+		
+		vector<double> counts(numSeqs+1, 0);
+		for (int i = 0; i < distinct.size(); i++) { counts[distinctSizes[i]] += distinctCounts[i]; }
+		for (int i = 1; i <= numSeqs; i++) {
+			if (counts[i] != 0) { sizes.push_back(i); sizeCounts.push_back(counts[i]); }
+		}
+		
+		//a pair misses the groups either otu is found in
+		pairCounts.resize(numSeqs+1, 0);
+		for (int i = 0; i < distinct.size(); i++) {
+			if (m->getControl_pressed()) { break; }
+			
+			pairCounts[distinctSizes[i]] += distinctCounts[i] * (distinctCounts[i] - 1);
+			
+			for (int j = i+1; j < distinct.size(); j++) {
+				int size = 0;
+				for (int w = 0; w < numWords; w++) { unsigned long long word = distinct[i][w] | distinct[j][w]; while (word != 0) { word &= (word-1); size++; } }
+				pairCounts[size] += 2 * distinctCounts[i] * distinctCounts[j];
+			}
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "RareCalc", "RareCalc");
+		exit(1);
+	}
+}
 /***********************************************************************/
 
 EstOutput RareCalc::getValues(int n){
 	try {
 		EstOutput output(3,0);
-
-		double richness = (double)numBins;
-		double varS = 0.0000;
-	
-		double varTerm1 = 0.0000;
-		double varTerm2 = 0.0000;
-	
-		double rSummation = 0;
-		for(int i=0;i<numBins;i++){
-			int N_ni = numSeqs - bins->get(i);
-			rSummation += (bMatrix[N_ni][n]);
 		
-			varTerm1 += (bMatrix[N_ni][n] * (1.0 - bMatrix[N_ni][n] / bMatrix[numSeqs][n]));
-
-			for(int j=i+1;j<numBins;j++){
-				varTerm2 += ( bMatrix[N_ni-bins->get(j)][n] - bMatrix[N_ni][n] * bMatrix[numSeqs-bins->get(j)][n] / bMatrix[numSeqs][n]);
-			}
+		//q[i] = C(N-i, n) / C(N, n), built up as a product so there are no large binomials
+		vector<double> q(pairCounts.size(), 0);
+		q[0] = 1.0;
+		for (int i = 1; i < q.size(); i++) {
+			if ((numSeqs - n - i + 1) <= 0) { break; }
+			q[i] = q[i-1] * (double)(numSeqs - n - i + 1) / (double)(numSeqs - i + 1);
+			if (q[i] == 0) { break; }
+		}
 		
+		double missed = 0;
+		for (int i = 0; i < sizes.size(); i++) { missed += sizeCounts[i] * q[sizes[i]]; }
+		
+		double pairsMissed = 0;
+		for (int i = 0; i < pairCounts.size(); i++) {
+			if (q[i] == 0) { break; }
+			pairsMissed += pairCounts[i] * q[i];
 		}
-		richness -= (rSummation / bMatrix[numSeqs][n]);
-		varS = (varTerm1 + 2 * varTerm2) / bMatrix[numSeqs][n];
-		float sd = pow(varS, 0.5);
-	
-
+		
+		double richness = (double)numBins - missed;
+		double varS = missed + pairsMissed - missed * missed;
+		if (varS < 0) { varS = 0; } //rounding
+		double sd = sqrt(varS);
+		
 		output[0] = richness;
-		output[1] = richness - 1.96 * sd;	
+		output[1] = richness - 1.96 * sd;
 		output[2] = richness + 1.96 * sd;
 	
 		return output;
@@ -9,7 +9,14 @@
  *
  */
 
-/* This class is not currently used by Mothur */
+/* This class computes the expected number of otus observed in a random subsample without replacement and its
+   variance, the rarefaction of Hurlbert (1971) with the variance of Heck et al. (1975). It is used by the analytic
+   mode of rarefaction.single for sobs, where the subsample is of sequences, and of rarefaction.shared for
+   sharedobserved, where the subsample is of groups. 
+ 
+   If q(m) is the chance a subsample of n from N misses m given items, C(N-m, n) / C(N, n), then
+   E(S_n) = S - sum q(n_i) and Var(S_n) = A + P - A^2, where A = sum q(n_i) and P = sum over pairs of different otus
+   i != j of q(n_ij). n_ij is n_i + n_j for sequences and the number of groups with either otu for groups. */
 
 #include "calculator.h"
 
@@ -17,13 +24,15 @@
 class RareCalc {
 
 public:
-    RareCalc(RAbundVector* b) : bins(b), numSeqs(b->getNumSeqs()), maxRank(b->getMaxRank()), numBins(b->getNumBins()) {	m = MothurOut::getInstance(); Utils util; bMatrix = util.binomial(numSeqs+1); }
-	EstOutput getValues(int);
+    RareCalc(SAbundVector*); //subsamples of sequences
+    RareCalc(vector<SharedRAbundVector*>); //subsamples of groups
+	EstOutput getValues(int); //expected otus observed in a subsample of n, lci and hci
 	string getName()	{	return "rarecalc";	}
 private:
-	RAbundVector* bins;
-	vector<vector<double> > bMatrix;
-	int numSeqs, maxRank, numBins;
+	int numSeqs, numBins; //numSeqs is the number of groups when subsampling groups
+	vector<int> sizes; //distinct otu sizes
+	vector<double> sizeCounts; //number of otus with each size
+	vector<double> pairCounts; //number of ordered pairs of different otus with each combined size
 	MothurOut* m;
 };
 
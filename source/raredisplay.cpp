@@ -64,6 +64,38 @@ void RareDisplay::update(vector<SharedRAbundVector*> shared, int numSeqs, int nu
 	}
 }
 
+/***********************************************************************/
+void RareDisplay::updateExact(int numSeqs, vector<double> data) {
+	try {
+		exact[numSeqs] = data;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "RareDisplay", "updateExact");
+		exit(1);
+	}
+}
+/***********************************************************************/
+//the other display's iterations are moved to this one
+void RareDisplay::mergeResults(Display* display) {
+	try {
+		RareDisplay* other = dynamic_cast<RareDisplay*>(display);
+		if (other == NULL) { return; }
+		
+		for (map<int, vector<double> >::iterator it = other->results.begin(); it != other->results.end(); it++) {
+			vector<double>& values = results[it->first];
+			values.insert(values.end(), (it->second).begin(), (it->second).end());
+		}
+		nIters += other->nIters - 1;
+		
+		other->results.clear();
+		other->nIters = 1;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "RareDisplay", "mergeResults");
+		exit(1);
+	}
+}
+
 /***********************************************************************/
 
 void RareDisplay::reset(){
@@ -81,6 +113,8 @@ void RareDisplay::reset(){
 void RareDisplay::close(){
 	try {
 		output->initFile(label);
+		
+		for (map<int, vector<double> >::iterator it = exact.begin(); it != exact.end(); it++) { output->output(it->first, it->second); }
 	
 		for (map<int, vector<double> >::iterator it = results.begin(); it != results.end(); it++) {
 		
@@ -102,6 +136,7 @@ void RareDisplay::close(){
 		
 		nIters = 1;
         results.clear();
+        exact.clear();
 		
 		output->resetFile();
 	}
@@ -17,8 +17,11 @@ public:
 	void reset();
 	void update(SAbundVector*);
 	void update(vector<SharedRAbundVector*> shared, int numSeqs, int numGroupComb, vector<string>);
+	void updateExact(int, vector<double>);
+	void mergeResults(Display*);
 	void close();
 	bool isCalcMultiple() { return estimate->getMultiple(); }
+	string getName() { return estimate->getName(); }
 	
 	void outputTempFiles(string);
 	void inputTempFiles(string);
@@ -28,6 +31,7 @@ private:
 	FileOutput* output;
 	string label;
 	map<int, vector<double> > results; //maps seqCount to results for that number of sequences
+	map<int, vector<double> > exact; //maps seqCount to the estimate, lci and hci when they are computed analytically
 	int nIters;
     vector<string> Groups;
     Utils util;
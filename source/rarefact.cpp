@@ -11,46 +11,33 @@
 //#include "ordervector.hpp"
 
 /***********************************************************************/
-
-int Rarefact::getCurve(float percentFreq = 0.01, int nIters = 1000){
+//replays a shuffle of the sequences for each seed, reporting to the displays every increment sequences
+void driverRarefact(rarefactData* params){
 	try {
 		RarefactionCurveData* rcd = new RarefactionCurveData();
-		for(int i=0;i<displays.size();i++){ rcd->registerDisplay(displays[i]); }
+		for(int i=0;i<params->displays.size();i++){ rcd->registerDisplay(params->displays[i]); }
 		
-		//convert freq percentage to number
-		int increment = 1;
-		if (percentFreq < 1.0) {  increment = numSeqs * percentFreq;  }
-		else { increment = percentFreq;  }	
-		
-        driver(rcd, increment, nIters);
-
-		for(int i=0;i<displays.size();i++){ displays[i]->close(); }
+		int numSeqs = params->order.size();
+		int increment = params->increment;
+		vector<int> order;
 		
-		delete rcd;
-		return 0;
-	}
-	catch(exception& e) {
-		m->errorOut(e, "Rarefact", "getCurve");
-		exit(1);
-	}
-}
-/***********************************************************************/
-int Rarefact::driver(RarefactionCurveData* rcd, int increment, int nIters = 1000){
-	try {
-			
-		for(int iter=0;iter<nIters;iter++){
+		for(int iter=0;iter<params->seeds.size();iter++){
 		
-			for(int i=0;i<displays.size();i++){ displays[i]->init(label); }
+			for(int i=0;i<params->displays.size();i++){ params->displays[i]->init(params->label); }
 		
-			RAbundVector* lookup	= new RAbundVector(order.getNumBins());
-			SAbundVector* rank	= new SAbundVector(order.getMaxRank()+1);
-			util.mothurRandomShuffle(order);
+			RAbundVector* lookup	= new RAbundVector(params->numBins);
+			SAbundVector* rank	= new SAbundVector(params->maxRank+1);
+			
+			//each iteration starts from the original order, so it only depends on its seed
+			order = params->order;
+			mt19937_64 engine(params->seeds[iter]);
+			shuffle(order.begin(), order.end(), engine);
 		
 			for(int i=0;i<numSeqs;i++){
 			
-				if (m->getControl_pressed()) { delete lookup; delete rank; delete rcd; return 0;  }
+				if (params->m->getControl_pressed()) { delete lookup; delete rank; delete rcd; return;  }
 			
-				int binNumber = order.get(i);
+				int binNumber = order[i];
 				int abundance = lookup->get(binNumber);
 			
 				rank->set(abundance, rank->get(abundance)-1);
@@ -59,52 +46,42 @@ int Rarefact::driver(RarefactionCurveData* rcd, int increment, int nIters = 1000
 				lookup->set(binNumber, abundance);
 				rank->set(abundance, rank->get(abundance)+1);
 
-				if((i == 0) || ((i+1) % increment == 0) || (ends.count(i+1) != 0)){ rcd->updateRankData(rank); }
+				if((i == 0) || ((i+1) % increment == 0) || (params->ends.count(i+1) != 0)){ rcd->updateRankData(rank); }
 			}
 	
-			if((numSeqs % increment != 0) || (ends.count(numSeqs) != 0)){ rcd->updateRankData(rank); }
+			if((numSeqs % increment != 0) || (params->ends.count(numSeqs) != 0)){ rcd->updateRankData(rank); }
 
-			for(int i=0;i<displays.size();i++){ displays[i]->reset(); }
+			for(int i=0;i<params->displays.size();i++){ params->displays[i]->reset(); }
 			
 			delete lookup;
 			delete rank;
 		}
-
-		return 0;
+		
+		delete rcd;
 	}
 	catch(exception& e) {
-		m->errorOut(e, "Rarefact", "driverRarefact");
+		params->m->errorOut(e, "Rarefact", "driverRarefact");
 		exit(1);
 	}
 }
 /***********************************************************************/
-int Rarefact::getSharedCurve(float percentFreq = 0.01, int nIters = 1000){
-try {
+//adds the groups one at a time, in a random order for each seed if jumble is set
+void driverSharedRarefact(rarefactData* params){
+	try {
 		SharedRarefactionCurveData* rcd = new SharedRarefactionCurveData();
+		for(int i=0;i<params->displays.size();i++){ rcd->registerDisplay(params->displays[i]); }
 		
-		label = lookup[0]->getLabel();
+		vector<SharedRAbundVector*> lookup;
 		
-		//register the displays
-		for(int i=0;i<displays.size();i++){
-			rcd->registerDisplay(displays[i]);
-		}
+		for(int iter=0;iter<params->seeds.size();iter++){
 		
-		//if jumble is false all iters will be the same
-		if (!jumble)  {  nIters = 1;  }
-		
-		//convert freq percentage to number
-		int increment = 1;
-		if (percentFreq < 1.0) {  increment = numSeqs * percentFreq;  }
-		else { increment = percentFreq;  }
-		
-		for(int iter=0;iter<nIters;iter++){
-		
-			for(int i=0;i<displays.size();i++){
-				displays[i]->init(label);		  
+			for(int i=0;i<params->displays.size();i++){
+				params->displays[i]->init(params->label);		  
 			}
 			
             //randomize the groups
-			if (jumble)  { util.mothurRandomShuffle(lookup); }
+			lookup = params->lookup;
+			if (params->jumble)  { mt19937_64 engine(params->seeds[iter]); shuffle(lookup.begin(), lookup.end(), engine); }
 			
 			//make merge the size of lookup[0]
 			SharedRAbundVector* merge = new SharedRAbundVector(lookup[0]->getNumBins());
@@ -115,29 +92,187 @@ try {
 			vector<SharedRAbundVector*> subset;
 			//send each group one at a time
 			for (int k = 0; k < lookup.size(); k++) { 
-				if (m->getControl_pressed()) {  delete merge; delete rcd; return 0;  }
+				if (params->m->getControl_pressed()) {  delete merge; delete rcd; return;  }
 				
 				subset.clear(); //clears out old pair of sharedrabunds
 				//add in new pair of sharedrabunds
 				subset.push_back(merge); subset.push_back(lookup[k]);
 				
-				rcd->updateSharedData(subset, k+1, numGroupComb);
-				mergeVectors(merge, lookup[k]);
+				rcd->updateSharedData(subset, k+1, params->numGroupComb);
+				
+				//merge new species into merge
+				for (int j = 0; j < merge->getNumBins(); j++) { merge->set(j, (merge->get(j) + lookup[k]->get(j))); }
 			}
 
 			//resets output files
-			for(int i=0;i<displays.size();i++){
-				displays[i]->reset();
+			for(int i=0;i<params->displays.size();i++){
+				params->displays[i]->reset();
 			}
 			
 			delete merge;
 		}
 		
+		delete rcd;
+	}
+	catch(exception& e) {
+		params->m->errorOut(e, "Rarefact", "driverSharedRarefact");
+		exit(1);
+	}
+}
+/***********************************************************************/
+void driverRareCalc(rareCalcData* params) {
+	try {
+		for (int i = 0; i < params->sizes.size(); i++) { params->values.push_back(params->calc->getValues(params->sizes[i])); }
+	}
+	catch(exception& e) {
+		MothurOut::getInstance()->errorOut(e, "Rarefact", "driverRareCalc");
+		exit(1);
+	}
+}
+/***********************************************************************/
+
+int Rarefact::getCurve(float percentFreq = 0.01, int nIters = 1000){
+	try {
+		//convert freq percentage to number
+		int increment = 1;
+		if (percentFreq < 1.0) {  increment = numSeqs * percentFreq;  }
+		else { increment = percentFreq;  }	
+		
+		vector<int> randomDisplays;
+		vector<int> exactDisplays = getExactDisplays("sobs", randomDisplays);
+		
+		if (exactDisplays.size() != 0) {
+			//the sizes the randomized curve reports
+			vector<int> sizes;
+			for (int i = 1; i <= numSeqs; i++) {
+				if ((i == 1) || (i % increment == 0) || (ends.count(i) != 0)) { sizes.push_back(i); }
+			}
+			if ((sizes.size() == 0) || (sizes.back() != numSeqs)) { sizes.push_back(numSeqs); }
+			
+			SAbundVector rank = order.getSAbundVector();
+			RareCalc calc(&rank);
+			runExact(&calc, exactDisplays, sizes);
+		}
+		
+		if (randomDisplays.size() != 0) {
+			vector<int> bins = order.get();
+			
+			vector<unsigned long long> seeds;
+			for (int i = 0; i < nIters; i++) { seeds.push_back((unsigned long long)util.getRandomNumber()); }
+			
+			int processors = min((int)threadDisplays.size()+1, nIters);
+			
+			vector<thread*> workerThreads;
+			vector<rarefactData*> data;
+			
+			for (int t = 0; t < processors; t++) {
+				vector<Display*> theseDisplays;
+				for (int i = 0; i < randomDisplays.size(); i++) {
+					if (t == 0) { theseDisplays.push_back(displays[randomDisplays[i]]); }
+					else { theseDisplays.push_back(threadDisplays[t-1][randomDisplays[i]]); }
+				}
+				
+				rarefactData* dataBundle = new rarefactData(theseDisplays, label);
+				for (int i = t; i < nIters; i += processors) { dataBundle->seeds.push_back(seeds[i]); }
+				dataBundle->order = bins;
+				dataBundle->ends = ends;
+				dataBundle->increment = increment;
+				dataBundle->numBins = order.getNumBins();
+				dataBundle->maxRank = order.getMaxRank();
+				data.push_back(dataBundle);
+				
+				if (t != 0) { workerThreads.push_back(new thread(driverRarefact, dataBundle)); }
+			}
+			
+			driverRarefact(data[0]);
+			
+			for (int i = 0; i < workerThreads.size(); i++) {
+				workerThreads[i]->join();
+				delete workerThreads[i];
+			}
+			
+			for (int t = 1; t < processors; t++) {
+				for (int i = 0; i < randomDisplays.size(); i++) { displays[randomDisplays[i]]->mergeResults(threadDisplays[t-1][randomDisplays[i]]); }
+			}
+			
+			for (int i = 0; i < data.size(); i++) { delete data[i]; }
+		}
+
+		for(int i=0;i<displays.size();i++){ displays[i]->close(); }
+		
+		return 0;
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Rarefact", "getCurve");
+		exit(1);
+	}
+}
+/***********************************************************************/
+int Rarefact::getSharedCurve(float percentFreq = 0.01, int nIters = 1000){
+try {
+		label = lookup[0]->getLabel();
+		
+		//if jumble is false all iters will be the same
+		if (!jumble)  {  nIters = 1;  }
+		
+		//the expected curve is over random orders of the groups
+		vector<int> randomDisplays;
+		vector<int> exactDisplays;
+		if (jumble) { exactDisplays = getExactDisplays("sharedsobs", randomDisplays); }
+		else { for (int i = 0; i < displays.size(); i++) { randomDisplays.push_back(i); } }
+		
+		if (exactDisplays.size() != 0) {
+			vector<int> sizes;
+			for (int i = 1; i <= lookup.size(); i++) { sizes.push_back(i); }
+			
+			RareCalc calc(lookup);
+			runExact(&calc, exactDisplays, sizes);
+		}
+		
+		if (randomDisplays.size() != 0) {
+			vector<unsigned long long> seeds;
+			for (int i = 0; i < nIters; i++) { seeds.push_back((unsigned long long)util.getRandomNumber()); }
+			
+			int processors = min((int)threadDisplays.size()+1, nIters);
+			
+			vector<thread*> workerThreads;
+			vector<rarefactData*> data;
+			
+			for (int t = 0; t < processors; t++) {
+				vector<Display*> theseDisplays;
+				for (int i = 0; i < randomDisplays.size(); i++) {
+					if (t == 0) { theseDisplays.push_back(displays[randomDisplays[i]]); }
+					else { theseDisplays.push_back(threadDisplays[t-1][randomDisplays[i]]); }
+				}
+				
+				rarefactData* dataBundle = new rarefactData(theseDisplays, label);
+				for (int i = t; i < nIters; i += processors) { dataBundle->seeds.push_back(seeds[i]); }
+				dataBundle->lookup = lookup;
+				dataBundle->jumble = jumble;
+				dataBundle->numGroupComb = numGroupComb;
+				data.push_back(dataBundle);
+				
+				if (t != 0) { workerThreads.push_back(new thread(driverSharedRarefact, dataBundle)); }
+			}
+			
+			driverSharedRarefact(data[0]);
+			
+			for (int i = 0; i < workerThreads.size(); i++) {
+				workerThreads[i]->join();
+				delete workerThreads[i];
+			}
+			
+			for (int t = 1; t < processors; t++) {
+				for (int i = 0; i < randomDisplays.size(); i++) { displays[randomDisplays[i]]->mergeResults(threadDisplays[t-1][randomDisplays[i]]); }
+			}
+			
+			for (int i = 0; i < data.size(); i++) { delete data[i]; }
+		}
+		
 		for(int i=0;i<displays.size();i++){
 			displays[i]->close();
 		}
 		
-		delete rcd;
 		return 0;
 	}
 	catch(exception& e) {
@@ -145,18 +280,62 @@ try {
 		exit(1);
 	}
 }
-
 /**************************************************************************************/
-void Rarefact::mergeVectors(SharedRAbundVector* shared1, SharedRAbundVector* shared2) {
-	try{
-		for (int k = 0; k < shared1->getNumBins(); k++) {
-			//merge new species into shared1
-			shared1->set(k, (shared1->get(k) + shared2->get(k)));  //set to 'combo' since this vector now contains multiple groups
+vector<int> Rarefact::getExactDisplays(string calcName, vector<int>& randomDisplays) {
+	try {
+		vector<int> exactDisplays;
+		
+		for (int i = 0; i < displays.size(); i++) {
+			if (analytic && (displays[i]->getName() == calcName)) { exactDisplays.push_back(i); }
+			else { randomDisplays.push_back(i); }
 		}
+		
+		return exactDisplays;
 	}
 	catch(exception& e) {
-		m->errorOut(e, "Rarefact", "mergeVectors");
+		m->errorOut(e, "Rarefact", "getExactDisplays");
 		exit(1);
 	}
 }
+/**************************************************************************************/
+//the sizes are split between the threads
+void Rarefact::runExact(RareCalc* calc, vector<int> exactDisplays, vector<int> sizes) {
+	try {
+		int processors = min((int)threadDisplays.size()+1, (int)sizes.size());
+		
+		vector<thread*> workerThreads;
+		vector<rareCalcData*> data;
+		
+		for (int t = 0; t < processors; t++) {
+			int start = (sizes.size() * t) / processors;
+			int end = (sizes.size() * (t+1)) / processors;
+			
+			rareCalcData* dataBundle = new rareCalcData(calc, vector<int>(sizes.begin()+start, sizes.begin()+end));
+			data.push_back(dataBundle);
+			
+			if (t != 0) { workerThreads.push_back(new thread(driverRareCalc, dataBundle)); }
+		}
+		
+		driverRareCalc(data[0]);
+		
+		for (int i = 0; i < workerThreads.size(); i++) {
+			workerThreads[i]->join();
+			delete workerThreads[i];
+		}
+		
+		for (int i = 0; i < exactDisplays.size(); i++) { displays[exactDisplays[i]]->init(label); }
+		
+		for (int t = 0; t < data.size(); t++) {
+			for (int j = 0; j < data[t]->sizes.size(); j++) {
+				for (int i = 0; i < exactDisplays.size(); i++) { displays[exactDisplays[i]]->updateExact(data[t]->sizes[j], data[t]->values[j]); }
+			}
+			delete data[t];
+		}
+	}
+	catch(exception& e) {
+		m->errorOut(e, "Rarefact", "runExact");
+		exit(1);
+	}
+}
+/**************************************************************************************/
 
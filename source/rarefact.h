@@ -4,16 +4,20 @@
 #include "rarefactioncurvedata.h"
 #include "raredisplay.h"
 #include "ordervector.hpp"
+#include "rarecalc.h"
 #include "mothur.h"
 
+/* The randomized curves are run in parallel, iteration i by thread i % processors. Each thread has its own copy of the
+   displays, since the calculators are not thread safe, and the iterations each have their own seed, so the curves do not
+   depend on the number of processors. In analytic mode sobs and sharedobserved are computed by RareCalc instead. */
 
 class Rarefact {
 	
 public:
-	Rarefact(OrderVector& o, vector<Display*> disp, set<int> en) :
-    numSeqs(o.getNumSeqs()), order(o), displays(disp), label(o.getLabel()),  ends(en)  { m = MothurOut::getInstance(); jumble = false; }
-	Rarefact(vector<SharedRAbundVector*> shared, vector<Display*> disp, bool j) :
-					 lookup(shared), displays(disp), jumble(j) {  m = MothurOut::getInstance(); }
+	Rarefact(OrderVector& o, vector<Display*> disp, set<int> en, bool a, vector< vector<Display*> > td) :
+    numSeqs(o.getNumSeqs()), order(o), displays(disp), label(o.getLabel()),  ends(en), analytic(a), threadDisplays(td)  { m = MothurOut::getInstance(); jumble = false; }
+	Rarefact(vector<SharedRAbundVector*> shared, vector<Display*> disp, bool j, bool a, vector< vector<Display*> > td) :
+					 lookup(shared), displays(disp), jumble(j), analytic(a), threadDisplays(td) {  m = MothurOut::getInstance(); }
 
 	~Rarefact(){};
 	int getCurve(float, int);
@@ -26,16 +30,49 @@ private:
 	int numSeqs, numGroupComb;
 	string label;
     set<int> ends;
-	void mergeVectors(SharedRAbundVector*, SharedRAbundVector*);
 	vector<SharedRAbundVector*> lookup;
 	MothurOut* m;
-    bool jumble;
+    bool jumble, analytic;
+    vector< vector<Display*> > threadDisplays; //a copy of the displays for each thread after the first
     Utils util;
 	
-	int driver(RarefactionCurveData*, int, int);
+	vector<int> getExactDisplays(string, vector<int>&); //calculator name, the rest of the displays. Returns the displays computed analytically
+	void runExact(RareCalc*, vector<int>, vector<int>); //displays, subsample sizes
+};
 
+/***********************************************************************/
+//the iterations of one thread
+struct rarefactData {
+	vector<Display*> displays;
+	vector<unsigned long long> seeds; //one per iteration
+	string label;
+	MothurOut* m;
+	
+	//rarefaction.single
+	vector<int> order; //otu of each sequence
+	set<int> ends;
+	int increment, numBins, maxRank;
+	
+	//rarefaction.shared
+	vector<SharedRAbundVector*> lookup;
+	bool jumble;
+	int numGroupComb;
+	
+	rarefactData(){}
+	rarefactData(vector<Display*> d, string l) : displays(d), label(l), increment(1), numBins(0), maxRank(0), jumble(false), numGroupComb(0) { m = MothurOut::getInstance(); }
 };
 
+/***********************************************************************/
 
-#endif
+struct rareCalcData {
+	RareCalc* calc;
+	vector<int> sizes;
+	vector< vector<double> > values; //estimate, lci and hci for each size
+	
+	rareCalcData(){}
+	rareCalcData(RareCalc* c, vector<int> s) : calc(c), sizes(s) {}
+};
+
+/***********************************************************************/
 
+#endif
@@ -81,14 +81,7 @@ int FormatColumnMatrix::read(NameAssignment* nameMap){
 		//sort file by first column so the distances for each row are together
 		string outfile = util.getRootName(squareFile) + "sorted.dist.temp";
 		
-		//use the unix sort 
-		#if defined NON_WINDOWS
-			string command = "sort -n " + squareFile + " -o " + outfile;
-			system(command.c_str());
-		#else //sort using windows sort
-			string command = "sort " + squareFile + " /O " + outfile;
-			system(command.c_str());
-		#endif
+		util.sortFileNumeric(squareFile, outfile, 1);
 		
 		if (m->getControl_pressed()) { util.mothurRemove(tempOutFile); util.mothurRemove(outfile); delete reading; return 0; }
 
@@ -244,14 +237,7 @@ int FormatColumnMatrix::read(CountTable* nameMap){
 		//sort file by first column so the distances for each row are together
 		string outfile = util.getRootName(squareFile) + "sorted.dist.temp";
 		
-		//use the unix sort 
-#if defined NON_WINDOWS
-        string command = "sort -n " + squareFile + " -o " + outfile;
-        system(command.c_str());
-#else //sort using windows sort
-        string command = "sort " + squareFile + " /O " + outfile;
-        system(command.c_str());
-#endif
+		util.sortFileNumeric(squareFile, outfile, 1);
 		
 		if (m->getControl_pressed()) { util.mothurRemove(tempOutFile); util.mothurRemove(outfile); delete reading; return 0; }
         
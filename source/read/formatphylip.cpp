@@ -102,14 +102,7 @@ int FormatPhylipMatrix::read(NameAssignment* nameMap){
 				//sort file by first column so the distances for each row are together
 				string outfile = util.getRootName(tempFile) + "sorted.dist.temp";
 				
-				//use the unix sort 
-				#if defined NON_WINDOWS
-					string command = "sort -n " + tempFile + " -o " + outfile;
-					system(command.c_str());
-				#else //sort using windows sort
-					string command = "sort " + tempFile + " /O " + outfile;
-					system(command.c_str());
-				#endif
+				util.sortFileNumeric(tempFile, outfile, 1);
 				
 				if (m->getControl_pressed()) { util.mothurRemove(tempFile); util.mothurRemove(outfile);  delete reading; return 0; }
 
@@ -332,14 +325,7 @@ int FormatPhylipMatrix::read(CountTable* nameMap){
             //sort file by first column so the distances for each row are together
             string outfile = util.getRootName(tempFile) + "sorted.dist.temp";
             
-            //use the unix sort 
-#if defined NON_WINDOWS
-            string command = "sort -n " + tempFile + " -o " + outfile;
-            system(command.c_str());
-#else //sort using windows sort
-            string command = "sort " + tempFile + " /O " + outfile;
-            system(command.c_str());
-#endif
+            util.sortFileNumeric(tempFile, outfile, 1);
             
             if (m->getControl_pressed()) { util.mothurRemove(tempFile); util.mothurRemove(outfile);  delete reading; return 0; }
             
@@ -113,12 +113,12 @@ int SplitMatrix::splitClassify(){
 		for (int i = 0; i < phylo->getNumNodes(); i++) {
 		
 			//is this node within the cutoff
-			TaxNode taxon = phylo->get(i);
+			const TaxNode& taxon = phylo->get(i);
 	
 			if (taxon.level == cutoff) {//if yes, then create group containing this nodes sequences
 				if (taxon.accessions.size() > 1) { //if this taxon just has one seq its a singleton
 					for (int j = 0; j < taxon.accessions.size(); j++) {
-						seqGroup[taxon.accessions[j]] = numGroups;
+						seqGroup[phylo->getSeqName(taxon.accessions[j])] = numGroups;
 					}
 					numGroups++;
 				}
@@ -276,9 +276,9 @@ int seqNoise::getListData(string listFileName, double cutOff, vector<int>& otuDa
 }
 
 /**************************************************************************************************/
-int seqNoise::updateOTUCountData(vector<int> otuFreq,
-								 vector<vector<int> > otuBySeqLookUp,
-								 vector<vector<int> > aanI,
+int seqNoise::updateOTUCountData(const vector<int>& otuFreq,
+								 const vector<vector<int> >& otuBySeqLookUp,
+								 const vector<vector<int> >& aanI,
 								 vector<int>& anP,
 								 vector<int>& anI,
 								 vector<int>& cumCount
@@ -311,20 +311,18 @@ int seqNoise::updateOTUCountData(vector<int> otuFreq,
 /**************************************************************************************************/
 double seqNoise::calcNewWeights(
 					  vector<double>& weights,	//
-					  vector<int> seqFreq,		//
-					  vector<int> anI,			//
-					  vector<int> cumCount,		//
-					  vector<int> anP,			//
-					  vector<int> otuFreq,		//
-					  vector<double> tau		//
+					  const vector<int>& seqFreq,		//
+					  const vector<int>& anI,			//
+					  const vector<int>& cumCount,		//
+					  const vector<int>& anP,			//
+					  const vector<int>& otuFreq,		//
+					  const vector<double>& tau		//
 					  ){
 	try {
 		
 		int numOTUs = weights.size();
 		double maxChange = -1;
 		
-		cout.flush();
-		
 		for(int i=0;i<numOTUs;i++){
 			
 			if (m->getControl_pressed()) { return 0; }
@@ -346,7 +344,6 @@ double seqNoise::calcNewWeights(
 			change = fabs(weights[i] - change);
 			
 			if(change > maxChange){	maxChange = change;	}
-			cout.flush();
 		}
 		return maxChange;
 		
@@ -359,24 +356,25 @@ double seqNoise::calcNewWeights(
 
 /**************************************************************************************************/
 
-int seqNoise::calcCentroids(
-				   vector<int> anI,
-				   vector<int> anP,
-				   vector<int>& change, 
-				   vector<int>& centroids, 
-				   vector<int> cumCount,
-				   vector<double> distances,///
-				   vector<int> seqFreq, 
-				   vector<int> otuFreq, 
-				   vector<double> tau 
-				   ){
+void driverSeqNoiseCentroids(seqNoiseCentroidData* params){
 	try {
-		int numOTUs = change.size();
+		const vector<int>& anI = *params->anI;
+		const vector<int>& anP = *params->anP;
+		vector<int>& change = *params->change;
+		vector<int>& centroids = *params->centroids;
+		const vector<int>& cumCount = *params->cumCount;
+		const vector<double>& distances = *params->distances;
+		const vector<int>& seqFreq = *params->seqFreq;
+		const vector<int>& otuFreq = *params->otuFreq;
+		const vector<double>& tau = *params->tau;
+		
 		int numSeqs = seqFreq.size();
+		vector<double> adF;
+		vector<int> anL;
 		
-		for(int i=0;i<numOTUs;i++){
+		for(int i=params->start;i<params->end;i++){
 			
-			if (m->getControl_pressed()) { return 0; }
+			if (params->m->getControl_pressed()) { break; }
 			
 			int minFIndex = -1;
 			double minFValue = 1e10;
@@ -393,22 +391,21 @@ int seqNoise::calcCentroids(
 			
 			if(freqOfOTU > 0 && count > MIN_COUNT){
 				
-				vector<double> adF(freqOfOTU);
-				vector<int> anL(freqOfOTU);
+				adF.assign(freqOfOTU, 0.0000);
+				anL.resize(freqOfOTU);
 				
 				for(int j=0;j<freqOfOTU;j++){
 					anL[j] = anI[cumCount[i] + j];
-					adF[j] = 0.0000;
 				}
 				
 				for(int j=0;j<freqOfOTU;j++){		
 					int index = cumCount[i] + j;
 					double curTau = tau[anP[index]];
+					const double* distRow = &distances[(size_t)anL[j]*numSeqs];
+					int freq = seqFreq[anL[j]];
 					
 					for(int k=0;k<freqOfOTU;k++){
-						double dist = distances[anL[j]*numSeqs + anL[k]];
-						
-						adF[k] += dist * curTau * seqFreq[anL[j]];
+						adF[k] += distRow[anL[k]] * curTau * freq;
 					}
 				}
 				
@@ -429,6 +426,68 @@ int seqNoise::calcCentroids(
 				centroids[i] = -1;			
 			}
 		}
+	}
+	catch(exception& e) {
+		params->m->errorOut(e, "seqNoise", "driverSeqNoiseCentroids");
+		exit(1);
+	}
+}
+/**************************************************************************************************/
+
+int seqNoise::calcCentroids(
+				   const vector<int>& anI,
+				   const vector<int>& anP,
+				   vector<int>& change, 
+				   vector<int>& centroids, 
+				   const vector<int>& cumCount,
+				   const vector<double>& distances,///
+				   const vector<int>& seqFreq, 
+				   const vector<int>& otuFreq, 
+				   const vector<double>& tau 
+				   ){
+	try {
+		int numOTUs = change.size();
+		
+		int numProcs = processors;
+		if (numProcs > numOTUs) { numProcs = numOTUs; }
+		if (numProcs < 1) { numProcs = 1; }
+		
+		//the otus are independent, the work in each grows with the square of its size
+		double totalWork = 0;
+		for(int i=0;i<numOTUs;i++){ totalWork += 1.0 + (double)otuFreq[i] * (double)otuFreq[i]; }
+		
+		vector<linePair> lines;
+		double sum = 0;
+		int start = 0;
+		for(int i=0;i<numOTUs;i++){
+			sum += 1.0 + (double)otuFreq[i] * (double)otuFreq[i];
+			if ((lines.size() < (numProcs-1)) && (sum >= (totalWork * (lines.size()+1) / (double)numProcs))) {
+				lines.push_back(linePair(start, i+1));
+				start = i+1;
+			}
+		}
+		lines.push_back(linePair(start, numOTUs));
+		
+		//create array of worker threads
+		vector<thread*> workerThreads;
+		vector<seqNoiseCentroidData*> data;
+		
+		//Lauch worker threads
+		for (int i = 1; i < lines.size(); i++) {
+			seqNoiseCentroidData* dataBundle = new seqNoiseCentroidData(&anI, &anP, &change, &centroids, &cumCount, &distances, &seqFreq, &otuFreq, &tau, lines[i].start, lines[i].end);
+			data.push_back(dataBundle);
+			workerThreads.push_back(new thread(driverSeqNoiseCentroids, dataBundle));
+		}
+		
+		seqNoiseCentroidData* dataBundle = new seqNoiseCentroidData(&anI, &anP, &change, &centroids, &cumCount, &distances, &seqFreq, &otuFreq, &tau, lines[0].start, lines[0].end);
+		driverSeqNoiseCentroids(dataBundle);
+		delete dataBundle;
+		
+		for (int i = 0; i < workerThreads.size(); i++) {
+			workerThreads[i]->join();
+			delete workerThreads[i];
+			delete data[i];
+		}
 		
 		return 0;
 	}
@@ -440,7 +499,7 @@ int seqNoise::calcCentroids(
 
 /**************************************************************************************************/
 
-int seqNoise::checkCentroids(vector<double>& weights, vector<int> centroids){
+int seqNoise::checkCentroids(vector<double>& weights, const vector<int>& centroids){
 	try {
 		int numOTUs = centroids.size();
 		vector<int> unique(numOTUs, 1);
@@ -476,7 +535,7 @@ int seqNoise::checkCentroids(vector<double>& weights, vector<int> centroids){
 
 /**************************************************************************************************/
 
-int seqNoise::setUpOTUData(vector<int>& otuData, vector<double>& percentage, vector<int> cumCount, vector<double> tau, vector<int> otuFreq, vector<int> anP, vector<int> anI){
+int seqNoise::setUpOTUData(vector<int>& otuData, vector<double>& percentage, const vector<int>& cumCount, const vector<double>& tau, const vector<int>& otuFreq, const vector<int>& anP, const vector<int>& anI){
 	try {
 
 		int numOTUs = cumCount.size();
@@ -515,7 +574,7 @@ int seqNoise::setUpOTUData(vector<int>& otuData, vector<double>& percentage, vec
 
 /**************************************************************************************************/
 
-int seqNoise::finishOTUData(vector<int> otuData, vector<int>& otuFreq, vector<int>& anP, vector<int>& anI, vector<int>& cumCount, vector<vector<int> >& otuBySeqLookUp, vector<vector<int> >& aanI, vector<double>& tau){
+int seqNoise::finishOTUData(const vector<int>& otuData, vector<int>& otuFreq, vector<int>& anP, vector<int>& anI, vector<int>& cumCount, vector<vector<int> >& otuBySeqLookUp, vector<vector<int> >& aanI, vector<double>& tau){
 	try {
 		int numSeqs = otuData.size();
 		int numOTUs = otuFreq.size();
@@ -39,7 +39,7 @@ struct freqData {
 
 class seqNoise {
 public:
-	seqNoise() { m = MothurOut::getInstance();  }
+	seqNoise() { m = MothurOut::getInstance(); processors = 1; }
 	~seqNoise(){}
 	
 	int getSequenceData(string, vector<string>&);
@@ -48,18 +48,20 @@ public:
 	int addRedundantName(string, string, vector<string>&, vector<string>&, vector<int>&);
     int getDistanceData(string, vector<double>&);
 	int getListData(string, double, vector<int>&, vector<int>&, vector<vector<int> >&);
-	int updateOTUCountData(vector<int>, vector<vector<int> >, vector<vector<int> >, vector<int>&, vector<int>&, vector<int>&);
-	double calcNewWeights(vector<double>&,vector<int>,vector<int>,vector<int>,vector<int>,vector<int>,vector<double>);
-	int calcCentroids(vector<int>,vector<int>,vector<int>&,vector<int>&,vector<int>,vector<double>,vector<int>,vector<int>,vector<double>);
-	int checkCentroids(vector<double>&, vector<int>);
-	int setUpOTUData(vector<int>&, vector<double>&, vector<int>, vector<double>, vector<int>, vector<int>, vector<int>);
-	int finishOTUData(vector<int>, vector<int>&, vector<int>&, vector<int>&, vector<int>&, vector<vector<int> >&, vector<vector<int> >&, vector<double>&);
+	int updateOTUCountData(const vector<int>&, const vector<vector<int> >&, const vector<vector<int> >&, vector<int>&, vector<int>&, vector<int>&);
+	double calcNewWeights(vector<double>&,const vector<int>&,const vector<int>&,const vector<int>&,const vector<int>&,const vector<int>&,const vector<double>&);
+	int calcCentroids(const vector<int>&,const vector<int>&,vector<int>&,vector<int>&,const vector<int>&,const vector<double>&,const vector<int>&,const vector<int>&,const vector<double>&);
+	int checkCentroids(vector<double>&, const vector<int>&);
+	int setUpOTUData(vector<int>&, vector<double>&, const vector<int>&, const vector<double>&, const vector<int>&, const vector<int>&, const vector<int>&);
+	int finishOTUData(const vector<int>&, vector<int>&, vector<int>&, vector<int>&, vector<int>&, vector<vector<int> >&, vector<vector<int> >&, vector<double>&);
 	int writeOutput(string, string, string, vector<int>, vector<int>, vector<int>, vector<string>, vector<string>, vector<string>, vector<int>, vector<double>&);
+	void setProcessors(int p) { processors = p; }
 
 
 private:
 	MothurOut* m;
     Utils util;
+	int processors;
 	
 	int getLastMatch(char, vector<vector<char> >&, int, int, vector<int>&, vector<int>&);
 	int countDiffs(vector<int>, vector<int>);
@@ -68,6 +70,36 @@ private:
 	
 };
 
+/**************************************************************************************************/
+struct seqNoiseCentroidData {
+	const vector<int>* anI;
+	const vector<int>* anP;
+	vector<int>* change;
+	vector<int>* centroids;
+	const vector<int>* cumCount;
+	const vector<double>* distances;
+	const vector<int>* seqFreq;
+	const vector<int>* otuFreq;
+	const vector<double>* tau;
+	int start, end;
+	MothurOut* m;
+	
+	seqNoiseCentroidData(){}
+	seqNoiseCentroidData(const vector<int>* i, const vector<int>* p, vector<int>* ch, vector<int>* ce, const vector<int>* cc, const vector<double>* d, const vector<int>* sf, const vector<int>* of, const vector<double>* t, int st, int en) {
+		m = MothurOut::getInstance();
+		anI = i;
+		anP = p;
+		change = ch;
+		centroids = ce;
+		cumCount = cc;
+		distances = d;
+		seqFreq = sf;
+		otuFreq = of;
+		tau = t;
+		start = st;
+		end = en;
+	}
+};
 /**************************************************************************************************/
 #endif
 
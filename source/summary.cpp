@@ -227,100 +227,107 @@ long long Summary::summarizeFasta(string fastafile, string n, string output) {
     }
 }
 //**********************************************************************************************************************
+//the values Sequence(SequenceReader&) reports for a record, read straight from the record's body. The letters are cleaned
+//up the same way: spaces and unprintable characters are skipped, U becomes T and anything but . - A T G C N is ambiguous
+void summarizeRecord(const TextSpan& body, int& start, int& end, int& numBases, int& ambigs, int& homop, int& numConverted) {
+    start = -1; end = -1; numBases = 0; ambigs = 0; homop = 1; numConverted = 0;
+    
+    int position = 0; int run = 0; char last = 0;
+    for (size_t i = 0; i < body.length; i++) {
+        char letter = body.data[i];
+        if ((letter == ' ') || !isprint((unsigned char)letter)) { continue; }
+        
+        letter = toupper(letter);
+        if (letter == 'U') { letter = 'T'; }
+        position++;
+        
+        if ((letter == '.') || (letter == '-')) { continue; }
+        if ((letter != 'A') && (letter != 'T') && (letter != 'G') && (letter != 'C')) {
+            if (letter != 'N') { numConverted++; letter = 'N'; }
+            ambigs++;
+        }
+        
+        if (start == -1) { start = position; }
+        end = position;
+        numBases++;
+        
+        if (letter == last) { run++; } else { run = 1; last = letter; }
+        if (run > homop) { homop = run; }
+    }
+}
+//**********************************************************************************************************************
 void driverSummarize(seqSumData* params) { //(string fastafile, string output, linePair lines) {
     try {
         ofstream out;
         if (params->summaryFile != "") { params->util.openOutputFile(params->summaryFile, out); }
         
-        ifstream in;
-        params->util.openInputFile(params->filename, in);
-        
-        in.seekg(params->start);
+        SequenceReader in(params->filename, params->start);
         
         //print header if you are process 0
         if (params->start == 0) {
-            params->util.zapGremlins(in); params->util.gobble(in);
-            //print header if you are process 0
             if (params->summaryFile != "") { out << "seqname\tstart\tend\tnbases\tambigs\tpolymer\tnumSeqs" << endl; }
         }
         
         bool done = false;
         params->count = 0;
         
+        TextSpan nameSpan, commentSpan, body;
+        string name;
+        int thisStartPosition, thisEndPosition, thisSeqLength, thisAmbig, thisHomoP, numConverted;
+        
         while (!done) {
             
             if (params->m->getControl_pressed()) {  break; }
             
-            Sequence seq(in); params->util.gobble(in);
+            if (!in.readFasta(nameSpan, commentSpan, body)) { break; }
             
-            if (seq.getName() != "") {
+            //skip commented out sequences and records without names
+            if ((nameSpan.length != 0) && (nameSpan.data[0] != '#')) {
+                
+                name.assign(nameSpan.data, nameSpan.length);
+                params->util.checkName(name);
+                
+                summarizeRecord(body, thisStartPosition, thisEndPosition, thisSeqLength, thisAmbig, thisHomoP, numConverted);
                 
-                if (params->m->getDebug()) { params->m->mothurOut("[DEBUG]: " + seq.getName() + "\t" + toString(seq.getStartPos()) + "\t" + toString(seq.getEndPos()) + "\t" + toString(seq.getNumBases()) + "\n"); }
+                if ((numConverted / (float) thisSeqLength) > 0.25) { params->m->mothurOut("[WARNING]: We found more than 25% of the bases in sequence " + name + " to be ambiguous. Mothur is not setup to process protein sequences."); params->m->mothurOutEndLine(); }
+                
+                if (params->m->getDebug()) { params->m->mothurOut("[DEBUG]: " + name + "\t" + toString(thisStartPosition) + "\t" + toString(thisEndPosition) + "\t" + toString(thisSeqLength) + "\n"); }
                 
-                //string seqInfo = addSeq(current);
                 params->count++;
                 
                 long long num = 1;
                 
                 if (params->hasNameMap) {
                     //make sure this sequence is in the namefile, else error
-                    map<string, int>::iterator itFindName = params->nameMap.find(seq.getName());
+                    map<string, int>::iterator itFindName = params->nameMap->find(name);
                     
-                    if (itFindName == params->nameMap.end()) { params->m->mothurOut("[ERROR]: '" + seq.getName() + "' is not in your name or count file, please correct."); params->m->mothurOutEndLine(); params->m->setControl_pressed(true); }
+                    if (itFindName == params->nameMap->end()) { params->m->mothurOut("[ERROR]: '" + name + "' is not in your name or count file, please correct."); params->m->mothurOutEndLine(); params->m->setControl_pressed(true); }
                     else { num = itFindName->second; }
                 }
                 
-                int thisStartPosition = seq.getStartPos();
-                map<int, long long>::iterator it = params->startPosition.find(thisStartPosition);
-                if (it == params->startPosition.end()) { params->startPosition[thisStartPosition] = num; } //first finding of this start position, set count.
-                else { it->second += num; } //add counts
-                
-                int thisEndPosition = seq.getEndPos();
-                it = params->endPosition.find(thisEndPosition);
-                if (it == params->endPosition.end()) { params->endPosition[thisEndPosition] = num; } //first finding of this end position, set count.
-                else { it->second += num; } //add counts
-                
-                int thisSeqLength = seq.getNumBases();
-                it = params->seqLength.find(thisSeqLength);
-                if (it == params->seqLength.end()) { params->seqLength[thisSeqLength] = num; } //first finding of this length, set count.
-                else { it->second += num; } //add counts
-                
-                int thisAmbig = seq.getAmbigBases();
-                it = params->ambigBases.find(thisAmbig);
-                if (it == params->ambigBases.end()) { params->ambigBases[thisAmbig] = num; } //first finding of this ambig, set count.
-                else { it->second += num; } //add counts
-                
-                int thisHomoP = seq.getLongHomoPolymer();
-                it = params->longHomoPolymer.find(thisHomoP);
-                if (it == params->longHomoPolymer.end()) { params->longHomoPolymer[thisHomoP] = num; } //first finding of this homop, set count.
-                else { it->second += num; } //add counts
-                
-                int numns = seq.getNumNs();
-                it = params->numNs.find(numns);
-                if (it == params->numNs.end()) { params->numNs[numns] = num; } //first finding of this homop, set count.
-                else { it->second += num; } //add counts
+                params->startHist.add(thisStartPosition, num);
+                params->endHist.add(thisEndPosition, num);
+                params->lengthHist.add(thisSeqLength, num);
+                params->ambigHist.add(thisAmbig, num);
+                params->homopHist.add(thisHomoP, num);
+                params->numNsHist.add(thisAmbig, num); //the cleaned up sequence only has A, T, G, C and N, so every ambiguous base is an N
                 
                 params->total += num;
                 
-                string seqInfo = "";
-                seqInfo += seq.getName() + '\t';
-                seqInfo += toString(thisStartPosition) + '\t' + toString(thisEndPosition) + '\t';
-                seqInfo += toString(thisSeqLength) + '\t' + toString(thisAmbig) + '\t';
-                seqInfo += toString(thisHomoP) + '\t' + toString(num);
-                
-                if (params->summaryFile != "") { out << seqInfo << endl; }
+                if (params->summaryFile != "") {
+                    out << name << '\t' << thisStartPosition << '\t' << thisEndPosition << '\t' << thisSeqLength << '\t' << thisAmbig << '\t' << thisHomoP << '\t' << num << '\n';
+                }
             }
             
 #if defined NON_WINDOWS
-            unsigned long long pos = in.tellg();
-            if ((pos == -1) || (pos >= params->end)) { break; }
+            unsigned long long pos = in.getPosition();
+            if (in.eof() || (pos >= params->end)) { break; }
 #else
-            if (params->count == params->end) { break; }
+            if (in.eof() || (params->count == params->end)) { break; }
 #endif
         }
         
         if (params->summaryFile != "") { out.close(); }
-        in.close();
         
     }
     catch(exception& e) {
@@ -361,71 +368,43 @@ long long Summary::summarizeFasta(string fastafile, string output) {
             string outputName = output + extension;
             if (output == "") {  outputName = "";  }
             
-            seqSumData* dataBundle = new seqSumData(fastafile, outputName, lines[i+1].start, lines[i+1].end, hasNameOrCount, nameMap);
+            seqSumData* dataBundle = new seqSumData(fastafile, outputName, lines[i+1].start, lines[i+1].end, hasNameOrCount, &nameMap);
             data.push_back(dataBundle);
             
             workerThreads.push_back(new thread(driverSummarize, dataBundle));
         }
         
-        seqSumData* dataBundle = new seqSumData(fastafile, output, lines[0].start, lines[0].end, hasNameOrCount, nameMap);
+        seqSumData* dataBundle = new seqSumData(fastafile, output, lines[0].start, lines[0].end, hasNameOrCount, &nameMap);
         
         driverSummarize(dataBundle);
         num = dataBundle->count;
         total = dataBundle->total;
-        startPosition = dataBundle->startPosition;
-        endPosition = dataBundle->endPosition;
-        seqLength = dataBundle->seqLength;
-        ambigBases = dataBundle->ambigBases;
-        longHomoPolymer = dataBundle->longHomoPolymer;
-        numNs = dataBundle->numNs;
-        delete dataBundle;
         
         for (int i = 0; i < processors-1; i++) {
             workerThreads[i]->join();
             num += data[i]->count;
             total += data[i]->total;
             
-            for (map<int, long long>::iterator it = data[i]->startPosition.begin(); it != data[i]->startPosition.end(); it++)		{
-                map<int, long long>::iterator itMain = startPosition.find(it->first);
-                if (itMain == startPosition.end()) { //newValue
-                    startPosition[it->first] = it->second;
-                }else { itMain->second += it->second; } //merge counts
-            }
-            for (map<int, long long>::iterator it = data[i]->endPosition.begin(); it != data[i]->endPosition.end(); it++)		{
-                map<int, long long>::iterator itMain = endPosition.find(it->first);
-                if (itMain == endPosition.end()) { //newValue
-                    endPosition[it->first] = it->second;
-                }else { itMain->second += it->second; } //merge counts
-            }
-            for (map<int, long long>::iterator it = data[i]->seqLength.begin(); it != data[i]->seqLength.end(); it++)		{
-                map<int, long long>::iterator itMain = seqLength.find(it->first);
-                if (itMain == seqLength.end()) { //newValue
-                    seqLength[it->first] = it->second;
-                }else { itMain->second += it->second; } //merge counts
-            }
-            for (map<int, long long>::iterator it = data[i]->ambigBases.begin(); it != data[i]->ambigBases.end(); it++)		{
-                map<int, long long>::iterator itMain = ambigBases.find(it->first);
-                if (itMain == ambigBases.end()) { //newValue
-                    ambigBases[it->first] = it->second;
-                }else { itMain->second += it->second; } //merge counts
-            }
-            for (map<int, long long>::iterator it = data[i]->longHomoPolymer.begin(); it != data[i]->longHomoPolymer.end(); it++)		{
-                map<int, long long>::iterator itMain = longHomoPolymer.find(it->first);
-                if (itMain == longHomoPolymer.end()) { //newValue
-                    longHomoPolymer[it->first] = it->second;
-                }else { itMain->second += it->second; } //merge counts
-            }
-            for (map<int, long long>::iterator it = data[i]->numNs.begin(); it != data[i]->numNs.end(); it++)		{
-                map<int, long long>::iterator itMain = numNs.find(it->first);
-                if (itMain == numNs.end()) { //newValue
-                    numNs[it->first] = it->second;
-                }else { itMain->second += it->second; } //merge counts
-            }
-
+            dataBundle->startHist.merge(data[i]->startHist);
+            dataBundle->endHist.merge(data[i]->endHist);
+            dataBundle->lengthHist.merge(data[i]->lengthHist);
+            dataBundle->ambigHist.merge(data[i]->ambigHist);
+            dataBundle->homopHist.merge(data[i]->homopHist);
+            dataBundle->numNsHist.merge(data[i]->numNsHist);
+            
             delete data[i];
             delete workerThreads[i];
         }
         
+        startPosition.clear(); endPosition.clear(); seqLength.clear(); ambigBases.clear(); longHomoPolymer.clear(); numNs.clear();
+        dataBundle->startHist.fill(startPosition);
+        dataBundle->endHist.fill(endPosition);
+        dataBundle->lengthHist.fill(seqLength);
+        dataBundle->ambigHist.fill(ambigBases);
+        dataBundle->homopHist.fill(longHomoPolymer);
+        dataBundle->numNsHist.fill(numNs);
+        delete dataBundle;
+        
         //append files
         for (int i = 0; i < processors-1; i++) {
             string extension = "";
@@ -495,9 +474,9 @@ void driverFastaSummarySummarize(seqSumData* params) {
             if (name != "") {
                 if ((numReps == 1) && params->hasNameMap) {
                     //make sure this sequence is in the namefile, else error
-                    map<string, int>::iterator itFindName = params->nameMap.find(name);
+                    map<string, int>::iterator itFindName = params->nameMap->find(name);
                     
-                    if (itFindName == params->nameMap.end()) { params->m->mothurOut("[ERROR]: '" + name + "' is not in your name or count file, please correct."); params->m->mothurOutEndLine(); params->m->setControl_pressed(true); }
+                    if (itFindName == params->nameMap->end()) { params->m->mothurOut("[ERROR]: '" + name + "' is not in your name or count file, please correct."); params->m->mothurOutEndLine(); params->m->setControl_pressed(true); }
                     else { numReps = itFindName->second; }
                 }
                 
@@ -569,13 +548,13 @@ long long Summary::summarizeFastaSummary(string summaryfile) {
         
         //Lauch worker threads
         for (int i = 0; i < processors-1; i++) {
-            seqSumData* dataBundle = new seqSumData(summaryfile, lines[i+1].start, lines[i+1].end, hasNameOrCount, nameMap);
+            seqSumData* dataBundle = new seqSumData(summaryfile, lines[i+1].start, lines[i+1].end, hasNameOrCount, &nameMap);
             data.push_back(dataBundle);
             
             workerThreads.push_back(new thread(driverFastaSummarySummarize, dataBundle));
         }
         
-        seqSumData* dataBundle = new seqSumData(summaryfile, lines[0].start, lines[0].end, hasNameOrCount, nameMap);
+        seqSumData* dataBundle = new seqSumData(summaryfile, lines[0].start, lines[0].end, hasNameOrCount, &nameMap);
         
         driverFastaSummarySummarize(dataBundle);
         num = dataBundle->count-1; //header line
@@ -684,9 +663,9 @@ void driverContigsSummarySummarize(seqSumData* params) {
                 long long numReps = 1;
                 if (params->hasNameMap) {
                     //make sure this sequence is in the namefile, else error
-                    map<string, int>::iterator itFindName = params->nameMap.find(name);
+                    map<string, int>::iterator itFindName = params->nameMap->find(name);
                     
-                    if (itFindName == params->nameMap.end()) { params->m->mothurOut("[ERROR]: '" + name + "' is not in your name or count file, please correct."); params->m->mothurOutEndLine(); params->m->setControl_pressed(true); }
+                    if (itFindName == params->nameMap->end()) { params->m->mothurOut("[ERROR]: '" + name + "' is not in your name or count file, please correct."); params->m->mothurOutEndLine(); params->m->setControl_pressed(true); }
                     else { numReps = itFindName->second; }
                 }
                 
@@ -762,13 +741,13 @@ long long Summary::summarizeContigsSummary(string summaryfile) {
         //Lauch worker threads
         for (int i = 0; i < processors-1; i++) {
             if (m->getDebug()) { m->mothurOut("[DEBUG]: creating thread " + toString(i+1) + "\n"); }
-            seqSumData* dataBundle = new seqSumData(summaryfile, lines[i+1].start, lines[i+1].end, hasNameOrCount, nameMap);
+            seqSumData* dataBundle = new seqSumData(summaryfile, lines[i+1].start, lines[i+1].end, hasNameOrCount, &nameMap);
             data.push_back(dataBundle);
             
             workerThreads.push_back(new thread(driverContigsSummarySummarize, dataBundle));
         }
         
-        seqSumData* dataBundle = new seqSumData(summaryfile, lines[0].start, lines[0].end, hasNameOrCount, nameMap);
+        seqSumData* dataBundle = new seqSumData(summaryfile, lines[0].start, lines[0].end, hasNameOrCount, &nameMap);
         
         driverContigsSummarySummarize(dataBundle);
         num = dataBundle->count-1; //header line
@@ -887,9 +866,9 @@ void driverAlignSummarySummarize(seqSumData* params) {
                 long long numReps = 1;
                 if (params->hasNameMap) {
                     //make sure this sequence is in the namefile, else error
-                     map<string, int>::iterator itFindName = params->nameMap.find(name);
+                     map<string, int>::iterator itFindName = params->nameMap->find(name);
                     
-                    if (itFindName == params->nameMap.end()) { params->m->mothurOut("[ERROR]: '" + name + "' is not in your name or count file, please correct."); params->m->mothurOutEndLine(); params->m->setControl_pressed(true); }
+                    if (itFindName == params->nameMap->end()) { params->m->mothurOut("[ERROR]: '" + name + "' is not in your name or count file, please correct."); params->m->mothurOutEndLine(); params->m->setControl_pressed(true); }
                     else { numReps = itFindName->second; }
                 }
                 
@@ -957,13 +936,13 @@ long long Summary::summarizeAlignSummary(string summaryfile) {
         //Lauch worker threads
         for (int i = 0; i < processors-1; i++) {
             
-            seqSumData* dataBundle = new seqSumData(summaryfile, lines[i+1].start, lines[i+1].end, hasNameOrCount, nameMap);
+            seqSumData* dataBundle = new seqSumData(summaryfile, lines[i+1].start, lines[i+1].end, hasNameOrCount, &nameMap);
             data.push_back(dataBundle);
             
             workerThreads.push_back(new thread(driverAlignSummarySummarize, dataBundle));
         }
         
-        seqSumData* dataBundle = new seqSumData(summaryfile, lines[0].start, lines[0].end, hasNameOrCount, nameMap);
+        seqSumData* dataBundle = new seqSumData(summaryfile, lines[0].start, lines[0].end, hasNameOrCount, &nameMap);
         
         driverAlignSummarySummarize(dataBundle);
         num = dataBundle->count-1; //header line
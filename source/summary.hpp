@@ -103,6 +103,25 @@ private:
 
 
     
+};
+/**************************************************************************************************/
+//number of seqs with each value, indexed by value + 1 so a missing position (-1) has a slot. The fasta values are
+//positions, lengths and counts, so the vector stays small and adding a seq is one index instead of a map search.
+struct SummaryHistogram {
+    vector<long long> counts;
+    
+    inline void add(int value, long long num) {
+        size_t index = value + 1;
+        if (index >= counts.size()) { counts.resize(max(index + 1, counts.size() * 2), 0); }
+        counts[index] += num;
+    }
+    void merge(const SummaryHistogram& other) {
+        if (other.counts.size() > counts.size()) { counts.resize(other.counts.size(), 0); }
+        for (size_t i = 0; i < other.counts.size(); i++) { counts[i] += other.counts[i]; }
+    }
+    void fill(map<int, long long>& values) const { //adds the values found to the map Summary reports from
+        for (size_t i = 0; i < counts.size(); i++) { if (counts[i] != 0) { values[(int)i - 1] += counts[i]; } }
+    }
 };
 /**************************************************************************************************/
 struct seqSumData {
@@ -119,6 +138,7 @@ struct seqSumData {
     map<float, long long> sims;
     map<float, long long> scores;
     map<int, long long> inserts;
+    SummaryHistogram startHist, endHist, lengthHist, ambigHist, homopHist, numNsHist; //fasta
 
 
     string filename, summaryFile, contigsfile, output;
@@ -128,13 +148,13 @@ struct seqSumData {
     long long total;
     MothurOut* m;
     bool hasNameMap;
-    map<string, int> nameMap;
+    map<string, int>* nameMap; //shared by the threads, read only
     Utils util;
     
     
     seqSumData(){}
     //FastaSummarize - output file created
-    seqSumData(string f, string sum, unsigned long long st, unsigned long long en, bool na, map<string, int> nam) {
+    seqSumData(string f, string sum, unsigned long long st, unsigned long long en, bool na, map<string, int>* nam) {
         filename = f;
         m = MothurOut::getInstance();
         start = st;
@@ -147,7 +167,7 @@ struct seqSumData {
     }
     
     //FastaSummarySummarize - no output files
-    seqSumData(string f, unsigned long long st, unsigned long long en, bool na, map<string, int> nam) {
+    seqSumData(string f, unsigned long long st, unsigned long long en, bool na, map<string, int>* nam) {
         filename = f;
         m = MothurOut::getInstance();
         start = st;
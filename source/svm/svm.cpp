@@ -264,6 +264,75 @@ void transformZeroOne(LabeledObservationVector& observations) {
 }
 
 
+//
+// RowCache member functions
+//
+// the budget is rounded down to whole rows but at least one row is kept
+RowCache::RowCache(int n, long long maxBytes) :
+        rowSize(n),
+        rowBytes((long long)n * sizeof(double)),
+        peakRows(0), hits(0), misses(0), evictions(0), numTables(0) {
+    maxRows = 1;
+    if ( rowBytes > 0 ) { maxRows = max(1LL, maxBytes / rowBytes); }
+}
+
+// drops every row of a table, rows still held by a caller stay valid until they are released
+void RowCache::removeTable(int table) {
+    lock_guard<std::mutex> guard(mutex);
+    for ( unordered_map<long long, RowCacheEntry>::iterator i = rows.begin(); i != rows.end(); ) {
+        if ( (i->first / rowSize) == table ) {
+            leastRecentlyUsed.erase(i->second.position);
+            i = rows.erase(i);
+        }
+        else {
+            i++;
+        }
+    }
+}
+
+// The row is calculated without holding the lock so threads needing different rows
+// do not wait for each other.  If two threads calculate the same row the first one
+// stored is kept, both are the same.
+CachedRow RowCache::getRow(int table, int i, RowCalculator& calculator) {
+    const long long key = (long long)table * rowSize + i;
+    {
+        lock_guard<std::mutex> guard(mutex);
+        unordered_map<long long, RowCacheEntry>::iterator it = rows.find(key);
+        if ( it != rows.end() ) {
+            hits++;
+            leastRecentlyUsed.splice(leastRecentlyUsed.begin(), leastRecentlyUsed, it->second.position);
+            return it->second.row;
+        }
+    }
+
+    vector<double>* row = new vector<double>(rowSize, 0.0);
+    calculator.calculateRow(i, *row);
+    CachedRow calculatedRow(row);
+
+    lock_guard<std::mutex> guard(mutex);
+    misses++;
+    unordered_map<long long, RowCacheEntry>::iterator it = rows.find(key);
+    if ( it != rows.end() ) {
+        return it->second.row;
+    }
+
+    leastRecentlyUsed.push_front(key);
+    RowCacheEntry entry;
+    entry.row = calculatedRow;
+    entry.position = leastRecentlyUsed.begin();
+    rows[key] = entry;
+
+    while ( rows.size() > maxRows ) {
+        rows.erase(leastRecentlyUsed.back());
+        leastRecentlyUsed.pop_back();
+        evictions++;
+    }
+    if ( rows.size() > peakRows ) { peakRows = rows.size(); }
+
+    return calculatedRow;
+}
+
+
 //
 // SVM member functions
 //
@@ -467,18 +536,18 @@ SVM* SmoTrainer::train(KernelFunctionCache& K, const LabeledObservationVector& t
     const int observationCount = twoClassLabeledObservationVector.size();
     const int featureCount = twoClassLabeledObservationVector[0].second->size();
 
-    if (outputFilter.debug()) m->mothurOut( "observation count : " + toString(observationCount) ); m->mothurOutEndLine();
-    if (outputFilter.debug()) m->mothurOut( "feature count     : " + toString(featureCount) ); m->mothurOutEndLine();
+    if (outputFilter.debug()) { m->mothurOut( "observation count : " + toString(observationCount) ); m->mothurOutEndLine(); }
+    if (outputFilter.debug()) { m->mothurOut( "feature count     : " + toString(featureCount) ); m->mothurOutEndLine(); }
     // dual coefficients
     vector<double> a(observationCount, 0.0);
     // gradient
     vector<double> g(observationCount, 1.0);
     // convert the labels to -1.0,+1.0
     vector<double> y(observationCount);
-    if (outputFilter.trace()) m->mothurOut( "assign numeric labels" ); m->mothurOutEndLine();
+    if (outputFilter.trace()) { m->mothurOut( "assign numeric labels" ); m->mothurOutEndLine(); }
     NumericClassToLabel discriminantToLabel;
     assignNumericLabels(y, twoClassLabeledObservationVector, discriminantToLabel);
-    if (outputFilter.trace()) m->mothurOut( "assign A and B" ); m->mothurOutEndLine();
+    if (outputFilter.trace()) { m->mothurOut( "assign A and B" ); m->mothurOutEndLine(); }
     vector<double> A(observationCount);
     vector<double> B(observationCount);
     for ( int n = 0; n < observationCount; n++ ) {
@@ -490,9 +559,9 @@ SVM* SmoTrainer::train(KernelFunctionCache& K, const LabeledObservationVector& t
             A[n] = -C;
             B[n] = 0;
         }
-        if (outputFilter.trace()) m->mothurOut( toString(n) + " " + toString(A[n]) + " " + toString(B[n]) ); m->mothurOutEndLine();
+        if (outputFilter.trace()) { m->mothurOut( toString(n) + " " + toString(A[n]) + " " + toString(B[n]) ); m->mothurOutEndLine(); }
     }
-    if (outputFilter.trace()) m->mothurOut( "assign K" ); m->mothurOutEndLine();
+    if (outputFilter.trace()) { m->mothurOut( "assign K" ); m->mothurOutEndLine(); }
     int m_count = 0;
     vector<double> u(3);
     vector<double> ya(observationCount);
@@ -512,7 +581,7 @@ SVM* SmoTrainer::train(KernelFunctionCache& K, const LabeledObservationVector& t
         int j = 0; // 0
         double yg_max = numeric_limits<double>::min();
         double yg_min = numeric_limits<double>::max();
-        if (outputFilter.trace()) m->mothurOut( "m = " + toString(m_count) ); m->mothurOutEndLine();
+        if (outputFilter.trace()) { m->mothurOut( "m = " + toString(m_count) ); m->mothurOutEndLine(); }
         for ( int k = 0; k < observationCount; k++ ) {
             ya[k] = y[k] * a[k];
             yg[k] = y[k] * g[k];
@@ -559,7 +628,7 @@ SVM* SmoTrainer::train(KernelFunctionCache& K, const LabeledObservationVector& t
             // what happens if we just go with what we've got instead of throwing an exception?
             // things work pretty well for the most part
             // might be better to look at lambda???
-            if (outputFilter.debug()) m->mothurOut( "iteration limit reached with lambda = " + toString(lambda) ); m->mothurOutEndLine();
+            if (outputFilter.debug()) { m->mothurOut( "iteration limit reached with lambda = " + toString(lambda) ); m->mothurOutEndLine(); }
             break;
         }
 
@@ -570,16 +639,19 @@ SVM* SmoTrainer::train(KernelFunctionCache& K, const LabeledObservationVector& t
         u[0] = B[i] - ya[i];
         u[1] = ya[j] - A[j];
 
-        double K_ii = K.similarity(twoClassLabeledObservationVector[i], twoClassLabeledObservationVector[i]);
-        double K_jj = K.similarity(twoClassLabeledObservationVector[j], twoClassLabeledObservationVector[j]);
-        double K_ij = K.similarity(twoClassLabeledObservationVector[i], twoClassLabeledObservationVector[j]);
+        // hold on to rows i and j, the cache may drop them while they are used
+        CachedRow K_i = K.getRow(twoClassLabeledObservationVector[i].datasetIndex);
+        CachedRow K_j = K.getRow(twoClassLabeledObservationVector[j].datasetIndex);
+        double K_ii = (*K_i)[twoClassLabeledObservationVector[i].datasetIndex];
+        double K_jj = (*K_j)[twoClassLabeledObservationVector[j].datasetIndex];
+        double K_ij = (*K_i)[twoClassLabeledObservationVector[j].datasetIndex];
         u[2] = (yg[i] - yg[j]) / (K_ii+K_jj-2.0*K_ij);
-        if (outputFilter.trace()) m->mothurOut( "directions: (" + toString(u[0]) + "," + toString(u[1]) + "," + toString(u[2]) + ")" ); m->mothurOutEndLine();
+        if (outputFilter.trace()) { m->mothurOut( "directions: (" + toString(u[0]) + "," + toString(u[1]) + "," + toString(u[2]) + ")" ); m->mothurOutEndLine(); }
         lambda = *min_element(u.begin(), u.end());
-        if (outputFilter.trace()) m->mothurOut( "lambda: " + toString(lambda) ); m->mothurOutEndLine();
+        if (outputFilter.trace()) { m->mothurOut( "lambda: " + toString(lambda) ); m->mothurOutEndLine(); }
         for ( int k = 0; k < observationCount; k++ ) {
-            double K_ik = K.similarity(twoClassLabeledObservationVector[i], twoClassLabeledObservationVector[k]);
-            double K_jk = K.similarity(twoClassLabeledObservationVector[j], twoClassLabeledObservationVector[k]);
+            double K_ik = (*K_i)[twoClassLabeledObservationVector[k].datasetIndex];
+            double K_jk = (*K_j)[twoClassLabeledObservationVector[k].datasetIndex];
             g[k] += (-lambda * y[k] * K_ik + lambda * y[k] * K_jk);
         }
         if (outputFilter.trace()) {
@@ -596,17 +668,17 @@ SVM* SmoTrainer::train(KernelFunctionCache& K, const LabeledObservationVector& t
 
     // at this point the optimal a's have been found
     // now use them to find w and b
-    if (outputFilter.trace()) m->mothurOut( "find w" ); m->mothurOutEndLine();
+    if (outputFilter.trace()) { m->mothurOut( "find w" ); m->mothurOutEndLine(); }
     vector<double> w(twoClassLabeledObservationVector[0].second->size(), 0.0);
     double b = 0.0;
     for ( int i = 0; i < y.size(); i++ ) {
-        if (outputFilter.trace()) m->mothurOut( "alpha[" + toString(i) + "] = " + toString(a[i]) ); m->mothurOutEndLine();
+        if (outputFilter.trace()) { m->mothurOut( "alpha[" + toString(i) + "] = " + toString(a[i]) ); m->mothurOutEndLine(); }
         for ( int j = 0; j < w.size(); j++ ) {
             w[j] += a[i] * y[i] * twoClassLabeledObservationVector[i].second->at(j);
         }
         if ( A[i] < a[i] && a[i] < B[i] ) {
             b = yg[i];
-            if (outputFilter.trace()) m->mothurOut( "b = " + toString(b) ); m->mothurOutEndLine();
+            if (outputFilter.trace()) { m->mothurOut( "b = " + toString(b) ); m->mothurOutEndLine(); }
         }
     }
 
@@ -634,7 +706,7 @@ SVM* SmoTrainer::train(KernelFunctionCache& K, const LabeledObservationVector& t
         }
     }
     //return new SVM(y, a, twoClassLabeledObservationVector, b, discriminantToLabel);
-    if (outputFilter.info()) m->mothurOut( "found " + toString(supportVectors.size()) + " support vectors" ); m->mothurOutEndLine();
+    if (outputFilter.info()) { m->mothurOut( "found " + toString(supportVectors.size()) + " support vectors" ); m->mothurOutEndLine(); }
     return new SVM(support_y, nonzero_a, supportVectors, b, discriminantToLabel);
 }
 
@@ -723,11 +795,14 @@ void getDefaultKernelParameterRangeMap(KernelParameterRangeMap& kernelParameterR
 // An instance of OneVsOneMultiClassSvmTrainer is intended to work with a single set of data
 // to produce a single instance of MultiClassSVM.  That's why observations and labels go in to
 // the constructor.
-OneVsOneMultiClassSvmTrainer::OneVsOneMultiClassSvmTrainer(SvmDataset& d, int e, int t, OutputFilter& of) :
+OneVsOneMultiClassSvmTrainer::OneVsOneMultiClassSvmTrainer(SvmDataset& d, int e, int t, OutputFilter& of, int p, long long c) :
         svmDataset(d),
         evaluationFoldCount(e),
         trainFoldCount(t),
-        outputFilter(of) {
+        outputFilter(of),
+        processors(max(p, 1)),
+        rowCacheBytes(c),
+        rowCachePeakBytes(0), rowCacheHits(0), rowCacheMisses(0), rowCacheEvictions(0) {
     buildLabelSet(labelSet, svmDataset.getLabeledObservationVector());
     buildLabelToLabeledObservationVector(labelToLabeledObservationVector, svmDataset.getLabeledObservationVector());
     buildLabelPairSet(labelPairSet, svmDataset.getLabeledObservationVector());
@@ -790,7 +865,8 @@ MultiClassSVM* OneVsOneMultiClassSvmTrainer::train(const KernelParameterRangeMap
     double bestMultiClassSvmScore = 0.0;
     MultiClassSVM* bestMc;
 
-    KernelFunctionFactory kernelFunctionFactory(svmDataset.getLabeledObservationVector());
+    RowCache rowCache(svmDataset.getLabeledObservationVector().size(), rowCacheBytes);
+    KernelFunctionFactory kernelFunctionFactory(svmDataset.getLabeledObservationVector(), rowCache);
 
     // first divide the data into a 'development' set for tuning hyperparameters
     // and an 'evaluation' set for measuring performance
@@ -832,30 +908,35 @@ MultiClassSVM* OneVsOneMultiClassSvmTrainer::train(const KernelParameterRangeMap
                 //}
             );
             KFoldLabeledObservationsDivider kFoldLabeledObservationsDivider(trainFoldCount, twoClassDevelopmentObservations);
-            // loop on kernel functions and kernel function parameters
+            // build the grid of kernel functions and kernel function parameters, each parameter set
+            // gets its own kernel function so the sets can be trained at the same time
+            SvmParameterSetVector parameterSets;
             for ( KernelParameterRangeMap::const_iterator kmap = kernelParameterRangeMap.begin(); kmap != kernelParameterRangeMap.end(); kmap++ ) {
-                string kernelFunctionKey = kmap->first;
-                KernelFunction& kernelFunction = kernelFunctionFactory.getKernelFunctionForKey(kmap->first);
                 ParameterSetBuilder p(kmap->second);
                 for (ParameterMapVector::const_iterator hp = p.getParameterSetList().begin(); hp != p.getParameterSetList().end(); hp++) {
-                    kernelFunction.setParameters(*hp);
-                    KernelFunctionCache kernelFunctionCache(kernelFunction, svmDataset.getLabeledObservationVector());
-                    smoTrainer.setParameters(*hp);
-                    if (outputFilter.debug()) {
-                        m->mothurOut( "parameters for " + toString(kernelFunctionKey) + " kernel" ); m->mothurOutEndLine();
-                        for ( ParameterMap::const_iterator i = hp->begin(); i != hp->end(); i++ ) {
-                            m->mothurOut( "    " + toString(i->first) + ":" + toString(i->second) ); m->mothurOutEndLine();
-                        }
-                    }
-                    double meanScoreOnKFolds = trainOnKFolds(smoTrainer, kernelFunctionCache, kFoldLabeledObservationsDivider);
-                    if ( meanScoreOnKFolds > bestMeanScoreOnKFolds ) {
-                        bestMeanScoreOnKFolds = meanScoreOnKFolds;
-                        bestParameterMap = *hp;
-                        bestKernelFunctionKey = kernelFunctionKey;
-                    }
+                    SvmParameterSet parameterSet;
+                    parameterSet.kernelFunctionKey = kmap->first;
+                    parameterSet.parameterMap = *hp;
+                    parameterSet.kernelFunction = kernelFunctionFactory.newKernelFunctionForKey(kmap->first);
+                    parameterSet.kernelFunction->setParameters(*hp);
+                    parameterSet.kernelFunctionCache = new KernelFunctionCache(*parameterSet.kernelFunction, rowCache);
+                    parameterSets.push_back(parameterSet);
                 }
             }
 
+            vector<double> meanScoresOnKFolds;
+            trainOnKFolds(parameterSets, kFoldLabeledObservationsDivider, meanScoresOnKFolds);
+
+            for (int s = 0; s < parameterSets.size(); s++) {
+                if ( meanScoresOnKFolds[s] > bestMeanScoreOnKFolds ) {
+                    bestMeanScoreOnKFolds = meanScoresOnKFolds[s];
+                    bestParameterMap = parameterSets[s].parameterMap;
+                    bestKernelFunctionKey = parameterSets[s].kernelFunctionKey;
+                }
+                delete parameterSets[s].kernelFunctionCache;
+                delete parameterSets[s].kernelFunction;
+            }
+
             if ( bestMeanScoreOnKFolds == 0.0 ) {
                 m->mothurOut( "failed to train SVM on labels " + toString(label0) + " and " + toString(label1) ); m->mothurOutEndLine();
                 throw exception();
@@ -891,7 +972,7 @@ MultiClassSVM* OneVsOneMultiClassSvmTrainer::train(const KernelParameterRangeMap
                 KernelFunction& kernelFunction = kernelFunctionFactory.getKernelFunctionForKey(bestKernelFunctionKey);
                 kernelFunction.setParameters(bestParameterMap);
                 smoTrainer.setParameters(bestParameterMap);
-                KernelFunctionCache kernelFunctionCache(kernelFunction, svmDataset.getLabeledObservationVector());
+                KernelFunctionCache kernelFunctionCache(kernelFunction, rowCache);
                 SVM* svm = smoTrainer.train(kernelFunctionCache, twoClassDevelopmentObservations);
                 //cout << "done training final SVM" << endl;
                 twoClassSvmList.push_back(svm);
@@ -932,68 +1013,153 @@ MultiClassSVM* OneVsOneMultiClassSvmTrainer::train(const KernelParameterRangeMap
     //for ( SvmVector::iterator i = bestMc->getSvmList().begin(); i != bestMc->getSvmList().end(); i++ ) {
     //    SvmPerformanceSummary bestMc->getSvmPerformanceSummary(*i);
     //}
+
+    rowCachePeakBytes = max(rowCachePeakBytes, rowCache.getPeakBytes());
+    rowCacheHits += rowCache.getHits();
+    rowCacheMisses += rowCache.getMisses();
+    rowCacheEvictions += rowCache.getEvictions();
+    //classify.svm prints the totals once training is done
+    if ( m->getDebug() ) {
+        m->mothurOut( "[DEBUG]: kernel row cache used " + toString(rowCache.getPeakBytes() / 1048576.0) + " of " + toString(rowCache.getMaxBytes() / 1048576.0) + " MB, "
+                     + toString(rowCache.getHits()) + " hits, " + toString(rowCache.getMisses()) + " rows calculated, " + toString(rowCache.getEvictions()) + " rows dropped\n" );
+    }
+
     return bestMc;
 }
 
 //SvmTrainingInterruptedException multiClassSvmTrainingInterruptedException("one-vs-one multiclass SVM training interrupted by user");
 
-double OneVsOneMultiClassSvmTrainer::trainOnKFolds(SmoTrainer& smoTrainer, KernelFunctionCache& kernelFunction, KFoldLabeledObservationsDivider& kFoldLabeledObservationsDivider) {
-    double meanScoreOverKFolds = 0.0;
-    double online_mean_n = 0.0;
-    double online_mean_score = 0.0;
-    meanScoreOverKFolds = -1.0;  // means we failed to train a SVM
+// the SVMs of one thread in the cross validation grid
+struct svmFoldData {
+    SvmParameterSetVector* parameterSets;
+    vector<LabeledObservationVector>* trainingFolds;
+    vector<LabeledObservationVector>* testingFolds;
+    vector< vector<double> >* scores; //[parameter set][fold], -1 if the SVM was not trained
+    OutputFilter outputFilter;
+    int threadID, numThreads;
+
+    svmFoldData(SvmParameterSetVector* p, vector<LabeledObservationVector>* tr, vector<LabeledObservationVector>* te, vector< vector<double> >* sc, const OutputFilter& of, int tid, int nt) :
+        parameterSets(p), trainingFolds(tr), testingFolds(te), scores(sc), outputFilter(of), threadID(tid), numThreads(nt) {}
+};
 
-    for ( kFoldLabeledObservationsDivider.start(); !kFoldLabeledObservationsDivider.end(); kFoldLabeledObservationsDivider.next() ) {
-        const LabeledObservationVector& kthTwoClassTrainingFold = kFoldLabeledObservationsDivider.getTrainingData();
-        const LabeledObservationVector& kthTwoClassTestingFold = kFoldLabeledObservationsDivider.getTestingData();
-        if (outputFilter.info()) {
-            m->mothurOut( "fold " + toString(kFoldLabeledObservationsDivider.getFoldNumber()) + " training data has " + toString(kthTwoClassTrainingFold.size()) + " labeled observations" ); m->mothurOutEndLine();
-            m->mothurOut( "fold " + toString(kFoldLabeledObservationsDivider.getFoldNumber()) + " testing data has " + toString(kthTwoClassTestingFold.size()) + " labeled observations" ); m->mothurOutEndLine();
-        }
-        if (m->getControl_pressed()) { return 0; }
-//        if ( externalSvmTrainingInterruption.interruptTraining() ) {
-//            m->mothurOut( "training interrupted by user" ); m->mothurOutEndLine();
-//            throw multiClassSvmTrainingInterruptedException;
-//        }
-        else {
-            try {
-                if (outputFilter.debug()) m->mothurOut( "begin training" ); m->mothurOutEndLine();
+// The (parameter set, fold) pairs are numbered parameter set first and handed out
+// round robin, so the folds of a parameter set train at the same time and share
+// the rows of its kernel function cache.
+void driverSvmFolds(svmFoldData* params) {
+    const OutputFilter& outputFilter = params->outputFilter;
+    const int numFolds = params->trainingFolds->size();
+    const int numPairs = params->parameterSets->size() * numFolds;
 
-                SVM* evaluationSvm = smoTrainer.train(kernelFunction, kthTwoClassTrainingFold);
-                SvmPerformanceSummary svmPerformanceSummary(*evaluationSvm, kthTwoClassTestingFold);
-                double score = evaluationSvm->score(kthTwoClassTestingFold);
-                //double score = svmPerformanceSummary.getAccuracy();
-                if (outputFilter.debug()) {
-                    m->mothurOut( "score on fold " + toString(kFoldLabeledObservationsDivider.getFoldNumber()) + " of test data is " + toString(score) ); m->mothurOutEndLine();
-                    m->mothurOut( "positive label: " + toString(svmPerformanceSummary.getPositiveClassLabel()) ); m->mothurOutEndLine();
-                    m->mothurOut( "negative label: " + toString(svmPerformanceSummary.getNegativeClassLabel()) ); m->mothurOutEndLine();
-                    m->mothurOut( "  precision: " + toString(svmPerformanceSummary.getPrecision())
-                              + "     recall: " + toString(svmPerformanceSummary.getRecall())
-                              + "          f: " + toString(svmPerformanceSummary.getF())
-                              + "   accuracy: " + toString(svmPerformanceSummary.getAccuracy())
-                              ); m->mothurOutEndLine();
-                }
-                online_mean_n += 1.0;
-                double online_mean_delta = score - online_mean_score;
-                online_mean_score += online_mean_delta / online_mean_n;
-                meanScoreOverKFolds = online_mean_score;
+    for (int n = params->threadID; n < numPairs; n += params->numThreads) {
+        if (m->getControl_pressed()) { break; }
 
-                delete evaluationSvm;
-            }
-            catch ( exception& e ) {
-                m->mothurOut( "exception: " + toString(e.what()) ); m->mothurOutEndLine();
-                m->mothurOut( "    on fold " + toString(kFoldLabeledObservationsDivider.getFoldNumber()) + " failed to train SVM with C = " + toString(smoTrainer.getC()) ); m->mothurOutEndLine();
+        const int s = n / numFolds;
+        const int k = n % numFolds;
+        SvmParameterSet& parameterSet = params->parameterSets->at(s);
+        const LabeledObservationVector& kthTwoClassTrainingFold = params->trainingFolds->at(k);
+        const LabeledObservationVector& kthTwoClassTestingFold = params->testingFolds->at(k);
+
+        SmoTrainer smoTrainer(outputFilter);
+        smoTrainer.setParameters(parameterSet.parameterMap);
+        try {
+            if (outputFilter.debug()) { m->mothurOut( "begin training" ); m->mothurOutEndLine(); }
+
+            SVM* evaluationSvm = smoTrainer.train(*parameterSet.kernelFunctionCache, kthTwoClassTrainingFold);
+            if (evaluationSvm == NULL) { break; } //control pressed
+
+            double score = evaluationSvm->score(kthTwoClassTestingFold);
+            if (outputFilter.debug()) {
+                SvmPerformanceSummary svmPerformanceSummary(*evaluationSvm, kthTwoClassTestingFold);
+                m->mothurOut( "score on fold " + toString(k) + " of test data is " + toString(score) ); m->mothurOutEndLine();
+                m->mothurOut( "positive label: " + toString(svmPerformanceSummary.getPositiveClassLabel()) ); m->mothurOutEndLine();
+                m->mothurOut( "negative label: " + toString(svmPerformanceSummary.getNegativeClassLabel()) ); m->mothurOutEndLine();
+                m->mothurOut( "  precision: " + toString(svmPerformanceSummary.getPrecision())
+                          + "     recall: " + toString(svmPerformanceSummary.getRecall())
+                          + "          f: " + toString(svmPerformanceSummary.getF())
+                          + "   accuracy: " + toString(svmPerformanceSummary.getAccuracy())
+                          ); m->mothurOutEndLine();
             }
+            params->scores->at(s).at(k) = score;
+
+            delete evaluationSvm;
+        }
+        catch ( exception& e ) {
+            m->mothurOut( "exception: " + toString(e.what()) ); m->mothurOutEndLine();
+            m->mothurOut( "    on fold " + toString(k) + " failed to train SVM with C = " + toString(smoTrainer.getC()) ); m->mothurOutEndLine();
         }
     }
-    if (outputFilter.debug()) {
-        m->mothurOut( "done with cross validation on C = " + toString(smoTrainer.getC()) ); m->mothurOutEndLine();
-        m->mothurOut( "    mean score over " + toString(kFoldLabeledObservationsDivider.getFoldNumber()) + " folds is " + toString(meanScoreOverKFolds) ); m->mothurOutEndLine();
+}
+
+// Trains an SVM for every parameter set on every fold and fills meanScores with the mean
+// score over the folds of each parameter set, -1 if no SVM could be trained.  The means are
+// taken in fold order once all the SVMs are done, so they are the same for any number of processors.
+void OneVsOneMultiClassSvmTrainer::trainOnKFolds(SvmParameterSetVector& parameterSets, KFoldLabeledObservationsDivider& kFoldLabeledObservationsDivider, vector<double>& meanScores) {
+    vector<LabeledObservationVector> trainingFolds;
+    vector<LabeledObservationVector> testingFolds;
+    for ( kFoldLabeledObservationsDivider.start(); !kFoldLabeledObservationsDivider.end(); kFoldLabeledObservationsDivider.next() ) {
+        trainingFolds.push_back(kFoldLabeledObservationsDivider.getTrainingData());
+        testingFolds.push_back(kFoldLabeledObservationsDivider.getTestingData());
     }
-    if ( meanScoreOverKFolds == 0.0 ) {
-        m->mothurOut( "failed to train SVM with C = " + toString(smoTrainer.getC()) ); m->mothurOutEndLine();
+    const int numFolds = trainingFolds.size();
+
+    vector< vector<double> > scores(parameterSets.size(), vector<double>(numFolds, -1.0));
+
+    int numThreads = max(1, min(processors, (int)(parameterSets.size() * numFolds)));
+
+    vector<thread*> workerThreads;
+    vector<svmFoldData*> data;
+
+    for (int i = 1; i < numThreads; i++) {
+        svmFoldData* dataBundle = new svmFoldData(&parameterSets, &trainingFolds, &testingFolds, &scores, outputFilter, i, numThreads);
+        data.push_back(dataBundle);
+        workerThreads.push_back(new thread(driverSvmFolds, dataBundle));
+    }
+
+    svmFoldData* dataBundle = new svmFoldData(&parameterSets, &trainingFolds, &testingFolds, &scores, outputFilter, 0, numThreads);
+    driverSvmFolds(dataBundle);
+    delete dataBundle;
+
+    for (int i = 0; i < workerThreads.size(); i++) {
+        workerThreads[i]->join();
+        delete data[i];
+        delete workerThreads[i];
+    }
+
+    meanScores.assign(parameterSets.size(), -1.0);
+    for (int s = 0; s < parameterSets.size(); s++) {
+        const ParameterMap& parameterMap = parameterSets[s].parameterMap;
+        const double C = parameterMap.find(SmoTrainer::MapKey_C)->second;
+        if (outputFilter.debug()) {
+            m->mothurOut( "parameters for " + toString(parameterSets[s].kernelFunctionKey) + " kernel" ); m->mothurOutEndLine();
+            for ( ParameterMap::const_iterator i = parameterMap.begin(); i != parameterMap.end(); i++ ) {
+                m->mothurOut( "    " + toString(i->first) + ":" + toString(i->second) ); m->mothurOutEndLine();
+            }
+        }
+
+        double meanScoreOverKFolds = -1.0;  // means we failed to train a SVM
+        double online_mean_n = 0.0;
+        double online_mean_score = 0.0;
+        for (int k = 0; k < numFolds; k++) {
+            if (outputFilter.info()) {
+                m->mothurOut( "fold " + toString(k) + " training data has " + toString(trainingFolds[k].size()) + " labeled observations" ); m->mothurOutEndLine();
+                m->mothurOut( "fold " + toString(k) + " testing data has " + toString(testingFolds[k].size()) + " labeled observations" ); m->mothurOutEndLine();
+            }
+            if ( scores[s][k] < 0.0 ) { continue; }
+
+            online_mean_n += 1.0;
+            double online_mean_delta = scores[s][k] - online_mean_score;
+            online_mean_score += online_mean_delta / online_mean_n;
+            meanScoreOverKFolds = online_mean_score;
+        }
+        if (outputFilter.debug()) {
+            m->mothurOut( "done with cross validation on C = " + toString(C) ); m->mothurOutEndLine();
+            m->mothurOut( "    mean score over " + toString(numFolds) + " folds is " + toString(meanScoreOverKFolds) ); m->mothurOutEndLine();
+        }
+        if ( meanScoreOverKFolds == 0.0 ) {
+            m->mothurOut( "failed to train SVM with C = " + toString(C) ); m->mothurOutEndLine();
+        }
+        meanScores[s] = meanScoreOverKFolds;
     }
-    return meanScoreOverKFolds;
 }
 
 
@@ -16,10 +16,12 @@
 #include <exception>
 #include <list>
 #include <map>
+#include <memory>
 #include <set>
 #include <stack>
 #include <string>
 #include <sstream>
+#include <unordered_map>
 #include "mothurout.h"
 
 
@@ -261,6 +263,7 @@ public:
     ParameterSetBuilder(const ParameterRangeMap& parameterRangeMap) {
         // a small step toward quieting down this code
         bool verbose = false;
+        m = MothurOut::getInstance();
 
         stack<pair<ParameterName, ParameterStack> > stackOfParameterRanges;
         stack<pair<ParameterName, ParameterStack> > stackOfEmptyParameterRanges;
@@ -275,12 +278,12 @@ public:
         // get started
         for ( int n = 0; n < parameterSetCount; n++ ) {
 
-            if (verbose) m->mothurOut("n = " + toString(n) ); m->mothurOutEndLine();
+            if (verbose) { m->mothurOut("n = " + toString(n) ); m->mothurOutEndLine(); }
 
             // pull empty stacks off until there are no empty stacks
             while ( stackOfParameterRanges.size() > 0 and stackOfParameterRanges.top().second.size() == 0 ) {
 
-                if (verbose) m->mothurOut("  empty parameter range: " + stackOfParameterRanges.top().first); m->mothurOutEndLine();
+                if (verbose) { m->mothurOut("  empty parameter range: " + stackOfParameterRanges.top().first); m->mothurOutEndLine(); }
 
                 stackOfEmptyParameterRanges.push(stackOfParameterRanges.top());
                 stackOfParameterRanges.pop();
@@ -296,11 +299,11 @@ public:
                 nextParameterSet[parameterName] = stackOfParameterRanges.top().second.top();
                 stackOfParameterRanges.top().second.pop();
             }
-            if (verbose) m->mothurOut( "stack of empty parameter ranges has size " + toString(stackOfEmptyParameterRanges.size() ) ); m->mothurOutEndLine();
+            if (verbose) { m->mothurOut( "stack of empty parameter ranges has size " + toString(stackOfEmptyParameterRanges.size() ) ); m->mothurOutEndLine(); }
             // reset each parameter range that has been exhausted
             while ( stackOfEmptyParameterRanges.size() > 0 ) {
                 ParameterName parameterName = stackOfEmptyParameterRanges.top().first;
-                if (verbose) m->mothurOut( "  reseting range for parameter " + toString(stackOfEmptyParameterRanges.top().first) ); m->mothurOutEndLine();
+                if (verbose) { m->mothurOut( "  reseting range for parameter " + toString(stackOfEmptyParameterRanges.top().first) ); m->mothurOutEndLine(); }
                 stackOfParameterRanges.push(stackOfEmptyParameterRanges.top());
                 stackOfEmptyParameterRanges.pop();
                 const ParameterRange& parameterRange = parameterRangeMap.find(parameterName)->second;
@@ -333,122 +336,103 @@ private:
 };
 
 
-class RowCache {
+// The RowCache class holds rows of kernel values for the observations of a dataset, row i holds the values
+// for observation i with every observation.  One cache is shared by all the kernel functions, kernel
+// function caches and threads of a training run, each of them keeps its rows in its own table of the cache.
+// Rows are calculated by a RowCalculator the first time they are asked for and are kept until the memory
+// budget of the cache is reached, then the least recently used rows are dropped.  Rows are handed out as
+// shared pointers so a row dropped while another thread is reading it stays valid until it is released.
+class RowCalculator {
 public:
-    RowCache(int d)  { //: cache(d, NULL)
-        for (int i = 0; i < d; i++) {  cache.push_back(NULL);  }
-    }
-    
-    virtual ~RowCache() {
-        for (int i = 0; i < cache.size(); i++) {
-            if ( !rowNotCached(i) ) {
-                delete cache[i];
-            }
-        }
-    }
-
-    double getCachedValue(int i, int j) {
-        if ( rowNotCached(i) ) {
-            createRow(i);
-        }
-        return cache.at(i)->at(j);
-    }
-
-    void createRow(int i) {
-        cache[i] = new vector<double>(cache.size(), numeric_limits<double>::signaling_NaN());
-        for ( int v = 0; v < cache.size(); v++ ) {
-            cache.at(i)->at(v) = calculateValueForCache(i, v);
-        }
-    }
-
-    bool rowNotCached(int i) {
-        return cache[i] == NULL;
-    }
-
-    virtual double calculateValueForCache(int, int) = 0;
-
-private:
-    vector<vector<double>* > cache;
+    virtual ~RowCalculator() {}
+    virtual void calculateRow(int, vector<double>&) = 0;
 };
 
+typedef shared_ptr<const vector<double> > CachedRow;
 
-class InnerProductRowCache : public RowCache {
+class RowCache {
 public:
-    InnerProductRowCache(const LabeledObservationVector& _obs) : obs(_obs), RowCache(_obs.size()) {}
-    virtual ~InnerProductRowCache() {}
-
-    double getInnerProduct(const LabeledObservation& obs_i, const LabeledObservation& obs_j) {
-        return getCachedValue(
-            obs_i.datasetIndex,
-            obs_j.datasetIndex
-        );
-    }
+    RowCache(int, long long); // row size (number of observations), memory budget in bytes
+    ~RowCache() {}
 
-    double calculateValueForCache(int i, int j) {
-        return inner_product(obs[i].second->begin(), obs[i].second->end(), obs[j].second->begin(), 0.0);
-    }
+    int addTable() { lock_guard<std::mutex> guard(mutex); return numTables++; }
+    void removeTable(int);
+    CachedRow getRow(int, int, RowCalculator&); // table, row, calculator used if the row is not cached
+
+    long long getMaxBytes()   const { return maxRows * rowBytes; }
+    long long getPeakBytes()  const { return peakRows * rowBytes; }
+    long long getHits()       const { return hits; }
+    long long getMisses()     const { return misses; }
+    long long getEvictions()  const { return evictions; }
 
 private:
-    const LabeledObservationVector& obs;
+    struct RowCacheEntry {
+        CachedRow row;
+        list<long long>::iterator position;
+    };
+
+    const int rowSize;
+    const long long rowBytes;
+    long long maxRows, peakRows, hits, misses, evictions;
+    int numTables;
+    list<long long> leastRecentlyUsed; // keys, most recently used first
+    unordered_map<long long, RowCacheEntry> rows;
+    std::mutex mutex;
 };
 
 
 // The KernelFunction class caches a partial kernel value that does not depend on kernel parameters.
-class KernelFunction {
+// Instances of a kernel with different parameters share these values through the same RowCache table.
+class KernelFunction : public RowCalculator {
 public:
-    //KernelFunction(const LabeledObservationVector& _obs, InnerProductCache& _ipc) : obs(_obs), innerProductRowCache(_ipc) {}
-
-    KernelFunction(const LabeledObservationVector& _obs) :
+    KernelFunction(const LabeledObservationVector& _obs, RowCache& _rowCache, int _table) :
         obs(_obs),
-        cache(_obs.size(), NULL) {}
+        rowCache(_rowCache),
+        table(_table) {}
 
-    virtual ~KernelFunction() {
-        for (int i = 0; i < cache.size(); i++) {
-            if ( !rowNotCached(i) ) {
-                delete cache[i];
-            }
-        }
-    }
+    virtual ~KernelFunction() {}
 
     virtual double similarity(const LabeledObservation&, const LabeledObservation&) = 0;
+    // the kernel value for a parameter free value returned by calculateParameterFreeSimilarity
+    virtual double similarityFromParameterFree(double) = 0;
     virtual void setParameters(const ParameterMap&) = 0;
     virtual void getDefaultParameterRanges(ParameterRangeMap&) = 0;
 
     virtual double calculateParameterFreeSimilarity(const LabeledObservation&, const LabeledObservation&) = 0;
 
     double getCachedParameterFreeSimilarity(const LabeledObservation& obs_i, const LabeledObservation& obs_j) {
-        const int i = obs_i.datasetIndex;
-        const int j = obs_j.datasetIndex;
+        return getParameterFreeRow(obs_i.datasetIndex)->at(obs_j.datasetIndex);
+    }
 
-        if ( rowNotCached(i) ) {
-            cache[i] = new vector<double>(obs.size(), numeric_limits<double>::signaling_NaN());
-            for ( int v = 0; v < obs.size(); v++ ) {
-                cache.at(i)->at(v) = calculateParameterFreeSimilarity(obs[i], obs[v]);
-            }
-        }
-        return cache.at(i)->at(j);
+    CachedRow getParameterFreeRow(int i) {
+        return rowCache.getRow(table, i, *this);
     }
 
-    bool rowNotCached(int i) {
-        return cache[i] == NULL;
+    void calculateRow(int i, vector<double>& row) {
+        for ( int v = 0; v < obs.size(); v++ ) {
+            row[v] = calculateParameterFreeSimilarity(obs[i], obs[v]);
+        }
     }
 
 private:
     const LabeledObservationVector& obs;
-    //vector<vector<double> > cache;
-    vector<vector<double>* > cache;
-    //InnerProductRowCache& innerProductCache;
+    RowCache& rowCache;
+    const int table;
 };
 
 
 class LinearKernelFunction : public KernelFunction {
 public:
     // parameters must be set before using a KernelFunction is used
-    LinearKernelFunction(const LabeledObservationVector& _obs) : KernelFunction(_obs), constant(0.0) {}
+    LinearKernelFunction(const LabeledObservationVector& _obs, RowCache& c, int t) : KernelFunction(_obs, c, t), constant(0.0) {}
     ~LinearKernelFunction() {}
 
     double similarity(const LabeledObservation& i, const LabeledObservation& j) {
-        return getCachedParameterFreeSimilarity(i, j) + constant;
+        return similarityFromParameterFree(getCachedParameterFreeSimilarity(i, j));
+    }
+
+    double similarityFromParameterFree(double s) {
+        return s + constant;
     }
 
     double calculateParameterFreeSimilarity(const LabeledObservation& i, const LabeledObservation& j) {
@@ -478,7 +462,7 @@ private:
 class RbfKernelFunction : public KernelFunction {
 public:
     // parameters must be set before a KernelFunction is used
-    RbfKernelFunction(const LabeledObservationVector& _obs) : KernelFunction(_obs), gamma(0.0) {}
+    RbfKernelFunction(const LabeledObservationVector& _obs, RowCache& c, int t) : KernelFunction(_obs, c, t), gamma(0.0) {}
     ~RbfKernelFunction() {}
 
     double similarity(const LabeledObservation& i, const LabeledObservation& j) {
@@ -486,7 +470,11 @@ public:
         //for (int n = 0; n < i.second->size(); n++) {
         //    sumOfSquaredDifs += pow((i.second->at(n) - j.second->at(n)), 2.0);
         //}
-        return gamma * getCachedParameterFreeSimilarity(i, j);
+        return similarityFromParameterFree(getCachedParameterFreeSimilarity(i, j));
+    }
+
+    double similarityFromParameterFree(double s) {
+        return gamma * s;
     }
 
     double calculateParameterFreeSimilarity(const LabeledObservation& i, const LabeledObservation& j) {
@@ -525,14 +513,18 @@ private:
 class PolynomialKernelFunction : public KernelFunction {
 public:
     // parameters must be set before using a KernelFunction is used
-    PolynomialKernelFunction(const LabeledObservationVector& _obs) : KernelFunction(_obs), c(0.0), gamma(0.0), d(0) {}
+    PolynomialKernelFunction(const LabeledObservationVector& _obs, RowCache& rc, int t) : KernelFunction(_obs, rc, t), c(0.0), gamma(0.0), d(0) {}
     ~PolynomialKernelFunction() {}
 
     double similarity(const LabeledObservation& i, const LabeledObservation& j) {
-        return pow((gamma * getCachedParameterFreeSimilarity(i, j) + c), d);
+        return similarityFromParameterFree(getCachedParameterFreeSimilarity(i, j));
         //return pow(inner_product(i.second->begin(), i.second->end(), j.second->begin(), c), d);
     }
 
+    double similarityFromParameterFree(double s) {
+        return pow((gamma * s + c), d);
+    }
+
     double calculateParameterFreeSimilarity(const LabeledObservation& i, const LabeledObservation& j) {
         return inner_product(i.second->begin(), i.second->end(), j.second->begin(), 0.0);
     }
@@ -568,14 +560,18 @@ private:
 class SigmoidKernelFunction : public KernelFunction {
 public:
     // parameters must be set before using a KernelFunction is used
-    SigmoidKernelFunction(const LabeledObservationVector& _obs) : KernelFunction(_obs), alpha(0.0), c(0.0) {}
+    SigmoidKernelFunction(const LabeledObservationVector& _obs, RowCache& rc, int t) : KernelFunction(_obs, rc, t), alpha(0.0), c(0.0) {}
     ~SigmoidKernelFunction() {}
 
     double similarity(const LabeledObservation& i, const LabeledObservation& j) {
-        return tanh(alpha * getCachedParameterFreeSimilarity(i, j) + c);
+        return similarityFromParameterFree(getCachedParameterFreeSimilarity(i, j));
         //return tanh(alpha * inner_product(i.second->begin(), i.second->end(), j.second->begin(), c));
     }
 
+    double similarityFromParameterFree(double s) {
+        return tanh(alpha * s + c);
+    }
+
     double calculateParameterFreeSimilarity(const LabeledObservation& i, const LabeledObservation& j) {
         return inner_product(i.second->begin(), i.second->end(), j.second->begin(), 0.0);
     }
@@ -604,18 +600,18 @@ private:
 
 class KernelFactory {
 public:
-    static KernelFunction* getKernelFunctionForKey(string kernelFunctionKey, const LabeledObservationVector& obs) {
+    static KernelFunction* getKernelFunctionForKey(string kernelFunctionKey, const LabeledObservationVector& obs, RowCache& rowCache, int table) {
         if ( kernelFunctionKey == LinearKernelFunction::MapKey ) {
-            return new LinearKernelFunction(obs);
+            return new LinearKernelFunction(obs, rowCache, table);
         }
         else if ( kernelFunctionKey == RbfKernelFunction::MapKey ) {
-            return new RbfKernelFunction(obs);
+            return new RbfKernelFunction(obs, rowCache, table);
         }
         else if ( kernelFunctionKey == PolynomialKernelFunction::MapKey ) {
-            return new PolynomialKernelFunction(obs);
+            return new PolynomialKernelFunction(obs, rowCache, table);
         }
         else if ( kernelFunctionKey == SigmoidKernelFunction::MapKey ) {
-            return new SigmoidKernelFunction(obs);
+            return new SigmoidKernelFunction(obs, rowCache, table);
         }
         else {
             throw new exception();
@@ -629,11 +625,13 @@ typedef map<string, KernelFunction*> KernelFunctionMap;
 // An instance of KernelFunctionFactory dynamically allocates kernel function
 // instances and maintains a table of pointers to them.  This allows kernel
 // function instances to be reused which improves performance since the
-// kernel values do not have to be recalculated as often.  A KernelFunctionFactory
-// maintains an inner product cache used by the KernelFunctions it builds.
+// kernel values do not have to be recalculated as often.  All kernel functions
+// built for the same key share one table of parameter free values in the RowCache,
+// including the extra instances from newKernelFunctionForKey used to hold
+// different parameters at the same time.
 class KernelFunctionFactory {
 public:
-    KernelFunctionFactory(const LabeledObservationVector& _obs) : obs(_obs) {}
+    KernelFunctionFactory(const LabeledObservationVector& _obs, RowCache& _rowCache) : obs(_obs), rowCache(_rowCache) {}
     ~KernelFunctionFactory() {
         for ( KernelFunctionMap::iterator i = kernelFunctionTable.begin(); i != kernelFunctionTable.end(); i++ ) {
             delete i->second;
@@ -645,59 +643,60 @@ public:
             kernelFunctionTable.insert(
                 make_pair(
                     kernelFunctionKey,
-                    KernelFactory::getKernelFunctionForKey(kernelFunctionKey, obs)
+                    newKernelFunctionForKey(kernelFunctionKey)
                 )
             );
         }
         return *kernelFunctionTable[kernelFunctionKey];
     }
 
+    // the caller must delete the kernel function
+    KernelFunction* newKernelFunctionForKey(string kernelFunctionKey) {
+        if ( rowCacheTable.count(kernelFunctionKey) == 0 ) {
+            rowCacheTable[kernelFunctionKey] = rowCache.addTable();
+        }
+        return KernelFactory::getKernelFunctionForKey(kernelFunctionKey, obs, rowCache, rowCacheTable[kernelFunctionKey]);
+    }
+
 private:
     const LabeledObservationVector& obs;
+    RowCache& rowCache;
     KernelFunctionMap kernelFunctionTable;
-    //InnerProductCache innerProductCache;
+    map<string, int> rowCacheTable;
 };
 
 
-class KernelFunctionCache {
+// A KernelFunctionCache holds the kernel values for one set of kernel parameters in its own
+// RowCache table.  The table is removed from the RowCache when the KernelFunctionCache is deleted.
+class KernelFunctionCache : public RowCalculator {
 public:
-    KernelFunctionCache(KernelFunction& _k, const LabeledObservationVector& _obs) :
-        k(_k), obs(_obs),
-        cache(_obs.size(), NULL) {}
+    KernelFunctionCache(KernelFunction& _k, RowCache& _rowCache) :
+        k(_k), rowCache(_rowCache),
+        table(_rowCache.addTable()) {}
     ~KernelFunctionCache() {
-        //cout << "deleting KernelFunctionCache cache" << endl;
-        for (int i = 0; i < cache.size(); i++) {
-            if ( !rowNotCached(i) ) {
-                delete cache[i];
-            }
-        }
+        rowCache.removeTable(table);
     }
 
     double similarity(const LabeledObservation& obs_i, const LabeledObservation& obs_j) {
-        const int i = obs_i.datasetIndex;
-        const int j = obs_j.datasetIndex;
-        // if the first element of row i is NaN then calculate all elements for row i
-        if ( rowNotCached(i) ) {
-            cache[i] = new vector<double>(obs.size(), numeric_limits<double>::signaling_NaN());
-            for ( int v = 0; v < obs.size(); v++ ) {
-                cache.at(i)->at(v) = k.similarity(
-                    obs[i],
-                    obs[v]
-                );
-            }
-        }
-        return cache.at(i)->at(j);
+        return getRow(obs_i.datasetIndex)->at(obs_j.datasetIndex);
     }
 
-    bool rowNotCached(int i) {
-        return cache[i] == NULL;
+    // row i holds the kernel values of observation i with every observation, by dataset index
+    CachedRow getRow(int i) {
+        return rowCache.getRow(table, i, *this);
+    }
+
+    void calculateRow(int i, vector<double>& row) {
+        CachedRow parameterFreeRow = k.getParameterFreeRow(i);
+        for ( int v = 0; v < row.size(); v++ ) {
+            row[v] = k.similarityFromParameterFree((*parameterFreeRow)[v]);
+        }
     }
 
 private:
     KernelFunction& k;
-    const LabeledObservationVector& obs;
-    //vector<vector<double> > cache;
-    vector<vector<double>* > cache;
+    RowCache& rowCache;
+    const int table;
 };
 
 
@@ -986,15 +985,32 @@ private:
 };
 
 
+// One kernel and set of kernel parameters in the grid searched for a pair of labels.
+// The kernel function and cache are shared by the threads training the folds.
+struct SvmParameterSet {
+    string kernelFunctionKey;
+    ParameterMap parameterMap;
+    KernelFunction* kernelFunction;
+    KernelFunctionCache* kernelFunctionCache;
+};
+typedef vector<SvmParameterSet> SvmParameterSetVector;
+
+
 // OneVsOneMultiClassSvmTrainer trains a support vector machine for each
 // pair of labels in a set of data.
+//
+// The cross validation of a pair of labels trains one SVM for each parameter
+// set and fold.  These are spread over the processors, the scores are combined
+// in grid order afterwards so the chosen parameters do not depend on the number
+// of processors.  All kernel values of a training run share one RowCache
+// limited to rowCacheBytes.
 class OneVsOneMultiClassSvmTrainer {
 public:
-    OneVsOneMultiClassSvmTrainer(SvmDataset&, int, int, OutputFilter&);
+    OneVsOneMultiClassSvmTrainer(SvmDataset&, int, int, OutputFilter&, int, long long); //dataset, evaluation folds, training folds, output filter, processors, kernel cache bytes
     ~OneVsOneMultiClassSvmTrainer() {}
 
     MultiClassSVM* train(const KernelParameterRangeMap&);
-    double trainOnKFolds(SmoTrainer&, KernelFunctionCache&, KFoldLabeledObservationsDivider&);
+    void trainOnKFolds(SvmParameterSetVector&, KFoldLabeledObservationsDivider&, vector<double>&); //fills the mean score of each parameter set
     const LabelSet& getLabelSet() { return labelSet; }
     const LabeledObservationVector& getLabeledObservations() { return svmDataset.getLabeledObservationVector(); }
     const LabelPairSet& getLabelPairSet() { return labelPairSet; }
@@ -1002,6 +1018,13 @@ public:
 
     const OutputFilter& getOutputFilter() { return outputFilter; }
 
+    // kernel row cache use summed over the calls to train
+    long long getRowCacheBytes()     { return rowCacheBytes; }
+    long long getRowCachePeakBytes() { return rowCachePeakBytes; }
+    long long getRowCacheHits()      { return rowCacheHits; }
+    long long getRowCacheMisses()    { return rowCacheMisses; }
+    long long getRowCacheEvictions() { return rowCacheEvictions; }
+
     static void buildLabelPairSet(LabelPairSet&, const LabeledObservationVector&);
     static void appendTrainingAndTestingData(Label, const LabeledObservationVector&, LabeledObservationVector&, LabeledObservationVector&);
 
@@ -1014,6 +1037,10 @@ private:
 
     const int evaluationFoldCount;
     const int trainFoldCount;
+    const int processors;
+
+    const long long rowCacheBytes;
+    long long rowCachePeakBytes, rowCacheHits, rowCacheMisses, rowCacheEvictions;
 
     LabelSet labelSet;
     LabelToLabeledObservationVector labelToLabeledObservationVector;
@@ -4,34 +4,26 @@
 //The sum_of_squares, havel_hakimi and calc_c_score algorithms have been adapted from I. Miklos and J. Podani. 2004. Randomization of presence-absence matrices: comments and new algorithms. Ecology 85:86-92.
 
 
-double TrialSwap2::calc_c_score (vector<vector<int> > &co_matrix, vector<int> rowtotal, int ncols, int nrows)
+double TrialSwap2::calc_c_score (PresenceMatrix &co_matrix, vector<int> &rowtotal)
 {
     try {
-        double cscore = 0.0;
         double maxD;
         double D;
         double normcscore = 0.0;
         int nonzeros = 0;
-        //int ncols = co_matrix[0].size(); int nrows = rowtotal.size();
-        vector<vector<double> > s; s.resize(nrows);
-        for (int i = 0; i < nrows; i++) { s[i].resize(nrows,0.0); }//only fill half the matrix
-        
+        int ncols = co_matrix.getNumCols(); int nrows = co_matrix.getNumRows();
         
         for(int i=0;i<nrows-1;i++)
         {
+            if (m->getControl_pressed()) { return 0; }
             
             for(int j=i+1;j<nrows;j++)
             {
-                if (m->getControl_pressed()) { return 0; }
-                for(int k=0;k<ncols;k++)
-                {
-                    if((co_matrix[i][k]==1)&&(co_matrix[j][k]==1)) //if both are 1s ie co-occurrence
-                        s[i][j]++; //s counts co-occurrences
-                }
+                //s counts co-occurrences
+                int s = co_matrix.getCoOccurrences(i, j);
                 
-                //rowtotal[i] = A, rowtotal[j] = B, ncols = P, s[i][j] = J
-                cscore += (rowtotal[i]-s[i][j])*(rowtotal[j]-s[i][j]);///(nrows*(nrows-1)/2);
-                D = (rowtotal[i]-s[i][j])*(rowtotal[j]-s[i][j]);
+                //rowtotal[i] = A, rowtotal[j] = B, ncols = P, s = J
+                D = (rowtotal[i]-s)*(rowtotal[j]-s);
                 
                 if(ncols < (rowtotal[i] + rowtotal[j]))
                 {
@@ -51,8 +43,7 @@ double TrialSwap2::calc_c_score (vector<vector<int> > &co_matrix, vector<int> ro
         }
         
         //cscore = cscore/(double)(nrows*(nrows-1)/2);  //not normalized
-        //cout << "normalized c score: " << normcscore/nonzeros << endl;
-        cscore = normcscore/(double)nonzeros;
+        double cscore = normcscore/(double)nonzeros;
 
         return cscore;
     }
@@ -62,37 +53,23 @@ double TrialSwap2::calc_c_score (vector<vector<int> > &co_matrix, vector<int> ro
     }
 }
 /**************************************************************************************************/
-int TrialSwap2::calc_checker (vector<vector<int> > &co_matrix, vector<int> rowtotal, int ncols, int nrows)
+int TrialSwap2::calc_checker (PresenceMatrix &co_matrix)
 {
     try {
         int cunits=0;
-        //int s[nrows][ncols];
-        //int ncols = co_matrix[0].size(); int nrows = rowtotal.size();
-        vector<vector<int> > s; s.resize(nrows);
-        for (int i = 0; i < nrows; i++) { s[i].resize(nrows,0); }//only fill half the matrix
+        int nrows = co_matrix.getNumRows();
         
         for(int i=0;i<nrows-1;i++)
         {
+            if (m->getControl_pressed()) { return 0; }
+            
             for(int j=i+1;j<nrows;j++)
             {
-                if (m->getControl_pressed()) { return 0; }
-                //s[i][j]=0;
-                for(int k=0;k<ncols;k++)
-                {
-                    //cout << s[i][j] << endl;
-                    //iterates through the row and counts co-occurrences. The total number of co-occurrences for each row pair is kept in matrix s at location s[i][j].
-                    if((co_matrix[i][k]==1)&&(co_matrix[j][k]==1)) //if both are 1s ie co-occurrence
-                        s[i][j]++; //s counts co-occurrences
-                    
-                }
-                //cout << "rowtotal: " << rowtotal[i] << endl;
-                //cout << "co-occurrences: " << s[i][j] << endl;
-                //cunits+=(rowtotal[i]-s[i][j])*(rowtotal[j]-s[i][j]);
-                if (s[i][j] == 0)
+                //row pairs that never co-occur
+                if (co_matrix.getCoOccurrences(i, j) == 0)
                 {
                     cunits+=1;
                 }
-                //cunits+=s[i][j];
             }
         }
         
@@ -145,36 +122,34 @@ double TrialSwap2::calc_vratio (int nrows, int ncols, vector<int> rowtotal, vect
     
 }
 /**************************************************************************************************/
-int TrialSwap2::calc_combo (int nrows, int ncols, vector<vector<int> > &nullmatrix)
+int TrialSwap2::calc_combo (PresenceMatrix &nullmatrix)
 {
     try {
-        //need to transpose so we can compare rows (row-major order)
-        //int tmpnrows = nrows;
-        vector<vector<int> > tmpmatrix;
+        int nrows = nullmatrix.getNumRows(); int ncols = nullmatrix.getNumCols();
         
-        vector<int> tmprow;
-        if(!tmpmatrix.empty())
-            tmpmatrix.clear();
-        for (int i=0;i<ncols;i++)
+        //need to transpose so we can compare columns as packed rows
+        PresenceMatrix tmpmatrix(ncols, nrows);
+        for (int i=0;i<nrows;i++)
         {
-            for (int j=0;j<nrows;j++)
+            for (int j=0;j<ncols;j++)
             {
-                tmprow.push_back(nullmatrix[j][i]);
+                if (nullmatrix.get(i, j)) { tmpmatrix.set(j, i); }
             }
-            
-            tmpmatrix.push_back(tmprow);
-            tmprow.clear();
         }
         
+        vector<int> tmptotal(ncols, 0);
+        for (int j=0;j<ncols;j++) { tmptotal[j] = tmpmatrix.getCoOccurrences(j, j); }
+        
         int unique = 0;
-        int match = 0;
         for(int j=0;j<ncols;j++)
         {
-            match = 0;
-            for(int i=j+1;i<=ncols;i++)
+            if (m->getControl_pressed()) { return 0; }
+            
+            int match = 0;
+            for(int i=j+1;i<ncols;i++)
             {
-                //comparing matrix rows
-                if( (tmpmatrix[j] == tmpmatrix[i]))
+                //comparing matrix rows, they match if they have the same totals and share all their presences
+                if ((tmptotal[i] == tmptotal[j]) && (tmpmatrix.getCoOccurrences(i, j) == tmptotal[j]))
                 {
                     match++;
                     break;
@@ -193,36 +168,6 @@ int TrialSwap2::calc_combo (int nrows, int ncols, vector<vector<int> > &nullmatr
     }
 }
 /**************************************************************************************************/
-int TrialSwap2::swap_checkerboards (vector<vector<int> > &co_matrix, int ncols, int nrows)
-{
-    try {
-        Utils util;
-        //do 100 runs to make sure enough swaps are happening. This does NOT mean that there will be 1000 swaps, but that is the theoretical max.
-        for(int a=0;a<1000;a++){
-            int i, j, k, l;
-            i = util.getRandomIndex(nrows-1);
-            while((j = util.getRandomIndex(nrows-1) ) == i ) {;if (m->getControl_pressed()) { return 0; }}
-            k = util.getRandomIndex(ncols-1);
-            while((l = util.getRandomIndex(ncols-1)) == k ) {;if (m->getControl_pressed()) { return 0; }}
-
-            if((co_matrix[i][k]*co_matrix[j][l]==1 && co_matrix[i][l]+co_matrix[j][k]==0)||(co_matrix[i][k]+co_matrix[j][l]==0 && co_matrix[i][l]*co_matrix[j][k]==1)) //checking for checkerboard value and swap
-            {
-                co_matrix[i][k]=1-co_matrix[i][k];
-                co_matrix[i][l]=1-co_matrix[i][l];
-                co_matrix[j][k]=1-co_matrix[j][k];
-                co_matrix[j][l]=1-co_matrix[j][l];
-
-            }
-        }
-        
-        return 0;
-    }
-    catch(exception& e) {
-        m->errorOut(e, "TrialSwap2", "swap_checkerboards");
-        exit(1);
-    }
-}
-/**************************************************************************************************/
 double TrialSwap2::calc_pvalue_greaterthan (vector<double> scorevec, double initialscore)
 {
     try {
@@ -321,17 +266,17 @@ double TrialSwap2::get_zscore (double sd, double nullMean, double initscore)
     }
 }
 /**************************************************************************************************/
-int TrialSwap2::print_matrix(vector<vector<int> > &matrix, int nrows, int ncols)
+int TrialSwap2::print_matrix(PresenceMatrix &matrix)
 {
     try {
         m->mothurOut("matrix:"); m->mothurOutEndLine();
         
-        for (int i = 0; i < nrows; i++)
+        for (int i = 0; i < matrix.getNumRows(); i++)
         {
             if (m->getControl_pressed()) { return 0; }
-            for (int j = 0; j < ncols; j++)
+            for (int j = 0; j < matrix.getNumCols(); j++)
             {
-                m->mothurOut(toString(matrix[i][j]));
+                m->mothurOut(toString(matrix.get(i, j)));
             }
             m->mothurOutEndLine();
         }
@@ -343,8 +288,122 @@ int TrialSwap2::print_matrix(vector<vector<int> > &matrix, int nrows, int ncols)
     }
 }
 /**************************************************************************************************/
-
-
-
-
-
+/**************************************************************************************************/
+SwapChain::SwapChain(PresenceMatrix &co_matrix, vector<int> &rows, unsigned long long seed) : matrix(co_matrix), rowtotal(rows), engine(seed)
+{
+    try {
+        m = MothurOut::getInstance();
+        nrows = matrix.getNumRows(); ncols = matrix.getNumCols();
+        normcscore = 0.0; nonzeros = 0; checker = 0; scored = false;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SwapChain", "SwapChain");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+void SwapChain::calcScores()
+{
+    try {
+        normcscore = 0.0; nonzeros = 0; checker = 0; scored = true;
+        
+        for(int i=0;i<nrows-1;i++)
+        {
+            if (m->getControl_pressed()) { break; }
+            
+            for(int j=i+1;j<nrows;j++)
+            {
+                int s = matrix.getCoOccurrences(i, j);
+                
+                if (s == 0) { checker++; }
+                
+                //maxD only depends on the row totals, so the pairs counted don't change with the swaps
+                if (getMaxD(i, j) != 0) { nonzeros++; }
+                
+                normcscore += getPairScore(i, j, s);
+            }
+        }
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SwapChain", "calcScores");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
+double SwapChain::getMaxD(int i, int j)
+{
+    if(ncols < (rowtotal[i] + rowtotal[j]))    { return (ncols-rowtotal[i])*(ncols-rowtotal[j]);   }
+    return rowtotal[i] * rowtotal[j];
+}
+/**************************************************************************************************/
+double SwapChain::getPairScore(int i, int j, int s)
+{
+    double maxD = getMaxD(i, j);
+    if (maxD == 0) { return 0; }
+    
+    double D = (rowtotal[i]-s)*(rowtotal[j]-s);
+    return D/maxD;
+}
+/**************************************************************************************************/
+//row loses column lost and gains column gained. Only its pairs with rows that differ in those columns change.
+//Called before the matrix is changed, the pair with the other swapped row keeps its co-occurrences.
+void SwapChain::updateRow(int row, int other, int lost, int gained)
+{
+    for (int x = 0; x < nrows; x++) {
+        if ((x == row) || (x == other)) { continue; }
+        
+        int change = (int)matrix.get(x, gained) - (int)matrix.get(x, lost);
+        if (change == 0) { continue; }
+        
+        int s = matrix.getCoOccurrences(row, x);
+        
+        if (s == 0) { checker--; }
+        if ((s+change) == 0) { checker++; }
+        
+        normcscore += getPairScore(row, x, s+change) - getPairScore(row, x, s);
+    }
+}
+/**************************************************************************************************/
+int SwapChain::swap_checkerboards (long long attempts)
+{
+    try {
+        if ((nrows < 2) || (ncols < 2)) { return 0; }
+        
+        uniform_int_distribution<int> rowDis(0, nrows-1);
+        uniform_int_distribution<int> colDis(0, ncols-1);
+        
+        int swaps = 0;
+        for(long long a=0;a<attempts;a++){
+            if ((a % 100000) == 0) { if (m->getControl_pressed()) { return swaps; } }
+            
+            int i, j, k, l;
+            i = rowDis(engine);
+            while((j = rowDis(engine)) == i ) {;}
+            k = colDis(engine);
+            while((l = colDis(engine)) == k ) {;}
+            
+            bool ik = matrix.get(i, k); bool il = matrix.get(i, l);
+            bool jk = matrix.get(j, k); bool jl = matrix.get(j, l);
+            
+            //checking for checkerboard value and swap
+            if ((ik == jl) && (il == jk) && (ik != il))
+            {
+                if (scored) {
+                    if (ik) { updateRow(i, j, k, l); updateRow(j, i, l, k); }
+                    else    { updateRow(i, j, l, k); updateRow(j, i, k, l); }
+                }
+                
+                matrix.flip(i, k); matrix.flip(i, l);
+                matrix.flip(j, k); matrix.flip(j, l);
+                swaps++;
+            }
+        }
+        
+        return swaps;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "SwapChain", "swap_checkerboards");
+        exit(1);
+    }
+}
+/**************************************************************************************************/
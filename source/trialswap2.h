@@ -12,7 +12,40 @@
 
 #include "mothurout.h"
 #include "utils.hpp"
+#include <bitset>
 
+/**************************************************************************************************/
+//presence/absence matrix with each row packed 64 columns to a word, so co-occurrences are counted a word at a time
+class PresenceMatrix {
+    
+public:
+    PresenceMatrix() : nrows(0), ncols(0), words(0) {}
+    PresenceMatrix(int r, int c) { resize(r, c); }
+    ~PresenceMatrix(){}
+    
+    void resize(int r, int c) { nrows = r; ncols = c; words = (c+63)/64; bits.assign((long long)nrows*words, 0); }
+    void clear() { fill(bits.begin(), bits.end(), 0); }
+    
+    int getNumRows() const { return nrows; }
+    int getNumCols() const { return ncols; }
+    bool get(int r, int c) const { return (bits[(long long)r*words+(c>>6)] >> (c&63)) & 1ULL; }
+    void set(int r, int c) { bits[(long long)r*words+(c>>6)] |= (1ULL << (c&63)); }
+    void flip(int r, int c) { bits[(long long)r*words+(c>>6)] ^= (1ULL << (c&63)); }
+    
+    //number of columns where both rows are present
+    int getCoOccurrences(int r1, int r2) const {
+        const unsigned long long* row1 = &bits[(long long)r1*words]; const unsigned long long* row2 = &bits[(long long)r2*words];
+        int count = 0;
+        for (int w = 0; w < words; w++) { count += bitset<64>(row1[w] & row2[w]).count(); }
+        return count;
+    }
+    
+private:
+    int nrows, ncols, words;
+    vector<unsigned long long> bits;
+};
+
+/**************************************************************************************************/
 
 class TrialSwap2 {
     
@@ -22,11 +55,10 @@ public:
     
     double calc_pvalue_lessthan (vector<double>, double);
     double calc_pvalue_greaterthan (vector<double>, double);
-    int swap_checkerboards (vector<vector<int> > &, int, int);
-    int calc_combo (int, int, vector<vector<int> > &);
+    int calc_combo (PresenceMatrix&);
     double calc_vratio (int, int, vector<int>, vector<int>);
-    int calc_checker (vector<vector<int> > &, vector<int>, int, int);
-    double calc_c_score (vector<vector<int> > &, vector<int>, int, int);
+    int calc_checker (PresenceMatrix&);
+    double calc_c_score (PresenceMatrix&, vector<int>&);
     double get_zscore (double, double, double);
     double getSD (int, vector<double>, double);
     
@@ -36,11 +68,42 @@ private:
     Utils util;
     
     double t_test (double, int, double, vector<double>);
-    int print_matrix(vector<vector<int> > &, int, int);
+    int print_matrix(PresenceMatrix&);
     
     
         
 };
+
+/**************************************************************************************************/
+//a chain of checkerboard swaps on its own copy of the matrix. The swaps keep the row and column totals, so once the
+//c-score and checker metrics are asked for they are updated from the rows a swap touches instead of being recalculated.
+class SwapChain {
+    
+public:
+    SwapChain(PresenceMatrix&, vector<int>&, unsigned long long); //matrix, rowtotals, seed
+    ~SwapChain(){}
+    
+    int swap_checkerboards(long long); //attempts, returns the number of swaps made
+    double getCScore() { if (!scored) { calcScores(); } return (nonzeros == 0) ? numeric_limits<double>::quiet_NaN() : normcscore / (double) nonzeros; } //NaN with no scored pairs, like calc_c_score
+    int getChecker() { if (!scored) { calcScores(); } return checker; }
+    PresenceMatrix& getMatrix() { return matrix; }
+    
+private:
+    MothurOut* m;
+    PresenceMatrix matrix;
+    vector<int> rowtotal;
+    mt19937_64 engine;
+    double normcscore;
+    int nonzeros, checker, nrows, ncols;
+    bool scored; //false until the metrics are first asked for, the burn-in swaps don't update them
+    
+    void calcScores();
+    double getMaxD(int, int); //row, row
+    double getPairScore(int, int, int); //row, row, co-occurrences. Returns D/maxD, 0 if maxD is 0
+    void updateRow(int, int, int, int); //row, other swapped row, column lost, column gained
+};
+
+/**************************************************************************************************/
 #endif
 
 
@@ -9,6 +9,10 @@
 #include "utils.hpp"
 #include "ordervector.hpp"
 #include "sharedordervector.h"
+#include "nameset.hpp"
+#include "sequenceindex.hpp"
+#include "externalsort.hpp"
+#include "currentfile.h"
 
 /***********************************************************************/
 Utils::Utils(){
@@ -763,7 +767,7 @@ vector<bool> Utils::isGZ(string filename){
         if (getExtension(filename) != ".gz") { return results; } // results[0] = false; results[1] = false;
 
         bool ableToOpen = openInputFileBinary(filename, fileHandle, gzin, ""); //no error
-        if (ableToOpen == 1) { return results; } // results[0] = false; results[1] = false;
+        if (!ableToOpen) { return results; } // results[0] = false; results[1] = false;
         else {  results[0] = true;  }
 
         char c;
@@ -1019,62 +1023,52 @@ string Utils::sortFile(string distFile, string outputDir){
         //if (outputDir == "") {  outputDir += hasPath(distFile);  }
         string outfile = getRootName(distFile) + "sorted.dist";
 
+        //sort by distance
+        sortFileNumeric(distFile, outfile, 3);
 
-        //if you can, use the unix sort since its been optimized for years
-#if defined NON_WINDOWS
-        string command = "sort -n -k +3 " + distFile + " -o " + outfile;
-        system(command.c_str());
-#else //you are stuck with my best attempt...
-        //windows sort does not have a way to specify a column, only a character in the line
-        //since we cannot assume that the distance will always be at the the same character location on each line
-        //due to variable sequence name lengths, I chose to force the distance into first position, then sort and then put it back.
-
-        //read in file line by file and put distance first
-        string tempDistFile = distFile + ".temp";
-        ifstream input;
-        ofstream output;
-        openInputFile(distFile, input);
-        openOutputFile(tempDistFile, output);
+        return outfile;
+    }
+    catch(exception& e) {
+        m->errorOut(e, "Utils", "sortFile");
+        exit(1);
+    }
+}
+/***********************************************************************/
+//like the unix "sort -n -k column" in the C locale, lines with the same number are ordered by their text. The lines are
+//sorted in memory sized runs by the current processors and merged, so the file doesn't have to fit in memory
+void Utils::sortFileNumeric(string inputFile, string outputFile, int column){
+    try {
+        int processors = 1;
+        mothurConvert(CurrentFile::getInstance()->getProcessors(), processors);
 
-        string firstName, secondName;
-        float dist;
-        while (!input.eof()) {
-            input >> firstName >> secondName >> dist;
-            output << dist << '\t' << firstName << '\t' << secondName << endl;
-            gobble(input);
-        }
-        input.close();
-        output.close();
+        ExternalSort sorter(outputFile, processors, m->getSortMemory(), true);
 
+        ifstream in;
+        openInputFile(inputFile, in);
 
-        //sort using windows sort
-        string tempOutfile = outfile + ".temp";
-        string command = "sort " + tempDistFile + " /O " + tempOutfile;
-        system(command.c_str());
+        string line;
+        while (std::getline(in, line)) {
+            if (m->getControl_pressed()) { break; }
 
-        //read in sorted file and put distance at end again
-        ifstream input2;
-        ofstream output2;
-        openInputFile(tempOutfile, input2);
-        openOutputFile(outfile, output2);
+            //skip to the column, the number can have leading blanks
+            size_t pos = 0;
+            for (int i = 1; i < column; i++) {
+                while ((pos < line.length()) && isspace((unsigned char)line[pos])) { pos++; }
+                while ((pos < line.length()) && !isspace((unsigned char)line[pos])) { pos++; }
+            }
+            double value = strtod(line.c_str() + pos, NULL);
 
-        while (!input2.eof()) {
-            input2 >> dist >> firstName >> secondName;
-            output2 << firstName << '\t' << secondName << '\t' << dist << endl;
-            gobble(input2);
+            line += '\n';
+            sorter.add(ExternalSort::encodeKey(value), line);
         }
-        input2.close();
-        output2.close();
+        in.close();
 
-        //remove temp files
-        mothurRemove(tempDistFile);
-        mothurRemove(tempOutfile);
-#endif
+        if (m->getControl_pressed()) { return; }
 
-        return outfile;
+        sorter.output(outputFile);
     }
     catch(exception& e) {
-        m->errorOut(e, "Utils", "sortFile");
+        m->errorOut(e, "Utils", "sortFileNumeric");
         exit(1);
     }
 }
@@ -1617,6 +1611,15 @@ bool Utils::stringBlank(string input){
 /**************************************************************************************************/
 vector<unsigned long long> Utils::setFilePosFasta(string filename, long long& num, char delim) {
     try {
+        //fastq offsets are read from filename.idx if it is current, and saved there after set.dir(index=T)
+        if (delim == '@') {
+            SequenceIndex index(filename, delim, CurrentFile::getInstance()->getOutputDir());
+            if (index.isValid() || (m->getIndexFiles() && index.build())) {
+                num = index.getNumRecords();
+                return index.getPositions();
+            }
+        }
+        
         vector<unsigned long long> positions;
         ifstream inFASTA;
         string completeFileName = getFullPathName(filename);
@@ -1677,6 +1680,13 @@ vector<unsigned long long> Utils::setFilePosFasta(string filename, long long& nu
 /**************************************************************************************************/
 vector<unsigned long long> Utils::setFilePosFasta(string filename, long long& num) {
     try {
+        //the offsets are read from filename.idx if it is current, and saved there after set.dir(index=T)
+        SequenceIndex index(filename, '>', CurrentFile::getInstance()->getOutputDir());
+        if (index.isValid() || (m->getIndexFiles() && index.build())) {
+            num = index.getNumRecords();
+            return index.getPositions();
+        }
+        
         vector<unsigned long long> positions;
         ifstream inFASTA;
         //openInputFileBinary(filename, inFASTA);
@@ -2985,6 +2995,39 @@ set<string> Utils::readAccnos(string accnosfile){
     }
 }
 //**********************************************************************************************************************
+int Utils::readAccnos(string accnosfile, NameSet& names){
+    try {
+        names.clear();
+        ifstream in;
+        bool ableToOpen = openInputFile(accnosfile, in, "");
+        if (!ableToOpen) {  m->mothurOut("[ERROR]: Could not open " + accnosfile + "\n"); return 0; }
+
+        string rest = "";
+        char buffer[4096];
+
+        while (!in.eof()) {
+            if (m->getControl_pressed()) { break; }
+
+            in.read(buffer, 4096);
+            vector<string> pieces = splitWhiteSpace(rest, buffer, in.gcount());
+
+            for (int i = 0; i < pieces.size(); i++) {  checkName(pieces[i]); names.insert(pieces[i]);  }
+        }
+        in.close();
+
+        if (rest != "") {
+            vector<string> pieces = splitWhiteSpace(rest);
+            for (int i = 0; i < pieces.size(); i++) {  checkName(pieces[i]); names.insert(pieces[i]);  }
+        }
+
+        return names.size();
+    }
+    catch(exception& e) {
+        m->errorOut(e, "Utils", "readAccnos");
+        exit(1);
+    }
+}
+//**********************************************************************************************************************
 int Utils::readAccnos(string accnosfile, vector<string>& names){
     try {
         names.clear();
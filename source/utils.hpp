@@ -17,6 +17,7 @@ class SharedOrderVector;
 class RAbundVector;
 class SharedRAbundVector;
 class Tree;
+class NameSet;
 
 class Utils {
     
@@ -111,6 +112,7 @@ public:
     vector<unsigned long long> setFilePosFasta(string, long long&);
     vector<unsigned long long> setFilePosFasta(string, long long&, char);
     string sortFile(string, string);
+    void sortFileNumeric(string, string, int); //input, output, column. Sorts the lines by the number in the column, then by line
     
     //file reads
     bool checkReleaseVersion(string, string);
@@ -122,6 +124,7 @@ public:
     void gobble(istringstream&);
     vector<string> parseTreeFile(string filename); //returns treenames
     set<string> readAccnos(string);
+    int readAccnos(string, NameSet&);
     int readAccnos(string, vector<string>&);
     int readAccnos(string, vector<string>&, string);
     vector<consTax> readConsTax(string);